@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Bootloader.c
+	\date		October 19th, 2026
+	\brief		Swap bootloader, a separate image in the first 4 KB of flash.
+				It finishes a pending swap of the firmware slots and starts
+				the application in the primary slot.
+
+				Build it as its own MCUXpresso project linked at 0x0 with 4 KB
+				of flash, from this file, startup/, device/, CMSIS/,
+				source/3_HAL/Flash.c, source/3_HAL/CRC.c and
+				source/4_SL/Swap.c, with DISABLE_WDOG=0 defined. It keeps the
+				flash configuration field at 0x400, so it must leave flash
+				security and NMI as they are.
+
+				COPC takes a single write after reset, and that write is the
+				bootloader's: it starts the COP the application services, and
+				the swap refreshes it between sectors.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "CRC.h"
+#include "Swap.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		RAM_START
+	\brief		First address of SRAM_L
+*/
+#define		RAM_START		0x1FFFF000u
+
+/*!
+	\def		RAM_END
+	\brief		End of SRAM_U, the highest initial stack pointer
+*/
+#define		RAM_END			0x20003000u
+
+/*!
+	\def		BOOTLOADER_COP
+	\brief		COP of the application, as COP_CONFIG in Watchdog.c: LPO
+				clock, 1024 ms, stopped in stop modes and while debugging
+*/
+#define		BOOTLOADER_COP	(SIM_COPC_COPCLKSEL (0) | SIM_COPC_COPT (3))
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Bootloader_vfnStart (uint32_t address);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			int main (void)
+	\return		Does not return while the primary slot holds an image
+	\brief		A full swap takes a few seconds; a plain boot only reads
+				the journal and jumps.
+*/
+int main (void)
+{
+	SIM->COPC = BOOTLOADER_COP;
+	CRC_vfnDriverInit ();
+	Swap_efnBoot ();
+	Bootloader_vfnStart (SWAP_PRIMARY);
+
+	/* Nothing to start: wait for a debugger */
+	while (1)
+	{
+		__WFI ();
+	}
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Bootloader_vfnStart (uint32_t address)
+	\param		address	Vector table of the application
+	\brief		Moves the vector table, loads the application stack and jumps
+				to its reset handler. Returns only if the vector table does
+				not look like an application.
+*/
+static void Bootloader_vfnStart (uint32_t address)
+{
+	const uint32_t *vectors = (const uint32_t *)address;
+	uint32_t stack = vectors[0];
+	uint32_t entry = vectors[1];
+
+	if ((stack <= RAM_START) || (stack > RAM_END) || ((stack & 3) != 0) ||
+			(entry < address) || (entry >= (address + SWAP_SLOT_SIZE)) || ((entry & 1) == 0))
+	{
+		return;
+	}
+
+	__disable_irq ();
+	SCB->VTOR = address;
+	__set_MSP (stack);
+	__enable_irq ();
+	((void (*)(void))entry) ();
+}
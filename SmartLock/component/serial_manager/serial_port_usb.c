@@ -0,0 +1,272 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		serial_port_usb.c
+	\date		October 19th, 2026
+	\brief		USB CDC port of the serial manager, for SDK code that selects
+				SERIAL_PORT_TYPE_USBCDC. It runs on the USB driver of
+				source/3_HAL/USB.c and takes the interface of the other
+				serial manager ports.
+*/
+//------------------------------------------------------------------------------
+
+#include "fsl_common.h"
+#include "serial_manager.h"
+#include "serial_port_internal.h"
+
+#if (defined(SERIAL_PORT_TYPE_USBCDC) && (SERIAL_PORT_TYPE_USBCDC > 0U))
+#include "USB.h"
+
+#include "serial_port_usb.h"
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+#ifndef NDEBUG
+#if (defined(DEBUG_CONSOLE_ASSERT_DISABLE) && (DEBUG_CONSOLE_ASSERT_DISABLE > 0U))
+#undef assert
+#define assert(n)
+#endif
+#endif
+
+/* Bytes taken from the USB receive ring per rx callback */
+#define SERIAL_PORT_USB_CDC_RECEIVE_DATA_LENGTH 16U
+
+typedef struct _serial_usb_cdc_send_state
+{
+    serial_manager_callback_t callback;
+    void *callbackParam;
+    uint8_t *buffer;
+    uint32_t length;
+    uint32_t offset;
+    volatile uint8_t busy;
+} serial_usb_cdc_send_state_t;
+
+typedef struct _serial_usb_cdc_recv_state
+{
+    serial_manager_callback_t callback;
+    void *callbackParam;
+} serial_usb_cdc_recv_state_t;
+
+typedef struct _serial_usb_cdc_state
+{
+    serial_usb_cdc_send_state_t tx;
+    serial_usb_cdc_recv_state_t rx;
+} serial_usb_cdc_state_t;
+
+/*******************************************************************************
+ * Prototypes
+ ******************************************************************************/
+static void Serial_UsbCdcRxCallback(void);
+static void Serial_UsbCdcTxCallback(void);
+
+/*******************************************************************************
+ * Variables
+ ******************************************************************************/
+/* The USB driver has a single device, so its callbacks find the port here */
+static serial_usb_cdc_state_t *s_serialUsbCdcHandle;
+
+/*******************************************************************************
+ * Code
+ ******************************************************************************/
+
+/* USB receive callback, runs in the USB interrupt */
+static void Serial_UsbCdcRxCallback(void)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle = s_serialUsbCdcHandle;
+    serial_manager_callback_message_t msg;
+    uint8_t readBuffer[SERIAL_PORT_USB_CDC_RECEIVE_DATA_LENGTH];
+
+    if (NULL == serialUsbCdcHandle)
+    {
+        return;
+    }
+
+    do
+    {
+        msg.length = USB_wfnReceive(&readBuffer[0], sizeof(readBuffer));
+        msg.buffer = &readBuffer[0];
+        if ((0U != msg.length) && (NULL != serialUsbCdcHandle->rx.callback))
+        {
+            serialUsbCdcHandle->rx.callback(serialUsbCdcHandle->rx.callbackParam, &msg, kStatus_SerialManager_Success);
+        }
+    } while (msg.length == sizeof(readBuffer));
+}
+
+/* USB transmit callback, runs in the USB interrupt once the driver sent every queued byte */
+static void Serial_UsbCdcTxCallback(void)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle = s_serialUsbCdcHandle;
+    serial_manager_callback_message_t msg;
+
+    if ((NULL == serialUsbCdcHandle) || (0U == serialUsbCdcHandle->tx.busy))
+    {
+        return;
+    }
+
+    if (serialUsbCdcHandle->tx.offset < serialUsbCdcHandle->tx.length)
+    {
+        serialUsbCdcHandle->tx.offset +=
+            USB_wfnSend(&serialUsbCdcHandle->tx.buffer[serialUsbCdcHandle->tx.offset],
+                        (uint16_t)MIN(serialUsbCdcHandle->tx.length - serialUsbCdcHandle->tx.offset, USB_TX_RING));
+        return;
+    }
+
+    serialUsbCdcHandle->tx.busy = 0U;
+    if ((NULL != serialUsbCdcHandle->tx.callback))
+    {
+        msg.buffer = serialUsbCdcHandle->tx.buffer;
+        msg.length = serialUsbCdcHandle->tx.length;
+        serialUsbCdcHandle->tx.callback(serialUsbCdcHandle->tx.callbackParam, &msg, kStatus_SerialManager_Success);
+    }
+}
+
+serial_manager_status_t Serial_UsbCdcInit(serial_handle_t serialHandle, void *config)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+    serial_port_usb_cdc_config_t *usbCdcConfig;
+
+    assert(config);
+    assert(serialHandle);
+    assert(SERIAL_PORT_USB_CDC_HANDLE_SIZE >= sizeof(serial_usb_cdc_state_t));
+
+    usbCdcConfig       = (serial_port_usb_cdc_config_t *)config;
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    if (kSerialManager_UsbControllerKhci0 != usbCdcConfig->controllerIndex)
+    {
+        return kStatus_SerialManager_Error;
+    }
+
+    (void)memset(serialUsbCdcHandle, 0, sizeof(*serialUsbCdcHandle));
+    s_serialUsbCdcHandle = serialUsbCdcHandle;
+
+    USB_vfnCallbackReg(Serial_UsbCdcRxCallback, Serial_UsbCdcTxCallback);
+    USB_vfnDriverInit();
+
+    return kStatus_SerialManager_Success;
+}
+
+serial_manager_status_t Serial_UsbCdcDeinit(serial_handle_t serialHandle)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+
+    assert(serialHandle);
+
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    USB_vfnDriverDeinit();
+    USB_vfnCallbackReg(NULL, NULL);
+
+    serialUsbCdcHandle->tx.busy = 0U;
+    s_serialUsbCdcHandle        = NULL;
+
+    return kStatus_SerialManager_Success;
+}
+
+serial_manager_status_t Serial_UsbCdcWrite(serial_handle_t serialHandle, uint8_t *buffer, uint32_t length)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+    uint32_t primask;
+
+    assert(serialHandle);
+    assert(buffer);
+    assert(length);
+
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    if (0U == USB_bfnIsConfigured())
+    {
+        return kStatus_SerialManager_Error;
+    }
+    if (serialUsbCdcHandle->tx.busy != 0U)
+    {
+        return kStatus_SerialManager_Busy;
+    }
+
+    serialUsbCdcHandle->tx.buffer = buffer;
+    serialUsbCdcHandle->tx.length = length;
+    serialUsbCdcHandle->tx.offset = 0U;
+    serialUsbCdcHandle->tx.busy   = 1U;
+
+    /* The driver calls back as soon as the ring drains, maybe before USB_wfnSend returns */
+    primask = DisableGlobalIRQ();
+    serialUsbCdcHandle->tx.offset = USB_wfnSend(buffer, (uint16_t)MIN(length, USB_TX_RING));
+    EnableGlobalIRQ(primask);
+
+    return kStatus_SerialManager_Success;
+}
+
+serial_manager_status_t Serial_UsbCdcRead(serial_handle_t serialHandle, uint8_t *buffer, uint32_t length)
+{
+    return kStatus_SerialManager_Error;
+}
+
+serial_manager_status_t Serial_UsbCdcCancelWrite(serial_handle_t serialHandle)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+    serial_manager_callback_message_t msg;
+    uint32_t primask;
+    uint8_t isBusy = 0U;
+
+    assert(serialHandle);
+
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    /* Bytes already queued in the USB driver are still sent */
+    primask                     = DisableGlobalIRQ();
+    isBusy                      = serialUsbCdcHandle->tx.busy;
+    serialUsbCdcHandle->tx.busy = 0U;
+    EnableGlobalIRQ(primask);
+
+    if (isBusy != 0U)
+    {
+        if ((NULL != serialUsbCdcHandle->tx.callback))
+        {
+            msg.buffer = serialUsbCdcHandle->tx.buffer;
+            msg.length = serialUsbCdcHandle->tx.length;
+            serialUsbCdcHandle->tx.callback(serialUsbCdcHandle->tx.callbackParam, &msg, kStatus_SerialManager_Canceled);
+        }
+    }
+    return kStatus_SerialManager_Success;
+}
+
+serial_manager_status_t Serial_UsbCdcInstallTxCallback(serial_handle_t serialHandle,
+                                                       serial_manager_callback_t callback,
+                                                       void *callbackParam)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+
+    assert(serialHandle);
+
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    serialUsbCdcHandle->tx.callback      = callback;
+    serialUsbCdcHandle->tx.callbackParam = callbackParam;
+
+    return kStatus_SerialManager_Success;
+}
+
+serial_manager_status_t Serial_UsbCdcInstallRxCallback(serial_handle_t serialHandle,
+                                                       serial_manager_callback_t callback,
+                                                       void *callbackParam)
+{
+    serial_usb_cdc_state_t *serialUsbCdcHandle;
+
+    assert(serialHandle);
+
+    serialUsbCdcHandle = (serial_usb_cdc_state_t *)serialHandle;
+
+    serialUsbCdcHandle->rx.callback      = callback;
+    serialUsbCdcHandle->rx.callbackParam = callbackParam;
+
+    return kStatus_SerialManager_Success;
+}
+
+void Serial_UsbCdcIsrFunction(serial_handle_t serialHandle)
+{
+    assert(serialHandle);
+
+    USB0_DriverIRQHandler();
+}
+
+#endif
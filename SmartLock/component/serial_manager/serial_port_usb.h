@@ -0,0 +1,36 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		serial_port_usb.h
+	\date		October 19th, 2026
+	\brief		Configuration of the USB CDC port of the serial manager
+*/
+//------------------------------------------------------------------------------
+
+#ifndef __SERIAL_PORT_USB_H__
+#define __SERIAL_PORT_USB_H__
+
+/*!
+ * @addtogroup serial_port_usb
+ * @{
+ */
+
+/*******************************************************************************
+ * Definitions
+ ******************************************************************************/
+/*! @brief serial port usb cdc handle size*/
+#define SERIAL_PORT_USB_CDC_HANDLE_SIZE (40U)
+
+/*! @brief USB controller index*/
+typedef enum _serial_port_usb_cdc_controller_index
+{
+    kSerialManager_UsbControllerKhci0 = 0U, /*!< KHCI 0U, the full-speed USB0 of the KL27Z */
+} serial_port_usb_cdc_controller_index_t;
+
+/*! @brief serial port usb cdc config struct*/
+typedef struct _serial_port_usb_cdc_config
+{
+    serial_port_usb_cdc_controller_index_t controllerIndex; /*!< controller index */
+} serial_port_usb_cdc_config_t;
+
+/*! @} */
+#endif /* __SERIAL_PORT_USB_H__ */
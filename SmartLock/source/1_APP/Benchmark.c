@@ -0,0 +1,983 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Benchmark.c
+	\date		October 19th, 2026
+	\brief		Entry point of the benchmark build (BENCHMARK_BUILD defined).
+				Times the HAL and HIL hot paths and prints a CSV report that
+				Tools/Bench/bench-compare checks against the stored baseline.
+				The same file is built on the host by Tools/Bench.
+*/
+//------------------------------------------------------------------------------
+#include <stdarg.h>
+#include <stdio.h>
+#include "MKL27Z644.h"
+
+#include "Password.h"
+#include "SmartLock.h"
+#include "Benchmark.h"
+#include "ClockProfile.h"
+#include "Bench.h"
+#include "fsl_str.h"
+#include "generic_list.h"
+#include "CRC.h"
+#include "PIT.h"
+#include "ADC.h"
+#include "Power.h"
+#include "Access.h"
+#include "RTC.h"
+#include "Aes.h"
+#include "Curve25519.h"
+#include "Hash.h"
+#include "Otp.h"
+#include "Credential.h"
+#include "Entry.h"
+#include "Pool.h"
+#include "RamFunc.h"
+
+#if defined(BENCHMARK_BUILD) || defined(HOST_SIMULATION)
+
+//------------------------------------------------------------------------------
+// Local Defines
+//------------------------------------------------------------------------------
+/*!
+    \def		LIST_ELEMENTS
+    \brief		Elements cycled through the generic_list benchmark
+*/
+#define			LIST_ELEMENTS		8
+
+/*!
+    \def		FORMAT_BUFFER
+    \brief		Size of the fsl_str output buffer
+*/
+#define			FORMAT_BUFFER		32
+
+/*!
+    \def		CRC_BLOCK
+    \brief		Bytes checked per CRC operation, the size of a flash record page
+*/
+#define			CRC_BLOCK			256
+
+/*!
+    \def		ACCESS_TIME
+    \brief		Local time of the access cases, Wednesday 2026-10-21 12:00
+*/
+#define			ACCESS_TIME			1792584000u
+
+/*!
+    \def		PIN_STRIDE
+    \brief		Step between the pins of consecutive users; keeps them unique
+    			and clear of the master password
+*/
+#define			PIN_STRIDE			37u
+
+/*!
+    \def		RULES
+    \brief		Rules of every schedule in the rule evaluation case
+*/
+#define			RULES				3
+
+//------------------------------------------------------------------------------
+// Local Types
+//------------------------------------------------------------------------------
+/*!
+    \struct		ACCESS_RULE
+    \brief		A schedule rule as uploaded: days from bit 0 Monday, and the
+    			minutes of the day it opens and closes at
+*/
+typedef struct
+{
+	uint8_t days;
+	uint16_t from;
+	uint16_t to;
+} ACCESS_RULE;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+    \var		sink
+    \brief		Results of the timed calls, kept so they are not optimized out
+*/
+static volatile uint32_t sink = 0;
+
+/*!
+    \var		list
+    \brief		List used by the generic_list benchmark
+*/
+static list_t list;
+
+/*!
+    \var		elements
+    \brief		Elements moved through the list
+*/
+static list_element_t elements[LIST_ELEMENTS];
+
+/*!
+    \var		formatBuffer
+    \brief		Output of the fsl_str benchmark
+*/
+static char formatBuffer[FORMAT_BUFFER];
+
+/*!
+    \var		crcBlock
+    \brief		Word-aligned buffer checked by the CRC benchmarks
+*/
+static uint32_t crcBlock[CRC_BLOCK / sizeof (uint32_t)];
+
+/*!
+    \var		adcBlock
+    \brief		Bandgap results of a 3 V supply fed to the power budget
+*/
+static uint16_t adcBlock[ADC_BLOCK];
+
+/*!
+    \var		rules
+    \brief		Office hours, Saturday morning and a night shift over midnight,
+    			the rules every benchmark schedule is compiled from
+*/
+static const ACCESS_RULE rules[RULES] = {
+		{0x1F, 8 * 60, 18 * 60},
+		{0x20, 9 * 60, 13 * 60},
+		{0x7F, 22 * 60, 6 * 60}
+};
+
+/*!
+    \var		firstPin
+    \brief		Pin of the first user of the table
+    \var		lastPin
+    \brief		Pin of the last user, found after scanning the whole table
+    \var		unknownPin
+    \brief		Pin of no user
+*/
+static uint8_t firstPin[4];
+static uint8_t lastPin[4];
+static uint8_t unknownPin[4] = {9, 9, 9, 9};
+
+/*!
+    \var		aesContext
+    \brief		Expanded key of the cipher cases
+    \var		aesKey
+    \brief		Key expanded by the key schedule case
+    \var		aesBlock
+    \brief		Block encrypted in place over and over
+*/
+static AES_CONTEXT aesContext;
+static uint8_t aesKey[AES_BLOCK];
+static uint8_t aesBlock[AES_BLOCK];
+
+/*!
+    \var		ccmNonce
+    \brief		Nonce of a session frame from the phone
+    \var		ccmPin
+    \brief		Four digits, the payload of a pin frame
+    \var		ccmFrame
+    \brief		The sealed pin, opened by the open case
+    \var		ccmTag
+    \brief		Tag of the sealed pin
+*/
+static uint8_t ccmNonce[AES_CCM_NONCE] = {1, 0, 0, 0, 1};
+static uint8_t ccmPin[4] = {1, 2, 3, 4};
+static uint8_t ccmFrame[4];
+static uint8_t ccmTag[AES_CCM_TAG];
+
+/*!
+    \var		curveScalar
+    \brief		Secret scalar of the key agreement case
+    \var		curveOut
+    \brief		Public key it computes
+*/
+static uint8_t curveScalar[CURVE25519_BYTES];
+static uint8_t curveOut[CURVE25519_BYTES];
+
+/*!
+    \var		hashContext
+    \brief		Hash the block cases feed
+    \var		hashBlock
+    \brief		One block of message
+*/
+static HASH_CONTEXT hashContext;
+static uint8_t hashBlock[HASH_BLOCK];
+
+/*!
+    \var		otpKeys
+    \brief		HMAC keys of the code cases, SHA-1 then SHA-256
+    \var		otpSlot
+    \brief		Generator of the lookup case, its table complete
+*/
+static HASH_HMAC_KEY otpKeys[eHASH_ALGORITHMS];
+static uint8_t otpSlot = 0;
+
+/*!
+    \var		sha512Context
+    \brief		Hash the SHA-512 block case feeds, over hashBlock twice
+*/
+static HASH_SHA512_CONTEXT sha512Context;
+
+/*!
+    \var		issuerKey
+    \brief		Public key of a test installer
+    \var		credential
+    \brief		Credential it signed for user 42, door 0, valid forever
+*/
+static const uint8_t issuerKey[ED25519_KEY] = {
+		0x24, 0xc3, 0xa4, 0x94, 0xfa, 0x22, 0x99, 0x62,
+		0x66, 0x44, 0xb9, 0x65, 0xa9, 0x13, 0x2d, 0xa7,
+		0x9c, 0xfe, 0x67, 0x15, 0x1f, 0xdc, 0x42, 0xde,
+		0x60, 0x0c, 0xf0, 0x90, 0x97, 0xdb, 0x82, 0x47
+};
+static const uint8_t credential[CREDENTIAL_BLOB] = {
+		0x01, 0x00, 0x2a, 0x00, 0x00, 0x00, 0x00, 0xff,
+		0xff, 0xff, 0xff, 0x00, 0x01, 0x05, 0x3a, 0x02,
+		0xf5, 0x8d, 0x69, 0xc2, 0xae, 0xed, 0x36, 0x7a,
+		0xc0, 0x10, 0x1b, 0xac, 0xb6, 0x34, 0xe2, 0x70,
+		0xae, 0x6a, 0xbe, 0x62, 0x0b, 0x56, 0x50, 0xa2,
+		0xc4, 0x23, 0x97, 0x15, 0x5e, 0xd5, 0x27, 0x9d,
+		0x26, 0x4d, 0x72, 0x04, 0x2d, 0x5b, 0xb5, 0x1b,
+		0x6e, 0x97, 0x58, 0x10, 0x56, 0x1c, 0xaf, 0x74,
+		0x52, 0x67, 0x5c, 0x3d, 0x20, 0x79, 0x04, 0xbe,
+		0xad, 0xc1, 0x59, 0x05, 0x04
+};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void vfnGpioSet (void);
+static void vfnGpioClear (void);
+static void vfnGpioRead (void);
+static void vfnMatrixScan (void);
+static void vfnMatrixUpdate (void);
+static void vfnKeypadTick (void);
+static void vfnPasswordCheck (void);
+static void vfnEntryPipeline (void);
+static void vfnUartTxByte (void);
+static void vfnStateDispatch (void);
+static void vfnStrPrintf (void);
+static void vfnListAddRemove (void);
+static void vfnPoolAllocFree (void);
+static void vfnUartRxByte (void);
+static void vfnCrc16Hardware (void);
+static void vfnCrc16Table (void);
+static void vfnCrc16Bitwise (void);
+static void vfnCrc32Hardware (void);
+static void vfnCrc32Table (void);
+static void vfnCrc32Bitwise (void);
+static void vfnCrc32Dma (void);
+static void vfnPowerBlock (void);
+static void vfnAccessFirst (void);
+static void vfnAccessLast (void);
+static void vfnAccessUnknown (void);
+static void vfnAccessBit (void);
+static void vfnAccessRules (void);
+static void vfnAccessCompile (void);
+static void vfnAesKeyExpand (void);
+static void vfnAesBlock (void);
+static void vfnCcmSealPin (void);
+static void vfnCcmOpenPin (void);
+static void vfnX25519 (void);
+static void vfnSha1Block (void);
+static void vfnSha256Block (void);
+static void vfnHotpSha1 (void);
+static void vfnHotpSha256 (void);
+static void vfnOtpLookup (void);
+static void vfnOtpWindow (void);
+static void vfnSha512Block (void);
+static void vfnEd25519Verify (void);
+static void vfnCredentialMiss (void);
+static void vfnCredentialHit (void);
+static void vfnAccessSchedule (uint8_t schedule);
+static void vfnAccessPin (uint16_t user, uint8_t *pin);
+
+/*!
+ 	 \var		benchCases
+ 	 \brief		Cases in report order. The names are the keys of the baseline.
+ */
+static const BENCH_CASE benchCases[] = {
+		{"gpio_set",			vfnGpioSet,			1000},
+		{"gpio_clear",			vfnGpioClear,		1000},
+		{"gpio_read",			vfnGpioRead,		1000},
+		{"matrix_scan",			vfnMatrixScan,		200},
+		{"matrix_update",		vfnMatrixUpdate,	200},
+		{"keypad_tick",			vfnKeypadTick,		200},
+		{"password_check",		vfnPasswordCheck,	1000},
+		{"entry_pipeline",		vfnEntryPipeline,	1000},
+		{"uart_tx_byte",		vfnUartTxByte,		32},
+		{"state_dispatch",		vfnStateDispatch,	200},
+		{"str_printf",			vfnStrPrintf,		100},
+		{"list_add_remove",		vfnListAddRemove,	200},
+		{"pool_alloc_free",		vfnPoolAllocFree,	1000},
+		{"crc16_hardware",		vfnCrc16Hardware,	20,		CRC_BLOCK},
+		{"crc16_table",			vfnCrc16Table,		20,		CRC_BLOCK},
+		{"crc16_bitwise",		vfnCrc16Bitwise,	20,		CRC_BLOCK},
+		{"crc32_hardware",		vfnCrc32Hardware,	20,		CRC_BLOCK},
+		{"crc32_table",			vfnCrc32Table,		20,		CRC_BLOCK},
+		{"crc32_bitwise",		vfnCrc32Bitwise,	20,		CRC_BLOCK},
+		{"crc32_dma",			vfnCrc32Dma,		20,		CRC_BLOCK},
+		{"power_block",			vfnPowerBlock,		200,	sizeof (adcBlock)},
+		{"access_first_user",	vfnAccessFirst,		1000},
+		{"access_last_user",	vfnAccessLast,		200},
+		{"access_unknown_pin",	vfnAccessUnknown,	200},
+		{"access_bit_test",		vfnAccessBit,		1000},
+		{"access_rule_eval",	vfnAccessRules,		200},
+		{"access_compile",		vfnAccessCompile,	20},
+		{"aes_key_expand",		vfnAesKeyExpand,	200},
+		{"aes_block",			vfnAesBlock,		200,	AES_BLOCK},
+		{"ccm_seal_pin",		vfnCcmSealPin,		200,	sizeof (ccmPin)},
+		{"ccm_open_pin",		vfnCcmOpenPin,		200,	sizeof (ccmPin)},
+		{"x25519",				vfnX25519,			1},
+		{"sha1_block",			vfnSha1Block,		200,	HASH_BLOCK},
+		{"sha256_block",		vfnSha256Block,		200,	HASH_BLOCK},
+		{"hotp_sha1",			vfnHotpSha1,		200},
+		{"hotp_sha256",			vfnHotpSha256,		200},
+		{"otp_lookup",			vfnOtpLookup,		1000},
+		{"otp_window_hmac",		vfnOtpWindow,		20},
+		{"sha512_block",		vfnSha512Block,		100,	HASH_SHA512_BLOCK},
+		{"ed25519_verify",		vfnEd25519Verify,	1},
+		{"credential_miss",		vfnCredentialMiss,	1},
+		{"credential_hit",		vfnCredentialHit,	200}
+};
+
+/*!
+ 	 \var		loopbackCases
+ 	 \brief		Cases run with the UART looped back on itself
+ */
+static const BENCH_CASE loopbackCases[] = {
+		{"uart_rx_byte",		vfnUartRxByte,		32}
+};
+
+//------------------------------------------------------------------------------
+// Benchmark cases
+//------------------------------------------------------------------------------
+static void vfnGpioSet (void)
+{
+	GPIO_bfnSetData (ePORTA, ePIN1);
+}
+
+static void vfnGpioClear (void)
+{
+	GPIO_bfnClearData (ePORTA, ePIN1);
+}
+
+static void vfnGpioRead (void)
+{
+	uint8_t value = 0;
+
+	GPIO_bfnReadData (ePORTD, ePIN4, &value);
+	sink += value;
+}
+
+/*!
+ 	 \fn		static void vfnMatrixScan (void)
+ 	 \brief		Full scan with no key pressed, the worst case of the keypad
+ */
+static void vfnMatrixScan (void)
+{
+	uint8_t row = 0;
+	uint8_t column = 0;
+
+	sink += Matrix_bfnMatrixRead (&row, &column);
+}
+
+/*!
+ 	 \fn		static void vfnMatrixUpdate (void)
+ 	 \brief		Bitmap scan plus ghost check and edge detection
+ */
+static void vfnMatrixUpdate (void)
+{
+	Matrix_vfnUpdate ();
+	sink += Matrix_wfnGetPressed ();
+}
+
+/*!
+ 	 \fn		static void vfnKeypadTick (void)
+ 	 \brief		One scan tick: a row read and the next one driven, plus the
+ 	 			frame processing every ROWS calls
+ */
+static void vfnKeypadTick (void)
+{
+	Matrix_vfnScanTick ();
+}
+
+/*!
+ 	 \fn		static void vfnPasswordCheck (void)
+ 	 \brief		A wrong keypad entry against the master pin and every user
+ */
+static void vfnPasswordCheck (void)
+{
+	sink += Password_bfnIsCorrect ();
+}
+
+/*!
+ 	 \fn		static void vfnEntryPipeline (void)
+ 	 \brief		A pin typed on the reader source and taken by the arbiter
+ */
+static void vfnEntryPipeline (void)
+{
+	ENTRY entry;
+	uint8_t i = 0;
+
+	for (i = 0; i < ENTRY_PIN; i++)
+	{
+		Entry_vfnPut (eENTRY_READER, i);
+	}
+	sink += Entry_bfnTake (&entry);
+}
+
+/*!
+ 	 \fn		static void vfnUartTxByte (void)
+ 	 \brief		Waits for the transmitter and queues one byte; at 9600 baud
+ 	 			this is dominated by the time on the wire
+ */
+static void vfnUartTxByte (void)
+{
+	uint8_t value = 'U';
+
+	while (!UART_bfnSend (&value))
+	{
+	}
+}
+
+/*!
+ 	 \fn		static void vfnUartRxByte (void)
+ 	 \brief		Sends one byte over the internal loopback and polls until it
+ 	 			is received
+ */
+static void vfnUartRxByte (void)
+{
+	uint8_t value = 'U';
+
+	while (!UART_bfnSend (&value))
+	{
+	}
+	while (!UART_bfnRead (&value))
+	{
+	}
+	sink += value;
+}
+
+/*!
+ 	 \fn		static void vfnStateDispatch (void)
+ 	 \brief		One pass of the idle main loop: clock task, state dispatch and
+ 	 			keypad poll with no entry pending
+ */
+static void vfnStateDispatch (void)
+{
+	SmartLock_vfnStep ();
+}
+
+/*!
+ 	 \fn		static void vfnStrCallback (char *buf, int32_t *indicator, char val, int len)
+ 	 \brief		fsl_str output callback writing into formatBuffer
+ */
+static void vfnStrCallback (char *buf, int32_t *indicator, char val, int len)
+{
+	int i = 0;
+
+	for (i = 0; i < len; i++)
+	{
+		if ((*indicator + 1) < FORMAT_BUFFER)
+		{
+			buf[*indicator] = val;
+			(*indicator)++;
+		}
+	}
+}
+
+static int ifnStrFormat (const char *fmt, ...)
+{
+	va_list ap;
+	int length;
+
+	va_start (ap, fmt);
+	length = StrFormatPrintf (fmt, ap, formatBuffer, vfnStrCallback);
+	va_end (ap);
+
+	return length;
+}
+
+/*!
+ 	 \fn		static void vfnStrPrintf (void)
+ 	 \brief		A line like the ones the firmware prints over the debug console
+ */
+static void vfnStrPrintf (void)
+{
+	sink += (uint32_t)ifnStrFormat ("key %d state %u %s", 7, 3u, "ok");
+}
+
+/*!
+ 	 \fn		static void vfnListAddRemove (void)
+ 	 \brief		Queues every element at the tail and drains them from the head
+ */
+static void vfnListAddRemove (void)
+{
+	uint8_t i = 0;
+
+	for (i = 0; i < LIST_ELEMENTS; i++)
+	{
+		LIST_AddTail (&list, &elements[i]);
+	}
+	for (i = 0; i < LIST_ELEMENTS; i++)
+	{
+		sink += (LIST_RemoveHead (&list) != NULL);
+	}
+}
+
+/*!
+ 	 \fn		static void vfnPoolAllocFree (void)
+ 	 \brief		Takes a block of each class and returns them, the second
+ 	 			one taken first
+ */
+static void vfnPoolAllocFree (void)
+{
+	void *small = Pool_pvfnAlloc (ED25519_KEY);
+	void *large = Pool_pvfnAlloc (CREDENTIAL_BLOB);
+
+	sink += (small != NULL) + (large != NULL);
+	Pool_vfnFree (large);
+	Pool_vfnFree (small);
+}
+
+/*!
+ 	 \fn		static void vfnCrc16Hardware (void)
+ 	 \brief		CRC of one block per engine and preset. On the host the
+ 	 			hardware and DMA cases run the table engine.
+ */
+static void vfnCrc16Hardware (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC16_CCITT, eCRC_HARDWARE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+static void vfnCrc16Table (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC16_CCITT, eCRC_TABLE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+static void vfnCrc16Bitwise (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC16_CCITT, eCRC_BITWISE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+static void vfnCrc32Hardware (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC32, eCRC_HARDWARE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+static void vfnCrc32Table (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC32, eCRC_TABLE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+static void vfnCrc32Bitwise (void)
+{
+	sink += CRC_dwfnComputeWith (eCRC32, eCRC_BITWISE, (const uint8_t *)crcBlock, CRC_BLOCK);
+}
+
+/*!
+ 	 \fn		static void vfnCrc32Dma (void)
+ 	 \brief		Same block fed by DMA, polled to completion. On target this
+ 	 			is the DMA setup cost plus the transfer time.
+ */
+static void vfnCrc32Dma (void)
+{
+	CRC_CONTEXT context;
+
+	CRC_vfnStart (&context, eCRC32);
+	CRC_bfnUpdateDma (&context, (const uint8_t *)crcBlock, CRC_BLOCK, NULL);
+	sink += CRC_dwfnFinal (&context);
+}
+
+/*!
+ 	 \fn		static void vfnPowerBlock (void)
+ 	 \brief		The work of one ADC block interrupt: mean, sag and filter
+ */
+static void vfnPowerBlock (void)
+{
+	Power_vfnSamples (adcBlock, ADC_BLOCK);
+	sink += Power_wfnGetMillivolts ();
+}
+
+/*!
+ 	 \fn		static void vfnAccessFirst (void)
+ 	 \brief		Authorisation of the first user of a full table
+ */
+static void vfnAccessFirst (void)
+{
+	sink += Access_bfnAuthorize (firstPin, ENTRY_PIN);
+}
+
+/*!
+ 	 \fn		static void vfnAccessLast (void)
+ 	 \brief		Authorisation of the last user, the longest lookup
+ */
+static void vfnAccessLast (void)
+{
+	sink += Access_bfnAuthorize (lastPin, ENTRY_PIN);
+}
+
+/*!
+ 	 \fn		static void vfnAccessUnknown (void)
+ 	 \brief		A wrong pin, refused after the whole table
+ */
+static void vfnAccessUnknown (void)
+{
+	sink += Access_bfnAuthorize (unknownPin, ENTRY_PIN);
+}
+
+/*!
+ 	 \fn		static void vfnAccessBit (void)
+ 	 \brief		The schedule part of an authorisation: one bit test
+ */
+static void vfnAccessBit (void)
+{
+	sink += Access_bfnIsOpen (1);
+}
+
+/*!
+ 	 \fn		static void vfnAccessRules (void)
+ 	 \brief		The same check done without the bitmaps: the time read and
+ 	 			split into weekday and minute, then every rule of the
+ 	 			schedule tested, a night rule also from the day before
+ */
+static void vfnAccessRules (void)
+{
+	uint32_t seconds = RTC_dwfnGetTime ();
+	uint32_t days = seconds / 86400u;
+	uint16_t minute = (uint16_t)((seconds - (days * 86400u)) / 60u);
+	uint8_t today = (uint8_t)((days + 3u) % 7u);
+	uint8_t yesterday = (uint8_t)((today + 6u) % 7u);
+	uint8_t isOpen = 0;
+	uint8_t i = 0;
+
+	for (i = 0; (i < RULES) && !isOpen; i++)
+	{
+		if (rules[i].from < rules[i].to)
+		{
+			isOpen = (rules[i].days & (1u << today)) && (minute >= rules[i].from)
+					&& (minute < rules[i].to);
+		}
+		else
+		{
+			isOpen = ((rules[i].days & (1u << today)) && (minute >= rules[i].from))
+					|| ((rules[i].days & (1u << yesterday)) && (minute < rules[i].to));
+		}
+	}
+	sink += isOpen;
+}
+
+/*!
+ 	 \fn		static void vfnAccessCompile (void)
+ 	 \brief		Upload of a schedule: its bitmap cleared and every rule set
+ */
+static void vfnAccessCompile (void)
+{
+	vfnAccessSchedule (0);
+}
+
+/*!
+ 	 \fn		static void vfnAesKeyExpand (void)
+ 	 \brief		Key schedule, run once per session key and per step of the
+ 	 			key derivation
+*/
+static void vfnAesKeyExpand (void)
+{
+	Aes_vfnSetKey (&aesContext, aesKey);
+}
+
+/*!
+ 	 \fn		static void vfnAesBlock (void)
+ 	 \brief		One block through the ten rounds
+*/
+static void vfnAesBlock (void)
+{
+	Aes_vfnEncrypt (&aesContext, aesBlock, aesBlock);
+}
+
+/*!
+ 	 \fn		static void vfnCcmSealPin (void)
+ 	 \brief		A pin frame sealed: the first MAC block, one payload block
+ 	 			and two key stream blocks
+*/
+static void vfnCcmSealPin (void)
+{
+	Aes_vfnCcmSeal (&aesContext, ccmNonce, 0, 0, ccmPin, sizeof (ccmPin), ccmFrame, ccmTag);
+}
+
+/*!
+ 	 \fn		static void vfnCcmOpenPin (void)
+ 	 \brief		The same frame opened and its tag checked, what the lock
+ 	 			does with every frame from the phone
+*/
+static void vfnCcmOpenPin (void)
+{
+	uint8_t pin[sizeof (ccmPin)];
+
+	sink += Aes_bfnCcmOpen (&aesContext, ccmNonce, 0, 0, ccmFrame, sizeof (ccmFrame), ccmTag, pin);
+}
+
+/*!
+ 	 \fn		static void vfnX25519 (void)
+ 	 \brief		One Montgomery ladder and inversion; pairing runs two
+*/
+static void vfnX25519 (void)
+{
+	Curve25519_vfnX25519Base (curveOut, curveScalar);
+	sink += curveOut[0];
+}
+
+/*!
+ 	 \fn		static void vfnSha1Block (void)
+ 	 \brief		One SHA-1 compression
+*/
+static void vfnSha1Block (void)
+{
+	hashContext.algorithm = eHASH_SHA1;
+	Hash_vfnUpdate (&hashContext, hashBlock, HASH_BLOCK);
+}
+
+/*!
+ 	 \fn		static void vfnSha256Block (void)
+ 	 \brief		One SHA-256 compression
+*/
+static void vfnSha256Block (void)
+{
+	hashContext.algorithm = eHASH_SHA256;
+	Hash_vfnUpdate (&hashContext, hashBlock, HASH_BLOCK);
+}
+
+/*!
+ 	 \fn		static void vfnHotpSha1 (void)
+ 	 \brief		One code from a kept key: two compressions and the
+ 	 			truncation, what filling one table entry costs
+*/
+static void vfnHotpSha1 (void)
+{
+	sink += Otp_dwfnCode (&otpKeys[eHASH_SHA1], sink, OTP_DIGITS);
+}
+
+/*!
+ 	 \fn		static void vfnHotpSha256 (void)
+ 	 \brief		The same over SHA-256
+*/
+static void vfnHotpSha256 (void)
+{
+	sink += Otp_dwfnCode (&otpKeys[eHASH_SHA256], sink, OTP_DIGITS);
+}
+
+/*!
+ 	 \fn		static void vfnOtpLookup (void)
+ 	 \brief		A wrong code checked against a complete HOTP table, the
+ 	 			whole window scanned
+*/
+static void vfnOtpLookup (void)
+{
+	sink += Otp_bfnMatch (otpSlot, 10000u);
+}
+
+/*!
+ 	 \fn		static void vfnOtpWindow (void)
+ 	 \brief		The same check without the table: one HMAC per counter of
+ 	 			the window
+*/
+static void vfnOtpWindow (void)
+{
+	uint32_t counter = 0;
+
+	for (counter = 0; counter < OTP_WINDOW; counter++)
+	{
+		sink += (Otp_dwfnCode (&otpKeys[eHASH_SHA1], counter, OTP_DIGITS) == 10000u);
+	}
+}
+
+/*!
+ 	 \fn		static void vfnSha512Block (void)
+ 	 \brief		One SHA-512 compression, 64-bit words on a 32-bit core
+*/
+static void vfnSha512Block (void)
+{
+	Hash_vfnSha512Update (&sha512Context, hashBlock, HASH_BLOCK);
+	Hash_vfnSha512Update (&sha512Context, hashBlock, HASH_BLOCK);
+}
+
+/*!
+ 	 \fn		static void vfnEd25519Verify (void)
+ 	 \brief		One signature check of a credential body
+*/
+static void vfnEd25519Verify (void)
+{
+	sink += Ed25519_bfnVerify (&credential[CREDENTIAL_BODY], issuerKey, credential, CREDENTIAL_BODY);
+}
+
+/*!
+ 	 \fn		static void vfnCredentialMiss (void)
+ 	 \brief		A credential the cache does not know: fingerprint, signature
+ 	 			check and insertion. The bench lock is door 1, so every
+ 	 			check runs and the door stays shut.
+*/
+static void vfnCredentialMiss (void)
+{
+	uint16_t user = 0;
+
+	Credential_vfnFlush ();
+	sink += (uint32_t)Credential_efnPresent (credential, &user);
+}
+
+/*!
+ 	 \fn		static void vfnCredentialHit (void)
+ 	 \brief		The same credential presented again: fingerprint and lookup
+*/
+static void vfnCredentialHit (void)
+{
+	uint16_t user = 0;
+
+	sink += (uint32_t)Credential_efnPresent (credential, &user);
+}
+
+/*!
+ 	 \fn		static void vfnAccessSchedule (uint8_t schedule)
+ 	 \param		schedule	Schedule to compile from the rules
+ */
+static void vfnAccessSchedule (uint8_t schedule)
+{
+	uint8_t i = 0;
+
+	Access_efnClearSchedule (schedule);
+	for (i = 0; i < RULES; i++)
+	{
+		Access_efnAddRule (schedule, rules[i].days, (uint8_t)(rules[i].from / 15u),
+				(uint8_t)((rules[i].to + 14u) / 15u));
+	}
+}
+
+/*!
+ 	 \fn		static void vfnAccessPin (uint16_t user, uint8_t *pin)
+ 	 \param		user	Entry of the user table
+ 	 \param		pin		Receives the four digits of the user
+ */
+static void vfnAccessPin (uint16_t user, uint8_t *pin)
+{
+	uint16_t value = (uint16_t)(user * PIN_STRIDE);
+	uint8_t i = 0;
+
+	for (i = 4; i > 0; i--)
+	{
+		pin[i - 1u] = (uint8_t)(value % 10u);
+		value /= 10u;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+ 	 \fn		void Benchmark_vfnRun (void)
+ 	 \brief		Brings up the firmware at full speed and prints the report
+ */
+void Benchmark_vfnRun (void)
+{
+	CREDENTIAL_STATS credentialStats;
+	uint32_t i = 0;
+
+	SmartLock_vfnInit ();
+
+	/* The cases call the keypad scan themselves; no tick may interleave */
+	Matrix_vfnStopScan ();
+	PIT_vfnStop (ePIT_SYSTEM);
+
+	/* Keep the core at a fixed clock so every case is counted alike */
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+	ClockProfile_vfnTask ();
+
+	GPIO_vfnPortInit (ePORTA, ePIN1, eOUTPUT);
+	LIST_Init (&list, 0);
+	for (i = 0; i < (CRC_BLOCK / sizeof (uint32_t)); i++)
+	{
+		crcBlock[i] = i * 0x9E3779B9u;
+	}
+	for (i = 0; i < ADC_BLOCK; i++)
+	{
+		adcBlock[i] = (uint16_t)(1365u + (i & 3u));
+	}
+
+	/* A full user table over every schedule, all compiled from the same rules */
+	Access_vfnSetTime (ACCESS_TIME);
+	for (i = 0; i < ACCESS_SCHEDULES; i++)
+	{
+		vfnAccessSchedule ((uint8_t)i);
+	}
+	for (i = 0; i < ACCESS_USERS; i++)
+	{
+		vfnAccessPin ((uint16_t)i, lastPin);
+		Access_efnSetUser ((uint16_t)i, lastPin, (uint8_t)(i % ACCESS_SCHEDULES));
+	}
+	vfnAccessPin (0, firstPin);
+
+	/* The entry the password case evaluates, 0000 from the keypad */
+	for (i = 0; i < ENTRY_PIN; i++)
+	{
+		Entry_vfnPut (eENTRY_KEYPAD, 0);
+	}
+	Password_bfnEntryReady ();
+
+	/* A valid frame for the open case; the key never changes the timing */
+	for (i = 0; i < AES_BLOCK; i++)
+	{
+		aesKey[i] = (uint8_t)(i * 17u);
+	}
+	for (i = 0; i < CURVE25519_BYTES; i++)
+	{
+		curveScalar[i] = (uint8_t)(i * 29u + 7u);
+	}
+	Aes_vfnSetKey (&aesContext, aesKey);
+	vfnCcmSealPin ();
+
+	/* The AES key doubles as the OTP secret; the table filled ahead */
+	Hash_vfnStart (&hashContext, eHASH_SHA1);
+	Hash_vfnHmacKey (&otpKeys[eHASH_SHA1], eHASH_SHA1, aesKey, AES_BLOCK);
+	Hash_vfnHmacKey (&otpKeys[eHASH_SHA256], eHASH_SHA256, aesKey, AES_BLOCK);
+	otpSlot = Otp_bfnAdd (eOTP_HOTP_SHA1, aesKey, AES_BLOCK, 0);
+	for (i = 0; i < OTP_WINDOW; i++)
+	{
+		Otp_vfnTask ();
+	}
+
+	/* A credential for another door, so a hit never opens the lock */
+	Hash_vfnSha512Start (&sha512Context);
+	Credential_vfnSetIssuer (issuerKey);
+	Credential_vfnSetDoor (1);
+
+	Bench_vfnHeader ();
+	/* Placement of the RAMFUNC_HOT paths, to tell two captures apart */
+#ifdef RAMFUNC_HOT_ENABLE
+	printf ("# hot paths: ram\n");
+#else
+	printf ("# hot paths: flash\n");
+#endif
+	Bench_vfnRun (benchCases, sizeof (benchCases) / sizeof (benchCases[0]));
+	Credential_vfnGetStats (&credentialStats);
+	printf ("# credential_cache: %lu hits in %lu presented; %lu verified\n",
+			(unsigned long)credentialStats.hits, (unsigned long)credentialStats.presented,
+			(unsigned long)credentialStats.verified);
+
+	/* The transmitted bytes must not pile up in the receiver before this */
+	UART_vfnLoopback (1);
+	Bench_vfnRun (loopbackCases, sizeof (loopbackCases) / sizeof (loopbackCases[0]));
+	UART_vfnLoopback (0);
+}
+
+#ifdef BENCHMARK_BUILD
+/*!
+ 	 \fn		int main(void)
+ 	 \return	Returns 0
+ 	 \brief		Runs the benchmarks once and idles
+ */
+int main(void)
+{
+	Benchmark_vfnRun ();
+
+    while(1)
+    {
+    }
+    return 0 ;
+}
+#endif
+
+#endif /* BENCHMARK_BUILD || HOST_SIMULATION */
@@ -0,0 +1,16 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Benchmark.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the benchmark build entry point
+*/
+//------------------------------------------------------------------------------
+#ifndef _1_APP_BENCHMARK_H_
+#define _1_APP_BENCHMARK_H_
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Benchmark_vfnRun (void);
+
+#endif /* _1_APP_BENCHMARK_H_ */
@@ -41,6 +41,23 @@
 #include "Control.h"
 #include "Indicators.h"
 #include "Password.h"
+#include "SmartLock.h"
+#include "Boot.h"
+#include "ClockProfile.h"
+#include "Timebase.h"
+#include "PIT.h"
+#include "PORT.h"
+#include "Protocol.h"
+#include "Power.h"
+#include "Update.h"
+#include "Crash.h"
+#include "Watchdog.h"
+#include "Access.h"
+#include "Session.h"
+#include "Otp.h"
+#include "Entry.h"
+#include "Pool.h"
+#include "Stack.h"
 
 //------------------------------------------------------------------------------
 // Local Defines
@@ -57,6 +74,15 @@
 */
 #define 		FALSE 		0
 
+/*!
+    \def		MAIN_DEADLINE_MS
+    \brief		Longest time between two main loop heartbeats before the
+    			watchdog resets. The supply wait (up to 3 s) and the relay
+    			pulses (1 s each) check in as they go, so the longest stretch
+    			without one is an indicator blink of 0.6 s.
+*/
+#define			MAIN_DEADLINE_MS	3000u
+
 //------------------------------------------------------------------------------
 // Enums
 //------------------------------------------------------------------------------
@@ -95,6 +121,12 @@ static uint8_t isPasswordCorrect = 0;
  */
 static uint8_t numErrors = 0;
 
+/*!
+ 	 \var		stateVariable
+ 	 \brief		State in which the state machine currently is
+ */
+static uint8_t stateVariable = eSTATE_ZERO;
+
 //------------------------------------------------------------------------------
 // Local Functions prototypes
 //------------------------------------------------------------------------------
@@ -118,39 +150,118 @@ void (*fnPtrArr[])(uint8_t *stateVar) = {
 		 vfnStateTwoLockdownOff
 };
 
+#if !defined(HOST_SIMULATION) && !defined(BENCHMARK_BUILD)
 /*!
  	 \fn		in main(void)
  	 \return	Returns 0
- 	 \brief		Where the program starts executing and the state machine is
+ 	 \brief		Where the program starts executing and the state machine is.
+ 	 			While the state machine waits for a pin the core sleeps until
+ 	 			the next interrupt: the scan tick, the system tick or a
+ 	 			Bluetooth byte.
  */
 int main(void)
 {
-  	/* Init board hardware. */
-	Password_vfnDriverInit ();
-	Indicators_vfnDriverInit ();
-	Control_vfnDriverInit ();
-
-	/* Define the state variable */
-	static uint8_t _StateVariable = eSTATE_ZERO;
+	/* Paint the stack before anything runs deep on it */
+	Stack_vfnInit ();
+	SmartLock_vfnInit ();
 
     /* Enter an infinite loop */
     while(1)
     {
-    	(*fnPtrArr[_StateVariable])(&_StateVariable);
+    	SmartLock_vfnStep ();
+    	if (stateVariable == eSTATE_ZERO)
+    	{
+    		__WFI ();
+    	}
     }
     return 0 ;
 }
+#endif
+
+/*!
+ 	 \fn		void SmartLock_vfnInit (void)
+ 	 \brief		Brings up the services and drivers needed before the first step
+ 	 			of the state machine. The host simulator calls it instead of main().
+ */
+void SmartLock_vfnInit (void)
+{
+	/* Start the cycle counter and stamp the time spent before main */
+	Timebase_vfnInit ();
+	Boot_vfnStamp (eBOOT_MAIN);
+
+	/* Keep the record of a fault and the state from before the reset */
+	Crash_vfnInit ();
+	Control_vfnRestore ();
+	Crash_bfnRecall (eCRASH_RETAIN_ERRORS, &numErrors);
+	Watchdog_vfnInit ();
+	Watchdog_vfnRegister (eWATCHDOG_MAIN, MAIN_DEADLINE_MS);
+
+	/* Start from the 8 MHz profile; the first pass of the loop drops to VLPR */
+	ClockProfile_vfnInit ();
+
+	/* The system tick paces the main loop; the keypad adds the scan tick */
+	PIT_vfnDriverInit ();
+	Timebase_vfnStartTick ();
+
+  	/* Init board hardware. Only the keypad, bluetooth, the supply
+  	 * monitor and the RTC are brought up here; the indicators and
+  	 * control drivers initialize themselves the first time they are
+  	 * used. */
+	Pool_vfnInit ();
+	Password_vfnDriverInit ();
+	Power_vfnInit ();
+	Access_vfnInit ();
+#ifdef FOTA_ENABLE
+	Update_vfnInit ();
+#endif
+
+	stateVariable = eSTATE_ZERO;
+	Crash_vfnReady ();
+}
+
+/*!
+ 	 \fn		void SmartLock_vfnStep (void)
+ 	 \brief		One pass of the main loop: applies the pending clock profile,
+ 	 			runs a waiting management command, computes the next one-time
+ 	 			code of the look-ahead tables, expires the abandoned entries,
+ 	 			arms the settled pin interrupts and dispatches the current state of the state machine,
+ 	 			tracing every state change.
+ */
+void SmartLock_vfnStep (void)
+{
+	uint8_t previousState = stateVariable;
+
+	Watchdog_vfnKick (eWATCHDOG_MAIN);
+	ClockProfile_vfnTask ();
+	Protocol_vfnTask ();
+	Otp_vfnTask ();
+	Entry_vfnTask ();
+	PORT_vfnTask ();
+	(*fnPtrArr[stateVariable])(&stateVariable);
+	if (stateVariable != previousState)
+	{
+		Crash_vfnTrace (eCRASH_EVENT_STATE, stateVariable);
+	}
+}
 
 /*!
  	 \fn		void vfnStateZero (uint8_t *stateVar)
  	 \param		stateVar Receives in which state the state machine currently is.
  	 \brief		The initial function and default state of the state machine.
-				It determines what to do if the introduced pin was correct or
-				not. If it was, changes to eSTATE_ONE_CORRECT state; else, changes to
-				eSTATE_ONE_WRONG state.
+				It polls the keypad and, once a complete pin was introduced,
+				determines if it was correct or not. If it was, changes to
+				eSTATE_ONE_CORRECT state; else, changes to eSTATE_ONE_WRONG state.
  */
 void vfnStateZero (uint8_t *stateVar)
 {
+	Password_vfnKeypadTask ();
+	if (!Password_bfnEntryReady ())
+	{
+		return;
+	}
+
+	/* Run fast until the state machine is back in this state */
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
 	isPasswordCorrect = Password_bfnIsCorrect ();
 	if (isPasswordCorrect)
 	{
@@ -166,6 +277,7 @@ void vfnStateZero (uint8_t *stateVar)
  	 \fn		void vfnStateOneCorrect (uint8_t *stateVar)
  	 \param		stateVar Receives in which state the state machine currently is.
  	 \brief		This state is called when the introduced pin is correct. This
+ 	  	  	  	opens the pairing window of the Bluetooth session and
  	  	  	  	calls Indicators_bfnCorrectPin() function to blink the green LED
  	  	  	  	and play a high-pitched tone. Then changes the state to
  	  	  	  	eSTATE_TWO_CORRECT.
@@ -173,6 +285,8 @@ void vfnStateZero (uint8_t *stateVar)
 void vfnStateOneCorrect (uint8_t *stateVar)
 {
 	numErrors = 0;
+	Crash_vfnRetain (eCRASH_RETAIN_ERRORS, numErrors);
+	Session_vfnAllowPairing ();
 	Indicators_bfnCorrectPin ();
 
 #if 0
@@ -199,6 +313,7 @@ void vfnStateOneCorrect (uint8_t *stateVar)
 void vfnStateOneWrong (uint8_t *stateVar)
 {
 	numErrors++;
+	Crash_vfnRetain (eCRASH_RETAIN_ERRORS, numErrors);
 	Indicators_bfnWrongPin ();
 #if 0
 	if (numErrors >= 3)
@@ -210,6 +325,7 @@ void vfnStateOneWrong (uint8_t *stateVar)
 		*stateVar = eSTATE_ZERO;
 	}
 #endif
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
 	*stateVar = eSTATE_ZERO;
 }
 
@@ -223,6 +339,7 @@ void vfnStateOneWrong (uint8_t *stateVar)
 void vfnStateTwoCorrect (uint8_t *stateVar)
 {
 	Control_bfnCorrectPin ();
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
 	*stateVar = eSTATE_ZERO;
 }
 
@@ -236,6 +353,7 @@ void vfnStateTwoCorrect (uint8_t *stateVar)
 void vfnStateTwoLockdownOn (uint8_t *stateVar)
 {
 	Control_bfnLockdownOn ();
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
 	*stateVar = eSTATE_ZERO;
 }
 
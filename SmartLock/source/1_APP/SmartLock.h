@@ -0,0 +1,20 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	SmartLock.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the main application control, split in
+				an init and a step so the state machine can also be driven by
+				the host simulator
+*/
+//------------------------------------------------------------------------------
+#ifndef _1_APP_SMARTLOCK_H_
+#define _1_APP_SMARTLOCK_H_
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void SmartLock_vfnInit (void);
+
+void SmartLock_vfnStep (void);
+
+#endif /* _1_APP_SMARTLOCK_H_ */
@@ -53,6 +53,10 @@
 // In most cases this will allow applications containing semihosting
 // operations to execute (to some degree) when the debugger is not connected.
 //
+// Any other hard fault is handed to Crash_vfnFault, which stores the stacked
+// registers in no-init RAM and resets the board, instead of hanging it until
+// a power cycle.
+//
 // == NOTE ==
 //
 // Correct execution of the application containing semihosted operations
@@ -87,7 +91,11 @@ void HardFault_Handler(void){
             "LDR    R3,=0xBEAB \n"
             "CMP     R2,R3 \n"
             "BEQ    _semihost_return \n"
-        // Wasn't semihosting instruction so enter infinite loop
+        // Wasn't semihosting instruction: store the crash record and
+        // reset. Crash_vfnFault takes the frame in R0 and EXC_RETURN in R1
+        // and does not return.
+            "MOV    R1, LR \n"
+            "BL     Crash_vfnFault \n"
             "B . \n"
         // Was semihosting instruction, so adjust location to
         // return to by 1 instruction (2 bytes), then exit function
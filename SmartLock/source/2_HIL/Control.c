@@ -13,6 +13,10 @@
 #include "Control.h"
 #include "GPIO.h"
 #include "serviceLayer.h"
+#include "Boot.h"
+#include "Power.h"
+#include "Crash.h"
+#include "Watchdog.h"
 
 //------------------------------------------------------------------------------
 // Defines
@@ -29,6 +33,18 @@
 */
 #define		FALSE 		0
 
+/*!
+    \def		PULSE_COUNT
+    \brief		delay() count of a relay or motor pulse
+*/
+#define		PULSE_COUNT		2000000
+
+/*!
+    \def		PULSE_SLICES
+    \brief		Parts a pulse is split in to check the supply between them
+*/
+#define		PULSE_SLICES	20
+
 //------------------------------------------------------------------------------
 // Variables
 //------------------------------------------------------------------------------
@@ -38,6 +54,19 @@
 */
 static uint8_t inLockdown = FALSE;
 
+/*!
+    \var		isInitialized
+    \brief		Flag to show if the control pins were already initialized. The
+    			relay boards are active low with their own pull-ups, so the
+    			outputs can stay unconfigured until the first actuation.
+*/
+static uint8_t isInitialized = FALSE;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint8_t Control_bfnPulse (PORTS port, PINS pin, POWER_LOAD load);
+
 //--------------------------------------------------------------------------
 // Functions
 //--------------------------------------------------------------------------
@@ -66,28 +95,37 @@ void Control_vfnDriverInit (void)
 	GPIO_bfnSetData (ePORTB, ePIN0);
 	GPIO_bfnSetData (ePORTB, ePIN1);
 	GPIO_bfnSetData (ePORTA, ePIN12);
+
+	isInitialized = TRUE;
+	Boot_vfnStamp (eBOOT_CONTROL_READY);
 }
 
 /*!
  	 \fn		uint8_t Control_bfnCorrectPin (void)
- 	 \return	Returns 1 when the process is finalized.
+ 	 \return	Returns 1 when the process is finalized; else, the supply
+ 	 			could not take the solenoid and returns 0.
  	 \brief		When called, this function activates the solenoid relay and,
 				if in lockdown, deactivates the window pin.
  */
 uint8_t Control_bfnCorrectPin (void)
 {
+	if (!isInitialized)
+	{
+		Control_vfnDriverInit ();
+	}
+
 	// Activate the solenoid relay
-	GPIO_bfnClearData (ePORTA, ePIN12);
-	delay (2000000);
-	GPIO_bfnSetData (ePORTA, ePIN12);
+	if (!Control_bfnPulse (ePORTA, ePIN12, ePOWER_LOAD_SOLENOID))
+	{
+		return 0;
+	}
 
 	// Unlock the window pin if enabled
 	if (inLockdown)
 	{
-		GPIO_bfnClearData (ePORTB, ePIN0);
-		delay (2000000);
-		GPIO_bfnSetData (ePORTB, ePIN0);
+		Control_bfnPulse (ePORTB, ePIN0, ePOWER_LOAD_MOTOR);
 		inLockdown = TRUE;
+		Crash_vfnRetain (eCRASH_RETAIN_LOCKDOWN, inLockdown);
 	}
 
 	return 1;
@@ -102,13 +140,16 @@ uint8_t Control_bfnCorrectPin (void)
  */
 uint8_t Control_bfnLockdownOn (void)
 {
+	if (!isInitialized)
+	{
+		Control_vfnDriverInit ();
+	}
+
 	// Activate the motor forward
-	if (!inLockdown)
+	if (!inLockdown && Control_bfnPulse (ePORTB, ePIN0, ePOWER_LOAD_MOTOR))
 	{
-		GPIO_bfnClearData (ePORTB, ePIN0);
-		delay (2000000);
-		GPIO_bfnSetData (ePORTB, ePIN0);
 		inLockdown = TRUE;
+		Crash_vfnRetain (eCRASH_RETAIN_LOCKDOWN, inLockdown);
 
 		return 1;
 	}
@@ -126,13 +167,16 @@ uint8_t Control_bfnLockdownOn (void)
  */
 uint8_t Control_bfnLockdownOff (void)
 {
+	if (!isInitialized)
+	{
+		Control_vfnDriverInit ();
+	}
+
 	// Activate the motor backwards
-	if (inLockdown)
+	if (inLockdown && Control_bfnPulse (ePORTB, ePIN1, ePOWER_LOAD_MOTOR))
 	{
-		GPIO_bfnClearData (ePORTB, ePIN1);
-		delay (2000000);
-		GPIO_bfnSetData (ePORTB, ePIN1);
 		inLockdown = FALSE;
+		Crash_vfnRetain (eCRASH_RETAIN_LOCKDOWN, inLockdown);
 
 		return 1;
 	}
@@ -141,3 +185,53 @@ uint8_t Control_bfnLockdownOff (void)
 		return 0;
 	}
 }
+
+/*!
+ 	 \fn		void Control_vfnRestore (void)
+ 	 \brief		Takes back the window pin position kept over a reset. The
+ 	 			motor is not moved: the pin is still where it was left.
+ */
+void Control_vfnRestore (void)
+{
+	Crash_bfnRecall (eCRASH_RETAIN_LOCKDOWN, &inLockdown);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+ 	 \fn		static uint8_t Control_bfnPulse (PORTS port, PINS pin, POWER_LOAD load)
+ 	 \param		port	Port of the active low relay or bridge input
+ 	 \param		pin		Pin of the active low relay or bridge input
+ 	 \param		load	Load switched by the pin
+ 	 \return	Returns 1 if the pulse was given; else, the power budget
+ 	 			refused the load and returns 0.
+ 	 \brief		Drives one pulse once the supply can take it, and ends it
+ 	 			early if the supply sags to the brown-out limit. Every slice
+ 	 			checks in for the main loop, whose pass the pulse blocks.
+ */
+static uint8_t Control_bfnPulse (PORTS port, PINS pin, POWER_LOAD load)
+{
+	uint8_t slice = 0;
+
+	if (!Power_bfnRequest (load))
+	{
+		return 0;
+	}
+
+	Crash_vfnTrace (eCRASH_EVENT_PULSE, (uint8_t)load);
+	GPIO_bfnClearData (port, pin);
+	for (slice = 0; slice < PULSE_SLICES; slice++)
+	{
+		Watchdog_vfnKick (eWATCHDOG_MAIN);
+		delay (PULSE_COUNT / PULSE_SLICES);
+		if (Power_bfnSagging ())
+		{
+			break;
+		}
+	}
+	GPIO_bfnSetData (port, pin);
+	Power_vfnRelease ();
+
+	return 1;
+}
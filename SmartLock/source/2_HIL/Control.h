@@ -21,4 +21,6 @@ uint8_t Control_bfnLockdownOn (void);
 
 uint8_t Control_bfnLockdownOff (void);
 
+void Control_vfnRestore (void);
+
 #endif /* 2_HIL_CONTROL_H_ */
@@ -13,6 +13,18 @@
 #include "GPIO.h"
 #include "PWM.h"
 #include "serviceLayer.h"
+#include "Boot.h"
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+    \var			isInitialized
+    \brief			Flag to show if the LEDs and buzzer were already initialized.
+    				The driver is brought up the first time it is used so it
+    				does not delay the keypad at boot.
+*/
+static uint8_t isInitialized = 0;
 
 //--------------------------------------------------------------------------
 // Functions
@@ -30,6 +42,9 @@ void Indicators_vfnDriverInit ()
 	GPIO_vfnPortInit(ePORTA, ePIN2, eOUTPUT);
 	// PTB18 as PWM output
 	PWM_vfnDriverInit();
+
+	isInitialized = 1;
+	Boot_vfnStamp (eBOOT_INDICATORS_READY);
 }
 
 /*!
@@ -43,6 +58,10 @@ void Indicators_vfnDriverInit ()
 uint8_t Indicators_bfnCorrectPin ()
 {
 	uint8_t i = 0;
+	if (!isInitialized)
+	{
+		Indicators_vfnDriverInit ();
+	}
 	PWM_bfnChangeCounter (500);
 	PWM_vfnToggleSignal ();
 	for (i = 0; i < 3; i++)
@@ -68,6 +87,10 @@ uint8_t Indicators_bfnCorrectPin ()
 uint8_t Indicators_bfnWrongPin ()
 {
 	uint8_t i = 0;
+	if (!isInitialized)
+	{
+		Indicators_vfnDriverInit ();
+	}
 	PWM_bfnChangeCounter (1000);
 	PWM_vfnToggleSignal ();
 	for (i = 0; i < 3; i++)
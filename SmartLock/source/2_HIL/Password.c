@@ -10,6 +10,16 @@
 // Includes
 //------------------------------------------------------------------------------
 #include "Password.h"
+#include "Boot.h"
+#include "PIT.h"
+#include "FLEXIO.h"
+#include "Timebase.h"
+#include "Protocol.h"
+#include "Watchdog.h"
+#include "Access.h"
+#include "Session.h"
+#include "Credential.h"
+#include "Entry.h"
 #include <stdio.h>
 
 //------------------------------------------------------------------------------
@@ -47,6 +57,70 @@
 #define AS_CHAR
 //#undef AS_CHAR
 
+/*!
+ * \def 		CHORD_CANCEL
+ * \brief		'*' and '#' held together discard the digits typed so far
+ */
+#define CHORD_CANCEL	(MATRIX_KEY(3, 0) | MATRIX_KEY(3, 2))
+
+/*!
+ * \def 		KEYPAD_IDLE_PERIOD_US
+ * \brief		Scan tick while no key was touched lately. One row is strobed
+ * 				per tick, so a frame takes ROWS ticks (40 ms, 25 Hz) and a
+ * 				press is seen at worst (2 * ROWS - 1) ticks later (70 ms)
+ */
+#define KEYPAD_IDLE_PERIOD_US		10000u
+
+/*!
+ * \def 		KEYPAD_ACTIVE_PERIOD_US
+ * \brief		Scan tick while keys are in use: 8 ms frames (125 Hz), 14 ms
+ * 				worst-case latency
+ */
+#define KEYPAD_ACTIVE_PERIOD_US		2000u
+
+/*!
+ * \def 		KEYPAD_ACTIVE_FRAMES
+ * \brief		Frames with no key held before the scan slows down again (2 s)
+ */
+#define KEYPAD_ACTIVE_FRAMES		250u
+
+/*!
+ * \def 		KEYPAD_FLEXIO_SLOT_US
+ * \brief		Column strobe of the FlexIO scanner. A frame takes six slots
+ * 				(6 ms) and a press is reported at worst two frames later (12 ms)
+ */
+#define KEYPAD_FLEXIO_SLOT_US		1000u
+
+/*!
+ * \def 		KEYPAD_DEADLINE_MS
+ * \brief		Longest gap between two scan ticks before the watchdog resets
+ */
+#define KEYPAD_DEADLINE_MS			200u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+    \struct		MATRIX_PIN
+    \brief		Port and pin of a keypad row or column
+*/
+typedef struct
+{
+	PORTS port;
+	PINS pin;
+} MATRIX_PIN;
+
+/*!
+    \enum		KEYPAD_RATE
+    \brief		Scan rates of the keypad tick
+*/
+typedef enum
+{
+	eKEYPAD_IDLE,
+	eKEYPAD_ACTIVE,
+	eKEYPAD_RATES
+} KEYPAD_RATE;
+
 //------------------------------------------------------------------------------
 // Variables
 //------------------------------------------------------------------------------
@@ -70,12 +144,153 @@ static uint8_t matrix[ROWS][COLUMNS] = {
 };
 #endif
 
+/*!
+    \var		rowPins
+    \brief		Keypad rows, driven high one at a time while scanning
+*/
+static const MATRIX_PIN rowPins[ROWS] = {
+		{ePORTD, ePIN0},
+		{ePORTD, ePIN1},
+		{ePORTD, ePIN2},
+		{ePORTD, ePIN3}
+};
+
+/*!
+    \var		columnPins
+    \brief		Keypad columns, read high when a pressed key connects them to
+    			the driven row. FlexIO boards have column 2 on PTD6.
+*/
+static const MATRIX_PIN columnPins[COLUMNS] = {
+		{ePORTD, ePIN4},
+		{ePORTD, ePIN5},
+#ifdef KEYPAD_FLEXIO_ENABLE
+		{ePORTD, ePIN6}
+#else
+		{ePORTB, ePIN3}
+#endif
+};
+
+/*!
+ * \var 		keyState
+ * \brief		Key-state bitmap of the last accepted scan, one bit per key
+ */
+static uint16_t keyState = 0;
+
+/*!
+ * \var 		lastFrame
+ * \brief		Raw bitmap of the previous frame, cleared by a ghosted frame
+ */
+static uint16_t lastFrame = 0;
+
+/*!
+ * \var 		keyChord
+ * \brief		Key-state bitmap when a key last went down, until a chord
+ * 				matching it is taken by Matrix_bfnChord
+ */
+static volatile uint16_t keyChord = 0;
+
+/*!
+ * \var 		keyPressed
+ * \brief		Press edges accumulated until Matrix_wfnGetPressed is called
+ */
+static volatile uint16_t keyPressed = 0;
+
+/*!
+ * \var 		keyReleased
+ * \brief		Release edges accumulated until Matrix_wfnGetReleased is called
+ */
+static volatile uint16_t keyReleased = 0;
+
+/*!
+ * \var 		strobeRow
+ * \brief		Row driven by the scan tick, read on the next tick
+ */
+static uint8_t strobeRow = 0;
+
+/*!
+ * \var 		strobeFrame
+ * \brief		Key-state bitmap of the rows read so far in this frame
+ */
+static uint16_t strobeFrame = 0;
+
+/*!
+ * \var 		scanRate
+ * \brief		Current rate of the scan tick
+ */
+static KEYPAD_RATE scanRate = eKEYPAD_IDLE;
+
+/*!
+ * \var 		activeFrames
+ * \brief		Frames left at the active rate
+ */
+static uint16_t activeFrames = 0;
+
+/*!
+ * \var 		ratePeriods
+ * \brief		Tick period of every scan rate, in microseconds
+ */
+static const uint32_t ratePeriods[eKEYPAD_RATES] = {
+		KEYPAD_IDLE_PERIOD_US,
+		KEYPAD_ACTIVE_PERIOD_US
+};
+
+/*!
+ * \var 		rateTicks
+ * \brief		Scan ticks run at every rate
+ */
+static uint32_t rateTicks[eKEYPAD_RATES] = {0};
+
+/*!
+ * \var 		rateBusyUs
+ * \brief		Time spent in the scan tick at every rate, in microseconds
+ */
+static uint32_t rateBusyUs[eKEYPAD_RATES] = {0};
+
+/*!
+ * \var 		reportPending
+ * \brief		Set by the scan tick when it slows down, so the keypad task
+ * 				prints the scan figures outside of the interrupt
+ */
+static volatile uint8_t reportPending = 0;
+
+/*!
+ * \var 		cancelPending
+ * \brief		Set by the scan tick when the cancel chord discarded an entry
+ */
+static volatile uint8_t cancelPending = 0;
+
+/*!
+ * \var 		bootReported
+ * \brief		Set once the boot timeline was printed
+ */
+static uint8_t bootReported = 0;
+
+/*!
+ * \var 		ghostScans
+ * \brief		Scans rejected because the pattern could contain ghost keys
+ */
+static uint32_t ghostScans = 0;
+
+/*!
+ * \var 		isGranted
+ * \brief		Set when a signed credential opened the door; the next
+ * 				evaluation is correct whatever was typed
+ */
+static uint8_t isGranted = 0;
+
+/*!
+ * \var 		entry
+ * \brief		Entry taken from the pipeline for the next evaluation
+ */
+static ENTRY entry;
+
+/*!
+ * \var 		hasEntry
+ * \brief		Set while the entry was taken and not decided yet
+ */
+static uint8_t hasEntry = 0;
+
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
-	/*!
-	 * \var 		dataIndex
-	 * \brief		Index in which the pin data is "currently".
-	 */
-	static uint8_t dataIndex = 0;
 	/*!
 	 * \var 		confirmation
 	 * \brief		Constant variable which only purpose is to have a space in memory
@@ -84,17 +299,29 @@ static uint8_t matrix[ROWS][COLUMNS] = {
 	static uint8_t confirmation = 1;
 #endif
 
-/*!
- 	 \var		pinData
- 	 \brief		Stored data introduced with the bluetooth
-*/
-static uint8_t pinData[4] = {0};
-
 /*!
  * \var 		password
  * \brief		Stores the initial password
  */
 static uint8_t password[4] = {1, 2, 3, 4};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Password_vfnPut (ENTRY_SOURCE source, uint8_t key);
+static void Password_vfnSessionDigit (uint8_t digit);
+static void Password_vfnGrant (void);
+#ifdef BLUETOOTH_INTERRUPT_ENABLE
+static void Password_vfnRemoteDigit (uint8_t value);
+#endif
+static void Password_vfnTakeKeys (void);
+static uint8_t Matrix_bfnIsGhosted (uint16_t state);
+static void Matrix_vfnProcess (uint16_t state);
+static void Matrix_vfnAdaptRate (void);
+#ifdef KEYPAD_FLEXIO_ENABLE
+static void Matrix_vfnFrame (uint16_t state);
+#endif
+
 //------------------------------------------------------------------------------
 // Functions
 //------------------------------------------------------------------------------
@@ -105,36 +332,203 @@ static uint8_t password[4] = {1, 2, 3, 4};
 void Password_vfnDriverInit ()
 {
   	/* Init board hardware. */
-	// Initialize required ports for the matrix to work
+	// Initialize required ports for the matrix to work. The keypad goes
+	// first so it is ready as soon as possible after power-on, right after
+	// the entries it types into
+	Entry_vfnInit ();
 	Matrix_vfnPortInit();
+	Matrix_vfnStartScan();
+	Boot_vfnStamp (eBOOT_KEYPAD_READY);
 
-	// Initialize required ports and optional functions for the bluetooth module
+	// Initialize the bluetooth module; the digits arrive as plain bytes
+	// between the management protocol lines
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
-	UART_vfnCallbackReg(readVal);
+	Protocol_vfnDriverInit(Password_vfnRemoteDigit);
+#else
+	UART_vfnDriverInit();
+#endif
+	Session_vfnInit (Password_vfnSessionDigit);
+	Credential_vfnInit (Password_vfnGrant);
+	Boot_vfnStamp (eBOOT_UART_READY);
+}
+
+/*!
+ * \fn			void Password_vfnKeypadTask (void)
+ * \brief		Prints what the scan tick reported since the last call: a
+ * 				cancelled entry, the boot timeline once the first key was
+ * 				accepted, and the scan figures when the keypad goes idle
+ */
+void Password_vfnKeypadTask (void)
+{
+#ifdef DEBUG_MODE_ENABLE
+	if (cancelPending)
+	{
+		cancelPending = 0;
+		printf ("Entry cancelled\n");
+	}
+	if (!bootReported && Boot_dwfnGetStamp (eBOOT_FIRST_KEY))
+	{
+		bootReported = 1;
+		Boot_vfnReport ();
+	}
+	if (reportPending)
+	{
+		reportPending = 0;
+		Matrix_vfnScanReport ();
+	}
 #endif
+}
 
-	UART_vfnDriverInit();
+/*!
+ * \fn			static void Password_vfnTakeKeys (void)
+ * \brief		Called by the scan tick after every frame. Puts every newly
+ * 				pressed key in the keypad's entry: the digits, '*' to start
+ * 				over and '#' to end the entry. Each key is accepted once per
+ * 				press, even while other keys are held; keys pressed in the
+ * 				same frame are put in key order. The cancel chord discards
+ * 				the partial entry as well. The first accepted key closes the
+ * 				boot timeline.
+ */
+static void Password_vfnTakeKeys (void)
+{
+	uint16_t pressed;
+	uint8_t index = 0;
+	uint8_t key;
+
+	pressed = Matrix_wfnGetPressed ();
+	if (pressed && !Boot_dwfnGetStamp (eBOOT_FIRST_KEY))
+	{
+		Boot_vfnStamp (eBOOT_FIRST_KEY);
+	}
+
+	for (index = 0; pressed; index++, pressed >>= 1)
+	{
+		if (!(pressed & 1u))
+		{
+			continue;
+		}
+		key = matrix[index / COLUMNS][index % COLUMNS];
+#ifdef AS_CHAR
+		if ((key >= '0') && (key <= '9'))
+		{
+			key = (uint8_t)(key - '0');
+		}
+#else
+		if (key == 10)
+		{
+			key = ENTRY_CLEAR;
+		}
+		else if (key == 11)
+		{
+			key = ENTRY_END;
+		}
+#endif
+		Password_vfnPut (eENTRY_KEYPAD, key);
+	}
+
+	if (Matrix_bfnChord (CHORD_CANCEL))
+	{
+		Entry_vfnPut (eENTRY_KEYPAD, ENTRY_CLEAR);
+		cancelPending = 1;
+	}
+}
+
+/*!
+ * \fn			uint8_t Password_bfnEntryReady (void)
+ * \return		Returns 1 if a credential was granted or an entry completed
+ * 				since the last evaluation; else, returns 0
+ * \brief		Takes the next completed entry from the pipeline, the
+ * 				sources in turn
+ */
+uint8_t Password_bfnEntryReady (void)
+{
+	if (isGranted)
+	{
+		return 1;
+	}
+	hasEntry = Entry_bfnTake (&entry);
+	return hasEntry;
+}
+
+/*!
+ * \fn			static void Password_vfnPut (ENTRY_SOURCE source, uint8_t key)
+ * \param		source	Input the key came from
+ * \param		key		Digit, ENTRY_CLEAR or ENTRY_END
+ * \brief		Puts a key in the entry of its source. When a key arrives is
+ * 				hard to guess, so its cycle count goes to the session's
+ * 				entropy pool.
+ */
+static void Password_vfnPut (ENTRY_SOURCE source, uint8_t key)
+{
+	Session_vfnStir (Timebase_dwfnGetCycles ());
+	Entry_vfnPut (source, key);
+}
+
+/*!
+ * \fn			static void Password_vfnSessionDigit (uint8_t digit)
+ * \param		digit	Digit of an authenticated session frame
+ * \brief		Runs from the main loop; the session digits type into the
+ * 				Bluetooth entry like the plain ones
+ */
+static void Password_vfnSessionDigit (uint8_t digit)
+{
+	Password_vfnPut (eENTRY_BLUETOOTH, digit);
+}
 
+/*!
+ * \fn			static void Password_vfnGrant (void)
+ * \brief		Runs from the main loop when a credential was accepted; the
+ * 				next evaluation opens the door
+ */
+static void Password_vfnGrant (void)
+{
+	isGranted = 1;
 }
+
 /*!
  * \fn			uint8_t Password_bfnIsCorrect(void)
  * \return		Returns a 1 if the introduced password is correct; else, returns 0
- * \brief		This function, when called, evaluates if the introduced password,
- * 				either from the keyboard or from the bluetooth module.
+ * \brief		This function, when called, evaluates the entry taken by
+ * 				Password_bfnEntryReady, from whichever source it came. The
+ * 				master password opens at any time; any other pin must be a
+ * 				user whose access schedule is open, and an entry of
+ * 				OTP_DIGITS a code of such a user's generator. A
+ * 				credential granted since the last evaluation opens
+ * 				whatever was typed. The master password
+ * 				typed on the keypad also lets the Bluetooth link provision
+ * 				the lock for a while.
  */
 uint8_t Password_bfnIsCorrect(void)
 {
-	// To-Do
 	uint8_t i = 0;
-	uint8_t isCorrect = 1;
-	for (i = 0; i < 4; i++)
+	uint8_t isCorrect = (entry.length == ENTRY_PIN);
+
+	for (i = 0; i < ENTRY_PIN; i++)
 	{
-		if (!(pinData[i] == password[i]))
+		if (!(entry.digits[i] == password[i]))
 		{
 			isCorrect = 0;
 		}
 	}
+	if (isCorrect && (entry.source == eENTRY_KEYPAD))
+	{
+		Protocol_vfnAuthorize ();
+	}
+	if (isGranted)
+	{
+		isGranted = 0;
+		isCorrect = 1;
+	}
 
+	if (!isCorrect)
+	{
+		isCorrect = Access_bfnAuthorize (entry.digits, entry.length);
+	}
+	if (hasEntry)
+	{
+		hasEntry = 0;
+		Entry_vfnDecided (&entry);
+	}
 	return isCorrect;
 }
 
@@ -168,17 +562,379 @@ uint8_t Matrix_bfnGetChar(void)
 */
 void Matrix_vfnPortInit (void)
 {
+	uint8_t i = 0;
+
 	//////////////////////// Initialize ports as GPIOs ////////////////////////
 	// Rows 0 - 3 (Outputs)
-	GPIO_vfnPortInit(ePORTD, ePIN0, eOUTPUT);
-	GPIO_vfnPortInit(ePORTD, ePIN1, eOUTPUT);
-	GPIO_vfnPortInit(ePORTD, ePIN2, eOUTPUT);
-	GPIO_vfnPortInit(ePORTD, ePIN3, eOUTPUT);
+	for (i = 0; i < ROWS; i++)
+	{
+		GPIO_vfnPortInit(rowPins[i].port, rowPins[i].pin, eOUTPUT);
+	}
 
 	// Columns 0 - 2 (Inputs)
-	GPIO_vfnPortInit(ePORTD, ePIN4, eINPUT);
-	GPIO_vfnPortInit(ePORTD, ePIN5, eINPUT);
-	GPIO_vfnPortInit(ePORTB, ePIN3, eINPUT);
+	for (i = 0; i < COLUMNS; i++)
+	{
+		GPIO_vfnPortInit(columnPins[i].port, columnPins[i].pin, eINPUT);
+	}
+}
+
+/*!
+    \fn			uint16_t Matrix_wfnScan (void)
+    \return		Returns the key-state bitmap read from the keypad, bit
+    			(row * COLUMNS + column) set for every key that reads pressed
+    \brief		Drives every row and reads every column. The scan always
+    			visits the whole matrix, so it takes the same time whatever is
+    			pressed.
+*/
+RAMFUNC_HOT uint16_t Matrix_wfnScan (void)
+{
+	uint16_t state = 0;
+	uint8_t row = 0;
+	uint8_t column = 0;
+	uint8_t value = 0;
+
+	for (row = 0; row < ROWS; row++)
+	{
+		GPIO_bfnSetData(rowPins[row].port, rowPins[row].pin);
+		for (column = 0; column < COLUMNS; column++)
+		{
+			GPIO_bfnReadData(columnPins[column].port, columnPins[column].pin, &value);
+			state |= (uint16_t)value << (row * COLUMNS + column);
+		}
+		GPIO_bfnClearData(rowPins[row].port, rowPins[row].pin);
+	}
+	return state;
+}
+
+/*!
+    \fn			static uint8_t Matrix_bfnIsGhosted (uint16_t state)
+    \param		state	Key-state bitmap of one scan
+    \return		Returns 1 if the bitmap may contain ghost keys; else, returns 0
+    \brief		The keypad has no diodes: with three corners of a rectangle
+    			pressed the fourth one reads pressed too. Such a pattern, and a
+    			real four-key rectangle which reads the same, shows up as two
+    			rows sharing two or more columns.
+*/
+static uint8_t Matrix_bfnIsGhosted (uint16_t state)
+{
+	uint8_t first = 0;
+	uint8_t second = 0;
+	uint8_t shared = 0;
+
+	for (first = 0; first < ROWS - 1; first++)
+	{
+		for (second = first + 1; second < ROWS; second++)
+		{
+			shared = (uint8_t)((state >> (first * COLUMNS)) & (state >> (second * COLUMNS)))
+					& ((1u << COLUMNS) - 1u);
+			if (shared & (shared - 1u))
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/*!
+    \fn			static void Matrix_vfnProcess (uint16_t state)
+    \param		state	Key-state bitmap of a complete frame
+    \brief		Computes the press and release edges against the previous
+    			accepted frame. Frames that may contain ghost keys are dropped
+    			and the previous state is kept.
+    			The rows of a frame are read one tick apart, so the key that
+    			completes a rectangle may go down after its row was read and
+    			leave only the ghost in the frame. A ghost needs three real
+    			keys, so with three or more keys in the frame a new key is only
+    			accepted once two clean frames in a row show it.
+*/
+static void Matrix_vfnProcess (uint16_t state)
+{
+	uint16_t changed;
+	uint16_t edges;
+	uint16_t pairs;
+	uint16_t raw = state;
+
+	if (Matrix_bfnIsGhosted (state))
+	{
+		ghostScans++;
+		lastFrame = 0;
+		return;
+	}
+
+	pairs = state & (state - 1u);
+	if (pairs & (pairs - 1u))
+	{
+		state &= (uint16_t)~(state & ~keyState & ~lastFrame);
+	}
+	lastFrame = raw;
+
+	changed = state ^ keyState;
+	edges = changed & state;
+	if (edges)
+	{
+		keyChord = state;
+	}
+	keyPressed |= edges;
+	keyReleased |= changed & keyState;
+	keyState = state;
+}
+
+/*!
+    \fn			static void Matrix_vfnAdaptRate (void)
+    \brief		Called at the end of every frame: scans fast while a key is
+    			held and for KEYPAD_ACTIVE_FRAMES after, slow otherwise. The new
+    			period starts with the next tick, so the frame timing has no
+    			jitter.
+*/
+static void Matrix_vfnAdaptRate (void)
+{
+	KEYPAD_RATE rate;
+
+	if (keyState)
+	{
+		activeFrames = KEYPAD_ACTIVE_FRAMES;
+	}
+	else if (activeFrames)
+	{
+		activeFrames--;
+	}
+
+	rate = activeFrames ? eKEYPAD_ACTIVE : eKEYPAD_IDLE;
+	if (rate != scanRate)
+	{
+		scanRate = rate;
+		PIT_vfnSetPeriod (ePIT_SCAN, ratePeriods[rate]);
+		if (rate == eKEYPAD_IDLE)
+		{
+			reportPending = 1;
+		}
+	}
+}
+
+/*!
+    \fn			void Matrix_vfnUpdate (void)
+    \brief		Scans the whole keypad at once and processes it as a frame.
+    			Only for use while the scan tick is stopped.
+*/
+void Matrix_vfnUpdate (void)
+{
+	Matrix_vfnProcess (Matrix_wfnScan ());
+}
+
+/*!
+    \fn			void Matrix_vfnScanTick (void)
+    \brief		Scan tick callback, run from the PIT interrupt. Reads the
+    			columns of the row driven on the previous tick, which had a
+    			whole period to settle, releases it and drives the next one.
+    			Every ROWS ticks a frame is complete and processed.
+*/
+RAMFUNC_HOT void Matrix_vfnScanTick (void)
+{
+	uint32_t start = Timebase_dwfnGetCycles ();
+	KEYPAD_RATE rate = scanRate;
+	uint8_t column = 0;
+
+	Watchdog_vfnKick (eWATCHDOG_KEYPAD);
+
+	for (column = 0; column < COLUMNS; column++)
+	{
+		strobeFrame |= (uint16_t)Matrix_bfnPorts (eINPUT, column, OFF)
+				<< (strobeRow * COLUMNS + column);
+	}
+	Matrix_bfnPorts (eOUTPUT, strobeRow, OFF);
+
+	if (++strobeRow >= ROWS)
+	{
+		strobeRow = 0;
+		Matrix_vfnProcess (strobeFrame);
+		strobeFrame = 0;
+		Matrix_vfnAdaptRate ();
+		Password_vfnTakeKeys ();
+	}
+	Matrix_bfnPorts (eOUTPUT, strobeRow, ON);
+
+	rateTicks[rate]++;
+	rateBusyUs[rate] += Timebase_dwfnCyclesToUs (Timebase_dwfnGetCycles () - start);
+}
+
+#ifdef KEYPAD_FLEXIO_ENABLE
+/*!
+    \fn			static void Matrix_vfnFrame (uint16_t state)
+    \param		state	Key-state bitmap of a complete frame
+    \brief		Frame callback of the FlexIO scanner, run from its interrupt.
+    			The scanner stops reporting after an empty frame, which is when
+    			the scan figures are printed.
+*/
+static void Matrix_vfnFrame (uint16_t state)
+{
+	Matrix_vfnProcess (state);
+	Password_vfnTakeKeys ();
+	if (!state)
+	{
+		reportPending = 1;
+	}
+}
+
+/*!
+    \fn			void Matrix_vfnStartScan (void)
+    \brief		Hands the keypad to the FlexIO scanner, which runs without the
+    			CPU until a key is pressed
+*/
+void Matrix_vfnStartScan (void)
+{
+	FLEXIO_vfnKeypadStart (KEYPAD_FLEXIO_SLOT_US, Matrix_vfnFrame);
+}
+
+/*!
+    \fn			void Matrix_vfnStopScan (void)
+    \brief		Stops the FlexIO scanner and gives the pins back to the GPIO
+    			driver, so the keypad can be scanned with Matrix_vfnUpdate
+*/
+void Matrix_vfnStopScan (void)
+{
+	FLEXIO_vfnKeypadStop ();
+	Matrix_vfnPortInit ();
+}
+
+/*!
+    \fn			void Matrix_vfnScanReport (void)
+    \brief		Prints the FlexIO scanner figures: the CPU only runs for the
+    			frames reported after a press woke the scanner.
+*/
+void Matrix_vfnScanReport (void)
+{
+	printf ("scan flexio: %lu us/column, latency <= %lu ms, %lu wakeups, %lu frames\n",
+			(unsigned long)KEYPAD_FLEXIO_SLOT_US,
+			(unsigned long)((4u * COLUMNS * KEYPAD_FLEXIO_SLOT_US) / 1000u),
+			(unsigned long)FLEXIO_dwfnGetWakeups (),
+			(unsigned long)FLEXIO_dwfnGetFrames ());
+}
+#else
+/*!
+    \fn			void Matrix_vfnStartScan (void)
+    \brief		Drives the first row and starts the scan tick at the idle rate
+*/
+void Matrix_vfnStartScan (void)
+{
+	strobeRow = 0;
+	strobeFrame = 0;
+	scanRate = eKEYPAD_IDLE;
+	activeFrames = 0;
+	Matrix_bfnPorts (eOUTPUT, strobeRow, ON);
+	Watchdog_vfnRegister (eWATCHDOG_KEYPAD, KEYPAD_DEADLINE_MS);
+	PIT_vfnStart (ePIT_SCAN, ratePeriods[scanRate], Matrix_vfnScanTick);
+}
+
+/*!
+    \fn			void Matrix_vfnStopScan (void)
+    \brief		Stops the scan tick and releases the driven row, so the keypad
+    			can be scanned with Matrix_vfnUpdate
+*/
+void Matrix_vfnStopScan (void)
+{
+	PIT_vfnStop (ePIT_SCAN);
+	Watchdog_vfnSuspend (eWATCHDOG_KEYPAD);
+	Matrix_bfnPorts (eOUTPUT, strobeRow, OFF);
+}
+
+/*!
+    \fn			void Matrix_vfnScanReport (void)
+    \brief		Prints the figures of every scan rate: tick period, worst-case
+    			press latency, ticks run and the share of time spent in the
+    			scan tick, which is the time the core is kept out of sleep by
+    			the keypad.
+*/
+void Matrix_vfnScanReport (void)
+{
+	static const char *names[eKEYPAD_RATES] = {"idle", "active"};
+	uint8_t rate = 0;
+	uint32_t busy10000;
+
+	for (rate = 0; rate < eKEYPAD_RATES; rate++)
+	{
+		busy10000 = rateTicks[rate] ? (uint32_t)(((uint64_t)rateBusyUs[rate] * 10000u)
+				/ ((uint64_t)rateTicks[rate] * ratePeriods[rate])) : 0;
+		printf ("scan %s: %lu us/row, latency <= %lu ms, %lu ticks, busy %lu.%02lu%%\n",
+				names[rate], (unsigned long)ratePeriods[rate],
+				(unsigned long)(((2u * ROWS - 1u) * ratePeriods[rate]) / 1000u),
+				(unsigned long)rateTicks[rate],
+				(unsigned long)(busy10000 / 100u), (unsigned long)(busy10000 % 100u));
+	}
+}
+#endif
+
+/*!
+    \fn			uint16_t Matrix_wfnGetState (void)
+    \return		Returns the key-state bitmap of the last accepted scan
+*/
+uint16_t Matrix_wfnGetState (void)
+{
+	return keyState;
+}
+
+/*!
+    \fn			uint16_t Matrix_wfnGetPressed (void)
+    \return		Returns the keys pressed since the last call
+*/
+uint16_t Matrix_wfnGetPressed (void)
+{
+	uint32_t primask = __get_PRIMASK ();
+	uint16_t pressed;
+
+	__disable_irq ();
+	pressed = keyPressed;
+	keyPressed = 0;
+	__set_PRIMASK (primask);
+	return pressed;
+}
+
+/*!
+    \fn			uint16_t Matrix_wfnGetReleased (void)
+    \return		Returns the keys released since the last call
+*/
+uint16_t Matrix_wfnGetReleased (void)
+{
+	uint32_t primask = __get_PRIMASK ();
+	uint16_t released;
+
+	__disable_irq ();
+	released = keyReleased;
+	keyReleased = 0;
+	__set_PRIMASK (primask);
+	return released;
+}
+
+/*!
+    \fn			uint8_t Matrix_bfnChord (uint16_t chord)
+    \param		chord	Bitmap of the keys of the chord, see MATRIX_KEY
+    \return		Returns 1 if the chord was entered since the last call; else,
+    			returns 0
+    \brief		A chord is entered when exactly its keys are held as the last
+    			of them goes down, so it fires once per press
+*/
+uint8_t Matrix_bfnChord (uint16_t chord)
+{
+	uint32_t primask = __get_PRIMASK ();
+	uint8_t entered = 0;
+
+	__disable_irq ();
+	if (keyChord == chord)
+	{
+		keyChord = 0;
+		entered = 1;
+	}
+	__set_PRIMASK (primask);
+	return entered;
+}
+
+/*!
+    \fn			uint32_t Matrix_dwfnGetGhostScans (void)
+    \return		Returns the number of scans rejected for possible ghosting
+*/
+uint32_t Matrix_dwfnGetGhostScans (void)
+{
+	return ghostScans;
 }
 
 /*!
@@ -186,88 +942,56 @@ void Matrix_vfnPortInit (void)
     \param		row		Pointer to a variable where the value of the active pressed row will be stored
     \param		column	Pointer to a variable where the value of the active pressed row will be stored
     \return		If a button is pressed, returns 1; else, returns 0
-    \brief		Iterates through all rows and columns to find the pressed button in the keypad
+    \brief		Scans the whole keypad and reports the first pressed key in
+    			row order
 */
 uint8_t Matrix_bfnMatrixRead (uint8_t *row, uint8_t *column)
 {
+	uint16_t state = Matrix_wfnScan ();
+	uint8_t index = 0;
+
 	*row = 0;
 	*column = 0;
-	for (*row = 0; *row < ROWS; (*row)++)
+	if (!state)
 	{
-		Matrix_bfnPorts(eOUTPUT, *row, ON);
-		for (*column = 0; *column < COLUMNS; (*column)++)
-		{
-			if (Matrix_bfnPorts(eINPUT, *column, OFF))
-			{
-				Matrix_bfnPorts(eOUTPUT, *row, OFF);
-				return 1;
-			}
-//			printf("%d\t", matrix[*row][*column]);
-		}
-		Matrix_bfnPorts(eOUTPUT, *row, OFF);
-//		printf("\n");
+		return 0;
 	}
-//	printf("\n");
-	return 0;
+	while (!(state & 1u))
+	{
+		state >>= 1;
+		index++;
+	}
+	*row = index / COLUMNS;
+	*column = index % COLUMNS;
+	return 1;
 }
 
 /*!
     \fn			uint8_t Matrix_bfnPorts(IO io, uint8_t iteration, uint8_t onOff)
     \param		io			Parameter to set if the pin you're using is as INPUT or OUTPUT
-    \param		iteration	Parameter for receiving the number of the iteration currently going in the Matrix_bfnMatrixRead loop
+    \param		iteration	Row (OUTPUT) or column (INPUT) number
     \param		onOff		Parameter for receiving if the port you will use as OUTPUT, is going to be ON or OFF
     \return		If io is 1, always returns 1; if io is 0, returns the value read from the selected pin, either 1 or 0
-    \brief		For internal use only for the Matrix_bfnMatrixRead function
+    \brief		Drives one row or reads one column through the pin tables
 */
-uint8_t Matrix_bfnPorts(IO io, uint8_t iteration, uint8_t onOff)
+RAMFUNC_HOT uint8_t Matrix_bfnPorts(IO io, uint8_t iteration, uint8_t onOff)
 {
 	uint8_t result = 0;
 
 	if (io)
 	{
-		switch (iteration)
+		if (iteration < ROWS)
 		{
-		case 0:
-			GPIO_bfnData(ePORTD, ePIN0, &onOff);
-			break;
-
-		case 1:
-			GPIO_bfnData(ePORTD, ePIN1, &onOff);
-			break;
-
-		case 2:
-			GPIO_bfnData(ePORTD, ePIN2, &onOff);
-			break;
-
-		case 3:
-			GPIO_bfnData(ePORTD, ePIN3, &onOff);
-			break;
-
-		default:
-			break;
+			GPIO_bfnData(rowPins[iteration].port, rowPins[iteration].pin, &onOff);
 		}
 		return 1;
 	}
 	else
 	{
-		switch (iteration)
+		if (iteration < COLUMNS)
 		{
-		case 0:
-			GPIO_bfnReadData(ePORTD, ePIN4, &result);
-			break;
-
-		case 1:
-			GPIO_bfnReadData(ePORTD, ePIN5, &result);
-			break;
-
-		case 2:
-			GPIO_bfnReadData(ePORTB, ePIN3, &result);
-			break;
-
-		default:
-			break;
+			GPIO_bfnReadData(columnPins[iteration].port, columnPins[iteration].pin, &result);
 		}
-
 		return result;
 	}
 }
@@ -276,25 +1000,27 @@ uint8_t Matrix_bfnPorts(IO io, uint8_t iteration, uint8_t onOff)
 // Bluetooth functions
 //------------------------------------------------------------------------------
 /*!
- 	 \fn		void readVal()
- 	 \brief		Function to be executed when an interruption is generated by the UART driver
+ 	 \fn		static void Password_vfnRemoteDigit (uint8_t value)
+ 	 \param		value	Digit received from the bluetooth module
+ 	 \brief		Called from Protocol_vfnTask, in the main loop, with every
+ 	 			byte that is not part of a management protocol line. The
+ 	 			digit is not echoed: it is part of a PIN. Plain digits are
+ 	 			refused once a phone is paired, or always with
+ 	 			SESSION_REQUIRED: they must come in session frames then.
  */
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
-void readVal()
+static void Password_vfnRemoteDigit (uint8_t value)
 {
-	if(UART_bfnRead(&pinData[dataIndex]))
+#ifdef SESSION_REQUIRED
+	(void)value;
+#else
+	if (Session_bfnIsPaired ())
 	{
-		printf("%d\n", pinData[dataIndex]);
-		UART_bfnSend(&confirmation);
-		if (3 <= dataIndex)
-		{
-			dataIndex = 0;
-		}
-		else
-		{
-			dataIndex++;
-		}
+		return;
 	}
+	UART_bfnSend(&confirmation);
+	Password_vfnPut (eENTRY_BLUETOOTH, value);
+#endif
 }
 #endif
 //------------------------------------------------------------------------------
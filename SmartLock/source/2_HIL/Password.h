@@ -13,6 +13,16 @@
 //--------------------------------------------------------------------------
 #include "GPIO.h"
 #include "UART.h"
+#include "RamFunc.h"
+
+//--------------------------------------------------------------------------
+// Defines
+//--------------------------------------------------------------------------
+/*!
+	\def		MATRIX_KEY
+	\brief		Bit of a key in the 12-bit key-state bitmap, three keys per row
+*/
+#define		MATRIX_KEY(row, column)		((uint16_t)(1u << ((row) * 3u + (column))))
 
 //--------------------------------------------------------------------------
 // Functions
@@ -21,16 +31,38 @@ void Password_vfnDriverInit (void);
 
 uint8_t Password_bfnIsCorrect (void);
 
+void Password_vfnKeypadTask (void);
+
+uint8_t Password_bfnEntryReady (void);
+
 void Matrix_vfnPortInit (void);
 
+RAMFUNC_HOT uint16_t Matrix_wfnScan (void);
+
+void Matrix_vfnUpdate (void);
+
+RAMFUNC_HOT void Matrix_vfnScanTick (void);
+
+void Matrix_vfnStartScan (void);
+
+void Matrix_vfnStopScan (void);
+
+void Matrix_vfnScanReport (void);
+
+uint16_t Matrix_wfnGetState (void);
+
+uint16_t Matrix_wfnGetPressed (void);
+
+uint16_t Matrix_wfnGetReleased (void);
+
+uint8_t Matrix_bfnChord (uint16_t chord);
+
+uint32_t Matrix_dwfnGetGhostScans (void);
+
 uint8_t Matrix_bfnGetChar(void);
 
 uint8_t Matrix_bfnMatrixRead (uint8_t *row, uint8_t *column);
 
-uint8_t Matrix_bfnPorts (IO io, uint8_t iteration, uint8_t onOff);
-
-#ifdef BLUETOOTH_INTERRUPT_ENABLE
-void readVal();
-#endif
+RAMFUNC_HOT uint8_t Matrix_bfnPorts (IO io, uint8_t iteration, uint8_t onOff);
 
 #endif /* PASSWORD_H_ */
@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		ADC.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the ADC0 driver. Every TPM1
+				overflow triggers one conversion averaged over 32 samples by
+				the ADC itself; DMA channel 2 moves each result into one of two
+				blocks and interrupts when a block is full, then fills the
+				other one while the callback reads the finished block.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "ADC.h"
+#include "ClockProfile.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		ADC_DMA_CHANNEL
+	\brief		DMA channel of the results; 0 is the CRC, 1 the UART receiver
+*/
+#define		ADC_DMA_CHANNEL		2
+
+/*!
+	\def		DMAMUX_ADC0
+	\brief		DMAMUX source of the ADC0 conversion complete request
+*/
+#define		DMAMUX_ADC0			40
+
+/*!
+	\def		DMA_SIZE_16BIT
+	\brief		SSIZE / DSIZE encoding of half-word transfers
+*/
+#define		DMA_SIZE_16BIT		2
+
+/*!
+	\def		ADC_TRIGGER_TPM1
+	\brief		SIM_SOPT7 ADC0TRGSEL of the TPM1 overflow
+*/
+#define		ADC_TRIGGER_TPM1	9
+
+/*!
+	\def		ADC_MODE_12BIT
+	\brief		CFG1 MODE of single-ended 12-bit conversions
+*/
+#define		ADC_MODE_12BIT		1
+
+/*!
+	\def		ADC_CLOCK_ADACK
+	\brief		CFG1 ADICLK of the asynchronous clock, which does not change
+				with the clock profile
+*/
+#define		ADC_CLOCK_ADACK		3
+
+/*!
+	\def		ADC_AVERAGE_32
+	\brief		SC3 AVGS of 32 samples per result
+*/
+#define		ADC_AVERAGE_32		3
+
+/*!
+	\def		ADC_CHANNEL_OFF
+	\brief		ADCH value that disables the converter
+*/
+#define		ADC_CHANNEL_OFF		31
+
+/*!
+	\def		MCGIRCLK_ALT
+	\brief		SIM_SOPT2 TPMSRC of MCGIRCLK, shared with the PWM driver
+*/
+#define		MCGIRCLK_ALT		3
+
+/*!
+	\def		TPM_PRESCALER
+	\brief		TPM1 counts MCGIRCLK divided by 2^TPM_PRESCALER, so periods up
+				to a second fit in the 16-bit modulo at 8 MHz
+*/
+#define		TPM_PRESCALER		7
+
+/*!
+	\def		MS_PER_SECOND
+	\brief		Milliseconds in a second
+*/
+#define		MS_PER_SECOND		1000u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		blocks
+	\brief		Result blocks, one written by the DMA while the other is read
+*/
+static uint16_t blocks[2][ADC_BLOCK];
+
+/*!
+	\var		activeBlock
+	\brief		Block the DMA is writing
+*/
+static uint8_t activeBlock = 0;
+
+/*!
+	\var		blockCallback
+	\brief		Called with every finished block
+*/
+static ADC_BLOCK_CALLBACK blockCallback = 0;
+
+/*!
+	\var		period
+	\brief		Trigger period in milliseconds, 0 while stopped
+*/
+static uint32_t period = 0;
+
+/*!
+	\var		tpmHz
+	\brief		TPM1 counting frequency at the current clock profile
+*/
+static uint32_t tpmHz = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint8_t ADC_bfnCalibrate (void);
+static void ADC_vfnStartTrigger (void);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			uint8_t ADC_bfnDriverInit (void)
+	\return		Returns 1 if the calibration passed; else, returns 0 and the
+				converter runs uncalibrated
+	\brief		Clocks ADC0, TPM1 and the DMA, enables the bandgap buffer and
+				calibrates the converter with the conversion settings it uses
+*/
+uint8_t ADC_bfnDriverInit (void)
+{
+	SIM->SCGC6 |= SIM_SCGC6_ADC0_MASK | SIM_SCGC6_TPM1_MASK | SIM_SCGC6_DMAMUX_MASK;
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+	SIM->SOPT2 |= SIM_SOPT2_TPMSRC(MCGIRCLK_ALT);
+	SIM->SOPT7 = (SIM->SOPT7 & ~SIM_SOPT7_ADC0TRGSEL_MASK)
+			| SIM_SOPT7_ADC0ALTTRGEN_MASK | SIM_SOPT7_ADC0TRGSEL(ADC_TRIGGER_TPM1);
+	PMC->REGSC |= PMC_REGSC_BGBE_MASK;
+
+	// The bandgap is a high impedance source: long sample time
+	ADC0->CFG1 = ADC_CFG1_ADLSMP_MASK | ADC_CFG1_MODE(ADC_MODE_12BIT)
+			| ADC_CFG1_ADICLK(ADC_CLOCK_ADACK);
+	ADC0->CFG2 = ADC_CFG2_ADACKEN_MASK;
+	ADC0->SC1[0] = ADC_SC1_ADCH(ADC_CHANNEL_OFF);
+
+	ADC_vfnClockChanged (SystemCoreClock, ClockProfile_dwfnGetIrClock ());
+	ClockProfile_bfnRegister (ADC_vfnClockChanged);
+	NVIC_EnableIRQ (DMA2_IRQn);
+
+	return ADC_bfnCalibrate ();
+}
+
+/*!
+	\fn			void ADC_vfnStart (uint8_t channel, uint32_t periodMs, ADC_BLOCK_CALLBACK callback)
+	\param		channel		ADC0 single-ended channel to convert
+	\param		periodMs	Time between conversions, up to a second
+	\param		callback	Function called with every ADC_BLOCK results
+	\brief		Starts converting a channel at a fixed period. The first block
+				arrives ADC_BLOCK periods from now.
+*/
+void ADC_vfnStart (uint8_t channel, uint32_t periodMs, ADC_BLOCK_CALLBACK callback)
+{
+	ADC_vfnStop ();
+
+	blockCallback = callback;
+	activeBlock = 0;
+
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[ADC_DMA_CHANNEL].SAR = (uint32_t)&ADC0->R[0];
+	DMA0->DMA[ADC_DMA_CHANNEL].DAR = (uint32_t)blocks[activeBlock];
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(sizeof (blocks[0]));
+	DMA0->DMA[ADC_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_ERQ_MASK
+			| DMA_DCR_CS_MASK | DMA_DCR_DINC_MASK
+			| DMA_DCR_SSIZE(DMA_SIZE_16BIT) | DMA_DCR_DSIZE(DMA_SIZE_16BIT);
+	DMAMUX0->CHCFG[ADC_DMA_CHANNEL] = DMAMUX_CHCFG_ENBL_MASK | DMAMUX_CHCFG_SOURCE(DMAMUX_ADC0);
+
+	// Hardware trigger, a DMA request per result instead of an interrupt
+	ADC0->SC3 = ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(ADC_AVERAGE_32);
+	ADC0->SC2 = ADC_SC2_ADTRG_MASK | ADC_SC2_DMAEN_MASK;
+	ADC0->SC1[0] = ADC_SC1_ADCH(channel);
+
+	period = periodMs;
+	ADC_vfnStartTrigger ();
+}
+
+/*!
+	\fn			void ADC_vfnStop (void)
+	\brief		Stops the trigger and the DMA and disables the converter
+*/
+void ADC_vfnStop (void)
+{
+	period = 0;
+	TPM1->SC = 0;
+	DMAMUX0->CHCFG[ADC_DMA_CHANNEL] = 0;
+	DMA0->DMA[ADC_DMA_CHANNEL].DCR = 0;
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	ADC0->SC2 = 0;
+	ADC0->SC1[0] = ADC_SC1_ADCH(ADC_CHANNEL_OFF);
+}
+
+/*!
+	\fn			void ADC_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+	\param		coreClock	New core clock in Hz
+	\param		irClock		New MCGIRCLK in Hz
+	\brief		TPM1 counts MCGIRCLK, so the trigger modulo is recomputed.
+				The converter itself runs from ADACK and is not affected.
+*/
+void ADC_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+
+	tpmHz = irClock >> TPM_PRESCALER;
+	if (period)
+	{
+		ADC_vfnStartTrigger ();
+	}
+}
+
+/*!
+	\fn			void DMA2_DriverIRQHandler (void)
+	\brief		A block is full: the DMA moves on to the other block and the
+				finished one is handed to the callback
+*/
+void DMA2_DriverIRQHandler (void)
+{
+	uint8_t finished = activeBlock;
+
+	STACK_ISR_ENTER (eSTACK_ISR_ADC_DMA);
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	activeBlock ^= 1u;
+	DMA0->DMA[ADC_DMA_CHANNEL].DAR = (uint32_t)blocks[activeBlock];
+	DMA0->DMA[ADC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(sizeof (blocks[0]));
+
+	if (blockCallback)
+	{
+		blockCallback (blocks[finished], ADC_BLOCK);
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_ADC_DMA);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint8_t ADC_bfnCalibrate (void)
+	\return		Returns 1 if the calibration passed; else, returns 0
+	\brief		Runs the self calibration with 32-sample averaging, as the
+				reference manual recommends, and loads the gains it measured
+*/
+static uint8_t ADC_bfnCalibrate (void)
+{
+	uint16_t gain = 0;
+
+	ADC0->SC2 = 0;
+	ADC0->SC3 = ADC_SC3_CAL_MASK | ADC_SC3_AVGE_MASK | ADC_SC3_AVGS(ADC_AVERAGE_32);
+	while (ADC0->SC3 & ADC_SC3_CAL_MASK)
+	{
+	}
+	if (ADC0->SC3 & ADC_SC3_CALF_MASK)
+	{
+		return 0;
+	}
+
+	gain = (uint16_t)(ADC0->CLP0 + ADC0->CLP1 + ADC0->CLP2 + ADC0->CLP3 + ADC0->CLP4 + ADC0->CLPS);
+	ADC0->PG = (gain >> 1) | 0x8000u;
+	gain = (uint16_t)(ADC0->CLM0 + ADC0->CLM1 + ADC0->CLM2 + ADC0->CLM3 + ADC0->CLM4 + ADC0->CLMS);
+	ADC0->MG = (gain >> 1) | 0x8000u;
+
+	return 1;
+}
+
+/*!
+	\fn			static void ADC_vfnStartTrigger (void)
+	\brief		(Re)starts TPM1 with the modulo of the current period
+*/
+static void ADC_vfnStartTrigger (void)
+{
+	uint32_t modulo = (period * tpmHz) / MS_PER_SECOND;
+
+	if (modulo > TPM_MOD_MOD_MASK)
+	{
+		modulo = TPM_MOD_MOD_MASK;
+	}
+	if (!modulo)
+	{
+		modulo = 1;
+	}
+
+	TPM1->SC = 0;
+	TPM1->CNT = 0;
+	TPM1->MOD = modulo - 1u;
+	TPM1->SC = TPM_SC_CMOD(1) | TPM_SC_PS(TPM_PRESCALER);
+}
@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		ADC.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the ADC0 driver. TPM1 triggers the
+				conversions at a fixed period, the ADC averages in hardware and
+				the DMA collects the results in blocks, so the core only wakes
+				once per block.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_ADC_H_
+#define _3_HAL_ADC_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def	ADC_BLOCK
+		\brief	Results collected by the DMA per callback
+	*/
+	#define ADC_BLOCK			8u
+
+	/*!
+		\def	ADC_FULL_SCALE
+		\brief	Largest result of a 12-bit conversion
+	*/
+	#define ADC_FULL_SCALE		4095u
+
+	/*!
+		\def	ADC_CHANNEL_BANDGAP
+		\brief	Internal 1.0 V bandgap reference; measured against VREFH,
+				which is VDD on this board, it gives the supply voltage
+	*/
+	#define ADC_CHANNEL_BANDGAP	27u
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	ADC_BLOCK_CALLBACK
+		\brief		Called from the DMA interrupt with a block of ADC_BLOCK
+					results. The block stays untouched until the next call.
+	*/
+	typedef void (*ADC_BLOCK_CALLBACK)(const uint16_t *samples, uint8_t count);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	uint8_t ADC_bfnDriverInit (void);
+
+	void ADC_vfnStart (uint8_t channel, uint32_t periodMs, ADC_BLOCK_CALLBACK callback);
+
+	void ADC_vfnStop (void);
+
+	void ADC_vfnClockChanged (uint32_t coreClock, uint32_t irClock);
+
+	void DMA2_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_ADC_H_ */
@@ -0,0 +1,665 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		CRC.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the CRC driver. On target the
+				checksum is computed by the CRC module, fed by the core or by
+				DMA channel 0 for large buffers. The host build, which has no
+				CRC module, uses the table-driven engine instead.
+
+				The engine holds a single remainder: it is loaded from the
+				context when another context is updated, and saved back after
+				every update. The driver is not reentrant; do not use it from
+				interrupts.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "CRC.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		TRANSPOSE_BITS_AND_BYTES
+	\brief		TOT value reversing the bits of every byte written (reflected input)
+*/
+#define		TRANSPOSE_BITS_AND_BYTES	2
+
+/*!
+	\def		TRANSPOSE_BYTES
+	\brief		TOT value swapping the bytes of a word so the first byte in
+				memory is shifted in first
+*/
+#define		TRANSPOSE_BYTES				3
+
+/*!
+	\def		CRC_DMA_CHANNEL
+	\brief		DMA channel feeding the CRC module
+*/
+#define		CRC_DMA_CHANNEL				0
+
+/*!
+	\def		CRC_DMA_MAX
+	\brief		Largest buffer a single DMA update can take (BCR is 20 bits)
+*/
+#define		CRC_DMA_MAX					0xFFFFCu
+
+/*!
+	\def		DMA_SIZE_32BIT
+	\brief		SSIZE and DSIZE value of 32-bit transfers
+*/
+#define		DMA_SIZE_32BIT				0
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CRC_PARAMS
+	\brief		Rocksoft model parameters of a preset
+*/
+typedef struct
+{
+	uint32_t polynomial;
+	uint32_t seed;
+	uint32_t xorOut;
+	uint32_t mask;
+	uint8_t width;
+	uint8_t reflect;
+} CRC_PARAMS;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		presets
+	\brief		Parameters of every CRC_PRESET, in enum order
+*/
+static const CRC_PARAMS presets[eCRC_PRESETS] = {
+		{0x1021u,		0xFFFFu,		0x0000u,		0xFFFFu,		16,	0},
+		{0x04C11DB7u,	0xFFFFFFFFu,	0xFFFFFFFFu,	0xFFFFFFFFu,	32,	1}
+};
+
+#ifdef CRC_SOFTWARE_ENABLE
+/*!
+	\var		crc16Table
+	\brief		CRC-16/CCITT remainders of every byte, most significant bit first
+*/
+static const uint16_t crc16Table[256] = {
+		0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+		0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+		0x1231u, 0x0210u, 0x3273u, 0x2252u, 0x52B5u, 0x4294u, 0x72F7u, 0x62D6u,
+		0x9339u, 0x8318u, 0xB37Bu, 0xA35Au, 0xD3BDu, 0xC39Cu, 0xF3FFu, 0xE3DEu,
+		0x2462u, 0x3443u, 0x0420u, 0x1401u, 0x64E6u, 0x74C7u, 0x44A4u, 0x5485u,
+		0xA56Au, 0xB54Bu, 0x8528u, 0x9509u, 0xE5EEu, 0xF5CFu, 0xC5ACu, 0xD58Du,
+		0x3653u, 0x2672u, 0x1611u, 0x0630u, 0x76D7u, 0x66F6u, 0x5695u, 0x46B4u,
+		0xB75Bu, 0xA77Au, 0x9719u, 0x8738u, 0xF7DFu, 0xE7FEu, 0xD79Du, 0xC7BCu,
+		0x48C4u, 0x58E5u, 0x6886u, 0x78A7u, 0x0840u, 0x1861u, 0x2802u, 0x3823u,
+		0xC9CCu, 0xD9EDu, 0xE98Eu, 0xF9AFu, 0x8948u, 0x9969u, 0xA90Au, 0xB92Bu,
+		0x5AF5u, 0x4AD4u, 0x7AB7u, 0x6A96u, 0x1A71u, 0x0A50u, 0x3A33u, 0x2A12u,
+		0xDBFDu, 0xCBDCu, 0xFBBFu, 0xEB9Eu, 0x9B79u, 0x8B58u, 0xBB3Bu, 0xAB1Au,
+		0x6CA6u, 0x7C87u, 0x4CE4u, 0x5CC5u, 0x2C22u, 0x3C03u, 0x0C60u, 0x1C41u,
+		0xEDAEu, 0xFD8Fu, 0xCDECu, 0xDDCDu, 0xAD2Au, 0xBD0Bu, 0x8D68u, 0x9D49u,
+		0x7E97u, 0x6EB6u, 0x5ED5u, 0x4EF4u, 0x3E13u, 0x2E32u, 0x1E51u, 0x0E70u,
+		0xFF9Fu, 0xEFBEu, 0xDFDDu, 0xCFFCu, 0xBF1Bu, 0xAF3Au, 0x9F59u, 0x8F78u,
+		0x9188u, 0x81A9u, 0xB1CAu, 0xA1EBu, 0xD10Cu, 0xC12Du, 0xF14Eu, 0xE16Fu,
+		0x1080u, 0x00A1u, 0x30C2u, 0x20E3u, 0x5004u, 0x4025u, 0x7046u, 0x6067u,
+		0x83B9u, 0x9398u, 0xA3FBu, 0xB3DAu, 0xC33Du, 0xD31Cu, 0xE37Fu, 0xF35Eu,
+		0x02B1u, 0x1290u, 0x22F3u, 0x32D2u, 0x4235u, 0x5214u, 0x6277u, 0x7256u,
+		0xB5EAu, 0xA5CBu, 0x95A8u, 0x8589u, 0xF56Eu, 0xE54Fu, 0xD52Cu, 0xC50Du,
+		0x34E2u, 0x24C3u, 0x14A0u, 0x0481u, 0x7466u, 0x6447u, 0x5424u, 0x4405u,
+		0xA7DBu, 0xB7FAu, 0x8799u, 0x97B8u, 0xE75Fu, 0xF77Eu, 0xC71Du, 0xD73Cu,
+		0x26D3u, 0x36F2u, 0x0691u, 0x16B0u, 0x6657u, 0x7676u, 0x4615u, 0x5634u,
+		0xD94Cu, 0xC96Du, 0xF90Eu, 0xE92Fu, 0x99C8u, 0x89E9u, 0xB98Au, 0xA9ABu,
+		0x5844u, 0x4865u, 0x7806u, 0x6827u, 0x18C0u, 0x08E1u, 0x3882u, 0x28A3u,
+		0xCB7Du, 0xDB5Cu, 0xEB3Fu, 0xFB1Eu, 0x8BF9u, 0x9BD8u, 0xABBBu, 0xBB9Au,
+		0x4A75u, 0x5A54u, 0x6A37u, 0x7A16u, 0x0AF1u, 0x1AD0u, 0x2AB3u, 0x3A92u,
+		0xFD2Eu, 0xED0Fu, 0xDD6Cu, 0xCD4Du, 0xBDAAu, 0xAD8Bu, 0x9DE8u, 0x8DC9u,
+		0x7C26u, 0x6C07u, 0x5C64u, 0x4C45u, 0x3CA2u, 0x2C83u, 0x1CE0u, 0x0CC1u,
+		0xEF1Fu, 0xFF3Eu, 0xCF5Du, 0xDF7Cu, 0xAF9Bu, 0xBFBAu, 0x8FD9u, 0x9FF8u,
+		0x6E17u, 0x7E36u, 0x4E55u, 0x5E74u, 0x2E93u, 0x3EB2u, 0x0ED1u, 0x1EF0u
+};
+
+/*!
+	\var		crc32Table
+	\brief		CRC-32 remainders of every byte, reflected
+*/
+static const uint32_t crc32Table[256] = {
+		0x00000000u, 0x77073096u, 0xEE0E612Cu, 0x990951BAu, 0x076DC419u, 0x706AF48Fu, 0xE963A535u, 0x9E6495A3u,
+		0x0EDB8832u, 0x79DCB8A4u, 0xE0D5E91Eu, 0x97D2D988u, 0x09B64C2Bu, 0x7EB17CBDu, 0xE7B82D07u, 0x90BF1D91u,
+		0x1DB71064u, 0x6AB020F2u, 0xF3B97148u, 0x84BE41DEu, 0x1ADAD47Du, 0x6DDDE4EBu, 0xF4D4B551u, 0x83D385C7u,
+		0x136C9856u, 0x646BA8C0u, 0xFD62F97Au, 0x8A65C9ECu, 0x14015C4Fu, 0x63066CD9u, 0xFA0F3D63u, 0x8D080DF5u,
+		0x3B6E20C8u, 0x4C69105Eu, 0xD56041E4u, 0xA2677172u, 0x3C03E4D1u, 0x4B04D447u, 0xD20D85FDu, 0xA50AB56Bu,
+		0x35B5A8FAu, 0x42B2986Cu, 0xDBBBC9D6u, 0xACBCF940u, 0x32D86CE3u, 0x45DF5C75u, 0xDCD60DCFu, 0xABD13D59u,
+		0x26D930ACu, 0x51DE003Au, 0xC8D75180u, 0xBFD06116u, 0x21B4F4B5u, 0x56B3C423u, 0xCFBA9599u, 0xB8BDA50Fu,
+		0x2802B89Eu, 0x5F058808u, 0xC60CD9B2u, 0xB10BE924u, 0x2F6F7C87u, 0x58684C11u, 0xC1611DABu, 0xB6662D3Du,
+		0x76DC4190u, 0x01DB7106u, 0x98D220BCu, 0xEFD5102Au, 0x71B18589u, 0x06B6B51Fu, 0x9FBFE4A5u, 0xE8B8D433u,
+		0x7807C9A2u, 0x0F00F934u, 0x9609A88Eu, 0xE10E9818u, 0x7F6A0DBBu, 0x086D3D2Du, 0x91646C97u, 0xE6635C01u,
+		0x6B6B51F4u, 0x1C6C6162u, 0x856530D8u, 0xF262004Eu, 0x6C0695EDu, 0x1B01A57Bu, 0x8208F4C1u, 0xF50FC457u,
+		0x65B0D9C6u, 0x12B7E950u, 0x8BBEB8EAu, 0xFCB9887Cu, 0x62DD1DDFu, 0x15DA2D49u, 0x8CD37CF3u, 0xFBD44C65u,
+		0x4DB26158u, 0x3AB551CEu, 0xA3BC0074u, 0xD4BB30E2u, 0x4ADFA541u, 0x3DD895D7u, 0xA4D1C46Du, 0xD3D6F4FBu,
+		0x4369E96Au, 0x346ED9FCu, 0xAD678846u, 0xDA60B8D0u, 0x44042D73u, 0x33031DE5u, 0xAA0A4C5Fu, 0xDD0D7CC9u,
+		0x5005713Cu, 0x270241AAu, 0xBE0B1010u, 0xC90C2086u, 0x5768B525u, 0x206F85B3u, 0xB966D409u, 0xCE61E49Fu,
+		0x5EDEF90Eu, 0x29D9C998u, 0xB0D09822u, 0xC7D7A8B4u, 0x59B33D17u, 0x2EB40D81u, 0xB7BD5C3Bu, 0xC0BA6CADu,
+		0xEDB88320u, 0x9ABFB3B6u, 0x03B6E20Cu, 0x74B1D29Au, 0xEAD54739u, 0x9DD277AFu, 0x04DB2615u, 0x73DC1683u,
+		0xE3630B12u, 0x94643B84u, 0x0D6D6A3Eu, 0x7A6A5AA8u, 0xE40ECF0Bu, 0x9309FF9Du, 0x0A00AE27u, 0x7D079EB1u,
+		0xF00F9344u, 0x8708A3D2u, 0x1E01F268u, 0x6906C2FEu, 0xF762575Du, 0x806567CBu, 0x196C3671u, 0x6E6B06E7u,
+		0xFED41B76u, 0x89D32BE0u, 0x10DA7A5Au, 0x67DD4ACCu, 0xF9B9DF6Fu, 0x8EBEEFF9u, 0x17B7BE43u, 0x60B08ED5u,
+		0xD6D6A3E8u, 0xA1D1937Eu, 0x38D8C2C4u, 0x4FDFF252u, 0xD1BB67F1u, 0xA6BC5767u, 0x3FB506DDu, 0x48B2364Bu,
+		0xD80D2BDAu, 0xAF0A1B4Cu, 0x36034AF6u, 0x41047A60u, 0xDF60EFC3u, 0xA867DF55u, 0x316E8EEFu, 0x4669BE79u,
+		0xCB61B38Cu, 0xBC66831Au, 0x256FD2A0u, 0x5268E236u, 0xCC0C7795u, 0xBB0B4703u, 0x220216B9u, 0x5505262Fu,
+		0xC5BA3BBEu, 0xB2BD0B28u, 0x2BB45A92u, 0x5CB36A04u, 0xC2D7FFA7u, 0xB5D0CF31u, 0x2CD99E8Bu, 0x5BDEAE1Du,
+		0x9B64C2B0u, 0xEC63F226u, 0x756AA39Cu, 0x026D930Au, 0x9C0906A9u, 0xEB0E363Fu, 0x72076785u, 0x05005713u,
+		0x95BF4A82u, 0xE2B87A14u, 0x7BB12BAEu, 0x0CB61B38u, 0x92D28E9Bu, 0xE5D5BE0Du, 0x7CDCEFB7u, 0x0BDBDF21u,
+		0x86D3D2D4u, 0xF1D4E242u, 0x68DDB3F8u, 0x1FDA836Eu, 0x81BE16CDu, 0xF6B9265Bu, 0x6FB077E1u, 0x18B74777u,
+		0x88085AE6u, 0xFF0F6A70u, 0x66063BCAu, 0x11010B5Cu, 0x8F659EFFu, 0xF862AE69u, 0x616BFFD3u, 0x166CCF45u,
+		0xA00AE278u, 0xD70DD2EEu, 0x4E048354u, 0x3903B3C2u, 0xA7672661u, 0xD06016F7u, 0x4969474Du, 0x3E6E77DBu,
+		0xAED16A4Au, 0xD9D65ADCu, 0x40DF0B66u, 0x37D83BF0u, 0xA9BCAE53u, 0xDEBB9EC5u, 0x47B2CF7Fu, 0x30B5FFE9u,
+		0xBDBDF21Cu, 0xCABAC28Au, 0x53B39330u, 0x24B4A3A6u, 0xBAD03605u, 0xCDD70693u, 0x54DE5729u, 0x23D967BFu,
+		0xB3667A2Eu, 0xC4614AB8u, 0x5D681B02u, 0x2A6F2B94u, 0xB40BBE37u, 0xC30C8EA1u, 0x5A05DF1Bu, 0x2D02EF8Du
+};
+#endif
+
+#ifndef HOST_SIMULATION
+/*!
+	\var		owner
+	\brief		Context whose remainder is loaded in the CRC module
+*/
+static CRC_CONTEXT *owner = 0;
+
+/*!
+	\var		ready
+	\brief		Set once the CRC module and the DMA channel are clocked
+*/
+static uint8_t ready = 0;
+
+/*!
+	\var		dmaBusy
+	\brief		Set while the DMA channel feeds the CRC module
+*/
+static volatile uint8_t dmaBusy = 0;
+
+/*!
+	\var		dmaContext
+	\brief		Context of the DMA update in progress
+*/
+static CRC_CONTEXT *dmaContext = 0;
+
+/*!
+	\var		dmaCallback
+	\brief		Called when the DMA update in progress is done
+*/
+static CRC_CALLBACK dmaCallback = 0;
+
+/*!
+	\var		dmaData
+	\brief		Word-aligned part of the buffer handed to the DMA channel
+*/
+static const uint8_t *dmaData = 0;
+
+/*!
+	\var		dmaLength
+	\brief		Bytes left after the head, the DMA words plus the unaligned tail
+*/
+static uint32_t dmaLength = 0;
+
+/*!
+	\var		dmaSeed
+	\brief		Remainder before the DMA words, to redo them if the transfer fails
+*/
+static uint32_t dmaSeed = 0;
+#endif
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint32_t CRC_dwfnReflect (uint32_t value, uint8_t width);
+static uint32_t CRC_dwfnFinish (const CRC_PARAMS *params, uint32_t value, uint8_t hardware);
+#ifdef CRC_SOFTWARE_ENABLE
+static uint32_t CRC_dwfnSoftSeed (const CRC_PARAMS *params);
+static uint32_t CRC_dwfnTableUpdate (CRC_PRESET preset, uint32_t value,
+									 const uint8_t *data, uint32_t length);
+static uint32_t CRC_dwfnBitwiseUpdate (const CRC_PARAMS *params, uint32_t value,
+									   const uint8_t *data, uint32_t length);
+#endif
+#ifndef HOST_SIMULATION
+static void CRC_vfnLoad (CRC_CONTEXT *context);
+static void CRC_vfnFeed (const uint8_t *data, uint32_t length);
+static void CRC_vfnSave (CRC_CONTEXT *context);
+#endif
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t CRC_dwfnReflect (uint32_t value, uint8_t width)
+	\param		value	Value to reflect
+	\param		width	Bits of the value
+	\return		Returns the low width bits of value in reverse order
+	\brief		The M0+ has no RBIT instruction, so this is a bit loop. It only
+				runs once per checksum.
+*/
+static uint32_t CRC_dwfnReflect (uint32_t value, uint8_t width)
+{
+	uint32_t reflected = 0;
+	uint8_t i = 0;
+
+	for (i = 0; i < width; i++)
+	{
+		reflected = (reflected << 1) | (value & 1u);
+		value >>= 1;
+	}
+	return reflected;
+}
+
+/*!
+	\fn			static uint32_t CRC_dwfnFinish (const CRC_PARAMS *params, uint32_t value, uint8_t hardware)
+	\param		params		Preset of the checksum
+	\param		value		Remainder after the last byte
+	\param		hardware	Set if the remainder comes from the CRC module
+	\return		Returns the checksum
+	\brief		The module runs with no output transposition so its remainder
+				can be saved and reloaded; the reflection is applied here.
+				The software engines already work reflected.
+*/
+static uint32_t CRC_dwfnFinish (const CRC_PARAMS *params, uint32_t value, uint8_t hardware)
+{
+	if (hardware && params->reflect)
+	{
+		value = CRC_dwfnReflect (value, params->width);
+	}
+	return (value ^ params->xorOut) & params->mask;
+}
+
+#ifdef CRC_SOFTWARE_ENABLE
+/*!
+	\fn			static uint32_t CRC_dwfnSoftSeed (const CRC_PARAMS *params)
+	\param		params	Preset of the checksum
+	\return		Returns the initial remainder of the software engines
+*/
+static uint32_t CRC_dwfnSoftSeed (const CRC_PARAMS *params)
+{
+	return params->reflect ? CRC_dwfnReflect (params->seed, params->width) : params->seed;
+}
+
+/*!
+	\fn			static uint32_t CRC_dwfnTableUpdate (CRC_PRESET preset, uint32_t value, const uint8_t *data, uint32_t length)
+	\param		preset	Preset of the checksum
+	\param		value	Remainder so far
+	\param		data	Bytes to add
+	\param		length	Number of bytes
+	\return		Returns the new remainder
+	\brief		One table lookup per byte
+*/
+static uint32_t CRC_dwfnTableUpdate (CRC_PRESET preset, uint32_t value,
+									 const uint8_t *data, uint32_t length)
+{
+	if (preset == eCRC32)
+	{
+		while (length--)
+		{
+			value = (value >> 8) ^ crc32Table[(value ^ *data++) & 0xFFu];
+		}
+	}
+	else
+	{
+		while (length--)
+		{
+			value = ((value << 8) ^ crc16Table[((value >> 8) ^ *data++) & 0xFFu]) & 0xFFFFu;
+		}
+	}
+	return value;
+}
+
+/*!
+	\fn			static uint32_t CRC_dwfnBitwiseUpdate (const CRC_PARAMS *params, uint32_t value, const uint8_t *data, uint32_t length)
+	\param		params	Preset of the checksum
+	\param		value	Remainder so far
+	\param		data	Bytes to add
+	\param		length	Number of bytes
+	\return		Returns the new remainder
+	\brief		Shift and conditional XOR for every bit; the reference the
+				other engines are measured against
+*/
+static uint32_t CRC_dwfnBitwiseUpdate (const CRC_PARAMS *params, uint32_t value,
+									   const uint8_t *data, uint32_t length)
+{
+	uint32_t polynomial = params->polynomial;
+	uint32_t top = 1u << (params->width - 1u);
+	uint8_t bit = 0;
+
+	if (params->reflect)
+	{
+		polynomial = CRC_dwfnReflect (polynomial, params->width);
+		while (length--)
+		{
+			value ^= *data++;
+			for (bit = 0; bit < 8; bit++)
+			{
+				value = (value & 1u) ? ((value >> 1) ^ polynomial) : (value >> 1);
+			}
+		}
+	}
+	else
+	{
+		while (length--)
+		{
+			value ^= (uint32_t)(*data++) << (params->width - 8u);
+			for (bit = 0; bit < 8; bit++)
+			{
+				value = (value & top) ? ((value << 1) ^ polynomial) : (value << 1);
+			}
+			value &= params->mask;
+		}
+	}
+	return value;
+}
+#endif
+
+#ifndef HOST_SIMULATION
+/*!
+	\fn			static void CRC_vfnLoad (CRC_CONTEXT *context)
+	\param		context	Context to continue
+	\brief		Programs the preset and writes the remainder of the context
+				as the seed. The seed is written untransposed so a saved
+				remainder is restored as it was read.
+*/
+static void CRC_vfnLoad (CRC_CONTEXT *context)
+{
+	const CRC_PARAMS *params = &presets[context->preset];
+	uint32_t control = CRC_CTRL_TCRC(params->width == 32)
+			| CRC_CTRL_TOT(params->reflect ? TRANSPOSE_BITS_AND_BYTES : TRANSPOSE_BYTES);
+
+	CRC0->CTRL = CRC_CTRL_TCRC(params->width == 32);
+	CRC0->GPOLY = params->polynomial;
+	CRC0->CTRL = CRC_CTRL_TCRC(params->width == 32) | CRC_CTRL_WAS_MASK;
+	CRC0->DATA = context->value;
+	CRC0->CTRL = control;
+	owner = context;
+}
+
+/*!
+	\fn			static void CRC_vfnFeed (const uint8_t *data, uint32_t length)
+	\param		data	Bytes to add
+	\param		length	Number of bytes
+	\brief		Writes whole words where the buffer is aligned and single
+				bytes for the head and the tail
+*/
+static void CRC_vfnFeed (const uint8_t *data, uint32_t length)
+{
+	while (length && ((uint32_t)data & 3u))
+	{
+		CRC0->ACCESS8BIT.DATALL = *data++;
+		length--;
+	}
+	while (length >= 4u)
+	{
+		CRC0->DATA = *(const uint32_t *)data;
+		data += 4;
+		length -= 4u;
+	}
+	while (length--)
+	{
+		CRC0->ACCESS8BIT.DATALL = *data++;
+	}
+}
+
+/*!
+	\fn			static void CRC_vfnSave (CRC_CONTEXT *context)
+	\param		context	Context to update
+	\brief		Stores the remainder of the module back in the context
+*/
+static void CRC_vfnSave (CRC_CONTEXT *context)
+{
+	context->value = CRC0->DATA & presets[context->preset].mask;
+}
+#endif
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void CRC_vfnDriverInit (void)
+	\brief		Clocks the CRC module and the DMA channel feeding it. Called
+				by CRC_vfnStart the first time a checksum is needed.
+*/
+void CRC_vfnDriverInit (void)
+{
+#ifndef HOST_SIMULATION
+	SIM->SCGC6 |= SIM_SCGC6_CRC_MASK;
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+
+	DMA0->DMA[CRC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	NVIC_EnableIRQ (DMA0_IRQn);
+	ready = 1;
+#endif
+}
+
+/*!
+	\fn			void CRC_vfnStart (CRC_CONTEXT *context, CRC_PRESET preset)
+	\param		context	Context of the new checksum
+	\param		preset	Checksum to compute
+	\brief		Starts a checksum. Every stream must start here, even when the
+				context is reused.
+*/
+void CRC_vfnStart (CRC_CONTEXT *context, CRC_PRESET preset)
+{
+	context->preset = preset;
+#ifdef HOST_SIMULATION
+	context->value = CRC_dwfnSoftSeed (&presets[preset]);
+#else
+	if (!ready)
+	{
+		CRC_vfnDriverInit ();
+	}
+	context->value = presets[preset].seed;
+	if (owner == context)
+	{
+		owner = 0;
+	}
+#endif
+}
+
+/*!
+	\fn			void CRC_vfnUpdate (CRC_CONTEXT *context, const uint8_t *data, uint32_t length)
+	\param		context	Checksum in progress
+	\param		data	Bytes to add
+	\param		length	Number of bytes
+	\brief		Adds a block to the checksum. Waits for a DMA update in progress.
+*/
+void CRC_vfnUpdate (CRC_CONTEXT *context, const uint8_t *data, uint32_t length)
+{
+#ifdef HOST_SIMULATION
+	context->value = CRC_dwfnTableUpdate (context->preset, context->value, data, length);
+#else
+	while (dmaBusy)
+	{
+	}
+	if (owner != context)
+	{
+		CRC_vfnLoad (context);
+	}
+	CRC_vfnFeed (data, length);
+	CRC_vfnSave (context);
+#endif
+}
+
+/*!
+	\fn			uint8_t CRC_bfnUpdateDma (CRC_CONTEXT *context, const uint8_t *data, uint32_t length, CRC_CALLBACK callback)
+	\param		context		Checksum in progress
+	\param		data		Bytes to add; must stay untouched until the callback
+	\param		length		Number of bytes
+	\param		callback	Called from the DMA interrupt when the block is added;
+							may be NULL if CRC_bfnDmaBusy is polled instead
+	\return		Returns 0 if a DMA update is already in progress or the block is
+				too large; returns 1 if it was started
+	\brief		Adds a block with the DMA channel writing whole words into the
+				CRC module while the core does something else. The unaligned
+				head and tail bytes are written by the core.
+*/
+uint8_t CRC_bfnUpdateDma (CRC_CONTEXT *context, const uint8_t *data, uint32_t length,
+						  CRC_CALLBACK callback)
+{
+#ifdef HOST_SIMULATION
+	CRC_vfnUpdate (context, data, length);
+	if (callback)
+	{
+		callback (context);
+	}
+	return 1;
+#else
+	uint32_t head = (4u - ((uint32_t)data & 3u)) & 3u;
+
+	if (dmaBusy || (length > CRC_DMA_MAX))
+	{
+		return 0;
+	}
+	if (head > length)
+	{
+		head = length;
+	}
+	if (owner != context)
+	{
+		CRC_vfnLoad (context);
+	}
+	CRC_vfnFeed (data, head);
+
+	dmaContext = context;
+	dmaCallback = callback;
+	dmaData = data + head;
+	dmaLength = length - head;
+	dmaSeed = CRC0->DATA;
+	dmaBusy = 1;
+
+	if (dmaLength < 4u)
+	{
+		DMA0_DriverIRQHandler ();
+		return 1;
+	}
+
+	DMA0->DMA[CRC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[CRC_DMA_CHANNEL].SAR = (uint32_t)dmaData;
+	DMA0->DMA[CRC_DMA_CHANNEL].DAR = (uint32_t)&CRC0->DATA;
+	DMA0->DMA[CRC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(dmaLength & ~3u);
+	DMA0->DMA[CRC_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_SINC_MASK
+			| DMA_DCR_SSIZE(DMA_SIZE_32BIT) | DMA_DCR_DSIZE(DMA_SIZE_32BIT)
+			| DMA_DCR_START_MASK;
+	return 1;
+#endif
+}
+
+/*!
+	\fn			uint8_t CRC_bfnDmaBusy (void)
+	\return		Returns 1 while a DMA update is in progress; else, returns 0
+*/
+uint8_t CRC_bfnDmaBusy (void)
+{
+#ifdef HOST_SIMULATION
+	return 0;
+#else
+	return dmaBusy;
+#endif
+}
+
+#ifndef HOST_SIMULATION
+/*!
+	\fn			void DMA0_DriverIRQHandler (void)
+	\brief		End of a DMA update: adds the tail bytes, saves the remainder
+				and calls the callback. If the transfer failed, the words are
+				added by the core from the remainder saved before the transfer.
+*/
+void DMA0_DriverIRQHandler (void)
+{
+	uint32_t status = DMA0->DMA[CRC_DMA_CHANNEL].DSR_BCR;
+	uint32_t words = dmaLength & ~3u;
+
+	STACK_ISR_ENTER (eSTACK_ISR_CRC_DMA);
+	DMA0->DMA[CRC_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	if (words && (status & (DMA_DSR_BCR_CE_MASK | DMA_DSR_BCR_BES_MASK | DMA_DSR_BCR_BED_MASK)))
+	{
+		dmaContext->value = dmaSeed;
+		CRC_vfnLoad (dmaContext);
+		CRC_vfnFeed (dmaData, words);
+	}
+	CRC_vfnFeed (dmaData + words, dmaLength & 3u);
+	CRC_vfnSave (dmaContext);
+
+	dmaBusy = 0;
+	if (dmaCallback)
+	{
+		dmaCallback (dmaContext);
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_CRC_DMA);
+}
+#endif
+
+/*!
+	\fn			uint32_t CRC_dwfnFinal (CRC_CONTEXT *context)
+	\param		context	Checksum in progress
+	\return		Returns the checksum of every byte added since CRC_vfnStart.
+				The context can still be updated afterwards.
+*/
+uint32_t CRC_dwfnFinal (CRC_CONTEXT *context)
+{
+#ifdef HOST_SIMULATION
+	return CRC_dwfnFinish (&presets[context->preset], context->value, 0);
+#else
+	while (dmaBusy)
+	{
+	}
+	return CRC_dwfnFinish (&presets[context->preset], context->value, 1);
+#endif
+}
+
+/*!
+	\fn			uint32_t CRC_dwfnCompute (CRC_PRESET preset, const uint8_t *data, uint32_t length)
+	\param		preset	Checksum to compute
+	\param		data	Bytes to check
+	\param		length	Number of bytes
+	\return		Returns the checksum of a whole buffer
+*/
+uint32_t CRC_dwfnCompute (CRC_PRESET preset, const uint8_t *data, uint32_t length)
+{
+	CRC_CONTEXT context;
+
+	CRC_vfnStart (&context, preset);
+	CRC_vfnUpdate (&context, data, length);
+	return CRC_dwfnFinal (&context);
+}
+
+#ifdef CRC_SOFTWARE_ENABLE
+/*!
+	\fn			uint32_t CRC_dwfnComputeWith (CRC_PRESET preset, CRC_METHOD method, const uint8_t *data, uint32_t length)
+	\param		preset	Checksum to compute
+	\param		method	Engine to use; eCRC_HARDWARE is the table on the host
+	\param		data	Bytes to check
+	\param		length	Number of bytes
+	\return		Returns the checksum of a whole buffer
+	\brief		Used by the benchmarks to compare the engines
+*/
+uint32_t CRC_dwfnComputeWith (CRC_PRESET preset, CRC_METHOD method,
+							  const uint8_t *data, uint32_t length)
+{
+	const CRC_PARAMS *params = &presets[preset];
+	uint32_t value = CRC_dwfnSoftSeed (params);
+
+	switch (method)
+	{
+		case eCRC_HARDWARE:
+			return CRC_dwfnCompute (preset, data, length);
+		case eCRC_TABLE:
+			value = CRC_dwfnTableUpdate (preset, value, data, length);
+			break;
+		case eCRC_BITWISE:
+		default:
+			value = CRC_dwfnBitwiseUpdate (params, value, data, length);
+			break;
+	}
+	return CRC_dwfnFinish (params, value, 0);
+}
+#endif
+//------------------------------------------------------------------------------
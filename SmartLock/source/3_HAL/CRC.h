@@ -0,0 +1,106 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		CRC.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the CRC driver. Checksums are computed
+				as a stream (start, any number of updates, final) so records,
+				frames and firmware images can be checked as they arrive.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_CRC_H_
+#define _3_HAL_CRC_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def	CRC_SOFTWARE_ENABLE
+		\brief	If defined, the table-driven and bitwise engines are built too.
+				The host build has no CRC module and always uses the table.
+	*/
+#if defined(HOST_SIMULATION) || defined(BENCHMARK_BUILD)
+	#define CRC_SOFTWARE_ENABLE
+#endif
+
+	//--------------------------------------------------------------------------
+	// Enums
+	//--------------------------------------------------------------------------
+	/*!
+		\enum	CRC_PRESET
+		\brief	Supported checksums
+	*/
+	typedef enum
+	{
+		eCRC16_CCITT = 0,	/* poly 0x1021, seed 0xFFFF, not reflected; check 0x29B1 */
+		eCRC32,				/* IEEE 802.3, reflected, inverted; check 0xCBF43926 */
+		eCRC_PRESETS
+	} CRC_PRESET;
+
+	/*!
+		\enum	CRC_METHOD
+		\brief	Engines that CRC_dwfnComputeWith can be asked for
+	*/
+	typedef enum
+	{
+		eCRC_HARDWARE = 0,
+		eCRC_TABLE,
+		eCRC_BITWISE
+	} CRC_METHOD;
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\struct	CRC_CONTEXT
+		\brief	State of one checksum in progress. The remainder is kept in
+				the form the engine works with; only CRC_dwfnFinal makes sense
+				of it.
+	*/
+	typedef struct
+	{
+		uint32_t value;
+		CRC_PRESET preset;
+	} CRC_CONTEXT;
+
+	/*!
+		\typedef	CRC_CALLBACK
+		\brief		Called from the DMA interrupt once a DMA update is done
+	*/
+	typedef void (*CRC_CALLBACK)(CRC_CONTEXT *context);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	void CRC_vfnDriverInit (void);
+
+	void CRC_vfnStart (CRC_CONTEXT *context, CRC_PRESET preset);
+
+	void CRC_vfnUpdate (CRC_CONTEXT *context, const uint8_t *data, uint32_t length);
+
+	uint8_t CRC_bfnUpdateDma (CRC_CONTEXT *context, const uint8_t *data, uint32_t length,
+							  CRC_CALLBACK callback);
+
+	uint8_t CRC_bfnDmaBusy (void);
+
+#ifndef HOST_SIMULATION
+	void DMA0_DriverIRQHandler (void);
+#endif
+
+	uint32_t CRC_dwfnFinal (CRC_CONTEXT *context);
+
+	uint32_t CRC_dwfnCompute (CRC_PRESET preset, const uint8_t *data, uint32_t length);
+
+#ifdef CRC_SOFTWARE_ENABLE
+	uint32_t CRC_dwfnComputeWith (CRC_PRESET preset, CRC_METHOD method,
+								  const uint8_t *data, uint32_t length);
+#endif
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_CRC_H_ */
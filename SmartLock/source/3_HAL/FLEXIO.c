@@ -0,0 +1,352 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		FLEXIO.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the FlexIO keypad scanner.
+
+				The FlexIO of the KL27 has four timers, four single-pin
+				shifters and no pin state register, which is not enough to
+				strobe four rows. The scan is turned around instead: FlexIO
+				strobes the three columns and the rows are read.
+				- Timer 3 runs freely and toggles once per slot
+				- Timers 0 to 2 are PWM outputs on columns 0 to 2 (PTD4 to
+				  PTD6) that count the slots of timer 3: one slot high and
+				  FRAME_SLOTS - 1 low, started two slots apart, so no two
+				  columns are ever driven back to back
+				The rows (PTD0-PTD3) are inputs with pull-downs that interrupt
+				on a rising edge through the pin interrupt service, which only
+				happens when a pressed key connects a row to the strobed
+				column. An idle keypad raises
+				no interrupt at all. The first edge enables the interrupt of
+				timer 0, raised as column 0 goes high, which ends the previous
+				frame; frames are then reported until one comes back empty,
+				which is also how releases are seen.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "FLEXIO.h"
+#include "PORT.h"
+#include "ClockProfile.h"
+#include "Stack.h"
+
+#ifdef KEYPAD_FLEXIO_ENABLE
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		US_PER_SECOND
+	\brief		Microseconds in a second
+*/
+#define		US_PER_SECOND		1000000u
+
+/*!
+	\def		KEYPAD_COLUMNS
+	\brief		Columns strobed by FlexIO timers 0 to 2
+*/
+#define		KEYPAD_COLUMNS		3u
+
+/*!
+	\def		KEYPAD_ROWS
+	\brief		Rows read on PTD0-PTD3
+*/
+#define		KEYPAD_ROWS			4u
+
+/*!
+	\def		COLUMN_PIN
+	\brief		FlexIO pin (FXIO0_Dn) and PORTD pin of column 0
+*/
+#define		COLUMN_PIN			4u
+
+/*!
+	\def		FRAME_SLOTS
+	\brief		Slots in a frame: a strobe and a gap per column
+*/
+#define		FRAME_SLOTS			(2u * KEYPAD_COLUMNS)
+
+/*!
+	\def		SLOT_TIMER
+	\brief		Free-running timer whose output toggles every slot
+*/
+#define		SLOT_TIMER			3u
+
+/*!
+	\def		FRAME_FLAG
+	\brief		Status of timer 0, set as column 0 goes high
+*/
+#define		FRAME_FLAG			(1u << 0)
+
+/*!
+	\def		TIMER_TRIGGER
+	\brief		Internal trigger selection of a timer's output
+*/
+#define		TIMER_TRIGGER(n)	(4u * (n) + 3u)
+
+/*!
+	\def		PCR_ROW
+	\brief		Rows: GPIO inputs with pull-down, the interrupt is set by
+				the pin interrupt service
+*/
+#define		PCR_ROW				(PORT_PCR_MUX(1) | PORT_PCR_PE_MASK)
+
+/*!
+	\def		PCR_COLUMN
+	\brief		Columns: FXIO0_D4 to FXIO0_D6
+*/
+#define		PCR_COLUMN			PORT_PCR_MUX(6)
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		frameCallback
+	\brief		Receives every complete frame
+*/
+static FLEXIO_FRAME_CALLBACK frameCallback = 0;
+
+/*!
+	\var		slotPeriodUs
+	\brief		Strobe length of one column, 0 while stopped
+*/
+static uint32_t slotPeriodUs = 0;
+
+/*!
+	\var		frameKeys
+	\brief		Keys seen by the row edges of the frame in progress
+*/
+static volatile uint16_t frameKeys = 0;
+
+/*!
+	\var		wakeups
+	\brief		Times an edge on an idle keypad started frame reporting
+*/
+static uint32_t wakeups = 0;
+
+/*!
+	\var		frames
+	\brief		Frames reported
+*/
+static uint32_t frames = 0;
+
+/*!
+	\var		isRegistered
+	\brief		Set once the clock listener was registered
+*/
+static uint8_t isRegistered = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void FLEXIO_vfnConfigureTimers (uint32_t irClock);
+static void FLEXIO_vfnRowEdge (uint8_t pin, uint32_t levels);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void FLEXIO_vfnConfigureTimers (uint32_t irClock)
+	\param		irClock		MCGIRCLK in Hz, the FlexIO clock
+	\brief		Sets up the strobe timers for the slot length and enables the
+				module. In dual 8-bit PWM mode the upper byte of TIMCMP is the
+				low time and the lower byte the high time, reloaded at every
+				phase. The columns start low with a first low time two slots
+				longer per column, and the steady low time is written as soon
+				as they run, which leaves the strobes staggered for good.
+*/
+static void FLEXIO_vfnConfigureTimers (uint32_t irClock)
+{
+	uint32_t slotCounts = slotPeriodUs * (irClock / US_PER_SECOND);
+	uint8_t timer = 0;
+
+	FLEXIO->CTRL = 0;
+
+	/* Slots: a 16-bit counter toggling its output every slot */
+	FLEXIO->TIMCMP[SLOT_TIMER] = slotCounts - 1u;
+	FLEXIO->TIMCFG[SLOT_TIMER] = FLEXIO_TIMCFG_TIMOUT(0) | FLEXIO_TIMCFG_TIMDEC(0)
+			| FLEXIO_TIMCFG_TIMENA(0) | FLEXIO_TIMCFG_TIMDIS(0);
+	FLEXIO->TIMCTL[SLOT_TIMER] = FLEXIO_TIMCTL_TIMOD(3);
+
+	/* Columns: PWM counting both edges of the slot timer */
+	for (timer = 0; timer < KEYPAD_COLUMNS; timer++)
+	{
+		FLEXIO->TIMCMP[timer] = (uint32_t)(2u * timer) << 8;
+		FLEXIO->TIMCFG[timer] = FLEXIO_TIMCFG_TIMOUT(1) | FLEXIO_TIMCFG_TIMDEC(1)
+				| FLEXIO_TIMCFG_TIMENA(0) | FLEXIO_TIMCFG_TIMDIS(0);
+		FLEXIO->TIMCTL[timer] = FLEXIO_TIMCTL_TRGSRC_MASK
+				| FLEXIO_TIMCTL_TRGSEL(TIMER_TRIGGER (SLOT_TIMER))
+				| FLEXIO_TIMCTL_PINCFG(3) | FLEXIO_TIMCTL_PINSEL(COLUMN_PIN + timer)
+				| FLEXIO_TIMCTL_TIMOD(2);
+	}
+
+	FLEXIO->TIMSTAT = 0xFu;
+	FLEXIO->CTRL = FLEXIO_CTRL_FLEXEN_MASK | FLEXIO_CTRL_DBGE_MASK;
+
+	/* Takes effect at the next reload, well within the first slot */
+	for (timer = 0; timer < KEYPAD_COLUMNS; timer++)
+	{
+		FLEXIO->TIMCMP[timer] = (uint32_t)(FRAME_SLOTS - 2u) << 8;
+	}
+}
+
+/*!
+	\fn			void FLEXIO_vfnKeypadStart (uint32_t slotUs, FLEXIO_FRAME_CALLBACK callback)
+	\param		slotUs		Strobe length of each column in microseconds; a
+							frame takes FRAME_SLOTS slots
+	\param		callback	Called with every frame while keys are in use
+	\brief		Hands the keypad pins to the scanner and starts strobing. The
+				pins must have been clocked by the GPIO driver.
+*/
+void FLEXIO_vfnKeypadStart (uint32_t slotUs, FLEXIO_FRAME_CALLBACK callback)
+{
+	uint8_t pin = 0;
+
+	frameCallback = callback;
+	slotPeriodUs = slotUs;
+	frameKeys = 0;
+
+	SIM->SCGC5 |= SIM_SCGC5_FLEXIO_MASK | SIM_SCGC5_PORTD_MASK;
+	SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_FLEXIOSRC_MASK) | SIM_SOPT2_FLEXIOSRC(3);
+
+	for (pin = 0; pin < KEYPAD_ROWS; pin++)
+	{
+		GPIOD->PDDR &= ~(1u << pin);
+		PORTD->PCR[pin] = PCR_ROW;
+	}
+	for (pin = 0; pin < KEYPAD_COLUMNS; pin++)
+	{
+		PORTD->PCR[COLUMN_PIN + pin] = PCR_COLUMN;
+	}
+
+	FLEXIO->TIMIEN = 0;
+	FLEXIO_vfnConfigureTimers (ClockProfile_dwfnGetIrClock ());
+	if (!isRegistered)
+	{
+		isRegistered = ClockProfile_bfnRegister (FLEXIO_vfnClockChanged);
+	}
+
+	NVIC_EnableIRQ (UART2_FLEXIO_IRQn);
+	for (pin = 0; pin < KEYPAD_ROWS; pin++)
+	{
+		PORT_bfnRegister (ePORTD, (PINS)pin, ePORT_RISING, 0, FLEXIO_vfnRowEdge);
+	}
+}
+
+/*!
+	\fn			void FLEXIO_vfnKeypadStop (void)
+	\brief		Stops strobing and disables the row interrupts. The pins are
+				left for the caller to configure again.
+*/
+void FLEXIO_vfnKeypadStop (void)
+{
+	uint8_t pin = 0;
+
+	slotPeriodUs = 0;
+	FLEXIO->TIMIEN = 0;
+	FLEXIO->CTRL = 0;
+	for (pin = 0; pin < KEYPAD_ROWS; pin++)
+	{
+		PORT_vfnUnregister (ePORTD, (PINS)pin);
+	}
+}
+
+/*!
+	\fn			uint32_t FLEXIO_dwfnGetWakeups (void)
+	\return		Returns how many times a press woke the idle scanner
+*/
+uint32_t FLEXIO_dwfnGetWakeups (void)
+{
+	return wakeups;
+}
+
+/*!
+	\fn			uint32_t FLEXIO_dwfnGetFrames (void)
+	\return		Returns how many frames were reported
+*/
+uint32_t FLEXIO_dwfnGetFrames (void)
+{
+	return frames;
+}
+
+/*!
+	\fn			void FLEXIO_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+	\param		coreClock	New core clock in Hz
+	\param		irClock		New MCGIRCLK in Hz
+	\brief		Recomputes the slot counts for the new MCGIRCLK. The frame in
+				progress is restarted.
+*/
+void FLEXIO_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+
+	if (slotPeriodUs)
+	{
+		frameKeys = 0;
+		FLEXIO_vfnConfigureTimers (irClock);
+	}
+}
+
+/*!
+	\fn			static void FLEXIO_vfnRowEdge (uint8_t pin, uint32_t levels)
+	\param		pin		Row that rose, PTD0 to PTD3
+	\param		levels	PORTD levels read along with the flag
+	\brief		Pin interrupt callback: a pressed key connects the row to the
+				column being strobed, which is read back from the pins (the
+				input buffer of a pin works in every mux setting) in the
+				snapshot the dispatcher took, before the strobe could move
+				on. The first edge on an idle keypad enables the end of
+				frame interrupt.
+*/
+static void FLEXIO_vfnRowEdge (uint8_t pin, uint32_t levels)
+{
+	uint32_t columns = (levels >> COLUMN_PIN) & ((1u << KEYPAD_COLUMNS) - 1u);
+
+	frameKeys |= (uint16_t)(columns << (pin * KEYPAD_COLUMNS));
+
+	if (!(FLEXIO->TIMIEN & FRAME_FLAG))
+	{
+		wakeups++;
+		FLEXIO->TIMSTAT = FRAME_FLAG;
+		FLEXIO->TIMIEN = FRAME_FLAG;
+	}
+}
+
+/*!
+	\fn			void UART2_FLEXIO_DriverIRQHandler (void)
+	\brief		End of frame, as column 0 goes high. An edge of column 0 raised
+				at the same time is pending too and is taken after this
+				handler, which has the lower interrupt number, so it counts
+				for the new frame. Reports the frame and goes back to waiting
+				for an edge after an empty one.
+*/
+void UART2_FLEXIO_DriverIRQHandler (void)
+{
+	uint16_t state;
+
+	STACK_ISR_ENTER (eSTACK_ISR_FLEXIO);
+	if (!(FLEXIO->TIMSTAT & FRAME_FLAG))
+	{
+		STACK_ISR_EXIT (eSTACK_ISR_FLEXIO);
+		return;
+	}
+	FLEXIO->TIMSTAT = FRAME_FLAG;
+
+	state = frameKeys;
+	frameKeys = 0;
+	frames++;
+	if (!state)
+	{
+		FLEXIO->TIMIEN = 0;
+	}
+	if (frameCallback)
+	{
+		frameCallback (state);
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_FLEXIO);
+}
+
+#endif /* KEYPAD_FLEXIO_ENABLE */
+//------------------------------------------------------------------------------
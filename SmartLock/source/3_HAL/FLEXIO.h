@@ -0,0 +1,60 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		FLEXIO.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the FlexIO keypad scanner. FlexIO
+				strobes the keypad columns on its own and the rows interrupt
+				only while a key connects them to a strobe, so an idle keypad
+				costs no CPU time at all.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_FLEXIO_H_
+#define _3_HAL_FLEXIO_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def		KEYPAD_FLEXIO_ENABLE
+		\brief		Scans the keypad with FlexIO instead of the PIT scan tick.
+					FlexIO only reaches PTD0-PTD7 on this package, so the board
+					must have keypad column 2 on PTD6 (FXIO0_D6) instead of PTB3.
+	*/
+	#ifndef HOST_SIMULATION
+//		#define KEYPAD_FLEXIO_ENABLE
+	#endif
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	FLEXIO_FRAME_CALLBACK
+		\brief		Called from the FlexIO interrupt with the key-state bitmap
+					of every complete frame, bit (row * 3 + column) per key
+	*/
+	typedef void (*FLEXIO_FRAME_CALLBACK)(uint16_t state);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	void FLEXIO_vfnKeypadStart (uint32_t slotUs, FLEXIO_FRAME_CALLBACK callback);
+
+	void FLEXIO_vfnKeypadStop (void);
+
+	uint32_t FLEXIO_dwfnGetWakeups (void);
+
+	uint32_t FLEXIO_dwfnGetFrames (void);
+
+	void FLEXIO_vfnClockChanged (uint32_t coreClock, uint32_t irClock);
+
+	void UART2_FLEXIO_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_FLEXIO_H_ */
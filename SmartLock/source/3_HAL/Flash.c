@@ -0,0 +1,159 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		Flash.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the program flash driver. The
+				KL27Z64 has a single flash block, so the CPU cannot fetch from
+				it while a command runs: the command is launched and waited on
+				from RAM with interrupts disabled, as every vector and handler
+				lives in flash.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include "MKL27Z644.h"
+#include "Flash.h"
+#include "RamFunc.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CMD_PROGRAM_LONGWORD
+	\brief		FTFA command that programs four bytes
+*/
+#define		CMD_PROGRAM_LONGWORD	0x06
+
+/*!
+	\def		CMD_ERASE_SECTOR
+	\brief		FTFA command that erases one sector
+*/
+#define		CMD_ERASE_SECTOR	0x09
+
+/*!
+	\def		FSTAT_ERRORS
+	\brief		Error flags of a finished command
+*/
+#define		FSTAT_ERRORS		(FTFA_FSTAT_ACCERR_MASK | FTFA_FSTAT_FPVIOL_MASK | \
+								 FTFA_FSTAT_MGSTAT0_MASK)
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint8_t Flash_bfnCommand (uint8_t command, uint32_t address, const uint8_t *data);
+static RAMFUNC void Flash_vfnLaunch (void);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			uint8_t Flash_bfnErase (uint32_t address)
+	\param		address	Start of the sector, a multiple of FLASH_SECTOR
+	\return		Returns 1 if the sector was erased; else, returns 0
+	\brief		Erases one sector. The CPU is stalled in RAM for the whole
+				erase, up to 100 ms.
+*/
+uint8_t Flash_bfnErase (uint32_t address)
+{
+	if ((address % FLASH_SECTOR) || (address >= FLASH_SIZE))
+	{
+		return 0;
+	}
+	return Flash_bfnCommand (CMD_ERASE_SECTOR, address, NULL);
+}
+
+/*!
+	\fn			uint8_t Flash_bfnProgram (uint32_t address, const uint8_t *data, uint32_t size)
+	\param		address	Destination, a multiple of FLASH_PHRASE
+	\param		data	Bytes to program
+	\param		size	Number of bytes, a multiple of FLASH_PHRASE
+	\return		Returns 1 if every longword was programmed; else, returns 0
+	\brief		Programs erased flash one longword at a time, so interrupts
+				are only held off for about 65 us at once
+*/
+uint8_t Flash_bfnProgram (uint32_t address, const uint8_t *data, uint32_t size)
+{
+	uint32_t offset = 0;
+
+	if ((address % FLASH_PHRASE) || (size % FLASH_PHRASE) ||
+			(address + size > FLASH_SIZE))
+	{
+		return 0;
+	}
+	for (offset = 0; offset < size; offset += FLASH_PHRASE)
+	{
+		if (!Flash_bfnCommand (CMD_PROGRAM_LONGWORD, address + offset, &data[offset]))
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*!
+	\fn			const uint8_t *Flash_pbfnRead (uint32_t address)
+	\param		address	Flash address
+	\return		Returns a pointer to read the flash through
+*/
+const uint8_t *Flash_pbfnRead (uint32_t address)
+{
+	return (const uint8_t *)address;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint8_t Flash_bfnCommand (uint8_t command, uint32_t address, const uint8_t *data)
+	\param		command	FTFA command
+	\param		address	Flash address of the command
+	\param		data	Four bytes to program, or NULL
+	\return		Returns 1 if the command finished without errors; else,
+				returns 0
+	\brief		Loads the command object and runs it from RAM
+*/
+static uint8_t Flash_bfnCommand (uint8_t command, uint32_t address, const uint8_t *data)
+{
+	uint32_t primask;
+
+	while (!(FTFA->FSTAT & FTFA_FSTAT_CCIF_MASK))
+	{
+	}
+	/* Errors of the previous command block the next one until cleared */
+	FTFA->FSTAT = FTFA_FSTAT_ACCERR_MASK | FTFA_FSTAT_FPVIOL_MASK;
+
+	FTFA->FCCOB0 = command;
+	FTFA->FCCOB1 = (uint8_t)(address >> 16);
+	FTFA->FCCOB2 = (uint8_t)(address >> 8);
+	FTFA->FCCOB3 = (uint8_t)address;
+	if (data != NULL)
+	{
+		/* FCCOB4 is the most significant byte of the longword */
+		FTFA->FCCOB4 = data[3];
+		FTFA->FCCOB5 = data[2];
+		FTFA->FCCOB6 = data[1];
+		FTFA->FCCOB7 = data[0];
+	}
+
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	Flash_vfnLaunch ();
+	__set_PRIMASK (primask);
+
+	return !(FTFA->FSTAT & FSTAT_ERRORS);
+}
+
+/*!
+	\fn			static void Flash_vfnLaunch (void)
+	\brief		Starts the loaded command and waits for it, running from RAM
+*/
+static RAMFUNC void Flash_vfnLaunch (void)
+{
+	FTFA->FSTAT = FTFA_FSTAT_CCIF_MASK;
+	while (!(FTFA->FSTAT & FTFA_FSTAT_CCIF_MASK))
+	{
+	}
+}
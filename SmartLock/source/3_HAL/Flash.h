@@ -0,0 +1,57 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		Flash.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the program flash driver. Erases
+				sectors and programs longwords through the FTFA command
+				interface.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_FLASH_H_
+#define _3_HAL_FLASH_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def		FLASH_SECTOR
+		\brief		Smallest erasable unit in bytes
+	*/
+	#define FLASH_SECTOR		1024u
+
+	/*!
+		\def		FLASH_PHRASE
+		\brief		Programming unit in bytes, a longword
+	*/
+	#define FLASH_PHRASE		4u
+
+	/*!
+		\def		FLASH_SIZE
+		\brief		Program flash of the KL27Z64
+	*/
+	#define FLASH_SIZE			0x10000u
+
+	/*!
+		\def		FLASH_ERASED
+		\brief		Value of an erased longword
+	*/
+	#define FLASH_ERASED		0xFFFFFFFFu
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	uint8_t Flash_bfnErase (uint32_t address);
+
+	uint8_t Flash_bfnProgram (uint32_t address, const uint8_t *data, uint32_t size);
+
+	const uint8_t *Flash_pbfnRead (uint32_t address);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_FLASH_H_ */
@@ -0,0 +1,183 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		PIT.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the periodic interrupt timer driver.
+				The PIT counts the bus clock, which changes with the clock
+				profile, so the load values are recomputed from the periods
+				in microseconds after every switch. The PIT keeps running in
+				WAIT and VLPW, which is where the core sleeps between ticks.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "fsl_clock.h"
+#include "PIT.h"
+#include "ClockProfile.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		US_PER_SECOND
+	\brief		Microseconds in a second
+*/
+#define		US_PER_SECOND		1000000u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		callbacks
+	\brief		Function called every period of each channel
+*/
+static PIT_CALLBACK callbacks[ePIT_CHANNELS] = {0};
+
+/*!
+	\var		periods
+	\brief		Period of each channel in microseconds, 0 while stopped
+*/
+static uint32_t periods[ePIT_CHANNELS] = {0};
+
+/*!
+	\var		busMhz
+	\brief		Bus clock in MHz, the PIT counts per microsecond
+*/
+static uint32_t busMhz = 1;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint32_t PIT_dwfnLoadValue (uint32_t periodUs);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t PIT_dwfnLoadValue (uint32_t periodUs)
+	\param		periodUs	Period in microseconds
+	\return		Returns the LDVAL of the period at the current bus clock
+*/
+static uint32_t PIT_dwfnLoadValue (uint32_t periodUs)
+{
+	return (periodUs * busMhz) - 1u;
+}
+
+/*!
+	\fn			void PIT_vfnDriverInit (void)
+	\brief		Clocks the PIT, freezes it while the debugger halts the core
+				and enables its interrupt
+*/
+void PIT_vfnDriverInit (void)
+{
+	SIM->SCGC6 |= SIM_SCGC6_PIT_MASK;
+	PIT->MCR = PIT_MCR_FRZ_MASK;
+
+	PIT_vfnClockChanged (SystemCoreClock, ClockProfile_dwfnGetIrClock ());
+	ClockProfile_bfnRegister (PIT_vfnClockChanged);
+	NVIC_EnableIRQ (PIT_IRQn);
+}
+
+/*!
+	\fn			void PIT_vfnStart (PIT_CHANNEL channel, uint32_t periodUs, PIT_CALLBACK callback)
+	\param		channel		Channel to start
+	\param		periodUs	Period in microseconds
+	\param		callback	Function to call every period, from the interrupt
+	\brief		Starts a channel; the first call comes one period from now
+*/
+void PIT_vfnStart (PIT_CHANNEL channel, uint32_t periodUs, PIT_CALLBACK callback)
+{
+	callbacks[channel] = callback;
+	periods[channel] = periodUs;
+
+	PIT->CHANNEL[channel].TCTRL = 0;
+	PIT->CHANNEL[channel].TFLG = PIT_TFLG_TIF_MASK;
+	PIT->CHANNEL[channel].LDVAL = PIT_dwfnLoadValue (periodUs);
+	PIT->CHANNEL[channel].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+}
+
+/*!
+	\fn			void PIT_vfnSetPeriod (PIT_CHANNEL channel, uint32_t periodUs)
+	\param		channel		Running channel
+	\param		periodUs	New period in microseconds
+	\brief		Changes the period without restarting the channel: the period
+				in progress finishes and the next one has the new length, so
+				the tick stays free of jitter. Safe to call from the callback.
+*/
+void PIT_vfnSetPeriod (PIT_CHANNEL channel, uint32_t periodUs)
+{
+	periods[channel] = periodUs;
+	PIT->CHANNEL[channel].LDVAL = PIT_dwfnLoadValue (periodUs);
+}
+
+/*!
+	\fn			void PIT_vfnStop (PIT_CHANNEL channel)
+	\param		channel		Channel to stop
+*/
+void PIT_vfnStop (PIT_CHANNEL channel)
+{
+	PIT->CHANNEL[channel].TCTRL = 0;
+	PIT->CHANNEL[channel].TFLG = PIT_TFLG_TIF_MASK;
+	periods[channel] = 0;
+}
+
+/*!
+	\fn			void PIT_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+	\param		coreClock	New core clock in Hz
+	\param		irClock		New MCGIRCLK in Hz
+	\brief		Recomputes the load values for the new bus clock. Running
+				channels are restarted so the current period is not counted
+				at the old rate.
+*/
+void PIT_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	uint8_t channel = 0;
+
+	(void)coreClock;
+	(void)irClock;
+
+	busMhz = CLOCK_GetBusClkFreq () / US_PER_SECOND;
+	if (!busMhz)
+	{
+		busMhz = 1;
+	}
+
+	for (channel = 0; channel < ePIT_CHANNELS; channel++)
+	{
+		if (periods[channel])
+		{
+			PIT->CHANNEL[channel].TCTRL = 0;
+			PIT->CHANNEL[channel].LDVAL = PIT_dwfnLoadValue (periods[channel]);
+			PIT->CHANNEL[channel].TCTRL = PIT_TCTRL_TIE_MASK | PIT_TCTRL_TEN_MASK;
+		}
+	}
+}
+
+/*!
+	\fn			void PIT_DriverIRQHandler (void)
+	\brief		Both channels share the interrupt; every expired channel has
+				its flag cleared and its callback called
+*/
+void PIT_DriverIRQHandler (void)
+{
+	uint8_t channel = 0;
+
+	STACK_ISR_ENTER (eSTACK_ISR_PIT);
+	for (channel = 0; channel < ePIT_CHANNELS; channel++)
+	{
+		if (PIT->CHANNEL[channel].TFLG & PIT_TFLG_TIF_MASK)
+		{
+			PIT->CHANNEL[channel].TFLG = PIT_TFLG_TIF_MASK;
+			if (callbacks[channel])
+			{
+				callbacks[channel] ();
+			}
+		}
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_PIT);
+}
+//------------------------------------------------------------------------------
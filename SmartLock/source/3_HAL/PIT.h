@@ -0,0 +1,59 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		PIT.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the periodic interrupt timer driver.
+				Each channel calls a callback from the PIT interrupt at a fixed
+				period, kept across clock profile switches.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_PIT_H_
+#define _3_HAL_PIT_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Enums
+	//--------------------------------------------------------------------------
+	/*!
+		\enum	PIT_CHANNEL
+		\brief	Users of the two PIT channels
+	*/
+	typedef enum
+	{
+		ePIT_SCAN = 0,		/* keypad row strobe */
+		ePIT_SYSTEM,		/* main loop pacing and millisecond count */
+		ePIT_CHANNELS
+	} PIT_CHANNEL;
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	PIT_CALLBACK
+		\brief		Called from the PIT interrupt every period of a channel
+	*/
+	typedef void (*PIT_CALLBACK)(void);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	void PIT_vfnDriverInit (void);
+
+	void PIT_vfnStart (PIT_CHANNEL channel, uint32_t periodUs, PIT_CALLBACK callback);
+
+	void PIT_vfnSetPeriod (PIT_CHANNEL channel, uint32_t periodUs);
+
+	void PIT_vfnStop (PIT_CHANNEL channel);
+
+	void PIT_vfnClockChanged (uint32_t coreClock, uint32_t irClock);
+
+	void PIT_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_PIT_H_ */
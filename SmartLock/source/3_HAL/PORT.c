@@ -0,0 +1,339 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		PORT.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the pin interrupt service.
+
+				The interrupt reads the flags of each of the four ports once
+				and clears them with one write. Each pending pin is then found
+				from its flag bit and its registered entry looked up through a
+				table indexed by port and pin, so the cost is per pending pin,
+				not per registered one. The Cortex-M0+ has no CLZ instruction:
+				the lowest pending bit is isolated and a de Bruijn multiply
+				turns it into the pin number.
+
+				A pin with a debounce time is disarmed on its first edge and
+				PORT_vfnTask reads it once the time has passed: the callback
+				only sees the settled level, and only when it is the one the
+				mode waits for. The time is counted on the system tick, so it
+				is rounded up to the next tick.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "PORT.h"
+#include "Timebase.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		PORT_PORTS
+	\brief		Ports on the shared vector, PORTB to PORTE
+*/
+#define		PORT_PORTS			4u
+
+/*!
+	\def		PORT_PINS
+	\brief		Pins of a port
+*/
+#define		PORT_PINS			32u
+
+/*!
+	\def		DE_BRUIJN
+	\brief		De Bruijn sequence B(2, 5): multiplied by a single bit, its
+				top five bits are different for every bit position
+*/
+#define		DE_BRUIJN			0x077CB531u
+
+/*!
+	\def		PIN_OF
+	\brief		Position of the single bit set in bit
+*/
+#define		PIN_OF(bit)			(pinOfProduct[((bit) * DE_BRUIJN) >> 27])
+
+/*!
+	\def		PCR_KEEP
+	\brief		PCR without its interrupt configuration and its write 1 to
+				clear flag
+*/
+#define		PCR_KEEP(pcr)		((pcr) & ~(PORT_PCR_IRQC_MASK | PORT_PCR_ISF_MASK))
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		PORT_ENTRY
+	\brief		A registered pin
+*/
+typedef struct
+{
+	PORT_CALLBACK callback;		/* 0 while the entry is free */
+	uint32_t deadline;			/* ms at which a disarmed pin is read */
+	uint16_t debounceMs;
+	uint8_t mode;
+	uint8_t level;				/* last level reported */
+} PORT_ENTRY;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		ports
+	\brief		Pin control registers of the ports on the shared vector
+*/
+static PORT_Type * const ports[PORT_PORTS] = {PORTB, PORTC, PORTD, PORTE};
+
+/*!
+	\var		gpios
+	\brief		Data registers of the same ports
+*/
+static GPIO_Type * const gpios[PORT_PORTS] = {GPIOB, GPIOC, GPIOD, GPIOE};
+
+/*!
+	\var		pinOfProduct
+	\brief		Bit position by the top five bits of its DE_BRUIJN product
+*/
+static const uint8_t pinOfProduct[PORT_PINS] = {
+		0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+		31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+};
+
+/*!
+	\var		entries
+	\brief		Registered pins
+*/
+static PORT_ENTRY entries[PORT_MAX_PINS];
+
+/*!
+	\var		slots
+	\brief		Entry of every pin, valid where registered has its bit set
+*/
+static uint8_t slots[PORT_PORTS][PORT_PINS];
+
+/*!
+	\var		registered
+	\brief		Registered pins of each port
+*/
+static volatile uint32_t registered[PORT_PORTS];
+
+/*!
+	\var		disarmed
+	\brief		Pins of each port waiting for PORT_vfnTask to arm them again
+*/
+static volatile uint32_t disarmed[PORT_PORTS];
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint8_t PORT_bfnIsLevel (uint8_t mode);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint8_t PORT_bfnIsLevel (uint8_t mode)
+	\return		Returns 1 if the mode interrupts on a level; else, returns 0
+*/
+static uint8_t PORT_bfnIsLevel (uint8_t mode)
+{
+	return (mode == ePORT_LOW) || (mode == ePORT_HIGH);
+}
+
+/*!
+	\fn			uint8_t PORT_bfnRegister (PORTS port, PINS pin, PORT_MODE mode,
+					uint16_t debounceMs, PORT_CALLBACK callback)
+	\param		port		PORTB to PORTE
+	\param		pin			Pin of the port, already muxed as an input
+	\param		mode		What interrupts
+	\param		debounceMs	Time the level must settle for, 0 to call back
+							from the interrupt
+	\param		callback	Called for the pin
+	\return		Returns 1 if the pin interrupts; else, returns 0: PORTA has a
+				vector of its own, or PORT_MAX_PINS are registered
+	\brief		Registers a pin, or changes a registered one
+*/
+uint8_t PORT_bfnRegister (PORTS port, PINS pin, PORT_MODE mode, uint16_t debounceMs,
+		PORT_CALLBACK callback)
+{
+	uint32_t bit = 1u << pin;
+	uint8_t index = (uint8_t)(port - ePORTB);
+	uint8_t slot = 0;
+
+	if ((port < ePORTB) || (port > ePORTE) || !callback)
+	{
+		return 0;
+	}
+	PORT_vfnUnregister (port, pin);
+	while ((slot < PORT_MAX_PINS) && entries[slot].callback)
+	{
+		slot++;
+	}
+	if (slot == PORT_MAX_PINS)
+	{
+		return 0;
+	}
+
+	entries[slot].callback = callback;
+	entries[slot].debounceMs = debounceMs;
+	entries[slot].mode = (uint8_t)mode;
+	entries[slot].level = (gpios[index]->PDIR & bit) ? 1u : 0u;
+	slots[index][pin] = slot;
+	ports[index]->ISFR = bit;
+	ports[index]->PCR[pin] = PCR_KEEP (ports[index]->PCR[pin]) | PORT_PCR_IRQC(mode);
+	registered[index] |= bit;
+
+	NVIC_EnableIRQ (PORTB_PORTC_PORTD_PORTE_IRQn);
+	return 1;
+}
+
+/*!
+	\fn			void PORT_vfnUnregister (PORTS port, PINS pin)
+	\param		port	PORTB to PORTE
+	\param		pin		Pin of the port
+	\brief		Stops the pin from interrupting and frees its entry. Nothing
+				is done for a pin that is not registered.
+*/
+void PORT_vfnUnregister (PORTS port, PINS pin)
+{
+	uint32_t bit = 1u << pin;
+	uint8_t index = (uint8_t)(port - ePORTB);
+	uint32_t primask;
+
+	if ((port < ePORTB) || (port > ePORTE) || !(registered[index] & bit))
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	ports[index]->PCR[pin] = PCR_KEEP (ports[index]->PCR[pin]);
+	ports[index]->ISFR = bit;
+	registered[index] &= ~bit;
+	disarmed[index] &= ~bit;
+	__set_PRIMASK (primask);
+
+	entries[slots[index][pin]].callback = 0;
+}
+
+/*!
+	\fn			void PORT_vfnTask (void)
+	\brief		Arms the disarmed pins whose time is up, run from the main
+				loop. A pin is armed before it is read, so a change right
+				after the read still interrupts. A debounced pin then calls
+				back with its settled level if the mode waits for that level:
+				high for rising and high, low for falling and low, and a
+				change from the last level reported for both edges.
+*/
+void PORT_vfnTask (void)
+{
+	PORT_ENTRY *entry;
+	uint32_t now = Timebase_dwfnGetMs ();
+	uint32_t pending;
+	uint32_t levels;
+	uint32_t bit;
+	uint32_t primask;
+	uint8_t index;
+	uint8_t pin;
+	uint8_t level;
+	uint8_t expected;
+
+	for (index = 0; index < PORT_PORTS; index++)
+	{
+		pending = disarmed[index];
+		while (pending)
+		{
+			bit = pending & (0u - pending);
+			pending ^= bit;
+			pin = PIN_OF (bit);
+			entry = &entries[slots[index][pin]];
+			if ((int32_t)(now - entry->deadline) < 0)
+			{
+				continue;
+			}
+
+			primask = __get_PRIMASK ();
+			__disable_irq ();
+			disarmed[index] &= ~bit;
+			__set_PRIMASK (primask);
+
+			ports[index]->ISFR = bit;
+			ports[index]->PCR[pin] = PCR_KEEP (ports[index]->PCR[pin]) | PORT_PCR_IRQC(entry->mode);
+			if (entry->debounceMs)
+			{
+				levels = gpios[index]->PDIR;
+				level = (levels & bit) ? 1u : 0u;
+				if (entry->mode == ePORT_BOTH)
+				{
+					expected = !entry->level;
+				}
+				else
+				{
+					expected = ((entry->mode == ePORT_RISING) || (entry->mode == ePORT_HIGH)) ? 1u : 0u;
+				}
+				if (level == expected)
+				{
+					entry->level = level;
+					entry->callback (pin, levels);
+				}
+			}
+		}
+	}
+}
+
+/*!
+	\fn			void PORTB_PORTC_PORTD_PORTE_DriverIRQHandler (void)
+	\brief		Clears the flags of every port with one write and handles its
+				pending pins lowest first. A debounced or level pin is
+				disarmed until PORT_vfnTask; the others call back right away
+				with the levels read along with the flags.
+*/
+void PORTB_PORTC_PORTD_PORTE_DriverIRQHandler (void)
+{
+	PORT_ENTRY *entry;
+	uint32_t pending;
+	uint32_t levels;
+	uint32_t bit;
+	uint8_t index;
+	uint8_t pin;
+
+	STACK_ISR_ENTER (eSTACK_ISR_PORT);
+	for (index = 0; index < PORT_PORTS; index++)
+	{
+		pending = ports[index]->ISFR;
+		if (!pending)
+		{
+			continue;
+		}
+		ports[index]->ISFR = pending;
+		levels = gpios[index]->PDIR;
+
+		/* A flag left by a pin unregistered meanwhile is only cleared */
+		pending &= registered[index];
+		while (pending)
+		{
+			bit = pending & (0u - pending);
+			pending ^= bit;
+			pin = PIN_OF (bit);
+			entry = &entries[slots[index][pin]];
+
+			if (entry->debounceMs || PORT_bfnIsLevel (entry->mode))
+			{
+				ports[index]->PCR[pin] = PCR_KEEP (ports[index]->PCR[pin]);
+				entry->deadline = Timebase_dwfnGetMs () + entry->debounceMs;
+				disarmed[index] |= bit;
+			}
+			if (!entry->debounceMs)
+			{
+				entry->level = (levels & bit) ? 1u : 0u;
+				entry->callback (pin, levels);
+			}
+		}
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_PORT);
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		PORT.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the pin interrupt service. PORTB to
+				PORTE share one interrupt vector; every pin that interrupts
+				registers a callback here and the service calls the callback
+				of each pending pin, whatever else is registered.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_PORT_H_
+#define _3_HAL_PORT_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+	#include "GPIO.h"
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def		PORT_MAX_PINS
+		\brief		Pins that can be registered at the same time
+	*/
+	#define		PORT_MAX_PINS		16u
+
+	//--------------------------------------------------------------------------
+	// Enums
+	//--------------------------------------------------------------------------
+	/*!
+		\enum	PORT_MODE
+		\brief	What interrupts, as the IRQC field of the pin's PCR. A level
+				interrupts again as long as it is held, so a level pin is
+				disarmed when it fires and armed again by PORT_vfnTask.
+	*/
+	typedef enum
+	{
+		ePORT_LOW = 8,
+		ePORT_RISING = 9,
+		ePORT_FALLING = 10,
+		ePORT_BOTH = 11,
+		ePORT_HIGH = 12
+	} PORT_MODE;
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	PORT_CALLBACK
+		\brief		Called with the pin and the levels of every pin of its
+					port, bit n for pin n: from the interrupt, with the levels
+					read along with the flags, or from PORT_vfnTask once the
+					level has settled for a pin with a debounce time. The
+					callback takes the levels from here rather than reading
+					the port again, which may have changed since.
+	*/
+	typedef void (*PORT_CALLBACK)(uint8_t pin, uint32_t levels);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	uint8_t PORT_bfnRegister (PORTS port, PINS pin, PORT_MODE mode, uint16_t debounceMs,
+			PORT_CALLBACK callback);
+
+	void PORT_vfnUnregister (PORTS port, PINS pin);
+
+	void PORT_vfnTask (void);
+
+	void PORTB_PORTC_PORTD_PORTE_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_PORT_H_ */
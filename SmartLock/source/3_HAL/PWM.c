@@ -12,6 +12,7 @@
 //------------------------------------------------------------------------------
 #include "MKL27Z644.h"
 #include "PWM.h"
+#include "ClockProfile.h"
 
 //------------------------------------------------------------------------------
 // Defines
@@ -54,10 +55,17 @@
 #define 	DBGMODE_MASK 		(3<<6)
 
 /*!
-    \def	PS_8
-    \brief	Prescaler factor option value
+    \def	TPM_TICK_HZ
+    \brief	Counter frequency the prescaler is chosen for (8 MHz MCGIRCLK / 8),
+    		so the MOD values keep their period across clock profiles
 */
-#define 	PS_8 				3
+#define 	TPM_TICK_HZ 		1000000u
+
+/*!
+    \def	PS_MAX
+    \brief	Largest prescaler factor option value (divide by 128)
+*/
+#define 	PS_MAX 				7
 
 /*!
     \def	CMOD
@@ -108,7 +116,8 @@ void PWM_vfnDriverInit()
 
 	TPM2->CONF = DBGMODE_MASK;							// Set debug mode to increment the counter
 
-	TPM2->SC |= PS_8;									// Set prescale factor to divide by 8
+	PWM_vfnClockChanged(SystemCoreClock, ClockProfile_dwfnGetIrClock());	// Set prescale factor for a 1MHz counter
+	ClockProfile_bfnRegister(PWM_vfnClockChanged);
 	TPM2->SC |= TPM_SC_CPWMS_MASK;						// Set CPWMS to up-down counter
 //	TPM2->SC |= CMOD << TPM_SC_CMOD_SHIFT;				// Set counter increment once per TPM clock
 
@@ -178,6 +187,32 @@ uint8_t PWM_bfnChangeCounter(uint16_t counter)
 	}
 }
 
+/*!
+ 	 \fn		void PWM_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+ 	 \param		coreClock	New core clock frequency in Hz (unused)
+ 	 \param		irClock		New MCGIRCLK frequency in Hz
+ 	 \brief		Picks the prescaler that keeps the counter at TPM_TICK_HZ. The
+ 	 			counter is stopped while PS is written, as the TPM requires.
+ */
+void PWM_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	uint32_t prescaler = 0;
+	uint32_t cmod = TPM2->SC & TPM_SC_CMOD_MASK;
+
+	(void)coreClock;
+	while (((irClock >> prescaler) > TPM_TICK_HZ) && (prescaler < PS_MAX))
+	{
+		prescaler++;
+	}
+
+	TPM2->SC &= ~TPM_SC_CMOD_MASK;
+	while (TPM2->SC & TPM_SC_CMOD_MASK)
+	{
+	}
+	TPM2->SC = (TPM2->SC & ~TPM_SC_PS_MASK) | TPM_SC_PS(prescaler);
+	TPM2->SC |= cmod;
+}
+
 /*!
  	 \fn		void PWM_vfnToggleSignal ()
  	 \brief		Alternates the state of the PWM signal, ON or OFF
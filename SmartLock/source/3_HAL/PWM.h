@@ -44,5 +44,7 @@
 
 	void PWM_vfnToggleSignal (void);
 
+	void PWM_vfnClockChanged (uint32_t coreClock, uint32_t irClock);
+
 //------------------------------------------------------------------------------
 #endif /* _3_HAL_PWM_H_ */
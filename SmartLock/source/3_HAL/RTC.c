@@ -0,0 +1,161 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		RTC.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the real-time clock driver. The
+				RTC runs from ERCLK32K, which is OSC0 in its low-range 32 kHz
+				mode with the FRDM-KL27Z crystal on EXTAL0/XTAL0 (PTA18/19).
+				The oscillator is started without waiting for it: the RTC
+				simply begins counting once the crystal runs, and waiting up
+				to a second here would starve the COP.
+
+				TSR only takes a write while the counter is stopped, and a
+				read can catch it incrementing, so it is read until two
+				reads agree.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "RTC.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		XTAL_PIN_EXTAL
+	\brief		PTA18, EXTAL0; the pin mux default of 0 is the analog function
+*/
+#define		XTAL_PIN_EXTAL		18u
+
+/*!
+	\def		XTAL_PIN_XTAL
+	\brief		PTA19, XTAL0
+*/
+#define		XTAL_PIN_XTAL		19u
+
+/*!
+	\def		OSC32KSEL_OSC0
+	\brief		SOPT1 selection of OSC32KCLK as ERCLK32K
+*/
+#define		OSC32KSEL_OSC0		0u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		callback
+	\brief		Function called every second, from the interrupt
+*/
+static RTC_SECONDS_CALLBACK callback = 0;
+
+/*!
+	\var		isSet
+	\brief		Set while TSR holds a time given by RTC_vfnSetTime, either
+				in this boot or before a warm reset
+*/
+static uint8_t isSet = 0;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void RTC_vfnDriverInit (void)
+	\brief		Starts the crystal and the counter. A set TIF means the RTC
+				lost its time with the power: TSR is restarted from 0 and
+				the time stays unset; otherwise the counter kept running
+				over the reset and holds the time set before it.
+*/
+void RTC_vfnDriverInit (void)
+{
+	SIM->SCGC5 |= SIM_SCGC5_PORTA_MASK;
+	PORTA->PCR[XTAL_PIN_EXTAL] &= ~PORT_PCR_MUX_MASK;
+	PORTA->PCR[XTAL_PIN_XTAL] &= ~PORT_PCR_MUX_MASK;
+
+	/* Low range, low power crystal mode; keep OSCERCLK on in VLPS */
+	OSC0->CR = OSC_CR_ERCLKEN_MASK | OSC_CR_EREFSTEN_MASK;
+	MCG->C2 = (uint8_t)((MCG->C2 & ~(MCG_C2_RANGE0_MASK | MCG_C2_HGO0_MASK)) | MCG_C2_EREFS0_MASK);
+	SIM->SOPT1 = (SIM->SOPT1 & ~SIM_SOPT1_OSC32KSEL_MASK) | SIM_SOPT1_OSC32KSEL (OSC32KSEL_OSC0);
+
+	SIM->SCGC6 |= SIM_SCGC6_RTC_MASK;
+	if (RTC->SR & (RTC_SR_TIF_MASK | RTC_SR_TOF_MASK))
+	{
+		RTC->SR = 0;
+		RTC->TPR = 0;
+		RTC->TSR = 0;
+		isSet = 0;
+	}
+	else
+	{
+		isSet = 1;
+	}
+	RTC->IER = RTC_IER_TSIE_MASK;
+	RTC->SR = RTC_SR_TCE_MASK;
+	NVIC_EnableIRQ (RTC_Seconds_IRQn);
+}
+
+/*!
+	\fn			void RTC_vfnSetTime (uint32_t seconds)
+	\param		seconds		New time in seconds
+	\brief		Sets the time and starts a fresh second
+*/
+void RTC_vfnSetTime (uint32_t seconds)
+{
+	RTC->SR = 0;
+	RTC->TPR = 0;
+	RTC->TSR = seconds;
+	RTC->SR = RTC_SR_TCE_MASK;
+	isSet = 1;
+}
+
+/*!
+	\fn			uint32_t RTC_dwfnGetTime (void)
+	\return		Returns the time in seconds
+*/
+uint32_t RTC_dwfnGetTime (void)
+{
+	uint32_t seconds = 0;
+
+	do
+	{
+		seconds = RTC->TSR;
+	} while (seconds != RTC->TSR);
+
+	return seconds;
+}
+
+/*!
+	\fn			uint8_t RTC_bfnIsSet (void)
+	\return		Returns 1 if the time was set since the last power-on; else,
+				returns 0 and the time counts from the power-on
+*/
+uint8_t RTC_bfnIsSet (void)
+{
+	return isSet;
+}
+
+/*!
+	\fn			void RTC_vfnCallbackReg (RTC_SECONDS_CALLBACK newCallback)
+	\param		newCallback		Function to call every second
+*/
+void RTC_vfnCallbackReg (RTC_SECONDS_CALLBACK newCallback)
+{
+	callback = newCallback;
+}
+
+/*!
+	\fn			void RTC_Seconds_DriverIRQHandler (void)
+	\brief		Seconds interrupt; it has no flag to clear
+*/
+void RTC_Seconds_DriverIRQHandler (void)
+{
+	STACK_ISR_ENTER (eSTACK_ISR_RTC);
+	if (callback)
+	{
+		callback (RTC_dwfnGetTime ());
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_RTC);
+}
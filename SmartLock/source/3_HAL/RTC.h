@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		RTC.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the real-time clock driver. The RTC
+				counts seconds from the 32.768 kHz crystal and keeps counting
+				over a warm reset; after a power-on it holds no time until
+				one is set.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_RTC_H_
+#define _3_HAL_RTC_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	RTC_SECONDS_CALLBACK
+		\brief		Called from the seconds interrupt with the new time
+	*/
+	typedef void (*RTC_SECONDS_CALLBACK)(uint32_t seconds);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	void RTC_vfnDriverInit (void);
+
+	void RTC_vfnSetTime (uint32_t seconds);
+
+	uint32_t RTC_dwfnGetTime (void);
+
+	uint8_t RTC_bfnIsSet (void);
+
+	void RTC_vfnCallbackReg (RTC_SECONDS_CALLBACK callback);
+
+	void RTC_Seconds_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_RTC_H_ */
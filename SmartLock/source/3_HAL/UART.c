@@ -12,6 +12,9 @@
 //------------------------------------------------------------------------------
 #include "MKL27Z644.h"
 #include "UART.h"
+#include "ClockProfile.h"
+#include "Stack.h"
+#include "RamFunc.h"
 #ifdef DEBUG_MODE_ENABLE
 #include <stdio.h>
 #endif
@@ -51,10 +54,10 @@
 #define DATA_READ_MASK		0xFF
 
 /*!
-	\def	SBR
-	\brief	Set the value of SBR to 52
+	\def	BAUDRATE
+	\brief	Baud rate of the bluetooth module
  */
-#define SBR					0x34
+#define BAUDRATE			9600u
 
 /*!
  	 \def	SBR_MASK
@@ -81,16 +84,107 @@
  	 \brief	If defined, activate interruptions of the UART driver
  */
 
+/*!
+ 	 \def	STAT_W1C_MASK
+ 	 \brief	Flags of LPUART0->STAT cleared by writing a one
+ */
+#define STAT_W1C_MASK		(LPUART_STAT_LBKDIF_MASK | LPUART_STAT_RXEDGIF_MASK \
+							| LPUART_STAT_IDLE_MASK | LPUART_STAT_OR_MASK \
+							| LPUART_STAT_NF_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_PF_MASK)
+
+/*!
+ 	 \def	RX_RING_MASK
+ 	 \brief	Wraps an index of the receive ring
+ */
+#define RX_RING_MASK		(UART_RX_RING - 1u)
+
+#ifdef UART_DMA_RX_ENABLE
+/*!
+ 	 \def	UART_DMA_CHANNEL
+ 	 \brief	DMA channel of the receiver; channel 0 belongs to the CRC driver
+ */
+#define UART_DMA_CHANNEL	1
+
+/*!
+ 	 \def	DMAMUX_LPUART0_RX
+ 	 \brief	DMAMUX source of the LPUART0 receiver
+ */
+#define DMAMUX_LPUART0_RX	2
+
+/*!
+ 	 \def	DMA_SIZE_8BIT
+ 	 \brief	SSIZE / DSIZE encoding of byte transfers
+ */
+#define DMA_SIZE_8BIT		1
+
+/*!
+ 	 \def	UART_RX_DMOD
+ 	 \brief	Destination address modulo that wraps UART_RX_RING bytes
+ */
+#define UART_RX_DMOD		4
+
+#if (UART_RX_RING != (8u << UART_RX_DMOD))
+#error "UART_RX_DMOD does not match UART_RX_RING"
+#endif
+#endif
+
 //------------------------------------------------------------------------------
 // Variables
 //------------------------------------------------------------------------------
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
 /*!
-    \var
-    \brief
+    \var	fnPtr
+    \brief	Receive callback
+*/
+UART_RX_CALLBACK fnPtr = NULL;
+
+/*!
+    \var	rxRing
+    \brief	Receive ring. The DMA wraps its destination on a multiple of the
+    		ring size, so the ring is aligned to it.
+*/
+static uint8_t rxRing[UART_RX_RING] __attribute__ ((aligned (UART_RX_RING)));
+
+/*!
+    \var	rxTail
+    \brief	Next byte of the ring to be taken by UART_wfnReceive
+*/
+static uint16_t rxTail = 0;
+
+#ifndef UART_DMA_RX_ENABLE
+/*!
+    \var	rxHead
+    \brief	Next byte of the ring to be written by the interrupt
+*/
+static volatile uint16_t rxHead = 0;
+#endif
+
+/*!
+    \var	rxEvents
+    \brief	Receive interrupts that called the callback, per reason
+*/
+static uint32_t rxEvents[eUART_RX_EVENTS] = {0};
+
+/*!
+    \var	rxBytes
+    \brief	Bytes taken from the ring
+*/
+static uint32_t rxBytes = 0;
+
+/*!
+    \var	rxDropped
+    \brief	Bytes lost: overrun by the receiver, or by the DMA before they
+    		were taken from the ring
 */
-void (*fnPtr)(void) = NULL;
+static uint32_t rxDropped = 0;
 
+#ifdef UART_DMA_RX_ENABLE
+/*!
+    \var	rxWritten
+    \brief	Bytes the DMA wrote to the ring, counted per half ring
+*/
+static uint32_t rxWritten = 0;
+#endif
 #endif
 //------------------------------------------------------------------------------
 // Functions
@@ -109,13 +203,10 @@ void UART_vfnDriverInit(void)
 	// Activate LPUART0 in SIM->SCGC5
 	SIM->SCGC5 |= SIM_SCGC5_LPUART0(1);
 
-	// Enable the 8MHz clock and set the required LIRC configurations in order to function properly
-	MCG->C1 |= MCG_C1_CLKS(1);
-	MCG->C1 |= MCG_C1_IRCLKEN(1);
-	MCG->C2 |= MCG_C2_IRCS(1);
-
-	// Set the value of SBR[12:0] to 52
-	LPUART0->BAUD = (LPUART0->BAUD & (~SBR_MASK)) | SBR;
+	// MCGIRCLK is kept enabled by the clock profile manager; compute SBR[12:0]
+	// for the current profile and recompute it after every switch
+	UART_vfnClockChanged(SystemCoreClock, ClockProfile_dwfnGetIrClock());
+	ClockProfile_bfnRegister(UART_vfnClockChanged);
 
 	// Set the Receiver enable bit
 	LPUART0->CTRL |= LPUART_CTRL_RE(1);
@@ -140,19 +231,63 @@ void UART_vfnDriverInit(void)
 	PORTE->PCR[20] |= PORT_PCR_MUX(PORT_ALT4);
 	PORTE->PCR[21] |= PORT_PCR_MUX(PORT_ALT4);
 
-#ifdef BLUETOOTH_INTERRUPT_ENABLE
+#ifdef UART_DMA_RX_ENABLE
+	// Stream the receiver into the ring: one byte per request, the
+	// destination wrapping around the ring, an interrupt every half ring
+	SIM->SCGC6 |= SIM_SCGC6_DMAMUX_MASK;
+	SIM->SCGC7 |= SIM_SCGC7_DMA_MASK;
+	DMAMUX0->CHCFG[UART_DMA_CHANNEL] = 0;
+	DMA0->DMA[UART_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	DMA0->DMA[UART_DMA_CHANNEL].SAR = (uint32_t)&LPUART0->DATA;
+	DMA0->DMA[UART_DMA_CHANNEL].DAR = (uint32_t)rxRing;
+	DMA0->DMA[UART_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(UART_RX_RING / 2u);
+	DMA0->DMA[UART_DMA_CHANNEL].DCR = DMA_DCR_EINT_MASK | DMA_DCR_ERQ_MASK
+			| DMA_DCR_CS_MASK | DMA_DCR_DINC_MASK
+			| DMA_DCR_SSIZE(DMA_SIZE_8BIT) | DMA_DCR_DSIZE(DMA_SIZE_8BIT)
+			| DMA_DCR_DMOD(UART_RX_DMOD);
+	DMAMUX0->CHCFG[UART_DMA_CHANNEL] = DMAMUX_CHCFG_ENBL_MASK
+			| DMAMUX_CHCFG_SOURCE(DMAMUX_LPUART0_RX);
+
+	// The receiver requests DMA instead of interrupting; the idle line
+	// (one idle character after the stop bit) ends a burst
+	LPUART0->BAUD |= LPUART_BAUD_RDMAE_MASK;
+	LPUART0->CTRL |= LPUART_CTRL_ILT_MASK | LPUART_CTRL_ILIE_MASK;
+	NVIC_EnableIRQ(DMA1_IRQn);
+	NVIC->ISER[0] |= (1<<LPUART0_IRQn);
+#elif defined(BLUETOOTH_INTERRUPT_ENABLE)
 	LPUART0->CTRL |= LPUART_CTRL_RIE(1);
 	NVIC->ISER[0] |= (1<<LPUART0_IRQn);
 #endif
 }
 
+/*!
+    \fn				void UART_vfnClockChanged(uint32_t coreClock, uint32_t irClock)
+    \param			coreClock	New core clock frequency in Hz (unused)
+    \param			irClock		New MCGIRCLK frequency in Hz
+    \brief			Recomputes SBR[12:0] so the baud rate stays at BAUDRATE with
+    				the oversampling ratio currently set in LPUART0->BAUD
+*/
+void UART_vfnClockChanged(uint32_t coreClock, uint32_t irClock)
+{
+	uint32_t osr = ((LPUART0->BAUD & LPUART_BAUD_OSR_MASK) >> LPUART_BAUD_OSR_SHIFT) + 1;
+	uint32_t sbr = (irClock + ((BAUDRATE * osr) >> 1)) / (BAUDRATE * osr);
+
+	(void)coreClock;
+	if (!sbr)
+	{
+		sbr = 1;
+	}
+	LPUART0->BAUD = (LPUART0->BAUD & (~SBR_MASK)) | (sbr & SBR_MASK);
+}
+
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
 /*!
-    \fn				void UART_vfnCallbackReg(void (*ptr)(void))
-    \param			ptr	Pointer to a function to be executed when an interrupt is raised
+    \fn				void UART_vfnCallbackReg(UART_RX_CALLBACK ptr)
+    \param			ptr	Pointer to a function to be executed when received
+    				bytes are waiting in the ring
     \brief			Register function for the callback static pointer
 */
-void UART_vfnCallbackReg(void (*ptr)(void))
+void UART_vfnCallbackReg(UART_RX_CALLBACK ptr)
 {
 	if (ptr != NULL)
 	{
@@ -161,17 +296,154 @@ void UART_vfnCallbackReg(void (*ptr)(void))
 }
 
 /*!
-    \fn				void LPUART0_DriverIRQHandler()
-    \brief			Handler function for the bluetooth interruption
+    \fn				static void UART_vfnNotify(UART_RX_EVENT event)
+    \param			event	Reason of the call
+    \brief			Counts the event and calls the receive callback
 */
-void LPUART0_DriverIRQHandler()
+static void UART_vfnNotify(UART_RX_EVENT event)
 {
+	rxEvents[event]++;
 	if (fnPtr != NULL)
 	{
-		fnPtr();
+		fnPtr(event);
+	}
+}
+
+/*!
+    \fn				uint16_t UART_wfnReceive(uint8_t *data, uint16_t size)
+    \param			data	Buffer for the received bytes
+    \param			size	Size of the buffer
+    \return			Returns the number of bytes copied
+    \brief			Takes the received bytes from the ring, oldest first. In DMA
+    				mode the write position is the destination address of the
+    				channel. Meant to be called from the receive callback.
+*/
+uint16_t UART_wfnReceive(uint8_t *data, uint16_t size)
+{
+	uint16_t head;
+	uint16_t count = 0;
+
+#ifdef UART_DMA_RX_ENABLE
+	head = (uint16_t)(DMA0->DMA[UART_DMA_CHANNEL].DAR - (uint32_t)rxRing) & RX_RING_MASK;
+#else
+	head = rxHead;
+#endif
+	while ((rxTail != head) && (count < size))
+	{
+		data[count++] = rxRing[rxTail];
+		rxTail = (rxTail + 1u) & RX_RING_MASK;
+	}
+	rxBytes += count;
+	return count;
+}
+
+/*!
+    \fn				uint32_t UART_dwfnGetRxEvents(UART_RX_EVENT event)
+    \return			Returns how many receive interrupts had the given reason
+*/
+uint32_t UART_dwfnGetRxEvents(UART_RX_EVENT event)
+{
+	return rxEvents[event];
+}
+
+/*!
+    \fn				uint32_t UART_dwfnGetRxBytes(void)
+    \return			Returns how many bytes were taken from the receive ring
+*/
+uint32_t UART_dwfnGetRxBytes(void)
+{
+	return rxBytes;
+}
+
+/*!
+    \fn				uint32_t UART_dwfnGetRxDropped(void)
+    \return			Returns how many received bytes were lost
+*/
+uint32_t UART_dwfnGetRxDropped(void)
+{
+	return rxDropped;
+}
+
+/*!
+    \fn				void LPUART0_DriverIRQHandler()
+    \brief			Handler function for the bluetooth interruption. In DMA mode
+    				only the idle line and the receive errors interrupt; else,
+    				every byte is moved to the ring here.
+*/
+RAMFUNC_HOT void LPUART0_DriverIRQHandler()
+{
+	uint32_t status = LPUART0->STAT;
+
+	STACK_ISR_ENTER(eSTACK_ISR_UART);
+	if (status & LPUART_STAT_OR_MASK)
+	{
+		rxDropped++;
+	}
+	if (status & (LPUART_STAT_OR_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_NF_MASK))
+	{
+		LPUART0->STAT = (status & ~STAT_W1C_MASK)
+				| (status & (LPUART_STAT_OR_MASK | LPUART_STAT_FE_MASK | LPUART_STAT_NF_MASK));
+	}
+
+#ifdef UART_DMA_RX_ENABLE
+	if (status & LPUART_STAT_IDLE_MASK)
+	{
+		LPUART0->STAT = (status & ~STAT_W1C_MASK) | LPUART_STAT_IDLE_MASK;
+		UART_vfnNotify(eUART_RX_IDLE);
+	}
+#else
+	if (status & LPUART_STAT_RDRF_MASK)
+	{
+		rxRing[rxHead] = (uint8_t)(LPUART0->DATA & DATA_READ_MASK);
+		rxHead = (rxHead + 1u) & RX_RING_MASK;
+		UART_vfnNotify(eUART_RX_BYTE);
 	}
+#endif
+	STACK_ISR_EXIT(eSTACK_ISR_UART);
+}
+
+#ifdef UART_DMA_RX_ENABLE
+/*!
+    \fn				void DMA1_DriverIRQHandler(void)
+    \brief			Half of the ring was written. The byte count is reloaded for
+    				the next half; the destination already wrapped by itself.
+    				After a bus error the channel restarts at the ring start.
+    				If the bytes not taken yet fill the ring, the DMA caught up
+    				with the reader and the ring no longer tells them apart
+    				from an empty one: they are counted as dropped and skipped.
+*/
+void DMA1_DriverIRQHandler(void)
+{
+	uint32_t status = DMA0->DMA[UART_DMA_CHANNEL].DSR_BCR;
+	uint32_t head;
+	uint32_t unread;
+
+	STACK_ISR_ENTER(eSTACK_ISR_UART_DMA);
+	DMA0->DMA[UART_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_DONE_MASK;
+	if (status & (DMA_DSR_BCR_CE_MASK | DMA_DSR_BCR_BES_MASK | DMA_DSR_BCR_BED_MASK))
+	{
+		DMA0->DMA[UART_DMA_CHANNEL].DAR = (uint32_t)rxRing;
+		rxTail = 0;
+		rxWritten = rxBytes + rxDropped;
+	}
+	else
+	{
+		rxWritten += UART_RX_RING / 2u;
+	}
+	DMA0->DMA[UART_DMA_CHANNEL].DSR_BCR = DMA_DSR_BCR_BCR(UART_RX_RING / 2u);
+
+	head = (DMA0->DMA[UART_DMA_CHANNEL].DAR - (uint32_t)rxRing) & RX_RING_MASK;
+	unread = rxWritten - rxBytes - rxDropped;
+	if ((int32_t)unread >= (int32_t)UART_RX_RING)
+	{
+		rxDropped += unread;
+		rxTail = (uint16_t)head;
+	}
+	UART_vfnNotify(head ? eUART_RX_HALF : eUART_RX_FULL);
+	STACK_ISR_EXIT(eSTACK_ISR_UART_DMA);
 }
 #endif
+#endif
 
 /*!
     \fn			uint8_t UART_bfnRead(uint8_t *readVal)
@@ -216,7 +488,7 @@ uint8_t UART_bfnSend(uint8_t *sendVal)
 {
 	if((LPUART0->STAT & TDRE_MASK) && !(LPUART0->STAT & RAF_MASK))
 	{
-		LPUART0->DATA |= (uint32_t)*sendVal;
+		LPUART0->DATA = (uint32_t)*sendVal;
 		return 1;
 	}
 	else
@@ -225,4 +497,36 @@ uint8_t UART_bfnSend(uint8_t *sendVal)
 	}
 }
 
+/*!
+    \fn			void UART_vfnLoopback(uint8_t enable)
+    \param		enable	1 to connect the transmitter to the receiver internally, 0 to go back to the pins
+    \brief		Internal loopback for the benchmark build. While it is enabled
+    				the receive interrupt and DMA requests are masked, so looped
+    				bytes are read by polling UART_bfnRead instead of reaching
+    				the registered callback
+*/
+void UART_vfnLoopback(uint8_t enable)
+{
+	if (enable)
+	{
+#ifdef UART_DMA_RX_ENABLE
+		LPUART0->BAUD &= ~LPUART_BAUD_RDMAE_MASK;
+		LPUART0->CTRL &= ~LPUART_CTRL_ILIE_MASK;
+#elif defined(BLUETOOTH_INTERRUPT_ENABLE)
+		LPUART0->CTRL &= ~LPUART_CTRL_RIE_MASK;
+#endif
+		LPUART0->CTRL = (LPUART0->CTRL & ~LPUART_CTRL_RSRC_MASK) | LPUART_CTRL_LOOPS(1);
+	}
+	else
+	{
+		LPUART0->CTRL &= ~LPUART_CTRL_LOOPS_MASK;
+#ifdef UART_DMA_RX_ENABLE
+		LPUART0->BAUD |= LPUART_BAUD_RDMAE_MASK;
+		LPUART0->CTRL |= LPUART_CTRL_ILIE_MASK;
+#elif defined(BLUETOOTH_INTERRUPT_ENABLE)
+		LPUART0->CTRL |= LPUART_CTRL_RIE(1);
+#endif
+	}
+}
+
 //------------------------------------------------------------------------------
@@ -11,6 +11,12 @@
 #ifndef	__UART_H__
 #define	__UART_H__
 
+    //--------------------------------------------------------------------------
+    // Includes
+    //--------------------------------------------------------------------------
+	#include <stdint.h>
+	#include "RamFunc.h"
+
     //--------------------------------------------------------------------------
     // Defines
     //--------------------------------------------------------------------------
@@ -28,20 +34,78 @@
 	#define DEBUG_MODE_ENABLE
 //	#undef	DEBUG_MODE_ENABLE
 
+	/*!
+		\def	UART_DMA_RX_ENABLE
+		\brief	If defined, DMA channel 1 streams the received bytes into the
+				receive ring and the driver only interrupts on half and full
+				ring and on an idle line; else, every byte interrupts
+	*/
+	#define UART_DMA_RX_ENABLE
+//	#undef	UART_DMA_RX_ENABLE
+
+	/*!
+		\def	UART_RX_RING
+		\brief	Size of the receive ring in bytes, a power of two up to 256 so
+				the DMA can wrap it with its destination address modulo
+	*/
+	#define UART_RX_RING		128u
+
+    //--------------------------------------------------------------------------
+    // Enums
+    //--------------------------------------------------------------------------
+	/*!
+		\enum	UART_RX_EVENT
+		\brief	Reasons the receive callback is called
+	*/
+	typedef enum
+	{
+		eUART_RX_BYTE,		/* one byte, interrupt per byte reception */
+		eUART_RX_HALF,		/* first half of the ring written by the DMA */
+		eUART_RX_FULL,		/* second half of the ring written by the DMA */
+		eUART_RX_IDLE,		/* the line went idle after the last byte */
+		eUART_RX_EVENTS
+	} UART_RX_EVENT;
+
+    //--------------------------------------------------------------------------
+    // Types
+    //--------------------------------------------------------------------------
+	/*!
+		\typedef	UART_RX_CALLBACK
+		\brief		Called from the interrupt when received bytes are waiting in
+					the ring; they are taken with UART_wfnReceive
+	*/
+	typedef void (*UART_RX_CALLBACK)(UART_RX_EVENT event);
+
     //--------------------------------------------------------------------------
     // Functions
     //--------------------------------------------------------------------------
 	void UART_vfnDriverInit(void);
 
+	void UART_vfnClockChanged(uint32_t coreClock, uint32_t irClock);
+
 #ifdef BLUETOOTH_INTERRUPT_ENABLE
-	void UART_vfnCallbackReg(void (*ptr)(void));
+	void UART_vfnCallbackReg(UART_RX_CALLBACK ptr);
+
+	uint16_t UART_wfnReceive(uint8_t *data, uint16_t size);
 
-	void LPUART0_DriverIRQHandler();
+	uint32_t UART_dwfnGetRxEvents(UART_RX_EVENT event);
+
+	uint32_t UART_dwfnGetRxBytes(void);
+
+	uint32_t UART_dwfnGetRxDropped(void);
+
+	RAMFUNC_HOT void LPUART0_DriverIRQHandler();
+
+#ifdef UART_DMA_RX_ENABLE
+	void DMA1_DriverIRQHandler(void);
+#endif
 #endif
 
 	uint8_t UART_bfnRead(uint8_t *readVal);
 
 	uint8_t UART_bfnSend(uint8_t *sendVal);
 
+	void UART_vfnLoopback(uint8_t enable);
+
 //------------------------------------------------------------------------------
 #endif
@@ -0,0 +1,1386 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		USB.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the USB full-speed CDC device.
+				Runs on IRC48M with clock recovery, so no crystal is needed.
+				Endpoint 0 answers the standard and CDC-ACM control requests,
+				endpoint 1 carries the data in both directions and endpoint 2
+				is the notification endpoint, which stays silent. Every
+				endpoint uses both the even and the odd buffer descriptor:
+				while the SIE fills or drains one, the interrupt handles the
+				other.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "MKL27Z644.h"
+#include "ClockProfile.h"
+#include "USB.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		USB_ENDPOINTS
+	\brief		Endpoints used: control, data and notification
+*/
+#define		USB_ENDPOINTS		3
+
+/*!
+	\def		EP_CONTROL
+	\brief		Control endpoint
+*/
+#define		EP_CONTROL			0
+
+/*!
+	\def		EP_DATA
+	\brief		Bulk endpoint of the data interface, OUT and IN
+*/
+#define		EP_DATA				1
+
+/*!
+	\def		EP_NOTIFY
+	\brief		Interrupt IN endpoint of the communication interface
+*/
+#define		EP_NOTIFY			2
+
+/*!
+	\def		BDT_ALIGN
+	\brief		The SIE only takes address bits 31:9 of the BDT
+*/
+#define		BDT_ALIGN			512
+
+/*!
+	\def		BD_INDEX
+	\brief		Buffer descriptor of an endpoint, direction (1 for IN) and
+				buffer (1 for odd), in the order the SIE expects them
+*/
+#define		BD_INDEX(ep, tx, odd)	(((ep) << 2) | ((tx) << 1) | (odd))
+
+/*!
+	\def		BD_OWN
+	\brief		Buffer descriptor handed to the SIE
+*/
+#define		BD_OWN				(1u << 7)
+
+/*!
+	\def		BD_DATA1
+	\brief		DATA1 packet; else, DATA0
+*/
+#define		BD_DATA1			(1u << 6)
+
+/*!
+	\def		BD_DTS
+	\brief		The SIE checks the data toggle of received packets
+*/
+#define		BD_DTS				(1u << 3)
+
+/*!
+	\def		BD_BC
+	\brief		Byte count field of a buffer descriptor
+*/
+#define		BD_BC(x)			((uint32_t)(x) << 16)
+
+/*!
+	\def		BD_GET_BC
+	\brief		Bytes moved by a completed buffer descriptor
+*/
+#define		BD_GET_BC(x)		(((x) >> 16) & 0x3FFu)
+
+/*!
+	\def		BD_GET_PID
+	\brief		Token of a completed buffer descriptor
+*/
+#define		BD_GET_PID(x)		(((x) >> 2) & 0xFu)
+
+/*!
+	\def		PID_SETUP
+	\brief		Token PID of a SETUP transaction
+*/
+#define		PID_SETUP			0xD
+
+/*!
+	\def		REQUEST_TYPE
+	\brief		Type bits of bmRequestType: 0 standard, 1 class
+*/
+#define		REQUEST_TYPE(x)		(((x) >> 5) & 3u)
+
+/*!
+	\def		REQUEST_RECIPIENT
+	\brief		Recipient bits of bmRequestType: 0 device, 1 interface,
+				2 endpoint
+*/
+#define		REQUEST_RECIPIENT(x)	((x) & 0x1Fu)
+
+/*!
+	\def		SETUP_SIZE
+	\brief		Bytes of a SETUP packet
+*/
+#define		SETUP_SIZE			8
+
+/*!
+	\def		LINE_CODING_SIZE
+	\brief		Bytes of the CDC line coding structure
+*/
+#define		LINE_CODING_SIZE	7
+
+/*!
+	\def		CONTROL_LINE_DTR
+	\brief		SET_CONTROL_LINE_STATE bit set while a host program has the
+				port open
+*/
+#define		CONTROL_LINE_DTR	1u
+
+/*!
+	\def		USB_VID
+	\brief		Vendor ID, the NXP ID used by the SDK CDC examples
+*/
+#define		USB_VID				0x1FC9u
+
+/*!
+	\def		USB_PID
+	\brief		Product ID of the SDK virtual COM example, which every NXP
+				host driver already knows
+*/
+#define		USB_PID				0x0094u
+
+/*!
+	\def		USB_MAX_STRING
+	\brief		Longest string descriptor in characters, so it fits one packet
+*/
+#define		USB_MAX_STRING		31
+
+/*!
+	\def		USB_RESET_TIMEOUT
+	\brief		Polls waiting for the module reset to finish
+*/
+#define		USB_RESET_TIMEOUT	1000
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		USB_REQUEST
+	\brief		bRequest codes answered on endpoint 0
+*/
+typedef enum
+{
+	eREQ_GET_STATUS = 0x00,
+	eREQ_CLEAR_FEATURE = 0x01,
+	eREQ_SET_FEATURE = 0x03,
+	eREQ_SET_ADDRESS = 0x05,
+	eREQ_GET_DESCRIPTOR = 0x06,
+	eREQ_GET_CONFIGURATION = 0x08,
+	eREQ_SET_CONFIGURATION = 0x09,
+	eREQ_GET_INTERFACE = 0x0A,
+	eREQ_SET_INTERFACE = 0x0B,
+	eREQ_SET_LINE_CODING = 0x20,
+	eREQ_GET_LINE_CODING = 0x21,
+	eREQ_SET_CONTROL_LINE_STATE = 0x22,
+	eREQ_SEND_BREAK = 0x23
+} USB_REQUEST;
+
+/*!
+	\enum		USB_DESCRIPTOR_TYPE
+	\brief		Descriptor types of GET_DESCRIPTOR
+*/
+typedef enum
+{
+	eDESC_DEVICE = 1,
+	eDESC_CONFIGURATION = 2,
+	eDESC_STRING = 3
+} USB_DESCRIPTOR_TYPE;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		USB_BD
+	\brief		Buffer descriptor shared with the SIE
+*/
+typedef struct
+{
+	volatile uint32_t control;
+	volatile uint32_t address;
+} USB_BD;
+
+/*!
+	\struct		USB_SETUP
+	\brief		Decoded SETUP packet
+*/
+typedef struct
+{
+	uint8_t requestType;
+	uint8_t request;
+	uint16_t value;
+	uint16_t index;
+	uint16_t length;
+} USB_SETUP;
+
+//------------------------------------------------------------------------------
+// Descriptors
+//------------------------------------------------------------------------------
+/*!
+	\var		deviceDescriptor
+	\brief		Device descriptor, CDC class at the device level
+*/
+static const uint8_t deviceDescriptor[] =
+{
+	18, eDESC_DEVICE, 0x00, 0x02, 0x02, 0x00, 0x00, USB_PACKET,
+	(uint8_t)USB_VID, (uint8_t)(USB_VID >> 8),
+	(uint8_t)USB_PID, (uint8_t)(USB_PID >> 8),
+	0x00, 0x01, 1, 2, 0, 1
+};
+
+/*!
+	\var		configurationDescriptor
+	\brief		Configuration with the CDC-ACM communication interface and its
+				data interface
+*/
+static const uint8_t configurationDescriptor[] =
+{
+	/* Configuration: 67 bytes, 2 interfaces, self powered, 100 mA */
+	9, eDESC_CONFIGURATION, 67, 0, 2, 1, 0, 0xC0, 50,
+	/* Interface 0: communication, abstract control model */
+	9, 4, 0, 0, 1, 0x02, 0x02, 0x01, 0,
+	/* Header, CDC 1.10 */
+	5, 0x24, 0x00, 0x10, 0x01,
+	/* Call management, data on interface 1 */
+	5, 0x24, 0x01, 0x00, 1,
+	/* Abstract control model: line coding and control line state */
+	4, 0x24, 0x02, 0x02,
+	/* Union: interface 0 controls interface 1 */
+	5, 0x24, 0x06, 0, 1,
+	/* Endpoint 2 IN, interrupt, 8 bytes every 16 ms */
+	7, 5, 0x80 | EP_NOTIFY, 0x03, 8, 0, 16,
+	/* Interface 1: data */
+	9, 4, 1, 0, 2, 0x0A, 0x00, 0x00, 0,
+	/* Endpoint 1 OUT, bulk */
+	7, 5, EP_DATA, 0x02, USB_PACKET, 0, 0,
+	/* Endpoint 1 IN, bulk */
+	7, 5, 0x80 | EP_DATA, 0x02, USB_PACKET, 0, 0
+};
+
+/*!
+	\var		languageDescriptor
+	\brief		String descriptor 0, English (United States)
+*/
+static const uint8_t languageDescriptor[] = {4, eDESC_STRING, 0x09, 0x04};
+
+/*!
+	\var		strings
+	\brief		String descriptors 1 and up, sent as UTF-16
+*/
+static const char * const strings[] =
+{
+	"SmartLock",
+	"SmartLock Service Port"
+};
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		bdt
+	\brief		Buffer descriptor table; only the used endpoints are reserved,
+				the SIE never reads the entries of disabled ones
+*/
+static USB_BD bdt[USB_ENDPOINTS * 4] __attribute__((aligned(BDT_ALIGN)));
+
+/*!
+	\var		outBuffers
+	\brief		Even and odd OUT buffers of the control and data endpoints
+*/
+static uint8_t outBuffers[2][2][USB_PACKET];
+
+/*!
+	\var		inBuffers
+	\brief		Even and odd IN buffers of the control and data endpoints
+*/
+static uint8_t inBuffers[2][2][USB_PACKET];
+
+/*!
+	\var		inOdd
+	\brief		IN buffer the SIE sends next, per endpoint
+*/
+static uint8_t inOdd[USB_ENDPOINTS];
+
+/*!
+	\var		inData1
+	\brief		Data toggle of the next IN packet, per endpoint
+*/
+static uint8_t inData1[USB_ENDPOINTS];
+
+/*!
+	\var		inArmed
+	\brief		IN buffers handed to the SIE, per endpoint
+*/
+static uint8_t inArmed[USB_ENDPOINTS];
+
+/*!
+	\var		rxOdd
+	\brief		Data OUT buffer the SIE fills next
+*/
+static uint8_t rxOdd = 0;
+
+/*!
+	\var		rxData1
+	\brief		Data toggle each data OUT buffer expects. Packets alternate
+				between the buffers, so a buffer always expects the same one.
+*/
+static uint8_t rxData1[2];
+
+/*!
+	\var		rxArmed
+	\brief		Data OUT buffers handed to the SIE, bit per buffer
+*/
+static uint8_t rxArmed = 0;
+
+/*!
+	\var		rxRing
+	\brief		Received bytes waiting for USB_wfnReceive
+*/
+static uint8_t rxRing[USB_RX_RING];
+
+/*!
+	\var		rxHead
+	\brief		Next byte written into rxRing, by the interrupt
+*/
+static volatile uint16_t rxHead = 0;
+
+/*!
+	\var		rxTail
+	\brief		Next byte read from rxRing, by USB_wfnReceive
+*/
+static volatile uint16_t rxTail = 0;
+
+/*!
+	\var		txRing
+	\brief		Bytes queued by USB_wfnSend
+*/
+static uint8_t txRing[USB_TX_RING];
+
+/*!
+	\var		txHead
+	\brief		Next byte written into txRing, by USB_wfnSend
+*/
+static volatile uint16_t txHead = 0;
+
+/*!
+	\var		txTail
+	\brief		Next byte moved from txRing into an IN buffer
+*/
+static volatile uint16_t txTail = 0;
+
+/*!
+	\var		txLastFull
+	\brief		The last IN packet was full, so a transfer that ends there
+				needs a zero length packet to complete on the host
+*/
+static uint8_t txLastFull = 0;
+
+/*!
+	\var		setup
+	\brief		SETUP packet being answered
+*/
+static USB_SETUP setup;
+
+/*!
+	\var		controlData
+	\brief		Rest of the control IN data stage
+*/
+static const uint8_t *controlData = 0;
+
+/*!
+	\var		controlRemaining
+	\brief		Bytes left in the control IN data stage
+*/
+static uint16_t controlRemaining = 0;
+
+/*!
+	\var		controlZlp
+	\brief		The control IN data stage ends with a zero length packet
+*/
+static uint8_t controlZlp = 0;
+
+/*!
+	\var		controlOut
+	\brief		Set while the data stage of SET_LINE_CODING is expected
+*/
+static uint8_t controlOut = 0;
+
+/*!
+	\var		pendingAddress
+	\brief		Address of SET_ADDRESS, taken after its status stage
+*/
+static uint8_t pendingAddress = 0;
+
+/*!
+	\var		stringBuffer
+	\brief		UTF-16 string descriptor being sent
+*/
+static uint8_t stringBuffer[2 + 2 * USB_MAX_STRING];
+
+/*!
+	\var		statusBuffer
+	\brief		Reply of GET_STATUS, GET_CONFIGURATION and GET_INTERFACE
+*/
+static uint8_t statusBuffer[2];
+
+/*!
+	\var		configuration
+	\brief		Configuration selected by the host, 0 while not configured
+*/
+static uint8_t configuration = 0;
+
+/*!
+	\var		lineCoding
+	\brief		CDC line coding; kept for GET_LINE_CODING only, the baud rate
+				means nothing on USB. 115200 8N1 until the host sets it.
+*/
+static uint8_t lineCoding[LINE_CODING_SIZE] = {0x00, 0xC2, 0x01, 0x00, 0, 0, 8};
+
+/*!
+	\var		lineState
+	\brief		Last SET_CONTROL_LINE_STATE value
+*/
+static uint16_t lineState = 0;
+
+/*!
+	\var		suspended
+	\brief		Set while the bus is suspended and the 48 MHz profile released
+*/
+static uint8_t suspended = 1;
+
+/*!
+	\var		statistics
+	\brief		Counters read with USB_dwfnGetStatistic
+*/
+static uint32_t statistics[eUSB_STATISTICS];
+
+/*!
+	\var		rxCallback
+	\brief		Called when received bytes are waiting
+*/
+static USB_RX_CALLBACK rxCallback = 0;
+
+/*!
+	\var		txCallback
+	\brief		Called when every queued byte was sent
+*/
+static USB_TX_CALLBACK txCallback = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void USB_vfnBusReset (void);
+static void USB_vfnSuspend (void);
+static void USB_vfnResume (void);
+static void USB_vfnToken (uint8_t stat);
+static void USB_vfnArmIn (uint8_t ep, const uint8_t *data, uint16_t size);
+static void USB_vfnArmRx (uint8_t odd);
+static void USB_vfnCancelIn (uint8_t ep);
+static void USB_vfnKickTx (void);
+static void USB_vfnRxPacket (uint8_t odd, uint16_t count);
+static void USB_vfnSetup (const uint8_t *packet);
+static uint8_t USB_bfnStandard (void);
+static uint8_t USB_bfnClass (void);
+static uint8_t USB_bfnDescriptor (void);
+static void USB_vfnConfigure (uint8_t value);
+static void USB_vfnControlSend (const uint8_t *data, uint16_t size);
+static void USB_vfnControlStatus (void);
+static void USB_vfnControlNext (void);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void USB_vfnDriverInit (void)
+	\brief		Clocks the module from IRC48M with clock recovery, resets it,
+				points it at the BDT and connects the D+ pull-up. The host
+				sees the device from then on; the bus reset it sends does the
+				rest of the set up.
+*/
+void USB_vfnDriverInit (void)
+{
+	uint32_t address = (uint32_t)(uintptr_t)bdt;
+	uint16_t timeout = USB_RESET_TIMEOUT;
+
+	/* IRC48M stays on in every clock profile and feeds the module */
+	MCG->MC |= MCG_MC_HIRCEN_MASK;
+	SIM->SOPT2 = (SIM->SOPT2 & ~SIM_SOPT2_USBSRC_MASK) | SIM_SOPT2_USBSRC (1);
+	SIM->SCGC4 |= SIM_SCGC4_USBFS_MASK;
+
+	USB0->USBTRC0 |= USB_USBTRC0_USBRESET_MASK;
+	while ((USB0->USBTRC0 & USB_USBTRC0_USBRESET_MASK) && timeout--)
+	{
+	}
+
+	/* Trims IRC48M against the SOF of the host */
+	USB0->CLK_RECOVER_IRC_EN = USB_CLK_RECOVER_IRC_EN_IRC_EN_MASK;
+	USB0->CLK_RECOVER_CTRL |= USB_CLK_RECOVER_CTRL_CLOCK_RECOVER_EN_MASK;
+
+	USB0->BDTPAGE1 = (uint8_t)((address >> 8) & USB_BDTPAGE1_BDTBA_MASK);
+	USB0->BDTPAGE2 = (uint8_t)(address >> 16);
+	USB0->BDTPAGE3 = (uint8_t)(address >> 24);
+
+	memset ((void *)bdt, 0, sizeof (bdt));
+	memset (statistics, 0, sizeof (statistics));
+	rxHead = rxTail = 0;
+	txHead = txTail = 0;
+	configuration = 0;
+
+	USB0->ISTAT = 0xFF;
+	USB0->ERRSTAT = 0xFF;
+	USB0->ERREN = 0xFF;
+	USB0->INTEN = USB_INTEN_USBRSTEN_MASK | USB_INTEN_TOKDNEEN_MASK |
+			USB_INTEN_SLEEPEN_MASK | USB_INTEN_STALLEN_MASK |
+			USB_INTEN_ERROREN_MASK;
+	USB0->USBCTRL = 0;
+	USB0->CTL = USB_CTL_USBENSOFEN_MASK;
+	USB0->CONTROL = USB_CONTROL_DPPULLUPNONOTG_MASK;
+
+	/* Awake until the host suspends the bus */
+	suspended = 0;
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+
+	NVIC->ISER[0] = (1u << USB0_IRQn);
+}
+
+/*!
+	\fn			void USB_vfnDriverDeinit (void)
+	\brief		Disconnects from the host and stops the module
+*/
+void USB_vfnDriverDeinit (void)
+{
+	NVIC->ICER[0] = (1u << USB0_IRQn);
+
+	USB0->CONTROL = 0;
+	USB0->INTEN = 0;
+	USB0->CTL = 0;
+	USB0->USBTRC0 &= ~USB_USBTRC0_USBRESMEN_MASK;
+	configuration = 0;
+
+	if (!suspended)
+	{
+		suspended = 1;
+		ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
+	}
+	SIM->SCGC4 &= ~SIM_SCGC4_USBFS_MASK;
+}
+
+/*!
+	\fn			void USB_vfnCallbackReg (USB_RX_CALLBACK rxCallbackPtr, USB_TX_CALLBACK txCallbackPtr)
+	\param		rxCallbackPtr	Called when received bytes are waiting, or 0
+	\param		txCallbackPtr	Called when every queued byte was sent, or 0
+	\brief		Registers the callbacks of the USB interrupt
+*/
+void USB_vfnCallbackReg (USB_RX_CALLBACK rxCallbackPtr, USB_TX_CALLBACK txCallbackPtr)
+{
+	rxCallback = rxCallbackPtr;
+	txCallback = txCallbackPtr;
+}
+
+/*!
+	\fn			uint16_t USB_wfnReceive (uint8_t *data, uint16_t size)
+	\param		data	Destination of the received bytes
+	\param		size	Room in data
+	\return		Returns the number of bytes copied
+	\brief		Takes received bytes from the ring. Buffers held back because
+				the ring was full go back to the SIE once there is room again.
+*/
+uint16_t USB_wfnReceive (uint8_t *data, uint16_t size)
+{
+	uint16_t count = 0;
+	uint32_t primask;
+
+	while ((count < size) && (rxTail != rxHead))
+	{
+		data[count++] = rxRing[rxTail];
+		rxTail = (uint16_t)((rxTail + 1) & (USB_RX_RING - 1));
+	}
+
+	if (count && configuration && (rxArmed != 3))
+	{
+		primask = __get_PRIMASK ();
+		__disable_irq ();
+		USB_vfnArmRx (0);
+		USB_vfnArmRx (1);
+		__set_PRIMASK (primask);
+	}
+
+	return count;
+}
+
+/*!
+	\fn			uint16_t USB_wfnSend (const uint8_t *data, uint16_t size)
+	\param		data	Bytes to send
+	\param		size	Number of bytes
+	\return		Returns the number of bytes queued, less than size when the
+				ring is full and 0 while the host has not configured the port
+	\brief		Queues bytes for the data IN endpoint and starts sending them
+*/
+uint16_t USB_wfnSend (const uint8_t *data, uint16_t size)
+{
+	uint16_t count = 0;
+	uint16_t next;
+	uint32_t primask;
+
+	if (!configuration)
+	{
+		return 0;
+	}
+
+	while (count < size)
+	{
+		next = (uint16_t)((txHead + 1) & (USB_TX_RING - 1));
+		if (next == txTail)
+		{
+			break;
+		}
+		txRing[txHead] = data[count++];
+		txHead = next;
+	}
+
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	USB_vfnKickTx ();
+	__set_PRIMASK (primask);
+
+	return count;
+}
+
+/*!
+	\fn			uint16_t USB_wfnTxPending (void)
+	\return		Returns the number of queued bytes not yet in an IN buffer
+*/
+uint16_t USB_wfnTxPending (void)
+{
+	return (uint16_t)((txHead - txTail) & (USB_TX_RING - 1));
+}
+
+/*!
+	\fn			uint8_t USB_bfnIsConfigured (void)
+	\return		Returns 1 if the host configured the device; else, returns 0
+*/
+uint8_t USB_bfnIsConfigured (void)
+{
+	return (configuration != 0);
+}
+
+/*!
+	\fn			uint8_t USB_bfnIsOpen (void)
+	\return		Returns 1 if a host program has the port open (DTR); else,
+				returns 0
+*/
+uint8_t USB_bfnIsOpen (void)
+{
+	return (configuration != 0) && (lineState & CONTROL_LINE_DTR);
+}
+
+/*!
+	\fn			uint32_t USB_dwfnGetStatistic (USB_STATISTIC statistic)
+	\param		statistic	Counter to read
+	\return		Returns the counter, 0 for an invalid one
+*/
+uint32_t USB_dwfnGetStatistic (USB_STATISTIC statistic)
+{
+	return (statistic < eUSB_STATISTICS) ? statistics[statistic] : 0;
+}
+
+/*!
+	\fn			void USB0_DriverIRQHandler (void)
+	\brief		USB interrupt. Takes one completed token from the status
+				FIFO per entry; TOKDNE stays set while the FIFO holds more,
+				so the interrupt is taken again right away.
+*/
+void USB0_DriverIRQHandler (void)
+{
+	uint8_t status = USB0->ISTAT & (USB0->INTEN | USB_ISTAT_RESUME_MASK);
+
+	STACK_ISR_ENTER (eSTACK_ISR_USB);
+	if ((USB0->USBTRC0 & USB_USBTRC0_USB_RESUME_INT_MASK) ||
+			(status & USB_ISTAT_RESUME_MASK))
+	{
+		USB_vfnResume ();
+	}
+
+	if (status & USB_ISTAT_USBRST_MASK)
+	{
+		USB_vfnResume ();
+		USB_vfnBusReset ();
+		STACK_ISR_EXIT (eSTACK_ISR_USB);
+		return;
+	}
+
+	if (status & USB_ISTAT_ERROR_MASK)
+	{
+		USB0->ERRSTAT = 0xFF;
+		USB0->ISTAT = USB_ISTAT_ERROR_MASK;
+	}
+
+	if (status & USB_ISTAT_STALL_MASK)
+	{
+		/* The stall was sent; endpoint 0 takes the next SETUP */
+		USB0->ENDPOINT[EP_CONTROL].ENDPT &= ~USB_ENDPT_EPSTALL_MASK;
+		USB0->ISTAT = USB_ISTAT_STALL_MASK;
+	}
+
+	if (status & USB_ISTAT_TOKDNE_MASK)
+	{
+		/* STAT is valid until TOKDNE is cleared, which pops the FIFO */
+		uint8_t stat = USB0->STAT;
+
+		USB0->ISTAT = USB_ISTAT_TOKDNE_MASK;
+		USB_vfnToken (stat);
+	}
+
+	if (status & USB_ISTAT_SLEEP_MASK)
+	{
+		USB0->ISTAT = USB_ISTAT_SLEEP_MASK;
+		USB_vfnSuspend ();
+	}
+	STACK_ISR_EXIT (eSTACK_ISR_USB);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void USB_vfnBusReset (void)
+	\brief		Returns to the default state: address 0, only endpoint 0,
+				every buffer back to even
+*/
+static void USB_vfnBusReset (void)
+{
+	uint8_t ep = 0;
+
+	USB0->CTL |= USB_CTL_ODDRST_MASK;
+	USB0->ADDR = 0;
+	memset ((void *)bdt, 0, sizeof (bdt));
+	for (ep = 0; ep < USB_ENDPOINTS; ep++)
+	{
+		inOdd[ep] = 0;
+		inData1[ep] = 0;
+		inArmed[ep] = 0;
+		USB0->ENDPOINT[ep].ENDPT = 0;
+	}
+	rxOdd = 0;
+	rxArmed = 0;
+	txHead = txTail = 0;
+	txLastFull = 0;
+	controlRemaining = 0;
+	controlZlp = 0;
+	controlOut = 0;
+	pendingAddress = 0;
+	configuration = 0;
+	lineState = 0;
+
+	/* Both endpoint 0 OUT buffers always wait for the next SETUP */
+	bdt[BD_INDEX (EP_CONTROL, 0, 0)].address = (uint32_t)(uintptr_t)outBuffers[EP_CONTROL][0];
+	bdt[BD_INDEX (EP_CONTROL, 0, 0)].control = BD_BC (USB_PACKET) | BD_OWN;
+	bdt[BD_INDEX (EP_CONTROL, 0, 1)].address = (uint32_t)(uintptr_t)outBuffers[EP_CONTROL][1];
+	bdt[BD_INDEX (EP_CONTROL, 0, 1)].control = BD_BC (USB_PACKET) | BD_OWN;
+	USB0->ENDPOINT[EP_CONTROL].ENDPT = USB_ENDPT_EPHSHK_MASK |
+			USB_ENDPT_EPTXEN_MASK | USB_ENDPT_EPRXEN_MASK;
+
+	USB0->CTL &= ~USB_CTL_ODDRST_MASK;
+	USB0->ERRSTAT = 0xFF;
+	USB0->ISTAT = 0xFF;
+	statistics[eUSB_RESETS]++;
+}
+
+/*!
+	\fn			static void USB_vfnSuspend (void)
+	\brief		The host stopped sending SOFs: suspends the transceiver, arms
+				the asynchronous resume and lets the core slow down
+*/
+static void USB_vfnSuspend (void)
+{
+	if (suspended)
+	{
+		return;
+	}
+	suspended = 1;
+	statistics[eUSB_SUSPENDS]++;
+
+	USB0->INTEN |= USB_INTEN_RESUMEEN_MASK;
+	USB0->USBCTRL |= USB_USBCTRL_SUSP_MASK;
+	USB0->USBTRC0 |= USB_USBTRC0_USBRESMEN_MASK;
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
+}
+
+/*!
+	\fn			static void USB_vfnResume (void)
+	\brief		Bus activity after a suspend: wakes the transceiver and asks
+				for 48 MHz again
+*/
+static void USB_vfnResume (void)
+{
+	USB0->USBTRC0 &= ~USB_USBTRC0_USBRESMEN_MASK;
+	USB0->ISTAT = USB_ISTAT_RESUME_MASK;
+	if (!suspended)
+	{
+		return;
+	}
+	suspended = 0;
+
+	USB0->USBCTRL &= ~USB_USBCTRL_SUSP_MASK;
+	USB0->INTEN &= ~USB_INTEN_RESUMEEN_MASK;
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+}
+
+/*!
+	\fn			static void USB_vfnToken (uint8_t stat)
+	\param		stat	USB0_STAT of the completed token
+	\brief		Dispatches a completed transaction to its endpoint
+*/
+static void USB_vfnToken (uint8_t stat)
+{
+	uint8_t ep = (stat & USB_STAT_ENDP_MASK) >> USB_STAT_ENDP_SHIFT;
+	uint8_t tx = (stat & USB_STAT_TX_MASK) ? 1 : 0;
+	uint8_t odd = (stat & USB_STAT_ODD_MASK) ? 1 : 0;
+	USB_BD *bd = &bdt[BD_INDEX (ep, tx, odd)];
+	uint32_t control = bd->control;
+
+	if (ep >= USB_ENDPOINTS)
+	{
+		return;
+	}
+
+	if (tx)
+	{
+		if (inArmed[ep])
+		{
+			inArmed[ep]--;
+		}
+		if (ep == EP_CONTROL)
+		{
+			USB_vfnControlNext ();
+		}
+		else if (ep == EP_DATA)
+		{
+			statistics[eUSB_TX_PACKETS]++;
+			USB_vfnKickTx ();
+		}
+		return;
+	}
+
+	if (ep == EP_DATA)
+	{
+		rxOdd ^= 1;
+		rxArmed &= (uint8_t)~(1u << odd);
+		USB_vfnRxPacket (odd, (uint16_t)BD_GET_BC (control));
+		return;
+	}
+
+	/* Endpoint 0 OUT: SETUP, the SET_LINE_CODING data or a status stage */
+	if (BD_GET_PID (control) == PID_SETUP)
+	{
+		USB_vfnSetup (outBuffers[EP_CONTROL][odd]);
+	}
+	else if (controlOut)
+	{
+		controlOut = 0;
+		if (BD_GET_BC (control) >= LINE_CODING_SIZE)
+		{
+			memcpy (lineCoding, outBuffers[EP_CONTROL][odd], LINE_CODING_SIZE);
+		}
+		USB_vfnControlStatus ();
+	}
+	bd->control = BD_BC (USB_PACKET) | BD_OWN;
+
+	/* A SETUP suspends the token processing until it was answered */
+	USB0->CTL &= ~USB_CTL_TXSUSPENDTOKENBUSY_MASK;
+}
+
+/*!
+	\fn			static void USB_vfnArmIn (uint8_t ep, const uint8_t *data, uint16_t size)
+	\param		ep		Endpoint 0 or 1
+	\param		data	Packet to send, copied; may be 0 when size is 0
+	\param		size	Bytes in the packet, up to USB_PACKET
+	\brief		Hands the next IN buffer of an endpoint to the SIE
+*/
+static void USB_vfnArmIn (uint8_t ep, const uint8_t *data, uint16_t size)
+{
+	uint8_t odd = inOdd[ep];
+	USB_BD *bd = &bdt[BD_INDEX (ep, 1, odd)];
+
+	if (size)
+	{
+		memcpy (inBuffers[ep][odd], data, size);
+	}
+	bd->address = (uint32_t)(uintptr_t)inBuffers[ep][odd];
+	bd->control = BD_BC (size) | (inData1[ep] ? BD_DATA1 : 0) | BD_DTS | BD_OWN;
+
+	inOdd[ep] ^= 1;
+	inData1[ep] ^= 1;
+	inArmed[ep]++;
+}
+
+/*!
+	\fn			static void USB_vfnArmRx (uint8_t odd)
+	\param		odd		Data OUT buffer
+	\brief		Hands a data OUT buffer to the SIE if it is not already there
+				and the ring has room for it and for every other armed buffer
+*/
+static void USB_vfnArmRx (uint8_t odd)
+{
+	uint16_t used = (uint16_t)((rxHead - rxTail) & (USB_RX_RING - 1));
+	uint16_t room = (uint16_t)(USB_RX_RING - 1 - used);
+	uint16_t needed = USB_PACKET;
+	USB_BD *bd = &bdt[BD_INDEX (EP_DATA, 0, odd)];
+
+	if (rxArmed & (1u << odd))
+	{
+		return;
+	}
+	if (rxArmed)
+	{
+		needed += USB_PACKET;
+	}
+	if (room < needed)
+	{
+		return;
+	}
+
+	bd->address = (uint32_t)(uintptr_t)outBuffers[EP_DATA][odd];
+	bd->control = BD_BC (USB_PACKET) | (rxData1[odd] ? BD_DATA1 : 0) | BD_DTS | BD_OWN;
+	rxArmed |= (uint8_t)(1u << odd);
+}
+
+/*!
+	\fn			static void USB_vfnCancelIn (uint8_t ep)
+	\param		ep		Endpoint 0 or 1
+	\brief		Takes back the IN buffers the SIE did not send. The SIE
+				still expects the first of them, so the buffer order is
+				rewound by one per buffer taken back.
+*/
+static void USB_vfnCancelIn (uint8_t ep)
+{
+	uint8_t odd = 0;
+
+	for (odd = 0; odd < 2; odd++)
+	{
+		if (bdt[BD_INDEX (ep, 1, odd)].control & BD_OWN)
+		{
+			bdt[BD_INDEX (ep, 1, odd)].control = 0;
+			inOdd[ep] ^= 1;
+			inArmed[ep]--;
+		}
+	}
+}
+
+/*!
+	\fn			static void USB_vfnKickTx (void)
+	\brief		Moves queued bytes into every free data IN buffer. A transfer
+				ending on a full packet is closed with a zero length packet.
+				Runs in the interrupt or with interrupts disabled.
+*/
+static void USB_vfnKickTx (void)
+{
+	uint8_t packet[USB_PACKET];
+	uint16_t count = 0;
+
+	if (!configuration)
+	{
+		return;
+	}
+
+	while (inArmed[EP_DATA] < 2)
+	{
+		count = 0;
+		while ((count < USB_PACKET) && (txTail != txHead))
+		{
+			packet[count++] = txRing[txTail];
+			txTail = (uint16_t)((txTail + 1) & (USB_TX_RING - 1));
+		}
+		if ((count == 0) && !txLastFull)
+		{
+			break;
+		}
+		txLastFull = (count == USB_PACKET);
+		USB_vfnArmIn (EP_DATA, packet, count);
+	}
+
+	if ((inArmed[EP_DATA] == 0) && (txTail == txHead) && (txCallback != 0))
+	{
+		txCallback ();
+	}
+}
+
+/*!
+	\fn			static void USB_vfnRxPacket (uint8_t odd, uint16_t count)
+	\param		odd		Data OUT buffer that was filled
+	\param		count	Bytes in the packet
+	\brief		Copies a data OUT packet into the ring and gives the buffer
+				back to the SIE, or holds it while the ring is too full. A
+				held buffer makes the host retry with NAKs until
+				USB_wfnReceive frees the ring.
+*/
+static void USB_vfnRxPacket (uint8_t odd, uint16_t count)
+{
+	const uint8_t *data = outBuffers[EP_DATA][odd];
+	uint16_t i = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		rxRing[rxHead] = data[i];
+		rxHead = (uint16_t)((rxHead + 1) & (USB_RX_RING - 1));
+	}
+	statistics[eUSB_RX_PACKETS]++;
+
+	USB_vfnArmRx (odd);
+	if (!(rxArmed & (1u << odd)))
+	{
+		statistics[eUSB_RX_HELD]++;
+	}
+
+	if ((count != 0) && (rxCallback != 0))
+	{
+		rxCallback ();
+	}
+}
+
+/*!
+	\fn			static void USB_vfnSetup (const uint8_t *packet)
+	\param		packet	SETUP packet
+	\brief		Starts a control transfer. A new SETUP ends whatever transfer
+				was still running; requests that are not supported are
+				answered with a stall.
+*/
+static void USB_vfnSetup (const uint8_t *packet)
+{
+	uint8_t handled = 0;
+
+	setup.requestType = packet[0];
+	setup.request = packet[1];
+	setup.value = (uint16_t)(packet[2] | (packet[3] << 8));
+	setup.index = (uint16_t)(packet[4] | (packet[5] << 8));
+	setup.length = (uint16_t)(packet[6] | (packet[7] << 8));
+
+	USB_vfnCancelIn (EP_CONTROL);
+	USB0->ENDPOINT[EP_CONTROL].ENDPT &= ~USB_ENDPT_EPSTALL_MASK;
+	controlRemaining = 0;
+	controlZlp = 0;
+	controlOut = 0;
+	/* Data and status stages start with DATA1 */
+	inData1[EP_CONTROL] = 1;
+
+	if (REQUEST_TYPE (setup.requestType) == 0)
+	{
+		handled = USB_bfnStandard ();
+	}
+	else if (REQUEST_TYPE (setup.requestType) == 1)
+	{
+		handled = USB_bfnClass ();
+	}
+
+	if (!handled)
+	{
+		USB0->ENDPOINT[EP_CONTROL].ENDPT |= USB_ENDPT_EPSTALL_MASK;
+	}
+}
+
+/*!
+	\fn			static uint8_t USB_bfnStandard (void)
+	\return		Returns 1 if the request was answered; else, returns 0
+	\brief		Chapter 9 requests
+*/
+static uint8_t USB_bfnStandard (void)
+{
+	uint8_t recipient = REQUEST_RECIPIENT (setup.requestType);
+	uint8_t ep = (uint8_t)(setup.index & 0x0F);
+
+	switch (setup.request)
+	{
+		case eREQ_GET_STATUS:
+			statusBuffer[0] = 0;
+			statusBuffer[1] = 0;
+			if (recipient == 0)
+			{
+				/* Self powered */
+				statusBuffer[0] = 1;
+			}
+			else if ((recipient == 2) && (ep < USB_ENDPOINTS) &&
+					(USB0->ENDPOINT[ep].ENDPT & USB_ENDPT_EPSTALL_MASK))
+			{
+				statusBuffer[0] = 1;
+			}
+			USB_vfnControlSend (statusBuffer, 2);
+			return 1;
+
+		case eREQ_CLEAR_FEATURE:
+		case eREQ_SET_FEATURE:
+			if ((recipient != 2) || (ep == EP_CONTROL) || (ep >= USB_ENDPOINTS))
+			{
+				/* No remote wakeup, no test modes */
+				return (recipient == 0);
+			}
+			if (setup.request == eREQ_SET_FEATURE)
+			{
+				USB0->ENDPOINT[ep].ENDPT |= USB_ENDPT_EPSTALL_MASK;
+			}
+			else
+			{
+				/* Leaving the halt restarts the data toggle with DATA0 */
+				USB0->ENDPOINT[ep].ENDPT &= ~USB_ENDPT_EPSTALL_MASK;
+				if (setup.index & 0x80)
+				{
+					USB_vfnCancelIn (ep);
+					inData1[ep] = 0;
+					if (ep == EP_DATA)
+					{
+						USB_vfnKickTx ();
+					}
+				}
+				else if (ep == EP_DATA)
+				{
+					rxData1[rxOdd] = 0;
+					rxData1[rxOdd ^ 1] = 1;
+					if (rxArmed & (1u << rxOdd))
+					{
+						bdt[BD_INDEX (EP_DATA, 0, rxOdd)].control &= ~BD_DATA1;
+					}
+					if (rxArmed & (1u << (rxOdd ^ 1)))
+					{
+						bdt[BD_INDEX (EP_DATA, 0, rxOdd ^ 1)].control |= BD_DATA1;
+					}
+				}
+			}
+			USB_vfnControlStatus ();
+			return 1;
+
+		case eREQ_SET_ADDRESS:
+			/* Still answering on address 0 until the status stage is sent */
+			pendingAddress = (uint8_t)(setup.value & USB_ADDR_ADDR_MASK);
+			USB_vfnControlStatus ();
+			return 1;
+
+		case eREQ_GET_DESCRIPTOR:
+			return USB_bfnDescriptor ();
+
+		case eREQ_GET_CONFIGURATION:
+			statusBuffer[0] = configuration;
+			USB_vfnControlSend (statusBuffer, 1);
+			return 1;
+
+		case eREQ_SET_CONFIGURATION:
+			if (setup.value > 1)
+			{
+				return 0;
+			}
+			USB_vfnConfigure ((uint8_t)setup.value);
+			USB_vfnControlStatus ();
+			return 1;
+
+		case eREQ_GET_INTERFACE:
+			statusBuffer[0] = 0;
+			USB_vfnControlSend (statusBuffer, 1);
+			return 1;
+
+		case eREQ_SET_INTERFACE:
+			if (setup.value != 0)
+			{
+				return 0;
+			}
+			USB_vfnControlStatus ();
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+/*!
+	\fn			static uint8_t USB_bfnClass (void)
+	\return		Returns 1 if the request was answered; else, returns 0
+	\brief		CDC-ACM requests of the communication interface
+*/
+static uint8_t USB_bfnClass (void)
+{
+	switch (setup.request)
+	{
+		case eREQ_SET_LINE_CODING:
+			/* The data stage lands in an endpoint 0 OUT buffer */
+			controlOut = 1;
+			return 1;
+
+		case eREQ_GET_LINE_CODING:
+			USB_vfnControlSend (lineCoding, LINE_CODING_SIZE);
+			return 1;
+
+		case eREQ_SET_CONTROL_LINE_STATE:
+			lineState = setup.value;
+			USB_vfnControlStatus ();
+			return 1;
+
+		case eREQ_SEND_BREAK:
+			USB_vfnControlStatus ();
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+/*!
+	\fn			static uint8_t USB_bfnDescriptor (void)
+	\return		Returns 1 if the descriptor exists; else, returns 0
+	\brief		GET_DESCRIPTOR. Strings are widened to UTF-16 on the fly.
+*/
+static uint8_t USB_bfnDescriptor (void)
+{
+	uint8_t index = (uint8_t)setup.value;
+	const char *text;
+	uint8_t length = 0;
+
+	switch (setup.value >> 8)
+	{
+		case eDESC_DEVICE:
+			USB_vfnControlSend (deviceDescriptor, sizeof (deviceDescriptor));
+			return 1;
+
+		case eDESC_CONFIGURATION:
+			USB_vfnControlSend (configurationDescriptor, sizeof (configurationDescriptor));
+			return 1;
+
+		case eDESC_STRING:
+			if (index == 0)
+			{
+				USB_vfnControlSend (languageDescriptor, sizeof (languageDescriptor));
+				return 1;
+			}
+			if (index > (sizeof (strings) / sizeof (strings[0])))
+			{
+				return 0;
+			}
+			text = strings[index - 1];
+			while ((text[length] != '\0') && (length < USB_MAX_STRING))
+			{
+				stringBuffer[2 + 2 * length] = (uint8_t)text[length];
+				stringBuffer[3 + 2 * length] = 0;
+				length++;
+			}
+			stringBuffer[0] = (uint8_t)(2 + 2 * length);
+			stringBuffer[1] = eDESC_STRING;
+			USB_vfnControlSend (stringBuffer, stringBuffer[0]);
+			return 1;
+
+		default:
+			return 0;
+	}
+}
+
+/*!
+	\fn			static void USB_vfnConfigure (uint8_t value)
+	\param		value	Configuration, 0 to go back to the address state
+	\brief		Enables or disables the data and notification endpoints. Both
+				data OUT buffers are armed at once, DATA0 in the one the SIE
+				fills first.
+*/
+static void USB_vfnConfigure (uint8_t value)
+{
+	USB_vfnCancelIn (EP_DATA);
+	bdt[BD_INDEX (EP_DATA, 0, 0)].control = 0;
+	bdt[BD_INDEX (EP_DATA, 0, 1)].control = 0;
+	rxArmed = 0;
+	inData1[EP_DATA] = 0;
+	inData1[EP_NOTIFY] = 0;
+	txHead = txTail = 0;
+	txLastFull = 0;
+	configuration = value;
+
+	if (!value)
+	{
+		USB0->ENDPOINT[EP_DATA].ENDPT = 0;
+		USB0->ENDPOINT[EP_NOTIFY].ENDPT = 0;
+		return;
+	}
+
+	USB0->ENDPOINT[EP_DATA].ENDPT = USB_ENDPT_EPHSHK_MASK |
+			USB_ENDPT_EPTXEN_MASK | USB_ENDPT_EPRXEN_MASK |
+			USB_ENDPT_EPCTLDIS_MASK;
+	USB0->ENDPOINT[EP_NOTIFY].ENDPT = USB_ENDPT_EPHSHK_MASK |
+			USB_ENDPT_EPTXEN_MASK | USB_ENDPT_EPCTLDIS_MASK;
+
+	rxData1[rxOdd] = 0;
+	rxData1[rxOdd ^ 1] = 1;
+	USB_vfnArmRx (rxOdd);
+	USB_vfnArmRx (rxOdd ^ 1);
+}
+
+/*!
+	\fn			static void USB_vfnControlSend (const uint8_t *data, uint16_t size)
+	\param		data	Data stage, kept by reference until it was sent
+	\param		size	Bytes available; the host may ask for fewer
+	\brief		Starts a control IN data stage. A stage shorter than asked
+				for that ends on a full packet needs a zero length packet.
+*/
+static void USB_vfnControlSend (const uint8_t *data, uint16_t size)
+{
+	if (size > setup.length)
+	{
+		size = setup.length;
+	}
+	if (size == 0)
+	{
+		USB_vfnControlStatus ();
+		return;
+	}
+	controlData = data;
+	controlRemaining = size;
+	controlZlp = (size < setup.length) && ((size % USB_PACKET) == 0);
+
+	USB_vfnControlNext ();
+}
+
+/*!
+	\fn			static void USB_vfnControlStatus (void)
+	\brief		Sends the zero length status stage of a request without an
+				IN data stage
+*/
+static void USB_vfnControlStatus (void)
+{
+	inData1[EP_CONTROL] = 1;
+	USB_vfnArmIn (EP_CONTROL, 0, 0);
+}
+
+/*!
+	\fn			static void USB_vfnControlNext (void)
+	\brief		Sends the next packet of the control IN data stage, or takes
+				the address of SET_ADDRESS once its status stage went out
+*/
+static void USB_vfnControlNext (void)
+{
+	uint16_t size = controlRemaining;
+
+	if (pendingAddress && (controlRemaining == 0) && !controlZlp)
+	{
+		USB0->ADDR = pendingAddress;
+		pendingAddress = 0;
+		return;
+	}
+
+	if ((size == 0) && !controlZlp)
+	{
+		return;
+	}
+	if (size > USB_PACKET)
+	{
+		size = USB_PACKET;
+	}
+	if (size == 0)
+	{
+		controlZlp = 0;
+	}
+
+	USB_vfnArmIn (EP_CONTROL, controlData, size);
+	controlData += size;
+	controlRemaining = (uint16_t)(controlRemaining - size);
+}
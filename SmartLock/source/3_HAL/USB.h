@@ -0,0 +1,110 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		USB.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the USB full-speed CDC device. The
+				board enumerates as a virtual COM port; the bulk endpoints are
+				double buffered, so the host can send the next packet while
+				the previous one is still being copied out.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _3_HAL_USB_H_
+#define _3_HAL_USB_H_
+
+	//--------------------------------------------------------------------------
+	// Includes
+	//--------------------------------------------------------------------------
+	#include <stdint.h>
+
+	//--------------------------------------------------------------------------
+	// Defines
+	//--------------------------------------------------------------------------
+	/*!
+		\def		USB_CDC_ENABLE
+		\brief		Brings up the USB CDC port next to the LPUART, so service
+					tools can use the management protocol at full speed. USB
+					keeps the core at 48 MHz while the bus is not suspended.
+	*/
+	#ifndef HOST_SIMULATION
+//		#define USB_CDC_ENABLE
+	#endif
+
+	/*!
+		\def		USB_PACKET
+		\brief		Maximum packet size of the control and bulk endpoints
+	*/
+	#define USB_PACKET			64u
+
+	/*!
+		\def		USB_RX_RING
+		\brief		Size of the receive ring in bytes, a power of two
+	*/
+	#define USB_RX_RING			256u
+
+	/*!
+		\def		USB_TX_RING
+		\brief		Size of the transmit ring in bytes, a power of two
+	*/
+	#define USB_TX_RING			256u
+
+	//--------------------------------------------------------------------------
+	// Enums
+	//--------------------------------------------------------------------------
+	/*!
+		\enum		USB_STATISTIC
+		\brief		Counters kept by the driver
+	*/
+	typedef enum
+	{
+		eUSB_RX_PACKETS,	/* bulk OUT packets received */
+		eUSB_TX_PACKETS,	/* bulk IN packets sent, zero length ones included */
+		eUSB_RX_HELD,		/* OUT buffers held back because the ring was full */
+		eUSB_RESETS,		/* bus resets */
+		eUSB_SUSPENDS,		/* bus suspends */
+		eUSB_STATISTICS
+	} USB_STATISTIC;
+
+	//--------------------------------------------------------------------------
+	// Types
+	//--------------------------------------------------------------------------
+	/*!
+		\typedef	USB_RX_CALLBACK
+		\brief		Called from the USB interrupt when received bytes are
+					waiting in the ring; they are taken with USB_wfnReceive
+	*/
+	typedef void (*USB_RX_CALLBACK)(void);
+
+	/*!
+		\typedef	USB_TX_CALLBACK
+		\brief		Called from the USB interrupt when the transmit ring ran
+					empty and every queued byte was sent
+	*/
+	typedef void (*USB_TX_CALLBACK)(void);
+
+	//--------------------------------------------------------------------------
+	// Functions
+	//--------------------------------------------------------------------------
+	void USB_vfnDriverInit (void);
+
+	void USB_vfnDriverDeinit (void);
+
+	void USB_vfnCallbackReg (USB_RX_CALLBACK rxCallback, USB_TX_CALLBACK txCallback);
+
+	uint16_t USB_wfnReceive (uint8_t *data, uint16_t size);
+
+	uint16_t USB_wfnSend (const uint8_t *data, uint16_t size);
+
+	uint16_t USB_wfnTxPending (void);
+
+	uint8_t USB_bfnIsConfigured (void);
+
+	uint8_t USB_bfnIsOpen (void);
+
+	uint32_t USB_dwfnGetStatistic (USB_STATISTIC statistic);
+
+	void USB0_DriverIRQHandler (void);
+
+//------------------------------------------------------------------------------
+#endif /* _3_HAL_USB_H_ */
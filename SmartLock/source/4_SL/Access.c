@@ -0,0 +1,1051 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Access.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the access schedules. The rules
+				of a schedule (days, from, to) only exist while they are
+				uploaded: each one sets its slots in the week bitmap and is
+				dropped. The seconds interrupt keeps the slot of the current
+				time, so a check never divides the time.
+
+				The week has 672 slots, Monday 00:00 first, and a day is
+				exactly three words of the bitmap, so the slot index runs on
+				across midnight and a rule past midnight is one run of bits.
+				The RTC holds local time, as the app sets it.
+
+				A user with a code generator has the slot of its generator
+				in place of a pin. An entry of OTP_DIGITS digits, typed
+				between two '#', is tried as a code on the generators of
+				the users open now; a pin is never taken for a code. Codes
+				can still be guessed, so after ACCESS_OTP_TRIES wrong
+				codes in a row no code is tried for a lockout that doubles
+				with every further wrong code, up to about a quarter of an
+				hour; an accepted code ends it.
+
+				Users without a schedule open at any time. Users with one
+				stay locked out while the time is unset after a power-on.
+				The tables live in RAM and are uploaded again by the app.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "MKL27Z644.h"
+#include "RTC.h"
+#include "Pool.h"
+#include "Timebase.h"
+#include "Protocol.h"
+#include "Entry.h"
+#include "Access.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		NO_PIN
+	\brief		Pin of a free user entry; no four digits pack to it
+*/
+#define		NO_PIN				0xFFFFFFFFu
+
+/*!
+	\def		OTP_PIN
+	\brief		Pin of a user with a code generator, ored with its slot; no
+				four digits pack to it either
+*/
+#define		OTP_PIN				0xF0000000u
+
+/*!
+	\def		IS_OTP_PIN
+	\brief		Whether a pin is the slot of a generator
+*/
+#define		IS_OTP_PIN(pin)		(((pin) != NO_PIN) && (((pin) & OTP_PIN) == OTP_PIN))
+
+/*!
+	\def		NO_USER
+	\brief		User of a free generator slot
+*/
+#define		NO_USER				0xFFFFu
+
+/*!
+	\def		ZONE_MAX_MINUTES
+	\brief		Largest offset of a time zone from UTC
+*/
+#define		ZONE_MAX_MINUTES	(14u * 60u)
+
+/*!
+	\def		WEEK_WORDS
+	\brief		Words of a week bitmap
+*/
+#define		WEEK_WORDS			(ACCESS_WEEK_SLOTS / 32u)
+
+/*!
+	\def		DAY_SECONDS
+	\brief		Seconds of a day
+*/
+#define		DAY_SECONDS			86400u
+
+/*!
+	\def		EPOCH_WEEKDAY
+	\brief		Weekday of day 0 of the RTC, 1970-01-01, a Thursday
+*/
+#define		EPOCH_WEEKDAY		3u
+
+/*!
+	\def		SLOT_MINUTES
+	\brief		Minutes of a slot
+*/
+#define		SLOT_MINUTES		(ACCESS_SLOT_SECONDS / 60u)
+
+/*!
+	\def		ACCESS_OTP_TRIES
+	\brief		Wrong codes in a row before the codes are locked out
+*/
+#define		ACCESS_OTP_TRIES	5u
+
+/*!
+	\def		ACCESS_OTP_LOCKOUT_MS
+	\brief		First lockout, doubled by every wrong code after it
+*/
+#define		ACCESS_OTP_LOCKOUT_MS	30000u
+
+/*!
+	\def		ACCESS_OTP_DOUBLINGS
+	\brief		Doublings of the lockout at most, 16 minutes
+*/
+#define		ACCESS_OTP_DOUBLINGS	5u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		pins
+	\brief		Pin of every user, its four digits packed first digit high
+*/
+static uint32_t pins[ACCESS_USERS];
+
+/*!
+	\var		userSchedules
+	\brief		Schedule of every user, ACCESS_ALWAYS if unrestricted
+*/
+static uint8_t userSchedules[ACCESS_USERS];
+
+/*!
+	\var		schedules
+	\brief		Compiled schedules, bit (slot % 32) of word (slot / 32) set
+				if the slot is open
+*/
+static uint32_t schedules[ACCESS_SCHEDULES][WEEK_WORDS];
+
+/*!
+	\var		otpUsers
+	\brief		User of every generator slot, NO_USER if free
+*/
+static uint16_t otpUsers[OTP_SLOTS];
+
+/*!
+	\var		otpSecret
+	\brief		Secret uploaded for the next generator, in pieces, in a
+				pool block held until it is taken or wiped
+*/
+static uint8_t *otpSecret = 0;
+
+/*!
+	\var		otpSecretLength
+	\brief		Bytes of otpSecret uploaded
+*/
+static uint8_t otpSecretLength = 0;
+
+/*!
+	\var		zoneMinutes
+	\brief		Offset of local time from UTC, as set with "$OTP ZONE"
+*/
+static int32_t zoneMinutes = 0;
+
+/*!
+	\var		otpMisses
+	\brief		Wrong codes since the last accepted one
+*/
+static uint8_t otpMisses = 0;
+
+/*!
+	\var		otpLockedAt
+	\brief		ms of the wrong code that started the lockout
+*/
+static uint32_t otpLockedAt = 0;
+
+/*!
+	\var		otpLockoutMs
+	\brief		Length of the lockout, 0 while there is none
+*/
+static uint32_t otpLockoutMs = 0;
+
+/*!
+	\var		slot
+	\brief		Slot of the current time, written by the seconds interrupt
+*/
+static volatile uint16_t slot = 0;
+
+/*!
+	\var		secondsLeft
+	\brief		Seconds interrupts until the next slot starts
+*/
+static uint16_t secondsLeft = ACCESS_SLOT_SECONDS;
+
+/*!
+	\var		errorNames
+	\brief		Reply names of ACCESS_ERROR
+*/
+static const char * const errorNames[eACCESS_ERRORS] = {"ok", "index", "pin", "duplicate", "time", "full"};
+
+/*!
+	\var		otpKindNames
+	\brief		Names of OTP_KIND in "$OTP"
+*/
+static const char * const otpKindNames[eOTP_KINDS] = {"H1", "H256", "T1", "T256"};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Access_vfnSecond (uint32_t seconds);
+static void Access_vfnSync (uint32_t seconds);
+static uint32_t Access_dwfnPack (const uint8_t *pin);
+static void Access_vfnTime (const char *args);
+static void Access_vfnUser (const char *args);
+static void Access_vfnSchedule (const char *args);
+static void Access_vfnOtp (const char *args);
+static void Access_vfnOtpUser (uint32_t user, const char *args);
+static void Access_vfnFree (uint16_t user);
+static void Access_vfnWipeSecret (void);
+static void Access_vfnOtpMiss (void);
+static uint8_t Access_bfnDecimal (const char **text, uint32_t *value);
+static uint8_t Access_bfnSlot (uint32_t hhmm, uint8_t roundUp, uint8_t *slotOut);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Access_vfnInit (void)
+	\brief		Empties the tables, starts the RTC and registers "$TIME",
+				"$USER", "$SCHED" and "$OTP"
+*/
+void Access_vfnInit (void)
+{
+	uint32_t primask = 0;
+	uint16_t user = 0;
+
+	for (user = 0; user < ACCESS_USERS; user++)
+	{
+		pins[user] = NO_PIN;
+		userSchedules[user] = ACCESS_ALWAYS;
+	}
+	memset (schedules, 0, sizeof (schedules));
+	for (user = 0; user < OTP_SLOTS; user++)
+	{
+		otpUsers[user] = NO_USER;
+	}
+	Otp_vfnInit ();
+	Access_vfnWipeSecret ();
+	otpMisses = 0;
+	otpLockoutMs = 0;
+
+	RTC_vfnDriverInit ();
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	Access_vfnSync (RTC_dwfnGetTime ());
+	__set_PRIMASK (primask);
+	RTC_vfnCallbackReg (Access_vfnSecond);
+
+	Protocol_bfnRegister ("TIME", Access_vfnTime);
+	Protocol_bfnRegister ("USER", Access_vfnUser);
+	Protocol_bfnRegister ("SCHED", Access_vfnSchedule);
+	Protocol_bfnRegister ("OTP", Access_vfnOtp);
+}
+
+/*!
+	\fn			void Access_vfnSetTime (uint32_t seconds)
+	\param		seconds		Local time in seconds since 1970-01-01 00:00
+*/
+void Access_vfnSetTime (uint32_t seconds)
+{
+	uint32_t primask = __get_PRIMASK ();
+
+	__disable_irq ();
+	RTC_vfnSetTime (seconds);
+	Access_vfnSync (seconds);
+	__set_PRIMASK (primask);
+}
+
+/*!
+	\fn			ACCESS_ERROR Access_efnSetUser (uint16_t user, const uint8_t *pin, uint8_t schedule)
+	\param		user		Entry of the user table
+	\param		pin			Four digits
+	\param		schedule	Schedule of the user, or ACCESS_ALWAYS
+	\return		Returns eACCESS_OK if the user was stored
+	\brief		Adds or replaces a user. Pins are unique, so a pin finds a
+				single user.
+*/
+ACCESS_ERROR Access_efnSetUser (uint16_t user, const uint8_t *pin, uint8_t schedule)
+{
+	uint32_t packed = 0;
+	uint16_t other = 0;
+	uint8_t i = 0;
+
+	if ((user >= ACCESS_USERS) || ((schedule >= ACCESS_SCHEDULES) && (schedule != ACCESS_ALWAYS)))
+	{
+		return eACCESS_INDEX;
+	}
+	for (i = 0; i < 4; i++)
+	{
+		if (pin[i] > 9)
+		{
+			return eACCESS_PIN;
+		}
+	}
+	packed = Access_dwfnPack (pin);
+	for (other = 0; other < ACCESS_USERS; other++)
+	{
+		if ((other != user) && (pins[other] == packed))
+		{
+			return eACCESS_DUPLICATE;
+		}
+	}
+
+	Access_vfnFree (user);
+	pins[user] = packed;
+	userSchedules[user] = schedule;
+	return eACCESS_OK;
+}
+
+/*!
+	\fn			ACCESS_ERROR Access_efnSetOtpUser (uint16_t user, OTP_KIND kind, const uint8_t *secret,
+						uint8_t length, uint8_t schedule)
+	\param		user		Entry of the user table
+	\param		kind		Generator of the user; a HOTP one starts at counter 0
+	\param		secret		Key shared with the generator
+	\param		schedule	Schedule of the user, or ACCESS_ALWAYS
+	\return		Returns eACCESS_OK if the user was stored
+	\brief		Adds or replaces a user that opens with the codes of a
+				generator instead of a pin
+*/
+ACCESS_ERROR Access_efnSetOtpUser (uint16_t user, OTP_KIND kind, const uint8_t *secret,
+		uint8_t length, uint8_t schedule)
+{
+	uint8_t slot = 0;
+
+	if ((user >= ACCESS_USERS) || ((schedule >= ACCESS_SCHEDULES) && (schedule != ACCESS_ALWAYS)))
+	{
+		return eACCESS_INDEX;
+	}
+	Access_vfnFree (user);
+	slot = Otp_bfnAdd (kind, secret, length, 0);
+	if (slot == OTP_NONE)
+	{
+		return eACCESS_FULL;
+	}
+
+	otpUsers[slot] = user;
+	pins[user] = OTP_PIN | slot;
+	userSchedules[user] = schedule;
+	return eACCESS_OK;
+}
+
+/*!
+	\fn			ACCESS_ERROR Access_efnDeleteUser (uint16_t user)
+	\param		user	Entry of the user table
+	\return		Returns eACCESS_OK if the entry is free now
+*/
+ACCESS_ERROR Access_efnDeleteUser (uint16_t user)
+{
+	if (user >= ACCESS_USERS)
+	{
+		return eACCESS_INDEX;
+	}
+	Access_vfnFree (user);
+	pins[user] = NO_PIN;
+	userSchedules[user] = ACCESS_ALWAYS;
+	return eACCESS_OK;
+}
+
+/*!
+	\fn			ACCESS_ERROR Access_efnAddRule (uint8_t schedule, uint8_t days, uint8_t startSlot, uint8_t endSlot)
+	\param		schedule	Schedule to open
+	\param		days		Days the rule starts on, bit 0 Monday to bit 6 Sunday
+	\param		startSlot	First open slot of the day
+	\param		endSlot		Slot the rule closes at, up to ACCESS_DAY_SLOTS; at
+							or before startSlot the rule ends the next day
+	\return		Returns eACCESS_OK if the slots were opened
+	\brief		Compiles a rule into the bitmap of the schedule
+*/
+ACCESS_ERROR Access_efnAddRule (uint8_t schedule, uint8_t days, uint8_t startSlot, uint8_t endSlot)
+{
+	uint16_t count = 0;
+	uint16_t first = 0;
+	uint16_t bit = 0;
+	uint16_t weekSlot = 0;
+	uint8_t day = 0;
+
+	if (schedule >= ACCESS_SCHEDULES)
+	{
+		return eACCESS_INDEX;
+	}
+	if (!days || (days >> 7) || (startSlot >= ACCESS_DAY_SLOTS) || (endSlot > ACCESS_DAY_SLOTS))
+	{
+		return eACCESS_TIME;
+	}
+
+	count = (endSlot > startSlot) ? (uint16_t)(endSlot - startSlot)
+			: (uint16_t)(ACCESS_DAY_SLOTS - startSlot + endSlot);
+	for (day = 0; day < 7; day++)
+	{
+		if (!(days & (1u << day)))
+		{
+			continue;
+		}
+		first = (uint16_t)(day * ACCESS_DAY_SLOTS + startSlot);
+		for (bit = first; bit < first + count; bit++)
+		{
+			/* Sunday night runs on into Monday */
+			weekSlot = (bit < ACCESS_WEEK_SLOTS) ? bit : (uint16_t)(bit - ACCESS_WEEK_SLOTS);
+			schedules[schedule][weekSlot >> 5] |= 1u << (weekSlot & 31u);
+		}
+	}
+	return eACCESS_OK;
+}
+
+/*!
+	\fn			ACCESS_ERROR Access_efnClearSchedule (uint8_t schedule)
+	\param		schedule	Schedule to close
+	\return		Returns eACCESS_OK if every slot of the schedule is closed
+*/
+ACCESS_ERROR Access_efnClearSchedule (uint8_t schedule)
+{
+	if (schedule >= ACCESS_SCHEDULES)
+	{
+		return eACCESS_INDEX;
+	}
+	memset (schedules[schedule], 0, sizeof (schedules[schedule]));
+	return eACCESS_OK;
+}
+
+/*!
+	\fn			uint8_t Access_bfnAuthorize (const uint8_t *digits, uint8_t length)
+	\param		digits	Digits entered
+	\param		length	How many: ENTRY_PIN for a pin, OTP_DIGITS for a code
+	\return		Returns 1 if the pin belongs to a user whose schedule is open
+				now, or the code is one of the generator of such a user;
+				else, returns 0. No code is accepted while they are locked
+				out.
+*/
+uint8_t Access_bfnAuthorize (const uint8_t *digits, uint8_t length)
+{
+	uint32_t packed = 0;
+	uint32_t code = 0;
+	uint16_t user = 0;
+	uint8_t slot = 0;
+	uint8_t isTried = 0;
+	uint8_t i = 0;
+
+	if (length == ENTRY_PIN)
+	{
+		packed = Access_dwfnPack (digits);
+		for (user = 0; user < ACCESS_USERS; user++)
+		{
+			if (pins[user] == packed)
+			{
+				return Access_bfnIsOpen (userSchedules[user]);
+			}
+		}
+		return 0;
+	}
+	if (length != OTP_DIGITS)
+	{
+		return 0;
+	}
+
+	if (otpLockoutMs && ((Timebase_dwfnGetMs () - otpLockedAt) < otpLockoutMs))
+	{
+		return 0;
+	}
+
+	for (i = 0; i < OTP_DIGITS; i++)
+	{
+		code = (code * 10u) + digits[i];
+	}
+	for (slot = 0; slot < OTP_SLOTS; slot++)
+	{
+		user = otpUsers[slot];
+		if ((user != NO_USER) && Access_bfnIsOpen (userSchedules[user]))
+		{
+			isTried = 1;
+			if (Otp_bfnMatch (slot, code))
+			{
+				otpMisses = 0;
+				otpLockoutMs = 0;
+				return 1;
+			}
+		}
+	}
+
+	/* A wrong code with no generator to guess at is no guess */
+	if (isTried)
+	{
+		Access_vfnOtpMiss ();
+	}
+	return 0;
+}
+
+/*!
+	\fn			uint8_t Access_bfnIsOpen (uint8_t schedule)
+	\param		schedule	Schedule to check, or ACCESS_ALWAYS
+	\return		Returns 1 if the schedule is open at the current time
+*/
+uint8_t Access_bfnIsOpen (uint8_t schedule)
+{
+	uint16_t now = slot;
+
+	if (schedule == ACCESS_ALWAYS)
+	{
+		return 1;
+	}
+	if (!RTC_bfnIsSet ())
+	{
+		return 0;
+	}
+	return (schedules[schedule][now >> 5] >> (now & 31u)) & 1u;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Access_vfnSecond (uint32_t seconds)
+	\param		seconds		Time after the tick
+	\brief		Seconds interrupt. Counts down to the next slot and takes its
+				index from the time there, so a lost tick cannot drift it.
+*/
+static void Access_vfnSecond (uint32_t seconds)
+{
+	if (--secondsLeft == 0)
+	{
+		Access_vfnSync (seconds);
+	}
+}
+
+/*!
+	\fn			static void Access_vfnSync (uint32_t seconds)
+	\param		seconds		Current time
+	\brief		Takes the slot and the countdown from the time. Runs with the
+				seconds interrupt masked.
+*/
+static void Access_vfnSync (uint32_t seconds)
+{
+	uint32_t days = seconds / DAY_SECONDS;
+	uint32_t ofDay = seconds - (days * DAY_SECONDS);
+	uint32_t weekday = (days + EPOCH_WEEKDAY) % 7u;
+
+	slot = (uint16_t)((weekday * ACCESS_DAY_SLOTS) + (ofDay / ACCESS_SLOT_SECONDS));
+	secondsLeft = (uint16_t)(ACCESS_SLOT_SECONDS - (ofDay % ACCESS_SLOT_SECONDS));
+}
+
+/*!
+	\fn			static uint32_t Access_dwfnPack (const uint8_t *pin)
+	\return		Returns the four digits of a pin in a word
+*/
+static uint32_t Access_dwfnPack (const uint8_t *pin)
+{
+	return ((uint32_t)pin[0] << 24) | ((uint32_t)pin[1] << 16) | ((uint32_t)pin[2] << 8) | pin[3];
+}
+
+/*!
+	\fn			static void Access_vfnTime (const char *args)
+	\brief		"$TIME [seconds]": sets the local time if given and the link
+				is authorized, then replies
+				with the time, whether it is set, the weekday (0 is Monday)
+				and the slot of the day
+*/
+static void Access_vfnTime (const char *args)
+{
+	uint32_t seconds = 0;
+	uint16_t now = 0;
+
+	if (*args)
+	{
+		if (!Protocol_bfnIsAuthorized ())
+		{
+			Protocol_vfnReply ("TIME ERR auth");
+			return;
+		}
+		if (args[strspn (args, "0123456789")] || !Access_bfnDecimal (&args, &seconds))
+		{
+			Protocol_vfnReply ("TIME ERR format");
+			return;
+		}
+		Access_vfnSetTime (seconds);
+	}
+	now = slot;
+	Protocol_vfnReply ("TIME s=%u set=%u day=%u slot=%u", RTC_dwfnGetTime (),
+			(uint32_t)RTC_bfnIsSet (), (uint32_t)(now / ACCESS_DAY_SLOTS),
+			(uint32_t)(now % ACCESS_DAY_SLOTS));
+}
+
+/*!
+	\fn			static void Access_vfnUser (const char *args)
+	\brief		"$USER n pin [schedule]" stores user n, with no schedule it
+				opens at any time; "$USER n DEL" deletes it; "$USER" counts
+				the users. Changes need an authorized link.
+*/
+static void Access_vfnUser (const char *args)
+{
+	ACCESS_ERROR error = eACCESS_OK;
+	uint32_t user = 0;
+	uint32_t schedule = ACCESS_ALWAYS;
+	uint8_t pin[4];
+	uint16_t count = 0;
+	uint8_t i = 0;
+
+	if (!*args)
+	{
+		for (user = 0; user < ACCESS_USERS; user++)
+		{
+			count += (pins[user] != NO_PIN);
+		}
+		Protocol_vfnReply ("USER n=%u max=%u", (uint32_t)count, (uint32_t)ACCESS_USERS);
+		return;
+	}
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("USER ERR auth");
+		return;
+	}
+	if (!Access_bfnDecimal (&args, &user))
+	{
+		Protocol_vfnReply ("USER ERR format");
+		return;
+	}
+	if (strcmp (args, "DEL") == 0)
+	{
+		error = Access_efnDeleteUser ((uint16_t)user);
+	}
+	else
+	{
+		for (i = 0; i < 4; i++)
+		{
+			if ((args[i] < '0') || (args[i] > '9'))
+			{
+				Protocol_vfnReply ("USER ERR %s", errorNames[eACCESS_PIN]);
+				return;
+			}
+			pin[i] = (uint8_t)(args[i] - '0');
+		}
+		args += 4;
+		while (*args == ' ')
+		{
+			args++;
+		}
+		if (*args && (!Access_bfnDecimal (&args, &schedule) || *args || (schedule > ACCESS_ALWAYS)))
+		{
+			Protocol_vfnReply ("USER ERR format");
+			return;
+		}
+		error = Access_efnSetUser ((uint16_t)user, pin, (uint8_t)schedule);
+	}
+
+	if (error != eACCESS_OK)
+	{
+		Protocol_vfnReply ("USER ERR %s", errorNames[error]);
+		return;
+	}
+	Protocol_vfnReply ("USER OK");
+}
+
+/*!
+	\fn			static void Access_vfnSchedule (const char *args)
+	\brief		"$SCHED n days from to" opens schedule n on the days, given
+				as seven 0/1 from Monday, from HHMM to HHMM; the times are
+				widened to whole slots and a rule ending at or before it
+				starts runs past midnight. "$SCHED n CLR" closes every slot;
+				"$SCHED n" replies with the open slots and whether it is
+				open now. Changes need an authorized link.
+*/
+static void Access_vfnSchedule (const char *args)
+{
+	ACCESS_ERROR error = eACCESS_OK;
+	uint32_t schedule = 0;
+	uint32_t from = 0;
+	uint32_t to = 0;
+	uint8_t days = 0;
+	uint8_t startSlot = 0;
+	uint8_t endSlot = 0;
+	uint16_t open = 0;
+	uint16_t bit = 0;
+	uint8_t i = 0;
+
+	if (!Access_bfnDecimal (&args, &schedule) || (schedule >= ACCESS_SCHEDULES))
+	{
+		Protocol_vfnReply ("SCHED ERR %s", errorNames[eACCESS_INDEX]);
+		return;
+	}
+	if (!*args)
+	{
+		for (bit = 0; bit < ACCESS_WEEK_SLOTS; bit++)
+		{
+			open += (schedules[schedule][bit >> 5] >> (bit & 31u)) & 1u;
+		}
+		Protocol_vfnReply ("SCHED %u open=%u now=%u", schedule, (uint32_t)open,
+				(uint32_t)Access_bfnIsOpen ((uint8_t)schedule));
+		return;
+	}
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("SCHED ERR auth");
+		return;
+	}
+	if (strcmp (args, "CLR") == 0)
+	{
+		error = Access_efnClearSchedule ((uint8_t)schedule);
+	}
+	else
+	{
+		for (i = 0; i < 7; i++)
+		{
+			if (args[i] == '1')
+			{
+				days |= (uint8_t)(1u << i);
+			}
+			else if (args[i] != '0')
+			{
+				Protocol_vfnReply ("SCHED ERR format");
+				return;
+			}
+		}
+		args += 7;
+		while (*args == ' ')
+		{
+			args++;
+		}
+		if (!Access_bfnDecimal (&args, &from) || !Access_bfnDecimal (&args, &to) || *args)
+		{
+			Protocol_vfnReply ("SCHED ERR format");
+			return;
+		}
+		error = eACCESS_TIME;
+		if (Access_bfnSlot (from, 0, &startSlot) && Access_bfnSlot (to, 1, &endSlot))
+		{
+			error = Access_efnAddRule ((uint8_t)schedule, days, startSlot, endSlot);
+		}
+	}
+
+	if (error != eACCESS_OK)
+	{
+		Protocol_vfnReply ("SCHED ERR %s", errorNames[error]);
+		return;
+	}
+	Protocol_vfnReply ("SCHED OK");
+}
+
+/*!
+	\fn			static void Access_vfnOtp (const char *args)
+	\brief		"$OTP KEY hex" appends up to 20 bytes to the secret of the
+				next generator, or replies OTP ERR busy if the pool has no
+				block for a new secret; "$OTP CLR" drops it; "$OTP n kind [schedule]"
+				gives user n a generator with it, kind H1, H256, T1 or T256
+				for HOTP or TOTP over SHA-1 or SHA-256. "$OTP ZONE [-]minutes"
+				sets the offset of local time from UTC for TOTP. "$OTP"
+				counts the generators, "$OTP STATS" replies how codes were
+				checked and the wrong codes in a row, and "$OTP n" with the
+				state of the generator of n. All but these queries need an
+				authorized link.
+*/
+static void Access_vfnOtp (const char *args)
+{
+	OTP_STATS stats;
+	uint32_t value = 0;
+	uint32_t counter = 0;
+	uint16_t count = 0;
+	uint8_t ready = 0;
+	uint8_t kind = 0;
+	uint8_t slot = 0;
+	uint8_t isNegative = 0;
+	char c;
+
+	if (!*args)
+	{
+		for (slot = 0; slot < OTP_SLOTS; slot++)
+		{
+			count += (otpUsers[slot] != NO_USER);
+		}
+		Protocol_vfnReply ("OTP n=%u max=%u zone=%s%u", (uint32_t)count, (uint32_t)OTP_SLOTS,
+				(zoneMinutes < 0) ? "-" : "", (uint32_t)((zoneMinutes < 0) ? -zoneMinutes : zoneMinutes));
+		return;
+	}
+	if (strcmp (args, "STATS") == 0)
+	{
+		Otp_vfnGetStats (&stats);
+		Protocol_vfnReply ("OTP lookups=%u refills=%u ok=%u miss=%u", stats.lookups, stats.refills,
+				stats.accepted, (uint32_t)otpMisses);
+		return;
+	}
+	if (args[strspn (args, "0123456789")] && !Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("OTP ERR auth");
+		return;
+	}
+	if (strcmp (args, "CLR") == 0)
+	{
+		Access_vfnWipeSecret ();
+		Protocol_vfnReply ("OTP OK");
+		return;
+	}
+	if (strncmp (args, "KEY ", 4) == 0)
+	{
+		if (!otpSecret && !(otpSecret = Pool_pvfnAlloc (OTP_SECRET_MAX)))
+		{
+			Protocol_vfnReply ("OTP ERR busy");
+			return;
+		}
+		for (args += 4; *args; args++, count++)
+		{
+			c = *args;
+			if ((c >= '0') && (c <= '9'))
+			{
+				value = (value << 4) | (uint32_t)(c - '0');
+			}
+			else if ((c >= 'a') && (c <= 'f'))
+			{
+				value = (value << 4) | (uint32_t)(c - 'a' + 10);
+			}
+			else if ((c >= 'A') && (c <= 'F'))
+			{
+				value = (value << 4) | (uint32_t)(c - 'A' + 10);
+			}
+			else
+			{
+				break;
+			}
+			if ((count & 1u) && (otpSecretLength < OTP_SECRET_MAX))
+			{
+				otpSecret[otpSecretLength++] = (uint8_t)value;
+			}
+			else if (count & 1u)
+			{
+				Access_vfnWipeSecret ();
+				Protocol_vfnReply ("OTP ERR key");
+				return;
+			}
+		}
+		if (*args || !count || (count & 1u))
+		{
+			Access_vfnWipeSecret ();
+			Protocol_vfnReply ("OTP ERR format");
+			return;
+		}
+		Protocol_vfnReply ("OTP KEY %u", (uint32_t)otpSecretLength);
+		return;
+	}
+	if (strncmp (args, "ZONE ", 5) == 0)
+	{
+		args += 5;
+		if (*args == '-')
+		{
+			isNegative = 1;
+			args++;
+		}
+		if (!Access_bfnDecimal (&args, &value) || *args || (value > ZONE_MAX_MINUTES))
+		{
+			Protocol_vfnReply ("OTP ERR format");
+			return;
+		}
+		zoneMinutes = isNegative ? -(int32_t)value : (int32_t)value;
+		Otp_vfnSetZone (zoneMinutes);
+		Protocol_vfnReply ("OTP OK");
+		return;
+	}
+
+	if (!Access_bfnDecimal (&args, &value) || (value >= ACCESS_USERS))
+	{
+		Protocol_vfnReply ("OTP ERR %s", errorNames[eACCESS_INDEX]);
+		return;
+	}
+	if (*args)
+	{
+		Access_vfnOtpUser (value, args);
+		return;
+	}
+	if (!IS_OTP_PIN (pins[value]))
+	{
+		Protocol_vfnReply ("OTP ERR %s", errorNames[eACCESS_INDEX]);
+		return;
+	}
+	kind = Otp_bfnGetSlot ((uint8_t)pins[value], &counter, &ready);
+	Protocol_vfnReply ("OTP %u %s counter=%u ready=%u", value, otpKindNames[kind], counter, (uint32_t)ready);
+}
+
+/*!
+	\fn			static void Access_vfnOtpUser (uint32_t user, const char *args)
+	\param		args	Kind and schedule of "$OTP n kind [schedule]"
+	\brief		Gives the user a generator with the secret uploaded and
+				clears the secret, whether it was taken or not
+*/
+static void Access_vfnOtpUser (uint32_t user, const char *args)
+{
+	ACCESS_ERROR error = eACCESS_OK;
+	uint32_t schedule = ACCESS_ALWAYS;
+	uint8_t kind = 0;
+	uint8_t length = 0;
+
+	for (kind = 0; kind < eOTP_KINDS; kind++)
+	{
+		length = (uint8_t)strlen (otpKindNames[kind]);
+		if ((strncmp (args, otpKindNames[kind], length) == 0) && ((args[length] == ' ') || !args[length]))
+		{
+			break;
+		}
+	}
+	if (kind == eOTP_KINDS)
+	{
+		Protocol_vfnReply ("OTP ERR format");
+		return;
+	}
+	args += length;
+	while (*args == ' ')
+	{
+		args++;
+	}
+	if (*args && (!Access_bfnDecimal (&args, &schedule) || *args || (schedule > ACCESS_ALWAYS)))
+	{
+		Protocol_vfnReply ("OTP ERR format");
+		return;
+	}
+	if (!otpSecretLength)
+	{
+		Protocol_vfnReply ("OTP ERR key");
+		return;
+	}
+
+	error = Access_efnSetOtpUser ((uint16_t)user, (OTP_KIND)kind, otpSecret, otpSecretLength, (uint8_t)schedule);
+	Access_vfnWipeSecret ();
+	if (error != eACCESS_OK)
+	{
+		Protocol_vfnReply ("OTP ERR %s", errorNames[error]);
+		return;
+	}
+	Protocol_vfnReply ("OTP OK");
+}
+
+/*!
+	\fn			static void Access_vfnFree (uint16_t user)
+	\brief		Frees the generator of a user, if it has one
+*/
+static void Access_vfnFree (uint16_t user)
+{
+	uint8_t slot = (uint8_t)pins[user];
+
+	if (IS_OTP_PIN (pins[user]))
+	{
+		Otp_vfnRemove (slot);
+		otpUsers[slot] = NO_USER;
+	}
+}
+
+/*!
+	\fn			static void Access_vfnOtpMiss (void)
+	\brief		Counts a wrong code and, from ACCESS_OTP_TRIES on, locks the
+				codes out from now, twice as long as the last time
+*/
+static void Access_vfnOtpMiss (void)
+{
+	uint8_t doublings = 0;
+
+	if (otpMisses < 0xFFu)
+	{
+		otpMisses++;
+	}
+	if (otpMisses < ACCESS_OTP_TRIES)
+	{
+		return;
+	}
+	doublings = (uint8_t)(otpMisses - ACCESS_OTP_TRIES);
+	if (doublings > ACCESS_OTP_DOUBLINGS)
+	{
+		doublings = ACCESS_OTP_DOUBLINGS;
+	}
+	otpLockedAt = Timebase_dwfnGetMs ();
+	otpLockoutMs = ACCESS_OTP_LOCKOUT_MS << doublings;
+}
+
+/*!
+	\fn			static void Access_vfnWipeSecret (void)
+	\brief		Clears the secret uploaded through a volatile pointer, which
+				the compiler may not drop as a dead store, and returns its
+				block to the pool
+*/
+static void Access_vfnWipeSecret (void)
+{
+	volatile uint8_t *bytes = otpSecret;
+	uint8_t i;
+
+	if (!bytes)
+	{
+		return;
+	}
+	for (i = 0; i < OTP_SECRET_MAX; i++)
+	{
+		bytes[i] = 0;
+	}
+	Pool_vfnFree (otpSecret);
+	otpSecret = 0;
+	otpSecretLength = 0;
+}
+
+/*!
+	\fn			static uint8_t Access_bfnDecimal (const char **text, uint32_t *value)
+	\param		text	Points past the number and its spaces on return
+	\return		Returns 1 if a decimal number that fits 32 bits was read;
+				else, returns 0
+*/
+static uint8_t Access_bfnDecimal (const char **text, uint32_t *value)
+{
+	const char *p = *text;
+	uint64_t number = 0;
+	uint8_t digits = 0;
+
+	for (; (*p >= '0') && (*p <= '9'); p++, digits++)
+	{
+		number = (number * 10u) + (uint32_t)(*p - '0');
+	}
+	if ((digits == 0) || (digits > 10) || (number > 0xFFFFFFFFu))
+	{
+		return 0;
+	}
+	while (*p == ' ')
+	{
+		p++;
+	}
+	*text = p;
+	*value = (uint32_t)number;
+	return 1;
+}
+
+/*!
+	\fn			static uint8_t Access_bfnSlot (uint32_t hhmm, uint8_t roundUp, uint8_t *slotOut)
+	\param		hhmm		Time of day as HHMM, 2400 for the end of the day
+	\param		roundUp		1 to take the slot the time is in the end of
+	\return		Returns 1 if the time is valid
+*/
+static uint8_t Access_bfnSlot (uint32_t hhmm, uint8_t roundUp, uint8_t *slotOut)
+{
+	uint32_t hours = hhmm / 100u;
+	uint32_t minutes = hhmm % 100u;
+
+	if ((minutes >= 60u) || (hours > 24u) || ((hours == 24u) && minutes))
+	{
+		return 0;
+	}
+	minutes += hours * 60u;
+	if (roundUp)
+	{
+		minutes += SLOT_MINUTES - 1u;
+	}
+	*slotOut = (uint8_t)(minutes / SLOT_MINUTES);
+	return 1;
+}
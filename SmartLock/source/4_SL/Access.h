@@ -0,0 +1,104 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Access.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the access schedules. Every user has
+				a pin and a schedule; a schedule is compiled when it is
+				uploaded into a bitmap with one bit per 15 minute slot of
+				the week, so checking a pin against the time of day is a
+				lookup and a single bit test. A user can have a HOTP or
+				TOTP generator instead of a fixed pin.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_ACCESS_H_
+#define _4_SL_ACCESS_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Otp.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		ACCESS_USERS
+	\brief		Entries of the user table
+	\def		ACCESS_SCHEDULES
+	\brief		Schedules shared by the users, 84 bytes each. The benchmark
+				build fills a larger table to time the worst case.
+*/
+#if defined(BENCHMARK_BUILD) || defined(HOST_SIMULATION)
+#define		ACCESS_USERS		256u
+#define		ACCESS_SCHEDULES	32u
+#else
+#define		ACCESS_USERS		64u
+#define		ACCESS_SCHEDULES	8u
+#endif
+
+/*!
+	\def		ACCESS_ALWAYS
+	\brief		Schedule of a user with no time restriction
+*/
+#define		ACCESS_ALWAYS		0xFFu
+
+/*!
+	\def		ACCESS_SLOT_SECONDS
+	\brief		Length of a slot
+*/
+#define		ACCESS_SLOT_SECONDS	900u
+
+/*!
+	\def		ACCESS_DAY_SLOTS
+	\brief		Slots of a day
+*/
+#define		ACCESS_DAY_SLOTS	96u
+
+/*!
+	\def		ACCESS_WEEK_SLOTS
+	\brief		Slots of a week, Monday 00:00 first
+*/
+#define		ACCESS_WEEK_SLOTS	(7u * ACCESS_DAY_SLOTS)
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		ACCESS_ERROR
+	\brief		Reasons a table change is refused
+*/
+typedef enum
+{
+	eACCESS_OK,
+	eACCESS_INDEX,		/* no such user or schedule */
+	eACCESS_PIN,		/* not four digits */
+	eACCESS_DUPLICATE,	/* pin of another user */
+	eACCESS_TIME,		/* day mask or slot out of range */
+	eACCESS_FULL,		/* no code generator slot free */
+	eACCESS_ERRORS
+} ACCESS_ERROR;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Access_vfnInit (void);
+
+void Access_vfnSetTime (uint32_t seconds);
+
+ACCESS_ERROR Access_efnSetUser (uint16_t user, const uint8_t *pin, uint8_t schedule);
+
+ACCESS_ERROR Access_efnSetOtpUser (uint16_t user, OTP_KIND kind, const uint8_t *secret,
+		uint8_t length, uint8_t schedule);
+
+ACCESS_ERROR Access_efnDeleteUser (uint16_t user);
+
+ACCESS_ERROR Access_efnAddRule (uint8_t schedule, uint8_t days, uint8_t startSlot, uint8_t endSlot);
+
+ACCESS_ERROR Access_efnClearSchedule (uint8_t schedule);
+
+uint8_t Access_bfnAuthorize (const uint8_t *digits, uint8_t length);
+
+uint8_t Access_bfnIsOpen (uint8_t schedule);
+
+#endif /* _4_SL_ACCESS_H_ */
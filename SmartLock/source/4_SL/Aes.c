@@ -0,0 +1,410 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Aes.c
+	\date		October 19th, 2026
+	\brief		Function implementation of AES-128 and CCM, sized for the
+				Cortex-M0+: one 1 KB round table instead of the usual four,
+				the other three are the same table rotated, and the M0+ has
+				a single-cycle rotate. A column is a little-endian word, so
+				a state byte is a shift and a mask away and no byte swaps
+				are needed on load and store.
+				The tables sit in flash, which has no cache to leak the
+				lookups through timing; every index depends on the key, so
+				the cipher is not hardened against an attacker who can
+				time single blocks with the probe on the board.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "Aes.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		ROR
+	\brief		Rotates a word right; compiles to a single instruction
+*/
+#define		ROR(x, n)			(((x) >> (n)) | ((x) << (32u - (n))))
+
+/*!
+	\def		CCM_FLAGS_MAC
+	\brief		Flags of the first CBC-MAC block: 8-byte tag, 2-byte length
+*/
+#define		CCM_FLAGS_MAC		((((AES_CCM_TAG - 2u) / 2u) << 3) | (15u - AES_CCM_NONCE - 1u))
+
+/*!
+	\def		CCM_FLAGS_CTR
+	\brief		Flags of the counter blocks
+*/
+#define		CCM_FLAGS_CTR		(15u - AES_CCM_NONCE - 1u)
+
+/*!
+	\def		CCM_FLAGS_AAD
+	\brief		Flag set in the first CBC-MAC block when there is AAD
+*/
+#define		CCM_FLAGS_AAD		0x40u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		sbox
+	\brief		SubBytes, for the key schedule and the last round
+*/
+static const uint8_t sbox[256] =
+{
+		0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+		0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+		0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+		0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+		0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+		0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+		0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+		0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+		0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+		0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+		0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+		0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+		0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+		0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+		0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+		0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+/*!
+	\var		te0
+	\brief		SubBytes and MixColumns of a row 0 byte: bytes 2s, s, s, 3s
+				from the low end. Rows 1 to 3 use it rotated left by 8, 16
+				and 24 bits.
+*/
+static const uint32_t te0[256] =
+{
+		0xA56363C6u, 0x847C7CF8u, 0x997777EEu, 0x8D7B7BF6u, 0x0DF2F2FFu, 0xBD6B6BD6u, 0xB16F6FDEu, 0x54C5C591u,
+		0x50303060u, 0x03010102u, 0xA96767CEu, 0x7D2B2B56u, 0x19FEFEE7u, 0x62D7D7B5u, 0xE6ABAB4Du, 0x9A7676ECu,
+		0x45CACA8Fu, 0x9D82821Fu, 0x40C9C989u, 0x877D7DFAu, 0x15FAFAEFu, 0xEB5959B2u, 0xC947478Eu, 0x0BF0F0FBu,
+		0xECADAD41u, 0x67D4D4B3u, 0xFDA2A25Fu, 0xEAAFAF45u, 0xBF9C9C23u, 0xF7A4A453u, 0x967272E4u, 0x5BC0C09Bu,
+		0xC2B7B775u, 0x1CFDFDE1u, 0xAE93933Du, 0x6A26264Cu, 0x5A36366Cu, 0x413F3F7Eu, 0x02F7F7F5u, 0x4FCCCC83u,
+		0x5C343468u, 0xF4A5A551u, 0x34E5E5D1u, 0x08F1F1F9u, 0x937171E2u, 0x73D8D8ABu, 0x53313162u, 0x3F15152Au,
+		0x0C040408u, 0x52C7C795u, 0x65232346u, 0x5EC3C39Du, 0x28181830u, 0xA1969637u, 0x0F05050Au, 0xB59A9A2Fu,
+		0x0907070Eu, 0x36121224u, 0x9B80801Bu, 0x3DE2E2DFu, 0x26EBEBCDu, 0x6927274Eu, 0xCDB2B27Fu, 0x9F7575EAu,
+		0x1B090912u, 0x9E83831Du, 0x742C2C58u, 0x2E1A1A34u, 0x2D1B1B36u, 0xB26E6EDCu, 0xEE5A5AB4u, 0xFBA0A05Bu,
+		0xF65252A4u, 0x4D3B3B76u, 0x61D6D6B7u, 0xCEB3B37Du, 0x7B292952u, 0x3EE3E3DDu, 0x712F2F5Eu, 0x97848413u,
+		0xF55353A6u, 0x68D1D1B9u, 0x00000000u, 0x2CEDEDC1u, 0x60202040u, 0x1FFCFCE3u, 0xC8B1B179u, 0xED5B5BB6u,
+		0xBE6A6AD4u, 0x46CBCB8Du, 0xD9BEBE67u, 0x4B393972u, 0xDE4A4A94u, 0xD44C4C98u, 0xE85858B0u, 0x4ACFCF85u,
+		0x6BD0D0BBu, 0x2AEFEFC5u, 0xE5AAAA4Fu, 0x16FBFBEDu, 0xC5434386u, 0xD74D4D9Au, 0x55333366u, 0x94858511u,
+		0xCF45458Au, 0x10F9F9E9u, 0x06020204u, 0x817F7FFEu, 0xF05050A0u, 0x443C3C78u, 0xBA9F9F25u, 0xE3A8A84Bu,
+		0xF35151A2u, 0xFEA3A35Du, 0xC0404080u, 0x8A8F8F05u, 0xAD92923Fu, 0xBC9D9D21u, 0x48383870u, 0x04F5F5F1u,
+		0xDFBCBC63u, 0xC1B6B677u, 0x75DADAAFu, 0x63212142u, 0x30101020u, 0x1AFFFFE5u, 0x0EF3F3FDu, 0x6DD2D2BFu,
+		0x4CCDCD81u, 0x140C0C18u, 0x35131326u, 0x2FECECC3u, 0xE15F5FBEu, 0xA2979735u, 0xCC444488u, 0x3917172Eu,
+		0x57C4C493u, 0xF2A7A755u, 0x827E7EFCu, 0x473D3D7Au, 0xAC6464C8u, 0xE75D5DBAu, 0x2B191932u, 0x957373E6u,
+		0xA06060C0u, 0x98818119u, 0xD14F4F9Eu, 0x7FDCDCA3u, 0x66222244u, 0x7E2A2A54u, 0xAB90903Bu, 0x8388880Bu,
+		0xCA46468Cu, 0x29EEEEC7u, 0xD3B8B86Bu, 0x3C141428u, 0x79DEDEA7u, 0xE25E5EBCu, 0x1D0B0B16u, 0x76DBDBADu,
+		0x3BE0E0DBu, 0x56323264u, 0x4E3A3A74u, 0x1E0A0A14u, 0xDB494992u, 0x0A06060Cu, 0x6C242448u, 0xE45C5CB8u,
+		0x5DC2C29Fu, 0x6ED3D3BDu, 0xEFACAC43u, 0xA66262C4u, 0xA8919139u, 0xA4959531u, 0x37E4E4D3u, 0x8B7979F2u,
+		0x32E7E7D5u, 0x43C8C88Bu, 0x5937376Eu, 0xB76D6DDAu, 0x8C8D8D01u, 0x64D5D5B1u, 0xD24E4E9Cu, 0xE0A9A949u,
+		0xB46C6CD8u, 0xFA5656ACu, 0x07F4F4F3u, 0x25EAEACFu, 0xAF6565CAu, 0x8E7A7AF4u, 0xE9AEAE47u, 0x18080810u,
+		0xD5BABA6Fu, 0x887878F0u, 0x6F25254Au, 0x722E2E5Cu, 0x241C1C38u, 0xF1A6A657u, 0xC7B4B473u, 0x51C6C697u,
+		0x23E8E8CBu, 0x7CDDDDA1u, 0x9C7474E8u, 0x211F1F3Eu, 0xDD4B4B96u, 0xDCBDBD61u, 0x868B8B0Du, 0x858A8A0Fu,
+		0x907070E0u, 0x423E3E7Cu, 0xC4B5B571u, 0xAA6666CCu, 0xD8484890u, 0x05030306u, 0x01F6F6F7u, 0x120E0E1Cu,
+		0xA36161C2u, 0x5F35356Au, 0xF95757AEu, 0xD0B9B969u, 0x91868617u, 0x58C1C199u, 0x271D1D3Au, 0xB99E9E27u,
+		0x38E1E1D9u, 0x13F8F8EBu, 0xB398982Bu, 0x33111122u, 0xBB6969D2u, 0x70D9D9A9u, 0x898E8E07u, 0xA7949433u,
+		0xB69B9B2Du, 0x221E1E3Cu, 0x92878715u, 0x20E9E9C9u, 0x49CECE87u, 0xFF5555AAu, 0x78282850u, 0x7ADFDFA5u,
+		0x8F8C8C03u, 0xF8A1A159u, 0x80898909u, 0x170D0D1Au, 0xDABFBF65u, 0x31E6E6D7u, 0xC6424284u, 0xB86868D0u,
+		0xC3414182u, 0xB0999929u, 0x772D2D5Au, 0x110F0F1Eu, 0xCBB0B07Bu, 0xFC5454A8u, 0xD6BBBB6Du, 0x3A16162Cu
+};
+
+/*!
+	\var		rcon
+	\brief		Round constants of the key schedule
+*/
+static const uint8_t rcon[AES_ROUNDS] =
+{
+	0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40, 0x80, 0x1B, 0x36
+};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Aes_vfnCcmMac (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, uint8_t *mac);
+static void Aes_vfnCcmCtr (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *mac);
+static void Aes_vfnAbsorb (const AES_CONTEXT *context, uint8_t *mac,
+		uint8_t *fill, const uint8_t *data, uint16_t length);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Aes_vfnSetKey (AES_CONTEXT *context, const uint8_t *key)
+	\param		context	Receives the expanded key
+	\param		key		AES_BLOCK bytes of key
+*/
+void Aes_vfnSetKey (AES_CONTEXT *context, const uint8_t *key)
+{
+	uint32_t *rk = context->roundKeys;
+	uint32_t word;
+	uint8_t i;
+
+	for (i = 0; i < 4u; i++)
+	{
+		rk[i] = (uint32_t)key[4u * i] | ((uint32_t)key[4u * i + 1u] << 8) |
+				((uint32_t)key[4u * i + 2u] << 16) | ((uint32_t)key[4u * i + 3u] << 24);
+	}
+	for (i = 0; i < AES_ROUNDS; i++, rk += 4)
+	{
+		/* RotWord is a rotate by one byte of the little-endian word */
+		word = rk[3];
+		word = (uint32_t)sbox[(word >> 8) & 0xFFu] |
+				((uint32_t)sbox[(word >> 16) & 0xFFu] << 8) |
+				((uint32_t)sbox[word >> 24] << 16) |
+				((uint32_t)sbox[word & 0xFFu] << 24);
+		rk[4] = rk[0] ^ word ^ rcon[i];
+		rk[5] = rk[1] ^ rk[4];
+		rk[6] = rk[2] ^ rk[5];
+		rk[7] = rk[3] ^ rk[6];
+	}
+}
+
+/*!
+	\fn			void Aes_vfnEncrypt (const AES_CONTEXT *context, const uint8_t *in, uint8_t *out)
+	\param		context	Expanded key
+	\param		in		Block to encrypt
+	\param		out		Receives the encrypted block; may be in
+	\brief		Output column c of a round takes row r from input column
+				c + r (ShiftRows), so each column is four table lookups
+*/
+RAMFUNC_HOT void Aes_vfnEncrypt (const AES_CONTEXT *context, const uint8_t *in, uint8_t *out)
+{
+	const uint32_t *rk = context->roundKeys;
+	uint32_t s0, s1, s2, s3;
+	uint32_t t0, t1, t2, t3;
+	uint8_t round;
+
+	s0 = ((uint32_t)in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) | ((uint32_t)in[3] << 24)) ^ rk[0];
+	s1 = ((uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24)) ^ rk[1];
+	s2 = ((uint32_t)in[8] | ((uint32_t)in[9] << 8) | ((uint32_t)in[10] << 16) | ((uint32_t)in[11] << 24)) ^ rk[2];
+	s3 = ((uint32_t)in[12] | ((uint32_t)in[13] << 8) | ((uint32_t)in[14] << 16) | ((uint32_t)in[15] << 24)) ^ rk[3];
+
+	for (round = 1; round < AES_ROUNDS; round++)
+	{
+		rk += 4;
+		t0 = te0[s0 & 0xFFu] ^ ROR (te0[(s1 >> 8) & 0xFFu], 24) ^
+				ROR (te0[(s2 >> 16) & 0xFFu], 16) ^ ROR (te0[s3 >> 24], 8) ^ rk[0];
+		t1 = te0[s1 & 0xFFu] ^ ROR (te0[(s2 >> 8) & 0xFFu], 24) ^
+				ROR (te0[(s3 >> 16) & 0xFFu], 16) ^ ROR (te0[s0 >> 24], 8) ^ rk[1];
+		t2 = te0[s2 & 0xFFu] ^ ROR (te0[(s3 >> 8) & 0xFFu], 24) ^
+				ROR (te0[(s0 >> 16) & 0xFFu], 16) ^ ROR (te0[s1 >> 24], 8) ^ rk[2];
+		t3 = te0[s3 & 0xFFu] ^ ROR (te0[(s0 >> 8) & 0xFFu], 24) ^
+				ROR (te0[(s1 >> 16) & 0xFFu], 16) ^ ROR (te0[s2 >> 24], 8) ^ rk[3];
+		s0 = t0;
+		s1 = t1;
+		s2 = t2;
+		s3 = t3;
+	}
+
+	/* The last round has no MixColumns */
+	rk += 4;
+	t0 = ((uint32_t)sbox[s0 & 0xFFu] | ((uint32_t)sbox[(s1 >> 8) & 0xFFu] << 8) |
+			((uint32_t)sbox[(s2 >> 16) & 0xFFu] << 16) | ((uint32_t)sbox[s3 >> 24] << 24)) ^ rk[0];
+	t1 = ((uint32_t)sbox[s1 & 0xFFu] | ((uint32_t)sbox[(s2 >> 8) & 0xFFu] << 8) |
+			((uint32_t)sbox[(s3 >> 16) & 0xFFu] << 16) | ((uint32_t)sbox[s0 >> 24] << 24)) ^ rk[1];
+	t2 = ((uint32_t)sbox[s2 & 0xFFu] | ((uint32_t)sbox[(s3 >> 8) & 0xFFu] << 8) |
+			((uint32_t)sbox[(s0 >> 16) & 0xFFu] << 16) | ((uint32_t)sbox[s1 >> 24] << 24)) ^ rk[2];
+	t3 = ((uint32_t)sbox[s3 & 0xFFu] | ((uint32_t)sbox[(s0 >> 8) & 0xFFu] << 8) |
+			((uint32_t)sbox[(s1 >> 16) & 0xFFu] << 16) | ((uint32_t)sbox[s2 >> 24] << 24)) ^ rk[3];
+
+	out[0] = (uint8_t)t0;	out[1] = (uint8_t)(t0 >> 8);	out[2] = (uint8_t)(t0 >> 16);	out[3] = (uint8_t)(t0 >> 24);
+	out[4] = (uint8_t)t1;	out[5] = (uint8_t)(t1 >> 8);	out[6] = (uint8_t)(t1 >> 16);	out[7] = (uint8_t)(t1 >> 24);
+	out[8] = (uint8_t)t2;	out[9] = (uint8_t)(t2 >> 8);	out[10] = (uint8_t)(t2 >> 16);	out[11] = (uint8_t)(t2 >> 24);
+	out[12] = (uint8_t)t3;	out[13] = (uint8_t)(t3 >> 8);	out[14] = (uint8_t)(t3 >> 16);	out[15] = (uint8_t)(t3 >> 24);
+}
+
+/*!
+	\fn			void Aes_vfnCcmSeal (const AES_CONTEXT *context, const uint8_t *nonce,
+					const uint8_t *aad, uint16_t aadLength,
+					const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *tag)
+	\param		context		Expanded key
+	\param		nonce		AES_CCM_NONCE bytes, never used twice with a key
+	\param		aad			Data authenticated but not encrypted
+	\param		aadLength	Bytes of aad, 0 for none
+	\param		in			Message
+	\param		length		Bytes of the message
+	\param		out			Receives the encrypted message; may be in
+	\param		tag			Receives AES_CCM_TAG bytes of tag
+*/
+void Aes_vfnCcmSeal (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *tag)
+{
+	uint8_t mac[AES_BLOCK];
+	uint8_t i;
+
+	Aes_vfnCcmMac (context, nonce, aad, aadLength, in, length, mac);
+	Aes_vfnCcmCtr (context, nonce, in, length, out, mac);
+	for (i = 0; i < AES_CCM_TAG; i++)
+	{
+		tag[i] = mac[i];
+	}
+}
+
+/*!
+	\fn			uint8_t Aes_bfnCcmOpen (const AES_CONTEXT *context, const uint8_t *nonce,
+					const uint8_t *aad, uint16_t aadLength,
+					const uint8_t *in, uint16_t length, const uint8_t *tag, uint8_t *out)
+	\param		context		Expanded key
+	\param		nonce		AES_CCM_NONCE bytes the message was sealed with
+	\param		aad			Data authenticated but not encrypted
+	\param		aadLength	Bytes of aad, 0 for none
+	\param		in			Encrypted message
+	\param		length		Bytes of the message
+	\param		tag			AES_CCM_TAG bytes of tag received with it
+	\param		out			Receives the message, zeroed if it is refused;
+							may be in
+	\return		Returns 1 if the tag matches; else, returns 0
+	\brief		The tag is compared in constant time, so a forger learns
+				nothing from how long a refusal takes
+*/
+uint8_t Aes_bfnCcmOpen (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, const uint8_t *tag, uint8_t *out)
+{
+	uint8_t mac[AES_BLOCK];
+	uint8_t check[AES_BLOCK];
+	uint8_t difference = 0;
+	uint16_t i;
+
+	/* The counter mode also encrypts the tag, so the MAC of the plain text
+	 * is recovered by running it over the received tag */
+	for (i = 0; i < AES_CCM_TAG; i++)
+	{
+		mac[i] = tag[i];
+	}
+	Aes_vfnCcmCtr (context, nonce, in, length, out, mac);
+	Aes_vfnCcmMac (context, nonce, aad, aadLength, out, length, check);
+	for (i = 0; i < AES_CCM_TAG; i++)
+	{
+		difference |= (uint8_t)(mac[i] ^ check[i]);
+	}
+	if (difference)
+	{
+		for (i = 0; i < length; i++)
+		{
+			out[i] = 0;
+		}
+		return 0;
+	}
+	return 1;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Aes_vfnCcmMac (const AES_CONTEXT *context, const uint8_t *nonce,
+					const uint8_t *aad, uint16_t aadLength,
+					const uint8_t *in, uint16_t length, uint8_t *mac)
+	\param		mac		Receives the CBC-MAC of the length block, the AAD
+						and the message
+*/
+static void Aes_vfnCcmMac (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, uint8_t *mac)
+{
+	uint8_t header[2];
+	uint8_t fill = 0;
+	uint8_t i;
+
+	mac[0] = (uint8_t)(CCM_FLAGS_MAC | (aadLength ? CCM_FLAGS_AAD : 0u));
+	for (i = 0; i < AES_CCM_NONCE; i++)
+	{
+		mac[1u + i] = nonce[i];
+	}
+	mac[14] = (uint8_t)(length >> 8);
+	mac[15] = (uint8_t)length;
+	Aes_vfnEncrypt (context, mac, mac);
+
+	if (aadLength)
+	{
+		header[0] = (uint8_t)(aadLength >> 8);
+		header[1] = (uint8_t)aadLength;
+		Aes_vfnAbsorb (context, mac, &fill, header, 2);
+		Aes_vfnAbsorb (context, mac, &fill, aad, aadLength);
+		if (fill)
+		{
+			Aes_vfnEncrypt (context, mac, mac);
+			fill = 0;
+		}
+	}
+	Aes_vfnAbsorb (context, mac, &fill, in, length);
+	if (fill)
+	{
+		Aes_vfnEncrypt (context, mac, mac);
+	}
+}
+
+/*!
+	\fn			static void Aes_vfnCcmCtr (const AES_CONTEXT *context, const uint8_t *nonce,
+					const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *mac)
+	\param		mac		Its first AES_CCM_TAG bytes are xored with key block 0
+	\brief		Counter mode: block 0 of the key stream covers the tag, the
+				message uses the blocks from 1 on
+*/
+static void Aes_vfnCcmCtr (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *mac)
+{
+	uint8_t counter[AES_BLOCK];
+	uint8_t stream[AES_BLOCK];
+	uint16_t block = 0;
+	uint16_t i;
+	uint8_t j;
+
+	counter[0] = CCM_FLAGS_CTR;
+	for (j = 0; j < AES_CCM_NONCE; j++)
+	{
+		counter[1u + j] = nonce[j];
+	}
+	counter[14] = 0;
+	counter[15] = 0;
+	Aes_vfnEncrypt (context, counter, stream);
+	for (j = 0; j < AES_CCM_TAG; j++)
+	{
+		mac[j] ^= stream[j];
+	}
+
+	for (i = 0; i < length; i++)
+	{
+		if ((i % AES_BLOCK) == 0)
+		{
+			block++;
+			counter[14] = (uint8_t)(block >> 8);
+			counter[15] = (uint8_t)block;
+			Aes_vfnEncrypt (context, counter, stream);
+		}
+		out[i] = in[i] ^ stream[i % AES_BLOCK];
+	}
+}
+
+/*!
+	\fn			static void Aes_vfnAbsorb (const AES_CONTEXT *context, uint8_t *mac,
+					uint8_t *fill, const uint8_t *data, uint16_t length)
+	\param		fill	Bytes already xored into the current block
+	\brief		Xors data into the CBC-MAC, encrypting each full block
+*/
+static void Aes_vfnAbsorb (const AES_CONTEXT *context, uint8_t *mac,
+		uint8_t *fill, const uint8_t *data, uint16_t length)
+{
+	uint16_t i;
+
+	for (i = 0; i < length; i++)
+	{
+		mac[(*fill)++] ^= data[i];
+		if (*fill == AES_BLOCK)
+		{
+			Aes_vfnEncrypt (context, mac, mac);
+			*fill = 0;
+		}
+	}
+}
@@ -0,0 +1,75 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Aes.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the AES-128 block cipher and of the
+				CCM mode (RFC 3610) built on it. Only the forward cipher is
+				needed: CCM decrypts with the same key stream it encrypts
+				with.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_AES_H_
+#define _4_SL_AES_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "RamFunc.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		AES_BLOCK
+	\brief		Bytes of a block and of a key
+*/
+#define		AES_BLOCK			16u
+
+/*!
+	\def		AES_ROUNDS
+	\brief		Rounds of AES-128
+*/
+#define		AES_ROUNDS			10u
+
+/*!
+	\def		AES_CCM_NONCE
+	\brief		Bytes of a CCM nonce; the 2 bytes left of a block count the
+				blocks, so a message is at most 65535 bytes
+*/
+#define		AES_CCM_NONCE		13u
+
+/*!
+	\def		AES_CCM_TAG
+	\brief		Bytes of a CCM authentication tag
+*/
+#define		AES_CCM_TAG			8u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		AES_CONTEXT
+	\brief		Expanded key, one little-endian word per column
+*/
+typedef struct
+{
+	uint32_t roundKeys[4u * (AES_ROUNDS + 1u)];
+} AES_CONTEXT;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Aes_vfnSetKey (AES_CONTEXT *context, const uint8_t *key);
+
+RAMFUNC_HOT void Aes_vfnEncrypt (const AES_CONTEXT *context, const uint8_t *in, uint8_t *out);
+
+void Aes_vfnCcmSeal (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, uint8_t *out, uint8_t *tag);
+
+uint8_t Aes_bfnCcmOpen (const AES_CONTEXT *context, const uint8_t *nonce,
+		const uint8_t *aad, uint16_t aadLength,
+		const uint8_t *in, uint16_t length, const uint8_t *tag, uint8_t *out);
+
+#endif /* _4_SL_AES_H_ */
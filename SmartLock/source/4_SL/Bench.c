@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Bench.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the micro-benchmark runner. On
+				target the ticks are core cycles from the SysTick timebase; the
+				host build uses a monotonic nanosecond clock instead. The
+				report is CSV so it can be compared against a baseline:
+
+					bench,iterations,total_<unit>,<unit>_per_op
+					gpio_set,1000,21000,21.00
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include "Bench.h"
+#ifdef HOST_SIMULATION
+#include <time.h>
+#else
+#include "Timebase.h"
+#endif
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+#ifdef HOST_SIMULATION
+/*!
+	\def		BENCH_UNIT
+	\brief		Unit of the reported ticks
+*/
+#define		BENCH_UNIT			"ns"
+
+/*!
+	\def		BENCH_TICK
+	\brief		One tick of the reported unit, for the throughput lines
+*/
+#define		BENCH_TICK			"ns"
+#else
+#define		BENCH_UNIT			"cycles"
+#define		BENCH_TICK			"cycle"
+#endif
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint32_t Bench_dwfnNow (void);
+static void Bench_vfnEmpty (void);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t Bench_dwfnNow (void)
+	\return		Returns the current tick count of the benchmark clock
+*/
+static uint32_t Bench_dwfnNow (void)
+{
+#ifdef HOST_SIMULATION
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (uint32_t)((uint64_t)now.tv_sec * 1000000000ull + (uint64_t)now.tv_nsec);
+#else
+	return Timebase_dwfnGetCycles ();
+#endif
+}
+
+/*!
+	\fn			static void Bench_vfnEmpty (void)
+	\brief		Empty operation used to measure the loop and call overhead
+*/
+static void Bench_vfnEmpty (void)
+{
+}
+
+/*!
+	\fn			uint32_t Bench_dwfnMeasure (BENCH_FN fn, uint32_t iterations)
+	\param		fn			Operation to time
+	\param		iterations	Number of calls per run
+	\return		Returns the ticks taken by the fastest of BENCH_RUNS runs,
+				without the cost of the loop and the call itself
+*/
+uint32_t Bench_dwfnMeasure (BENCH_FN fn, uint32_t iterations)
+{
+	volatile BENCH_FN call = fn;
+	volatile BENCH_FN empty = Bench_vfnEmpty;
+	uint32_t best = 0xFFFFFFFFu;
+	uint32_t overhead = 0xFFFFFFFFu;
+	uint32_t start;
+	uint32_t elapsed;
+	uint32_t run;
+	uint32_t i;
+
+	for (run = 0; run < BENCH_RUNS; run++)
+	{
+		start = Bench_dwfnNow ();
+		for (i = 0; i < iterations; i++)
+		{
+			empty ();
+		}
+		elapsed = Bench_dwfnNow () - start;
+		if (elapsed < overhead)
+		{
+			overhead = elapsed;
+		}
+
+		start = Bench_dwfnNow ();
+		for (i = 0; i < iterations; i++)
+		{
+			call ();
+		}
+		elapsed = Bench_dwfnNow () - start;
+		if (elapsed < best)
+		{
+			best = elapsed;
+		}
+	}
+
+	return (best > overhead) ? (best - overhead) : 0;
+}
+
+/*!
+	\fn			void Bench_vfnHeader (void)
+	\brief		Prints the CSV header naming the unit of the report
+*/
+void Bench_vfnHeader (void)
+{
+	printf ("bench,iterations,total_%s,%s_per_op\n", BENCH_UNIT, BENCH_UNIT);
+}
+
+/*!
+	\fn			void Bench_vfnRun (const BENCH_CASE *cases, uint8_t count)
+	\param		cases	Benchmark cases to run, in report order
+	\param		count	Number of cases
+	\brief		Times every case and prints one CSV line per case, after the
+				header printed by Bench_vfnHeader. The cost
+				per operation is printed with two decimals using integer math,
+				since the target printf has no float support. Cases with a
+				byte count add a comment line with their throughput, which
+				bench-compare skips:
+
+					# crc32_table: 0.125 bytes/cycle
+*/
+void Bench_vfnRun (const BENCH_CASE *cases, uint8_t count)
+{
+	uint8_t i = 0;
+	uint32_t total;
+	uint32_t perOp100;
+	uint32_t perTick1000;
+
+	for (i = 0; i < count; i++)
+	{
+		total = Bench_dwfnMeasure (cases[i].fn, cases[i].iterations);
+		perOp100 = (uint32_t)(((uint64_t)total * 100u) / cases[i].iterations);
+		printf ("%s,%lu,%lu,%lu.%02lu\n", cases[i].name,
+				(unsigned long)cases[i].iterations, (unsigned long)total,
+				(unsigned long)(perOp100 / 100u), (unsigned long)(perOp100 % 100u));
+		if (cases[i].bytes && total)
+		{
+			perTick1000 = (uint32_t)(((uint64_t)cases[i].bytes * cases[i].iterations * 1000u) / total);
+			printf ("# %s: %lu.%03lu bytes/%s\n", cases[i].name,
+					(unsigned long)(perTick1000 / 1000u), (unsigned long)(perTick1000 % 1000u),
+					BENCH_TICK);
+		}
+	}
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,58 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Bench.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the micro-benchmark runner used by the
+				benchmark build and by its host counterpart
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_BENCH_H_
+#define _4_SL_BENCH_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		BENCH_RUNS
+	\brief		Times every case is repeated; the fastest run is reported
+*/
+#define		BENCH_RUNS			5u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	BENCH_FN
+	\brief		One operation of a benchmark case
+*/
+typedef void (*BENCH_FN)(void);
+
+/*!
+	\struct		BENCH_CASE
+	\brief		Name, operation and repetitions of a benchmark case. Cases
+				that process a buffer give its size in bytes to also get their
+				throughput; the others leave it 0.
+*/
+typedef struct
+{
+	const char *name;
+	BENCH_FN fn;
+	uint32_t iterations;
+	uint32_t bytes;
+} BENCH_CASE;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+uint32_t Bench_dwfnMeasure (BENCH_FN fn, uint32_t iterations);
+
+void Bench_vfnHeader (void);
+
+void Bench_vfnRun (const BENCH_CASE *cases, uint8_t count);
+
+#endif /* _4_SL_BENCH_H_ */
@@ -0,0 +1,94 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Boot.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the boot timeline. Stamps are taken
+				from the Timebase cycle counter, which ResetISR starts before
+				the .data and .bss initialization, so every stamp is measured
+				from power-on.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include "MKL27Z644.h"
+#include "Boot.h"
+#include "Timebase.h"
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		stamps
+	\brief		Cycle stamp of every boot stage, 0 while not reached
+*/
+static uint32_t stamps[eBOOT_STAGES] = {0};
+
+/*!
+	\var		stageNames
+	\brief		Printable names of the boot stages
+*/
+static const char * const stageNames[eBOOT_STAGES] = {
+		"main",
+		"keypad",
+		"uart",
+		"indicators",
+		"control",
+		"first key"
+};
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Boot_vfnStamp (BOOT_STAGE stage)
+	\param		stage	Boot stage that was just reached
+	\brief		Stores the current cycle count for the stage. Only the first
+				time a stage is reached is recorded.
+*/
+void Boot_vfnStamp (BOOT_STAGE stage)
+{
+	if ((stage < eBOOT_STAGES) && !stamps[stage])
+	{
+		stamps[stage] = Timebase_dwfnGetCycles ();
+	}
+}
+
+/*!
+	\fn			uint32_t Boot_dwfnGetStamp (BOOT_STAGE stage)
+	\param		stage	Boot stage to query
+	\return		Returns the cycles from power-on to the stage, 0 if the stage
+				was not reached yet
+*/
+uint32_t Boot_dwfnGetStamp (BOOT_STAGE stage)
+{
+	if (stage < eBOOT_STAGES)
+	{
+		return stamps[stage];
+	}
+	else
+	{
+		return 0;
+	}
+}
+
+/*!
+	\fn			void Boot_vfnReport (void)
+	\brief		Prints the boot timeline, one line per reached stage with the
+				time since power-on
+*/
+void Boot_vfnReport (void)
+{
+	uint8_t i = 0;
+
+	printf ("boot stage,cycles,us\n");
+	for (i = 0; i < eBOOT_STAGES; i++)
+	{
+		if (stamps[i])
+		{
+			printf ("%s,%lu,%lu\n", stageNames[i], (unsigned long)stamps[i],
+					(unsigned long)Timebase_dwfnCyclesToUs (stamps[i]));
+		}
+	}
+}
+//------------------------------------------------------------------------------
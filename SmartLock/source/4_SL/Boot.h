@@ -0,0 +1,44 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Boot.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the boot timeline, which stores a
+				cycle stamp for every initialization stage
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_BOOT_H_
+#define _4_SL_BOOT_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		BOOT_STAGE
+	\brief		Stages recorded in the boot timeline, in their expected order
+*/
+typedef enum
+{
+	eBOOT_MAIN,
+	eBOOT_KEYPAD_READY,
+	eBOOT_UART_READY,
+	eBOOT_INDICATORS_READY,
+	eBOOT_CONTROL_READY,
+	eBOOT_FIRST_KEY,
+	eBOOT_STAGES
+} BOOT_STAGE;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Boot_vfnStamp (BOOT_STAGE stage);
+
+uint32_t Boot_dwfnGetStamp (BOOT_STAGE stage);
+
+void Boot_vfnReport (void);
+
+#endif /* _4_SL_BOOT_H_ */
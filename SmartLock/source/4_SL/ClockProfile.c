@@ -0,0 +1,294 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	ClockProfile.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the clock profile manager. Drivers
+				request the profile their work needs; when nobody requests
+				anything the core idles in VLPR from the 2 MHz LIRC. Every
+				switch goes through fsl_clock and fsl_smc and is followed by a
+				notification so the drivers can recompute their dividers.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "fsl_clock.h"
+#include "fsl_smc.h"
+#include "ClockProfile.h"
+#include "Timebase.h"
+#include "serviceLayer.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_LISTENERS
+	\brief		Maximum number of drivers that can be notified of a switch
+*/
+#define		MAX_LISTENERS		6
+
+/*!
+	\def		IDLE_PROFILE
+	\brief		Profile used while no driver requests a faster one
+*/
+#define		IDLE_PROFILE		eCLOCK_PROFILE_VLPR_2M
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CLOCK_PROFILE_CONFIG
+	\brief		MCG_Lite, SIM divider and power mode settings of a profile
+*/
+typedef struct
+{
+	mcglite_config_t mcg;
+	uint8_t outDiv1;
+	uint8_t outDiv4;
+	uint8_t isVlpr;
+} CLOCK_PROFILE_CONFIG;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		profiles
+	\brief		Settings of every profile. MCGIRCLK stays enabled in all of them
+				since LPUART0 and TPM2 are clocked from it.
+				- VLPR 2 MHz: core 2 MHz, bus 1 MHz, MCGIRCLK 2 MHz
+				- RUN 8 MHz: core 8 MHz, bus 8 MHz, MCGIRCLK 8 MHz
+				- RUN 48 MHz: core 48 MHz (HIRC), bus 24 MHz, MCGIRCLK 8 MHz
+*/
+static const CLOCK_PROFILE_CONFIG profiles[eCLOCK_PROFILES] = {
+		{{kMCGLITE_ClkSrcLirc, kMCGLITE_IrclkEnable, kMCGLITE_Lirc2M,
+				kMCGLITE_LircDivBy1, kMCGLITE_LircDivBy1, false}, 0, 1, 1},
+		{{kMCGLITE_ClkSrcLirc, kMCGLITE_IrclkEnable, kMCGLITE_Lirc8M,
+				kMCGLITE_LircDivBy1, kMCGLITE_LircDivBy1, false}, 0, 0, 0},
+		{{kMCGLITE_ClkSrcHirc, kMCGLITE_IrclkEnable, kMCGLITE_Lirc8M,
+				kMCGLITE_LircDivBy1, kMCGLITE_LircDivBy1, false}, 0, 1, 0}
+};
+
+/*!
+	\var		listeners
+	\brief		Drivers notified after every profile switch
+*/
+static CLOCK_LISTENER listeners[MAX_LISTENERS] = {0};
+
+/*!
+	\var		numListeners
+	\brief		Number of registered listeners
+*/
+static uint8_t numListeners = 0;
+
+/*!
+	\var		requests
+	\brief		Number of pending requests for every profile, changed from
+				the main loop and the USB interrupts alike
+*/
+static volatile uint8_t requests[eCLOCK_PROFILES] = {0};
+
+/*!
+	\var		currentProfile
+	\brief		Profile the clocks are currently configured with
+*/
+static CLOCK_PROFILE currentProfile = eCLOCK_PROFILE_RUN_8M;
+
+/*!
+	\var		irClock
+	\brief		MCGIRCLK frequency of the current profile, in Hz
+*/
+static uint32_t irClock = 0;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void ClockProfile_vfnInit (void)
+	\brief		Allows the VLP modes and configures the reset profile (8 MHz
+				LIRC) with MCGIRCLK enabled, so the drivers initialized before
+				the first switch find their clock running.
+*/
+void ClockProfile_vfnInit (void)
+{
+	SMC_SetPowerModeProtection (SMC, kSMC_AllowPowerModeVlp);
+	currentProfile = eCLOCK_PROFILES;
+	ClockProfile_bfnSwitch (eCLOCK_PROFILE_RUN_8M);
+}
+
+/*!
+	\fn			uint8_t ClockProfile_bfnRegister (CLOCK_LISTENER listener)
+	\param		listener	Function to call after every profile switch
+	\return		Returns 1 if the listener was registered; else, returns 0
+	\brief		Registers a driver to be notified of clock changes
+*/
+uint8_t ClockProfile_bfnRegister (CLOCK_LISTENER listener)
+{
+	uint8_t i = 0;
+
+	if (listener == 0)
+	{
+		return 0;
+	}
+	for (i = 0; i < numListeners; i++)
+	{
+		if (listeners[i] == listener)
+		{
+			return 1;
+		}
+	}
+	if (numListeners >= MAX_LISTENERS)
+	{
+		return 0;
+	}
+	listeners[numListeners++] = listener;
+
+	return 1;
+}
+
+/*!
+	\fn			void ClockProfile_vfnRequest (CLOCK_PROFILE profile)
+	\param		profile	Profile the caller needs until it releases it
+	\brief		Adds a request for a profile. The switch itself happens in
+				ClockProfile_vfnTask(), so this can be called from anywhere:
+				the count is changed with the interrupts masked.
+*/
+void ClockProfile_vfnRequest (CLOCK_PROFILE profile)
+{
+	uint32_t primask;
+
+	if (profile >= eCLOCK_PROFILES)
+	{
+		return;
+	}
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	if (requests[profile] < 0xFF)
+	{
+		requests[profile]++;
+	}
+	__set_PRIMASK (primask);
+}
+
+/*!
+	\fn			void ClockProfile_vfnRelease (CLOCK_PROFILE profile)
+	\param		profile	Profile previously requested by the caller
+	\brief		Removes a request made with ClockProfile_vfnRequest(), from
+				anywhere as well
+*/
+void ClockProfile_vfnRelease (CLOCK_PROFILE profile)
+{
+	uint32_t primask;
+
+	if (profile >= eCLOCK_PROFILES)
+	{
+		return;
+	}
+	primask = __get_PRIMASK ();
+	__disable_irq ();
+	if (requests[profile])
+	{
+		requests[profile]--;
+	}
+	__set_PRIMASK (primask);
+}
+
+/*!
+	\fn			void ClockProfile_vfnTask (void)
+	\brief		Switches to the fastest requested profile, or to the idle
+				profile when there are no requests. Called from the main loop.
+*/
+void ClockProfile_vfnTask (void)
+{
+	uint8_t profile = eCLOCK_PROFILES;
+	CLOCK_PROFILE target = IDLE_PROFILE;
+
+	while (profile--)
+	{
+		if (requests[profile])
+		{
+			target = (CLOCK_PROFILE)profile;
+			break;
+		}
+	}
+
+	if (target != currentProfile)
+	{
+		ClockProfile_bfnSwitch (target);
+	}
+}
+
+/*!
+	\fn			uint8_t ClockProfile_bfnSwitch (CLOCK_PROFILE profile)
+	\param		profile	Profile to switch to
+	\return		Returns 1 if the switch was successful; else, returns 0
+	\brief		Leaves VLPR if needed (the MCG_Lite can only be reconfigured
+				in RUN), applies the clock settings, enters VLPR if the profile
+				requires it and notifies every listener.
+*/
+uint8_t ClockProfile_bfnSwitch (CLOCK_PROFILE profile)
+{
+	const CLOCK_PROFILE_CONFIG *config;
+	uint8_t i = 0;
+
+	if (profile >= eCLOCK_PROFILES)
+	{
+		return 0;
+	}
+	config = &profiles[profile];
+
+	if (SMC_GetPowerModeState (SMC) == kSMC_PowerStateVlpr)
+	{
+		SMC_SetPowerModeRun (SMC);
+		while (SMC_GetPowerModeState (SMC) != kSMC_PowerStateRun)
+		{
+		}
+	}
+
+	// Safe dividers first, so no clock goes over its limit while switching
+	CLOCK_SetSimSafeDivs ();
+	if (CLOCK_SetMcgliteConfig (&config->mcg) != kStatus_Success)
+	{
+		return 0;
+	}
+	CLOCK_SetOutDiv (config->outDiv1, config->outDiv4);
+
+	if (config->isVlpr)
+	{
+		SMC_SetPowerModeVlpr (SMC);
+		while (SMC_GetPowerModeState (SMC) != kSMC_PowerStateVlpr)
+		{
+		}
+	}
+
+	SystemCoreClockUpdate ();
+	irClock = CLOCK_GetInternalRefClkFreq ();
+	currentProfile = profile;
+
+	Timebase_vfnClockChanged (SystemCoreClock);
+	Delay_vfnClockChanged (SystemCoreClock);
+	for (i = 0; i < numListeners; i++)
+	{
+		listeners[i] (SystemCoreClock, irClock);
+	}
+
+	return 1;
+}
+
+/*!
+	\fn			CLOCK_PROFILE ClockProfile_efnGetCurrent (void)
+	\return		Returns the profile the clocks are currently configured with
+*/
+CLOCK_PROFILE ClockProfile_efnGetCurrent (void)
+{
+	return currentProfile;
+}
+
+/*!
+	\fn			uint32_t ClockProfile_dwfnGetIrClock (void)
+	\return		Returns the MCGIRCLK frequency of the current profile, in Hz
+*/
+uint32_t ClockProfile_dwfnGetIrClock (void)
+{
+	return irClock;
+}
+//------------------------------------------------------------------------------
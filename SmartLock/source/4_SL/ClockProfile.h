@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	ClockProfile.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the clock profile manager, which
+				switches the core between high speed RUN and VLPR on demand
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_CLOCKPROFILE_H_
+#define _4_SL_CLOCKPROFILE_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		CLOCK_PROFILE
+	\brief		Available clock profiles, ordered from the slowest to the fastest
+*/
+typedef enum
+{
+	eCLOCK_PROFILE_VLPR_2M,
+	eCLOCK_PROFILE_RUN_8M,
+	eCLOCK_PROFILE_RUN_48M,
+	eCLOCK_PROFILES
+} CLOCK_PROFILE;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	CLOCK_LISTENER
+	\brief		Function called after every profile switch with the new core
+				clock and the new MCGIRCLK frequency, both in Hz
+*/
+typedef void (*CLOCK_LISTENER)(uint32_t coreClock, uint32_t irClock);
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void ClockProfile_vfnInit (void);
+
+uint8_t ClockProfile_bfnRegister (CLOCK_LISTENER listener);
+
+void ClockProfile_vfnRequest (CLOCK_PROFILE profile);
+
+void ClockProfile_vfnRelease (CLOCK_PROFILE profile);
+
+void ClockProfile_vfnTask (void);
+
+uint8_t ClockProfile_bfnSwitch (CLOCK_PROFILE profile);
+
+CLOCK_PROFILE ClockProfile_efnGetCurrent (void);
+
+uint32_t ClockProfile_dwfnGetIrClock (void);
+
+#endif /* _4_SL_CLOCKPROFILE_H_ */
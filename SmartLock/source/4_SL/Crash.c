@@ -0,0 +1,321 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Crash.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the crash record. The record lives
+				in the .noinit section, which ResetISR neither copies nor
+				clears; a magic word and check words tell a warm reset from a
+				power-on, when the RAM holds noise. The Cortex-M0+ has no
+				fault status registers, so the record keeps what the core
+				offers: the exception frame, EXC_RETURN, ICSR and the reset
+				cause from the RCM.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "MKL27Z644.h"
+#include "Crash.h"
+#include "Protocol.h"
+#include "Timebase.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CRASH_MAGIC
+	\brief		Marks the no-init RAM as written by this firmware
+*/
+#define		CRASH_MAGIC			0xC4A5B00Fu
+
+/*!
+	\def		CRASH_NOINIT
+	\brief		Places a variable in RAM the startup code leaves alone
+*/
+#define		CRASH_NOINIT		__attribute__((section(".noinit")))
+
+/*!
+	\def		FRAME_WORDS
+	\brief		Registers the core stacks on exception entry: r0-r3, r12, lr,
+				pc and xPSR
+*/
+#define		FRAME_WORDS			8u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CRASH_RECORD
+	\brief		Kept over resets; check covers every word before it
+*/
+typedef struct
+{
+	uint32_t magic;
+	uint32_t crashes;
+	uint32_t isValid;
+	uint32_t frame[FRAME_WORDS];
+	uint32_t sp;
+	uint32_t excReturn;
+	uint32_t icsr;
+	uint32_t trace[CRASH_TRACE_DEPTH];
+	uint32_t check;
+	uint8_t retained[eCRASH_RETAINED];
+	uint8_t retainedCheck;
+} CRASH_RECORD;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		record
+	\brief		Last crash and the retained state
+*/
+static CRASH_RECORD record CRASH_NOINIT;
+
+/*!
+	\var		trace
+	\brief		Ring of the last events, event << 24 | arg << 16 | ms
+*/
+static uint32_t trace[CRASH_TRACE_DEPTH] = {0};
+
+/*!
+	\var		traceHead
+	\brief		Next entry of the trace ring
+*/
+static uint8_t traceHead = 0;
+
+/*!
+	\var		resetCause
+	\brief		RCM_SRS1 << 8 | RCM_SRS0 of this boot
+*/
+static uint16_t resetCause = 0;
+
+/*!
+	\var		readyUs
+	\brief		Microseconds from reset until the application was ready
+*/
+static uint32_t readyUs = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint32_t Crash_dwfnCheck (void);
+static uint8_t Crash_bfnRetainedCheck (void);
+static void Crash_vfnReport (const char *args);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Crash_vfnInit (void)
+	\brief		Called first thing in main. Starts a fresh record after a
+				power-on, keeps the last one otherwise, and registers "$CRASH".
+*/
+void Crash_vfnInit (void)
+{
+	uint8_t isColdStart = 0;
+
+#ifndef HOST_SIMULATION
+	resetCause = (uint16_t)(((uint16_t)RCM->SRS1 << 8) | RCM->SRS0);
+	/* After a power-on or a brown-out the RAM holds noise */
+	isColdStart = (resetCause & (RCM_SRS0_POR_MASK | RCM_SRS0_LVD_MASK)) != 0;
+#endif
+	if (isColdStart || (record.magic != CRASH_MAGIC) || (record.check != Crash_dwfnCheck ()))
+	{
+		memset (&record, 0, sizeof (record));
+		record.magic = CRASH_MAGIC;
+		record.check = Crash_dwfnCheck ();
+	}
+	if (isColdStart || (record.retainedCheck != Crash_bfnRetainedCheck ()))
+	{
+		memset (record.retained, 0, sizeof (record.retained));
+		record.retainedCheck = Crash_bfnRetainedCheck ();
+	}
+
+	Crash_vfnTrace (eCRASH_EVENT_BOOT, (uint8_t)record.crashes);
+	Protocol_bfnRegister ("CRASH", Crash_vfnReport);
+}
+
+/*!
+	\fn			void Crash_vfnReady (void)
+	\brief		Stamps the time from reset to a working door, reported by
+				"$CRASH" as the recovery time
+*/
+void Crash_vfnReady (void)
+{
+	readyUs = Timebase_dwfnCyclesToUs (Timebase_dwfnGetCycles ());
+}
+
+/*!
+	\fn			void Crash_vfnTrace (CRASH_EVENT event, uint8_t arg)
+	\param		event	What happened
+	\param		arg		Event detail
+	\brief		Adds an event to the ring stored with a crash. Safe from
+				interrupts.
+*/
+void Crash_vfnTrace (CRASH_EVENT event, uint8_t arg)
+{
+	uint32_t primask = __get_PRIMASK ();
+
+	__disable_irq ();
+	trace[traceHead] = ((uint32_t)event << 24) | ((uint32_t)arg << 16) | (Timebase_dwfnGetMs () & 0xFFFF);
+	traceHead = (uint8_t)((traceHead + 1) % CRASH_TRACE_DEPTH);
+	__set_PRIMASK (primask);
+}
+
+/*!
+	\fn			void Crash_vfnRetain (CRASH_RETAIN item, uint8_t value)
+	\param		item	State to keep
+	\param		value	Its new value
+	\brief		Keeps a value over resets, up to the next power-on
+*/
+void Crash_vfnRetain (CRASH_RETAIN item, uint8_t value)
+{
+	if (item < eCRASH_RETAINED)
+	{
+		record.retained[item] = value;
+		record.retainedCheck = Crash_bfnRetainedCheck ();
+	}
+}
+
+/*!
+	\fn			uint8_t Crash_bfnRecall (CRASH_RETAIN item, uint8_t *value)
+	\param		item	State to read back
+	\param		value	Receives the value kept before the reset
+	\return		Returns 1 if value was read; else, the retained state is
+				damaged and returns 0 with value untouched. After a power-on
+				every value reads as 0.
+*/
+uint8_t Crash_bfnRecall (CRASH_RETAIN item, uint8_t *value)
+{
+	if ((item >= eCRASH_RETAINED) || (record.retainedCheck != Crash_bfnRetainedCheck ()))
+	{
+		return 0;
+	}
+	*value = record.retained[item];
+	return 1;
+}
+
+/*!
+	\fn			uint32_t Crash_dwfnGetCount (void)
+	\return		Returns the faults since power-on
+*/
+uint32_t Crash_dwfnGetCount (void)
+{
+	return record.crashes;
+}
+
+/*!
+	\fn			uint16_t Crash_wfnGetResetCause (void)
+	\return		Returns RCM_SRS1 << 8 | RCM_SRS0 of this boot
+*/
+uint16_t Crash_wfnGetResetCause (void)
+{
+	return resetCause;
+}
+
+/*!
+	\fn			void Crash_vfnFault (const uint32_t *frame, uint32_t excReturn)
+	\param		frame		Exception frame stacked by the core
+	\param		excReturn	LR on entry to the HardFault handler
+	\brief		Called by HardFault_Handler. Stores the record and resets,
+				which takes a few microseconds; the door is back once main
+				has run SmartLock_vfnInit again.
+*/
+void Crash_vfnFault (const uint32_t *frame, uint32_t excReturn)
+{
+	uint8_t i = 0;
+
+	record.magic = CRASH_MAGIC;
+	record.crashes++;
+	record.isValid = 1;
+	for (i = 0; i < FRAME_WORDS; i++)
+	{
+		record.frame[i] = frame[i];
+	}
+	/* Stack pointer of the faulting code, past the frame and its padding */
+	record.sp = (uint32_t)(uintptr_t)&frame[FRAME_WORDS] + ((frame[7] & (1u << 9)) ? 4u : 0u);
+	record.excReturn = excReturn;
+	for (i = 0; i < CRASH_TRACE_DEPTH; i++)
+	{
+		record.trace[i] = trace[(traceHead + i) % CRASH_TRACE_DEPTH];
+	}
+#ifndef HOST_SIMULATION
+	record.icsr = SCB->ICSR;
+#endif
+	record.check = Crash_dwfnCheck ();
+
+#ifndef HOST_SIMULATION
+	NVIC_SystemReset ();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t Crash_dwfnCheck (void)
+	\return		Returns the check word of the record
+*/
+static uint32_t Crash_dwfnCheck (void)
+{
+	const uint32_t *word = (const uint32_t *)&record;
+	uint32_t check = CRASH_MAGIC;
+
+	while (word < &record.check)
+	{
+		check = ((check << 5) | (check >> 27)) ^ *word++;
+	}
+	return check;
+}
+
+/*!
+	\fn			static uint8_t Crash_bfnRetainedCheck (void)
+	\return		Returns the check byte of the retained state
+*/
+static uint8_t Crash_bfnRetainedCheck (void)
+{
+	uint8_t check = 0xA5;
+	uint8_t i = 0;
+
+	for (i = 0; i < eCRASH_RETAINED; i++)
+	{
+		check = (uint8_t)(((check << 1) | (check >> 7)) ^ record.retained[i]);
+	}
+	return check;
+}
+
+/*!
+	\fn			static void Crash_vfnReport (const char *args)
+	\brief		"$CRASH": the last fault, its registers and the events before
+				it, the reset cause and the recovery time. "$CRASH CLR"
+				forgets the fault.
+*/
+static void Crash_vfnReport (const char *args)
+{
+	uint8_t i = 0;
+
+	if (strcmp (args, "CLR") == 0)
+	{
+		record.isValid = 0;
+		record.crashes = 0;
+		record.check = Crash_dwfnCheck ();
+	}
+	Protocol_vfnReply ("CRASH n=%u cause=%x ready=%uus", record.crashes,
+			(uint32_t)resetCause, readyUs);
+	if (!record.isValid)
+	{
+		return;
+	}
+	Protocol_vfnReply ("CRASH pc=%x lr=%x psr=%x sp=%x",
+			record.frame[6], record.frame[5], record.frame[7], record.sp);
+	Protocol_vfnReply ("CRASH r0=%x r1=%x r2=%x r3=%x",
+			record.frame[0], record.frame[1], record.frame[2], record.frame[3]);
+	Protocol_vfnReply ("CRASH r12=%x exc=%x icsr=%x",
+			record.frame[4], record.excReturn, record.icsr);
+	for (i = 0; i < CRASH_TRACE_DEPTH; i += 4)
+	{
+		Protocol_vfnReply ("CRASH t %x %x %x %x", record.trace[i], record.trace[i + 1],
+				record.trace[i + 2], record.trace[i + 3]);
+	}
+}
@@ -0,0 +1,77 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Crash.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the crash record. A HardFault stores
+				the stacked registers and the last traced events in RAM that
+				the startup code does not initialize, then resets at once.
+				The same RAM keeps the state the door must not lose over a
+				reset, so the next boot is back in a few milliseconds with
+				the window pin where it was, and "$CRASH" reports the fault.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_CRASH_H_
+#define _4_SL_CRASH_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CRASH_TRACE_DEPTH
+	\brief		Traced events kept, and stored with a crash
+*/
+#define		CRASH_TRACE_DEPTH	16u
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		CRASH_EVENT
+	\brief		Events of the trace ring
+*/
+typedef enum
+{
+	eCRASH_EVENT_BOOT,		/* arg = crashes since power-on */
+	eCRASH_EVENT_STATE,		/* arg = new state of the state machine */
+	eCRASH_EVENT_PULSE,		/* arg = POWER_LOAD of a relay or motor pulse */
+	eCRASH_EVENT_WATCHDOG,	/* arg = WATCHDOG_TASK that missed its deadline */
+	eCRASH_EVENTS
+} CRASH_EVENT;
+
+/*!
+	\enum		CRASH_RETAIN
+	\brief		State kept over a reset
+*/
+typedef enum
+{
+	eCRASH_RETAIN_LOCKDOWN,	/* window pin engaged */
+	eCRASH_RETAIN_ERRORS,	/* wrong pins in a row */
+	eCRASH_RETAIN_WATCHDOG,	/* WATCHDOG_TASK + 1 that missed before the reset */
+	eCRASH_RETAINED
+} CRASH_RETAIN;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Crash_vfnInit (void);
+
+void Crash_vfnReady (void);
+
+void Crash_vfnTrace (CRASH_EVENT event, uint8_t arg);
+
+void Crash_vfnRetain (CRASH_RETAIN item, uint8_t value);
+
+uint8_t Crash_bfnRecall (CRASH_RETAIN item, uint8_t *value);
+
+uint32_t Crash_dwfnGetCount (void);
+
+uint16_t Crash_wfnGetResetCause (void);
+
+void Crash_vfnFault (const uint32_t *frame, uint32_t excReturn);
+
+#endif /* _4_SL_CRASH_H_ */
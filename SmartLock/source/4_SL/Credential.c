@@ -0,0 +1,523 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Credential.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the signed access credentials.
+				Commands, bytes in hex in pieces of up to 16 per line:
+					$CRED					status
+					$CRED STATS				how credentials were checked
+					$CRED KEY piece			installer's public key
+					$CRED DOOR n			door this lock is
+					$CRED CLR				drops a partial upload and
+											the cache
+					$CRED piece				credential; once complete it
+											is checked and answered with
+											CRED OK user=n or
+											CRED ERR key|format|sig|time|door
+				The first piece of a key or a credential is answered
+				CRED ERR busy while the pool has no block free for it.
+
+				A signature check takes the core about 200 ms at 48 MHz.
+				The SHA-256 of every credential that passed one is kept
+				in a small cache, least recently presented out first, so
+				a phone presenting the same credential again costs two
+				hash blocks. The window and the door are checked on every
+				presentation, cached or not.
+
+				A credential is a bearer token until it expires: the phone
+				should send it inside the secure session. The door and the
+				cache live in RAM and are uploaded again by the app; so is
+				the key, unless the image is built with CREDENTIAL_KEY.
+				Either upload needs an authorized link, as a reset leaves
+				the lock without a key to check a new one against.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "ClockProfile.h"
+#include "Hash.h"
+#include "Pool.h"
+#include "Protocol.h"
+#include "RTC.h"
+#include "Credential.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		FINGERPRINT_BYTES
+	\brief		Bytes of the SHA-256 of a credential kept in the cache
+*/
+#define		FINGERPRINT_BYTES	16u
+
+/*!
+	\def		PIECE_BYTES
+	\brief		Most bytes in one line of hex, so "$CRED KEY " and the
+				hex fit in PROTOCOL_LINE
+*/
+#define		PIECE_BYTES			16u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CREDENTIAL_ENTRY
+	\brief		Credential whose signature was checked
+*/
+typedef struct
+{
+	uint8_t fingerprint[FINGERPRINT_BYTES];
+	uint32_t lastUsed;		/* 0 if the entry is free */
+} CREDENTIAL_ENTRY;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		cache
+	\brief		Credentials verified
+*/
+static CREDENTIAL_ENTRY cache[CREDENTIAL_CACHE];
+
+/*!
+	\var		useCount
+	\brief		Presentations found in or added to the cache, the clock of
+				lastUsed
+*/
+static uint32_t useCount = 0;
+
+/*!
+	\var		issuer
+	\brief		Installer's public key
+*/
+static uint8_t issuer[ED25519_KEY];
+
+/*!
+	\var		hasIssuer
+	\brief		Set once the installer's key is complete
+*/
+static uint8_t hasIssuer = 0;
+
+#ifdef CREDENTIAL_KEY
+/*!
+	\var		builtInKey
+	\brief		Installer's key the image was built with
+*/
+static const uint8_t builtInKey[ED25519_KEY] = CREDENTIAL_KEY;
+#endif
+
+/*!
+	\var		door
+	\brief		Door this lock is
+*/
+static uint8_t door = 0;
+
+/*!
+	\var		upload, uploadLength
+	\brief		Credential being uploaded, a pool block held from its first
+				piece to its last, and its bytes so far
+*/
+static uint8_t *upload = 0;
+static uint8_t uploadLength = 0;
+
+/*!
+	\var		keyUpload, keyLength
+	\brief		Installer's key being uploaded, likewise
+*/
+static uint8_t *keyUpload = 0;
+static uint8_t keyLength = 0;
+
+/*!
+	\var		stats
+	\brief		Counts of the presentations
+*/
+static CREDENTIAL_STATS stats;
+
+/*!
+	\var		grantCallback
+	\brief		Opens the door
+*/
+static CREDENTIAL_GRANT_CALLBACK grantCallback = 0;
+
+/*!
+	\var		resultNames
+	\brief		Reply names of CREDENTIAL_RESULT
+*/
+static const char * const resultNames[eCREDENTIAL_RESULTS] = {"ok", "key", "format", "sig", "time", "door"};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Credential_vfnCommand (const char *args);
+static uint8_t Credential_bfnLookup (const uint8_t *fingerprint);
+static void Credential_vfnInsert (const uint8_t *fingerprint);
+static uint8_t Credential_bfnAppend (const char *text, uint8_t *buffer, uint8_t *length, uint8_t size);
+static void Credential_vfnRelease (uint8_t **buffer, uint8_t *length);
+static uint32_t Credential_dwfnRead (const uint8_t *bytes, uint8_t count);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Credential_vfnInit (CREDENTIAL_GRANT_CALLBACK callback)
+	\param		callback	Opens the door for a valid credential
+	\brief		Registers "$CRED"; the installer key is CREDENTIAL_KEY if
+				the image has one, else none is set
+*/
+void Credential_vfnInit (CREDENTIAL_GRANT_CALLBACK callback)
+{
+	grantCallback = callback;
+	hasIssuer = 0;
+#ifdef CREDENTIAL_KEY
+	memcpy (issuer, builtInKey, ED25519_KEY);
+	hasIssuer = 1;
+#endif
+	Credential_vfnRelease (&upload, &uploadLength);
+	Credential_vfnRelease (&keyUpload, &keyLength);
+	memset (&stats, 0, sizeof (stats));
+	Credential_vfnFlush ();
+
+	Protocol_bfnRegister ("CRED", Credential_vfnCommand);
+}
+
+/*!
+	\fn			void Credential_vfnSetIssuer (const uint8_t *publicKey)
+	\param		publicKey	ED25519_KEY bytes of the installer's key
+	\brief		The cache is flushed: it holds the other key's credentials
+*/
+void Credential_vfnSetIssuer (const uint8_t *publicKey)
+{
+	memcpy (issuer, publicKey, ED25519_KEY);
+	hasIssuer = 1;
+	Credential_vfnFlush ();
+}
+
+/*!
+	\fn			void Credential_vfnSetDoor (uint8_t number)
+	\param		number	Door this lock is, below CREDENTIAL_DOORS
+*/
+void Credential_vfnSetDoor (uint8_t number)
+{
+	door = number;
+}
+
+/*!
+	\fn			CREDENTIAL_RESULT Credential_efnPresent (const uint8_t *blob, uint16_t *user)
+	\param		blob	CREDENTIAL_BLOB bytes
+	\param		user	Receives the user the credential was issued to
+	\return		Returns eCREDENTIAL_OK if the credential opens this door now
+*/
+CREDENTIAL_RESULT Credential_efnPresent (const uint8_t *blob, uint16_t *user)
+{
+	HASH_CONTEXT hash;
+	uint8_t digest[HASH_MAX_DIGEST];
+	uint32_t now = RTC_dwfnGetTime ();
+	uint8_t isValid = 0;
+
+	stats.presented++;
+	*user = (uint16_t)Credential_dwfnRead (&blob[1], 2);
+	if (!hasIssuer)
+	{
+		stats.refused++;
+		return eCREDENTIAL_KEY;
+	}
+	if (blob[0] != CREDENTIAL_VERSION)
+	{
+		stats.refused++;
+		return eCREDENTIAL_FORMAT;
+	}
+
+	Hash_vfnStart (&hash, eHASH_SHA256);
+	Hash_vfnUpdate (&hash, blob, CREDENTIAL_BLOB);
+	Hash_vfnFinish (&hash, digest);
+	if (Credential_bfnLookup (digest))
+	{
+		stats.hits++;
+	}
+	else
+	{
+		ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+		ClockProfile_vfnTask ();
+		isValid = Ed25519_bfnVerify (&blob[CREDENTIAL_BODY], issuer, blob, CREDENTIAL_BODY);
+		ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
+		if (!isValid)
+		{
+			stats.refused++;
+			return eCREDENTIAL_SIGNATURE;
+		}
+		stats.verified++;
+		Credential_vfnInsert (digest);
+	}
+
+	if (!RTC_bfnIsSet () || (now < Credential_dwfnRead (&blob[3], 4)) || (now >= Credential_dwfnRead (&blob[7], 4)))
+	{
+		stats.refused++;
+		return eCREDENTIAL_TIME;
+	}
+	if (!((Credential_dwfnRead (&blob[11], 2) >> door) & 1u))
+	{
+		stats.refused++;
+		return eCREDENTIAL_DOOR;
+	}
+	if (grantCallback)
+	{
+		grantCallback ();
+	}
+	return eCREDENTIAL_OK;
+}
+
+/*!
+	\fn			void Credential_vfnFlush (void)
+	\brief		Forgets every verified credential
+*/
+void Credential_vfnFlush (void)
+{
+	memset (cache, 0, sizeof (cache));
+	useCount = 0;
+}
+
+/*!
+	\fn			void Credential_vfnGetStats (CREDENTIAL_STATS *out)
+	\param		out		Receives the counts since power-on
+*/
+void Credential_vfnGetStats (CREDENTIAL_STATS *out)
+{
+	*out = stats;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Credential_vfnCommand (const char *args)
+	\brief		"$CRED", "$CRED STATS", "$CRED KEY piece", "$CRED DOOR n",
+				"$CRED CLR" or "$CRED piece". Setting the issuer key, like
+				changing the door, needs an authorized link: the key is
+				lost at every reset, so a first key taken from anyone
+				could be planted after a watchdog reset.
+*/
+static void Credential_vfnCommand (const char *args)
+{
+	CREDENTIAL_RESULT result;
+	uint16_t user = 0;
+	uint8_t count = 0;
+	uint8_t i;
+
+	if (!*args)
+	{
+		for (i = 0; i < CREDENTIAL_CACHE; i++)
+		{
+			count += (cache[i].lastUsed != 0);
+		}
+		Protocol_vfnReply ("CRED key=%u door=%u cached=%u max=%u", (uint32_t)hasIssuer, (uint32_t)door,
+				(uint32_t)count, (uint32_t)CREDENTIAL_CACHE);
+		return;
+	}
+	if (strcmp (args, "STATS") == 0)
+	{
+		Protocol_vfnReply ("CRED n=%u hits=%u verified=%u refused=%u", stats.presented, stats.hits,
+				stats.verified, stats.refused);
+		return;
+	}
+	if (strcmp (args, "CLR") == 0)
+	{
+		Credential_vfnRelease (&upload, &uploadLength);
+		Credential_vfnRelease (&keyUpload, &keyLength);
+		Credential_vfnFlush ();
+		Protocol_vfnReply ("CRED OK");
+		return;
+	}
+	if (strncmp (args, "DOOR ", 5) == 0)
+	{
+		if (!Protocol_bfnIsAuthorized ())
+		{
+			Protocol_vfnReply ("CRED ERR auth");
+			return;
+		}
+		args += 5;
+		if ((args[0] < '0') || (args[0] > '9') || ((args[1] != '\0') &&
+				((args[1] < '0') || (args[1] > '9') || (args[2] != '\0'))))
+		{
+			Protocol_vfnReply ("CRED ERR format");
+			return;
+		}
+		count = (uint8_t)(args[0] - '0');
+		if (args[1])
+		{
+			count = (uint8_t)(count * 10u + (uint8_t)(args[1] - '0'));
+		}
+		if (count >= CREDENTIAL_DOORS)
+		{
+			Protocol_vfnReply ("CRED ERR format");
+			return;
+		}
+		Credential_vfnSetDoor (count);
+		Protocol_vfnReply ("CRED OK");
+		return;
+	}
+	if (strncmp (args, "KEY ", 4) == 0)
+	{
+		if (!Protocol_bfnIsAuthorized ())
+		{
+			Credential_vfnRelease (&keyUpload, &keyLength);
+			Protocol_vfnReply ("CRED ERR auth");
+			return;
+		}
+		if (!keyUpload && !(keyUpload = Pool_pvfnAlloc (ED25519_KEY)))
+		{
+			Protocol_vfnReply ("CRED ERR busy");
+			return;
+		}
+		if (!Credential_bfnAppend (&args[4], keyUpload, &keyLength, ED25519_KEY))
+		{
+			Credential_vfnRelease (&keyUpload, &keyLength);
+			Protocol_vfnReply ("CRED ERR format");
+			return;
+		}
+		if (keyLength < ED25519_KEY)
+		{
+			Protocol_vfnReply ("CRED KEY %u", (uint32_t)keyLength);
+			return;
+		}
+		Credential_vfnSetIssuer (keyUpload);
+		Credential_vfnRelease (&keyUpload, &keyLength);
+		Protocol_vfnReply ("CRED KEY OK");
+		return;
+	}
+
+	if (!upload && !(upload = Pool_pvfnAlloc (CREDENTIAL_BLOB)))
+	{
+		Protocol_vfnReply ("CRED ERR busy");
+		return;
+	}
+	if (!Credential_bfnAppend (args, upload, &uploadLength, CREDENTIAL_BLOB))
+	{
+		Credential_vfnRelease (&upload, &uploadLength);
+		Protocol_vfnReply ("CRED ERR format");
+		return;
+	}
+	if (uploadLength < CREDENTIAL_BLOB)
+	{
+		Protocol_vfnReply ("CRED %u", (uint32_t)uploadLength);
+		return;
+	}
+	result = Credential_efnPresent (upload, &user);
+	Credential_vfnRelease (&upload, &uploadLength);
+	if (result != eCREDENTIAL_OK)
+	{
+		Protocol_vfnReply ("CRED ERR %s", resultNames[result]);
+		return;
+	}
+	Protocol_vfnReply ("CRED OK user=%u", (uint32_t)user);
+}
+
+/*!
+	\fn			static uint8_t Credential_bfnLookup (const uint8_t *fingerprint)
+	\return		Returns 1 if the credential was verified before; it becomes
+				the most recently used
+*/
+static uint8_t Credential_bfnLookup (const uint8_t *fingerprint)
+{
+	uint8_t i;
+
+	for (i = 0; i < CREDENTIAL_CACHE; i++)
+	{
+		if (cache[i].lastUsed && (memcmp (cache[i].fingerprint, fingerprint, FINGERPRINT_BYTES) == 0))
+		{
+			cache[i].lastUsed = ++useCount;
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			static void Credential_vfnInsert (const uint8_t *fingerprint)
+	\brief		Takes a free entry, or the least recently used one
+*/
+static void Credential_vfnInsert (const uint8_t *fingerprint)
+{
+	uint8_t oldest = 0;
+	uint8_t i;
+
+	for (i = 1; i < CREDENTIAL_CACHE; i++)
+	{
+		if (cache[i].lastUsed < cache[oldest].lastUsed)
+		{
+			oldest = i;
+		}
+	}
+	memcpy (cache[oldest].fingerprint, fingerprint, FINGERPRINT_BYTES);
+	cache[oldest].lastUsed = ++useCount;
+}
+
+/*!
+	\fn			static uint8_t Credential_bfnAppend (const char *text, uint8_t *buffer, uint8_t *length, uint8_t size)
+	\param		text	Pairs of hex digits, at most PIECE_BYTES of them
+	\param		length	Bytes in the buffer, updated
+	\return		Returns 0 if the piece is not hex or does not fit
+*/
+static uint8_t Credential_bfnAppend (const char *text, uint8_t *buffer, uint8_t *length, uint8_t size)
+{
+	uint8_t digits[2 * PIECE_BYTES];
+	uint8_t count;
+	uint8_t i;
+	char c;
+
+	for (count = 0; text[count] && (count < 2u * PIECE_BYTES); count++)
+	{
+		c = text[count];
+		if ((c >= '0') && (c <= '9'))
+		{
+			digits[count] = (uint8_t)(c - '0');
+		}
+		else if ((c >= 'a') && (c <= 'f'))
+		{
+			digits[count] = (uint8_t)(c - 'a' + 10);
+		}
+		else if ((c >= 'A') && (c <= 'F'))
+		{
+			digits[count] = (uint8_t)(c - 'A' + 10);
+		}
+		else
+		{
+			break;
+		}
+	}
+	if (text[count] || !count || (count & 1u) || ((uint16_t)*length + count / 2u > size))
+	{
+		return 0;
+	}
+	for (i = 0; i < count; i += 2)
+	{
+		buffer[(*length)++] = (uint8_t)((digits[i] << 4) | digits[i + 1]);
+	}
+	return 1;
+}
+
+/*!
+	\fn			static void Credential_vfnRelease (uint8_t **buffer, uint8_t *length)
+	\brief		Returns an upload's block to the pool; the upload starts over
+*/
+static void Credential_vfnRelease (uint8_t **buffer, uint8_t *length)
+{
+	Pool_vfnFree (*buffer);
+	*buffer = 0;
+	*length = 0;
+}
+
+/*!
+	\fn			static uint32_t Credential_dwfnRead (const uint8_t *bytes, uint8_t count)
+	\return		Returns count big-endian bytes as a number
+*/
+static uint32_t Credential_dwfnRead (const uint8_t *bytes, uint8_t count)
+{
+	uint32_t value = 0;
+
+	while (count--)
+	{
+		value = (value << 8) | *bytes++;
+	}
+	return value;
+}
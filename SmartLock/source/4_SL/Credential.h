@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Credential.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the signed access credentials. An
+				installer's office signs a credential for a user, a time
+				window and a set of doors with its Ed25519 key; a phone
+				presents it over Bluetooth and the lock checks it offline
+				against the installer's public key.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_CREDENTIAL_H_
+#define _4_SL_CREDENTIAL_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Ed25519.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CREDENTIAL_VERSION
+	\brief		First byte of every credential of this layout
+*/
+#define		CREDENTIAL_VERSION	1u
+
+/*!
+	\def		CREDENTIAL_BODY
+	\brief		Bytes signed: version(1) user(2) notBefore(4) notAfter(4)
+				doors(2), big-endian; the times are local, as the RTC
+				keeps them, and bit n of doors is door n
+*/
+#define		CREDENTIAL_BODY		13u
+
+/*!
+	\def		CREDENTIAL_BLOB
+	\brief		Bytes of a credential: the body and its signature
+*/
+#define		CREDENTIAL_BLOB		(CREDENTIAL_BODY + ED25519_SIGNATURE)
+
+/*!
+	\def		CREDENTIAL_DOORS
+	\brief		Doors a credential can name
+*/
+#define		CREDENTIAL_DOORS	16u
+
+/*!
+	\def		CREDENTIAL_KEY
+	\brief		Installer's Ed25519 public key, 32 bytes in braces, built
+				into the image so that a reset does not leave the lock
+				without one. Undefined, the app uploads it with
+				"$CRED KEY" over an authorized link after every reset.
+*/
+#ifndef HOST_SIMULATION
+//	#define CREDENTIAL_KEY	{0x00, ...}
+#endif
+
+/*!
+	\def		CREDENTIAL_CACHE
+	\brief		Credentials remembered as verified, 20 bytes each. The
+				benchmark build has more to time the worst case.
+*/
+#if defined(BENCHMARK_BUILD) || defined(HOST_SIMULATION)
+#define		CREDENTIAL_CACHE	16u
+#else
+#define		CREDENTIAL_CACHE	8u
+#endif
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		CREDENTIAL_RESULT
+	\brief		Outcome of a presentation
+*/
+typedef enum
+{
+	eCREDENTIAL_OK,
+	eCREDENTIAL_KEY,		/* no installer key set */
+	eCREDENTIAL_FORMAT,		/* unknown version */
+	eCREDENTIAL_SIGNATURE,	/* not signed by the installer */
+	eCREDENTIAL_TIME,		/* outside its window, or the time is unset */
+	eCREDENTIAL_DOOR,		/* not for this door */
+	eCREDENTIAL_RESULTS
+} CREDENTIAL_RESULT;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	CREDENTIAL_GRANT_CALLBACK
+	\brief		Called from the main loop when a credential opens the door
+*/
+typedef void (*CREDENTIAL_GRANT_CALLBACK)(void);
+
+/*!
+	\struct		CREDENTIAL_STATS
+	\brief		How the credentials presented were checked
+*/
+typedef struct
+{
+	uint32_t presented;
+	uint32_t hits;		/* found in the cache, no signature check */
+	uint32_t verified;	/* signature checks that passed */
+	uint32_t refused;
+} CREDENTIAL_STATS;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Credential_vfnInit (CREDENTIAL_GRANT_CALLBACK callback);
+
+void Credential_vfnSetIssuer (const uint8_t *publicKey);
+
+void Credential_vfnSetDoor (uint8_t door);
+
+CREDENTIAL_RESULT Credential_efnPresent (const uint8_t *blob, uint16_t *user);
+
+void Credential_vfnFlush (void);
+
+void Credential_vfnGetStats (CREDENTIAL_STATS *out);
+
+#endif /* _4_SL_CREDENTIAL_H_ */
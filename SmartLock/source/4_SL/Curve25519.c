@@ -0,0 +1,425 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Curve25519.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the field arithmetic and X25519.
+				The Cortex-M0+ multiplies 32 x 32 bits into the low 32 bits
+				only, so a field element has sixteen 16-bit limbs: a limb
+				product fits a word, and its halves are added into two
+				columns that cannot overflow either. 2^256 is 38 modulo p,
+				which folds the upper half of a product back.
+				The ladder, the swaps and the reduction only ever branch
+				on loop counters, so their timing does not depend on the
+				secret scalar.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "Curve25519.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		LIMB_MASK
+	\brief		Bits of a reduced limb
+*/
+#define		LIMB_MASK			0xFFFFu
+
+/*!
+	\def		FOLD
+	\brief		2^256 modulo p
+*/
+#define		FOLD				38u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		fourP
+	\brief		4p with every limb above 2^16, so a - b + 4p never borrows
+*/
+static const CURVE25519_FE fourP =
+{
+	0x1FFB4u, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu,
+	0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu, 0x1FFFEu
+};
+
+/*!
+	\var		a24
+	\brief		(486662 - 2) / 4 = 121665, the curve constant of the ladder
+*/
+static const CURVE25519_FE a24 = {0xDB41u, 1u};
+
+/*!
+	\var		basePoint
+	\brief		u = 9, the generator of X25519
+*/
+static const uint8_t basePoint[CURVE25519_BYTES] = {9};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static RAMFUNC_HOT void Curve25519_vfnCarry (CURVE25519_FE out);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Curve25519_vfnUnpack (CURVE25519_FE out, const uint8_t *in)
+	\param		in		CURVE25519_BYTES little-endian bytes; the top bit is
+						ignored, as RFC 7748 asks
+*/
+void Curve25519_vfnUnpack (CURVE25519_FE out, const uint8_t *in)
+{
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = (uint32_t)in[2u * i] | ((uint32_t)in[2u * i + 1u] << 8);
+	}
+	out[CURVE25519_LIMBS - 1u] &= 0x7FFFu;
+}
+
+/*!
+	\fn			void Curve25519_vfnPack (uint8_t *out, const CURVE25519_FE in)
+	\param		out		Receives CURVE25519_BYTES little-endian bytes of the
+						value fully reduced below p
+	\brief		A reduced element is below 2^256 < 3p, so p is taken off
+				twice, each time kept only if it did not borrow
+*/
+void Curve25519_vfnPack (uint8_t *out, const CURVE25519_FE in)
+{
+	CURVE25519_FE t;
+	CURVE25519_FE m;
+	uint32_t borrow;
+	uint8_t pass;
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		t[i] = in[i];
+	}
+	for (pass = 0; pass < 2u; pass++)
+	{
+		/* p is 0xFFED, then fourteen 0xFFFF, then 0x7FFF */
+		m[0] = t[0] - 0xFFEDu;
+		for (i = 1; i < CURVE25519_LIMBS; i++)
+		{
+			borrow = (m[i - 1u] >> 16) & 1u;
+			m[i - 1u] &= LIMB_MASK;
+			m[i] = t[i] - ((i == CURVE25519_LIMBS - 1u) ? 0x7FFFu : LIMB_MASK) - borrow;
+		}
+		borrow = (m[CURVE25519_LIMBS - 1u] >> 16) & 1u;
+		m[CURVE25519_LIMBS - 1u] &= LIMB_MASK;
+		Curve25519_vfnSwap (t, m, 1u - borrow);
+	}
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[2u * i] = (uint8_t)t[i];
+		out[2u * i + 1u] = (uint8_t)(t[i] >> 8);
+	}
+}
+
+/*!
+	\fn			void Curve25519_vfnAdd (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+	\param		out		Receives a + b; may be a or b
+*/
+void Curve25519_vfnAdd (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+{
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = a[i] + b[i];
+	}
+	Curve25519_vfnCarry (out);
+}
+
+/*!
+	\fn			void Curve25519_vfnSub (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+	\param		out		Receives a - b; may be a or b
+*/
+void Curve25519_vfnSub (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+{
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = a[i] + fourP[i] - b[i];
+	}
+	Curve25519_vfnCarry (out);
+}
+
+/*!
+	\fn			void Curve25519_vfnMul (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+	\param		out		Receives a * b; may be a or b
+	\brief		Schoolbook product into 32 columns: each limb product
+				below 2^32 adds its low half to column i + j and its high
+				half to the next one, so a column stays below 2^21
+*/
+RAMFUNC_HOT void Curve25519_vfnMul (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b)
+{
+	uint32_t columns[2u * CURVE25519_LIMBS] = {0};
+	uint32_t product;
+	uint32_t ai;
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		ai = a[i];
+		for (j = 0; j < CURVE25519_LIMBS; j++)
+		{
+			product = ai * b[j];
+			columns[i + j] += product & LIMB_MASK;
+			columns[i + j + 1u] += product >> 16;
+		}
+	}
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = columns[i] + FOLD * columns[i + CURVE25519_LIMBS];
+	}
+	Curve25519_vfnCarry (out);
+}
+
+/*!
+	\fn			void Curve25519_vfnSquare (CURVE25519_FE out, const CURVE25519_FE a)
+	\param		out		Receives a * a; may be a
+	\brief		Each product of two different limbs is taken once and its
+				halves added twice, 136 multiplications instead of 256;
+				the columns are the same as those of Curve25519_vfnMul
+*/
+RAMFUNC_HOT void Curve25519_vfnSquare (CURVE25519_FE out, const CURVE25519_FE a)
+{
+	uint32_t columns[2u * CURVE25519_LIMBS] = {0};
+	uint32_t product;
+	uint32_t ai;
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		ai = a[i];
+		product = ai * ai;
+		columns[2u * i] += product & LIMB_MASK;
+		columns[2u * i + 1u] += product >> 16;
+		for (j = (uint8_t)(i + 1u); j < CURVE25519_LIMBS; j++)
+		{
+			product = ai * a[j];
+			columns[i + j] += (product & LIMB_MASK) << 1;
+			columns[i + j + 1u] += (product >> 16) << 1;
+		}
+	}
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = columns[i] + FOLD * columns[i + CURVE25519_LIMBS];
+	}
+	Curve25519_vfnCarry (out);
+}
+
+/*!
+	\fn			void Curve25519_vfnInvert (CURVE25519_FE out, const CURVE25519_FE in)
+	\param		out		Receives 1 / in, computed as in^(p - 2); may be in
+	\brief		p - 2 = 2^255 - 21 has every bit from 254 down set but bits
+				2 and 4
+*/
+void Curve25519_vfnInvert (CURVE25519_FE out, const CURVE25519_FE in)
+{
+	CURVE25519_FE c;
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		c[i] = in[i];
+	}
+	for (i = 253; ; i--)
+	{
+		Curve25519_vfnSquare (c, c);
+		if ((i != 2u) && (i != 4u))
+		{
+			Curve25519_vfnMul (c, c, in);
+		}
+		if (i == 0)
+		{
+			break;
+		}
+	}
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = c[i];
+	}
+}
+
+/*!
+	\fn			void Curve25519_vfnPow22523 (CURVE25519_FE out, const CURVE25519_FE in)
+	\param		out		Receives in^((p - 5) / 8), the power a square root is
+						taken with; may be in
+	\brief		(p - 5) / 8 = 2^252 - 3 has every bit from 251 down set
+				but bit 1
+*/
+void Curve25519_vfnPow22523 (CURVE25519_FE out, const CURVE25519_FE in)
+{
+	CURVE25519_FE c;
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		c[i] = in[i];
+	}
+	for (i = 250; ; i--)
+	{
+		Curve25519_vfnSquare (c, c);
+		if (i != 1u)
+		{
+			Curve25519_vfnMul (c, c, in);
+		}
+		if (i == 0)
+		{
+			break;
+		}
+	}
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		out[i] = c[i];
+	}
+}
+
+/*!
+	\fn			void Curve25519_vfnSwap (CURVE25519_FE a, CURVE25519_FE b, uint32_t swap)
+	\param		swap	1 to swap a and b, 0 to leave them; both take the
+						same time
+*/
+void Curve25519_vfnSwap (CURVE25519_FE a, CURVE25519_FE b, uint32_t swap)
+{
+	uint32_t mask = 0u - swap;
+	uint32_t t;
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		t = mask & (a[i] ^ b[i]);
+		a[i] ^= t;
+		b[i] ^= t;
+	}
+}
+
+/*!
+	\fn			void Curve25519_vfnX25519 (uint8_t *out, const uint8_t *scalar, const uint8_t *point)
+	\param		out		Receives the u-coordinate of scalar * point
+	\param		scalar	CURVE25519_BYTES of secret scalar, clamped here
+	\param		point	CURVE25519_BYTES u-coordinate of the peer's point
+	\brief		Montgomery ladder of RFC 7748 section 5
+*/
+void Curve25519_vfnX25519 (uint8_t *out, const uint8_t *scalar, const uint8_t *point)
+{
+	CURVE25519_FE x1;
+	CURVE25519_FE x2 = {1};
+	CURVE25519_FE z2 = {0};
+	CURVE25519_FE x3;
+	CURVE25519_FE z3 = {1};
+	CURVE25519_FE a;
+	CURVE25519_FE b;
+	CURVE25519_FE c;
+	CURVE25519_FE d;
+	CURVE25519_FE e;
+	uint8_t k[CURVE25519_BYTES];
+	uint32_t swap = 0;
+	uint32_t bit;
+	uint8_t i;
+
+	for (i = 0; i < CURVE25519_BYTES; i++)
+	{
+		k[i] = scalar[i];
+	}
+	k[0] &= 248u;
+	k[31] = (uint8_t)((k[31] & 127u) | 64u);
+
+	Curve25519_vfnUnpack (x1, point);
+	for (i = 0; i < CURVE25519_LIMBS; i++)
+	{
+		x3[i] = x1[i];
+	}
+
+	for (i = 255; i > 0; i--)
+	{
+		bit = (k[(i - 1u) >> 3] >> ((i - 1u) & 7u)) & 1u;
+		swap ^= bit;
+		Curve25519_vfnSwap (x2, x3, swap);
+		Curve25519_vfnSwap (z2, z3, swap);
+		swap = bit;
+
+		Curve25519_vfnAdd (a, x2, z2);		/* A */
+		Curve25519_vfnSub (b, x2, z2);		/* B */
+		Curve25519_vfnAdd (c, x3, z3);		/* C */
+		Curve25519_vfnSub (d, x3, z3);		/* D */
+		Curve25519_vfnMul (d, d, a);		/* DA */
+		Curve25519_vfnMul (c, c, b);		/* CB */
+		Curve25519_vfnSquare (a, a);		/* AA */
+		Curve25519_vfnSquare (b, b);		/* BB */
+		Curve25519_vfnSub (e, a, b);		/* E = AA - BB */
+		Curve25519_vfnAdd (x3, d, c);
+		Curve25519_vfnSquare (x3, x3);		/* (DA + CB)^2 */
+		Curve25519_vfnSub (z3, d, c);
+		Curve25519_vfnSquare (z3, z3);
+		Curve25519_vfnMul (z3, z3, x1);		/* x1 * (DA - CB)^2 */
+		Curve25519_vfnMul (x2, a, b);		/* AA * BB */
+		Curve25519_vfnMul (z2, e, a24);
+		Curve25519_vfnAdd (z2, z2, a);
+		Curve25519_vfnMul (z2, z2, e);		/* E * (AA + a24 * E) */
+	}
+	Curve25519_vfnSwap (x2, x3, swap);
+	Curve25519_vfnSwap (z2, z3, swap);
+
+	Curve25519_vfnInvert (z2, z2);
+	Curve25519_vfnMul (x2, x2, z2);
+	Curve25519_vfnPack (out, x2);
+
+	for (i = 0; i < CURVE25519_BYTES; i++)
+	{
+		((volatile uint8_t *)k)[i] = 0;
+	}
+}
+
+/*!
+	\fn			void Curve25519_vfnX25519Base (uint8_t *out, const uint8_t *scalar)
+	\param		out		Receives the public key of scalar
+	\param		scalar	CURVE25519_BYTES of secret scalar
+*/
+void Curve25519_vfnX25519Base (uint8_t *out, const uint8_t *scalar)
+{
+	Curve25519_vfnX25519 (out, scalar, basePoint);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Curve25519_vfnCarry (CURVE25519_FE out)
+	\param		out		Limbs below 2^27, returned below 2^16
+	\brief		Two carry passes, the carry out of the top limb folded back
+				into limb 0. After the second pass only limb 0 can be over
+				by the last fold, and then limb 1 was just carried out of
+				and is small, so one more carry into it is enough.
+*/
+static RAMFUNC_HOT void Curve25519_vfnCarry (CURVE25519_FE out)
+{
+	uint32_t carry;
+	uint8_t pass;
+	uint8_t i;
+
+	for (pass = 0; pass < 2u; pass++)
+	{
+		for (i = 0; i < CURVE25519_LIMBS - 1u; i++)
+		{
+			carry = out[i] >> 16;
+			out[i] &= LIMB_MASK;
+			out[i + 1u] += carry;
+		}
+		carry = out[CURVE25519_LIMBS - 1u] >> 16;
+		out[CURVE25519_LIMBS - 1u] &= LIMB_MASK;
+		out[0] += FOLD * carry;
+	}
+	out[1] += out[0] >> 16;
+	out[0] &= LIMB_MASK;
+}
@@ -0,0 +1,71 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Curve25519.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the arithmetic modulo 2^255 - 19
+				and of the X25519 key agreement (RFC 7748) built on it.
+				The field functions are shared with the other users of the
+				curve.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_CURVE25519_H_
+#define _4_SL_CURVE25519_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "RamFunc.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CURVE25519_BYTES
+	\brief		Bytes of a scalar, of a packed field element and of a key
+*/
+#define		CURVE25519_BYTES	32u
+
+/*!
+	\def		CURVE25519_LIMBS
+	\brief		16-bit limbs of a field element
+*/
+#define		CURVE25519_LIMBS	16u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	CURVE25519_FE
+	\brief		Field element, limb i weighs 2^(16 i). Every function
+				returns its limbs below 2^16, which keeps the products of
+				a multiplication within 32 bits.
+*/
+typedef uint32_t CURVE25519_FE[CURVE25519_LIMBS];
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Curve25519_vfnUnpack (CURVE25519_FE out, const uint8_t *in);
+
+void Curve25519_vfnPack (uint8_t *out, const CURVE25519_FE in);
+
+void Curve25519_vfnAdd (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b);
+
+void Curve25519_vfnSub (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b);
+
+RAMFUNC_HOT void Curve25519_vfnMul (CURVE25519_FE out, const CURVE25519_FE a, const CURVE25519_FE b);
+
+RAMFUNC_HOT void Curve25519_vfnSquare (CURVE25519_FE out, const CURVE25519_FE a);
+
+void Curve25519_vfnInvert (CURVE25519_FE out, const CURVE25519_FE in);
+
+void Curve25519_vfnPow22523 (CURVE25519_FE out, const CURVE25519_FE in);
+
+void Curve25519_vfnSwap (CURVE25519_FE a, CURVE25519_FE b, uint32_t swap);
+
+void Curve25519_vfnX25519 (uint8_t *out, const uint8_t *scalar, const uint8_t *point);
+
+void Curve25519_vfnX25519Base (uint8_t *out, const uint8_t *scalar);
+
+#endif /* _4_SL_CURVE25519_H_ */
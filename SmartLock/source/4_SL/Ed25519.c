@@ -0,0 +1,419 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Ed25519.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the Ed25519 signature check.
+				Points are kept in extended coordinates (X:Y:Z:T) on the
+				field of Curve25519.c, whose 16-bit limbs suit the 32-bit
+				multiplier of the Cortex-M0+; doubling takes four squares
+				and four products, an addition nine products.
+
+				[S]B - [k]A is computed with one shared run of doublings
+				over the bits of both scalars (Straus), adding B, -A or
+				B - A wherever either scalar has a bit set, and its
+				encoding compared with R. Everything in a signature is
+				public, so nothing here needs to run in constant time.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "Curve25519.h"
+#include "Hash.h"
+#include "Ed25519.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		SCALAR_BITS
+	\brief		Bits of a scalar reduced modulo the group order L < 2^253
+*/
+#define		SCALAR_BITS			253u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		ED25519_POINT
+	\brief		Point (X/Z, Y/Z) with T = XY/Z
+*/
+typedef struct
+{
+	CURVE25519_FE x;
+	CURVE25519_FE y;
+	CURVE25519_FE z;
+	CURVE25519_FE t;
+} ED25519_POINT;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		curveD
+	\brief		d = -121665 / 121666 of the curve equation
+*/
+static const CURVE25519_FE curveD =
+{
+	0x78A3u, 0x1359u, 0x4DCAu, 0x75EBu, 0xD8ABu, 0x4141u, 0x0A4Du, 0x0070u,
+	0xE898u, 0x7779u, 0x4079u, 0x8CC7u, 0xFE73u, 0x2B6Fu, 0x6CEEu, 0x5203u
+};
+
+/*!
+	\var		curveD2
+	\brief		2d, as the addition uses it
+*/
+static const CURVE25519_FE curveD2 =
+{
+	0xF159u, 0x26B2u, 0x9B94u, 0xEBD6u, 0xB156u, 0x8283u, 0x149Au, 0x00E0u,
+	0xD130u, 0xEEF3u, 0x80F2u, 0x198Eu, 0xFCE7u, 0x56DFu, 0xD9DCu, 0x2406u
+};
+
+/*!
+	\var		sqrtMinusOne
+	\brief		2^((p - 1) / 4), a square root of -1
+*/
+static const CURVE25519_FE sqrtMinusOne =
+{
+	0xA0B0u, 0x4A0Eu, 0x1B27u, 0xC4EEu, 0xE478u, 0xAD2Fu, 0x1806u, 0x2F43u,
+	0xD7A7u, 0x3DFBu, 0x0099u, 0x2B4Du, 0xDF0Bu, 0x4FC1u, 0x2480u, 0x2B83u
+};
+
+/*!
+	\var		basePoint
+	\brief		The generator B, y = 4/5 and x even
+*/
+static const ED25519_POINT basePoint =
+{
+	{
+		0xD51Au, 0x8F25u, 0x2D60u, 0xC956u, 0xA7B2u, 0x9525u, 0xC760u, 0x692Cu,
+		0xDC5Cu, 0xFDD6u, 0xE231u, 0xC0A4u, 0x53FEu, 0xCD6Eu, 0x36D3u, 0x2169u
+	},
+	{
+		0x6658u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u,
+		0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u, 0x6666u
+	},
+	{1u},
+	{
+		0xDDA3u, 0xA5B7u, 0x8AB3u, 0x6DDEu, 0x52F5u, 0x7751u, 0x9F80u, 0x20F0u,
+		0xE37Du, 0x64ABu, 0x4E8Eu, 0x66EAu, 0x7665u, 0xD78Bu, 0x5F0Fu, 0x6787u
+	}
+};
+
+/*!
+	\var		groupOrder
+	\brief		L = 2^252 + 27742317777372353535851937790883648493,
+				little-endian bytes
+*/
+static const uint8_t groupOrder[32] =
+{
+	0xEDu, 0xD3u, 0xF5u, 0x5Cu, 0x1Au, 0x63u, 0x12u, 0x58u,
+	0xD6u, 0x9Cu, 0xF7u, 0xA2u, 0xDEu, 0xF9u, 0xDEu, 0x14u,
+	0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0x10u
+};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Ed25519_vfnAdd (ED25519_POINT *r, const ED25519_POINT *p, const ED25519_POINT *q);
+static void Ed25519_vfnDouble (ED25519_POINT *r);
+static uint8_t Ed25519_bfnDecodeNegated (ED25519_POINT *r, const uint8_t *in);
+static void Ed25519_vfnEncode (uint8_t *out, const ED25519_POINT *p);
+static uint8_t Ed25519_bfnIsEqual (const CURVE25519_FE a, const CURVE25519_FE b);
+static uint8_t Ed25519_bfnIsBelowOrder (const uint8_t *scalar);
+static void Ed25519_vfnReduce (uint8_t *out, const uint8_t *digest);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			uint8_t Ed25519_bfnVerify (const uint8_t *signature, const uint8_t *publicKey,
+					const uint8_t *message, uint16_t length)
+	\param		signature	ED25519_SIGNATURE bytes, R then S
+	\param		publicKey	ED25519_KEY bytes, the encoded point A
+	\return		Returns 1 if [S]B = R + [k]A with k = SHA-512(R, A, message)
+				modulo L; else, returns 0. S at or above L and keys that
+				are no point are refused, as RFC 8032 asks.
+*/
+uint8_t Ed25519_bfnVerify (const uint8_t *signature, const uint8_t *publicKey,
+		const uint8_t *message, uint16_t length)
+{
+	HASH_SHA512_CONTEXT hash;
+	ED25519_POINT table[3];
+	ED25519_POINT r;
+	uint8_t digest[HASH_SHA512_DIGEST];
+	uint8_t k[32];
+	uint8_t check[32];
+	const uint8_t *s = &signature[32];
+	uint8_t index;
+	uint16_t bit;
+
+	if (!Ed25519_bfnIsBelowOrder (s) || !Ed25519_bfnDecodeNegated (&table[1], publicKey))
+	{
+		return 0;
+	}
+
+	Hash_vfnSha512Start (&hash);
+	Hash_vfnSha512Update (&hash, signature, 32u);
+	Hash_vfnSha512Update (&hash, publicKey, ED25519_KEY);
+	Hash_vfnSha512Update (&hash, message, length);
+	Hash_vfnSha512Finish (&hash, digest);
+	Ed25519_vfnReduce (k, digest);
+
+	/* table[index - 1] is added for bit index of (S bit) | (k bit) << 1 */
+	table[0] = basePoint;
+	Ed25519_vfnAdd (&table[2], &basePoint, &table[1]);
+	memset (&r, 0, sizeof (r));
+	r.y[0] = 1u;
+	r.z[0] = 1u;
+	for (bit = SCALAR_BITS; bit-- > 0;)
+	{
+		Ed25519_vfnDouble (&r);
+		index = (uint8_t)(((s[bit >> 3] >> (bit & 7u)) & 1u) | (((k[bit >> 3] >> (bit & 7u)) & 1u) << 1));
+		if (index)
+		{
+			Ed25519_vfnAdd (&r, &r, &table[index - 1u]);
+		}
+	}
+
+	Ed25519_vfnEncode (check, &r);
+	return memcmp (check, signature, 32u) == 0;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Ed25519_vfnAdd (ED25519_POINT *r, const ED25519_POINT *p, const ED25519_POINT *q)
+	\param		r	Receives p + q; may be p or q
+	\brief		Unified addition of the twisted Edwards curve with a = -1
+*/
+static void Ed25519_vfnAdd (ED25519_POINT *r, const ED25519_POINT *p, const ED25519_POINT *q)
+{
+	CURVE25519_FE a;
+	CURVE25519_FE b;
+	CURVE25519_FE c;
+	CURVE25519_FE d;
+	CURVE25519_FE t;
+
+	Curve25519_vfnSub (a, p->y, p->x);
+	Curve25519_vfnSub (t, q->y, q->x);
+	Curve25519_vfnMul (a, a, t);			/* (Y1 - X1)(Y2 - X2) */
+	Curve25519_vfnAdd (b, p->y, p->x);
+	Curve25519_vfnAdd (t, q->y, q->x);
+	Curve25519_vfnMul (b, b, t);			/* (Y1 + X1)(Y2 + X2) */
+	Curve25519_vfnMul (c, p->t, q->t);
+	Curve25519_vfnMul (c, c, curveD2);		/* 2d T1 T2 */
+	Curve25519_vfnMul (d, p->z, q->z);
+	Curve25519_vfnAdd (d, d, d);			/* 2 Z1 Z2 */
+
+	Curve25519_vfnSub (t, b, a);			/* E */
+	Curve25519_vfnAdd (b, b, a);			/* H */
+	Curve25519_vfnSub (a, d, c);			/* F */
+	Curve25519_vfnAdd (d, d, c);			/* G */
+	Curve25519_vfnMul (r->x, t, a);
+	Curve25519_vfnMul (r->y, b, d);
+	Curve25519_vfnMul (r->z, d, a);
+	Curve25519_vfnMul (r->t, t, b);
+}
+
+/*!
+	\fn			static void Ed25519_vfnDouble (ED25519_POINT *r)
+	\param		r	Point doubled in place; T is not read
+*/
+static void Ed25519_vfnDouble (ED25519_POINT *r)
+{
+	CURVE25519_FE e;
+	CURVE25519_FE f;
+	CURVE25519_FE g;
+	CURVE25519_FE h;
+
+	Curve25519_vfnSquare (e, r->x);			/* X^2 */
+	Curve25519_vfnSquare (g, r->y);			/* Y^2 */
+	Curve25519_vfnAdd (h, e, g);			/* H = X^2 + Y^2 */
+	Curve25519_vfnSub (g, g, e);			/* G = Y^2 - X^2 */
+	Curve25519_vfnSquare (f, r->z);
+	Curve25519_vfnAdd (f, f, f);
+	Curve25519_vfnSub (f, f, g);			/* F = 2 Z^2 - G */
+	Curve25519_vfnAdd (e, r->x, r->y);
+	Curve25519_vfnSquare (e, e);
+	Curve25519_vfnSub (e, e, h);			/* E = (X + Y)^2 - H */
+	Curve25519_vfnMul (r->x, e, f);
+	Curve25519_vfnMul (r->y, h, g);
+	Curve25519_vfnMul (r->z, g, f);
+	Curve25519_vfnMul (r->t, e, h);
+}
+
+/*!
+	\fn			static uint8_t Ed25519_bfnDecodeNegated (ED25519_POINT *r, const uint8_t *in)
+	\param		r	Receives minus the point, which is what the check adds
+	\param		in	32 bytes: y, and the sign of x in the top bit
+	\return		Returns 0 if y is not below p or no point has it
+	\brief		x = u v^3 (u v^7)^((p - 5) / 8) with u = y^2 - 1 and
+				v = d y^2 + 1 is a root of u / v or of -u / v; in the
+				second case it is multiplied by the root of -1
+*/
+static uint8_t Ed25519_bfnDecodeNegated (ED25519_POINT *r, const uint8_t *in)
+{
+	CURVE25519_FE u;
+	CURVE25519_FE v;
+	CURVE25519_FE v3;
+	CURVE25519_FE check;
+	CURVE25519_FE zero = {0};
+	uint8_t packed[32];
+	uint8_t sign = in[31] >> 7;
+
+	Curve25519_vfnUnpack (r->y, in);
+	Curve25519_vfnPack (packed, r->y);
+	packed[31] |= (uint8_t)(sign << 7);
+	if (memcmp (packed, in, 32u) != 0)
+	{
+		return 0;
+	}
+	memset (r->z, 0, sizeof (r->z));
+	r->z[0] = 1u;
+
+	Curve25519_vfnSquare (u, r->y);
+	Curve25519_vfnMul (v, u, curveD);
+	Curve25519_vfnSub (u, u, r->z);			/* y^2 - 1 */
+	Curve25519_vfnAdd (v, v, r->z);			/* d y^2 + 1 */
+
+	Curve25519_vfnSquare (v3, v);
+	Curve25519_vfnMul (v3, v3, v);			/* v^3 */
+	Curve25519_vfnSquare (r->x, v3);
+	Curve25519_vfnMul (r->x, r->x, v);
+	Curve25519_vfnMul (r->x, r->x, u);		/* u v^7 */
+	Curve25519_vfnPow22523 (r->x, r->x);
+	Curve25519_vfnMul (r->x, r->x, v3);
+	Curve25519_vfnMul (r->x, r->x, u);
+
+	Curve25519_vfnSquare (check, r->x);
+	Curve25519_vfnMul (check, check, v);
+	if (!Ed25519_bfnIsEqual (check, u))
+	{
+		Curve25519_vfnSub (u, zero, u);
+		if (!Ed25519_bfnIsEqual (check, u))
+		{
+			return 0;
+		}
+		Curve25519_vfnMul (r->x, r->x, sqrtMinusOne);
+	}
+
+	Curve25519_vfnPack (packed, r->x);
+	if (Ed25519_bfnIsEqual (r->x, zero) && sign)
+	{
+		return 0;
+	}
+	/* Negated: x keeps the sign bit only if it had the opposite one */
+	if ((packed[0] & 1u) == sign)
+	{
+		Curve25519_vfnSub (r->x, zero, r->x);
+	}
+	Curve25519_vfnMul (r->t, r->x, r->y);
+	return 1;
+}
+
+/*!
+	\fn			static void Ed25519_vfnEncode (uint8_t *out, const ED25519_POINT *p)
+	\param		out		Receives y, with the sign of x in the top bit
+*/
+static void Ed25519_vfnEncode (uint8_t *out, const ED25519_POINT *p)
+{
+	CURVE25519_FE inverse;
+	CURVE25519_FE x;
+	CURVE25519_FE y;
+	uint8_t packed[32];
+
+	Curve25519_vfnInvert (inverse, p->z);
+	Curve25519_vfnMul (x, p->x, inverse);
+	Curve25519_vfnMul (y, p->y, inverse);
+	Curve25519_vfnPack (out, y);
+	Curve25519_vfnPack (packed, x);
+	out[31] ^= (uint8_t)((packed[0] & 1u) << 7);
+}
+
+/*!
+	\fn			static uint8_t Ed25519_bfnIsEqual (const CURVE25519_FE a, const CURVE25519_FE b)
+	\return		Returns 1 if both elements are the same modulo p
+*/
+static uint8_t Ed25519_bfnIsEqual (const CURVE25519_FE a, const CURVE25519_FE b)
+{
+	uint8_t packedA[32];
+	uint8_t packedB[32];
+
+	Curve25519_vfnPack (packedA, a);
+	Curve25519_vfnPack (packedB, b);
+	return memcmp (packedA, packedB, 32u) == 0;
+}
+
+/*!
+	\fn			static uint8_t Ed25519_bfnIsBelowOrder (const uint8_t *scalar)
+	\param		scalar	32 little-endian bytes
+	\return		Returns 1 if the scalar is below L
+*/
+static uint8_t Ed25519_bfnIsBelowOrder (const uint8_t *scalar)
+{
+	uint8_t i;
+
+	for (i = 32; i-- > 0;)
+	{
+		if (scalar[i] != groupOrder[i])
+		{
+			return scalar[i] < groupOrder[i];
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			static void Ed25519_vfnReduce (uint8_t *out, const uint8_t *digest)
+	\param		out		Receives 32 bytes of the digest modulo L
+	\param		digest	HASH_SHA512_DIGEST little-endian bytes
+	\brief		Byte-wise reduction: every byte from the top down is
+				replaced by its multiple of 2^252 = -(L - 2^252), carried
+				signed into the bytes below, then the bits above 2^252 are
+				taken off the same way and the result brought into range.
+				The carries outgrow 32 bits on the way, hence the 64-bit
+				limbs; this runs once per signature.
+*/
+static void Ed25519_vfnReduce (uint8_t *out, const uint8_t *digest)
+{
+	int64_t x[HASH_SHA512_DIGEST];
+	int64_t carry;
+	uint8_t i;
+	uint8_t j;
+
+	for (i = 0; i < HASH_SHA512_DIGEST; i++)
+	{
+		x[i] = digest[i];
+	}
+	for (i = HASH_SHA512_DIGEST - 1u; i >= 32u; i--)
+	{
+		carry = 0;
+		for (j = (uint8_t)(i - 32u); j < (uint8_t)(i - 12u); j++)
+		{
+			x[j] += carry - 16 * x[i] * (int64_t)groupOrder[j - (i - 32u)];
+			carry = (x[j] + 128) >> 8;
+			x[j] -= carry * 256;
+		}
+		x[j] += carry;
+		x[i] = 0;
+	}
+
+	carry = 0;
+	for (j = 0; j < 32u; j++)
+	{
+		x[j] += carry - (x[31] >> 4) * (int64_t)groupOrder[j];
+		carry = x[j] >> 8;
+		x[j] &= 255;
+	}
+	for (j = 0; j < 32u; j++)
+	{
+		x[j] -= carry * (int64_t)groupOrder[j];
+	}
+	for (i = 0; i < 32u; i++)
+	{
+		x[i + 1u] += x[i] >> 8;
+		out[i] = (uint8_t)(x[i] & 255);
+	}
+}
@@ -0,0 +1,39 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Ed25519.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the Ed25519 signature check
+				(RFC 8032). The lock only ever verifies: signatures are
+				made by the installer's tools, which hold the private key.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_ED25519_H_
+#define _4_SL_ED25519_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		ED25519_KEY
+	\brief		Bytes of a public key
+*/
+#define		ED25519_KEY			32u
+
+/*!
+	\def		ED25519_SIGNATURE
+	\brief		Bytes of a signature, R then S
+*/
+#define		ED25519_SIGNATURE	64u
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+uint8_t Ed25519_bfnVerify (const uint8_t *signature, const uint8_t *publicKey,
+		const uint8_t *message, uint16_t length);
+
+#endif /* _4_SL_ED25519_H_ */
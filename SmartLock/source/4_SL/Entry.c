@@ -0,0 +1,340 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Entry.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the pin entry pipeline. The
+				sources put their keys from their interrupts or from the
+				main loop, one session per source: digits are appended, '*'
+				discards the session, '#' completes it, and so does the
+				ENTRY_PIN digit unless ENTRY_REQUIRE_END is defined. A '#'
+				that starts a session makes it a long one, which only '#'
+				completes: "#123456#" is a code, "1234" still a pin. A
+				session left alone for ENTRY_TIMEOUT_MS is discarded.
+
+				A completed entry waits in its source's slot until the state
+				machine takes it; a newer one from the same source replaces
+				it. The slots are taken round robin, starting after the
+				source served last, so a source typing entry after entry
+				cannot keep another one waiting for more than one decision.
+				The time from the last key to the decision is kept per
+				source with the resolution of the system tick.
+
+				Command:
+					$ENTRY		one line per source:
+								ENTRY kp n= clr= to= drop= avg= max=
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "MKL27Z644.h"
+#include "Protocol.h"
+#include "Timebase.h"
+#include "Entry.h"
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		ENTRY_SESSION
+	\brief		Entry being typed on one source, and the last one completed
+*/
+typedef struct
+{
+	uint8_t digits[ENTRY_DIGITS];
+	uint8_t length;
+	uint8_t isOverflowed;
+	uint8_t isLong;		/* started with '#', so only '#' ends it */
+	uint32_t lastMs;
+	ENTRY completed;	/* valid while its pendingSources bit is set */
+} ENTRY_SESSION;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		sessions
+	\brief		One per source, written from the interrupts
+*/
+static volatile ENTRY_SESSION sessions[eENTRY_SOURCES];
+
+/*!
+	\var		openSessions
+	\brief		Bit n set while source n has digits typed, so the idle main
+				loop does not even read the time
+*/
+static volatile uint8_t openSessions = 0;
+
+/*!
+	\var		pendingSources
+	\brief		Bit n set while source n has a completed entry waiting
+*/
+static volatile uint8_t pendingSources = 0;
+
+/*!
+	\var		stats
+	\brief		Counts of every source
+*/
+static ENTRY_STATS stats[eENTRY_SOURCES];
+
+/*!
+	\var		lastServed
+	\brief		Source whose entry was taken last
+*/
+static uint8_t lastServed = eENTRY_SOURCES - 1u;
+
+/*!
+	\var		sourceNames
+	\brief		Reply names of ENTRY_SOURCE
+*/
+static const char * const sourceNames[eENTRY_SOURCES] = {"kp", "bt", "rd"};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Entry_vfnCommand (const char *args);
+static void Entry_vfnExpire (ENTRY_SOURCE source, uint32_t now);
+static void Entry_vfnComplete (ENTRY_SOURCE source, uint32_t now);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Entry_vfnInit (void)
+	\brief		Empties every session and registers "$ENTRY"
+*/
+void Entry_vfnInit (void)
+{
+	memset ((void *)sessions, 0, sizeof (sessions));
+	memset (stats, 0, sizeof (stats));
+	openSessions = 0;
+	pendingSources = 0;
+	lastServed = eENTRY_SOURCES - 1u;
+
+	Protocol_bfnRegister ("ENTRY", Entry_vfnCommand);
+}
+
+/*!
+	\fn			void Entry_vfnPut (ENTRY_SOURCE source, uint8_t key)
+	\param		source	Input the key came from
+	\param		key		Digit 0 to 9, ENTRY_CLEAR or ENTRY_END; anything
+						else is ignored
+	\brief		Safe from the interrupts and from the main loop: the
+				interrupts are masked while the session changes
+*/
+void Entry_vfnPut (ENTRY_SOURCE source, uint8_t key)
+{
+	volatile ENTRY_SESSION *session = &sessions[source];
+	uint32_t primask = __get_PRIMASK ();
+	uint32_t now = Timebase_dwfnGetMs ();
+
+	if ((key > 9u) && (key != ENTRY_CLEAR) && (key != ENTRY_END))
+	{
+		return;
+	}
+
+	__disable_irq ();
+	Entry_vfnExpire (source, now);
+	if (key == ENTRY_CLEAR)
+	{
+		if (session->length)
+		{
+			stats[source].cleared++;
+		}
+		session->length = 0;
+		session->isOverflowed = 0;
+		session->isLong = 0;
+		openSessions &= (uint8_t)~(1u << source);
+	}
+	else if (key == ENTRY_END)
+	{
+		if (session->length)
+		{
+			Entry_vfnComplete (source, now);
+		}
+		else
+		{
+			session->isLong = 1;
+			session->lastMs = now;
+			openSessions |= (uint8_t)(1u << source);
+		}
+	}
+	else
+	{
+		if (session->length < ENTRY_DIGITS)
+		{
+			session->digits[session->length] = key;
+		}
+		else
+		{
+			session->isOverflowed = 1;
+		}
+		session->length++;
+		session->lastMs = now;
+		openSessions |= (uint8_t)(1u << source);
+#ifndef ENTRY_REQUIRE_END
+		if ((session->length == ENTRY_PIN) && !session->isLong)
+		{
+			Entry_vfnComplete (source, now);
+		}
+#endif
+	}
+	__set_PRIMASK (primask);
+}
+
+/*!
+	\fn			void Entry_vfnTask (void)
+	\brief		Discards the sessions nobody typed into for ENTRY_TIMEOUT_MS,
+				so half a pin does not stay in RAM
+*/
+void Entry_vfnTask (void)
+{
+	uint32_t primask;
+	uint32_t now;
+	uint8_t source;
+
+	if (!openSessions)
+	{
+		return;
+	}
+	primask = __get_PRIMASK ();
+	now = Timebase_dwfnGetMs ();
+	for (source = 0; source < eENTRY_SOURCES; source++)
+	{
+		__disable_irq ();
+		Entry_vfnExpire ((ENTRY_SOURCE)source, now);
+		__set_PRIMASK (primask);
+	}
+}
+
+/*!
+	\fn			uint8_t Entry_bfnTake (ENTRY *entry)
+	\param		entry	Receives the next completed entry
+	\return		Returns 1 if an entry was waiting; else, returns 0
+	\brief		Serves the sources round robin from the one after the source
+				served last
+*/
+uint8_t Entry_bfnTake (ENTRY *entry)
+{
+	uint32_t primask;
+	uint8_t source = lastServed;
+	uint8_t i;
+
+	if (!pendingSources)
+	{
+		return 0;
+	}
+	primask = __get_PRIMASK ();
+	for (i = 0; i < eENTRY_SOURCES; i++)
+	{
+		source = (uint8_t)((source + 1u) % eENTRY_SOURCES);
+		if (!(pendingSources & (1u << source)))
+		{
+			continue;
+		}
+		__disable_irq ();
+		*entry = *(const ENTRY *)&sessions[source].completed;
+		pendingSources &= (uint8_t)~(1u << source);
+		__set_PRIMASK (primask);
+		lastServed = source;
+		return 1;
+	}
+	return 0;
+}
+
+/*!
+	\fn			void Entry_vfnDecided (const ENTRY *entry)
+	\param		entry	Entry taken with Entry_bfnTake, once it was verified
+	\brief		Accounts the time since its last key
+*/
+void Entry_vfnDecided (const ENTRY *entry)
+{
+	ENTRY_STATS *source = &stats[entry->source];
+	uint32_t latency = Timebase_dwfnGetMs () - entry->endMs;
+
+	source->decided++;
+	source->latencySumMs += latency;
+	if (latency > source->latencyMaxMs)
+	{
+		source->latencyMaxMs = latency;
+	}
+}
+
+/*!
+	\fn			void Entry_vfnGetStats (ENTRY_SOURCE source, ENTRY_STATS *out)
+	\param		out		Receives the counts of the source since power-on
+*/
+void Entry_vfnGetStats (ENTRY_SOURCE source, ENTRY_STATS *out)
+{
+	*out = stats[source];
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Entry_vfnCommand (const char *args)
+	\brief		"$ENTRY": the counts and the decision latency of every source
+*/
+static void Entry_vfnCommand (const char *args)
+{
+	uint8_t source;
+
+	(void)args;
+	for (source = 0; source < eENTRY_SOURCES; source++)
+	{
+		Protocol_vfnReply ("ENTRY %s n=%u clr=%u to=%u drop=%u avg=%u max=%u", sourceNames[source],
+				stats[source].completed, stats[source].cleared, stats[source].timeouts,
+				stats[source].dropped,
+				stats[source].decided ? (stats[source].latencySumMs / stats[source].decided) : 0u,
+				stats[source].latencyMaxMs);
+	}
+}
+
+/*!
+	\fn			static void Entry_vfnExpire (ENTRY_SOURCE source, uint32_t now)
+	\brief		Discards the session if its last key is ENTRY_TIMEOUT_MS old,
+				a lone '#' included. The interrupts must be masked.
+*/
+static void Entry_vfnExpire (ENTRY_SOURCE source, uint32_t now)
+{
+	volatile ENTRY_SESSION *session = &sessions[source];
+
+	if ((session->length || session->isLong) && ((now - session->lastMs) >= ENTRY_TIMEOUT_MS))
+	{
+		session->length = 0;
+		session->isOverflowed = 0;
+		session->isLong = 0;
+		openSessions &= (uint8_t)~(1u << source);
+		stats[source].timeouts++;
+	}
+}
+
+/*!
+	\fn			static void Entry_vfnComplete (ENTRY_SOURCE source, uint32_t now)
+	\brief		Moves the session to the source's slot, replacing an entry
+				still waiting there. An overflowed session is dropped. The
+				interrupts must be masked.
+*/
+static void Entry_vfnComplete (ENTRY_SOURCE source, uint32_t now)
+{
+	volatile ENTRY_SESSION *session = &sessions[source];
+
+	if (session->isOverflowed || (pendingSources & (1u << source)))
+	{
+		stats[source].dropped++;
+	}
+	if (!session->isOverflowed)
+	{
+		memcpy ((void *)session->completed.digits, (const void *)session->digits, ENTRY_DIGITS);
+		session->completed.length = session->length;
+		session->completed.source = (uint8_t)source;
+		session->completed.endMs = now;
+		pendingSources |= (uint8_t)(1u << source);
+		stats[source].completed++;
+	}
+	session->length = 0;
+	session->isOverflowed = 0;
+	session->isLong = 0;
+	openSessions &= (uint8_t)~(1u << source);
+}
@@ -0,0 +1,595 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Hash.c
+	\date		October 19th, 2026
+	\brief		Function implementation of SHA-1, SHA-256 and HMAC. The
+				message schedule is kept as a ring of 16 words updated in
+				place rather than the 80 or 64 words of the standard, so a
+				compression needs no more than 64 bytes of stack on the
+				Cortex-M0+, and every rotation is a single ROR. SHA-512
+				works on 64-bit words the M0+ handles as register pairs;
+				it only hashes the few short messages of a signature.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "Hash.h"
+#include "RamFunc.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		ROR
+	\brief		Rotates a word right; compiles to a single instruction
+*/
+#define		ROR(x, n)			(((x) >> (n)) | ((x) << (32u - (n))))
+
+/*!
+	\def		ROR64
+	\brief		Rotates a 64-bit word right
+*/
+#define		ROR64(x, n)			(((x) >> (n)) | ((x) << (64u - (n))))
+
+/*!
+	\def		SHA512_LENGTH_BYTES
+	\brief		Bytes of the bit length that ends the SHA-512 padding
+*/
+#define		SHA512_LENGTH_BYTES	16u
+
+/*!
+	\def		LENGTH_BYTES
+	\brief		Bytes of the bit length that ends the padding
+*/
+#define		LENGTH_BYTES		8u
+
+/*!
+	\def		HMAC_IPAD, HMAC_OPAD
+	\brief		Bytes the key is xored with for the inner and outer hash
+*/
+#define		HMAC_IPAD			0x36u
+#define		HMAC_OPAD			0x5Cu
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		sha1Initial
+	\brief		Initial state of SHA-1
+*/
+static const uint32_t sha1Initial[5] =
+{
+		0x67452301u, 0xEFCDAB89u, 0x98BADCFEu, 0x10325476u, 0xC3D2E1F0u
+};
+
+/*!
+	\var		sha256Initial
+	\brief		Initial state of SHA-256
+*/
+static const uint32_t sha256Initial[8] =
+{
+		0x6A09E667u, 0xBB67AE85u, 0x3C6EF372u, 0xA54FF53Au,
+		0x510E527Fu, 0x9B05688Cu, 0x1F83D9ABu, 0x5BE0CD19u
+};
+
+/*!
+	\var		sha256Rounds
+	\brief		Round constants of SHA-256
+*/
+static const uint32_t sha256Rounds[64] =
+{
+		0x428A2F98u, 0x71374491u, 0xB5C0FBCFu, 0xE9B5DBA5u,
+		0x3956C25Bu, 0x59F111F1u, 0x923F82A4u, 0xAB1C5ED5u,
+		0xD807AA98u, 0x12835B01u, 0x243185BEu, 0x550C7DC3u,
+		0x72BE5D74u, 0x80DEB1FEu, 0x9BDC06A7u, 0xC19BF174u,
+		0xE49B69C1u, 0xEFBE4786u, 0x0FC19DC6u, 0x240CA1CCu,
+		0x2DE92C6Fu, 0x4A7484AAu, 0x5CB0A9DCu, 0x76F988DAu,
+		0x983E5152u, 0xA831C66Du, 0xB00327C8u, 0xBF597FC7u,
+		0xC6E00BF3u, 0xD5A79147u, 0x06CA6351u, 0x14292967u,
+		0x27B70A85u, 0x2E1B2138u, 0x4D2C6DFCu, 0x53380D13u,
+		0x650A7354u, 0x766A0ABBu, 0x81C2C92Eu, 0x92722C85u,
+		0xA2BFE8A1u, 0xA81A664Bu, 0xC24B8B70u, 0xC76C51A3u,
+		0xD192E819u, 0xD6990624u, 0xF40E3585u, 0x106AA070u,
+		0x19A4C116u, 0x1E376C08u, 0x2748774Cu, 0x34B0BCB5u,
+		0x391C0CB3u, 0x4ED8AA4Au, 0x5B9CCA4Fu, 0x682E6FF3u,
+		0x748F82EEu, 0x78A5636Fu, 0x84C87814u, 0x8CC70208u,
+		0x90BEFFFAu, 0xA4506CEBu, 0xBEF9A3F7u, 0xC67178F2u
+};
+
+/*!
+	\var		sha512Initial
+	\brief		Initial state of SHA-512
+*/
+static const uint64_t sha512Initial[8] =
+{
+		0x6A09E667F3BCC908ULL, 0xBB67AE8584CAA73BULL,
+		0x3C6EF372FE94F82BULL, 0xA54FF53A5F1D36F1ULL,
+		0x510E527FADE682D1ULL, 0x9B05688C2B3E6C1FULL,
+		0x1F83D9ABFB41BD6BULL, 0x5BE0CD19137E2179ULL
+};
+
+/*!
+	\var		sha512Rounds
+	\brief		Round constants of SHA-512
+*/
+static const uint64_t sha512Rounds[80] =
+{
+		0x428A2F98D728AE22ULL, 0x7137449123EF65CDULL,
+		0xB5C0FBCFEC4D3B2FULL, 0xE9B5DBA58189DBBCULL,
+		0x3956C25BF348B538ULL, 0x59F111F1B605D019ULL,
+		0x923F82A4AF194F9BULL, 0xAB1C5ED5DA6D8118ULL,
+		0xD807AA98A3030242ULL, 0x12835B0145706FBEULL,
+		0x243185BE4EE4B28CULL, 0x550C7DC3D5FFB4E2ULL,
+		0x72BE5D74F27B896FULL, 0x80DEB1FE3B1696B1ULL,
+		0x9BDC06A725C71235ULL, 0xC19BF174CF692694ULL,
+		0xE49B69C19EF14AD2ULL, 0xEFBE4786384F25E3ULL,
+		0x0FC19DC68B8CD5B5ULL, 0x240CA1CC77AC9C65ULL,
+		0x2DE92C6F592B0275ULL, 0x4A7484AA6EA6E483ULL,
+		0x5CB0A9DCBD41FBD4ULL, 0x76F988DA831153B5ULL,
+		0x983E5152EE66DFABULL, 0xA831C66D2DB43210ULL,
+		0xB00327C898FB213FULL, 0xBF597FC7BEEF0EE4ULL,
+		0xC6E00BF33DA88FC2ULL, 0xD5A79147930AA725ULL,
+		0x06CA6351E003826FULL, 0x142929670A0E6E70ULL,
+		0x27B70A8546D22FFCULL, 0x2E1B21385C26C926ULL,
+		0x4D2C6DFC5AC42AEDULL, 0x53380D139D95B3DFULL,
+		0x650A73548BAF63DEULL, 0x766A0ABB3C77B2A8ULL,
+		0x81C2C92E47EDAEE6ULL, 0x92722C851482353BULL,
+		0xA2BFE8A14CF10364ULL, 0xA81A664BBC423001ULL,
+		0xC24B8B70D0F89791ULL, 0xC76C51A30654BE30ULL,
+		0xD192E819D6EF5218ULL, 0xD69906245565A910ULL,
+		0xF40E35855771202AULL, 0x106AA07032BBD1B8ULL,
+		0x19A4C116B8D2D0C8ULL, 0x1E376C085141AB53ULL,
+		0x2748774CDF8EEB99ULL, 0x34B0BCB5E19B48A8ULL,
+		0x391C0CB3C5C95A63ULL, 0x4ED8AA4AE3418ACBULL,
+		0x5B9CCA4F7763E373ULL, 0x682E6FF3D6B2B8A3ULL,
+		0x748F82EE5DEFB2FCULL, 0x78A5636F43172F60ULL,
+		0x84C87814A1F0AB72ULL, 0x8CC702081A6439ECULL,
+		0x90BEFFFA23631E28ULL, 0xA4506CEBDE82BDE9ULL,
+		0xBEF9A3F7B2C67915ULL, 0xC67178F2E372532BULL,
+		0xCA273ECEEA26619CULL, 0xD186B8C721C0C207ULL,
+		0xEADA7DD6CDE0EB1EULL, 0xF57D4F7FEE6ED178ULL,
+		0x06F067AA72176FBAULL, 0x0A637DC5A2C898A6ULL,
+		0x113F9804BEF90DAEULL, 0x1B710B35131C471BULL,
+		0x28DB77F523047D84ULL, 0x32CAAB7B40C72493ULL,
+		0x3C9EBE0A15C9BEBCULL, 0x431D67C49C100D4CULL,
+		0x4CC5D4BECB3E42B6ULL, 0x597F299CFC657E2AULL,
+		0x5FCB6FAB3AD6FAECULL, 0x6C44198C4A475817ULL
+};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Hash_vfnCompress (HASH_CONTEXT *context);
+static void Hash_vfnSha512 (HASH_SHA512_CONTEXT *context);
+static RAMFUNC_HOT void Hash_vfnSha1 (uint32_t *state, uint32_t *w);
+static RAMFUNC_HOT void Hash_vfnSha256 (uint32_t *state, uint32_t *w);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			uint8_t Hash_bfnDigestSize (HASH_ALGORITHM algorithm)
+	\return		Returns the bytes of a digest of the hash
+*/
+uint8_t Hash_bfnDigestSize (HASH_ALGORITHM algorithm)
+{
+	return (algorithm == eHASH_SHA1) ? 20u : 32u;
+}
+
+/*!
+	\fn			void Hash_vfnStart (HASH_CONTEXT *context, HASH_ALGORITHM algorithm)
+	\param		context		Receives the initial state of the hash
+*/
+void Hash_vfnStart (HASH_CONTEXT *context, HASH_ALGORITHM algorithm)
+{
+	uint8_t i;
+
+	for (i = 0; i < 8u; i++)
+	{
+		context->state[i] = (algorithm == eHASH_SHA1) ? ((i < 5u) ? sha1Initial[i] : 0) : sha256Initial[i];
+	}
+	context->length = 0;
+	context->fill = 0;
+	context->algorithm = (uint8_t)algorithm;
+}
+
+/*!
+	\fn			void Hash_vfnUpdate (HASH_CONTEXT *context, const uint8_t *data, uint32_t length)
+	\param		data	Next bytes of the message
+*/
+void Hash_vfnUpdate (HASH_CONTEXT *context, const uint8_t *data, uint32_t length)
+{
+	context->length += length;
+	while (length--)
+	{
+		context->block[context->fill++] = *data++;
+		if (context->fill == HASH_BLOCK)
+		{
+			Hash_vfnCompress (context);
+			context->fill = 0;
+		}
+	}
+}
+
+/*!
+	\fn			void Hash_vfnFinish (HASH_CONTEXT *context, uint8_t *digest)
+	\param		digest	Receives Hash_bfnDigestSize bytes
+	\brief		Pads with 0x80, zeros and the bit length, big-endian
+*/
+void Hash_vfnFinish (HASH_CONTEXT *context, uint8_t *digest)
+{
+	uint32_t bits = context->length << 3;
+	uint8_t size = Hash_bfnDigestSize ((HASH_ALGORITHM)context->algorithm);
+	uint8_t i;
+
+	context->block[context->fill++] = 0x80u;
+	if (context->fill > (HASH_BLOCK - LENGTH_BYTES))
+	{
+		while (context->fill < HASH_BLOCK)
+		{
+			context->block[context->fill++] = 0;
+		}
+		Hash_vfnCompress (context);
+		context->fill = 0;
+	}
+	while (context->fill < (HASH_BLOCK - 4u))
+	{
+		context->block[context->fill++] = 0;
+	}
+	context->block[HASH_BLOCK - 5u] = (uint8_t)(context->length >> 29);
+	context->block[HASH_BLOCK - 4u] = (uint8_t)(bits >> 24);
+	context->block[HASH_BLOCK - 3u] = (uint8_t)(bits >> 16);
+	context->block[HASH_BLOCK - 2u] = (uint8_t)(bits >> 8);
+	context->block[HASH_BLOCK - 1u] = (uint8_t)bits;
+	Hash_vfnCompress (context);
+
+	for (i = 0; i < size; i++)
+	{
+		digest[i] = (uint8_t)(context->state[i >> 2] >> (24u - 8u * (i & 3u)));
+	}
+}
+
+/*!
+	\fn			void Hash_vfnHmacKey (HASH_HMAC_KEY *key, HASH_ALGORITHM algorithm, const uint8_t *secret, uint16_t length)
+	\param		key		Receives the states after the padded key blocks
+	\param		secret	Key bytes; a key longer than a block is hashed first
+*/
+void Hash_vfnHmacKey (HASH_HMAC_KEY *key, HASH_ALGORITHM algorithm, const uint8_t *secret, uint16_t length)
+{
+	HASH_CONTEXT context;
+	uint8_t block[HASH_BLOCK] = {0};
+	uint8_t i;
+
+	if (length > HASH_BLOCK)
+	{
+		Hash_vfnStart (&context, algorithm);
+		Hash_vfnUpdate (&context, secret, length);
+		Hash_vfnFinish (&context, block);
+	}
+	else
+	{
+		for (i = 0; i < length; i++)
+		{
+			block[i] = secret[i];
+		}
+	}
+
+	for (i = 0; i < HASH_BLOCK; i++)
+	{
+		block[i] ^= HMAC_IPAD;
+	}
+	Hash_vfnStart (&context, algorithm);
+	Hash_vfnUpdate (&context, block, HASH_BLOCK);
+	for (i = 0; i < 8u; i++)
+	{
+		key->inner[i] = context.state[i];
+	}
+
+	for (i = 0; i < HASH_BLOCK; i++)
+	{
+		block[i] ^= HMAC_IPAD ^ HMAC_OPAD;
+	}
+	Hash_vfnStart (&context, algorithm);
+	Hash_vfnUpdate (&context, block, HASH_BLOCK);
+	for (i = 0; i < 8u; i++)
+	{
+		key->outer[i] = context.state[i];
+	}
+	key->algorithm = (uint8_t)algorithm;
+
+	for (i = 0; i < HASH_BLOCK; i++)
+	{
+		((volatile uint8_t *)block)[i] = 0;
+		((volatile uint8_t *)context.block)[i] = 0;
+	}
+}
+
+/*!
+	\fn			void Hash_vfnHmac (const HASH_HMAC_KEY *key, const uint8_t *message, uint16_t length, uint8_t *mac)
+	\param		mac		Receives the digest size of the key's hash
+	\brief		Resumes both hashes after their key block
+*/
+void Hash_vfnHmac (const HASH_HMAC_KEY *key, const uint8_t *message, uint16_t length, uint8_t *mac)
+{
+	HASH_CONTEXT context;
+	uint8_t i;
+
+	for (i = 0; i < 8u; i++)
+	{
+		context.state[i] = key->inner[i];
+	}
+	context.length = HASH_BLOCK;
+	context.fill = 0;
+	context.algorithm = key->algorithm;
+	Hash_vfnUpdate (&context, message, length);
+	Hash_vfnFinish (&context, mac);
+
+	for (i = 0; i < 8u; i++)
+	{
+		context.state[i] = key->outer[i];
+	}
+	context.length = HASH_BLOCK;
+	context.fill = 0;
+	Hash_vfnUpdate (&context, mac, Hash_bfnDigestSize ((HASH_ALGORITHM)key->algorithm));
+	Hash_vfnFinish (&context, mac);
+}
+
+/*!
+	\fn			void Hash_vfnSha512Start (HASH_SHA512_CONTEXT *context)
+	\param		context		Receives the initial state of SHA-512
+*/
+void Hash_vfnSha512Start (HASH_SHA512_CONTEXT *context)
+{
+	uint8_t i;
+
+	for (i = 0; i < 8u; i++)
+	{
+		context->state[i] = sha512Initial[i];
+	}
+	context->length = 0;
+	context->fill = 0;
+}
+
+/*!
+	\fn			void Hash_vfnSha512Update (HASH_SHA512_CONTEXT *context, const uint8_t *data, uint32_t length)
+	\param		data	Next bytes of the message
+*/
+void Hash_vfnSha512Update (HASH_SHA512_CONTEXT *context, const uint8_t *data, uint32_t length)
+{
+	context->length += length;
+	while (length--)
+	{
+		context->block[context->fill++] = *data++;
+		if (context->fill == HASH_SHA512_BLOCK)
+		{
+			Hash_vfnSha512 (context);
+			context->fill = 0;
+		}
+	}
+}
+
+/*!
+	\fn			void Hash_vfnSha512Finish (HASH_SHA512_CONTEXT *context, uint8_t *digest)
+	\param		digest	Receives HASH_SHA512_DIGEST bytes
+	\brief		Pads with 0x80, zeros and the 128-bit bit length
+*/
+void Hash_vfnSha512Finish (HASH_SHA512_CONTEXT *context, uint8_t *digest)
+{
+	uint32_t bits = context->length << 3;
+	uint8_t i;
+
+	context->block[context->fill++] = 0x80u;
+	if (context->fill > (HASH_SHA512_BLOCK - SHA512_LENGTH_BYTES))
+	{
+		while (context->fill < HASH_SHA512_BLOCK)
+		{
+			context->block[context->fill++] = 0;
+		}
+		Hash_vfnSha512 (context);
+		context->fill = 0;
+	}
+	while (context->fill < (HASH_SHA512_BLOCK - 4u))
+	{
+		context->block[context->fill++] = 0;
+	}
+	context->block[HASH_SHA512_BLOCK - 5u] = (uint8_t)(context->length >> 29);
+	context->block[HASH_SHA512_BLOCK - 4u] = (uint8_t)(bits >> 24);
+	context->block[HASH_SHA512_BLOCK - 3u] = (uint8_t)(bits >> 16);
+	context->block[HASH_SHA512_BLOCK - 2u] = (uint8_t)(bits >> 8);
+	context->block[HASH_SHA512_BLOCK - 1u] = (uint8_t)bits;
+	Hash_vfnSha512 (context);
+
+	for (i = 0; i < HASH_SHA512_DIGEST; i++)
+	{
+		digest[i] = (uint8_t)(context->state[i >> 3] >> (56u - 8u * (i & 7u)));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Hash_vfnCompress (HASH_CONTEXT *context)
+	\brief		Loads the block as big-endian words and runs the hash on it
+*/
+static void Hash_vfnCompress (HASH_CONTEXT *context)
+{
+	uint32_t w[16];
+	const uint8_t *block = context->block;
+	uint8_t i;
+
+	for (i = 0; i < 16u; i++, block += 4)
+	{
+		w[i] = ((uint32_t)block[0] << 24) | ((uint32_t)block[1] << 16) |
+				((uint32_t)block[2] << 8) | (uint32_t)block[3];
+	}
+	if (context->algorithm == eHASH_SHA1)
+	{
+		Hash_vfnSha1 (context->state, w);
+	}
+	else
+	{
+		Hash_vfnSha256 (context->state, w);
+	}
+}
+
+/*!
+	\fn			static void Hash_vfnSha512 (HASH_SHA512_CONTEXT *context)
+	\brief		Runs SHA-512 on the block, its schedule a ring of 16 words
+*/
+static void Hash_vfnSha512 (HASH_SHA512_CONTEXT *context)
+{
+	uint64_t w[16];
+	uint64_t s[8];
+	uint64_t t1;
+	uint64_t t2;
+	uint64_t x;
+	uint64_t y;
+	const uint8_t *block = context->block;
+	uint8_t t;
+	uint8_t i;
+
+	for (i = 0; i < 16u; i++)
+	{
+		w[i] = 0;
+		for (t = 0; t < 8u; t++)
+		{
+			w[i] = (w[i] << 8) | *block++;
+		}
+	}
+	for (i = 0; i < 8u; i++)
+	{
+		s[i] = context->state[i];
+	}
+
+	for (t = 0; t < 80u; t++)
+	{
+		if (t >= 16u)
+		{
+			x = w[(t - 15u) & 15u];
+			y = w[(t - 2u) & 15u];
+			w[t & 15u] += (ROR64 (y, 19) ^ ROR64 (y, 61) ^ (y >> 6)) + w[(t - 7u) & 15u] +
+					(ROR64 (x, 1) ^ ROR64 (x, 8) ^ (x >> 7));
+		}
+		t1 = s[7] + (ROR64 (s[4], 14) ^ ROR64 (s[4], 18) ^ ROR64 (s[4], 41)) +
+				(s[6] ^ (s[4] & (s[5] ^ s[6]))) + sha512Rounds[t] + w[t & 15u];
+		t2 = (ROR64 (s[0], 28) ^ ROR64 (s[0], 34) ^ ROR64 (s[0], 39)) +
+				((s[0] & s[1]) | (s[2] & (s[0] | s[1])));
+		for (i = 7; i > 0; i--)
+		{
+			s[i] = s[i - 1u];
+		}
+		s[4] += t1;
+		s[0] = t1 + t2;
+	}
+
+	for (i = 0; i < 8u; i++)
+	{
+		context->state[i] += s[i];
+	}
+}
+
+/*!
+	\fn			static void Hash_vfnSha1 (uint32_t *state, uint32_t *w)
+	\param		w		Block words, used as the ring of the schedule
+*/
+static RAMFUNC_HOT void Hash_vfnSha1 (uint32_t *state, uint32_t *w)
+{
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+	uint32_t f;
+	uint32_t x;
+	uint8_t t;
+
+	for (t = 0; t < 80u; t++)
+	{
+		if (t >= 16u)
+		{
+			x = w[(t - 3u) & 15u] ^ w[(t - 8u) & 15u] ^ w[(t - 14u) & 15u] ^ w[t & 15u];
+			w[t & 15u] = ROR (x, 31);
+		}
+		if (t < 20u)
+		{
+			f = (d ^ (b & (c ^ d))) + 0x5A827999u;
+		}
+		else if (t < 40u)
+		{
+			f = (b ^ c ^ d) + 0x6ED9EBA1u;
+		}
+		else if (t < 60u)
+		{
+			f = ((b & c) | (d & (b | c))) + 0x8F1BBCDCu;
+		}
+		else
+		{
+			f = (b ^ c ^ d) + 0xCA62C1D6u;
+		}
+		x = ROR (a, 27) + f + e + w[t & 15u];
+		e = d;
+		d = c;
+		c = ROR (b, 2);
+		b = a;
+		a = x;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
+
+/*!
+	\fn			static void Hash_vfnSha256 (uint32_t *state, uint32_t *w)
+	\param		w		Block words, used as the ring of the schedule
+*/
+static RAMFUNC_HOT void Hash_vfnSha256 (uint32_t *state, uint32_t *w)
+{
+	uint32_t a = state[0];
+	uint32_t b = state[1];
+	uint32_t c = state[2];
+	uint32_t d = state[3];
+	uint32_t e = state[4];
+	uint32_t f = state[5];
+	uint32_t g = state[6];
+	uint32_t h = state[7];
+	uint32_t t1;
+	uint32_t t2;
+	uint32_t x;
+	uint32_t y;
+	uint8_t t;
+
+	for (t = 0; t < 64u; t++)
+	{
+		if (t >= 16u)
+		{
+			x = w[(t - 15u) & 15u];
+			y = w[(t - 2u) & 15u];
+			w[t & 15u] += (ROR (y, 17) ^ ROR (y, 19) ^ (y >> 10)) + w[(t - 7u) & 15u] +
+					(ROR (x, 7) ^ ROR (x, 18) ^ (x >> 3));
+		}
+		t1 = h + (ROR (e, 6) ^ ROR (e, 11) ^ ROR (e, 25)) + (g ^ (e & (f ^ g))) +
+				sha256Rounds[t] + w[t & 15u];
+		t2 = (ROR (a, 2) ^ ROR (a, 13) ^ ROR (a, 22)) + ((a & b) | (c & (a | b)));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
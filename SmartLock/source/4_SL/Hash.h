@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Hash.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the SHA-1 and SHA-256 hashes and of
+				HMAC (RFC 2104) over them. An HMAC key is kept as the two
+				hash states after its padded blocks, so a MAC of a short
+				message costs two compressions instead of four. SHA-512,
+				which Ed25519 signatures are built on, has a context of
+				its own: its 64-bit words would double the others.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_HASH_H_
+#define _4_SL_HASH_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		HASH_BLOCK
+	\brief		Bytes of a block of either hash
+*/
+#define		HASH_BLOCK			64u
+
+/*!
+	\def		HASH_MAX_DIGEST
+	\brief		Bytes of the longest digest
+*/
+#define		HASH_MAX_DIGEST		32u
+
+/*!
+	\def		HASH_SHA512_BLOCK
+	\brief		Bytes of a SHA-512 block
+*/
+#define		HASH_SHA512_BLOCK	128u
+
+/*!
+	\def		HASH_SHA512_DIGEST
+	\brief		Bytes of a SHA-512 digest
+*/
+#define		HASH_SHA512_DIGEST	64u
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		HASH_ALGORITHM
+	\brief		Hashes available
+*/
+typedef enum
+{
+	eHASH_SHA1,
+	eHASH_SHA256,
+	eHASH_ALGORITHMS
+} HASH_ALGORITHM;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		HASH_CONTEXT
+	\brief		Hash being computed
+*/
+typedef struct
+{
+	uint32_t state[8];
+	uint32_t length;
+	uint8_t block[HASH_BLOCK];
+	uint8_t fill;
+	uint8_t algorithm;
+} HASH_CONTEXT;
+
+/*!
+	\struct		HASH_HMAC_KEY
+	\brief		HMAC key as the states after the inner and the outer pad
+*/
+typedef struct
+{
+	uint32_t inner[8];
+	uint32_t outer[8];
+	uint8_t algorithm;
+} HASH_HMAC_KEY;
+
+/*!
+	\struct		HASH_SHA512_CONTEXT
+	\brief		SHA-512 being computed
+*/
+typedef struct
+{
+	uint64_t state[8];
+	uint32_t length;
+	uint8_t block[HASH_SHA512_BLOCK];
+	uint8_t fill;
+} HASH_SHA512_CONTEXT;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+uint8_t Hash_bfnDigestSize (HASH_ALGORITHM algorithm);
+
+void Hash_vfnStart (HASH_CONTEXT *context, HASH_ALGORITHM algorithm);
+
+void Hash_vfnUpdate (HASH_CONTEXT *context, const uint8_t *data, uint32_t length);
+
+void Hash_vfnFinish (HASH_CONTEXT *context, uint8_t *digest);
+
+void Hash_vfnHmacKey (HASH_HMAC_KEY *key, HASH_ALGORITHM algorithm, const uint8_t *secret, uint16_t length);
+
+void Hash_vfnHmac (const HASH_HMAC_KEY *key, const uint8_t *message, uint16_t length, uint8_t *mac);
+
+void Hash_vfnSha512Start (HASH_SHA512_CONTEXT *context);
+
+void Hash_vfnSha512Update (HASH_SHA512_CONTEXT *context, const uint8_t *data, uint32_t length);
+
+void Hash_vfnSha512Finish (HASH_SHA512_CONTEXT *context, uint8_t *digest);
+
+#endif /* _4_SL_HASH_H_ */
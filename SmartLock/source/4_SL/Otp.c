@@ -0,0 +1,448 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Otp.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the one-time codes. A slot keeps
+				its secret only as the two HMAC states after the padded key
+				blocks, so a code costs two compressions, and a table of the
+				codes of the next OTP_WINDOW counters, or of the time steps
+				from OTP_SKEW before the current one.
+
+				Otp_vfnTask computes at most one missing code per pass of
+				the main loop. A code typed before its table is complete
+				computes what it needs on the spot, and the statistics count
+				those refills. The table is scanned to its end whatever
+				entry matches, so the time a check takes tells nothing of
+				which counter the code was for.
+
+				The RTC holds local time; TOTP runs on UTC, so the offset
+				of the time zone is taken off before the time is divided
+				into steps.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "RTC.h"
+#include "Otp.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		OTP_IS_TOTP
+	\brief		Whether a kind counts time steps
+*/
+#define		OTP_IS_TOTP(kind)	(((kind) & 2u) != 0u)
+
+/*!
+	\def		OTP_ALGORITHM
+	\brief		Hash of a kind
+*/
+#define		OTP_ALGORITHM(kind)	(((kind) & 1u) ? eHASH_SHA256 : eHASH_SHA1)
+
+/*!
+	\def		TOTP_SPAN
+	\brief		Entries of a TOTP table a code is checked against
+*/
+#define		TOTP_SPAN			(2u * OTP_SKEW + 1u)
+
+/*!
+	\def		COUNTER_BYTES
+	\brief		Bytes of the big-endian counter the HMAC is taken of
+*/
+#define		COUNTER_BYTES		8u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		OTP_SLOT
+	\brief		Generator of a user
+*/
+typedef struct
+{
+	HASH_HMAC_KEY key;
+	uint32_t base;				/* counter or time step of codes[0] */
+	uint32_t nextStep;			/* oldest TOTP step not used yet */
+	uint32_t codes[OTP_WINDOW];
+	uint8_t ready;				/* entries of codes[] computed */
+	uint8_t kind;
+	uint8_t isUsed;
+} OTP_SLOT;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		slots
+	\brief		Generators
+*/
+static OTP_SLOT slots[OTP_SLOTS];
+
+/*!
+	\var		zoneSeconds
+	\brief		Offset of local time from UTC
+*/
+static int32_t zoneSeconds = 0;
+
+/*!
+	\var		cursor
+	\brief		Slot Otp_vfnTask looks at first
+*/
+static uint8_t cursor = 0;
+
+/*!
+	\var		isComplete
+	\brief		Set while every table is complete as of checkedTime, so the
+				idle main loop only reads the RTC
+*/
+static uint8_t isComplete = 0;
+
+/*!
+	\var		checkedTime
+	\brief		Time the tables were last found complete at
+*/
+static uint32_t checkedTime = 0;
+
+/*!
+	\var		stats
+	\brief		Counts of the checks
+*/
+static OTP_STATS stats;
+
+/*!
+	\var		powersOfTen
+	\brief		Modulus of a code of each length
+*/
+static const uint32_t powersOfTen[10] =
+{
+	1u, 10u, 100u, 1000u, 10000u, 100000u, 1000000u, 10000000u, 100000000u, 1000000000u
+};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static uint8_t Otp_bfnFirstStep (uint32_t now, uint32_t *first);
+static void Otp_vfnAlign (OTP_SLOT *slot, uint32_t first);
+static void Otp_vfnFill (OTP_SLOT *slot);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Otp_vfnInit (void)
+	\brief		Frees every slot
+*/
+void Otp_vfnInit (void)
+{
+	uint8_t i;
+
+	for (i = 0; i < OTP_SLOTS; i++)
+	{
+		Otp_vfnRemove (i);
+	}
+	memset (&stats, 0, sizeof (stats));
+	cursor = 0;
+	isComplete = 0;
+}
+
+/*!
+	\fn			uint8_t Otp_bfnAdd (OTP_KIND kind, const uint8_t *secret, uint8_t length, uint32_t counter)
+	\param		secret	Key shared with the generator, at most OTP_SECRET_MAX bytes
+	\param		counter	Next HOTP counter of the generator; unused for TOTP
+	\return		Returns the slot of the generator, or OTP_NONE if none is free
+*/
+uint8_t Otp_bfnAdd (OTP_KIND kind, const uint8_t *secret, uint8_t length, uint32_t counter)
+{
+	OTP_SLOT *slot;
+	uint8_t i;
+
+	if ((kind >= eOTP_KINDS) || (length > OTP_SECRET_MAX))
+	{
+		return OTP_NONE;
+	}
+	for (i = 0; i < OTP_SLOTS; i++)
+	{
+		slot = &slots[i];
+		if (!slot->isUsed)
+		{
+			Hash_vfnHmacKey (&slot->key, OTP_ALGORITHM (kind), secret, length);
+			slot->base = counter;
+			slot->nextStep = 0;
+			slot->ready = 0;
+			slot->kind = (uint8_t)kind;
+			slot->isUsed = 1;
+			isComplete = 0;
+			return i;
+		}
+	}
+	return OTP_NONE;
+}
+
+/*!
+	\fn			void Otp_vfnRemove (uint8_t slot)
+	\brief		Clears the key and the codes of a slot and frees it
+*/
+void Otp_vfnRemove (uint8_t slot)
+{
+	volatile uint8_t *bytes;
+	uint32_t size = sizeof (OTP_SLOT);
+
+	if (slot >= OTP_SLOTS)
+	{
+		return;
+	}
+	bytes = (volatile uint8_t *)&slots[slot];
+	while (size--)
+	{
+		*bytes++ = 0;
+	}
+}
+
+/*!
+	\fn			uint8_t Otp_bfnMatch (uint8_t slot, uint32_t code)
+	\param		code	Code typed
+	\return		Returns 1 if the code is one of the window of the slot; the
+				counter moves past it, so it is accepted once
+*/
+uint8_t Otp_bfnMatch (uint8_t slot, uint32_t code)
+{
+	OTP_SLOT *generator;
+	uint32_t first = 0;
+	uint32_t minimum = 0;
+	uint32_t found = OTP_WINDOW;
+	uint32_t mask;
+	uint8_t span = OTP_WINDOW;
+	uint8_t i;
+
+	if (slot >= OTP_SLOTS)
+	{
+		return 0;
+	}
+	generator = &slots[slot];
+	if (!generator->isUsed)
+	{
+		return 0;
+	}
+	if (OTP_IS_TOTP (generator->kind))
+	{
+		if (!Otp_bfnFirstStep (RTC_dwfnGetTime (), &first))
+		{
+			return 0;
+		}
+		Otp_vfnAlign (generator, first);
+		minimum = generator->nextStep;
+		span = TOTP_SPAN;
+	}
+	while (generator->ready < span)
+	{
+		Otp_vfnFill (generator);
+		stats.refills++;
+	}
+	stats.lookups++;
+
+	/* Down to the first entry, so the earliest match is kept */
+	for (i = span; i-- > 0;)
+	{
+		mask = 0u - (uint32_t)((generator->codes[i] == code) & ((generator->base + i) >= minimum));
+		found = (found & ~mask) | (i & mask);
+	}
+	if (found == OTP_WINDOW)
+	{
+		return 0;
+	}
+
+	if (OTP_IS_TOTP (generator->kind))
+	{
+		generator->nextStep = generator->base + found + 1u;
+	}
+	else
+	{
+		Otp_vfnAlign (generator, generator->base + found + 1u);
+	}
+	stats.accepted++;
+	return 1;
+}
+
+/*!
+	\fn			void Otp_vfnTask (void)
+	\brief		Main loop task. Moves the TOTP tables along with the time
+				and computes the first missing code of one slot.
+*/
+void Otp_vfnTask (void)
+{
+	OTP_SLOT *generator;
+	uint32_t now = RTC_dwfnGetTime ();
+	uint32_t first = 0;
+	uint8_t hasTime = 0;
+	uint8_t i;
+
+	if (isComplete && (now == checkedTime))
+	{
+		return;
+	}
+	hasTime = Otp_bfnFirstStep (now, &first);
+
+	for (i = 0; i < OTP_SLOTS; i++)
+	{
+		generator = &slots[cursor];
+		cursor = (uint8_t)((cursor + 1u) % OTP_SLOTS);
+		if (!generator->isUsed)
+		{
+			continue;
+		}
+		if (OTP_IS_TOTP (generator->kind))
+		{
+			if (!hasTime)
+			{
+				continue;
+			}
+			Otp_vfnAlign (generator, first);
+		}
+		if (generator->ready < OTP_WINDOW)
+		{
+			Otp_vfnFill (generator);
+			isComplete = 0;
+			return;
+		}
+	}
+	isComplete = 1;
+	checkedTime = now;
+}
+
+/*!
+	\fn			void Otp_vfnSetZone (int32_t minutes)
+	\param		minutes		Offset of local time from UTC, east positive
+	\brief		The TOTP tables are computed again for the new steps; the
+				steps already used stay used
+*/
+void Otp_vfnSetZone (int32_t minutes)
+{
+	uint8_t i;
+
+	zoneSeconds = minutes * 60;
+	isComplete = 0;
+	for (i = 0; i < OTP_SLOTS; i++)
+	{
+		if (OTP_IS_TOTP (slots[i].kind))
+		{
+			slots[i].ready = 0;
+		}
+	}
+}
+
+/*!
+	\fn			uint8_t Otp_bfnGetSlot (uint8_t slot, uint32_t *counter, uint8_t *ready)
+	\param		counter		Receives the counter or time step of the first
+							code of the table
+	\param		ready		Receives the codes of the table computed
+	\return		Returns the OTP_KIND of the slot, or OTP_NONE if it is free
+*/
+uint8_t Otp_bfnGetSlot (uint8_t slot, uint32_t *counter, uint8_t *ready)
+{
+	if ((slot >= OTP_SLOTS) || !slots[slot].isUsed)
+	{
+		return OTP_NONE;
+	}
+	*counter = slots[slot].base;
+	*ready = slots[slot].ready;
+	return slots[slot].kind;
+}
+
+/*!
+	\fn			void Otp_vfnGetStats (OTP_STATS *out)
+	\param		out		Receives the counts since power-on
+*/
+void Otp_vfnGetStats (OTP_STATS *out)
+{
+	*out = stats;
+}
+
+/*!
+	\fn			uint32_t Otp_dwfnCode (const HASH_HMAC_KEY *key, uint32_t counter, uint8_t digits)
+	\param		counter		Counter or time step, the high word of the
+							64-bit RFC 4226 counter is zero
+	\param		digits		Digits of the code, up to 9
+	\return		Returns the code, the dynamic truncation of the HMAC
+*/
+uint32_t Otp_dwfnCode (const HASH_HMAC_KEY *key, uint32_t counter, uint8_t digits)
+{
+	uint8_t message[COUNTER_BYTES] = {0};
+	uint8_t mac[HASH_MAX_DIGEST];
+	uint8_t offset;
+	uint32_t binary;
+
+	message[4] = (uint8_t)(counter >> 24);
+	message[5] = (uint8_t)(counter >> 16);
+	message[6] = (uint8_t)(counter >> 8);
+	message[7] = (uint8_t)counter;
+	Hash_vfnHmac (key, message, COUNTER_BYTES, mac);
+
+	offset = mac[Hash_bfnDigestSize ((HASH_ALGORITHM)key->algorithm) - 1u] & 0x0Fu;
+	binary = ((uint32_t)(mac[offset] & 0x7Fu) << 24) | ((uint32_t)mac[offset + 1u] << 16) |
+			((uint32_t)mac[offset + 2u] << 8) | (uint32_t)mac[offset + 3u];
+	return binary % powersOfTen[digits];
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint8_t Otp_bfnFirstStep (uint32_t now, uint32_t *first)
+	\param		now		Local time of the RTC
+	\param		first	Receives the oldest TOTP step accepted now
+	\return		Returns 0 while the time is unset after a power-on
+*/
+static uint8_t Otp_bfnFirstStep (uint32_t now, uint32_t *first)
+{
+	uint32_t utc = now - (uint32_t)zoneSeconds;
+	uint32_t step = utc / OTP_PERIOD;
+
+	if (!RTC_bfnIsSet () || (step < OTP_SKEW))
+	{
+		return 0;
+	}
+	*first = step - OTP_SKEW;
+	return 1;
+}
+
+/*!
+	\fn			static void Otp_vfnAlign (OTP_SLOT *slot, uint32_t first)
+	\param		first	Counter or step the table starts at from now on
+	\brief		Keeps the codes already computed that are still ahead
+*/
+static void Otp_vfnAlign (OTP_SLOT *slot, uint32_t first)
+{
+	uint32_t shift = first - slot->base;
+	uint8_t i;
+
+	if (shift == 0)
+	{
+		return;
+	}
+	if (shift < slot->ready)
+	{
+		for (i = 0; i < (uint8_t)(slot->ready - shift); i++)
+		{
+			slot->codes[i] = slot->codes[i + shift];
+		}
+		slot->ready = (uint8_t)(slot->ready - shift);
+	}
+	else
+	{
+		slot->ready = 0;
+	}
+	slot->base = first;
+	isComplete = 0;
+}
+
+/*!
+	\fn			static void Otp_vfnFill (OTP_SLOT *slot)
+	\brief		Computes the first missing code of the table
+*/
+static void Otp_vfnFill (OTP_SLOT *slot)
+{
+	slot->codes[slot->ready] = Otp_dwfnCode (&slot->key, slot->base + slot->ready, OTP_DIGITS);
+	slot->ready++;
+}
@@ -0,0 +1,126 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Otp.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the one-time codes: HOTP (RFC 4226)
+				and TOTP (RFC 6238) over HMAC-SHA1 or HMAC-SHA256. Every
+				slot keeps the codes of its look-ahead window in a table
+				that the main loop fills in the background, so a code typed
+				on the keypad is checked by a table scan instead of an HMAC
+				per candidate counter.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_OTP_H_
+#define _4_SL_OTP_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Hash.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		OTP_SLOTS
+	\brief		Users that can have a code generator, about 120 bytes each.
+				The benchmark build has more to time the worst case.
+*/
+#if defined(BENCHMARK_BUILD) || defined(HOST_SIMULATION)
+#define		OTP_SLOTS			16u
+#else
+#define		OTP_SLOTS			8u
+#endif
+
+/*!
+	\def		OTP_NONE
+	\brief		Slot returned when none is free
+*/
+#define		OTP_NONE			0xFFu
+
+/*!
+	\def		OTP_DIGITS
+	\brief		Digits of a code, typed as "#123456#" so that it is not
+				ended as a pin; at most ENTRY_DIGITS
+*/
+#define		OTP_DIGITS			6u
+
+/*!
+	\def		OTP_WINDOW
+	\brief		Codes kept ahead of the counter; an HOTP generator pressed
+				up to OTP_WINDOW - 1 times without a try is resynchronized
+				by the next code it shows
+*/
+#define		OTP_WINDOW			8u
+
+/*!
+	\def		OTP_PERIOD
+	\brief		Seconds of a TOTP time step
+*/
+#define		OTP_PERIOD			30u
+
+/*!
+	\def		OTP_SKEW
+	\brief		TOTP steps accepted before and after the current one
+*/
+#define		OTP_SKEW			1u
+
+/*!
+	\def		OTP_SECRET_MAX
+	\brief		Longest secret accepted, one block of the hashes
+*/
+#define		OTP_SECRET_MAX		HASH_BLOCK
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		OTP_KIND
+	\brief		Generators; bit 0 selects SHA-256, bit 1 time steps
+*/
+typedef enum
+{
+	eOTP_HOTP_SHA1,
+	eOTP_HOTP_SHA256,
+	eOTP_TOTP_SHA1,
+	eOTP_TOTP_SHA256,
+	eOTP_KINDS
+} OTP_KIND;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		OTP_STATS
+	\brief		How the codes typed were checked
+*/
+typedef struct
+{
+	uint32_t lookups;	/* codes checked against a slot */
+	uint32_t refills;	/* HMACs computed while a code was checked */
+	uint32_t accepted;	/* codes that opened */
+} OTP_STATS;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Otp_vfnInit (void);
+
+uint8_t Otp_bfnAdd (OTP_KIND kind, const uint8_t *secret, uint8_t length, uint32_t counter);
+
+void Otp_vfnRemove (uint8_t slot);
+
+uint8_t Otp_bfnMatch (uint8_t slot, uint32_t code);
+
+void Otp_vfnTask (void);
+
+void Otp_vfnSetZone (int32_t minutes);
+
+uint8_t Otp_bfnGetSlot (uint8_t slot, uint32_t *counter, uint8_t *ready);
+
+void Otp_vfnGetStats (OTP_STATS *out);
+
+uint32_t Otp_dwfnCode (const HASH_HMAC_KEY *key, uint32_t counter, uint8_t digits);
+
+#endif /* _4_SL_OTP_H_ */
@@ -0,0 +1,216 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Pool.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the fixed-block memory pools.
+				Every class of POOL_CLASSES is a static array of equal
+				blocks. A freed block goes on its class' free list, linked
+				through its first word; a class whose list is empty hands
+				out the blocks it never gave before, in order, so the pools
+				need no init and the free lists build up as they are used.
+				Taking or returning a block is a few loads and stores with
+				the interrupts masked, the same from an interrupt as from
+				the main loop.
+
+				Command:
+					$POOL		one line per class:
+								POOL size n= used= max= fail=
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Protocol.h"
+#include "Pool.h"
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		POOL_LAYOUT
+	\brief		Where the blocks of a class are
+*/
+typedef struct
+{
+	uint32_t *storage;
+	uint16_t blockWords;
+	uint8_t blocks;
+} POOL_LAYOUT;
+
+/*!
+	\struct		POOL_STATE
+	\brief		Free blocks of a class and its use
+*/
+typedef struct
+{
+	uint32_t *freeList;
+	uint8_t fresh;			/* blocks handed out at least once */
+	uint8_t inUse;
+	uint8_t highWater;
+	uint32_t failures;
+} POOL_STATE;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+#define		POOL_WORDS(bytes)					(((bytes) + 3u) / 4u)
+#define		POOL_STORAGE(name, bytes, blocks)	static uint32_t name##Storage[POOL_WORDS (bytes) * (blocks)];
+
+/*!
+	\var		ePOOL_SMALLStorage, ...
+	\brief		Blocks of every class
+*/
+POOL_CLASSES (POOL_STORAGE)
+
+#undef		POOL_STORAGE
+
+#define		POOL_LAYOUT_ENTRY(name, bytes, blocks)		{name##Storage, POOL_WORDS (bytes), (blocks)},
+
+/*!
+	\var		layouts
+	\brief		Storage of every class
+*/
+static const POOL_LAYOUT layouts[ePOOL_CLASSES] = {
+	POOL_CLASSES (POOL_LAYOUT_ENTRY)
+};
+
+#undef		POOL_LAYOUT_ENTRY
+
+/*!
+	\var		states
+	\brief		Free list and use of every class
+*/
+static POOL_STATE states[ePOOL_CLASSES];
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Pool_vfnCommand (const char *args);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Pool_vfnInit (void)
+	\brief		Registers "$POOL"; the pools themselves need no init
+*/
+void Pool_vfnInit (void)
+{
+	Protocol_bfnRegister ("POOL", Pool_vfnCommand);
+}
+
+/*!
+	\fn			void *Pool_pvfnAlloc (uint16_t size)
+	\param		size	Bytes needed
+	\return		Returns a block of at least size bytes, aligned to a word,
+				or 0 if no class has one free
+	\brief		Safe from the interrupts and from the main loop
+*/
+void *Pool_pvfnAlloc (uint16_t size)
+{
+	uint32_t primask = __get_PRIMASK ();
+	uint32_t *block = 0;
+	uint8_t first = ePOOL_CLASSES;
+	uint8_t i;
+
+	__disable_irq ();
+	for (i = 0; i < ePOOL_CLASSES; i++)
+	{
+		if ((uint32_t)layouts[i].blockWords * 4u < size)
+		{
+			continue;
+		}
+		if (first == ePOOL_CLASSES)
+		{
+			first = i;
+		}
+		if (states[i].freeList)
+		{
+			block = states[i].freeList;
+			states[i].freeList = *(uint32_t **)block;
+		}
+		else if (states[i].fresh < layouts[i].blocks)
+		{
+			block = &layouts[i].storage[(uint32_t)states[i].fresh * layouts[i].blockWords];
+			states[i].fresh++;
+		}
+		else
+		{
+			continue;
+		}
+		if (++states[i].inUse > states[i].highWater)
+		{
+			states[i].highWater = states[i].inUse;
+		}
+		break;
+	}
+	if (!block && (first < ePOOL_CLASSES))
+	{
+		states[first].failures++;
+	}
+	__set_PRIMASK (primask);
+
+	return block;
+}
+
+/*!
+	\fn			void Pool_vfnFree (void *block)
+	\param		block	Block from Pool_pvfnAlloc, or 0
+	\brief		Returns the block to its class. Safe from the interrupts
+				and from the main loop.
+*/
+void Pool_vfnFree (void *block)
+{
+	uint32_t primask;
+	uint32_t *word = (uint32_t *)block;
+	uint8_t i;
+
+	for (i = 0; i < ePOOL_CLASSES; i++)
+	{
+		if ((word >= layouts[i].storage) &&
+				(word < &layouts[i].storage[(uint32_t)layouts[i].blocks * layouts[i].blockWords]))
+		{
+			primask = __get_PRIMASK ();
+			__disable_irq ();
+			*(uint32_t **)word = states[i].freeList;
+			states[i].freeList = word;
+			states[i].inUse--;
+			__set_PRIMASK (primask);
+			return;
+		}
+	}
+}
+
+/*!
+	\fn			void Pool_vfnGetStats (POOL_CLASS poolClass, POOL_STATS *out)
+	\brief		Copies the use of a class
+*/
+void Pool_vfnGetStats (POOL_CLASS poolClass, POOL_STATS *out)
+{
+	out->blockSize = (uint16_t)(layouts[poolClass].blockWords * 4u);
+	out->blocks = layouts[poolClass].blocks;
+	out->inUse = states[poolClass].inUse;
+	out->highWater = states[poolClass].highWater;
+	out->failures = states[poolClass].failures;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Pool_vfnCommand (const char *args)
+	\brief		"$POOL": the use of every class
+*/
+static void Pool_vfnCommand (const char *args)
+{
+	POOL_STATS stats;
+	uint8_t i;
+
+	(void)args;
+	for (i = 0; i < ePOOL_CLASSES; i++)
+	{
+		Pool_vfnGetStats ((POOL_CLASS)i, &stats);
+		Protocol_vfnReply ("POOL %u n=%u used=%u max=%u fail=%u", (uint32_t)stats.blockSize,
+				(uint32_t)stats.blocks, (uint32_t)stats.inUse, (uint32_t)stats.highWater, stats.failures);
+	}
+}
@@ -0,0 +1,80 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Pool.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the fixed-block memory pools. Buffers
+				a feature only holds for a while, such as a key being
+				uploaded, come from a few classes of equal blocks sized at
+				compile time instead of each feature keeping its own array;
+				there is no heap.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_POOL_H_
+#define _4_SL_POOL_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		POOL_CLASSES
+	\brief		X (name, block bytes, blocks) of every class, in ascending
+				block size; blocks are rounded up to words. A request takes
+				the smallest class it fits and, when that one is empty, the
+				next larger one.
+				SMALL:	installer's key of a credential (32)
+				LARGE:	credential (77), one-time code secret (64)
+*/
+#define		POOL_CLASSES(X)						\
+			X (ePOOL_SMALL,		32u,	1u)		\
+			X (ePOOL_LARGE,		80u,	2u)
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+#define		POOL_ENUM(name, bytes, blocks)		name,
+
+/*!
+	\enum		POOL_CLASS
+	\brief		Classes of POOL_CLASSES
+*/
+typedef enum
+{
+	POOL_CLASSES (POOL_ENUM)
+	ePOOL_CLASSES
+} POOL_CLASS;
+
+#undef		POOL_ENUM
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		POOL_STATS
+	\brief		Use of one class
+*/
+typedef struct
+{
+	uint16_t blockSize;
+	uint8_t blocks;
+	uint8_t inUse;
+	uint8_t highWater;		/* most blocks in use at once */
+	uint32_t failures;		/* requests of its size no class could serve */
+} POOL_STATS;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Pool_vfnInit (void);
+
+void *Pool_pvfnAlloc (uint16_t size);
+
+void Pool_vfnFree (void *block);
+
+void Pool_vfnGetStats (POOL_CLASS poolClass, POOL_STATS *out);
+
+#endif /* _4_SL_POOL_H_ */
@@ -0,0 +1,379 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Power.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the power budget service. ADC0
+				measures the bandgap against VDD every POWER_PERIOD_MS; each
+				block of results is reduced in the DMA interrupt to a mean, fed
+				to a fixed-point low-pass filter, and to the lowest voltage of
+				the block for sag detection. That is two divisions and a few
+				additions per block, a few microseconds at 2 MHz.
+				A load is started only if the filtered voltage minus the sag the
+				load causes stays above POWER_BROWNOUT_MV. Right after a pulse
+				the battery is still recovering, so the request waits up to
+				POWER_WAIT_POLLS polls before it is refused, checking in with
+				the main loop heartbeat at every poll.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Power.h"
+#include "ADC.h"
+#include "Protocol.h"
+#include "serviceLayer.h"
+#include "Watchdog.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		POWER_PERIOD_MS
+	\brief		Time between conversions; a block is ADC_BLOCK of them
+*/
+#define		POWER_PERIOD_MS		20u
+
+/*!
+	\def		POWER_DEADLINE_MS
+	\brief		Longest gap between two ADC blocks before the watchdog resets
+*/
+#define		POWER_DEADLINE_MS	1000u
+
+/*!
+	\def		BANDGAP_MV
+	\brief		Nominal voltage of the bandgap reference
+*/
+#define		BANDGAP_MV			1000u
+
+/*!
+	\def		POWER_FILTER_Q
+	\brief		Fractional bits of the filtered voltage
+*/
+#define		POWER_FILTER_Q		4
+
+/*!
+	\def		POWER_FILTER_SHIFT
+	\brief		Low-pass weight of a new block, 1/2^POWER_FILTER_SHIFT
+*/
+#define		POWER_FILTER_SHIFT	2
+
+/*!
+	\def		POWER_BROWNOUT_MV
+	\brief		Lowest supply the loads may pull VDD down to, with margin over
+				the 1.71 V minimum of the MCU
+*/
+#define		POWER_BROWNOUT_MV	1900u
+
+/*!
+	\def		POWER_CRITICAL_MV
+	\brief		Below this the battery is exhausted and waiting is pointless
+*/
+#define		POWER_CRITICAL_MV	2000u
+
+/*!
+	\def		POWER_POLL_COUNT
+	\brief		delay() count between two checks of a waiting request (50 ms)
+*/
+#define		POWER_POLL_COUNT	100000u
+
+/*!
+	\def		POWER_WAIT_POLLS
+	\brief		Checks of a waiting request before it is refused (3 s)
+*/
+#define		POWER_WAIT_POLLS	60u
+
+/*!
+	\def		SOC_POINTS
+	\brief		Points of the state of charge curve
+*/
+#define		SOC_POINTS			7
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		SOC_POINT
+	\brief		State of charge at a resting voltage
+*/
+typedef struct
+{
+	uint16_t millivolts;
+	uint8_t percent;
+} SOC_POINT;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		loadSag
+	\brief		Sag each load is expected to cause, in mV
+*/
+static const uint16_t loadSag[ePOWER_LOADS] = {350u, 450u};
+
+/*!
+	\var		socCurve
+	\brief		Two alkaline AA cells at light load, highest voltage first
+*/
+static const SOC_POINT socCurve[SOC_POINTS] = {
+		{3100u, 100u}, {2900u, 80u}, {2700u, 55u}, {2500u, 30u},
+		{2300u, 12u}, {2100u, 3u}, {2000u, 0u}
+};
+
+/*!
+	\var		filtered
+	\brief		Low-pass filtered supply voltage, mV with POWER_FILTER_Q
+				fractional bits
+*/
+static volatile int32_t filtered = 0;
+
+/*!
+	\var		lowest
+	\brief		Lowest supply voltage of the last block, in mV
+*/
+static volatile uint16_t lowest = 0;
+
+/*!
+	\var		isValid
+	\brief		Set once the first block was measured
+*/
+static volatile uint8_t isValid = 0;
+
+/*!
+	\var		loadActive
+	\brief		Set between a granted request and its release
+*/
+static volatile uint8_t loadActive = 0;
+
+/*!
+	\var		loadStart
+	\brief		Filtered voltage when the current load started, in mV
+*/
+static uint16_t loadStart = 0;
+
+/*!
+	\var		loadLowest
+	\brief		Lowest voltage measured during the current load, in mV
+*/
+static volatile uint16_t loadLowest = 0;
+
+/*!
+	\var		lastSag
+	\brief		Sag of the last load, in mV
+*/
+static uint16_t lastSag = 0;
+
+/*!
+	\var		grants
+	\brief		Requests granted, immediately or after waiting
+*/
+static uint32_t grants = 0;
+
+/*!
+	\var		delays
+	\brief		Requests granted after waiting for the battery to recover
+*/
+static uint32_t delays = 0;
+
+/*!
+	\var		refusals
+	\brief		Requests refused
+*/
+static uint32_t refusals = 0;
+
+/*!
+	\var		aborts
+	\brief		Loads cut short because the supply sagged below the limit
+*/
+static uint32_t aborts = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Power_vfnReport (const char *args);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Power_vfnInit (void)
+	\brief		Starts measuring the supply and registers "$BATT"
+*/
+void Power_vfnInit (void)
+{
+	ADC_bfnDriverInit ();
+	Watchdog_vfnRegister (eWATCHDOG_SUPPLY, POWER_DEADLINE_MS);
+	ADC_vfnStart (ADC_CHANNEL_BANDGAP, POWER_PERIOD_MS, Power_vfnSamples);
+	Protocol_bfnRegister ("BATT", Power_vfnReport);
+}
+
+/*!
+	\fn			uint8_t Power_bfnRequest (POWER_LOAD load)
+	\param		load	Load about to be switched on
+	\return		Returns 1 if the load may start; else, returns 0
+	\brief		Waits, if needed, until the supply can take the load. Until
+				the first block is measured every request is granted, so a
+				failed ADC never keeps the door shut. A granted request must
+				be followed by Power_vfnRelease. The wait is bounded, so it
+				checks in for the main loop, whose pass it blocks.
+*/
+uint8_t Power_bfnRequest (POWER_LOAD load)
+{
+	uint8_t polls = 0;
+
+	if (isValid)
+	{
+		if (Power_wfnGetMillivolts () < POWER_CRITICAL_MV)
+		{
+			refusals++;
+			return 0;
+		}
+		while (Power_wfnGetMillivolts () < (POWER_BROWNOUT_MV + loadSag[load]))
+		{
+			if (polls++ >= POWER_WAIT_POLLS)
+			{
+				refusals++;
+				return 0;
+			}
+			Watchdog_vfnKick (eWATCHDOG_MAIN);
+			delay (POWER_POLL_COUNT);
+		}
+	}
+	if (polls)
+	{
+		delays++;
+	}
+	grants++;
+
+	loadStart = Power_wfnGetMillivolts ();
+	loadLowest = loadStart;
+	loadActive = 1;
+
+	return 1;
+}
+
+/*!
+	\fn			uint8_t Power_bfnSagging (void)
+	\return		Returns 1 if the running load pulled the supply below
+				POWER_BROWNOUT_MV and must be switched off; else, returns 0
+*/
+uint8_t Power_bfnSagging (void)
+{
+	if (loadActive && isValid && (lowest < POWER_BROWNOUT_MV))
+	{
+		aborts++;
+		loadActive = 0;
+		return 1;
+	}
+	return 0;
+}
+
+/*!
+	\fn			void Power_vfnRelease (void)
+	\brief		Ends a load and keeps the sag it caused
+*/
+void Power_vfnRelease (void)
+{
+	if (isValid && (loadStart > loadLowest))
+	{
+		lastSag = loadStart - loadLowest;
+	}
+	loadActive = 0;
+}
+
+/*!
+	\fn			uint16_t Power_wfnGetMillivolts (void)
+	\return		Returns the filtered supply voltage in mV, 0 if not measured yet
+*/
+uint16_t Power_wfnGetMillivolts (void)
+{
+	return (uint16_t)(filtered >> POWER_FILTER_Q);
+}
+
+/*!
+	\fn			uint8_t Power_bfnGetCharge (void)
+	\return		Returns the battery state of charge in percent, interpolated
+				from the filtered voltage
+*/
+uint8_t Power_bfnGetCharge (void)
+{
+	uint16_t millivolts = Power_wfnGetMillivolts ();
+	uint8_t i = 0;
+
+	if (millivolts >= socCurve[0].millivolts)
+	{
+		return socCurve[0].percent;
+	}
+	for (i = 1; i < SOC_POINTS; i++)
+	{
+		if (millivolts >= socCurve[i].millivolts)
+		{
+			return (uint8_t)(socCurve[i].percent
+					+ ((uint32_t)(millivolts - socCurve[i].millivolts)
+					* (socCurve[i - 1].percent - socCurve[i].percent))
+					/ (socCurve[i - 1].millivolts - socCurve[i].millivolts));
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			void Power_vfnSamples (const uint16_t *samples, uint8_t count)
+	\param		samples	Bandgap conversions, each already averaged by the ADC
+	\param		count	Number of samples
+	\brief		ADC block callback, from the DMA interrupt. The bandgap reads
+				higher as VDD drops, so the largest sample is the lowest VDD.
+*/
+void Power_vfnSamples (const uint16_t *samples, uint8_t count)
+{
+	uint32_t sum = 0;
+	uint16_t highest = 0;
+	int32_t mean = 0;
+	uint8_t i = 0;
+
+	Watchdog_vfnKick (eWATCHDOG_SUPPLY);
+	for (i = 0; i < count; i++)
+	{
+		sum += samples[i];
+		if (samples[i] > highest)
+		{
+			highest = samples[i];
+		}
+	}
+	if (!highest)
+	{
+		return;
+	}
+
+	mean = (int32_t)(((BANDGAP_MV * ADC_FULL_SCALE * count) / sum) << POWER_FILTER_Q);
+	lowest = (uint16_t)((BANDGAP_MV * ADC_FULL_SCALE) / highest);
+
+	if (isValid)
+	{
+		filtered += (mean - filtered) >> POWER_FILTER_SHIFT;
+	}
+	else
+	{
+		filtered = mean;
+		isValid = 1;
+	}
+	if (loadActive && (lowest < loadLowest))
+	{
+		loadLowest = lowest;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Power_vfnReport (const char *args)
+	\brief		"$BATT": supply in mV, state of charge, sag of the last load
+				and the request counters
+*/
+static void Power_vfnReport (const char *args)
+{
+	(void)args;
+	Protocol_vfnReply ("BATT mv=%u soc=%u sag=%u grant=%u delay=%u refuse=%u abort=%u",
+			(uint32_t)Power_wfnGetMillivolts (), (uint32_t)Power_bfnGetCharge (),
+			(uint32_t)lastSag, grants, delays, refusals, aborts);
+}
@@ -0,0 +1,49 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Power.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the power budget service. It tracks
+				the supply voltage from the ADC and decides whether a high
+				current load may start now, later or not at all.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_POWER_H_
+#define _4_SL_POWER_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		POWER_LOAD
+	\brief		High current loads, each with the sag it is expected to cause
+*/
+typedef enum
+{
+	ePOWER_LOAD_SOLENOID,
+	ePOWER_LOAD_MOTOR,
+	ePOWER_LOADS
+} POWER_LOAD;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Power_vfnInit (void);
+
+uint8_t Power_bfnRequest (POWER_LOAD load);
+
+uint8_t Power_bfnSagging (void);
+
+void Power_vfnRelease (void);
+
+uint16_t Power_wfnGetMillivolts (void);
+
+uint8_t Power_bfnGetCharge (void);
+
+void Power_vfnSamples (const uint16_t *samples, uint8_t count);
+
+#endif /* _4_SL_POWER_H_ */
@@ -0,0 +1,672 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Protocol.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the management protocol. The UART
+				receive events drain the ring from the interrupt: command lines
+				are collected there and run later by Protocol_vfnTask from the
+				main loop, so a handler may take as long as it needs. The
+				bytes outside a line are queued the same way and handed to
+				the byte handler by Protocol_vfnTask.
+				Every line is "$NAME args\n"; replies are "$text\r\n".
+				Up to PROTOCOL_QUEUE lines wait in order, so a host may send
+				the next commands before the replies of the first arrive;
+				after "$PIPE 1" every command's replies end with "$END" so
+				such a host can tell them apart.
+				With USB_CDC_ENABLE the USB CDC port is a second link with
+				its own framing; a reply goes out on the link its command
+				came from.
+				Commands that provision the lock ask Protocol_bfnIsAuthorized
+				first: they are taken from the USB port, which needs the
+				cable, and from the Bluetooth link only for PROTOCOL_AUTH_MS
+				after the master password was typed on the keypad.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdarg.h>
+#include <string.h>
+#include "MKL27Z644.h"
+#include "fsl_str.h"
+#include "UART.h"
+#include "USB.h"
+#include "Timebase.h"
+#include "Protocol.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_COMMANDS
+	\brief		Maximum number of registered commands
+*/
+#define		MAX_COMMANDS		24
+
+/*!
+	\def		PROTOCOL_LINE
+	\brief		Longest command line, without the start byte and the newline
+*/
+#define		PROTOCOL_LINE		48
+
+/*!
+	\def		PROTOCOL_REPLY
+	\brief		Longest reply, without the start byte and the line ending
+*/
+#define		PROTOCOL_REPLY		64
+
+/*!
+	\def		PROTOCOL_QUEUE
+	\brief		Command lines waiting for Protocol_vfnTask, a power of two
+*/
+#define		PROTOCOL_QUEUE		4u
+
+/*!
+	\def		PROTOCOL_BYTES
+	\brief		Bytes outside the command lines waiting for Protocol_vfnTask,
+				a power of two
+*/
+#define		PROTOCOL_BYTES		16u
+
+/*!
+	\def		RX_CHUNK
+	\brief		Bytes taken from the UART ring per call
+*/
+#define		RX_CHUNK			16
+
+/*!
+	\def		PROTOCOL_FRAME
+	\brief		Longest reply with its start byte and line ending
+*/
+#define		PROTOCOL_FRAME		(PROTOCOL_REPLY + 3)
+
+/*!
+	\def		PROTOCOL_AUTH_MS
+	\brief		Time the Bluetooth link may provision after the master
+				password was typed on the keypad
+*/
+#define		PROTOCOL_AUTH_MS	60000u
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		PROTOCOL_LINK
+	\brief		Links the command lines arrive on
+*/
+typedef enum
+{
+	ePROTOCOL_LINK_UART,
+	ePROTOCOL_LINK_USB,
+	ePROTOCOL_LINKS
+} PROTOCOL_LINK;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		PROTOCOL_COMMAND
+	\brief		Name of a command and the function that runs it
+*/
+typedef struct
+{
+	const char *name;
+	PROTOCOL_HANDLER handler;
+} PROTOCOL_COMMAND;
+
+/*!
+	\struct		PROTOCOL_FRAMER
+	\brief		Framing state of one link
+*/
+typedef struct
+{
+	uint8_t inLine;
+	uint8_t lineLength;
+	char line[PROTOCOL_LINE];
+} PROTOCOL_FRAMER;
+
+/*!
+	\struct		PROTOCOL_PENDING
+	\brief		Complete command line and the link it came from
+*/
+typedef struct
+{
+	char text[PROTOCOL_LINE + 1];
+	uint8_t link;
+} PROTOCOL_PENDING;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		commands
+	\brief		Registered commands
+*/
+static PROTOCOL_COMMAND commands[MAX_COMMANDS] = {{0}};
+
+/*!
+	\var		numCommands
+	\brief		Number of registered commands
+*/
+static uint8_t numCommands = 0;
+
+/*!
+	\var		byteHandler
+	\brief		Receives every byte outside a command line
+*/
+static PROTOCOL_BYTE_HANDLER byteHandler = 0;
+
+/*!
+	\var		bytes
+	\brief		Bytes outside the command lines waiting for Protocol_vfnTask
+*/
+static uint8_t bytes[PROTOCOL_BYTES];
+
+/*!
+	\var		bytesHead
+	\brief		Bytes queued since init; only the interrupt writes it
+*/
+static volatile uint8_t bytesHead = 0;
+
+/*!
+	\var		bytesTail
+	\brief		Bytes handled since init; only the main loop writes it
+*/
+static volatile uint8_t bytesTail = 0;
+
+/*!
+	\var		framers
+	\brief		Command line being received on each link
+*/
+static PROTOCOL_FRAMER framers[ePROTOCOL_LINKS];
+
+/*!
+	\var		pending
+	\brief		Complete lines waiting for Protocol_vfnTask
+*/
+static PROTOCOL_PENDING pending[PROTOCOL_QUEUE];
+
+/*!
+	\var		pendingHead
+	\brief		Lines queued since init; only the interrupt writes it
+*/
+static volatile uint8_t pendingHead = 0;
+
+/*!
+	\var		pendingTail
+	\brief		Lines run since init; only the main loop writes it
+*/
+static volatile uint8_t pendingTail = 0;
+
+/*!
+	\var		isPipelined
+	\brief		Set per link by "$PIPE 1": replies end with "$END"
+*/
+static uint8_t isPipelined[ePROTOCOL_LINKS] = {0};
+
+/*!
+	\var		commandLink
+	\brief		Link command came from, and the one its replies go to
+*/
+static PROTOCOL_LINK commandLink = ePROTOCOL_LINK_UART;
+
+/*!
+	\var		dropped
+	\brief		Lines lost because they were too long or arrived while the
+				queue was full, and bytes outside them lost to a full queue
+*/
+static uint32_t dropped = 0;
+
+/*!
+	\var		frame
+	\brief		Reply being formatted, the text after the start byte
+*/
+static char frame[PROTOCOL_FRAME];
+
+/*!
+	\var		replyLength
+	\brief		Bytes of text in frame, written by the fsl_str callback
+*/
+static int32_t replyLength = 0;
+
+/*!
+	\var		isAuthorized
+	\brief		Set by Protocol_vfnAuthorize, cleared when the time is up
+*/
+static uint8_t isAuthorized = 0;
+
+/*!
+	\var		authorizedAt
+	\brief		ms of the last Protocol_vfnAuthorize
+*/
+static uint32_t authorizedAt = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Protocol_vfnReceive (UART_RX_EVENT event);
+static void Protocol_vfnByte (PROTOCOL_LINK link, uint8_t value);
+static void Protocol_vfnSend (const uint8_t *data, uint16_t size);
+static void Protocol_vfnReplyChar (char *buf, int32_t *indicator, char val, int len);
+static void Protocol_vfnPing (const char *args);
+static void Protocol_vfnStat (const char *args);
+static void Protocol_vfnPipe (const char *args);
+#ifdef USB_CDC_ENABLE
+static void Protocol_vfnUsbReceive (void);
+static void Protocol_vfnUsb (const char *args);
+#endif
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Protocol_vfnDriverInit (PROTOCOL_BYTE_HANDLER handler)
+	\param		handler	Receives every byte outside a command line, from
+						Protocol_vfnTask
+	\brief		Registers the built-in commands and brings up the UART, and
+				the USB CDC port if enabled
+*/
+void Protocol_vfnDriverInit (PROTOCOL_BYTE_HANDLER handler)
+{
+	byteHandler = handler;
+	memset (framers, 0, sizeof (framers));
+	memset (isPipelined, 0, sizeof (isPipelined));
+	pendingHead = 0;
+	pendingTail = 0;
+	bytesHead = 0;
+	bytesTail = 0;
+
+	Protocol_bfnRegister ("PING", Protocol_vfnPing);
+	Protocol_bfnRegister ("STAT", Protocol_vfnStat);
+	Protocol_bfnRegister ("PIPE", Protocol_vfnPipe);
+
+	UART_vfnCallbackReg (Protocol_vfnReceive);
+	UART_vfnDriverInit ();
+
+#ifdef USB_CDC_ENABLE
+	Protocol_bfnRegister ("USB", Protocol_vfnUsb);
+
+	USB_vfnCallbackReg (Protocol_vfnUsbReceive, 0);
+	USB_vfnDriverInit ();
+#endif
+}
+
+/*!
+	\fn			uint8_t Protocol_bfnRegister (const char *name, PROTOCOL_HANDLER handler)
+	\param		name	Command name, matched exactly and kept by reference
+	\param		handler	Function that runs the command
+	\return		Returns 1 if the command was registered; else, returns 0
+	\brief		Adds a command. Registering a name again replaces its handler.
+*/
+uint8_t Protocol_bfnRegister (const char *name, PROTOCOL_HANDLER handler)
+{
+	uint8_t i = 0;
+
+	if ((name == 0) || (handler == 0))
+	{
+		return 0;
+	}
+	for (i = 0; i < numCommands; i++)
+	{
+		if (strcmp (commands[i].name, name) == 0)
+		{
+			commands[i].handler = handler;
+			return 1;
+		}
+	}
+	if (numCommands >= MAX_COMMANDS)
+	{
+		return 0;
+	}
+	commands[numCommands].name = name;
+	commands[numCommands].handler = handler;
+	numCommands++;
+
+	return 1;
+}
+
+/*!
+	\fn			void Protocol_vfnTask (void)
+	\brief		Hands the waiting bytes outside the command lines to the byte
+				handler, then runs the oldest waiting command line, if any.
+				Unknown commands are answered with "$ERR name".
+*/
+void Protocol_vfnTask (void)
+{
+	PROTOCOL_PENDING *entry;
+	char *command;
+	const char *args = "";
+	char *space;
+	uint8_t i = 0;
+
+	while (bytesTail != bytesHead)
+	{
+		byteHandler (bytes[bytesTail & (PROTOCOL_BYTES - 1u)]);
+		bytesTail++;
+	}
+	if (pendingHead == pendingTail)
+	{
+		return;
+	}
+
+	entry = &pending[pendingTail & (PROTOCOL_QUEUE - 1u)];
+	command = entry->text;
+	commandLink = (PROTOCOL_LINK)entry->link;
+	space = strchr (command, ' ');
+	if (space != 0)
+	{
+		*space = '\0';
+		args = space + 1;
+	}
+	for (i = 0; i < numCommands; i++)
+	{
+		if (strcmp (commands[i].name, command) == 0)
+		{
+			break;
+		}
+	}
+	if (i < numCommands)
+	{
+		commands[i].handler (args);
+	}
+	else
+	{
+		Protocol_vfnReply ("ERR %s", command);
+	}
+	if (isPipelined[commandLink])
+	{
+		Protocol_vfnReply ("END");
+	}
+
+	/* Only now may the interrupt overwrite the line */
+	pendingTail++;
+}
+
+/*!
+	\fn			void Protocol_vfnReply (const char *fmt, ...)
+	\param		fmt	fsl_str format of the reply, without the start byte
+	\brief		Formats a reply and sends it on the link of the command being
+				run, waiting for the transmitter. Meant for the main loop only.
+*/
+void Protocol_vfnReply (const char *fmt, ...)
+{
+	va_list ap;
+
+	replyLength = 0;
+	va_start (ap, fmt);
+	StrFormatPrintf (fmt, ap, &frame[1], Protocol_vfnReplyChar);
+	va_end (ap);
+
+	frame[0] = PROTOCOL_START;
+	frame[replyLength + 1] = '\r';
+	frame[replyLength + 2] = '\n';
+	Protocol_vfnSend ((const uint8_t *)frame, (uint16_t)(replyLength + 3));
+}
+
+/*!
+	\fn			void Protocol_vfnAuthorize (void)
+	\brief		Lets the Bluetooth link provision for PROTOCOL_AUTH_MS from
+				now. Called when the master password was typed on the
+				keypad, that is by someone in front of the lock.
+*/
+void Protocol_vfnAuthorize (void)
+{
+	authorizedAt = Timebase_dwfnGetMs ();
+	isAuthorized = 1;
+}
+
+/*!
+	\fn			uint8_t Protocol_bfnIsAuthorized (void)
+	\return		Returns 1 if the command being run may provision the lock;
+				else, returns 0
+	\brief		Meant for the handlers: a command from the USB port is
+				always authorized, one from the Bluetooth link only while
+				the time given by Protocol_vfnAuthorize runs
+*/
+uint8_t Protocol_bfnIsAuthorized (void)
+{
+	if (commandLink == ePROTOCOL_LINK_USB)
+	{
+		return 1;
+	}
+	if (isAuthorized && ((Timebase_dwfnGetMs () - authorizedAt) >= PROTOCOL_AUTH_MS))
+	{
+		isAuthorized = 0;
+	}
+	return isAuthorized;
+}
+
+/*!
+	\fn			uint32_t Protocol_dwfnGetDropped (void)
+	\return		Returns the number of command lines lost
+*/
+uint32_t Protocol_dwfnGetDropped (void)
+{
+	return dropped;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Protocol_vfnReceive (UART_RX_EVENT event)
+	\param		event	Reason of the call; every reason is handled alike
+	\brief		UART receive callback. Takes every waiting byte from the ring.
+*/
+static void Protocol_vfnReceive (UART_RX_EVENT event)
+{
+	uint8_t chunk[RX_CHUNK];
+	uint16_t count = 0;
+	uint16_t i = 0;
+
+	(void)event;
+	do
+	{
+		count = UART_wfnReceive (chunk, sizeof (chunk));
+		for (i = 0; i < count; i++)
+		{
+			Protocol_vfnByte (ePROTOCOL_LINK_UART, chunk[i]);
+		}
+	} while (count == sizeof (chunk));
+}
+
+#ifdef USB_CDC_ENABLE
+/*!
+	\fn			static void Protocol_vfnUsbReceive (void)
+	\brief		USB receive callback. Takes every waiting byte from the ring,
+				which also hands held OUT buffers back to the host.
+*/
+static void Protocol_vfnUsbReceive (void)
+{
+	uint8_t chunk[RX_CHUNK];
+	uint16_t count = 0;
+	uint16_t i = 0;
+
+	do
+	{
+		count = USB_wfnReceive (chunk, sizeof (chunk));
+		for (i = 0; i < count; i++)
+		{
+			Protocol_vfnByte (ePROTOCOL_LINK_USB, chunk[i]);
+		}
+	} while (count == sizeof (chunk));
+}
+#endif
+
+/*!
+	\fn			static void Protocol_vfnByte (PROTOCOL_LINK link, uint8_t value)
+	\param		link	Link the byte arrived on
+	\param		value	Received byte
+	\brief		Frames the command lines. A line that does not fit, or that
+				ends while the queue is full, is dropped. Only the UART has
+				bytes outside the command lines; they are queued for
+				Protocol_vfnTask, or dropped while that queue is full.
+*/
+static void Protocol_vfnByte (PROTOCOL_LINK link, uint8_t value)
+{
+	PROTOCOL_FRAMER *framer = &framers[link];
+	PROTOCOL_PENDING *entry;
+
+	if (!framer->inLine)
+	{
+		if (value == PROTOCOL_START)
+		{
+			framer->inLine = 1;
+			framer->lineLength = 0;
+		}
+		else if ((link == ePROTOCOL_LINK_UART) && (byteHandler != 0))
+		{
+			if ((uint8_t)(bytesHead - bytesTail) >= PROTOCOL_BYTES)
+			{
+				dropped++;
+				return;
+			}
+			bytes[bytesHead & (PROTOCOL_BYTES - 1u)] = value;
+			bytesHead++;
+		}
+		return;
+	}
+
+	if (value == '\r')
+	{
+		return;
+	}
+	if (value == '\n')
+	{
+		framer->inLine = 0;
+		if ((uint8_t)(pendingHead - pendingTail) >= PROTOCOL_QUEUE)
+		{
+			dropped++;
+			return;
+		}
+		entry = &pending[pendingHead & (PROTOCOL_QUEUE - 1u)];
+		memcpy (entry->text, framer->line, framer->lineLength);
+		entry->text[framer->lineLength] = '\0';
+		entry->link = (uint8_t)link;
+		pendingHead++;
+		return;
+	}
+	if (framer->lineLength >= PROTOCOL_LINE)
+	{
+		framer->inLine = 0;
+		dropped++;
+		return;
+	}
+	framer->line[framer->lineLength++] = (char)value;
+}
+
+/*!
+	\fn			static void Protocol_vfnSend (const uint8_t *data, uint16_t size)
+	\param		data	Frame to send
+	\param		size	Bytes in the frame
+	\brief		Waits for the transmitter of the command link and queues the
+				frame. A USB frame is dropped once no program has the port
+				open, so a closed port cannot stall the main loop.
+*/
+static void Protocol_vfnSend (const uint8_t *data, uint16_t size)
+{
+	uint16_t sent = 0;
+
+#ifdef USB_CDC_ENABLE
+	if (commandLink == ePROTOCOL_LINK_USB)
+	{
+		while ((sent < size) && USB_bfnIsOpen ())
+		{
+			sent = (uint16_t)(sent + USB_wfnSend (&data[sent], (uint16_t)(size - sent)));
+		}
+		return;
+	}
+#endif
+
+	for (sent = 0; sent < size; sent++)
+	{
+		while (!UART_bfnSend ((uint8_t *)&data[sent]))
+		{
+		}
+	}
+}
+
+/*!
+	\fn			static void Protocol_vfnReplyChar (char *buf, int32_t *indicator, char val, int len)
+	\brief		fsl_str output callback writing the text into frame; the rest
+				of a reply that does not fit is cut
+*/
+static void Protocol_vfnReplyChar (char *buf, int32_t *indicator, char val, int len)
+{
+	int i = 0;
+
+	for (i = 0; i < len; i++)
+	{
+		if (*indicator < PROTOCOL_REPLY)
+		{
+			buf[*indicator] = val;
+			(*indicator)++;
+		}
+	}
+	replyLength = *indicator;
+}
+
+//------------------------------------------------------------------------------
+// Built-in commands
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Protocol_vfnPing (const char *args)
+	\brief		"$PING": answers "$PONG"
+*/
+static void Protocol_vfnPing (const char *args)
+{
+	(void)args;
+	Protocol_vfnReply ("PONG");
+}
+
+/*!
+	\fn			static void Protocol_vfnStat (const char *args)
+	\brief		"$STAT": bytes received, receive interrupts per reason,
+				dropped lines and bytes, and bytes lost by the receiver or
+				its DMA ring. With the DMA receiver a bulk transfer costs two
+				interrupts per ring instead of one per byte.
+*/
+static void Protocol_vfnStat (const char *args)
+{
+	(void)args;
+	Protocol_vfnReply ("STAT rx=%u byte=%u half=%u full=%u idle=%u drop=%u lost=%u",
+			UART_dwfnGetRxBytes (),
+			UART_dwfnGetRxEvents (eUART_RX_BYTE),
+			UART_dwfnGetRxEvents (eUART_RX_HALF),
+			UART_dwfnGetRxEvents (eUART_RX_FULL),
+			UART_dwfnGetRxEvents (eUART_RX_IDLE),
+			dropped,
+			UART_dwfnGetRxDropped ());
+}
+
+/*!
+	\fn			static void Protocol_vfnPipe (const char *args)
+	\brief		"$PIPE 1" ends every reply on this link with "$END", "$PIPE 0"
+				goes back to plain replies; answers "$PIPE mode"
+*/
+static void Protocol_vfnPipe (const char *args)
+{
+	if ((args[0] == '0') || (args[0] == '1'))
+	{
+		isPipelined[commandLink] = (uint8_t)(args[0] - '0');
+	}
+	Protocol_vfnReply ("PIPE %u", (uint32_t)isPipelined[commandLink]);
+}
+
+#ifdef USB_CDC_ENABLE
+/*!
+	\fn			static void Protocol_vfnUsb (const char *args)
+	\brief		"$USB": state of the USB CDC port and its packet counters
+*/
+static void Protocol_vfnUsb (const char *args)
+{
+	(void)args;
+	Protocol_vfnReply ("USB cfg=%u open=%u rx=%u tx=%u held=%u reset=%u susp=%u",
+			USB_bfnIsConfigured (),
+			USB_bfnIsOpen (),
+			USB_dwfnGetStatistic (eUSB_RX_PACKETS),
+			USB_dwfnGetStatistic (eUSB_TX_PACKETS),
+			USB_dwfnGetStatistic (eUSB_RX_HELD),
+			USB_dwfnGetStatistic (eUSB_RESETS),
+			USB_dwfnGetStatistic (eUSB_SUSPENDS));
+}
+#endif
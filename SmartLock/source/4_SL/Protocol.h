@@ -0,0 +1,61 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Protocol.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the management protocol carried over
+				the Bluetooth link. Lines starting with '$' are commands; any
+				other byte is handed to the plain byte handler, as before.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_PROTOCOL_H_
+#define _4_SL_PROTOCOL_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		PROTOCOL_START
+	\brief		First byte of a command line and of every reply
+*/
+#define		PROTOCOL_START		'$'
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	PROTOCOL_HANDLER
+	\brief		Runs a command from the main loop. args points to the text after
+				the command name and its separating space, "" if there is none.
+*/
+typedef void (*PROTOCOL_HANDLER)(const char *args);
+
+/*!
+	\typedef	PROTOCOL_BYTE_HANDLER
+	\brief		Called from Protocol_vfnTask, in the main loop, with every
+				byte outside a command line in the order received
+*/
+typedef void (*PROTOCOL_BYTE_HANDLER)(uint8_t value);
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Protocol_vfnDriverInit (PROTOCOL_BYTE_HANDLER byteHandler);
+
+uint8_t Protocol_bfnRegister (const char *name, PROTOCOL_HANDLER handler);
+
+void Protocol_vfnTask (void);
+
+void Protocol_vfnReply (const char *fmt, ...);
+
+uint32_t Protocol_dwfnGetDropped (void);
+
+void Protocol_vfnAuthorize (void);
+
+uint8_t Protocol_bfnIsAuthorized (void);
+
+#endif /* _4_SL_PROTOCOL_H_ */
@@ -0,0 +1,54 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	RamFunc.h
+	\date		October 19th, 2026
+	\brief		Placement of functions in SRAM. The managed linker script
+				gathers the .ramfunc sections into .data, so the startup code
+				copies them from flash with the initialized variables and
+				nothing else has to be set up. Code run from SRAM does not
+				wait for the flash, which is slower than the core above
+				24 MHz, at the price of the RAM it takes: Tools/RamBudget
+				lists it per module.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_RAMFUNC_H_
+#define _4_SL_RAMFUNC_H_
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		RAMFUNC_HOT_ENABLE
+	\brief		Runs the hot paths tagged RAMFUNC_HOT from SRAM. Without it
+				they stay in flash; the Benchmark build run both ways gives
+				what the placement is worth.
+*/
+#ifndef HOST_SIMULATION
+	#define RAMFUNC_HOT_ENABLE
+#endif
+
+/*!
+	\def		RAMFUNC
+	\brief		Places a function in SRAM. SRAM is out of reach of a BL
+				from flash, hence the long call, which only callers that see
+				the attribute make: tag the prototype as well as the
+				definition. Calls from SRAM into flash go through the veneers
+				the linker adds.
+*/
+#if defined(__arm__)
+	#define		RAMFUNC			__attribute__((section(".ramfunc.$RAM"), noinline, long_call))
+#else
+	#define		RAMFUNC			__attribute__((noinline))
+#endif
+
+/*!
+	\def		RAMFUNC_HOT
+	\brief		Places a hot path in SRAM when RAMFUNC_HOT_ENABLE is defined
+*/
+#ifdef RAMFUNC_HOT_ENABLE
+	#define		RAMFUNC_HOT		RAMFUNC
+#else
+	#define		RAMFUNC_HOT
+#endif
+
+#endif /* _4_SL_RAMFUNC_H_ */
@@ -0,0 +1,602 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Session.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the secure Bluetooth session.
+				Commands, bytes in hex:
+					$PAIR					status
+					$PAIR 0|1 half			half of the phone's X25519 key
+					$PAIR CLR				forgets the paired phone
+					$SEC					status
+					$SEC frame				counter(4) digits tag(8)
+				Once both halves arrived the lock replies with its own key
+				in two halves and a six digit code the phone shows too; the
+				user compares them, which is what keeps a man in the middle
+				out. The session key is derived from the shared secret and
+				both public keys with a Davies-Meyer chain of AES, so no
+				hash is needed on the lock.
+				The nonce of a frame is its direction, 1 from the phone and
+				2 from the lock, and its counter. Every frame from the phone
+				is answered with a sealed frame that carries the phone's
+				counter back; errors are in clear text:
+					SEC ERR unpaired|format|replay|auth
+				The key lives in RAM only: after a power cycle the phone
+				pairs again.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Aes.h"
+#include "ClockProfile.h"
+#include "Curve25519.h"
+#include "Protocol.h"
+#include "Timebase.h"
+#include "Session.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		COUNTER_BYTES
+	\brief		Bytes of the frame counter, big-endian
+*/
+#define		COUNTER_BYTES		4u
+
+/*!
+	\def		FRAME_BYTES
+	\brief		Longest frame: counter, payload and tag
+*/
+#define		FRAME_BYTES			(COUNTER_BYTES + SESSION_PAYLOAD + AES_CCM_TAG)
+
+/*!
+	\def		HALF_BYTES
+	\brief		Bytes of a public key sent in one line
+*/
+#define		HALF_BYTES			(CURVE25519_BYTES / 2u)
+
+/*!
+	\def		CODE_DIGITS
+	\brief		Digits of the check code compared on both sides
+*/
+#define		CODE_DIGITS			6u
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		SESSION_DIRECTION
+	\brief		First byte of the nonce, so both directions never share one
+*/
+typedef enum
+{
+	eSESSION_FROM_PHONE = 1,
+	eSESSION_FROM_LOCK = 2
+} SESSION_DIRECTION;
+
+/*!
+	\enum		SESSION_LABEL
+	\brief		Start of the key derivation chain of every derived value
+*/
+typedef enum
+{
+	eSESSION_LABEL_KEY = 1,
+	eSESSION_LABEL_CODE = 2
+} SESSION_LABEL;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		SESSION_STATE
+	\brief		Pairing and the counters of both directions
+*/
+typedef struct
+{
+	uint8_t isPaired;
+	uint8_t isWindowOpen;
+	uint8_t halves;
+	uint32_t windowStart;
+	uint32_t received;
+	uint32_t sent;
+	uint8_t phoneKey[CURVE25519_BYTES];
+	AES_CONTEXT key;
+} SESSION_STATE;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		session
+	\brief		The paired phone, if any
+*/
+static SESSION_STATE session = {0};
+
+/*!
+	\var		digitCallback
+	\brief		Receives the digits of every authenticated frame
+*/
+static SESSION_DIGIT_CALLBACK digitCallback = 0;
+
+/*!
+	\var		pool
+	\brief		Entropy pool, stirred with the cycle counter whenever a key
+				or a line arrives and keyed into AES to draw from it
+*/
+static uint32_t pool[4] = {0};
+
+/*!
+	\var		poolIndex
+	\brief		Word of the pool stirred next
+*/
+static uint8_t poolIndex = 0;
+
+/*!
+	\var		hexDigits
+	\brief		Digits of the hex replies
+*/
+static const char hexDigits[] = "0123456789abcdef";
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Session_vfnPair (const char *args);
+static void Session_vfnSecure (const char *args);
+static void Session_vfnAgree (void);
+static void Session_vfnDraw (uint8_t *out, uint8_t blocks);
+static void Session_vfnDerive (uint8_t *out, SESSION_LABEL label,
+		const uint8_t *shared, const uint8_t *lockKey);
+static void Session_vfnNonce (uint8_t *nonce, SESSION_DIRECTION direction, uint32_t counter);
+static uint8_t Session_bfnWindow (void);
+static uint8_t Session_bfnDecode (const char *text, uint8_t *out, uint8_t size);
+static void Session_vfnEncode (char *text, const uint8_t *in, uint8_t size);
+static void Session_vfnWipe (void *data, uint32_t size);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Session_vfnInit (SESSION_DIGIT_CALLBACK callback)
+	\param		callback	Receives the digits of every authenticated frame
+	\brief		Registers the session commands; no phone is paired
+*/
+void Session_vfnInit (SESSION_DIGIT_CALLBACK callback)
+{
+	digitCallback = callback;
+	Session_vfnStir (Timebase_dwfnGetCycles ());
+
+	Protocol_bfnRegister ("PAIR", Session_vfnPair);
+	Protocol_bfnRegister ("SEC", Session_vfnSecure);
+}
+
+/*!
+	\fn			void Session_vfnAllowPairing (void)
+	\brief		Opens the pairing window for SESSION_PAIRING_MS. Called
+				after a correct pin, so only someone who may open the door
+				can pair a phone with it.
+*/
+void Session_vfnAllowPairing (void)
+{
+	session.isWindowOpen = 1;
+	session.windowStart = Timebase_dwfnGetMs ();
+	session.halves = 0;
+}
+
+/*!
+	\fn			uint8_t Session_bfnIsPaired (void)
+	\return		Returns 1 if a phone is paired; else, returns 0
+*/
+uint8_t Session_bfnIsPaired (void)
+{
+	return session.isPaired;
+}
+
+/*!
+	\fn			void Session_vfnStir (uint32_t sample)
+	\param		sample	Value hard to predict, typically the cycle counter
+						at an external event
+	\brief		Mixes a sample into the pool. Called from interrupts too.
+*/
+void Session_vfnStir (uint32_t sample)
+{
+	uint32_t primask = __get_PRIMASK ();
+	uint32_t word;
+
+	__disable_irq ();
+	word = pool[poolIndex] ^ sample;
+	word = ((word << 7) | (word >> 25)) * 0x9E3779B9u;
+	pool[poolIndex] = word ^ pool[(poolIndex + 1u) & 3u];
+	poolIndex = (uint8_t)((poolIndex + 1u) & 3u);
+	__set_PRIMASK (primask);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Session_vfnPair (const char *args)
+	\brief		"$PAIR", "$PAIR 0|1 half" or "$PAIR CLR". The key
+				agreement runs once both halves are in.
+*/
+static void Session_vfnPair (const char *args)
+{
+	uint8_t half;
+
+	Session_vfnStir (Timebase_dwfnGetCycles ());
+	if (args[0] == '\0')
+	{
+		Protocol_vfnReply ("PAIR paired=%u window=%u", (uint32_t)session.isPaired,
+				(uint32_t)Session_bfnWindow ());
+		return;
+	}
+	if (!Session_bfnWindow ())
+	{
+		Protocol_vfnReply ("PAIR ERR closed");
+		return;
+	}
+	if ((args[0] == 'C') && (args[1] == 'L') && (args[2] == 'R') && (args[3] == '\0'))
+	{
+		session.isPaired = 0;
+		Session_vfnWipe (&session.key, sizeof (session.key));
+		Protocol_vfnReply ("PAIR CLR");
+		return;
+	}
+
+	half = (uint8_t)(args[0] - '0');
+	if ((half > 1u) || (args[1] != ' ') ||
+			!Session_bfnDecode (&args[2], &session.phoneKey[half * HALF_BYTES], HALF_BYTES))
+	{
+		Protocol_vfnReply ("PAIR ERR format");
+		return;
+	}
+	session.halves |= (uint8_t)(1u << half);
+	if (session.halves != 3u)
+	{
+		Protocol_vfnReply ("PAIR %u", (uint32_t)half);
+		return;
+	}
+	session.halves = 0;
+
+	/* Two ladders take about 150 ms at 48 MHz and seconds in VLPR */
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+	ClockProfile_vfnTask ();
+	Session_vfnAgree ();
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
+}
+
+/*!
+	\fn			static void Session_vfnAgree (void)
+	\brief		Draws a new key pair, agrees on the shared secret with the
+				phone's key and derives the session key and the check code.
+				The secrets are wiped before it returns.
+*/
+static void Session_vfnAgree (void)
+{
+	uint8_t secret[CURVE25519_BYTES];
+	uint8_t lockKey[CURVE25519_BYTES];
+	uint8_t shared[CURVE25519_BYTES];
+	uint8_t derived[AES_BLOCK];
+	char text[2u * HALF_BYTES + 1u];
+	uint32_t code;
+	uint8_t isZero = 0;
+	uint8_t i;
+
+	Session_vfnDraw (secret, CURVE25519_BYTES / AES_BLOCK);
+	Curve25519_vfnX25519Base (lockKey, secret);
+	Curve25519_vfnX25519 (shared, secret, session.phoneKey);
+
+	/* A key of small order gives an all-zero secret any attacker knows */
+	for (i = 0; i < CURVE25519_BYTES; i++)
+	{
+		isZero |= shared[i];
+	}
+	if (!isZero)
+	{
+		Session_vfnWipe (secret, sizeof (secret));
+		Protocol_vfnReply ("PAIR ERR key");
+		return;
+	}
+
+	Session_vfnDerive (derived, eSESSION_LABEL_KEY, shared, lockKey);
+	Aes_vfnSetKey (&session.key, derived);
+	Session_vfnDerive (derived, eSESSION_LABEL_CODE, shared, lockKey);
+	code = ((uint32_t)derived[0] | ((uint32_t)derived[1] << 8) |
+			((uint32_t)derived[2] << 16) | ((uint32_t)derived[3] << 24)) % 1000000u;
+	session.isPaired = 1;
+	session.received = 0;
+	session.sent = 0;
+
+	Session_vfnEncode (text, lockKey, HALF_BYTES);
+	Protocol_vfnReply ("PAIR 0 %s", text);
+	Session_vfnEncode (text, &lockKey[HALF_BYTES], HALF_BYTES);
+	Protocol_vfnReply ("PAIR 1 %s", text);
+	for (i = CODE_DIGITS; i > 0; i--)
+	{
+		text[i - 1u] = (char)('0' + (code % 10u));
+		code /= 10u;
+	}
+	text[CODE_DIGITS] = '\0';
+	Protocol_vfnReply ("PAIR OK %s", text);
+
+	Session_vfnWipe (secret, sizeof (secret));
+	Session_vfnWipe (shared, sizeof (shared));
+	Session_vfnWipe (derived, sizeof (derived));
+}
+
+/*!
+	\fn			static void Session_vfnSecure (const char *args)
+	\brief		"$SEC frame": checks the counter, opens the frame, hands its
+				digits on and answers with a sealed frame. "$SEC" replies
+				the status.
+*/
+static void Session_vfnSecure (const char *args)
+{
+	uint8_t frame[FRAME_BYTES];
+	uint8_t nonce[AES_CCM_NONCE];
+	char text[2u * FRAME_BYTES + 1u];
+	uint32_t counter;
+	uint8_t length = 0;
+	uint8_t digits;
+	uint8_t i;
+
+	Session_vfnStir (Timebase_dwfnGetCycles ());
+	if (!session.isPaired)
+	{
+		Protocol_vfnReply ("SEC ERR unpaired");
+		return;
+	}
+	if (args[0] == '\0')
+	{
+		Protocol_vfnReply ("SEC received=%x sent=%x", session.received, session.sent);
+		return;
+	}
+	while (args[2u * length] != '\0')
+	{
+		if ((length >= FRAME_BYTES) || !Session_bfnDecode (&args[2u * length], &frame[length], 1))
+		{
+			Protocol_vfnReply ("SEC ERR format");
+			return;
+		}
+		length++;
+	}
+	if (length < (COUNTER_BYTES + 1u + AES_CCM_TAG))
+	{
+		Protocol_vfnReply ("SEC ERR format");
+		return;
+	}
+	digits = (uint8_t)(length - COUNTER_BYTES - AES_CCM_TAG);
+
+	counter = ((uint32_t)frame[0] << 24) | ((uint32_t)frame[1] << 16) |
+			((uint32_t)frame[2] << 8) | (uint32_t)frame[3];
+	if (counter <= session.received)
+	{
+		Protocol_vfnReply ("SEC ERR replay");
+		return;
+	}
+	Session_vfnNonce (nonce, eSESSION_FROM_PHONE, counter);
+	if (!Aes_bfnCcmOpen (&session.key, nonce, 0, 0, &frame[COUNTER_BYTES], digits,
+			&frame[COUNTER_BYTES + digits], &frame[COUNTER_BYTES]))
+	{
+		Protocol_vfnReply ("SEC ERR auth");
+		return;
+	}
+	session.received = counter;
+	for (i = 0; i < digits; i++)
+	{
+		if (frame[COUNTER_BYTES + i] > 9u)
+		{
+			Protocol_vfnReply ("SEC ERR format");
+			return;
+		}
+	}
+	for (i = 0; (i < digits) && digitCallback; i++)
+	{
+		digitCallback (frame[COUNTER_BYTES + i]);
+	}
+
+	/* The answer carries the phone's counter back under the lock's */
+	session.sent++;
+	Session_vfnNonce (nonce, eSESSION_FROM_LOCK, session.sent);
+	for (i = 0; i < COUNTER_BYTES; i++)
+	{
+		frame[COUNTER_BYTES + i] = frame[i];
+		frame[i] = (uint8_t)(session.sent >> (24u - 8u * i));
+	}
+	Aes_vfnCcmSeal (&session.key, nonce, 0, 0, &frame[COUNTER_BYTES], COUNTER_BYTES,
+			&frame[COUNTER_BYTES], &frame[2u * COUNTER_BYTES]);
+	Session_vfnEncode (text, frame, 2u * COUNTER_BYTES + AES_CCM_TAG);
+	Protocol_vfnReply ("SEC %s", text);
+}
+
+/*!
+	\fn			static void Session_vfnDraw (uint8_t *out, uint8_t blocks)
+	\param		out		Receives blocks * AES_BLOCK random bytes
+	\brief		Encrypts a counter under the pool, then rekeys the pool
+				from the same stream, so a later look at the RAM does not
+				give away the bytes drawn before
+*/
+static void Session_vfnDraw (uint8_t *out, uint8_t blocks)
+{
+	AES_CONTEXT context;
+	uint8_t key[AES_BLOCK];
+	uint8_t counter[AES_BLOCK] = {0};
+	uint32_t primask = __get_PRIMASK ();
+	uint8_t i;
+
+	Session_vfnStir (Timebase_dwfnGetCycles ());
+	__disable_irq ();
+	for (i = 0; i < AES_BLOCK; i++)
+	{
+		key[i] = (uint8_t)(pool[i >> 2] >> (8u * (i & 3u)));
+	}
+	__set_PRIMASK (primask);
+	Aes_vfnSetKey (&context, key);
+
+	for (i = 0; i < blocks; i++)
+	{
+		counter[0] = (uint8_t)(i + 1u);
+		Aes_vfnEncrypt (&context, counter, &out[i * AES_BLOCK]);
+	}
+	counter[0] = 0;
+	Aes_vfnEncrypt (&context, counter, key);
+	for (i = 0; i < AES_BLOCK; i += 4u)
+	{
+		Session_vfnStir ((uint32_t)key[i] | ((uint32_t)key[i + 1u] << 8) |
+				((uint32_t)key[i + 2u] << 16) | ((uint32_t)key[i + 3u] << 24));
+	}
+
+	Session_vfnWipe (&context, sizeof (context));
+	Session_vfnWipe (key, sizeof (key));
+}
+
+/*!
+	\fn			static void Session_vfnDerive (uint8_t *out, SESSION_LABEL label,
+					const uint8_t *shared, const uint8_t *lockKey)
+	\param		out		Receives AES_BLOCK derived bytes
+	\param		label	Value to derive
+	\brief		Davies-Meyer: every 16 bytes of shared secret, lock key
+				and phone key in turn key AES over the chain value, which
+				is then xored in. The input always has the same length, so
+				it needs no padding.
+*/
+static void Session_vfnDerive (uint8_t *out, SESSION_LABEL label,
+		const uint8_t *shared, const uint8_t *lockKey)
+{
+	const uint8_t *parts[3];
+	AES_CONTEXT context;
+	uint8_t block[AES_BLOCK];
+	uint8_t part;
+	uint8_t offset;
+	uint8_t i;
+
+	parts[0] = shared;
+	parts[1] = lockKey;
+	parts[2] = session.phoneKey;
+	for (i = 0; i < AES_BLOCK; i++)
+	{
+		out[i] = 0;
+	}
+	out[0] = (uint8_t)label;
+
+	for (part = 0; part < 3u; part++)
+	{
+		for (offset = 0; offset < CURVE25519_BYTES; offset += AES_BLOCK)
+		{
+			Aes_vfnSetKey (&context, &parts[part][offset]);
+			Aes_vfnEncrypt (&context, out, block);
+			for (i = 0; i < AES_BLOCK; i++)
+			{
+				out[i] ^= block[i];
+			}
+		}
+	}
+	Session_vfnWipe (&context, sizeof (context));
+	Session_vfnWipe (block, sizeof (block));
+}
+
+/*!
+	\fn			static void Session_vfnNonce (uint8_t *nonce, SESSION_DIRECTION direction, uint32_t counter)
+	\param		nonce	Receives direction, the big-endian counter and zeros
+*/
+static void Session_vfnNonce (uint8_t *nonce, SESSION_DIRECTION direction, uint32_t counter)
+{
+	uint8_t i;
+
+	nonce[0] = (uint8_t)direction;
+	for (i = 0; i < COUNTER_BYTES; i++)
+	{
+		nonce[1u + i] = (uint8_t)(counter >> (24u - 8u * i));
+	}
+	for (i = 1u + COUNTER_BYTES; i < AES_CCM_NONCE; i++)
+	{
+		nonce[i] = 0;
+	}
+}
+
+/*!
+	\fn			static uint8_t Session_bfnWindow (void)
+	\return		Returns 1 while the pairing window is open; else, returns 0
+*/
+static uint8_t Session_bfnWindow (void)
+{
+	if (session.isWindowOpen &&
+			((Timebase_dwfnGetMs () - session.windowStart) >= SESSION_PAIRING_MS))
+	{
+		session.isWindowOpen = 0;
+		session.halves = 0;
+	}
+	return session.isWindowOpen;
+}
+
+/*!
+	\fn			static uint8_t Session_bfnDecode (const char *text, uint8_t *out, uint8_t size)
+	\param		text	Hex digits, lower or upper case
+	\param		out		Receives size bytes
+	\return		Returns 1 if text is exactly size bytes of hex, or holds
+				more after them when size is 1; else, returns 0
+*/
+static uint8_t Session_bfnDecode (const char *text, uint8_t *out, uint8_t size)
+{
+	uint8_t value = 0;
+	uint8_t digit;
+	uint8_t i;
+	char c;
+
+	for (i = 0; i < 2u * size; i++)
+	{
+		c = text[i];
+		if ((c >= '0') && (c <= '9'))
+		{
+			digit = (uint8_t)(c - '0');
+		}
+		else if ((c >= 'a') && (c <= 'f'))
+		{
+			digit = (uint8_t)(c - 'a' + 10);
+		}
+		else if ((c >= 'A') && (c <= 'F'))
+		{
+			digit = (uint8_t)(c - 'A' + 10);
+		}
+		else
+		{
+			return 0;
+		}
+		value = (uint8_t)((value << 4) | digit);
+		if (i & 1u)
+		{
+			out[i >> 1] = value;
+		}
+	}
+	return (size == 1u) || (text[2u * size] == '\0');
+}
+
+/*!
+	\fn			static void Session_vfnEncode (char *text, const uint8_t *in, uint8_t size)
+	\param		text	Receives 2 * size hex digits and the terminator
+*/
+static void Session_vfnEncode (char *text, const uint8_t *in, uint8_t size)
+{
+	uint8_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		text[2u * i] = hexDigits[in[i] >> 4];
+		text[2u * i + 1u] = hexDigits[in[i] & 0x0Fu];
+	}
+	text[2u * size] = '\0';
+}
+
+/*!
+	\fn			static void Session_vfnWipe (void *data, uint32_t size)
+	\brief		Clears a secret through a volatile pointer, which the
+				compiler may not drop as a dead store
+*/
+static void Session_vfnWipe (void *data, uint32_t size)
+{
+	volatile uint8_t *bytes = (volatile uint8_t *)data;
+
+	while (size--)
+	{
+		*bytes++ = 0;
+	}
+}
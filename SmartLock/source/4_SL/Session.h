@@ -0,0 +1,67 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Session.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the secure Bluetooth session. A
+				phone pairs with an X25519 key agreement while the pairing
+				window is open, which takes a correct pin on the keypad;
+				after that the pin digits travel in AES-128-CCM frames with
+				a counter that only goes up, so a frame can neither be read,
+				forged nor replayed.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_SESSION_H_
+#define _4_SL_SESSION_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		SESSION_REQUIRED
+	\brief		Refuses the plain Bluetooth digits even before a phone was
+				paired, so a pin can only come from the keypad or a session
+*/
+#ifndef HOST_SIMULATION
+//	#define SESSION_REQUIRED
+#endif
+
+/*!
+	\def		SESSION_PAIRING_MS
+	\brief		Time the pairing window stays open after a correct pin
+*/
+#define		SESSION_PAIRING_MS	60000u
+
+/*!
+	\def		SESSION_PAYLOAD
+	\brief		Most digits in one frame; the counter, the digits and the
+				tag fill a protocol line
+*/
+#define		SESSION_PAYLOAD		10u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	SESSION_DIGIT_CALLBACK
+	\brief		Called from the main loop with every digit of an
+				authenticated frame, 0 to 9
+*/
+typedef void (*SESSION_DIGIT_CALLBACK)(uint8_t digit);
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Session_vfnInit (SESSION_DIGIT_CALLBACK callback);
+
+void Session_vfnAllowPairing (void);
+
+uint8_t Session_bfnIsPaired (void);
+
+void Session_vfnStir (uint32_t sample);
+
+#endif /* _4_SL_SESSION_H_ */
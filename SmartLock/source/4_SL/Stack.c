@@ -0,0 +1,239 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Stack.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the stack monitor. Stack_vfnInit,
+				the first call of main, fills the main stack from its base
+				up to the current stack pointer with STACK_PAINT; the first
+				word from the base that no longer holds it is the deepest
+				the stack ever went. The base and the top are the
+				_vStackBase and _vStackTop of the MCUXpresso linker script;
+				a stack reaching its base has overflowed into the heap.
+
+				With STACK_ISR_PROFILE an interrupt entry records the depth
+				of the stack it found, then repaints STACK_ISR_WINDOW bytes
+				below it; the exit finds how much of them the handler used.
+				An interrupt that preempts another one repaints part of the
+				first one's window, so a nested handler can read low.
+
+				Command:
+					$STACK		STACK size= used= free=
+								and with STACK_ISR_PROFILE one line per
+								interrupt: STACK isr in= used=
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Protocol.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		STACK_PAINT
+	\brief		Pattern of a stack word never used
+*/
+#define		STACK_PAINT			0xC5C5C5C5u
+
+/*!
+	\def		ISR_WINDOW_WORDS
+	\brief		Words of STACK_ISR_WINDOW
+*/
+#define		ISR_WINDOW_WORDS	(STACK_ISR_WINDOW / 4u)
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+#ifndef HOST_SIMULATION
+/*!
+	\var		_vStackBase, _vStackTop
+	\brief		Lowest address of the stack and the one above it, from the
+				linker script
+*/
+extern uint32_t _vStackBase[];
+extern uint32_t _vStackTop[];
+#endif
+
+#ifdef STACK_ISR_PROFILE
+/*!
+	\var		entrySp
+	\brief		Stack pointer of every interrupt running
+*/
+static uint32_t *entrySp[eSTACK_ISRS];
+#endif
+
+/*!
+	\var		isrStats
+	\brief		Stack of every interrupt
+*/
+static STACK_ISR_STATS isrStats[eSTACK_ISRS];
+
+#ifdef STACK_ISR_PROFILE
+/*!
+	\var		isrNames
+	\brief		Reply names of STACK_ISR
+*/
+static const char * const isrNames[eSTACK_ISRS] = {
+	"tick", "pit", "uart", "udma", "usb", "port", "fxio", "adma", "cdma", "rtc"
+};
+#endif
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Stack_vfnCommand (const char *args);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Stack_vfnInit (void)
+	\brief		Paints the free part of the main stack and registers
+				"$STACK". The interrupts must still be off.
+*/
+void Stack_vfnInit (void)
+{
+#ifndef HOST_SIMULATION
+	uint32_t *word = _vStackBase;
+	uint32_t *sp = (uint32_t *)__get_MSP ();
+
+	/* Everything below the stack pointer is free */
+	while (word < sp)
+	{
+		*word++ = STACK_PAINT;
+	}
+#endif
+
+	Protocol_bfnRegister ("STACK", Stack_vfnCommand);
+}
+
+/*!
+	\fn			uint32_t Stack_dwfnGetSize (void)
+	\return		Returns the bytes reserved for the main stack; 0 on the host
+*/
+uint32_t Stack_dwfnGetSize (void)
+{
+#ifndef HOST_SIMULATION
+	return (uint32_t)(_vStackTop - _vStackBase) * 4u;
+#else
+	return 0;
+#endif
+}
+
+/*!
+	\fn			uint32_t Stack_dwfnGetHighWater (void)
+	\return		Returns the most bytes of the main stack ever used; the
+				size if it overflowed
+	\brief		Reads the stack from its base up, only on request
+*/
+uint32_t Stack_dwfnGetHighWater (void)
+{
+#ifndef HOST_SIMULATION
+	const uint32_t *word = _vStackBase;
+
+	while ((word < _vStackTop) && (*word == STACK_PAINT))
+	{
+		word++;
+	}
+	return (uint32_t)(_vStackTop - word) * 4u;
+#else
+	return 0;
+#endif
+}
+
+/*!
+	\fn			void Stack_vfnIsrEnter (STACK_ISR isr)
+	\brief		Records the depth of the stack and repaints the window below
+				it. Called through STACK_ISR_ENTER.
+*/
+void Stack_vfnIsrEnter (STACK_ISR isr)
+{
+#ifdef STACK_ISR_PROFILE
+	uint32_t *sp = (uint32_t *)__get_MSP ();
+	uint32_t *word = sp - ISR_WINDOW_WORDS;
+	uint32_t depth = (uint32_t)(_vStackTop - sp) * 4u;
+
+	if (depth > isrStats[isr].entryMax)
+	{
+		isrStats[isr].entryMax = (uint16_t)depth;
+	}
+	entrySp[isr] = sp;
+	if (word < _vStackBase)
+	{
+		word = _vStackBase;
+	}
+	while (word < sp)
+	{
+		*word++ = STACK_PAINT;
+	}
+#else
+	(void)isr;
+#endif
+}
+
+/*!
+	\fn			void Stack_vfnIsrExit (STACK_ISR isr)
+	\brief		Finds how much of the window the interrupt used. Called
+				through STACK_ISR_EXIT.
+*/
+void Stack_vfnIsrExit (STACK_ISR isr)
+{
+#ifdef STACK_ISR_PROFILE
+	uint32_t *sp = entrySp[isr];
+	const uint32_t *word = sp - ISR_WINDOW_WORDS;
+	uint32_t used;
+
+	if (word < _vStackBase)
+	{
+		word = _vStackBase;
+	}
+	while ((word < sp) && (*word == STACK_PAINT))
+	{
+		word++;
+	}
+	used = (uint32_t)(sp - word) * 4u;
+	if (used > isrStats[isr].usedMax)
+	{
+		isrStats[isr].usedMax = (uint16_t)used;
+	}
+#else
+	(void)isr;
+#endif
+}
+
+/*!
+	\fn			void Stack_vfnGetIsrStats (STACK_ISR isr, STACK_ISR_STATS *out)
+	\brief		Copies the stack of an interrupt
+*/
+void Stack_vfnGetIsrStats (STACK_ISR isr, STACK_ISR_STATS *out)
+{
+	*out = isrStats[isr];
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Stack_vfnCommand (const char *args)
+	\brief		"$STACK": the main stack and the interrupts sampled
+*/
+static void Stack_vfnCommand (const char *args)
+{
+	uint32_t size = Stack_dwfnGetSize ();
+	uint32_t used = Stack_dwfnGetHighWater ();
+#ifdef STACK_ISR_PROFILE
+	uint8_t isr;
+#endif
+
+	(void)args;
+	Protocol_vfnReply ("STACK size=%u used=%u free=%u", size, used, size - used);
+#ifdef STACK_ISR_PROFILE
+	for (isr = 0; isr < eSTACK_ISRS; isr++)
+	{
+		Protocol_vfnReply ("STACK %s in=%u used=%u", isrNames[isr], (uint32_t)isrStats[isr].entryMax,
+				(uint32_t)isrStats[isr].usedMax);
+	}
+#endif
+}
@@ -0,0 +1,102 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Stack.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the stack monitor. The main stack is
+				painted at boot and its high-water mark is read back on
+				request; with STACK_ISR_PROFILE every interrupt also records
+				how deep the stack was when it came and how much it used.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_STACK_H_
+#define _4_SL_STACK_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		STACK_ISR_PROFILE
+	\brief		Samples the stack on the entry and the exit of every
+				interrupt. An entry repaints STACK_ISR_WINDOW bytes below
+				the interrupt's frame, about 200 cycles, so it is for
+				sizing builds only.
+*/
+#ifndef HOST_SIMULATION
+//	#define STACK_ISR_PROFILE
+#endif
+
+/*!
+	\def		STACK_ISR_WINDOW
+	\brief		Stack an interrupt may use that is measured; more is
+				reported as this much
+*/
+#define		STACK_ISR_WINDOW	256u
+
+/*!
+	\def		STACK_ISR_ENTER, STACK_ISR_EXIT
+	\brief		First and last statements of an interrupt handler
+*/
+#ifdef STACK_ISR_PROFILE
+	#define		STACK_ISR_ENTER(isr)	Stack_vfnIsrEnter (isr)
+	#define		STACK_ISR_EXIT(isr)		Stack_vfnIsrExit (isr)
+#else
+	#define		STACK_ISR_ENTER(isr)
+	#define		STACK_ISR_EXIT(isr)
+#endif
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		STACK_ISR
+	\brief		Interrupts sampled
+*/
+typedef enum
+{
+	eSTACK_ISR_TICK,		/* SysTick */
+	eSTACK_ISR_PIT,
+	eSTACK_ISR_UART,		/* LPUART0 */
+	eSTACK_ISR_UART_DMA,	/* DMA1 */
+	eSTACK_ISR_USB,
+	eSTACK_ISR_PORT,		/* PORTB to PORTE */
+	eSTACK_ISR_FLEXIO,
+	eSTACK_ISR_ADC_DMA,		/* DMA2 */
+	eSTACK_ISR_CRC_DMA,		/* DMA0 */
+	eSTACK_ISR_RTC,
+	eSTACK_ISRS
+} STACK_ISR;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		STACK_ISR_STATS
+	\brief		Stack of one interrupt, in bytes
+*/
+typedef struct
+{
+	uint16_t entryMax;		/* deepest stack found on entry, its frame included */
+	uint16_t usedMax;		/* most used below its frame */
+} STACK_ISR_STATS;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Stack_vfnInit (void);
+
+uint32_t Stack_dwfnGetSize (void);
+
+uint32_t Stack_dwfnGetHighWater (void);
+
+void Stack_vfnIsrEnter (STACK_ISR isr);
+
+void Stack_vfnIsrExit (STACK_ISR isr);
+
+void Stack_vfnGetIsrStats (STACK_ISR isr, STACK_ISR_STATS *out);
+
+#endif /* _4_SL_STACK_H_ */
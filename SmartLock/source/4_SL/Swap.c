@@ -0,0 +1,464 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		Swap.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the firmware slots. The journal is
+				a list of 16-byte records appended to erased flash; the last
+				valid records give the state, and a record torn by a reset
+				fails its check and is skipped. A sector is swapped in three
+				steps, each journaled once it is done:
+					1. primary sector to the scratch sector
+					2. secondary sector to the primary sector
+					3. scratch sector to the secondary sector
+				The source of every step is intact until the next step is
+				journaled, so an interrupted step is simply done again.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "MKL27Z644.h"
+#include "CRC.h"
+#include "Flash.h"
+#include "Swap.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		SWAP_SECTORS
+	\brief		Sectors in a slot
+*/
+#define		SWAP_SECTORS		(SWAP_SLOT_SIZE / FLASH_SECTOR)
+
+/*!
+	\def		JOURNAL_RECORDS
+	\brief		Records that fit the journal
+*/
+#define		JOURNAL_RECORDS		(SWAP_JOURNAL_SIZE / sizeof (SWAP_RECORD))
+
+/*!
+	\def		RECORD_MAGIC
+	\brief		Top byte of every record tag
+*/
+#define		RECORD_MAGIC		0x5A000000u
+
+/*!
+	\def		RECORD_SEED
+	\brief		Mixed into the check word so an all-zero record is invalid
+*/
+#define		RECORD_SEED			0xC3A5965Au
+
+/*!
+	\def		RECORD_TAG
+	\brief		Tag word of a record type and its argument
+*/
+#define		RECORD_TAG(type, arg)	(RECORD_MAGIC | ((uint32_t)(type) << 16) | (uint16_t)(arg))
+
+/*!
+	\def		STEP_ARG
+	\brief		Argument of a step record: direction, sector and step 1 to 3
+*/
+#define		STEP_ARG(revert, sector, step)	(((revert) << 15) | ((sector) << 2) | (step))
+
+/*!
+	\def		STEP_NONE
+	\brief		Position before the first step
+*/
+#define		STEP_NONE			0u
+
+/*!
+	\def		SWAP_SERVICE_COP
+	\brief		Refreshes the COP the bootloader started; a sector copy takes
+				well under its timeout, a whole swap takes seconds
+*/
+#ifndef HOST_SIMULATION
+	#define		SWAP_SERVICE_COP()	do { SIM->SRVCOP = 0x55u; SIM->SRVCOP = 0xAAu; } while (0)
+#else
+	#define		SWAP_SERVICE_COP()
+#endif
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		SWAP_RECORD_TYPE
+	\brief		Journal records
+*/
+typedef enum
+{
+	eRECORD_READY = 1,	/* a = image size, b = image CRC-32 */
+	eRECORD_STEP,		/* argument = STEP_ARG */
+	eRECORD_SWAPPED,	/* argument = 1 after a rollback */
+	eRECORD_TRIAL,		/* the bootloader started the new image */
+	eRECORD_CONFIRMED	/* the new image confirmed itself */
+} SWAP_RECORD_TYPE;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		SWAP_RECORD
+	\brief		Journal record; check is programmed last
+*/
+typedef struct
+{
+	uint32_t tag;
+	uint32_t a;
+	uint32_t b;
+	uint32_t check;
+} SWAP_RECORD;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		state
+	\brief		State found by the last scan
+*/
+static SWAP_STATE state = eSWAP_IDLE;
+
+/*!
+	\var		nextRecord
+	\brief		First erased record of the journal
+*/
+static uint16_t nextRecord = 0;
+
+/*!
+	\var		needsCompact
+	\brief		The journal holds records, or leftovers of an interrupted
+				compaction, although the state is idle
+*/
+static uint8_t needsCompact = 0;
+
+/*!
+	\var		lastStep
+	\brief		Argument of the last step record of the running swap
+*/
+static uint16_t lastStep = STEP_NONE;
+
+/*!
+	\var		imageSize
+	\brief		Size of the image of the ready record
+*/
+static uint32_t imageSize = 0;
+
+/*!
+	\var		imageCrc
+	\brief		CRC-32 of the image of the ready record
+*/
+static uint32_t imageCrc = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Swap_vfnScan (void);
+static uint8_t Swap_bfnAppend (SWAP_RECORD_TYPE type, uint16_t arg, uint32_t a, uint32_t b);
+static uint8_t Swap_bfnCompact (void);
+static uint8_t Swap_bfnRun (uint8_t revert, uint16_t resume);
+static uint8_t Swap_bfnCopy (uint32_t destination, uint32_t source);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			SWAP_STATE Swap_efnGetState (void)
+	\return		Returns the state of the slots
+*/
+SWAP_STATE Swap_efnGetState (void)
+{
+	Swap_vfnScan ();
+	return state;
+}
+
+/*!
+	\fn			uint8_t Swap_bfnRequest (uint32_t size, uint32_t crc)
+	\param		size	Bytes of the image written to the secondary slot
+	\param		crc		Its CRC-32, checked again by the bootloader
+	\return		Returns 1 if the swap was requested; else, returns 0
+	\brief		Asks the bootloader to start the secondary image on the next
+				reset. Only possible while the slots are idle.
+*/
+uint8_t Swap_bfnRequest (uint32_t size, uint32_t crc)
+{
+	Swap_vfnScan ();
+	if ((state != eSWAP_IDLE) || (size == 0) || (size > SWAP_SLOT_SIZE))
+	{
+		return 0;
+	}
+	if (needsCompact && !Swap_bfnCompact ())
+	{
+		return 0;
+	}
+	return Swap_bfnAppend (eRECORD_READY, 0, size, crc);
+}
+
+/*!
+	\fn			uint8_t Swap_bfnConfirm (void)
+	\return		Returns 1 if the running image is kept for good; else,
+				returns 0
+	\brief		Called by the application once it is up. Keeps a new image,
+				which the bootloader would otherwise swap back on the next
+				reset, and clears the journal.
+*/
+uint8_t Swap_bfnConfirm (void)
+{
+	Swap_vfnScan ();
+	if (state == eSWAP_TRIAL)
+	{
+		if (!Swap_bfnAppend (eRECORD_CONFIRMED, 0, 0, 0))
+		{
+			return 0;
+		}
+		Swap_vfnScan ();
+	}
+	if (state != eSWAP_IDLE)
+	{
+		return 0;
+	}
+	return !needsCompact || Swap_bfnCompact ();
+}
+
+/*!
+	\fn			SWAP_STATE Swap_efnBoot (void)
+	\return		Returns eSWAP_TRIAL if a new image is started for the first
+				time; else, returns eSWAP_IDLE
+	\brief		Bootloader side. Finishes whatever the journal says is
+				pending: verifies and swaps in a ready image, resumes an
+				interrupted swap, or swaps back an image that was started but
+				never confirmed itself.
+*/
+SWAP_STATE Swap_efnBoot (void)
+{
+	Swap_vfnScan ();
+
+	switch (state)
+	{
+		case eSWAP_READY:
+			if (CRC_dwfnCompute (eCRC32, Flash_pbfnRead (SWAP_SECONDARY), imageSize) != imageCrc)
+			{
+				/* Damaged since it was written: keep the running image */
+				Swap_bfnCompact ();
+				break;
+			}
+			lastStep = STEP_NONE;
+			/* no break */
+		case eSWAP_SWAPPING:
+			if (!Swap_bfnRun (0, lastStep) || !Swap_bfnAppend (eRECORD_SWAPPED, 0, 0, 0))
+			{
+				break;
+			}
+			/* no break */
+		case eSWAP_TESTING:
+			Swap_bfnAppend (eRECORD_TRIAL, 0, 0, 0);
+			break;
+
+		case eSWAP_TRIAL:
+			/* Started before and reset without confirming: roll back */
+			lastStep = STEP_NONE;
+			/* no break */
+		case eSWAP_REVERTING:
+			if (Swap_bfnRun (1, lastStep) && Swap_bfnAppend (eRECORD_SWAPPED, 1, 0, 0))
+			{
+				Swap_bfnCompact ();
+			}
+			break;
+
+		default:
+			if (needsCompact)
+			{
+				Swap_bfnCompact ();
+			}
+			break;
+	}
+
+	Swap_vfnScan ();
+	return state;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Swap_vfnScan (void)
+	\brief		Reads the journal up to its first erased record. Data past
+				that record is left from an interrupted compaction, which is
+				only ever started from an idle state, so it reads as idle.
+*/
+static void Swap_vfnScan (void)
+{
+	const SWAP_RECORD *journal = (const SWAP_RECORD *)Flash_pbfnRead (SWAP_JOURNAL);
+	const uint32_t *word;
+	SWAP_RECORD record;
+	uint16_t i = 0;
+
+	state = eSWAP_IDLE;
+	needsCompact = 0;
+	lastStep = STEP_NONE;
+
+	for (i = 0; i < JOURNAL_RECORDS; i++)
+	{
+		memcpy (&record, &journal[i], sizeof (record));
+		if (record.tag == FLASH_ERASED)
+		{
+			break;
+		}
+		needsCompact = 1;
+		if (((record.tag & 0xFF000000u) != RECORD_MAGIC) ||
+				(record.check != (record.tag ^ record.a ^ record.b ^ RECORD_SEED)))
+		{
+			continue;
+		}
+
+		switch ((record.tag >> 16) & 0xFF)
+		{
+			case eRECORD_READY:
+				state = eSWAP_READY;
+				imageSize = record.a;
+				imageCrc = record.b;
+				break;
+			case eRECORD_STEP:
+				lastStep = (uint16_t)record.tag;
+				state = (lastStep & 0x8000u) ? eSWAP_REVERTING : eSWAP_SWAPPING;
+				break;
+			case eRECORD_SWAPPED:
+				state = ((uint16_t)record.tag) ? eSWAP_IDLE : eSWAP_TESTING;
+				break;
+			case eRECORD_TRIAL:
+				state = eSWAP_TRIAL;
+				break;
+			case eRECORD_CONFIRMED:
+				state = eSWAP_IDLE;
+				break;
+			default:
+				break;
+		}
+	}
+	nextRecord = i;
+
+	for (word = (const uint32_t *)&journal[i]; word < (const uint32_t *)&journal[JOURNAL_RECORDS]; word++)
+	{
+		if (*word != FLASH_ERASED)
+		{
+			state = eSWAP_IDLE;
+			needsCompact = 1;
+			nextRecord = JOURNAL_RECORDS;
+			break;
+		}
+	}
+}
+
+/*!
+	\fn			static uint8_t Swap_bfnAppend (SWAP_RECORD_TYPE type, uint16_t arg, uint32_t a, uint32_t b)
+	\return		Returns 1 if the record was written; else, returns 0
+	\brief		Programs the next journal record, check word last
+*/
+static uint8_t Swap_bfnAppend (SWAP_RECORD_TYPE type, uint16_t arg, uint32_t a, uint32_t b)
+{
+	SWAP_RECORD record;
+
+	if (nextRecord >= JOURNAL_RECORDS)
+	{
+		return 0;
+	}
+	record.tag = RECORD_TAG (type, arg);
+	record.a = a;
+	record.b = b;
+	record.check = record.tag ^ a ^ b ^ RECORD_SEED;
+
+	/* Even a failed record takes its place: it is not erased any more */
+	nextRecord++;
+	return Flash_bfnProgram (SWAP_JOURNAL + (nextRecord - 1) * sizeof (record),
+			(const uint8_t *)&record, sizeof (record));
+}
+
+/*!
+	\fn			static uint8_t Swap_bfnCompact (void)
+	\return		Returns 1 if the journal was erased; else, returns 0
+	\brief		Erases the journal, first sector first: once the first record
+				is gone the state reads as idle, which is what compacting is
+				only done from
+*/
+static uint8_t Swap_bfnCompact (void)
+{
+	uint32_t address = SWAP_JOURNAL;
+
+	for (address = SWAP_JOURNAL; address < SWAP_JOURNAL + SWAP_JOURNAL_SIZE; address += FLASH_SECTOR)
+	{
+		if (!Flash_bfnErase (address))
+		{
+			return 0;
+		}
+	}
+	state = eSWAP_IDLE;
+	nextRecord = 0;
+	needsCompact = 0;
+	return 1;
+}
+
+/*!
+	\fn			static uint8_t Swap_bfnRun (uint8_t revert, uint16_t resume)
+	\param		revert	1 when swapping back to the old image
+	\param		resume	Last journaled step, or STEP_NONE
+	\return		Returns 1 if every sector was swapped; else, returns 0
+	\brief		Swaps the slots from the step after resume. Sectors that are
+				equal in both slots, the erased tail of small images most of
+				all, are skipped without a record: they are still equal when a
+				resumed swap looks at them again.
+*/
+static uint8_t Swap_bfnRun (uint8_t revert, uint16_t resume)
+{
+	uint16_t sector = 0;
+	uint16_t step = 1;
+	uint32_t primary;
+	uint32_t secondary;
+
+	if (resume != STEP_NONE)
+	{
+		sector = (resume >> 2) & 0x1FFF;
+		step = (uint16_t)((resume & 3) + 1);
+		if (step > 3)
+		{
+			sector++;
+			step = 1;
+		}
+	}
+
+	for (; sector < SWAP_SECTORS; sector++, step = 1)
+	{
+		primary = SWAP_PRIMARY + sector * FLASH_SECTOR;
+		secondary = SWAP_SECONDARY + sector * FLASH_SECTOR;
+
+		if ((step == 1) &&
+				(memcmp (Flash_pbfnRead (primary), Flash_pbfnRead (secondary), FLASH_SECTOR) == 0))
+		{
+			continue;
+		}
+		for (; step <= 3; step++)
+		{
+			if (((step == 1) && !Swap_bfnCopy (SWAP_SCRATCH, primary)) ||
+					((step == 2) && !Swap_bfnCopy (primary, secondary)) ||
+					((step == 3) && !Swap_bfnCopy (secondary, SWAP_SCRATCH)) ||
+					!Swap_bfnAppend (eRECORD_STEP, (uint16_t)STEP_ARG (revert, sector, step), 0, 0))
+			{
+				return 0;
+			}
+		}
+	}
+	return 1;
+}
+
+/*!
+	\fn			static uint8_t Swap_bfnCopy (uint32_t destination, uint32_t source)
+	\return		Returns 1 if the sector was copied; else, returns 0
+	\brief		Erases a sector and programs it with another one. Only the
+				bootloader swaps, so the COP serviced here is its own.
+*/
+static uint8_t Swap_bfnCopy (uint32_t destination, uint32_t source)
+{
+	SWAP_SERVICE_COP ();
+	return Flash_bfnErase (destination) &&
+			Flash_bfnProgram (destination, Flash_pbfnRead (source), FLASH_SECTOR);
+}
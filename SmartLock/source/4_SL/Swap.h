@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+/*!
+	\file		Swap.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the firmware slots. The application
+				always runs from the primary slot; an update is written to the
+				secondary slot and the bootloader swaps the two sector by
+				sector through a scratch sector. Every step is journaled in
+				flash first, so a reset at any point resumes the swap, and an
+				image that resets before confirming itself is swapped back.
+
+				Flash map of the KL27Z64:
+					0x0000 - 0x0FFF		bootloader, flash configuration field
+					0x1000 - 0x7FFF		primary slot, the running application
+					0x8000 - 0xEFFF		secondary slot, download or rollback image
+					0xF000 - 0xF3FF		scratch sector of the swap
+					0xF400 - 0xFFFF		swap journal
+				With FOTA_ENABLE the application must be linked at SWAP_PRIMARY
+				(MCU settings, flash origin 0x1000, no flash configuration
+				field) and started by the bootloader.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+#ifndef _4_SL_SWAP_H_
+#define _4_SL_SWAP_H_
+
+//--------------------------------------------------------------------------
+// Includes
+//--------------------------------------------------------------------------
+#include <stdint.h>
+#include "Flash.h"
+
+//--------------------------------------------------------------------------
+// Defines
+//--------------------------------------------------------------------------
+/*!
+	\def		SWAP_PRIMARY
+	\brief		Start of the slot the application runs from
+*/
+#define SWAP_PRIMARY		0x1000u
+
+/*!
+	\def		SWAP_SECONDARY
+	\brief		Start of the slot updates are written to
+*/
+#define SWAP_SECONDARY		0x8000u
+
+/*!
+	\def		SWAP_SLOT_SIZE
+	\brief		Size of each slot, the largest image
+*/
+#define SWAP_SLOT_SIZE		0x7000u
+
+/*!
+	\def		SWAP_SCRATCH
+	\brief		Sector holding a primary sector while it is swapped
+*/
+#define SWAP_SCRATCH		0xF000u
+
+/*!
+	\def		SWAP_JOURNAL
+	\brief		Start of the swap journal
+*/
+#define SWAP_JOURNAL		0xF400u
+
+/*!
+	\def		SWAP_JOURNAL_SIZE
+	\brief		Size of the journal, enough for a swap and its rollback
+*/
+#define SWAP_JOURNAL_SIZE	0xC00u
+
+//--------------------------------------------------------------------------
+// Enums
+//--------------------------------------------------------------------------
+/*!
+	\enum		SWAP_STATE
+	\brief		State of the slots as read from the journal
+*/
+typedef enum
+{
+	eSWAP_IDLE,			/* primary runs, the secondary is free */
+	eSWAP_READY,		/* a verified image waits in the secondary slot */
+	eSWAP_SWAPPING,		/* the swap to the new image was interrupted */
+	eSWAP_TESTING,		/* swapped, the new image was not started yet */
+	eSWAP_TRIAL,		/* the new image runs and has not confirmed itself */
+	eSWAP_REVERTING,	/* the swap back to the old image was interrupted */
+	eSWAP_STATES
+} SWAP_STATE;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+SWAP_STATE Swap_efnGetState (void);
+
+uint8_t Swap_bfnRequest (uint32_t size, uint32_t crc);
+
+uint8_t Swap_bfnConfirm (void);
+
+SWAP_STATE Swap_efnBoot (void);
+
+//------------------------------------------------------------------------------
+#endif /* _4_SL_SWAP_H_ */
@@ -0,0 +1,191 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Timebase.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the free-running cycle counter.
+				The Cortex-M0+ has no DWT cycle counter, so SysTick is left
+				running over its full 24-bit range (started by ResetISR) and
+				every wrap is accumulated in software to extend it to 32 bits.
+				The millisecond count comes from the system tick on PIT
+				channel 1, since the cycle count changes rate with the clock
+				profile.
+
+				For the same reason a cycle count is converted to time at
+				the clock running when it is converted. An interval that
+				spans a ClockProfile switch comes out wrong; the switches
+				happen only in ClockProfile_vfnTask, so intervals taken
+				within an interrupt, or within a main loop pass after the
+				task, are exact.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Timebase.h"
+#include "PIT.h"
+#include "Watchdog.h"
+#include "Stack.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CYCLES_PER_WRAP
+	\brief		Number of core cycles counted between two SysTick wraps
+*/
+#define		CYCLES_PER_WRAP		(TIMEBASE_RELOAD + 1u)
+
+/*!
+	\def		US_PER_SECOND
+	\brief		Microseconds in a second
+*/
+#define		US_PER_SECOND		1000000u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		wrapCycles
+	\brief		Cycles accumulated by the SysTick wraps seen so far
+*/
+static volatile uint32_t wrapCycles = 0;
+
+/*!
+	\var		cyclesPerUs
+	\brief		Core cycles per microsecond at the current core clock
+*/
+static uint32_t cyclesPerUs = DEFAULT_SYSTEM_CLOCK / US_PER_SECOND;
+
+/*!
+	\var		tickMs
+	\brief		Milliseconds counted by the system tick
+*/
+static volatile uint32_t tickMs = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Timebase_vfnTick (void);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Timebase_vfnInit (void)
+	\brief		Enables the SysTick wrap interrupt. If the counter was not
+				already started by the startup code, it is started here.
+*/
+void Timebase_vfnInit (void)
+{
+	if (!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk))
+	{
+		SysTick->LOAD = TIMEBASE_RELOAD;
+		SysTick->VAL = 0;
+	}
+
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk
+			| SysTick_CTRL_ENABLE_Msk;
+
+	Timebase_vfnClockChanged (SystemCoreClock);
+}
+
+/*!
+	\fn			uint32_t Timebase_dwfnGetCycles (void)
+	\return		Returns the number of core cycles elapsed since reset
+	\brief		Combines the software wrap count with the current SysTick
+				value. The wrap count is read twice so a wrap happening in
+				the middle of the read is not lost. With the interrupts
+				masked, or from an interrupt, a wrap may still wait for
+				SysTick_Handler: it is seen pending and counted here, with
+				the counter read again after it.
+*/
+uint32_t Timebase_dwfnGetCycles (void)
+{
+	uint32_t wraps;
+	uint32_t pending;
+	uint32_t value;
+
+	do
+	{
+		wraps = wrapCycles;
+		value = SysTick->VAL;
+		pending = 0;
+		if (SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+		{
+			value = SysTick->VAL;
+			pending = CYCLES_PER_WRAP;
+		}
+	} while (wraps != wrapCycles);
+
+	return wraps + pending + (TIMEBASE_RELOAD - value);
+}
+
+/*!
+	\fn			uint32_t Timebase_dwfnCyclesToUs (uint32_t cycles)
+	\param		cycles	Number of core cycles to convert
+	\return		Returns the equivalent time in microseconds
+	\brief		Converts a cycle count to microseconds at the current core
+				clock, which is only right for an interval that did not span
+				a clock profile switch
+*/
+uint32_t Timebase_dwfnCyclesToUs (uint32_t cycles)
+{
+	return cycles / cyclesPerUs;
+}
+
+/*!
+	\fn			void Timebase_vfnClockChanged (uint32_t coreClock)
+	\param		coreClock	New core clock frequency in Hz
+	\brief		Recomputes the cycles to microseconds conversion factor after
+				a core clock change
+*/
+void Timebase_vfnClockChanged (uint32_t coreClock)
+{
+	cyclesPerUs = coreClock / US_PER_SECOND;
+	if (!cyclesPerUs)
+	{
+		cyclesPerUs = 1;
+	}
+}
+
+/*!
+	\fn			static void Timebase_vfnTick (void)
+	\brief		System tick callback, run from the PIT interrupt. Also
+				supervises the watchdog heartbeats.
+*/
+static void Timebase_vfnTick (void)
+{
+	tickMs += TIMEBASE_TICK_US / 1000u;
+	Watchdog_vfnTick ();
+}
+
+/*!
+	\fn			void Timebase_vfnStartTick (void)
+	\brief		Starts the system tick. The PIT driver must be initialized.
+*/
+void Timebase_vfnStartTick (void)
+{
+	PIT_vfnStart (ePIT_SYSTEM, TIMEBASE_TICK_US, Timebase_vfnTick);
+}
+
+/*!
+	\fn			uint32_t Timebase_dwfnGetMs (void)
+	\return		Returns the milliseconds elapsed since the system tick started,
+				with the resolution of the tick
+*/
+uint32_t Timebase_dwfnGetMs (void)
+{
+	return tickMs;
+}
+
+/*!
+	\fn			void SysTick_Handler (void)
+	\brief		SysTick wrap interrupt, extends the counter by one full period
+*/
+void SysTick_Handler (void)
+{
+	STACK_ISR_ENTER (eSTACK_ISR_TICK);
+	wrapCycles += CYCLES_PER_WRAP;
+	STACK_ISR_EXIT (eSTACK_ISR_TICK);
+}
+//------------------------------------------------------------------------------
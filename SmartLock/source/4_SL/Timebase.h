@@ -0,0 +1,48 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Timebase.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the free-running cycle counter built
+				on top of the SysTick timer
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_TIMEBASE_H_
+#define _4_SL_TIMEBASE_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		TIMEBASE_RELOAD
+	\brief		SysTick reload value, the full 24-bit range of the counter
+*/
+#define		TIMEBASE_RELOAD		0x00FFFFFFu
+
+/*!
+	\def		TIMEBASE_TICK_US
+	\brief		Period of the system tick, which wakes the main loop and
+				counts milliseconds independently of the clock profile
+*/
+#define		TIMEBASE_TICK_US	10000u
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Timebase_vfnInit (void);
+
+uint32_t Timebase_dwfnGetCycles (void);
+
+uint32_t Timebase_dwfnCyclesToUs (uint32_t cycles);
+
+void Timebase_vfnClockChanged (uint32_t coreClock);
+
+void Timebase_vfnStartTick (void);
+
+uint32_t Timebase_dwfnGetMs (void);
+
+#endif /* _4_SL_TIMEBASE_H_ */
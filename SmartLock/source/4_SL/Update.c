@@ -0,0 +1,600 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Update.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the firmware updater.
+
+				The delta is a byte stream of operations against the running
+				image (the base):
+					0x00-0x7F	literal, the next op + 1 bytes are output
+					0x80-0xFF	copy of (op & 0x7F) + UPDATE_MIN_COPY bytes
+								from the base, followed by a zigzag varint:
+								source offset minus the output position
+				Commands, numbers in hex:
+					$UPB size crc basesize basecrc	begin, checks the base
+					$UPD seq data					up to 16 delta bytes
+					$UPG data						up to 16 bytes of the
+													signature
+					$UPE							end, checks the image
+													and its signature
+					$UPS							status
+					$UPR							reset into the bootloader
+				Every $UPD is acknowledged with its sequence number; a
+				repeated number is acknowledged again without decoding it, so
+				the sender simply resends on a lost reply.
+
+				The signature is made with the vendor's Ed25519 key over the
+				SHA-256 digest of the whole new image. The bootloader only
+				checks the CRC-32 again: it has no room for Ed25519 in its
+				4 KB, and it only ever swaps in an image whose swap this
+				check requested. All commands but $UPS need an authorized
+				link.
+*/
+//------------------------------------------------------------------------------
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "ClockProfile.h"
+#include "CRC.h"
+#include "Ed25519.h"
+#include "Flash.h"
+#include "Hash.h"
+#include "Protocol.h"
+#include "Swap.h"
+#include "Update.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		UPDATE_CHUNK
+	\brief		Most delta bytes in one $UPD line
+*/
+#define		UPDATE_CHUNK		16u
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		UPDATE_DECODER
+	\brief		What the next delta byte is
+*/
+typedef enum
+{
+	eDECODE_OP,
+	eDECODE_LITERAL,
+	eDECODE_OFFSET
+} UPDATE_DECODER;
+
+/*!
+	\enum		UPDATE_ERROR
+	\brief		Why the running update was dropped
+*/
+typedef enum
+{
+	eUPDATE_OK,
+	eUPDATE_BUSY,
+	eUPDATE_SIZE,
+	eUPDATE_BASE,
+	eUPDATE_SEQUENCE,
+	eUPDATE_FORMAT,
+	eUPDATE_FLASH,
+	eUPDATE_IMAGE,
+	eUPDATE_SIGNATURE
+} UPDATE_ERROR;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		UPDATE_SESSION
+	\brief		Image being rebuilt
+*/
+typedef struct
+{
+	uint8_t active;
+	uint8_t error;
+	uint16_t sequence;
+	uint32_t size;
+	uint32_t crc;
+	uint32_t baseSize;
+	uint32_t position;
+	uint8_t decoder;
+	uint8_t shift;
+	uint16_t remaining;
+	uint32_t offset;
+	uint8_t stage[FLASH_PHRASE];
+	uint8_t signatureLength;
+	uint8_t signature[ED25519_SIGNATURE];
+} UPDATE_SESSION;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		session
+	\brief		The running update
+*/
+static UPDATE_SESSION session = {0};
+
+/*!
+	\var		errorNames
+	\brief		Reply text of every UPDATE_ERROR
+*/
+static const char * const errorNames[] =
+{
+	"ok", "busy", "size", "base", "seq", "format", "flash", "image", "sig"
+};
+
+/*!
+	\var		updateKey
+	\brief		Key the images are signed with
+*/
+static const uint8_t updateKey[ED25519_KEY] = UPDATE_KEY;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Update_vfnBegin (const char *args);
+static void Update_vfnData (const char *args);
+static void Update_vfnSignature (const char *args);
+static void Update_vfnEnd (const char *args);
+static void Update_vfnStatus (const char *args);
+static void Update_vfnReset (const char *args);
+static UPDATE_ERROR Update_efnDecode (uint8_t value);
+static UPDATE_ERROR Update_efnOutput (uint8_t value);
+static void Update_vfnFail (const char *command, UPDATE_ERROR error);
+static uint8_t Update_bfnHex (const char **text, uint32_t *value);
+static uint8_t Update_bfnHexByte (const char *text, uint8_t *value);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Update_vfnInit (void)
+	\brief		Keeps the running image, which the bootloader would otherwise
+				swap back on the next reset, and registers the update commands
+*/
+void Update_vfnInit (void)
+{
+	Swap_bfnConfirm ();
+
+	Protocol_bfnRegister ("UPB", Update_vfnBegin);
+	Protocol_bfnRegister ("UPD", Update_vfnData);
+	Protocol_bfnRegister ("UPG", Update_vfnSignature);
+	Protocol_bfnRegister ("UPE", Update_vfnEnd);
+	Protocol_bfnRegister ("UPS", Update_vfnStatus);
+	Protocol_bfnRegister ("UPR", Update_vfnReset);
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Update_vfnBegin (const char *args)
+	\brief		"$UPB size crc basesize basecrc": starts an update. The base
+				CRC makes sure the delta was made against the running image.
+*/
+static void Update_vfnBegin (const char *args)
+{
+	uint32_t size;
+	uint32_t crc;
+	uint32_t baseSize;
+	uint32_t baseCrc;
+
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("UPB ERR auth");
+		return;
+	}
+	session.active = 0;
+	if (!Update_bfnHex (&args, &size) || !Update_bfnHex (&args, &crc) ||
+			!Update_bfnHex (&args, &baseSize) || !Update_bfnHex (&args, &baseCrc))
+	{
+		Update_vfnFail ("UPB", eUPDATE_FORMAT);
+		return;
+	}
+	if (Swap_efnGetState () != eSWAP_IDLE)
+	{
+		Update_vfnFail ("UPB", eUPDATE_BUSY);
+		return;
+	}
+	if ((size == 0) || (size > SWAP_SLOT_SIZE) || (baseSize > SWAP_SLOT_SIZE))
+	{
+		Update_vfnFail ("UPB", eUPDATE_SIZE);
+		return;
+	}
+	if (CRC_dwfnCompute (eCRC32, Flash_pbfnRead (SWAP_PRIMARY), baseSize) != baseCrc)
+	{
+		Update_vfnFail ("UPB", eUPDATE_BASE);
+		return;
+	}
+
+	session.active = 1;
+	session.error = eUPDATE_OK;
+	session.sequence = 0;
+	session.size = size;
+	session.crc = crc;
+	session.baseSize = baseSize;
+	session.position = 0;
+	session.decoder = eDECODE_OP;
+	session.signatureLength = 0;
+	Protocol_vfnReply ("UPB OK");
+}
+
+/*!
+	\fn			static void Update_vfnData (const char *args)
+	\brief		"$UPD seq hexdata": decodes the next delta bytes. seq counts
+				from 0; the previous number is acknowledged again.
+*/
+static void Update_vfnData (const char *args)
+{
+	uint32_t sequence;
+	uint8_t value;
+	uint8_t count = 0;
+	UPDATE_ERROR error = eUPDATE_OK;
+
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("UPD ERR auth");
+		return;
+	}
+	if (!session.active)
+	{
+		Protocol_vfnReply ("UPD ERR idle");
+		return;
+	}
+	if (!Update_bfnHex (&args, &sequence))
+	{
+		Update_vfnFail ("UPD", eUPDATE_FORMAT);
+		return;
+	}
+	if ((uint16_t)(sequence + 1) == session.sequence)
+	{
+		Protocol_vfnReply ("UPD %x", sequence);
+		return;
+	}
+	if (sequence != session.sequence)
+	{
+		Update_vfnFail ("UPD", eUPDATE_SEQUENCE);
+		return;
+	}
+
+	for (; (error == eUPDATE_OK) && (args[0] != '\0'); args += 2)
+	{
+		if (!Update_bfnHexByte (args, &value) || (++count > UPDATE_CHUNK))
+		{
+			error = eUPDATE_FORMAT;
+		}
+		else
+		{
+			error = Update_efnDecode (value);
+		}
+	}
+
+	if (error != eUPDATE_OK)
+	{
+		Update_vfnFail ("UPD", error);
+		return;
+	}
+	session.sequence++;
+	Protocol_vfnReply ("UPD %x", sequence);
+}
+
+/*!
+	\fn			static void Update_vfnSignature (const char *args)
+	\brief		"$UPG hexdata": appends to the signature of the image, at
+				most 16 bytes a line. Replies with the bytes received.
+*/
+static void Update_vfnSignature (const char *args)
+{
+	uint8_t value;
+	uint8_t count = 0;
+
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("UPG ERR auth");
+		return;
+	}
+	if (!session.active)
+	{
+		Protocol_vfnReply ("UPG ERR idle");
+		return;
+	}
+	for (; args[0] != '\0'; args += 2)
+	{
+		if (!Update_bfnHexByte (args, &value) || (++count > UPDATE_CHUNK) ||
+				(session.signatureLength >= ED25519_SIGNATURE))
+		{
+			Update_vfnFail ("UPG", eUPDATE_FORMAT);
+			return;
+		}
+		session.signature[session.signatureLength++] = value;
+	}
+	Protocol_vfnReply ("UPG %x", (uint32_t)session.signatureLength);
+}
+
+/*!
+	\fn			static void Update_vfnEnd (const char *args)
+	\brief		"$UPE": writes the last bytes, checks the rebuilt image and
+				its signature and asks the bootloader to swap it in
+*/
+static void Update_vfnEnd (const char *args)
+{
+	HASH_CONTEXT hash;
+	uint8_t digest[HASH_MAX_DIGEST];
+	uint8_t isSigned;
+
+	(void)args;
+
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("UPE ERR auth");
+		return;
+	}
+	if (!session.active)
+	{
+		Protocol_vfnReply ("UPE ERR idle");
+		return;
+	}
+	if ((session.decoder != eDECODE_OP) || (session.position != session.size))
+	{
+		Update_vfnFail ("UPE", eUPDATE_SIZE);
+		return;
+	}
+	while ((session.position % FLASH_PHRASE) != 0)
+	{
+		session.stage[session.position++ % FLASH_PHRASE] = 0xFF;
+		if ((session.position % FLASH_PHRASE) == 0)
+		{
+			if (!Flash_bfnProgram (SWAP_SECONDARY + session.position - FLASH_PHRASE, session.stage, FLASH_PHRASE))
+			{
+				Update_vfnFail ("UPE", eUPDATE_FLASH);
+				return;
+			}
+		}
+	}
+	if (CRC_dwfnCompute (eCRC32, Flash_pbfnRead (SWAP_SECONDARY), session.size) != session.crc)
+	{
+		Update_vfnFail ("UPE", eUPDATE_IMAGE);
+		return;
+	}
+	if (session.signatureLength != ED25519_SIGNATURE)
+	{
+		Update_vfnFail ("UPE", eUPDATE_SIGNATURE);
+		return;
+	}
+	ClockProfile_vfnRequest (eCLOCK_PROFILE_RUN_48M);
+	ClockProfile_vfnTask ();
+	Hash_vfnStart (&hash, eHASH_SHA256);
+	Hash_vfnUpdate (&hash, Flash_pbfnRead (SWAP_SECONDARY), session.size);
+	Hash_vfnFinish (&hash, digest);
+	isSigned = Ed25519_bfnVerify (session.signature, updateKey, digest, HASH_MAX_DIGEST);
+	ClockProfile_vfnRelease (eCLOCK_PROFILE_RUN_48M);
+	if (!isSigned)
+	{
+		Update_vfnFail ("UPE", eUPDATE_SIGNATURE);
+		return;
+	}
+	if (!Swap_bfnRequest (session.size, session.crc))
+	{
+		Update_vfnFail ("UPE", eUPDATE_FLASH);
+		return;
+	}
+	session.active = 0;
+	Protocol_vfnReply ("UPE OK");
+}
+
+/*!
+	\fn			static void Update_vfnStatus (const char *args)
+	\brief		"$UPS": slot state, progress and the last error
+*/
+static void Update_vfnStatus (const char *args)
+{
+	(void)args;
+	Protocol_vfnReply ("UPS swap=%u active=%u pos=%x size=%x seq=%x err=%s",
+			(uint32_t)Swap_efnGetState (), (uint32_t)session.active, session.position,
+			session.size, (uint32_t)session.sequence, errorNames[session.error]);
+}
+
+/*!
+	\fn			static void Update_vfnReset (const char *args)
+	\brief		"$UPR": resets into the bootloader once the reply is out
+*/
+static void Update_vfnReset (const char *args)
+{
+	(void)args;
+	if (!Protocol_bfnIsAuthorized ())
+	{
+		Protocol_vfnReply ("UPR ERR auth");
+		return;
+	}
+	Protocol_vfnReply ("UPR");
+#ifndef HOST_SIMULATION
+	/* Let the reply leave the UART before the reset */
+	for (volatile uint32_t delay = 0; delay < 100000u; delay++)
+	{
+	}
+	NVIC_SystemReset ();
+#endif
+}
+
+/*!
+	\fn			static UPDATE_ERROR Update_efnDecode (uint8_t value)
+	\param		value	Next byte of the delta
+	\return		Returns eUPDATE_OK, or why the delta is refused
+*/
+static UPDATE_ERROR Update_efnDecode (uint8_t value)
+{
+	UPDATE_ERROR error = eUPDATE_OK;
+	uint32_t source;
+
+	switch (session.decoder)
+	{
+		case eDECODE_OP:
+			if (value < 0x80)
+			{
+				session.remaining = (uint16_t)(value + 1);
+				session.decoder = eDECODE_LITERAL;
+			}
+			else
+			{
+				session.remaining = (uint16_t)((value & 0x7F) + UPDATE_MIN_COPY);
+				session.offset = 0;
+				session.shift = 0;
+				session.decoder = eDECODE_OFFSET;
+			}
+			break;
+
+		case eDECODE_LITERAL:
+			error = Update_efnOutput (value);
+			if (--session.remaining == 0)
+			{
+				session.decoder = eDECODE_OP;
+			}
+			break;
+
+		case eDECODE_OFFSET:
+			if (session.shift > 28)
+			{
+				return eUPDATE_FORMAT;
+			}
+			session.offset |= (uint32_t)(value & 0x7F) << session.shift;
+			session.shift += 7;
+			if (value & 0x80)
+			{
+				break;
+			}
+			/* Zigzag: even values are forward, odd values backward */
+			source = session.position + ((session.offset >> 1) ^ (0u - (session.offset & 1)));
+			if ((source >= session.baseSize) || (session.remaining > (session.baseSize - source)))
+			{
+				return eUPDATE_FORMAT;
+			}
+			while ((error == eUPDATE_OK) && session.remaining)
+			{
+				error = Update_efnOutput (*Flash_pbfnRead (SWAP_PRIMARY + source++));
+				session.remaining--;
+			}
+			session.decoder = eDECODE_OP;
+			break;
+
+		default:
+			error = eUPDATE_FORMAT;
+			break;
+	}
+	return error;
+}
+
+/*!
+	\fn			static UPDATE_ERROR Update_efnOutput (uint8_t value)
+	\param		value	Next byte of the new image
+	\return		Returns eUPDATE_OK, or why the byte could not be written
+	\brief		Stages the byte and programs every full longword. A sector is
+				erased when its first byte arrives.
+*/
+static UPDATE_ERROR Update_efnOutput (uint8_t value)
+{
+	if (session.position >= session.size)
+	{
+		return eUPDATE_SIZE;
+	}
+	if (((session.position % FLASH_SECTOR) == 0) && !Flash_bfnErase (SWAP_SECONDARY + session.position))
+	{
+		return eUPDATE_FLASH;
+	}
+	session.stage[session.position++ % FLASH_PHRASE] = value;
+	if (((session.position % FLASH_PHRASE) == 0) &&
+			!Flash_bfnProgram (SWAP_SECONDARY + session.position - FLASH_PHRASE, session.stage, FLASH_PHRASE))
+	{
+		return eUPDATE_FLASH;
+	}
+	return eUPDATE_OK;
+}
+
+/*!
+	\fn			static void Update_vfnFail (const char *command, UPDATE_ERROR error)
+	\brief		Drops the running update and replies with the reason
+*/
+static void Update_vfnFail (const char *command, UPDATE_ERROR error)
+{
+	session.active = 0;
+	session.error = (uint8_t)error;
+	Protocol_vfnReply ("%s ERR %s", command, errorNames[error]);
+}
+
+/*!
+	\fn			static uint8_t Update_bfnHex (const char **text, uint32_t *value)
+	\param		text	Points past the number and its space on return
+	\return		Returns 1 if a hex number was read; else, returns 0
+*/
+static uint8_t Update_bfnHex (const char **text, uint32_t *value)
+{
+	const char *p = *text;
+	uint8_t digits = 0;
+
+	*value = 0;
+	for (;; p++, digits++)
+	{
+		if ((*p >= '0') && (*p <= '9'))
+		{
+			*value = (*value << 4) | (uint32_t)(*p - '0');
+		}
+		else if ((*p >= 'a') && (*p <= 'f'))
+		{
+			*value = (*value << 4) | (uint32_t)(*p - 'a' + 10);
+		}
+		else if ((*p >= 'A') && (*p <= 'F'))
+		{
+			*value = (*value << 4) | (uint32_t)(*p - 'A' + 10);
+		}
+		else
+		{
+			break;
+		}
+	}
+	if ((digits == 0) || (digits > 8))
+	{
+		return 0;
+	}
+	while (*p == ' ')
+	{
+		p++;
+	}
+	*text = p;
+	return 1;
+}
+
+/*!
+	\fn			static uint8_t Update_bfnHexByte (const char *text, uint8_t *value)
+	\param		text	Two hex digits
+	\return		Returns 1 if both were hex digits; else, returns 0
+*/
+static uint8_t Update_bfnHexByte (const char *text, uint8_t *value)
+{
+	uint8_t digit;
+
+	*value = 0;
+	for (digit = 0; digit < 2; digit++, text++)
+	{
+		*value = (uint8_t)(*value << 4);
+		if ((*text >= '0') && (*text <= '9'))
+		{
+			*value |= (uint8_t)(*text - '0');
+		}
+		else if ((*text >= 'a') && (*text <= 'f'))
+		{
+			*value |= (uint8_t)(*text - 'a' + 10);
+		}
+		else if ((*text >= 'A') && (*text <= 'F'))
+		{
+			*value |= (uint8_t)(*text - 'A' + 10);
+		}
+		else
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
@@ -0,0 +1,62 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Update.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the firmware updater. A new image is
+				sent over the management protocol as a delta against the
+				running image, rebuilt into the secondary slot while it
+				arrives and started by the bootloader on the next reset.
+				Only an image signed with the vendor's key is handed to the
+				bootloader, and only an authorized link may send one.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_UPDATE_H_
+#define _4_SL_UPDATE_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		FOTA_ENABLE
+	\brief		Registers the update commands. The application must then be
+				linked at SWAP_PRIMARY and booted by the swap bootloader.
+*/
+#ifndef HOST_SIMULATION
+//	#define FOTA_ENABLE
+#endif
+
+/*!
+	\def		UPDATE_MIN_COPY
+	\brief		Shortest copy of a delta; shorter matches are sent as literals
+*/
+#define		UPDATE_MIN_COPY		4u
+
+/*!
+	\def		UPDATE_KEY
+	\brief		Ed25519 public key of the vendor; an image must carry its
+				signature over the SHA-256 digest of the image. A release
+				build defines its own, FOTA_ENABLE insists on it. The default
+				is the development key of Tools/Fota (seed byte i is
+				i * 29 + 3), which anybody can sign with.
+*/
+#ifndef UPDATE_KEY
+	#ifdef FOTA_ENABLE
+		#error "FOTA_ENABLE needs UPDATE_KEY, the public key of the vendor"
+	#endif
+	#define		UPDATE_KEY		{0xd6, 0x85, 0x02, 0x6f, 0xc7, 0x11, 0x77, 0xfb, \
+								 0x49, 0x45, 0xd1, 0x0d, 0x81, 0xbe, 0x65, 0x70, \
+								 0x4c, 0x47, 0xd5, 0x3c, 0xff, 0x34, 0x01, 0x4e, \
+								 0x04, 0x9c, 0x3b, 0x71, 0x4c, 0xac, 0xb2, 0x49}
+#endif
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Update_vfnInit (void);
+
+#endif /* _4_SL_UPDATE_H_ */
@@ -0,0 +1,260 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Watchdog.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the watchdog service. A heartbeat
+				is two stores, the tick of the check-in and the armed flag,
+				so it is cheap and safe from any interrupt. A task is only
+				supervised from its first heartbeat on, so a peripheral that
+				never started cannot keep the board in a reset loop.
+
+				The system tick does the supervision. A task stuck with the
+				interrupts on is caught there within its deadline; a hang
+				with the interrupts off stops the refreshes too, and the COP
+				resets the board after COP_TIMEOUT_MS.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "MKL27Z644.h"
+#include "Crash.h"
+#include "Protocol.h"
+#include "Timebase.h"
+#include "Watchdog.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		COP_TIMEOUT_MS
+	\brief		COP timeout: 2^10 cycles of the 1 kHz LPO
+*/
+#define		COP_TIMEOUT_MS		1024u
+
+/*!
+	\def		COP_CONFIG
+	\brief		LPO clock, longest normal timeout, stopped in stop modes and
+				while debugging. The swap bootloader writes the same value.
+*/
+#define		COP_CONFIG			(SIM_COPC_COPCLKSEL (0) | SIM_COPC_COPT (3))
+
+/*!
+	\def		TICK_MS
+	\brief		Period of the supervision
+*/
+#define		TICK_MS				(TIMEBASE_TICK_US / 1000u)
+
+/*!
+	\def		NO_TASK
+	\brief		Retained value when no heartbeat was missed
+*/
+#define		NO_TASK				0u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		ticks
+	\brief		Supervision ticks since boot
+*/
+static volatile uint16_t ticks = 0;
+
+/*!
+	\var		kicks
+	\brief		Tick of the last heartbeat of every task
+*/
+static volatile uint16_t kicks[eWATCHDOG_TASKS] = {0};
+
+/*!
+	\var		isArmed
+	\brief		Set by the first heartbeat of a task, cleared on suspend
+*/
+static volatile uint8_t isArmed[eWATCHDOG_TASKS] = {0};
+
+/*!
+	\var		deadlines
+	\brief		Ticks a task may go without a heartbeat, 0 if unregistered
+*/
+static uint16_t deadlines[eWATCHDOG_TASKS] = {0};
+
+/*!
+	\var		worstAges
+	\brief		Longest gap between two heartbeats, in ticks
+*/
+static uint16_t worstAges[eWATCHDOG_TASKS] = {0};
+
+/*!
+	\var		misses
+	\brief		Missed deadlines since boot; only grows without WATCHDOG_ENABLE
+*/
+static uint32_t misses = 0;
+
+/*!
+	\var		lastMissed
+	\brief		Task that missed before the last reset, as WATCHDOG_TASK + 1
+*/
+static uint8_t lastMissed = NO_TASK;
+
+/*!
+	\var		isCopRunning
+	\brief		Set if the COP runs, configured by this boot or by the
+				bootloader
+*/
+static uint8_t isCopRunning = 0;
+
+/*!
+	\var		taskNames
+	\brief		Reply names of the tasks
+*/
+static const char * const taskNames[eWATCHDOG_TASKS] = {"main", "keypad", "supply"};
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Watchdog_vfnReport (const char *args);
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Watchdog_vfnInit (void)
+	\brief		Takes the task that missed before the reset, starts the COP
+				and registers "$WDOG". Needs Crash_vfnInit first.
+*/
+void Watchdog_vfnInit (void)
+{
+	Crash_bfnRecall (eCRASH_RETAIN_WATCHDOG, &lastMissed);
+	Crash_vfnRetain (eCRASH_RETAIN_WATCHDOG, NO_TASK);
+
+#if defined(WATCHDOG_ENABLE) && !defined(HOST_SIMULATION)
+	/* COPC takes a single write after reset: after the bootloader's this one
+	 * is ignored, and after SystemInit's with DISABLE_WDOG set it stays off */
+	SIM->COPC = COP_CONFIG;
+	isCopRunning = ((SIM->COPC & SIM_COPC_COPT_MASK) != 0u);
+	SIM->SRVCOP = 0x55u;
+	SIM->SRVCOP = 0xAAu;
+#endif
+
+	Protocol_bfnRegister ("WDOG", Watchdog_vfnReport);
+}
+
+/*!
+	\fn			void Watchdog_vfnRegister (WATCHDOG_TASK task, uint16_t deadlineMs)
+	\param		task		Task to supervise
+	\param		deadlineMs	Longest time allowed between two heartbeats
+	\brief		Supervision starts with the first heartbeat of the task
+*/
+void Watchdog_vfnRegister (WATCHDOG_TASK task, uint16_t deadlineMs)
+{
+	if (task < eWATCHDOG_TASKS)
+	{
+		deadlines[task] = (uint16_t)((deadlineMs + TICK_MS - 1u) / TICK_MS);
+	}
+}
+
+/*!
+	\fn			void Watchdog_vfnKick (WATCHDOG_TASK task)
+	\param		task	Task checking in
+	\brief		Heartbeat. Meant for hot paths and interrupts: two stores.
+*/
+void Watchdog_vfnKick (WATCHDOG_TASK task)
+{
+	kicks[task] = ticks;
+	isArmed[task] = 1;
+}
+
+/*!
+	\fn			void Watchdog_vfnSuspend (WATCHDOG_TASK task)
+	\param		task	Task that stops on purpose
+	\brief		Stops supervising a task until its next heartbeat
+*/
+void Watchdog_vfnSuspend (WATCHDOG_TASK task)
+{
+	isArmed[task] = 0;
+}
+
+/*!
+	\fn			void Watchdog_vfnTick (void)
+	\brief		Called from the system tick. Refreshes the COP if every armed
+				task is within its deadline; else, records the first late
+				task and, with WATCHDOG_ENABLE, resets right away instead of
+				waiting for the COP.
+*/
+void Watchdog_vfnTick (void)
+{
+	uint8_t task = 0;
+	uint16_t age = 0;
+	uint8_t late = NO_TASK;
+
+	ticks++;
+	for (task = 0; task < eWATCHDOG_TASKS; task++)
+	{
+		if (!isArmed[task] || !deadlines[task])
+		{
+			continue;
+		}
+		age = (uint16_t)(ticks - kicks[task]);
+		if (age > worstAges[task])
+		{
+			worstAges[task] = age;
+		}
+		if ((age > deadlines[task]) && (late == NO_TASK))
+		{
+			late = (uint8_t)(task + 1u);
+		}
+	}
+
+	if (late == NO_TASK)
+	{
+#ifndef HOST_SIMULATION
+		if (isCopRunning)
+		{
+			SIM->SRVCOP = 0x55u;
+			SIM->SRVCOP = 0xAAu;
+		}
+#endif
+		return;
+	}
+
+	misses++;
+	lastMissed = late;
+	/* Restart the count, so a miss is reported once per deadline */
+	kicks[late - 1u] = ticks;
+	Crash_vfnTrace (eCRASH_EVENT_WATCHDOG, (uint8_t)(late - 1u));
+#if defined(WATCHDOG_ENABLE) && !defined(HOST_SIMULATION)
+	Crash_vfnRetain (eCRASH_RETAIN_WATCHDOG, late);
+	NVIC_SystemReset ();
+#endif
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Watchdog_vfnReport (const char *args)
+	\brief		"$WDOG": COP state, misses, the task that missed last, which
+				may be from before the reset, and the longest heartbeat gap
+				of every task in ms
+*/
+static void Watchdog_vfnReport (const char *args)
+{
+	const char *last = "none";
+
+	(void)args;
+	if (lastMissed != NO_TASK)
+	{
+		last = taskNames[lastMissed - 1u];
+	}
+#ifndef HOST_SIMULATION
+	else if (Crash_wfnGetResetCause () & RCM_SRS0_WDOG_MASK)
+	{
+		/* The COP expired: the interrupts were off too long */
+		last = "cop";
+	}
+#endif
+	Protocol_vfnReply ("WDOG cop=%u miss=%u last=%s", (uint32_t)isCopRunning, misses, last);
+	Protocol_vfnReply ("WDOG gap %s=%u %s=%u %s=%u",
+			taskNames[eWATCHDOG_MAIN], (uint32_t)worstAges[eWATCHDOG_MAIN] * TICK_MS,
+			taskNames[eWATCHDOG_KEYPAD], (uint32_t)worstAges[eWATCHDOG_KEYPAD] * TICK_MS,
+			taskNames[eWATCHDOG_SUPPLY], (uint32_t)worstAges[eWATCHDOG_SUPPLY] * TICK_MS);
+}
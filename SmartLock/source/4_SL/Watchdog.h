@@ -0,0 +1,63 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Watchdog.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the watchdog service. Every supervised
+				task, a main loop pass or an interrupt chain, checks in with a
+				heartbeat; the system tick refreshes the COP only while every
+				task checked in within its deadline, and resets the board as
+				soon as one did not, recording which.
+*/
+//------------------------------------------------------------------------------
+#ifndef _4_SL_WATCHDOG_H_
+#define _4_SL_WATCHDOG_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		WATCHDOG_ENABLE
+	\brief		Starts the COP and resets on a missed heartbeat; without it
+				misses are only counted and reported. COPC takes a single
+				write after reset, so the project defines DISABLE_WDOG=0 for
+				SystemInit to leave it alone; under the swap bootloader the
+				bootloader makes that write, and the one here is ignored.
+*/
+#ifndef HOST_SIMULATION
+	#define WATCHDOG_ENABLE
+#endif
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		WATCHDOG_TASK
+	\brief		Supervised tasks
+*/
+typedef enum
+{
+	eWATCHDOG_MAIN,		/* a pass of the main loop */
+	eWATCHDOG_KEYPAD,	/* the keypad scan tick */
+	eWATCHDOG_SUPPLY,	/* the ADC blocks of the supply monitor */
+	eWATCHDOG_TASKS
+} WATCHDOG_TASK;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Watchdog_vfnInit (void);
+
+void Watchdog_vfnRegister (WATCHDOG_TASK task, uint16_t deadlineMs);
+
+void Watchdog_vfnKick (WATCHDOG_TASK task);
+
+void Watchdog_vfnSuspend (WATCHDOG_TASK task);
+
+void Watchdog_vfnTick (void);
+
+#endif /* _4_SL_WATCHDOG_H_ */
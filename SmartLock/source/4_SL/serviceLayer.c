@@ -12,21 +12,60 @@ typedef unsigned long uint32_t;
 //------------------------------------------------------------------------------
 #include "serviceLayer.h"
 
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+    \def		DELAY_REFERENCE_MHZ
+    \brief		Core clock, in MHz, the delay counts were calibrated with
+*/
+#define		DELAY_REFERENCE_MHZ		8
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+    \var		coreMhz
+    \brief		Current core clock in MHz, used to keep the delays constant
+    			in time across clock profile switches
+*/
+static uint32_t coreMhz = DELAY_REFERENCE_MHZ;
+
 //--------------------------------------------------------------------------
 // Functions
 //--------------------------------------------------------------------------
 /*!
     \fn			void delay (uint32_t count)
-    \param		count	Number to which the KL27z board will count from
-    \brief		Function with a blocking loop to delay any process n seconds
+    \param		count	Number to which the KL27z board will count from at 8 MHz
+    \brief		Function with a blocking loop to delay any process n seconds.
+    			The count is scaled to the current core clock.
 */
 void delay (uint32_t count)
 {
+	if (coreMhz != DELAY_REFERENCE_MHZ)
+	{
+		count = (count / DELAY_REFERENCE_MHZ) * coreMhz;
+	}
+
 	while(count--)
 	{
 		__asm volatile("nop");
 	}
 }
+
+/*!
+    \fn			void Delay_vfnClockChanged (uint32_t coreClock)
+    \param		coreClock	New core clock frequency in Hz
+    \brief		Updates the core clock used to scale the delay counts
+*/
+void Delay_vfnClockChanged (uint32_t coreClock)
+{
+	coreMhz = coreClock / 1000000u;
+	if (!coreMhz)
+	{
+		coreMhz = 1;
+	}
+}
 //------------------------------------------------------------------------------
 
 
@@ -12,4 +12,6 @@
 //--------------------------------------------------------------------------
 void delay (uint32_t count);
 
+void Delay_vfnClockChanged (uint32_t coreClock);
+
 #endif /* 4_SL_SERVICELAYER_H_ */
@@ -238,21 +238,44 @@ void (* const g_pfnVectors[])(void) = {
 // are written as separate functions rather than being inlined within the
 // ResetISR() function in order to cope with MCUs with multiple banks of
 // memory.
+// Both move four words per iteration so the compiler can emit LDM/STM pairs
+// instead of one load/store and a compare per word; the remaining words of
+// a section that is not a multiple of 16 bytes are handled one at a time.
 //*****************************************************************************
 __attribute__ ((section(".after_vectors.init_data")))
 void data_init(unsigned int romstart, unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
     unsigned int *pulSrc = (unsigned int*) romstart;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int *pulEnd = (unsigned int*) (start + len);
+    unsigned int ul0, ul1, ul2, ul3;
+    while ((unsigned int)(pulEnd - pulDest) >= 4) {
+        ul0 = pulSrc[0];
+        ul1 = pulSrc[1];
+        ul2 = pulSrc[2];
+        ul3 = pulSrc[3];
+        pulDest[0] = ul0;
+        pulDest[1] = ul1;
+        pulDest[2] = ul2;
+        pulDest[3] = ul3;
+        pulSrc += 4;
+        pulDest += 4;
+    }
+    while (pulDest < pulEnd)
         *pulDest++ = *pulSrc++;
 }
 
 __attribute__ ((section(".after_vectors.init_bss")))
 void bss_init(unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int *pulEnd = (unsigned int*) (start + len);
+    while ((unsigned int)(pulEnd - pulDest) >= 4) {
+        pulDest[0] = 0;
+        pulDest[1] = 0;
+        pulDest[2] = 0;
+        pulDest[3] = 0;
+        pulDest += 4;
+    }
+    while (pulDest < pulEnd)
         *pulDest++ = 0;
 }
 
@@ -279,6 +302,13 @@ void ResetISR(void) {
     // Disable interrupts
     __asm volatile ("cpsid i");
 
+    // Start SysTick free-running over its full 24-bit range from the core
+    // clock, so the boot timeline (Timebase/Boot) is measured from reset.
+    // The wrap interrupt is only enabled later by Timebase_vfnInit().
+    *((volatile unsigned int *)0xE000E014) = 0x00FFFFFFu;  // SYST_RVR
+    *((volatile unsigned int *)0xE000E018) = 0x00u;        // SYST_CVR
+    *((volatile unsigned int *)0xE000E010) = 0x05u;        // SYST_CSR: CLKSOURCE | ENABLE
+
 
 #if defined (__USE_CMSIS)
 // If __USE_CMSIS defined, then call CMSIS SystemInit code
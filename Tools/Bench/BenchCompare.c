@@ -0,0 +1,209 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		BenchCompare.c
+	\brief		Compares a benchmark report against a baseline report, both in
+				the CSV format printed by Bench_vfnRun:
+
+					bench,iterations,total_<unit>,<unit>_per_op
+
+				usage:	bench-compare [--tolerance <percent>] [--floor <ticks>]
+							[--informational] <baseline.csv> <report.csv>
+
+				A case regresses when its cost per operation grew by more than
+				the tolerance and by more than the floor, which keeps sub-tick
+				noise on the cheapest cases from failing the check. Missing
+				cases and reports in different units are errors. Exits with 1
+				on any regression or error; with --informational regressions
+				are only listed, for timings that do not repeat, such as host
+				wall-clock nanoseconds.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_CASES
+	\brief		Cases a report may hold
+*/
+#define		MAX_CASES			64
+
+/*!
+	\def		NAME_LENGTH
+	\brief		Longest case or unit name
+*/
+#define		NAME_LENGTH			48
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		REPORT
+	\brief		Cost per operation of every case of a report
+*/
+typedef struct
+{
+	char unit[NAME_LENGTH];
+	char names[MAX_CASES][NAME_LENGTH];
+	double perOp[MAX_CASES];
+	int count;
+} REPORT;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static int ifnLoad (const char *path, REPORT *report)
+	\return		Returns 0 when the file was read; else, returns -1
+	\brief		Reads a report. Lines before the header (boot messages on the
+				target console) and the throughput comment lines are skipped.
+*/
+static int ifnLoad (const char *path, REPORT *report)
+{
+	FILE *file = fopen (path, "r");
+	char line[256];
+	char *field;
+	int inReport = 0;
+
+	memset (report, 0, sizeof (*report));
+	if (file == NULL)
+	{
+		fprintf (stderr, "%s: cannot open\n", path);
+		return -1;
+	}
+	while (fgets (line, sizeof (line), file) != NULL)
+	{
+		line[strcspn (line, "\r\n")] = '\0';
+		if (!strncmp (line, "bench,iterations,total_", 23))
+		{
+			field = line + 23;
+			field[strcspn (field, ",")] = '\0';
+			snprintf (report->unit, sizeof (report->unit), "%.47s", field);
+			inReport = 1;
+			continue;
+		}
+		if (!inReport || !line[0] || (report->count >= MAX_CASES))
+		{
+			continue;
+		}
+		// name,iterations,total,per_op
+		field = strrchr (line, ',');
+		if ((field == NULL) || (strchr (line, ',') == field))
+		{
+			continue;
+		}
+		report->perOp[report->count] = strtod (field + 1, NULL);
+		line[strcspn (line, ",")] = '\0';
+		snprintf (report->names[report->count], NAME_LENGTH, "%.47s", line);
+		report->count++;
+	}
+	fclose (file);
+
+	if (!inReport)
+	{
+		fprintf (stderr, "%s: no benchmark report found\n", path);
+		return -1;
+	}
+	return 0;
+}
+
+/*!
+	\fn			int main (int argc, char **argv)
+	\return		Returns 0 when no case regressed, or if only informational;
+				else, returns 1
+*/
+int main (int argc, char **argv)
+{
+	static REPORT baseline;
+	static REPORT current;
+	double tolerance = 10.0;
+	double floor = 0.0;
+	double delta;
+	int argi = 1;
+	int i;
+	int j;
+	int failed = 0;
+	int regressed = 0;
+	int isInformational = 0;
+
+	for (; (argi < argc) && !strncmp (argv[argi], "--", 2); argi++)
+	{
+		if (!strcmp (argv[argi], "--tolerance") && (argi + 1 < argc))
+		{
+			tolerance = strtod (argv[++argi], NULL);
+		}
+		else if (!strcmp (argv[argi], "--floor") && (argi + 1 < argc))
+		{
+			floor = strtod (argv[++argi], NULL);
+		}
+		else if (!strcmp (argv[argi], "--informational"))
+		{
+			isInformational = 1;
+		}
+		else
+		{
+			fprintf (stderr, "unknown option %s\n", argv[argi]);
+			return 1;
+		}
+	}
+	if ((argc - argi != 2) || ifnLoad (argv[argi], &baseline)
+			|| ifnLoad (argv[argi + 1], &current))
+	{
+		fprintf (stderr, "usage: bench-compare [--tolerance <percent>] [--floor <ticks>] [--informational] <baseline.csv> <report.csv>\n");
+		return 1;
+	}
+	if (strcmp (baseline.unit, current.unit))
+	{
+		fprintf (stderr, "baseline is in %s, report is in %s\n", baseline.unit, current.unit);
+		return 1;
+	}
+
+	printf ("bench,baseline_%s,current_%s,change_percent,status\n", baseline.unit, current.unit);
+	for (i = 0; i < baseline.count; i++)
+	{
+		for (j = 0; (j < current.count) && strcmp (baseline.names[i], current.names[j]); j++)
+		{
+		}
+		if (j == current.count)
+		{
+			printf ("%s,%.2f,,,missing\n", baseline.names[i], baseline.perOp[i]);
+			failed = 1;
+			continue;
+		}
+		delta = current.perOp[j] - baseline.perOp[i];
+		printf ("%s,%.2f,%.2f,%+.1f,", baseline.names[i], baseline.perOp[i], current.perOp[j],
+				(baseline.perOp[i] > 0.0) ? (100.0 * delta / baseline.perOp[i]) : 0.0);
+		if ((delta > floor) && (delta > baseline.perOp[i] * tolerance / 100.0))
+		{
+			printf ("regressed\n");
+			regressed = 1;
+		}
+		else
+		{
+			printf ("ok\n");
+		}
+	}
+	for (j = 0; j < current.count; j++)
+	{
+		for (i = 0; (i < baseline.count) && strcmp (baseline.names[i], current.names[j]); i++)
+		{
+		}
+		if (i == baseline.count)
+		{
+			printf ("%s,,%.2f,,new\n", current.names[j], current.perOp[j]);
+		}
+	}
+
+	if (regressed && isInformational)
+	{
+		fprintf (stderr, "regressions listed for information only\n");
+		regressed = 0;
+	}
+	return failed || regressed;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,28 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		BenchHost.c
+	\brief		Host entry point of the benchmark build: runs the cases of
+				Benchmark.c on the simulated HAL and prints the CSV report
+				on stdout
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "SimHAL.h"
+#include "Benchmark.h"
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			int main (void)
+	\return		Returns 0
+*/
+int main (void)
+{
+	Sim_vfnReset ();
+	Benchmark_vfnRun ();
+
+	return 0;
+}
+//------------------------------------------------------------------------------
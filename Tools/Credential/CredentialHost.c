@@ -0,0 +1,440 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		CredentialHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the signed credentials. Hash.c and Ed25519.c
+				are checked against the vectors of FIPS 180 and RFC 8032;
+				then Credential.c and Protocol.c run unchanged while the
+				harness uploads an installer key and presents credentials:
+				valid, presented again, tampered, signed by someone else,
+				out of their window, for another door, and a fleet of them
+				through the cache. The uploads take their buffers from
+				Pool.c, which must have them all back after every test.
+
+				The credentials were signed ahead with the test installer's
+				seed (byte i is i * 37 + 11), so the harness needs no
+				signing code.
+
+				Usage:
+					credentialhost [--verbose]
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "RTC.h"
+#include "ClockProfile.h"
+#include "Hash.h"
+#include "Ed25519.h"
+#include "Credential.h"
+#include "Pool.h"
+#include "Protocol.h"
+#include "Timebase.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		FLEET
+	\brief		Credentials of the cache scenarios, more than the cache holds
+*/
+#define		FLEET				24
+
+/*!
+	\def		PRESENTATIONS
+	\brief		Presentations of the skewed workload
+*/
+#define		PRESENTATIONS		400
+
+/*!
+	\def		FAST_REQUESTS, FAST_RELEASES
+	\brief		Calls for the 48 MHz profile, one of each per signature check
+*/
+#define		FAST_REQUESTS		Host_adwClockRequests[eCLOCK_PROFILE_RUN_48M]
+#define		FAST_RELEASES		Host_adwClockReleases[eCLOCK_PROFILE_RUN_48M]
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+static uint32_t grants = 0;
+
+/*!
+	\var		issuer
+	\brief		Public key of the test installer
+*/
+static const char issuer[] = "24c3a494fa2299626644b965a9132da79cfe67151fdc42de600cf09097db8247";
+
+/*!
+	\var		valid
+	\brief		User 7, from 1000 to 2000, doors 0 and 2
+	\var		other
+	\brief		The same body signed by another key
+	\var		version
+	\brief		The same with version 2, signed by the installer
+*/
+static const char valid[] = "010007000003e8000007d000059935181be3dc406d85b8c0bccaf419493393e0de712507d8e010"
+		"b44d8397ecff111f58bb02d8543422aefdf0ee1b463c9a3f0962cf335b33c4b7fdcd15a4e60c";
+static const char other[] = "010007000003e8000007d00005397efe4d3b6523e2034de3da5910df8cf2e80537d9fadc21c24f"
+		"a3f93866dc063c61e257118fe00c98d60e24e91cfbc24366853b0bf1ea7436facff96aa83106";
+static const char version[] = "020007000003e8000007d00005bce87d9c910d6ae29ce71f0d73b04ca334beea8e127188d32581"
+		"b925e148c18b57bdaf28a446d9c0f6c722fcc58d17e661932ccbb4b242bb4aabaa0a448ec804";
+
+/*!
+	\var		fleet
+	\brief		Users 100 to 123, every door, valid forever
+*/
+static const char * const fleet[FLEET] = {
+		"01006400000000ffffffffffff6e1b385f84876bd6f612c93f0c53c30c0ddac0c95cc87ba409b2"
+		"4f90c2beb023619b840c1a5677ac48b7336dbb7506391ab7a3cb1eccadabbf1b15bc2e613108",
+		"01006500000000ffffffffffff33d08712833a84e90790ce690ab980569acfac157b847806058b"
+		"6f2d43d70d5c801f26bdcaf6328177edb4492a8e3ff376dc4d3c7e1803ab44220a5421776302",
+		"01006600000000ffffffffffff67523e6df4531bf0930f4f6b38c22f7c8812e6fb655784858bc3"
+		"5a049bc1311b1763bb49797ef4f6329b616b61225e13e1181248174a5d3838af9a5848ed1906",
+		"01006700000000ffffffffffff208af479f2b01ff53c177c64e998b971aeb986bc21b1e36a2605"
+		"3ead27bfef9aaeb2af36b602789427099618f76d3270660451ea9be367a515389cd9b77f8409",
+		"01006800000000ffffffffffff264d2cc1c55fb50bd644cf16d1e12f4fbfcab8150511524f03b9"
+		"11661f9eeffbcaea426c4d3e7ff5f1e6bc2b4a2aadb3620ba0e266af9dddfb1bb05886af940a",
+		"01006900000000ffffffffffff17243dacc333bbb10c8fb8061b64873e9373f05647e53451f436"
+		"11fcb3c453d81ef1201efc8e4c570caaacfaf459c8d86811d51bc29d04ba062b6e66d4f4ef00",
+		"01006a00000000ffffffffffff081be2382ade12625b0660920433b77f8b0f12a021b92e8f37bb"
+		"99cf1369b05e6d467cb78a91af809c96bab3c5fb274e71c7586660114b626b2d42745bceb607",
+		"01006b00000000ffffffffffffb7e24f19679b2351c08df019022c856e17f335fc3c4cb73c3da7"
+		"2ab3944d0691b2a3b5d84f1718f352b9d8135d045d1a0c6cca1955b6ebe8d8e8e818646ab606",
+		"01006c00000000ffffffffffffc767299edac8473ee40d074062f8650a0dffab271853e45c16cd"
+		"be90f7290cd5b5f29dc755b052b3dae0d50889d0c204f6dafb78d482e0a39d170ee6b199ac03",
+		"01006d00000000ffffffffffff6fe13e744c61e5c10cf82fb4a0d47eacc48b6b8a0d10e8426aea"
+		"05a158abc581e2752650d00a514b9f1eb4742881b05006094c95317358503b8bed0ea2078b0b",
+		"01006e00000000ffffffffffff0b6601a39e4543500862a3ca98fc51afdc12a190b8a23ae66787"
+		"3652bf1ca261e9dfea7f15f3deccdd155abfa768e0c59be21544fbaffbb6c2b4c55ae65a4409",
+		"01006f00000000ffffffffffff04d662fde89a665d9a4fb181f048c7309504c38503cdd7306132"
+		"b5d42097e309066a7f0d6b34608ac692991b91b8461605f4585f971e67cf35af4228881c400b",
+		"01007000000000ffffffffffffc1f47ac55b25721fc3bb1e5371881dbf4bb0ea0ff679a2745b8d"
+		"95744f5e438c3de1a4e3623222b0a201300db367ebfe0b54af5eac9de61c3318dd60218a000d",
+		"01007100000000ffffffffffff03f2d5412d598c0534713789f7c1e5d9e9a87ef090ba78a413b8"
+		"f492f2b701b39a87857aae38e914f277f8b44b14c4f00965738fc6526e72223ffe0b1087550f",
+		"01007200000000ffffffffffff6b418fa5583097926e24ef294944b2829eff320549f4154a36fc"
+		"a73481aa8af8c286567c0e04b5351a76ce02639b7ff9ea602a3aadfc135ad0ad343c3676e20d",
+		"01007300000000ffffffffffff37a8f1b01b9ab109f446d75be02f9c38b9175617c1831c5d8e68"
+		"0c0cb6bdc4c7ee6018dff6198af5ac40bb409a083c867cfe8e3a4c36402d6a54e35a700b1c07",
+		"01007400000000ffffffffffff7bab23f6f2b111caddc8b1f1d4c97715405199c2b92122ba8fdf"
+		"26326a0376d40ea39aac89d78a483e0ff88afc3dfff6113626495ccb8230495a5b66b8eb8e0a",
+		"01007500000000ffffffffffff81aef8c276a0430cb044b03f58dcaa790bea62f202b5aa38905b"
+		"26579c28cf1482cb35953e7b4e0e48b832588dc52431e446c74d835c332853c80be94dce4902",
+		"01007600000000ffffffffffffee6eb7e86a0cd82535456e535b33e9ea1d8ffe3b18c3f92018b7"
+		"8106ca7ccb3188dca743519abacbd5443f819e621311b0dab83141be6d6455e89cb28efe9c0c",
+		"01007700000000ffffffffffffe0cc9594b153f6be5c65ee0e14863a1c596078a0b76aa2d736f9"
+		"93b3a03f9ffddcbaf277beecdf2f1db21b4ba982209e25b621fd674f08b4dfbc782b95f45001",
+		"01007800000000ffffffffffff62205f1afb1271860cc34df3c98dd3cdada7f273c3b9d3c1cc20"
+		"961fa0fc5e7dfbfcf195c4bc9ebd6f27bf7e99e36a8c506e220aa366d723d3bb1da55f166d03",
+		"01007900000000ffffffffffff5a3f83eb867d6c9141394e5f1a7f4d1fb8b7c0301df86a32d6aa"
+		"add2f2ab897149b9b65026a52950b0be9efa931e3581144dbac33b3fb1e30cb47f2d5d336f00",
+		"01007a00000000ffffffffffffd14bd1be29503bf2fcfe1bc5fe7cc238b1a78bb554a974688841"
+		"0557f0e46a19d8c010c75f192b5c4488a87dfa19e6cca8f7b1a743897fc0e8612b7112d66e04",
+		"01007b00000000ffffffffffff3b91e8ed1fab717c38a58eab0886892803ac450b3a90976cb562"
+		"4b6ce5cd644aa78ca462053a13d87d12aa3f494615cb66a06d5851cae65dcecf3f64e973b801"
+};
+
+//------------------------------------------------------------------------------
+// Firmware stubs
+//------------------------------------------------------------------------------
+static void grant (void)
+{
+	grants++;
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static const char *upload (const char *prefix, const char *hex)
+	\return		Returns the reply to the last piece
+	\brief		Sends hex in pieces of 16 bytes after the prefix
+*/
+static const char *upload (const char *prefix, const char *hex)
+{
+	char line[64];
+	const char *reply = "";
+	size_t length = strlen (hex);
+	size_t done;
+
+	for (done = 0; done < length; done += 32)
+	{
+		snprintf (line, sizeof (line), "%s%.32s", prefix, hex + done);
+		reply = Host_pcfnCommand (line, 0);
+	}
+	return reply;
+}
+
+/*!
+	\fn			static void bytes (const char *hex, uint8_t *out)
+	\brief		Converts hex to bytes
+*/
+static void bytes (const char *hex, uint8_t *out)
+{
+	size_t i;
+
+	for (i = 0; hex[2 * i]; i++)
+	{
+		sscanf (&hex[2 * i], "%2hhx", &out[i]);
+	}
+}
+
+/*!
+	\fn			static CREDENTIAL_RESULT present (const char *hex, uint16_t *user)
+	\return		Returns what the lock decides on the credential
+*/
+static CREDENTIAL_RESULT present (const char *hex, uint16_t *user)
+{
+	uint8_t blob[CREDENTIAL_BLOB];
+
+	bytes (hex, blob);
+	return Credential_efnPresent (blob, user);
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testVectors (void)
+	\brief		SHA-512 of FIPS 180 and tests 1 to 3 of RFC 8032 section 7.1,
+				each also with a bit of the message, R, S and the key flipped
+				and with S + 16L, the same scalar out of range
+*/
+static void testVectors (void)
+{
+	static const struct
+	{
+		const char *key;
+		const char *message;
+		const char *signature;
+	} vectors[] = {
+		{"d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a", "",
+				"e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+				"5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b"},
+		{"3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c", "72",
+				"92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+				"085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00"},
+		{"fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025", "af82",
+				"6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+				"18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a"}
+	};
+	static const char abc[] = "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+			"2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f";
+	HASH_SHA512_CONTEXT context;
+	uint8_t digest[HASH_SHA512_DIGEST];
+	uint8_t expected[HASH_SHA512_DIGEST];
+	uint8_t key[ED25519_KEY];
+	uint8_t message[4];
+	uint8_t signature[ED25519_SIGNATURE];
+	uint16_t length;
+	size_t i;
+
+	Hash_vfnSha512Start (&context);
+	Hash_vfnSha512Update (&context, (const uint8_t *)"abc", 3);
+	Hash_vfnSha512Finish (&context, digest);
+	bytes (abc, expected);
+	CHECK (!memcmp (digest, expected, sizeof (digest)), "SHA-512 of abc");
+
+	for (i = 0; i < sizeof (vectors) / sizeof (vectors[0]); i++)
+	{
+		bytes (vectors[i].key, key);
+		bytes (vectors[i].message, message);
+		bytes (vectors[i].signature, signature);
+		length = (uint16_t)(strlen (vectors[i].message) / 2);
+		CHECK (Ed25519_bfnVerify (signature, key, message, length), "test %zu refused", i + 1);
+		if (length)
+		{
+			message[0] ^= 1;
+			CHECK (!Ed25519_bfnVerify (signature, key, message, length), "test %zu message", i + 1);
+			message[0] ^= 1;
+		}
+		signature[3] ^= 0x10;
+		CHECK (!Ed25519_bfnVerify (signature, key, message, length), "test %zu R", i + 1);
+		signature[3] ^= 0x10;
+		signature[40] ^= 0x01;
+		CHECK (!Ed25519_bfnVerify (signature, key, message, length), "test %zu S", i + 1);
+		signature[40] ^= 0x01;
+		key[9] ^= 0x04;
+		CHECK (!Ed25519_bfnVerify (signature, key, message, length), "test %zu key", i + 1);
+		key[9] ^= 0x04;
+		signature[63] = (uint8_t)(signature[63] + 0x10);
+		CHECK (!Ed25519_bfnVerify (signature, key, message, length), "test %zu S + 16L", i + 1);
+	}
+}
+
+/*!
+	\fn			static void testPresent (void)
+	\brief		The credential checks through the commands
+*/
+static void testPresent (void)
+{
+	char tampered[sizeof (valid)];
+	CREDENTIAL_STATS stats;
+	const char *reply;
+
+	reply = Host_pcfnCommand ("CRED", 0);
+	CHECK (!strcmp (reply, "CRED key=0 door=0 cached=0 max=16"), "status %s", reply);
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED ERR key"), "no key");
+
+	/* Fresh from a reset, not even the first key is taken unauthorized */
+	CHECK (!strcmp (upload ("CRED KEY ", issuer), "CRED ERR auth"), "first key");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED DOOR 1", 0), "CRED ERR auth"), "door changed");
+	reply = Host_pcfnCommand ("CRED", 0);
+	CHECK (!strcmp (reply, "CRED key=0 door=0 cached=0 max=16"), "status %s", reply);
+
+	/* The key arrives in two pieces; a partial one is dropped by CLR */
+	Protocol_vfnAuthorize ();
+	CHECK (!strcmp (upload ("CRED KEY ", issuer), "CRED KEY OK"), "key");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED KEY 00", 0), "CRED KEY 1"), "key piece");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED CLR", 0), "CRED OK"), "clear");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED 0g", 0), "CRED ERR format"), "not hex");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED 123", 0), "CRED ERR format"), "odd digits");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED DOOR 16", 0), "CRED ERR format"), "door 16");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED 0100", 0), "CRED 2"), "first piece");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED CLR", 0), "CRED OK"), "clear upload");
+
+	/* The signature is checked once; the window and door every time */
+	RTC_vfnSetTime (999);
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED ERR time"), "before");
+	CHECK ((FAST_REQUESTS == 1) && (FAST_RELEASES == 1), "48 MHz %u/%u", FAST_REQUESTS, FAST_RELEASES);
+	RTC_vfnSetTime (1000);
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED OK user=7"), "from");
+	CHECK (FAST_REQUESTS == 1, "verified again");
+	CHECK (grants == 1, "grants %u", grants);
+	RTC_vfnSetTime (1999);
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED OK user=7"), "until");
+	RTC_vfnSetTime (2000);
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED ERR time"), "after");
+	RTC_vfnSetTime (1500);
+	CHECK (!strcmp (Host_pcfnCommand ("CRED DOOR 1", 0), "CRED OK"), "door 1");
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED ERR door"), "door 1 refused");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED DOOR 2", 0), "CRED OK"), "door 2");
+	CHECK (!strcmp (upload ("CRED ", valid), "CRED OK user=7"), "door 2 opened");
+	CHECK (grants == 3, "grants %u", grants);
+
+	/* A changed body is another fingerprint: verified and refused */
+	memcpy (tampered, valid, sizeof (valid));
+	tampered[14] = '8';
+	CHECK (!strcmp (upload ("CRED ", tampered), "CRED ERR sig"), "window widened");
+	CHECK (!strcmp (upload ("CRED ", other), "CRED ERR sig"), "other key");
+	CHECK (!strcmp (upload ("CRED ", version), "CRED ERR format"), "version");
+	CHECK (!strcmp (upload ("CRED ", tampered), "CRED ERR sig"), "refused twice");
+	CHECK (FAST_REQUESTS == 4, "verified %u", FAST_REQUESTS);
+	reply = Host_pcfnCommand ("CRED", 0);
+	CHECK (!strcmp (reply, "CRED key=1 door=2 cached=1 max=16"), "status %s", reply);
+
+	Credential_vfnGetStats (&stats);
+	CHECK ((stats.presented == 11) && (stats.hits == 5) && (stats.verified == 1) && (stats.refused == 8),
+			"stats %u %u %u %u", stats.presented, stats.hits, stats.verified, stats.refused);
+	reply = Host_pcfnCommand ("CRED STATS", 0);
+	CHECK (!strcmp (reply, "CRED n=11 hits=5 verified=1 refused=8"), "stats %s", reply);
+
+	/* A new key drops what the old one signed */
+	CHECK (!strcmp (upload ("CRED KEY ", issuer), "CRED KEY OK"), "same key");
+	reply = Host_pcfnCommand ("CRED", 0);
+	CHECK (!strcmp (reply, "CRED key=1 door=2 cached=0 max=16"), "flushed %s", reply);
+}
+
+/*!
+	\fn			static void testPool (void)
+	\brief		Uploads while the pool is used up, and the blocks coming
+				back afterwards
+*/
+static void testPool (void)
+{
+	POOL_STATS small;
+	POOL_STATS large;
+	void *held[2];
+	const char *reply;
+
+	/* The credential needs a large block, the key takes the small one */
+	held[0] = Pool_pvfnAlloc (CREDENTIAL_BLOB);
+	held[1] = Pool_pvfnAlloc (CREDENTIAL_BLOB);
+	CHECK (held[0] && held[1] && (held[0] != held[1]), "two large blocks");
+	CHECK (!Pool_pvfnAlloc (CREDENTIAL_BLOB), "a third large block");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED 0100", 0), "CRED ERR busy"), "credential busy");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED KEY 00", 0), "CRED KEY 1"), "key in the small block");
+	CHECK (!Pool_pvfnAlloc (ED25519_KEY), "no block for a second key");
+	reply = Host_pcfnCommand ("POOL", 0);
+	CHECK (!strcmp (reply, "POOL 32 n=1 used=1 max=1 fail=1"), "pool %s", reply);
+
+	/* A freed block is taken again, and CLR returns the key's */
+	Pool_vfnFree (held[1]);
+	CHECK (!strcmp (Host_pcfnCommand ("CRED 0100", 0), "CRED 2"), "credential after a free");
+	CHECK (!strcmp (Host_pcfnCommand ("CRED CLR", 0), "CRED OK"), "clear");
+	Pool_vfnFree (held[0]);
+	Pool_vfnGetStats (ePOOL_SMALL, &small);
+	Pool_vfnGetStats (ePOOL_LARGE, &large);
+	CHECK (!small.inUse && !large.inUse, "blocks in use %u %u", (uint32_t)small.inUse, (uint32_t)large.inUse);
+	CHECK ((large.highWater == 2) && (large.failures == 2), "large max %u fail %u",
+			(uint32_t)large.highWater, large.failures);
+}
+
+/*!
+	\fn			static void testCache (void)
+	\brief		The fleet through the cache: a cycle longer than the cache
+				misses every time, a skewed workload mostly hits
+*/
+static void testCache (void)
+{
+	CREDENTIAL_STATS before;
+	CREDENTIAL_STATS after;
+	CREDENTIAL_RESULT result;
+	uint32_t seed = 1;
+	uint16_t user = 0;
+	int round;
+	int i;
+	int n;
+
+	Credential_vfnGetStats (&before);
+	for (round = 0; round < 2; round++)
+	{
+		for (i = 0; i < FLEET; i++)
+		{
+			result = present (fleet[i], &user);
+			CHECK ((result == eCREDENTIAL_OK) && (user == 100 + i), "fleet %d: %d user %u", i, result, user);
+		}
+	}
+	Credential_vfnGetStats (&after);
+	CHECK (after.hits == before.hits, "cycle hits %u", after.hits - before.hits);
+
+	/* The last CREDENTIAL_CACHE presented are the ones kept */
+	for (i = FLEET - CREDENTIAL_CACHE; i < FLEET; i++)
+	{
+		present (fleet[i], &user);
+	}
+	Credential_vfnGetStats (&before);
+	CHECK (before.hits - after.hits == CREDENTIAL_CACHE, "kept %u", before.hits - after.hits);
+
+	/* Four in five presentations from six regulars */
+	for (n = 0; n < PRESENTATIONS; n++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		i = ((seed >> 16) % 5u) ? (int)((seed >> 8) % 6u) : (int)((seed >> 4) % FLEET);
+		present (fleet[i], &user);
+	}
+	Credential_vfnGetStats (&after);
+	n = (int)(after.hits - before.hits);
+	printf ("skewed workload: %d of %d presentations hit the cache, %u verified\n", n, PRESENTATIONS,
+			after.verified - before.verified);
+	CHECK (n * 10 >= PRESENTATIONS * 8, "hit rate %d/%d", n, PRESENTATIONS);
+	CHECK (after.refused == before.refused, "refused");
+}
+
+int main (int argc, char **argv)
+{
+	Host_vfnInit (argc, argv);
+	Protocol_vfnDriverInit (Host_vfnIgnoreByte);
+	Pool_vfnInit ();
+	Credential_vfnInit (grant);
+
+	testVectors ();
+	testPresent ();
+	testPool ();
+	testCache ();
+
+	return Host_ifnResult ();
+}
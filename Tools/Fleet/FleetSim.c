@@ -0,0 +1,386 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		FleetSim.c
+	\date		October 19th, 2026
+	\brief		Runs thousands of simulated locks on a common virtual clock
+				across all cores.
+
+				Usage:
+					fleetsim [options]
+
+				Options:
+					--instances <n>		locks (default 1024)
+					--seconds <s>		virtual seconds to run (default 60)
+					--quantum <ms>		virtual time per scheduling step (default 250)
+					--workers <n,...>	worker counts to compare (default 1 up
+										to the number of cores, doubling)
+					--seed <s>			seed of the workloads (default 1)
+
+				The firmware state is process-wide (see Instance.c), so the
+				workers are forked processes. The contexts and the scheduler
+				live in shared memory. Every quantum the instances are split
+				into one range per worker; a worker takes instances from the
+				front of its own range and, once that is empty, steals from
+				the ranges of the others, one atomic increment per instance.
+
+				The output is one CSV line per worker count. inst_s_per_s is
+				instances x simulated seconds per wall second. hash covers every
+				context at the end: instances only touch their own context, so
+				it must not depend on the worker count, or the run fails.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "Instance.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_WORKERS
+	\brief		Most worker processes
+*/
+#define		MAX_WORKERS			256u
+
+/*!
+	\def		MAX_RUNS
+	\brief		Most worker counts compared in one run
+*/
+#define		MAX_RUNS			16u
+
+/*!
+	\def		LINE_SIZE
+	\brief		Cache line, so the cursors of two workers never share one
+*/
+#define		LINE_SIZE			64u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CURSOR
+	\brief		Range of instances of one worker in the current quantum
+*/
+typedef struct
+{
+	_Atomic uint32_t next;
+	uint32_t end;
+	uint8_t pad[LINE_SIZE - 2u * sizeof (uint32_t)];
+} CURSOR;
+
+/*!
+	\struct		SHARED
+	\brief		Scheduler state shared by the workers, followed by the cursors
+				and the contexts
+*/
+typedef struct
+{
+	pthread_barrier_t barrier;
+	_Atomic uint64_t steals;
+	double startSeconds;
+	double endSeconds;
+} SHARED;
+
+//------------------------------------------------------------------------------
+// Local Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		shared
+*/
+static SHARED *shared;
+
+/*!
+	\var		cursors
+*/
+static CURSOR *cursors;
+
+/*!
+	\var		contexts
+*/
+static uint8_t *contexts;
+
+/*!
+	\var		contextSize
+	\brief		Bytes of a context, rounded up to a cache line
+*/
+static size_t contextSize;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static double dfnNow (void)
+	\return		Returns the wall clock in seconds
+*/
+static double dfnNow (void)
+{
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1e9;
+}
+
+/*!
+	\fn			static int ifnTake (uint32_t worker, uint32_t workers, uint32_t *instance)
+	\return		Returns 1 with the next instance, from the own range first,
+				then stolen from the other ranges; 0 once all are taken
+*/
+static int ifnTake (uint32_t worker, uint32_t workers, uint32_t *instance)
+{
+	uint32_t i;
+	uint32_t victim;
+
+	for (i = 0; i < workers; i++)
+	{
+		victim = (worker + i) % workers;
+		if (atomic_load_explicit (&cursors[victim].next, memory_order_relaxed) >= cursors[victim].end)
+		{
+			continue;
+		}
+		*instance = atomic_fetch_add_explicit (&cursors[victim].next, 1u, memory_order_relaxed);
+		if (*instance < cursors[victim].end)
+		{
+			if (i)
+			{
+				atomic_fetch_add_explicit (&shared->steals, 1u, memory_order_relaxed);
+			}
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			static void vfnWorker (uint32_t worker, uint32_t workers, uint32_t instances, uint32_t quanta, uint64_t quantumUs, uint32_t seed)
+	\brief		One worker process. Quantum 0 creates the instances, the
+				others run them; two barriers per quantum keep the ranges
+				from being reset while another worker still takes from them.
+*/
+static void vfnWorker (uint32_t worker, uint32_t workers, uint32_t instances,
+		uint32_t quanta, uint64_t quantumUs, uint32_t seed)
+{
+	uint32_t quantum;
+	uint32_t instance;
+
+	for (quantum = 0; quantum <= quanta; quantum++)
+	{
+		cursors[worker].end = (uint32_t)((uint64_t)instances * (worker + 1u) / workers);
+		atomic_store (&cursors[worker].next, (uint32_t)((uint64_t)instances * worker / workers));
+		pthread_barrier_wait (&shared->barrier);
+		if ((quantum == 1) && (worker == 0))
+		{
+			shared->startSeconds = dfnNow ();
+		}
+
+		while (ifnTake (worker, workers, &instance))
+		{
+			if (quantum == 0)
+			{
+				Instance_vfnCreate (&contexts[instance * contextSize], seed + instance);
+			}
+			else
+			{
+				Instance_vfnRun (&contexts[instance * contextSize], quantumUs);
+			}
+		}
+		pthread_barrier_wait (&shared->barrier);
+	}
+	if (worker == 0)
+	{
+		shared->endSeconds = dfnNow ();
+	}
+}
+
+/*!
+	\fn			static uint64_t qwfnHash (uint32_t instances)
+	\return		Returns the FNV-1a hash of every context
+*/
+static uint64_t qwfnHash (uint32_t instances)
+{
+	uint64_t hash = 0xCBF29CE484222325ull;
+	size_t i;
+
+	for (i = 0; i < (size_t)instances * contextSize; i++)
+	{
+		hash = (hash ^ contexts[i]) * 0x100000001B3ull;
+	}
+	return hash;
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	uint32_t runWorkers[MAX_RUNS];
+	uint32_t runs = 0;
+	uint32_t instances = 1024;
+	uint32_t seconds = 60;
+	uint32_t quantumMs = 250;
+	uint32_t seed = 1;
+	uint32_t quanta;
+	uint32_t run;
+	uint32_t w;
+	uint32_t i;
+	uint64_t firstHash = 0;
+	double firstRate = 0.0;
+	double simSeconds;
+	double rate;
+	double wall;
+	size_t headerBytes;
+	size_t bytes;
+	pid_t pids[MAX_WORKERS];
+	pthread_barrierattr_t attr;
+	WORKLOAD_STATS stats;
+	WORKLOAD_STATS total;
+	char *list;
+	int failed = 0;
+	int status;
+	int argi;
+
+	/* Before any firmware code runs */
+	Instance_vfnInit ();
+
+	for (argi = 1; argi < argc; argi++)
+	{
+		if (!strcmp (argv[argi], "--instances") && (argi + 1 < argc))
+		{
+			instances = (uint32_t)strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--seconds") && (argi + 1 < argc))
+		{
+			seconds = (uint32_t)strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--quantum") && (argi + 1 < argc))
+		{
+			quantumMs = (uint32_t)strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--seed") && (argi + 1 < argc))
+		{
+			seed = (uint32_t)strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--workers") && (argi + 1 < argc))
+		{
+			for (list = argv[++argi]; *list && (runs < MAX_RUNS); list += (*list == ','))
+			{
+				runWorkers[runs++] = (uint32_t)strtoul (list, &list, 0);
+			}
+		}
+		else
+		{
+			fprintf (stderr, "usage: %s [--instances n] [--seconds s] [--quantum ms]"
+					" [--workers n,...] [--seed s]\n", argv[0]);
+			return 2;
+		}
+	}
+	if (!runs)
+	{
+		for (w = 1; (w < (uint32_t)sysconf (_SC_NPROCESSORS_ONLN)) && (runs < MAX_RUNS - 1u); w *= 2u)
+		{
+			runWorkers[runs++] = w;
+		}
+		runWorkers[runs++] = (uint32_t)sysconf (_SC_NPROCESSORS_ONLN);
+	}
+	if (!instances || !quantumMs)
+	{
+		return 2;
+	}
+	quanta = (seconds * 1000u + quantumMs - 1u) / quantumMs;
+	contextSize = (Instance_dwfnContextSize () + LINE_SIZE - 1u) & ~(size_t)(LINE_SIZE - 1u);
+	headerBytes = (sizeof (SHARED) + LINE_SIZE - 1u) & ~(size_t)(LINE_SIZE - 1u);
+
+	fprintf (stderr, "context %u bytes, %u instances, %u x %u ms\n",
+			Instance_dwfnContextSize (), instances, quanta, quantumMs);
+	printf ("workers,instances,sim_s,wall_s,inst_s_per_s,speedup,steals,"
+			"entries,unlocks,replies,hash\n");
+	fflush (stdout);
+
+	for (run = 0; run < runs; run++)
+	{
+		uint32_t workers = runWorkers[run];
+
+		if (!workers || (workers > MAX_WORKERS))
+		{
+			return 2;
+		}
+		bytes = headerBytes + MAX_WORKERS * sizeof (CURSOR) + (size_t)instances * contextSize;
+		shared = mmap (NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+		if (shared == MAP_FAILED)
+		{
+			perror ("mmap");
+			return 1;
+		}
+		cursors = (CURSOR *)((uint8_t *)shared + headerBytes);
+		contexts = (uint8_t *)(cursors + MAX_WORKERS);
+		pthread_barrierattr_init (&attr);
+		pthread_barrierattr_setpshared (&attr, PTHREAD_PROCESS_SHARED);
+		pthread_barrier_init (&shared->barrier, &attr, workers);
+		fflush (NULL);
+
+		for (w = 0; w < workers; w++)
+		{
+			pids[w] = fork ();
+			if (pids[w] == 0)
+			{
+				/* The firmware prints its own diagnostics */
+				if (freopen ("/dev/null", "w", stdout) == NULL)
+				{
+					_exit (1);
+				}
+				vfnWorker (w, workers, instances, quanta, (uint64_t)quantumMs * 1000u, seed);
+				_exit (0);
+			}
+		}
+		for (w = 0; w < workers; w++)
+		{
+			if ((waitpid (pids[w], &status, 0) < 0) || !WIFEXITED (status) || WEXITSTATUS (status))
+			{
+				fprintf (stderr, "worker %u failed\n", w);
+				failed = 1;
+			}
+		}
+
+		memset (&total, 0, sizeof (total));
+		for (i = 0; i < instances; i++)
+		{
+			Instance_vfnStats (&contexts[i * contextSize], &stats);
+			total.evaluations += stats.evaluations;
+			total.unlocks += stats.unlocks;
+			total.replies += stats.replies;
+		}
+		wall = shared->endSeconds - shared->startSeconds;
+		simSeconds = (double)quanta * quantumMs / 1000.0;
+		rate = (wall > 0.0) ? instances * simSeconds / wall : 0.0;
+		if (!run)
+		{
+			firstRate = rate;
+			firstHash = qwfnHash (instances);
+		}
+		else if (qwfnHash (instances) != firstHash)
+		{
+			fprintf (stderr, "%u workers: the contexts differ from %u workers\n",
+					workers, runWorkers[0]);
+			failed = 1;
+		}
+		printf ("%u,%u,%.1f,%.3f,%.0f,%.2f,%llu,%u,%u,%u,%016llx\n", workers, instances,
+				simSeconds, wall, rate,
+				firstRate > 0.0 ? rate / firstRate : 0.0,
+				(unsigned long long)atomic_load (&shared->steals), total.evaluations,
+				total.unlocks, total.replies, (unsigned long long)qwfnHash (instances));
+		fflush (stdout);
+
+		pthread_barrier_destroy (&shared->barrier);
+		munmap (shared, bytes);
+	}
+	fprintf (stderr, "%s\n", failed ? "FAIL" : "PASS");
+	return failed;
+}
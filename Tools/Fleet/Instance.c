@@ -0,0 +1,123 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Instance.c
+	\date		October 19th, 2026
+	\brief		Instance contexts of the firmware on the simulated HAL.
+
+				The firmware keeps its state in module statics, which is
+				right for the board and stays that way. For the host, the
+				firmware, SimHAL.c and Workload.c are linked into one object
+				whose writable data is renamed to the section "fwstate" (see
+				the Makefile), so the whole state of a lock, pinData,
+				numErrors, inLockdown, fnPtr and the rest, is one contiguous
+				block between __start_fwstate and __stop_fwstate. An instance
+				context is a copy of that block: running an instance loads it,
+				steps the firmware and stores it back. Pointers in the block
+				only point into the block, code or constants, whose addresses
+				are the same for every instance and every forked worker.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include "SimHAL.h"
+#include "Instance.h"
+
+//------------------------------------------------------------------------------
+// Local Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		__start_fwstate
+	\brief		Start of the instance state, provided by the linker
+*/
+extern uint8_t __start_fwstate[];
+
+/*!
+	\var		__stop_fwstate
+	\brief		End of the instance state, provided by the linker
+*/
+extern uint8_t __stop_fwstate[];
+
+/*!
+	\var		pristine
+	\brief		The instance state before any firmware code ran
+*/
+static uint8_t *pristine = NULL;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static const void *vpfnField (const void *context, const void *loaded)
+	\return		Returns where a variable of the loaded instance is kept in a
+				context
+*/
+static const void *vpfnField (const void *context, const void *loaded)
+{
+	return (const uint8_t *)context + ((const uint8_t *)loaded - __start_fwstate);
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Instance_vfnInit (void)
+	\brief		Keeps the initial state; must run before any other firmware
+				or SimHAL function
+*/
+void Instance_vfnInit (void)
+{
+	if (pristine == NULL)
+	{
+		pristine = malloc (Instance_dwfnContextSize ());
+		if (pristine == NULL)
+		{
+			abort ();
+		}
+		memcpy (pristine, __start_fwstate, Instance_dwfnContextSize ());
+	}
+}
+
+/*!
+	\fn			uint32_t Instance_dwfnContextSize (void)
+	\return		Returns the bytes of one instance context
+*/
+uint32_t Instance_dwfnContextSize (void)
+{
+	return (uint32_t)(__stop_fwstate - __start_fwstate);
+}
+
+/*!
+	\fn			void Instance_vfnCreate (void *context, uint32_t seed)
+	\param		context		Instance_dwfnContextSize bytes
+	\param		seed		Seed of the workload
+	\brief		Boots a new lock into context
+*/
+void Instance_vfnCreate (void *context, uint32_t seed)
+{
+	memcpy (__start_fwstate, pristine, Instance_dwfnContextSize ());
+	Workload_vfnStart (seed);
+	memcpy (context, __start_fwstate, Instance_dwfnContextSize ());
+}
+
+/*!
+	\fn			void Instance_vfnRun (void *context, uint64_t us)
+	\param		context		A created instance
+	\param		us			Virtual time to run
+*/
+void Instance_vfnRun (void *context, uint64_t us)
+{
+	memcpy (__start_fwstate, context, Instance_dwfnContextSize ());
+	Workload_vfnRunUntil (Sim_qwNowUs + us);
+	memcpy (context, __start_fwstate, Instance_dwfnContextSize ());
+}
+
+/*!
+	\fn			void Instance_vfnStats (const void *context, WORKLOAD_STATS *stats)
+	\brief		Reads the workload statistics of an instance without loading it
+*/
+void Instance_vfnStats (const void *context, WORKLOAD_STATS *stats)
+{
+	memcpy (stats, vpfnField (context, Workload_tpfnStats ()), sizeof (*stats));
+}
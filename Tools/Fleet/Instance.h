@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Instance.h
+	\date		October 19th, 2026
+	\brief		Re-entrant interface to the firmware on the simulated HAL.
+				Every lock is an instance context, an opaque block of
+				Instance_dwfnContextSize bytes owned by the caller; any number
+				of them can be created and run, one at a time per process.
+*/
+//------------------------------------------------------------------------------
+#ifndef FLEET_INSTANCE_H_
+#define FLEET_INSTANCE_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "Workload.h"
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+void Instance_vfnInit (void);
+
+uint32_t Instance_dwfnContextSize (void);
+
+void Instance_vfnCreate (void *context, uint32_t seed);
+
+void Instance_vfnRun (void *context, uint64_t us);
+
+void Instance_vfnStats (const void *context, WORKLOAD_STATS *stats);
+
+//------------------------------------------------------------------------------
+#endif /* FLEET_INSTANCE_H_ */
@@ -0,0 +1,334 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Workload.c
+	\date		October 19th, 2026
+	\brief		Per-instance driver of a simulated lock. Every few seconds of
+				virtual time a pin entry starts: the right pin one time in
+				three, each digit typed on the keypad or sent over Bluetooth,
+				followed now and then by a "$STAT" request. The events of one
+				entry are generated in time order, so a FIFO holds them.
+
+				Built into the instance context: every variable here is
+				swapped with the firmware's when the runner switches locks.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include "SimHAL.h"
+#include "SmartLock.h"
+#include "Workload.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		PIN_LENGTH
+	\brief		Digits of the pin, as in the simulator
+*/
+#define		PIN_LENGTH			4u
+
+/*!
+	\def		MAX_EVENTS
+	\brief		Events of one entry: a press and a release per digit and the
+				bytes of a status request
+*/
+#define		MAX_EVENTS			(PIN_LENGTH * 2u + sizeof (statRequest) - 1u)
+
+/*!
+	\def		LOOP_US
+	\brief		Step of the virtual clock while a key is held
+*/
+#define		LOOP_US				1000u
+
+/*!
+	\def		IDLE_JUMP_US
+	\brief		Longest jump of the virtual clock while no key is held
+*/
+#define		IDLE_JUMP_US		100000u
+
+/*!
+	\def		GAP_MS
+	\brief		Longest pause between two entries
+*/
+#define		GAP_MS				20000u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\enum		WORKLOAD_EVENT_TYPE
+*/
+typedef enum
+{
+	eWORKLOAD_KEY_DOWN = 0,
+	eWORKLOAD_KEY_UP,
+	eWORKLOAD_BT
+} WORKLOAD_EVENT_TYPE;
+
+/*!
+	\struct		WORKLOAD_EVENT
+*/
+typedef struct
+{
+	uint64_t timeUs;
+	uint8_t type;
+	uint8_t value;
+} WORKLOAD_EVENT;
+
+//------------------------------------------------------------------------------
+// Local Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		statRequest
+	\brief		Status request sent after some entries
+*/
+static const char statRequest[] = "$STAT\n";
+
+/*!
+	\var		password
+	\brief		Master pin of the firmware
+*/
+static const uint8_t password[PIN_LENGTH] = {1, 2, 3, 4};
+
+/*!
+	\var		events
+	\brief		FIFO of the pending events
+*/
+static WORKLOAD_EVENT events[MAX_EVENTS];
+
+/*!
+	\var		eventHead
+	\brief		Index of the next event
+*/
+static uint8_t eventHead = 0;
+
+/*!
+	\var		eventCount
+	\brief		Events pending
+*/
+static uint8_t eventCount = 0;
+
+/*!
+	\var		rngState
+	\brief		xorshift32 state, never 0
+*/
+static uint32_t rngState = 1;
+
+/*!
+	\var		stats
+*/
+static WORKLOAD_STATS stats;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t dwfnRandom (uint32_t range)
+	\return		Returns a pseudo-random number below range
+*/
+static uint32_t dwfnRandom (uint32_t range)
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return rngState % range;
+}
+
+/*!
+	\fn			static void vfnPush (uint64_t timeUs, WORKLOAD_EVENT_TYPE type, uint8_t value)
+*/
+static void vfnPush (uint64_t timeUs, WORKLOAD_EVENT_TYPE type, uint8_t value)
+{
+	WORKLOAD_EVENT *event = &events[(eventHead + eventCount) % MAX_EVENTS];
+
+	event->timeUs = timeUs;
+	event->type = (uint8_t)type;
+	event->value = value;
+	eventCount++;
+}
+
+/*!
+	\fn			static void vfnSequence (uint64_t startUs)
+	\brief		Generates one pin entry, as the simulator's fuzzer does
+*/
+static void vfnSequence (uint64_t startUs)
+{
+	uint8_t isCorrect = (dwfnRandom (3) == 0);
+	uint64_t t = startUs;
+	uint32_t hold;
+	uint8_t digit;
+	uint8_t i;
+
+	stats.sequences++;
+	for (i = 0; i < PIN_LENGTH; i++)
+	{
+		digit = isCorrect ? password[i] : (uint8_t)dwfnRandom (10);
+		if (dwfnRandom (2))
+		{
+			hold = (20u + dwfnRandom (200u)) * 1000u;
+			vfnPush (t, eWORKLOAD_KEY_DOWN, (uint8_t)('0' + digit));
+			vfnPush (t + hold, eWORKLOAD_KEY_UP, (uint8_t)('0' + digit));
+			t += hold + (20u + dwfnRandom (400u)) * 1000u;
+		}
+		else
+		{
+			vfnPush (t, eWORKLOAD_BT, digit);
+			t += (1u + dwfnRandom (200u)) * 1000u;
+		}
+	}
+	if (!dwfnRandom (4))
+	{
+		for (i = 0; statRequest[i]; i++)
+		{
+			vfnPush (t + i * 1000u, eWORKLOAD_BT, (uint8_t)statRequest[i]);
+		}
+	}
+}
+
+/*!
+	\fn			static void vfnPump (uint64_t nowUs)
+	\brief		Delivers every event that is due and starts the next entry
+				once the last one was delivered
+*/
+static void vfnPump (uint64_t nowUs)
+{
+	WORKLOAD_EVENT *event;
+
+	while (eventCount && (events[eventHead].timeUs <= nowUs))
+	{
+		event = &events[eventHead];
+		eventHead = (uint8_t)((eventHead + 1u) % MAX_EVENTS);
+		eventCount--;
+		switch (event->type)
+		{
+		case eWORKLOAD_KEY_DOWN:
+			Sim_vfnKey (event->value, 1);
+			break;
+
+		case eWORKLOAD_KEY_UP:
+			Sim_vfnKey (event->value, 0);
+			break;
+
+		default:
+			stats.btBytes++;
+			Sim_vfnUartRx (event->value);
+			break;
+		}
+	}
+	if (!eventCount)
+	{
+		vfnSequence (nowUs + (1000u + dwfnRandom (GAP_MS)) * 1000u);
+	}
+}
+
+/*!
+	\fn			static void vfnKeyAccepted (uint8_t key)
+*/
+static void vfnKeyAccepted (uint8_t key)
+{
+	(void)key;
+	stats.keys++;
+}
+
+/*!
+	\fn			static void vfnEvaluation (CLOCK_PROFILE profile)
+	\brief		The full speed request marks one evaluation of the pin
+*/
+static void vfnEvaluation (CLOCK_PROFILE profile)
+{
+	if (eCLOCK_PROFILE_RUN_48M == profile)
+	{
+		stats.evaluations++;
+	}
+}
+
+/*!
+	\fn			static void vfnPinChanged (PORTS port, PINS pin, uint8_t level)
+	\brief		PTA12 low energises the solenoid, PTB0 low starts a lockdown
+*/
+static void vfnPinChanged (PORTS port, PINS pin, uint8_t level)
+{
+	if ((port == ePORTA) && (pin == ePIN12) && !level)
+	{
+		stats.unlocks++;
+	}
+	else if ((port == ePORTB) && (pin == ePIN0) && !level)
+	{
+		stats.lockdowns++;
+	}
+}
+
+/*!
+	\fn			static void vfnTx (uint8_t value)
+	\brief		Counts the protocol replies by their line endings
+*/
+static void vfnTx (uint8_t value)
+{
+	if (value == '\n')
+	{
+		stats.replies++;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Workload_vfnStart (uint32_t seed)
+	\param		seed	Seed of the entries, one per instance
+	\brief		Boots the firmware on a freshly reset simulated board
+*/
+void Workload_vfnStart (uint32_t seed)
+{
+	rngState = seed ? seed : 1u;
+	Sim_vfnReset ();
+	Sim_vfnSetHooks (vfnPinChanged, vfnKeyAccepted, vfnPump, NULL, vfnEvaluation);
+	Sim_vfnSetTxHook (vfnTx);
+	SmartLock_vfnInit ();
+	vfnSequence (Sim_qwNowUs + dwfnRandom (GAP_MS) * 1000u);
+}
+
+/*!
+	\fn			void Workload_vfnRunUntil (uint64_t endUs)
+	\brief		Steps the firmware until the virtual clock reaches endUs.
+				While no key is held the clock jumps to the next event.
+*/
+void Workload_vfnRunUntil (uint64_t endUs)
+{
+	uint64_t jump;
+
+	while (Sim_qwNowUs < endUs)
+	{
+		SmartLock_vfnStep ();
+
+		jump = LOOP_US;
+		if (!Sim_bfnAnyKeyPressed ())
+		{
+			jump = IDLE_JUMP_US;
+			if (eventCount && (events[eventHead].timeUs > Sim_qwNowUs)
+					&& (events[eventHead].timeUs - Sim_qwNowUs < jump))
+			{
+				jump = events[eventHead].timeUs - Sim_qwNowUs;
+			}
+			if (jump < LOOP_US)
+			{
+				jump = LOOP_US;
+			}
+		}
+		if (jump > endUs - Sim_qwNowUs)
+		{
+			jump = endUs - Sim_qwNowUs;
+		}
+		Sim_vfnAdvance (jump);
+	}
+}
+
+/*!
+	\fn			const WORKLOAD_STATS *Workload_tpfnStats (void)
+	\return		Returns the statistics of the instance that is loaded
+*/
+const WORKLOAD_STATS *Workload_tpfnStats (void)
+{
+	return &stats;
+}
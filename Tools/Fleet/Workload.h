@@ -0,0 +1,46 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Workload.h
+	\date		October 19th, 2026
+	\brief		Per-instance driver of a simulated lock: random pin entries
+				on the keypad and over Bluetooth plus status requests. Its
+				state is part of the instance context like the firmware's.
+*/
+//------------------------------------------------------------------------------
+#ifndef FLEET_WORKLOAD_H_
+#define FLEET_WORKLOAD_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		WORKLOAD_STATS
+	\brief		What one lock went through
+*/
+typedef struct
+{
+	uint32_t sequences;			/*!< Pin entries started */
+	uint32_t keys;				/*!< Key presses accepted by the keypad */
+	uint32_t btBytes;			/*!< Bytes sent over Bluetooth */
+	uint32_t evaluations;		/*!< Pins evaluated by the firmware */
+	uint32_t unlocks;			/*!< Solenoid actuations */
+	uint32_t lockdowns;			/*!< Lockdowns entered */
+	uint32_t replies;			/*!< Management protocol replies */
+} WORKLOAD_STATS;
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+void Workload_vfnStart (uint32_t seed);
+
+void Workload_vfnRunUntil (uint64_t endUs);
+
+const WORKLOAD_STATS *Workload_tpfnStats (void);
+
+//------------------------------------------------------------------------------
+#endif /* FLEET_WORKLOAD_H_ */
@@ -0,0 +1,240 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Delta.c
+	\date		October 19th, 2026
+	\brief		Encoder and reference decoder of the firmware delta. The
+				encoder is greedy: at every position of the new image it looks
+				up the base positions sharing the next UPDATE_MIN_COPY bytes
+				and takes the longest match, the nearest one on a tie, since
+				code that only moved encodes with a short offset.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdlib.h>
+#include <string.h>
+#include "Update.h"
+#include "Delta.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		HASH_BITS
+	\brief		Size of the hash table of base positions
+*/
+#define		HASH_BITS			14
+
+/*!
+	\def		CHAIN_LIMIT
+	\brief		Base positions tried per hash bucket
+*/
+#define		CHAIN_LIMIT			256
+
+/*!
+	\def		MAX_LITERAL, MAX_COPY
+	\brief		Longest runs one operation byte can describe
+*/
+#define		MAX_LITERAL			128u
+#define		MAX_COPY			(0x7Fu + UPDATE_MIN_COPY)
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t hash (const uint8_t *p)
+	\return		Returns the bucket of the UPDATE_MIN_COPY bytes at p
+*/
+static uint32_t hash (const uint8_t *p)
+{
+	uint32_t value = (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+	return (value * 2654435761u) >> (32 - HASH_BITS);
+}
+
+/*!
+	\fn			static uint32_t varintSize (uint32_t value)
+	\return		Returns the bytes the varint of value takes
+*/
+static uint32_t varintSize (uint32_t value)
+{
+	uint32_t size = 1;
+
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		size++;
+	}
+	return size;
+}
+
+/*!
+	\fn			static uint32_t zigzag (int32_t value)
+	\return		Returns value with its sign in bit 0, as the decoder expects
+*/
+static uint32_t zigzag (int32_t value)
+{
+	return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			uint32_t Delta_dwfnEncode (const uint8_t *base, uint32_t baseSize,
+					const uint8_t *image, uint32_t size, uint8_t *out, uint32_t room)
+	\return		Returns the size of the operation stream, without a header,
+				or DELTA_FAILED if it does not fit room
+*/
+uint32_t Delta_dwfnEncode (const uint8_t *base, uint32_t baseSize,
+		const uint8_t *image, uint32_t size, uint8_t *out, uint32_t room)
+{
+	int32_t *head = malloc (sizeof (int32_t) << HASH_BITS);
+	int32_t *chain = malloc (sizeof (int32_t) * (baseSize ? baseSize : 1));
+	uint32_t length = 0;
+	uint32_t position = 0;
+	uint32_t literalStart = 0;
+	uint32_t i;
+
+#define EMIT(value)	do { if (length >= room) { length = DELTA_FAILED; goto done; } \
+						out[length++] = (uint8_t)(value); } while (0)
+
+	memset (head, 0xFF, sizeof (int32_t) << HASH_BITS);
+	for (i = 0; i + UPDATE_MIN_COPY <= baseSize; i++)
+	{
+		uint32_t h = hash (&base[i]);
+		chain[i] = head[h];
+		head[h] = (int32_t)i;
+	}
+
+	while (position < size)
+	{
+		uint32_t bestLength = 0;
+		uint32_t bestSource = 0;
+		uint32_t bestCost = 0;
+
+		if (position + UPDATE_MIN_COPY <= size)
+		{
+			int32_t candidate = head[hash (&image[position])];
+			int tries = CHAIN_LIMIT;
+
+			for (; (candidate >= 0) && tries--; candidate = chain[candidate])
+			{
+				uint32_t source = (uint32_t)candidate;
+				uint32_t match = 0;
+				uint32_t cost;
+
+				while ((match < MAX_COPY) && (position + match < size) &&
+						(source + match < baseSize) && (image[position + match] == base[source + match]))
+				{
+					match++;
+				}
+				cost = 1 + varintSize (zigzag ((int32_t)(source - position)));
+				if ((match >= UPDATE_MIN_COPY) && (match > cost) &&
+						((match > bestLength) || ((match == bestLength) && (cost < bestCost))))
+				{
+					bestLength = match;
+					bestSource = source;
+					bestCost = cost;
+				}
+			}
+		}
+
+		if (bestLength == 0)
+		{
+			position++;
+			if ((position - literalStart == MAX_LITERAL) || (position == size))
+			{
+				EMIT (position - literalStart - 1);
+				for (i = literalStart; i < position; i++)
+				{
+					EMIT (image[i]);
+				}
+				literalStart = position;
+			}
+			continue;
+		}
+
+		if (position > literalStart)
+		{
+			EMIT (position - literalStart - 1);
+			for (i = literalStart; i < position; i++)
+			{
+				EMIT (image[i]);
+			}
+		}
+		EMIT (0x80 | (bestLength - UPDATE_MIN_COPY));
+		for (i = zigzag ((int32_t)(bestSource - position)); i >= 0x80; i >>= 7)
+		{
+			EMIT (0x80 | (i & 0x7F));
+		}
+		EMIT (i);
+		position += bestLength;
+		literalStart = position;
+	}
+
+done:
+#undef EMIT
+	free (head);
+	free (chain);
+	return length;
+}
+
+/*!
+	\fn			uint32_t Delta_dwfnApply (const uint8_t *base, uint32_t baseSize,
+					const uint8_t *delta, uint32_t deltaSize, uint8_t *out, uint32_t room)
+	\return		Returns the size of the rebuilt image, or DELTA_FAILED if the
+				operation stream is malformed
+	\brief		Same rules as the decoder of Update.c, on whole buffers
+*/
+uint32_t Delta_dwfnApply (const uint8_t *base, uint32_t baseSize,
+		const uint8_t *delta, uint32_t deltaSize, uint8_t *out, uint32_t room)
+{
+	uint32_t in = 0;
+	uint32_t length = 0;
+
+	while (in < deltaSize)
+	{
+		uint8_t op = delta[in++];
+
+		if (op < 0x80)
+		{
+			uint32_t count = (uint32_t)op + 1;
+
+			if ((in + count > deltaSize) || (length + count > room))
+			{
+				return DELTA_FAILED;
+			}
+			memcpy (&out[length], &delta[in], count);
+			in += count;
+			length += count;
+		}
+		else
+		{
+			uint32_t count = (uint32_t)(op & 0x7F) + UPDATE_MIN_COPY;
+			uint32_t offset = 0;
+			uint32_t source;
+			uint8_t shift = 0;
+			uint8_t value;
+
+			do
+			{
+				if ((in >= deltaSize) || (shift > 28))
+				{
+					return DELTA_FAILED;
+				}
+				value = delta[in++];
+				offset |= (uint32_t)(value & 0x7F) << shift;
+				shift += 7;
+			} while (value & 0x80);
+
+			source = length + ((offset >> 1) ^ (0u - (offset & 1)));
+			if ((source >= baseSize) || (count > baseSize - source) || (length + count > room))
+			{
+				return DELTA_FAILED;
+			}
+			memcpy (&out[length], &base[source], count);
+			length += count;
+		}
+	}
+	return length;
+}
@@ -0,0 +1,34 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Delta.h
+	\date		October 19th, 2026
+	\brief		Host side of the firmware delta format decoded by Update.c:
+				an encoder and a reference decoder.
+*/
+//------------------------------------------------------------------------------
+#ifndef FOTA_DELTA_H_
+#define FOTA_DELTA_H_
+
+#include <stdint.h>
+
+/*!
+	\def		DELTA_HEADER
+	\brief		Bytes of the delta file header: image size, image CRC-32,
+				base size and base CRC-32, little endian
+*/
+#define		DELTA_HEADER		16u
+
+/*!
+	\def		DELTA_FAILED
+	\brief		Returned instead of a size when a delta cannot be built or
+				applied
+*/
+#define		DELTA_FAILED		0xFFFFFFFFu
+
+uint32_t Delta_dwfnEncode (const uint8_t *base, uint32_t baseSize,
+		const uint8_t *image, uint32_t size, uint8_t *out, uint32_t room);
+
+uint32_t Delta_dwfnApply (const uint8_t *base, uint32_t baseSize,
+		const uint8_t *delta, uint32_t deltaSize, uint8_t *out, uint32_t room);
+
+#endif /* FOTA_DELTA_H_ */
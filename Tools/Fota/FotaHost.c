@@ -0,0 +1,544 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		FotaHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the firmware updater. Update.c, Swap.c,
+				Protocol.c and CRC.c run unchanged on a model of the 64 KB
+				flash that can lose power after any erase or longword
+				program. The harness sends a delta over the management
+				protocol, then boots the swap, the trial and the rollback with
+				a reset at every single flash operation and checks that the
+				slots always end up whole.
+
+				The update was signed ahead with the development key of
+				Update.h (seed byte i is i * 29 + 3), so the harness needs
+				no signing code; an unsigned image, a wrong signature and an
+				unauthorized link are refused.
+
+				Usage:
+					fotahost [--verbose]
+
+				An interrupted program leaves the longword with only some of
+				its bits cleared. An interrupted erase leaves the sector as it
+				was: the FTFA only reports an erase done after it verified it.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <setjmp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CRC.h"
+#include "Flash.h"
+#include "Protocol.h"
+#include "Swap.h"
+#include "Update.h"
+#include "Delta.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		BASE_SIZE, IMAGE_SIZE
+	\brief		Sizes of the running image and of the update
+*/
+#define		BASE_SIZE			20000u
+#define		IMAGE_SIZE			20420u
+
+/*!
+	\def		STORM_OPS
+	\brief		Flash operations between the resets of the reset storm, a bit
+				more than one swap step takes
+*/
+#define		STORM_OPS			300
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+static uint8_t flash[FLASH_SIZE];
+static uint8_t snapshot[FLASH_SIZE];
+static uint32_t flashOps = 0;
+static int32_t cutAfter = -1;
+static jmp_buf powerCut;
+static uint32_t overprograms = 0;
+
+static uint8_t base[SWAP_SLOT_SIZE];
+static uint8_t image[SWAP_SLOT_SIZE];
+
+/*!
+	\var		signature
+	\brief		Signature of the update made by makeImages
+*/
+static const char signature[] =
+		"fdd7ff2fb366b7d891594123cf0334f3c84190723c21c1fcef79f09309abe426"
+		"88c6672d9a8c03382315a8ea1d5a72600eb3ead9004ecafe353a756cda871704";
+
+//------------------------------------------------------------------------------
+// Flash model
+//------------------------------------------------------------------------------
+/*!
+	\fn			static int flashCut (void)
+	\return		Returns 1 if the power fails during this operation
+*/
+static int flashCut (void)
+{
+	flashOps++;
+	if (cutAfter < 0)
+	{
+		return 0;
+	}
+	return cutAfter-- == 0;
+}
+
+uint8_t Flash_bfnErase (uint32_t address)
+{
+	if ((address % FLASH_SECTOR) || (address >= FLASH_SIZE) || (address < SWAP_PRIMARY))
+	{
+		return 0;
+	}
+	if (flashCut ())
+	{
+		longjmp (powerCut, 1);
+	}
+	memset (&flash[address], 0xFF, FLASH_SECTOR);
+	return 1;
+}
+
+uint8_t Flash_bfnProgram (uint32_t address, const uint8_t *data, uint32_t size)
+{
+	uint32_t word;
+	uint32_t old;
+	uint32_t i;
+
+	if ((address % FLASH_PHRASE) || (size % FLASH_PHRASE) || (address + size > FLASH_SIZE) ||
+			(address < SWAP_PRIMARY))
+	{
+		return 0;
+	}
+	for (i = 0; i < size; i += FLASH_PHRASE, address += FLASH_PHRASE)
+	{
+		memcpy (&word, &data[i], sizeof (word));
+		memcpy (&old, &flash[address], sizeof (old));
+		if (old != FLASH_ERASED)
+		{
+			overprograms++;
+		}
+		if (flashCut ())
+		{
+			/* Only some of the bits made it */
+			word = old & (word | (0x5A5A5A5Au ^ address));
+			memcpy (&flash[address], &word, sizeof (word));
+			longjmp (powerCut, 1);
+		}
+		word &= old;
+		memcpy (&flash[address], &word, sizeof (word));
+	}
+	return 1;
+}
+
+const uint8_t *Flash_pbfnRead (uint32_t address)
+{
+	return &flash[address];
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void sendLines (const uint8_t *delta, uint32_t deltaSize)
+	\brief		Sends a delta as $UPD lines without looking at the replies
+*/
+static void sendLines (const uint8_t *delta, uint32_t deltaSize)
+{
+	char line[80];
+	uint32_t lines;
+	uint32_t i;
+	uint32_t k;
+	int length;
+
+	for (i = 0, lines = 0; i < deltaSize; i += 16, lines++)
+	{
+		length = snprintf (line, sizeof (line), "UPD %x ", lines);
+		for (k = i; (k < i + 16) && (k < deltaSize); k++)
+		{
+			length += snprintf (&line[length], sizeof (line) - (size_t)length, "%02x", delta[k]);
+		}
+		Host_pcfnCommand (line, 0);
+	}
+}
+
+/*!
+	\fn			static const char *sendSignature (const char *hex)
+	\return		Returns the reply to the last $UPG line
+	\brief		Sends the hex of a signature 16 bytes a line
+*/
+static const char *sendSignature (const char *hex)
+{
+	char line[48];
+	size_t i;
+
+	for (i = 0; i < strlen (hex); i += 32)
+	{
+		snprintf (line, sizeof (line), "UPG %.32s", &hex[i]);
+		Host_pcfnCommand (line, 0);
+	}
+	return Host_pcfnCommand (NULL, 0);
+}
+
+/*!
+	\fn			static void makeImages (void)
+	\brief		Builds a running image and an update that changes a few
+				constants, inserts a function and so moves all later code
+*/
+static void makeImages (void)
+{
+	uint32_t seed = 12345;
+	uint32_t i;
+
+	for (i = 0; i < BASE_SIZE; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		/* Code repeats: reuse an earlier byte now and then */
+		base[i] = ((i > 64) && ((seed >> 28) < 5)) ? base[i - 1 - ((seed >> 16) & 63)] : (uint8_t)(seed >> 16);
+	}
+	memset (&base[BASE_SIZE], 0xFF, SWAP_SLOT_SIZE - BASE_SIZE);
+	memset (image, 0xFF, sizeof (image));
+
+	/* Same start with a few patched literals, 400 new bytes, moved rest */
+	memcpy (image, base, 6000);
+	image[100] ^= 0x10;
+	image[2222] = 0x42;
+	for (i = 0; i < 400; i++)
+	{
+		seed = seed * 1103515245u + 12345u;
+		image[6000 + i] = (uint8_t)(seed >> 16);
+	}
+	memcpy (&image[6400], &base[6000], BASE_SIZE - 6000);
+	image[15000] ^= 0xFF;
+	for (i = BASE_SIZE + 400; i < IMAGE_SIZE; i++)
+	{
+		image[i] = (uint8_t)i;
+	}
+}
+
+/*!
+	\fn			static void resetFlash (void)
+	\brief		A board running the base image with an empty journal
+*/
+static void resetFlash (void)
+{
+	memset (flash, 0xFF, sizeof (flash));
+	memcpy (&flash[SWAP_PRIMARY], base, SWAP_SLOT_SIZE);
+}
+
+/*!
+	\fn			static int slotIs (uint32_t slot, const uint8_t *content)
+	\return		Returns 1 if a whole slot holds content
+*/
+static int slotIs (uint32_t slot, const uint8_t *content)
+{
+	return memcmp (&flash[slot], content, SWAP_SLOT_SIZE) == 0;
+}
+
+/*!
+	\fn			static int journalErased (void)
+	\return		Returns 1 if the journal was compacted
+*/
+static int journalErased (void)
+{
+	uint32_t i;
+
+	for (i = SWAP_JOURNAL; i < SWAP_JOURNAL + SWAP_JOURNAL_SIZE; i++)
+	{
+		if (flash[i] != 0xFF)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+/*!
+	\fn			static SWAP_STATE bootWithCut (int32_t cut)
+	\return		Returns the state of the slots after the boot
+	\brief		Runs the bootloader, losing power after cut flash
+				operations unless cut is negative
+*/
+static SWAP_STATE bootWithCut (int32_t cut)
+{
+	SWAP_STATE state = eSWAP_STATES;
+
+	cutAfter = cut;
+	if (setjmp (powerCut) == 0)
+	{
+		state = Swap_efnBoot ();
+	}
+	cutAfter = -1;
+	return state;
+}
+
+//------------------------------------------------------------------------------
+// Scenarios
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testDownload (void)
+	\brief		Sends the update as a delta through the management protocol
+				with one lost acknowledgement, then checks the refusals
+*/
+static void testDownload (void)
+{
+	static uint8_t delta[2 * SWAP_SLOT_SIZE];
+	uint32_t deltaSize;
+	uint32_t baseCrc = CRC_dwfnCompute (eCRC32, base, BASE_SIZE);
+	uint32_t imageCrc = CRC_dwfnCompute (eCRC32, image, IMAGE_SIZE);
+	char line[80];
+	char expect[16];
+	uint32_t lines = 0;
+	uint32_t damaged;
+	uint32_t i;
+	uint32_t k;
+	int length;
+
+	deltaSize = Delta_dwfnEncode (base, BASE_SIZE, image, IMAGE_SIZE, delta, sizeof (delta));
+	CHECK (deltaSize != DELTA_FAILED, "encode");
+	{
+		static uint8_t check[SWAP_SLOT_SIZE];
+		CHECK (Delta_dwfnApply (base, BASE_SIZE, delta, deltaSize, check, sizeof (check)) == IMAGE_SIZE &&
+				memcmp (check, image, IMAGE_SIZE) == 0, "reference decoder");
+	}
+
+	resetFlash ();
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPB ERR auth") == 0, "unauthorized begin: %s", Host_acUartOut);
+	CHECK (strcmp (Host_pcfnCommand ("UPR", 0), "UPR ERR auth") == 0, "unauthorized reset: %s", Host_acUartOut);
+	CHECK (strncmp (Host_pcfnCommand ("UPS", 0), "UPS swap=0 active=0", 19) == 0, "status: %s", Host_acUartOut);
+	Protocol_vfnAuthorize ();
+
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc ^ 1);
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPB ERR base") == 0, "wrong base accepted: %s", Host_acUartOut);
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", SWAP_SLOT_SIZE + 1, imageCrc, BASE_SIZE, baseCrc);
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPB ERR size") == 0, "oversized image accepted: %s", Host_acUartOut);
+	CHECK (strcmp (Host_pcfnCommand ("UPD 0 00", 0), "UPD ERR idle") == 0, "data without a session: %s", Host_acUartOut);
+
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPB OK") == 0, "begin: %s", Host_acUartOut);
+	for (i = 0; i < deltaSize; i += 16, lines++)
+	{
+		length = snprintf (line, sizeof (line), "UPD %x ", lines);
+		for (k = i; (k < i + 16) && (k < deltaSize); k++)
+		{
+			length += snprintf (&line[length], sizeof (line) - (size_t)length, "%02x", delta[k]);
+		}
+		snprintf (expect, sizeof (expect), "UPD %x", lines);
+		CHECK (strcmp (Host_pcfnCommand (line, 0), expect) == 0, "line %u: %s", lines, Host_acUartOut);
+		if (lines == 7)
+		{
+			/* The acknowledgement got lost: the sender repeats the line */
+			CHECK (strcmp (Host_pcfnCommand (line, 0), expect) == 0, "repeated line: %s", Host_acUartOut);
+		}
+	}
+	CHECK (strncmp (Host_pcfnCommand ("UPS", 0), "UPS swap=0 active=1", 19) == 0, "status: %s", Host_acUartOut);
+	CHECK (strcmp (sendSignature (signature), "UPG 40") == 0, "signature: %s", Host_acUartOut);
+	CHECK (strcmp (Host_pcfnCommand ("UPE", 0), "UPE OK") == 0, "end: %s", Host_acUartOut);
+	CHECK (Swap_efnGetState () == eSWAP_READY, "not ready");
+	CHECK (memcmp (&flash[SWAP_SECONDARY], image, IMAGE_SIZE) == 0, "secondary slot");
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPD ERR idle") == 0, "data after the end: %s", Host_acUartOut);
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	CHECK (strcmp (Host_pcfnCommand (line, 0), "UPB ERR busy") == 0, "second update while ready: %s", Host_acUartOut);
+
+	printf ("download: %u byte image as a %u byte delta (%u%%) in %u lines\n",
+			IMAGE_SIZE, deltaSize, 100u * deltaSize / IMAGE_SIZE, lines);
+
+	/* A damaged delta is caught before the swap is requested */
+	resetFlash ();
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	Host_pcfnCommand (line, 0);
+	for (i = 0; delta[i] >= 0x80; i++)
+	{
+		/* Skip copies and their offsets to the first literal */
+		while (delta[++i] & 0x80)
+		{
+		}
+	}
+	damaged = i + 1;
+	delta[damaged] ^= 0x01;
+	sendLines (delta, deltaSize);
+	delta[damaged] ^= 0x01;
+	sendSignature (signature);
+	CHECK (strcmp (Host_pcfnCommand ("UPE", 0), "UPE ERR image") == 0, "damaged image accepted: %s", Host_acUartOut);
+	CHECK (Swap_efnGetState () == eSWAP_IDLE, "damaged image requested");
+
+	/* The right image, unsigned or with a signature of something else */
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	Host_pcfnCommand (line, 0);
+	sendLines (delta, deltaSize);
+	CHECK (strcmp (Host_pcfnCommand ("UPE", 0), "UPE ERR sig") == 0, "unsigned image accepted: %s", Host_acUartOut);
+	CHECK (Swap_efnGetState () == eSWAP_IDLE, "unsigned image requested");
+	{
+		char forged[sizeof (signature)];
+
+		memcpy (forged, signature, sizeof (signature));
+		forged[70] = (forged[70] == '0') ? '1' : '0';
+		Host_pcfnCommand (line, 0);
+		sendLines (delta, deltaSize);
+		CHECK (strcmp (sendSignature (forged), "UPG 40") == 0, "forged signature: %s", Host_acUartOut);
+		CHECK (strcmp (Host_pcfnCommand ("UPG 00", 0), "UPG ERR format") == 0, "signature too long: %s", Host_acUartOut);
+		Host_pcfnCommand (line, 0);
+		sendLines (delta, deltaSize);
+		sendSignature (forged);
+		CHECK (strcmp (Host_pcfnCommand ("UPE", 0), "UPE ERR sig") == 0, "forged signature accepted: %s", Host_acUartOut);
+		CHECK (Swap_efnGetState () == eSWAP_IDLE, "forged image requested");
+	}
+
+	snprintf (line, sizeof (line), "UPB %x %x %x %x", IMAGE_SIZE, imageCrc, BASE_SIZE, baseCrc);
+	Host_pcfnCommand (line, 0);
+	CHECK (strcmp (Host_pcfnCommand ("UPD 5 00", 0), "UPD ERR seq") == 0, "sequence gap: %s", Host_acUartOut);
+}
+
+/*!
+	\fn			static void prepareReady (void)
+	\brief		Flash as the download leaves it: update in the secondary slot,
+				swap requested
+*/
+static void prepareReady (void)
+{
+	resetFlash ();
+	memcpy (&flash[SWAP_SECONDARY], image, SWAP_SLOT_SIZE);
+	CHECK (Swap_bfnRequest (IMAGE_SIZE, CRC_dwfnCompute (eCRC32, image, IMAGE_SIZE)), "request");
+}
+
+/*!
+	\fn			static void testSwap (void)
+	\brief		Swap, trial and confirm without a reset
+*/
+static void testSwap (void)
+{
+	uint32_t ops;
+
+	prepareReady ();
+	flashOps = 0;
+	CHECK (bootWithCut (-1) == eSWAP_TRIAL, "swap");
+	ops = flashOps;
+	CHECK (slotIs (SWAP_PRIMARY, image) && slotIs (SWAP_SECONDARY, base), "slots after the swap");
+	CHECK (Swap_bfnConfirm () && (Swap_efnGetState () == eSWAP_IDLE) && journalErased (), "confirm");
+	CHECK (bootWithCut (-1) == eSWAP_IDLE && slotIs (SWAP_PRIMARY, image), "boot after confirm");
+	printf ("swap: %u flash operations\n", ops);
+
+	/* A ready image damaged after the download is not started */
+	prepareReady ();
+	flash[SWAP_SECONDARY + 10] ^= 0x01;
+	CHECK (bootWithCut (-1) == eSWAP_IDLE && slotIs (SWAP_PRIMARY, base) && journalErased (), "damaged ready image");
+}
+
+/*!
+	\fn			static void testSwapCuts (void)
+	\brief		Loses power at every flash operation of the swap
+*/
+static void testSwapCuts (void)
+{
+	uint32_t total;
+	uint32_t bad = 0;
+	int32_t cut;
+	SWAP_STATE state;
+
+	prepareReady ();
+	memcpy (snapshot, flash, sizeof (flash));
+	flashOps = 0;
+	bootWithCut (-1);
+	total = flashOps;
+
+	for (cut = 0; cut < (int32_t)total; cut++)
+	{
+		memcpy (flash, snapshot, sizeof (flash));
+		bootWithCut (cut);
+		state = bootWithCut (-1);
+		if ((state != eSWAP_TRIAL) || !slotIs (SWAP_PRIMARY, image) || !slotIs (SWAP_SECONDARY, base))
+		{
+			if (bad++ < 5)
+			{
+				CHECK (0, "reset after %d of %u operations: state %u", cut, total, state);
+			}
+		}
+	}
+	CHECK (bad == 0, "%u of %u resets broke the swap", bad, total);
+	printf ("swap: survived a reset at each of %u flash operations\n", total);
+}
+
+/*!
+	\fn			static void testRollbackCuts (void)
+	\brief		An update that never confirms itself is swapped back, even
+				with power lost at every flash operation of the rollback
+*/
+static void testRollbackCuts (void)
+{
+	uint32_t total;
+	uint32_t bad = 0;
+	int32_t cut;
+	SWAP_STATE state;
+
+	prepareReady ();
+	bootWithCut (-1);
+	memcpy (snapshot, flash, sizeof (flash));
+	flashOps = 0;
+	state = bootWithCut (-1);
+	total = flashOps;
+	CHECK (state == eSWAP_IDLE && slotIs (SWAP_PRIMARY, base) && slotIs (SWAP_SECONDARY, image) &&
+			journalErased (), "rollback");
+
+	for (cut = 0; cut < (int32_t)total; cut++)
+	{
+		memcpy (flash, snapshot, sizeof (flash));
+		bootWithCut (cut);
+		state = bootWithCut (-1);
+		if ((state != eSWAP_IDLE) || !slotIs (SWAP_PRIMARY, base) || !journalErased ())
+		{
+			if (bad++ < 5)
+			{
+				CHECK (0, "reset after %d of %u operations: state %u", cut, total, state);
+			}
+		}
+	}
+	CHECK (bad == 0, "%u of %u resets broke the rollback", bad, total);
+	printf ("rollback: survived a reset at each of %u flash operations\n", total);
+}
+
+/*!
+	\fn			static void testResetStorm (void)
+	\brief		Resets every STORM_OPS flash operations until the swap is
+				done, then confirms
+*/
+static void testResetStorm (void)
+{
+	uint32_t boots = 0;
+	SWAP_STATE state = eSWAP_STATES;
+
+	prepareReady ();
+	while ((state != eSWAP_TRIAL) && (boots++ < 1000))
+	{
+		state = bootWithCut (STORM_OPS);
+	}
+	CHECK (state == eSWAP_TRIAL && slotIs (SWAP_PRIMARY, image) && slotIs (SWAP_SECONDARY, base),
+			"storm: state %u after %u boots", state, boots);
+	CHECK (Swap_bfnConfirm () && bootWithCut (-1) == eSWAP_IDLE && slotIs (SWAP_PRIMARY, image), "storm confirm");
+	printf ("storm: swapped across %u resets\n", boots);
+}
+
+int main (int argc, char **argv)
+{
+	Host_vfnInit (argc, argv);
+	CRC_vfnDriverInit ();
+	Protocol_vfnDriverInit (Host_vfnIgnoreByte);
+	Update_vfnInit ();
+	makeImages ();
+
+	testDownload ();
+	testSwap ();
+	testSwapCuts ();
+	testRollbackCuts ();
+	testResetStorm ();
+
+	CHECK (overprograms == 0, "%u longwords programmed without an erase", overprograms);
+	return Host_ifnResult ();
+}
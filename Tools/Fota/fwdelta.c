@@ -0,0 +1,244 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		fwdelta.c
+	\date		October 19th, 2026
+	\brief		Builds, checks and sends firmware deltas for the updater.
+
+				Usage:
+					fwdelta make <base.bin> <new.bin> <out.delta>
+					fwdelta apply <base.bin> <in.delta> <out.bin>
+					fwdelta digest <new.bin> <out.digest>
+					fwdelta send <base.bin> <in.delta> <in.sig>
+
+				The images are the raw contents of the primary slot, as
+				objcopy -O binary writes them for an application linked at
+				0x1000. "send" prints the $UP command lines to pipe into the
+				Bluetooth serial port; the sender must wait for the "$UPD seq"
+				acknowledgement of every line and resend it otherwise. The
+				lock only takes them once the master password was typed on
+				its keypad.
+
+				The lock only takes an image signed with the vendor's Ed25519
+				key over its SHA-256 digest. "digest" writes the digest, to
+				be signed where the key is kept, for instance:
+					openssl pkeyutl -sign -inkey vendor.pem -rawin
+							-in new.digest -out new.sig
+				and "send" adds the 64 byte signature as $UPG lines.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "CRC.h"
+#include "Ed25519.h"
+#include "Hash.h"
+#include "Swap.h"
+#include "Delta.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		LINE_BYTES
+	\brief		Delta bytes per $UPD line; must not exceed UPDATE_CHUNK
+*/
+#define		LINE_BYTES			16u
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint8_t *load (const char *path, uint32_t *size)
+	\return		Returns the contents of a file, or exits
+*/
+static uint8_t *load (const char *path, uint32_t *size)
+{
+	FILE *file = fopen (path, "rb");
+	uint8_t *data = NULL;
+	long length;
+
+	if (!file || fseek (file, 0, SEEK_END) || ((length = ftell (file)) < 0) || fseek (file, 0, SEEK_SET))
+	{
+		fprintf (stderr, "fwdelta: cannot read %s\n", path);
+		exit (1);
+	}
+	data = malloc ((size_t)length + 1);
+	if (fread (data, 1, (size_t)length, file) != (size_t)length)
+	{
+		fprintf (stderr, "fwdelta: cannot read %s\n", path);
+		exit (1);
+	}
+	fclose (file);
+	*size = (uint32_t)length;
+	return data;
+}
+
+/*!
+	\fn			static void save (const char *path, const uint8_t *data, uint32_t size)
+	\brief		Writes a file, or exits
+*/
+static void save (const char *path, const uint8_t *data, uint32_t size)
+{
+	FILE *file = fopen (path, "wb");
+
+	if (!file || (fwrite (data, 1, size, file) != size) || fclose (file))
+	{
+		fprintf (stderr, "fwdelta: cannot write %s\n", path);
+		exit (1);
+	}
+}
+
+/*!
+	\fn			static void putWord (uint8_t *p, uint32_t value)
+	\brief		Stores a little endian header word
+*/
+static void putWord (uint8_t *p, uint32_t value)
+{
+	p[0] = (uint8_t)value;
+	p[1] = (uint8_t)(value >> 8);
+	p[2] = (uint8_t)(value >> 16);
+	p[3] = (uint8_t)(value >> 24);
+}
+
+/*!
+	\fn			static uint32_t getWord (const uint8_t *p)
+	\return		Returns a little endian header word
+*/
+static uint32_t getWord (const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+/*!
+	\fn			static uint32_t checkBase (const uint8_t *delta, uint32_t deltaSize,
+					const uint8_t *base, uint32_t baseSize)
+	\return		Returns the base size of the delta, or exits if the base
+				does not match it
+*/
+static uint32_t checkBase (const uint8_t *delta, uint32_t deltaSize, const uint8_t *base, uint32_t baseSize)
+{
+	uint32_t size;
+
+	if (deltaSize < DELTA_HEADER)
+	{
+		fprintf (stderr, "fwdelta: delta too short\n");
+		exit (1);
+	}
+	size = getWord (&delta[8]);
+	if ((size > baseSize) || (CRC_dwfnCompute (eCRC32, base, size) != getWord (&delta[12])))
+	{
+		fprintf (stderr, "fwdelta: the delta was not made against this base\n");
+		exit (1);
+	}
+	return size;
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	uint32_t baseSize = 0;
+	uint32_t size = 0;
+	uint32_t deltaSize = 0;
+	uint8_t *base;
+	uint8_t *image;
+	uint8_t *delta;
+	uint8_t *signature;
+	uint32_t signatureSize = 0;
+	HASH_CONTEXT hash;
+	uint8_t digest[HASH_MAX_DIGEST];
+	uint32_t i;
+	uint32_t j;
+
+	if ((argc == 5) && !strcmp (argv[1], "make"))
+	{
+		base = load (argv[2], &baseSize);
+		image = load (argv[3], &size);
+		if ((size == 0) || (size > SWAP_SLOT_SIZE) || (baseSize > SWAP_SLOT_SIZE))
+		{
+			fprintf (stderr, "fwdelta: images must fit the %u byte slot\n", SWAP_SLOT_SIZE);
+			return 1;
+		}
+		delta = malloc (DELTA_HEADER + 2 * size);
+		deltaSize = Delta_dwfnEncode (base, baseSize, image, size, &delta[DELTA_HEADER], 2 * size);
+		putWord (&delta[0], size);
+		putWord (&delta[4], CRC_dwfnCompute (eCRC32, image, size));
+		putWord (&delta[8], baseSize);
+		putWord (&delta[12], CRC_dwfnCompute (eCRC32, base, baseSize));
+		save (argv[4], delta, DELTA_HEADER + deltaSize);
+		printf ("%u -> %u bytes (%u%%), %u $UPD lines\n", size, DELTA_HEADER + deltaSize,
+				100u * (DELTA_HEADER + deltaSize) / size, (deltaSize + LINE_BYTES - 1) / LINE_BYTES);
+		return 0;
+	}
+
+	if ((argc == 5) && !strcmp (argv[1], "apply"))
+	{
+		base = load (argv[2], &baseSize);
+		delta = load (argv[3], &deltaSize);
+		baseSize = checkBase (delta, deltaSize, base, baseSize);
+		image = malloc (SWAP_SLOT_SIZE);
+		size = Delta_dwfnApply (base, baseSize, &delta[DELTA_HEADER], deltaSize - DELTA_HEADER, image, SWAP_SLOT_SIZE);
+		if ((size != getWord (&delta[0])) || (CRC_dwfnCompute (eCRC32, image, size) != getWord (&delta[4])))
+		{
+			fprintf (stderr, "fwdelta: the rebuilt image does not match\n");
+			return 1;
+		}
+		save (argv[4], image, size);
+		return 0;
+	}
+
+	if ((argc == 4) && !strcmp (argv[1], "digest"))
+	{
+		image = load (argv[2], &size);
+		Hash_vfnStart (&hash, eHASH_SHA256);
+		Hash_vfnUpdate (&hash, image, size);
+		Hash_vfnFinish (&hash, digest);
+		save (argv[3], digest, HASH_MAX_DIGEST);
+		return 0;
+	}
+
+	if ((argc == 5) && !strcmp (argv[1], "send"))
+	{
+		base = load (argv[2], &baseSize);
+		delta = load (argv[3], &deltaSize);
+		signature = load (argv[4], &signatureSize);
+		baseSize = checkBase (delta, deltaSize, base, baseSize);
+		if (signatureSize != ED25519_SIGNATURE)
+		{
+			fprintf (stderr, "fwdelta: %s is not a %u byte signature\n", argv[4], ED25519_SIGNATURE);
+			return 1;
+		}
+		printf ("$UPB %x %x %x %x\n", getWord (&delta[0]), getWord (&delta[4]), baseSize, getWord (&delta[12]));
+		for (i = DELTA_HEADER, j = 0; i < deltaSize; i += LINE_BYTES, j++)
+		{
+			uint32_t k;
+
+			printf ("$UPD %x ", j & 0xFFFF);
+			for (k = i; (k < i + LINE_BYTES) && (k < deltaSize); k++)
+			{
+				printf ("%02x", delta[k]);
+			}
+			printf ("\n");
+		}
+		for (i = 0; i < ED25519_SIGNATURE; i += LINE_BYTES)
+		{
+			printf ("$UPG ");
+			for (j = i; j < i + LINE_BYTES; j++)
+			{
+				printf ("%02x", signature[j]);
+			}
+			printf ("\n");
+		}
+		printf ("$UPE\n");
+		return 0;
+	}
+
+	fprintf (stderr, "usage: fwdelta make <base.bin> <new.bin> <out.delta>\n"
+			"       fwdelta apply <base.bin> <in.delta> <out.bin>\n"
+			"       fwdelta digest <new.bin> <out.digest>\n"
+			"       fwdelta send <base.bin> <in.delta> <in.sig>\n");
+	return 2;
+}
@@ -0,0 +1,316 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Fleet.cpp
+	\date		October 19th, 2026
+	\brief		Fan-out operations over many locks. The reply handlers run on
+				the epoll thread and only store the reply; the lock that got
+				its last reply is handed to the pool for parsing.
+
+				User table format, one entry per line, '#' starts a comment:
+					sched <n> <days> <HHMM> <HHMM>	access rule of schedule n,
+													days Monday first, e.g. 1111100
+					user <n> <pin> [<sched>]		pin of user slot n
+				Every schedule named in the table is cleared before its rules
+				are added, and the users go last so they never point at a
+				schedule that is half written.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <algorithm>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include "Fleet.h"
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static bool IsError (const std::string &line)
+	\return		Returns true if a reply line reports an error, "ERR <command>"
+				for an unknown command or "<TAG> ERR <reason>"
+*/
+static bool IsError (const std::string &line)
+{
+	return (line.compare (0, 4, "ERR ") == 0) || (line.find (" ERR ") != std::string::npos);
+}
+
+/*!
+	\fn			static void Collect (LockResult &result, const std::vector<Reply> &replies)
+	\brief		Keeps every line and field; fails on the first error
+*/
+static void Collect (LockResult &result, const std::vector<Reply> &replies)
+{
+	std::string tag;
+	std::string token;
+	size_t equals = 0;
+
+	result.ok = true;
+	for (const Reply &reply : replies)
+	{
+		if (!reply.ok)
+		{
+			result.ok = false;
+			if (result.error.empty ())
+			{
+				result.error = reply.error;
+			}
+			continue;
+		}
+		for (const std::string &line : reply.lines)
+		{
+			std::istringstream words (line);
+
+			result.lines.push_back (line);
+			if (IsError (line))
+			{
+				result.ok = false;
+				if (result.error.empty ())
+				{
+					result.error = line;
+				}
+			}
+			words >> tag;
+			while (words >> token)
+			{
+				equals = token.find ('=');
+				if (equals != std::string::npos)
+				{
+					result.fields[tag + "." + token.substr (0, equals)] = token.substr (equals + 1);
+				}
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			Fleet::Fleet (Gateway &gateway, ThreadPool &pool)
+*/
+Fleet::Fleet (Gateway &gateway, ThreadPool &pool)
+	: gateway (gateway), pool (pool)
+{
+}
+
+/*!
+	\fn			std::vector<size_t> Fleet::All () const
+	\return		Returns the index of every link
+*/
+std::vector<size_t> Fleet::All () const
+{
+	std::vector<size_t> locks (gateway.LinkCount ());
+	size_t i = 0;
+
+	for (i = 0; i < locks.size (); i++)
+	{
+		locks[i] = i;
+	}
+	return locks;
+}
+
+/*!
+	\fn			std::vector<LockResult> Fleet::StatusSweep (const std::vector<size_t> &locks)
+	\brief		Reads the link, battery, watchdog and clock state of every lock
+*/
+std::vector<LockResult> Fleet::StatusSweep (const std::vector<size_t> &locks)
+{
+	return FanOut (locks, {"PING", "STAT", "BATT", "WDOG", "TIME"}, Collect);
+}
+
+/*!
+	\fn			std::vector<LockResult> Fleet::PushUsers (const std::vector<size_t> &locks, const std::vector<std::string> &commands)
+	\param		commands	Output of UserTable
+	\brief		Writes a user table to every lock; every line must be acknowledged
+*/
+std::vector<LockResult> Fleet::PushUsers (const std::vector<size_t> &locks,
+		const std::vector<std::string> &commands)
+{
+	return FanOut (locks, commands, [] (LockResult &result, const std::vector<Reply> &replies)
+	{
+		Collect (result, replies);
+		for (const Reply &reply : replies)
+		{
+			if (reply.ok && (reply.lines.empty ()
+					|| (reply.lines[0].size () < 3)
+					|| (reply.lines[0].compare (reply.lines[0].size () - 3, 3, " OK") != 0)))
+			{
+				result.ok = false;
+				if (result.error.empty ())
+				{
+					result.error = reply.lines.empty () ? "no reply" : reply.lines[0];
+				}
+			}
+		}
+	});
+}
+
+/*!
+	\fn			std::vector<LockResult> Fleet::PullLogs (const std::vector<size_t> &locks)
+	\brief		Reads the crash record and the watchdog history of every lock
+*/
+std::vector<LockResult> Fleet::PullLogs (const std::vector<size_t> &locks)
+{
+	return FanOut (locks, {"CRASH", "WDOG"}, Collect);
+}
+
+/*!
+	\fn			std::vector<LockResult> Fleet::Send (const std::vector<size_t> &locks, const std::string &command)
+	\brief		Sends one command line to every lock
+*/
+std::vector<LockResult> Fleet::Send (const std::vector<size_t> &locks, const std::string &command)
+{
+	return FanOut (locks, {command}, Collect);
+}
+
+/*!
+	\fn			std::vector<std::string> Fleet::UserTable (std::istream &in)
+	\param		in		User table, see the file header
+	\return		Returns the commands that write the table
+	\brief		Throws std::runtime_error naming the first malformed line
+*/
+std::vector<std::string> Fleet::UserTable (std::istream &in)
+{
+	std::vector<std::string> schedules;
+	std::vector<std::string> rules;
+	std::vector<std::string> users;
+	std::vector<std::string> commands;
+	std::vector<std::string> words;
+	std::string line;
+	std::string word;
+	size_t number = 0;
+
+	while (std::getline (in, line))
+	{
+		std::istringstream stream (line.substr (0, line.find ('#')));
+
+		number++;
+		words.clear ();
+		while (stream >> word)
+		{
+			words.push_back (word);
+		}
+		if (words.empty ())
+		{
+			continue;
+		}
+		if ((words[0] == "sched") && (words.size () == 5))
+		{
+			if (std::find (schedules.begin (), schedules.end (), words[1]) == schedules.end ())
+			{
+				schedules.push_back (words[1]);
+			}
+			rules.push_back ("SCHED " + words[1] + " " + words[2] + " " + words[3] + " " + words[4]);
+		}
+		else if ((words[0] == "user") && ((words.size () == 3) || (words.size () == 4)))
+		{
+			users.push_back ("USER " + words[1] + " " + words[2]
+					+ ((words.size () == 4) ? " " + words[3] : std::string ()));
+		}
+		else
+		{
+			throw std::runtime_error ("line " + std::to_string (number) + ": " + line);
+		}
+	}
+
+	for (const std::string &schedule : schedules)
+	{
+		commands.push_back ("SCHED " + schedule + " CLR");
+	}
+	commands.insert (commands.end (), rules.begin (), rules.end ());
+	commands.insert (commands.end (), users.begin (), users.end ());
+	return commands;
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			std::vector<LockResult> Fleet::FanOut (const std::vector<size_t> &locks, const std::vector<std::string> &commands, Parser parse)
+	\return		Returns one result per lock, in the order of locks
+	\brief		Submits every command to every lock and waits for all of them
+*/
+std::vector<LockResult> Fleet::FanOut (const std::vector<size_t> &locks,
+		const std::vector<std::string> &commands, Parser parse)
+{
+	/* Shared by the handlers of one call; outlives it only if a handler does */
+	struct Batch
+	{
+		std::mutex mutex;
+		std::condition_variable done;
+		size_t remaining;
+		std::vector<LockResult> results;
+	};
+	/* Replies of one lock, only touched on the epoll thread until parsed */
+	struct Pending
+	{
+		std::vector<Reply> replies;
+		size_t left;
+		Clock::time_point start;
+	};
+
+	std::shared_ptr<Batch> batch = std::make_shared<Batch> ();
+	size_t i = 0;
+	size_t k = 0;
+
+	batch->remaining = locks.size ();
+	batch->results.resize (locks.size ());
+	if (locks.empty ())
+	{
+		return {};
+	}
+	if (commands.empty ())
+	{
+		for (i = 0; i < locks.size (); i++)
+		{
+			batch->results[i].link = locks[i];
+			batch->results[i].ok = true;
+		}
+		return batch->results;
+	}
+
+	for (i = 0; i < locks.size (); i++)
+	{
+		std::shared_ptr<Pending> pending = std::make_shared<Pending> ();
+
+		pending->replies.resize (commands.size ());
+		pending->left = commands.size ();
+		pending->start = Clock::now ();
+		for (k = 0; k < commands.size (); k++)
+		{
+			gateway.Submit (locks[i], commands[k],
+					[this, batch, pending, parse, i, k, link = locks[i]] (const Reply &reply)
+			{
+				pending->replies[k] = reply;
+				if (--pending->left)
+				{
+					return;
+				}
+				double ms = std::chrono::duration<double, std::milli> (Clock::now () - pending->start).count ();
+				pool.Post ([batch, pending, parse, i, link, ms]
+				{
+					LockResult result;
+
+					result.link = link;
+					result.ms = ms;
+					parse (result, pending->replies);
+
+					std::lock_guard<std::mutex> lock (batch->mutex);
+					batch->results[i] = std::move (result);
+					if (--batch->remaining == 0)
+					{
+						batch->done.notify_all ();
+					}
+				});
+			});
+		}
+	}
+
+	std::unique_lock<std::mutex> lock (batch->mutex);
+	batch->done.wait (lock, [&batch] { return batch->remaining == 0; });
+	return std::move (batch->results);
+}
@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Fleet.h
+	\date		October 19th, 2026
+	\brief		Fan-out operations over many locks: every lock gets its
+				commands pipelined on its own link, and its replies are parsed
+				on the thread pool as soon as the last one arrived.
+*/
+//------------------------------------------------------------------------------
+#ifndef GATEWAY_FLEET_H_
+#define GATEWAY_FLEET_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <functional>
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+#include "Gateway.h"
+#include "ThreadPool.h"
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		LockResult
+	\brief		Outcome of one operation on one lock. fields holds the
+				key=value pairs of the replies as "<TAG>.<key>", e.g.
+				"BATT.mv"; lines holds every reply line.
+*/
+struct LockResult
+{
+	size_t link = 0;
+	bool ok = false;
+	std::string error;
+	std::map<std::string, std::string> fields;
+	std::vector<std::string> lines;
+	double ms = 0.0;
+};
+
+//------------------------------------------------------------------------------
+// Classes
+//------------------------------------------------------------------------------
+/*!
+	\class		Fleet
+	\brief		Operations run on a set of locks at once
+*/
+class Fleet
+{
+public:
+	Fleet (Gateway &gateway, ThreadPool &pool);
+
+	std::vector<size_t> All () const;
+
+	std::vector<LockResult> StatusSweep (const std::vector<size_t> &locks);
+	std::vector<LockResult> PushUsers (const std::vector<size_t> &locks,
+			const std::vector<std::string> &commands);
+	std::vector<LockResult> PullLogs (const std::vector<size_t> &locks);
+	std::vector<LockResult> Send (const std::vector<size_t> &locks, const std::string &command);
+
+	static std::vector<std::string> UserTable (std::istream &in);
+
+private:
+	/*!
+		\typedef	Parser
+		\brief		Fills a result from the replies of its commands, in order
+	*/
+	typedef std::function<void (LockResult &result, const std::vector<Reply> &replies)> Parser;
+
+	std::vector<LockResult> FanOut (const std::vector<size_t> &locks,
+			const std::vector<std::string> &commands, Parser parse);
+
+	Gateway &gateway;
+	ThreadPool &pool;
+};
+
+#endif /* GATEWAY_FLEET_H_ */
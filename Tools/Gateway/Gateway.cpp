@@ -0,0 +1,312 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Gateway.cpp
+	\date		October 19th, 2026
+	\brief		Multiplexer of many lock links on one epoll thread. The links
+				are level-triggered for input; output is only armed while a
+				link has bytes the port did not take, since most writes go
+				through at once. Timeouts are checked every EXPIRE_MS.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Gateway.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		WAKE_KEY
+	\brief		epoll key of the eventfd, above every link index
+*/
+#define		WAKE_KEY			UINT64_MAX
+
+/*!
+	\def		MAX_EVENTS
+	\brief		Events taken per epoll_wait
+*/
+#define		MAX_EVENTS			64
+
+/*!
+	\def		EXPIRE_MS
+	\brief		Period of the timeout check, also the longest epoll_wait
+*/
+#define		EXPIRE_MS			10
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static speed_t SpeedOf (uint32_t baud)
+	\return		Returns the termios speed of a baud rate, B9600 if unknown
+*/
+static speed_t SpeedOf (uint32_t baud)
+{
+	switch (baud)
+	{
+		case 19200:		return B19200;
+		case 38400:		return B38400;
+		case 57600:		return B57600;
+		case 115200:	return B115200;
+		case 230400:	return B230400;
+		default:		return B9600;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			Gateway::Gateway (const GatewayOptions &options)
+*/
+Gateway::Gateway (const GatewayOptions &options)
+	: options (options)
+{
+	struct epoll_event event = {};
+
+	epollFd = epoll_create1 (EPOLL_CLOEXEC);
+	wakeFd = eventfd (0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ((epollFd < 0) || (wakeFd < 0))
+	{
+		throw std::runtime_error (std::string ("epoll: ") + strerror (errno));
+	}
+	event.events = EPOLLIN;
+	event.data.u64 = WAKE_KEY;
+	epoll_ctl (epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+}
+
+/*!
+	\fn			Gateway::~Gateway ()
+	\brief		Stops the thread; closing the links fails what is still queued
+*/
+Gateway::~Gateway ()
+{
+	Stop ();
+	links.clear ();
+	close (wakeFd);
+	close (epollFd);
+}
+
+/*!
+	\fn			size_t Gateway::AddLink (int fd, const std::string &name)
+	\param		fd		Descriptor of a serial port or pty, owned from now on
+	\param		name	Name used in the reports
+	\return		Returns the index of the link
+	\brief		Adds a link; only before Start
+*/
+size_t Gateway::AddLink (int fd, const std::string &name)
+{
+	struct epoll_event event = {};
+	size_t index = links.size ();
+
+	fcntl (fd, F_SETFL, fcntl (fd, F_GETFL) | O_NONBLOCK);
+	links.emplace_back (new Link (fd, name, options.window, options.timeout));
+	isArmedOut.push_back (false);
+
+	event.events = EPOLLIN;
+	event.data.u64 = index;
+	if (epoll_ctl (epollFd, EPOLL_CTL_ADD, fd, &event) < 0)
+	{
+		throw std::runtime_error (name + ": " + strerror (errno));
+	}
+	Arm (index);
+	return index;
+}
+
+/*!
+	\fn			size_t Gateway::OpenDevice (const std::string &path)
+	\param		path	Serial device or pty
+	\return		Returns the index of the link
+	\brief		Opens a port raw, 8N1 at the configured baud rate
+*/
+size_t Gateway::OpenDevice (const std::string &path)
+{
+	struct termios tty;
+	int fd = open (path.c_str (), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+
+	if (fd < 0)
+	{
+		throw std::runtime_error (path + ": " + strerror (errno));
+	}
+	if (isatty (fd) && (tcgetattr (fd, &tty) == 0))
+	{
+		cfmakeraw (&tty);
+		cfsetspeed (&tty, SpeedOf (options.baud));
+		tty.c_cflag |= CLOCAL | CREAD;
+		tty.c_cc[VMIN] = 0;
+		tty.c_cc[VTIME] = 0;
+		tcsetattr (fd, TCSANOW, &tty);
+		tcflush (fd, TCIOFLUSH);
+	}
+	return AddLink (fd, path);
+}
+
+/*!
+	\fn			void Gateway::Start ()
+	\brief		Starts the epoll thread
+*/
+void Gateway::Start ()
+{
+	if (!isRunning.exchange (true))
+	{
+		thread = std::thread (&Gateway::Run, this);
+	}
+}
+
+/*!
+	\fn			void Gateway::Stop ()
+	\brief		Stops the epoll thread; queued commands stay queued
+*/
+void Gateway::Stop ()
+{
+	uint64_t one = 1;
+
+	if (isRunning.exchange (false))
+	{
+		(void)!write (wakeFd, &one, sizeof (one));
+		thread.join ();
+	}
+}
+
+/*!
+	\fn			void Gateway::Submit (size_t link, const std::string &command, ReplyHandler handler)
+	\param		link		Index of the link
+	\param		command		Command line without "$" and newline
+	\param		handler		Called on the epoll thread with the reply
+	\brief		Queues a command from any thread
+*/
+void Gateway::Submit (size_t link, const std::string &command, ReplyHandler handler)
+{
+	uint64_t one = 1;
+	bool wasEmpty = false;
+
+	{
+		std::lock_guard<std::mutex> lock (inboxMutex);
+		wasEmpty = inbox.empty ();
+		inbox.push_back ({link, command, std::move (handler)});
+	}
+	if (wasEmpty)
+	{
+		(void)!write (wakeFd, &one, sizeof (one));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Gateway::Run ()
+	\brief		The epoll thread
+*/
+void Gateway::Run ()
+{
+	struct epoll_event events[MAX_EVENTS];
+	Clock::time_point nextExpire = Clock::now ();
+	Clock::time_point now;
+	size_t index = 0;
+	int count = 0;
+	int i = 0;
+
+	while (isRunning)
+	{
+		count = epoll_wait (epollFd, events, MAX_EVENTS, EXPIRE_MS);
+		for (i = 0; i < count; i++)
+		{
+			if (events[i].data.u64 == WAKE_KEY)
+			{
+				uint64_t value;
+				(void)!read (wakeFd, &value, sizeof (value));
+				Drain ();
+				continue;
+			}
+			index = (size_t)events[i].data.u64;
+			if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+			{
+				links[index]->OnReadable ();
+			}
+			if (events[i].events & EPOLLOUT)
+			{
+				links[index]->OnWritable ();
+			}
+			Arm (index);
+		}
+
+		now = Clock::now ();
+		if (now >= nextExpire)
+		{
+			nextExpire = now + std::chrono::milliseconds (EXPIRE_MS);
+			for (index = 0; index < links.size (); index++)
+			{
+				links[index]->Expire (now);
+				Arm (index);
+			}
+		}
+		loops++;
+	}
+}
+
+/*!
+	\fn			void Gateway::Drain ()
+	\brief		Hands the submitted commands to their links
+*/
+void Gateway::Drain ()
+{
+	std::vector<Submission> batch;
+	Reply reply;
+
+	{
+		std::lock_guard<std::mutex> lock (inboxMutex);
+		batch.swap (inbox);
+	}
+	for (Submission &submission : batch)
+	{
+		if (submission.link >= links.size ())
+		{
+			reply.error = "no such link";
+			if (submission.handler)
+			{
+				submission.handler (reply);
+			}
+			continue;
+		}
+		links[submission.link]->Queue (submission.command, std::move (submission.handler));
+		Arm (submission.link);
+	}
+}
+
+/*!
+	\fn			void Gateway::Arm (size_t index)
+	\brief		Writes what a link has queued and waits for EPOLLOUT only if
+				the port did not take all of it
+*/
+void Gateway::Arm (size_t index)
+{
+	Link &link = *links[index];
+	struct epoll_event event = {};
+	bool wantsOut = false;
+
+	if (link.WantsWrite ())
+	{
+		link.OnWritable ();
+	}
+	if (!link.IsOpen ())
+	{
+		return;
+	}
+	wantsOut = link.WantsWrite ();
+	if (wantsOut != isArmedOut[index])
+	{
+		event.events = EPOLLIN | (wantsOut ? EPOLLOUT : 0);
+		event.data.u64 = index;
+		epoll_ctl (epollFd, EPOLL_CTL_MOD, link.Fd (), &event);
+		isArmedOut[index] = wantsOut;
+	}
+}
@@ -0,0 +1,97 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Gateway.h
+	\date		October 19th, 2026
+	\brief		Multiplexer of many lock links on one epoll thread. Any thread
+				may submit commands; they are handed to the epoll thread
+				through an inbox and an eventfd, and the replies come back
+				through the handlers, called on the epoll thread.
+*/
+//------------------------------------------------------------------------------
+#ifndef GATEWAY_GATEWAY_H_
+#define GATEWAY_GATEWAY_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Link.h"
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		GatewayOptions
+	\brief		Settings shared by every link
+*/
+struct GatewayOptions
+{
+	size_t window = 4;
+	std::chrono::milliseconds timeout {2000};
+	uint32_t baud = 9600;
+};
+
+//------------------------------------------------------------------------------
+// Classes
+//------------------------------------------------------------------------------
+/*!
+	\class		Gateway
+	\brief		Owns the links and the epoll thread that serves them
+*/
+class Gateway
+{
+public:
+	explicit Gateway (const GatewayOptions &options);
+	~Gateway ();
+
+	Gateway (const Gateway &) = delete;
+	Gateway &operator= (const Gateway &) = delete;
+
+	size_t AddLink (int fd, const std::string &name);
+	size_t OpenDevice (const std::string &path);
+
+	void Start ();
+	void Stop ();
+
+	void Submit (size_t link, const std::string &command, ReplyHandler handler);
+
+	size_t LinkCount () const { return links.size (); }
+	const std::string &LinkName (size_t link) const { return links[link]->Name (); }
+	uint64_t Loops () const { return loops; }
+
+private:
+	/*!
+		\struct		Submission
+		\brief		A command on its way to the epoll thread
+	*/
+	struct Submission
+	{
+		size_t link;
+		std::string command;
+		ReplyHandler handler;
+	};
+
+	void Run ();
+	void Drain ();
+	void Arm (size_t link);
+
+	GatewayOptions options;
+	int epollFd;
+	int wakeFd;
+	std::vector<std::unique_ptr<Link>> links;
+	std::vector<bool> isArmedOut;
+
+	std::mutex inboxMutex;
+	std::vector<Submission> inbox;
+
+	std::thread thread;
+	std::atomic<bool> isRunning {false};
+	std::atomic<uint64_t> loops {0};
+};
+
+#endif /* GATEWAY_GATEWAY_H_ */
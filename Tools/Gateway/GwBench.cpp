@@ -0,0 +1,231 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		GwBench.cpp
+	\date		October 19th, 2026
+	\brief		Throughput of the gateway against simulated locks. For every
+				lock count a fleet of simlock processes is started on
+				pseudo-terminals and every operation runs for a number of
+				rounds; the result is one CSV line per count and operation,
+				in locks serviced per second.
+
+				Usage:
+					gwbench [options] <locks>...
+
+				Options:
+					--rounds <n>	rounds per operation (default 3)
+					--threads <n>	parser threads (default 2)
+					--window <n>	commands in flight per lock (default 4)
+					--simlock <path> simulated lock (default ./simlock)
+
+				The exit status is 1 if any lock failed any operation. The
+				locks are separate processes sharing the cores with the
+				gateway, so the numbers are a lower bound on a dedicated host.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include "Fleet.h"
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		SimLock
+	\brief		A simulated lock process and its terminal
+*/
+struct SimLock
+{
+	pid_t pid;
+	int master;
+	int slave;
+	std::string path;
+};
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static SimLock Spawn (const char *simlock)
+	\brief		Starts a simulated lock on a new pseudo-terminal. The master
+				is made raw before the lock starts so nothing it sends is
+				echoed back, and the parent keeps the slave open so the
+				master never reads EIO while the child (re)opens it.
+*/
+static SimLock Spawn (const char *simlock)
+{
+	struct termios tty;
+	SimLock lock;
+
+	lock.master = posix_openpt (O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if ((lock.master < 0) || grantpt (lock.master) || unlockpt (lock.master))
+	{
+		throw std::runtime_error (std::string ("posix_openpt: ") + strerror (errno));
+	}
+	lock.path = ptsname (lock.master);
+	lock.slave = open (lock.path.c_str (), O_RDWR | O_NOCTTY | O_CLOEXEC);
+	if (lock.slave < 0)
+	{
+		throw std::runtime_error (lock.path + ": " + strerror (errno));
+	}
+	tcgetattr (lock.slave, &tty);
+	cfmakeraw (&tty);
+	tcsetattr (lock.slave, TCSANOW, &tty);
+
+	lock.pid = fork ();
+	if (lock.pid == 0)
+	{
+		execl (simlock, simlock, lock.path.c_str (), (char *)NULL);
+		_exit (127);
+	}
+	if (lock.pid < 0)
+	{
+		throw std::runtime_error (std::string ("fork: ") + strerror (errno));
+	}
+	return lock;
+}
+
+/*!
+	\fn			static std::vector<std::string> BenchTable ()
+	\return		Returns the commands of a user table of a business-hours
+				schedule and eight users
+*/
+static std::vector<std::string> BenchTable ()
+{
+	std::vector<std::string> commands = {"SCHED 1 CLR", "SCHED 1 1111100 0800 1800"};
+	unsigned user = 0;
+
+	for (user = 1; user <= 8; user++)
+	{
+		commands.push_back ("USER " + std::to_string (user) + " " + std::to_string (4000 + user * 7) + " 1");
+	}
+	return commands;
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	GatewayOptions options;
+	std::vector<size_t> counts;
+	const char *simlock = "./simlock";
+	size_t threads = 2;
+	unsigned rounds = 3;
+	size_t totalFailures = 0;
+	int argi = 1;
+
+	for (argi = 1; argi < argc; argi++)
+	{
+		if (!strcmp (argv[argi], "--rounds") && (argi + 1 < argc))
+		{
+			rounds = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--threads") && (argi + 1 < argc))
+		{
+			threads = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--window") && (argi + 1 < argc))
+		{
+			options.window = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--simlock") && (argi + 1 < argc))
+		{
+			simlock = argv[++argi];
+		}
+		else if ((argv[argi][0] != '-') && strtoul (argv[argi], NULL, 0))
+		{
+			counts.push_back (strtoul (argv[argi], NULL, 0));
+		}
+		else
+		{
+			fprintf (stderr, "usage: %s [--rounds n] [--threads n] [--window n] [--simlock path] <locks>...\n",
+					argv[0]);
+			return 2;
+		}
+	}
+
+	printf ("locks,op,rounds,seconds,locks_per_s,failures\n");
+	try
+	{
+		for (size_t count : counts)
+		{
+			std::vector<SimLock> locks;
+			Gateway gateway (options);
+			ThreadPool pool (threads);
+			Fleet fleet (gateway, pool);
+			const std::vector<std::string> table = BenchTable ();
+			struct Operation
+			{
+				const char *name;
+				std::function<std::vector<LockResult> ()> run;
+			};
+			const Operation operations[] =
+			{
+				{"sweep", [&] { return fleet.StatusSweep (fleet.All ()); }},
+				{"push", [&] { return fleet.PushUsers (fleet.All (), table); }},
+				{"pull", [&] { return fleet.PullLogs (fleet.All ()); }},
+			};
+
+			for (size_t i = 0; i < count; i++)
+			{
+				locks.push_back (Spawn (simlock));
+				gateway.AddLink (locks.back ().master, locks.back ().path);
+			}
+			gateway.Start ();
+			/* Warm-up: every link finishes its "$PIPE 1" */
+			fleet.Send (fleet.All (), "PING");
+
+			for (const Operation &operation : operations)
+			{
+				size_t failures = 0;
+				unsigned round = 0;
+				auto start = Clock::now ();
+
+				for (round = 0; round < rounds; round++)
+				{
+					for (const LockResult &result : operation.run ())
+					{
+						if (!result.ok)
+						{
+							failures++;
+							fprintf (stderr, "%s: lock %zu: %s\n", operation.name, result.link,
+									result.error.c_str ());
+						}
+					}
+				}
+				double seconds = std::chrono::duration<double> (Clock::now () - start).count ();
+				printf ("%zu,%s,%u,%.3f,%.1f,%zu\n", count, operation.name, rounds, seconds,
+						seconds > 0.0 ? (double)(count * rounds) / seconds : 0.0, failures);
+				fflush (stdout);
+				totalFailures += failures;
+			}
+
+			gateway.Stop ();
+			for (SimLock &lock : locks)
+			{
+				kill (lock.pid, SIGTERM);
+				close (lock.slave);
+			}
+			for (SimLock &lock : locks)
+			{
+				waitpid (lock.pid, NULL, 0);
+			}
+		}
+	}
+	catch (const std::exception &error)
+	{
+		fprintf (stderr, "gwbench: %s\n", error.what ());
+		return 1;
+	}
+	return totalFailures ? 1 : 0;
+}
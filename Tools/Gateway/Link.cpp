@@ -0,0 +1,333 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Link.cpp
+	\date		October 19th, 2026
+	\brief		One serial link to a lock. The first command of every link is
+				"$PIPE 1"; until its reply arrives one command at a time is
+				in flight, then up to the window.
+
+				A timeout fails every command in flight. Their replies may
+				still come, so the link sends a "$PING" and drops every line
+				until the "$PONG" and the "$END" after it before it goes on.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <cerrno>
+#include <iterator>
+#include <unistd.h>
+#include "Link.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_LINE
+	\brief		Longest reply line kept; the lock sends at most 64 characters
+*/
+#define		MAX_LINE			256u
+
+/*!
+	\def		READ_CHUNK
+	\brief		Bytes taken per read
+*/
+#define		READ_CHUNK			512u
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			Link::Link (int fd, const std::string &name, size_t window, std::chrono::milliseconds timeout)
+	\param		fd		Non-blocking descriptor of the serial port or pty; the
+						link closes it
+	\param		name	Name used in the reports
+	\param		window	Commands in flight, at most the PROTOCOL_QUEUE of the lock
+	\param		timeout	Longest wait for the "$END" of a command
+*/
+Link::Link (int fd, const std::string &name, size_t window, std::chrono::milliseconds timeout)
+	: fd (fd), name (name), window (window ? window : 1), timeout (timeout)
+{
+	Queue ("PIPE 1", [this] (const Reply &reply)
+	{
+		isPipelined = !reply.lines.empty () && (reply.lines[0] == "PIPE 1");
+		if (reply.ok && !isPipelined)
+		{
+			Close ("no PIPE support");
+		}
+	});
+}
+
+/*!
+	\fn			Link::~Link ()
+*/
+Link::~Link ()
+{
+	Close ("gateway stopped");
+}
+
+/*!
+	\fn			void Link::Queue (const std::string &command, ReplyHandler handler)
+	\param		command		Command line without "$" and newline
+	\param		handler		Called with the reply, may be empty
+	\brief		Queues a command; it is sent as soon as the window allows
+*/
+void Link::Queue (const std::string &command, ReplyHandler handler)
+{
+	Request request;
+
+	request.command = command;
+	request.handler = std::move (handler);
+	if (!IsOpen ())
+	{
+		Fail (request, "closed");
+		return;
+	}
+	waiting.push_back (std::move (request));
+	Fill ();
+}
+
+/*!
+	\fn			bool Link::OnReadable ()
+	\return		Returns false once the link closed
+	\brief		Frames the received bytes into reply lines
+*/
+bool Link::OnReadable ()
+{
+	char chunk[READ_CHUNK];
+	ssize_t count = 0;
+	ssize_t i = 0;
+
+	while (IsOpen ())
+	{
+		count = read (fd, chunk, sizeof (chunk));
+		if (count < 0)
+		{
+			if ((errno == EAGAIN) || (errno == EINTR))
+			{
+				return true;
+			}
+			Close ("read failed");
+			return false;
+		}
+		if (count == 0)
+		{
+			Close ("closed by the lock");
+			return false;
+		}
+		for (i = 0; i < count; i++)
+		{
+			if (!inLine)
+			{
+				if (chunk[i] == '$')
+				{
+					inLine = true;
+					rx.clear ();
+				}
+			}
+			else if (chunk[i] == '\n')
+			{
+				inLine = false;
+				Line (rx);
+			}
+			else if (chunk[i] != '\r')
+			{
+				if (rx.size () >= MAX_LINE)
+				{
+					inLine = false;
+					continue;
+				}
+				rx.push_back (chunk[i]);
+			}
+		}
+	}
+	return false;
+}
+
+/*!
+	\fn			bool Link::OnWritable ()
+	\return		Returns false once the link closed
+	\brief		Writes as much of the queued lines as the port takes
+*/
+bool Link::OnWritable ()
+{
+	ssize_t count = 0;
+
+	while (IsOpen () && !tx.empty ())
+	{
+		count = write (fd, tx.data (), tx.size ());
+		if (count < 0)
+		{
+			if ((errno == EAGAIN) || (errno == EINTR))
+			{
+				return true;
+			}
+			Close ("write failed");
+			return false;
+		}
+		tx.erase (0, (size_t)count);
+	}
+	return IsOpen ();
+}
+
+/*!
+	\fn			void Link::Expire (Clock::time_point now)
+	\param		now		Current time
+	\brief		Fails the commands in flight if the oldest one timed out
+*/
+void Link::Expire (Clock::time_point now)
+{
+	bool wasPipe = false;
+
+	if (inFlight.empty () || (now - inFlight.front ().sentAt < timeout))
+	{
+		return;
+	}
+
+	wasPipe = !isPipelined;
+	std::deque<Request> expired;
+	expired.swap (inFlight);
+	for (Request &request : expired)
+	{
+		Fail (request, "timeout");
+	}
+	if (wasPipe)
+	{
+		Close ("no reply to PIPE");
+		return;
+	}
+	Resync ();
+	Fill ();
+}
+
+/*!
+	\fn			void Link::Close (const char *reason)
+	\param		reason	Error given to every command still queued
+*/
+void Link::Close (const char *reason)
+{
+	if (fd >= 0)
+	{
+		close (fd);
+		fd = -1;
+	}
+	tx.clear ();
+
+	/* The handlers may queue more commands, which fail at once */
+	std::deque<Request> dropped;
+	dropped.swap (inFlight);
+	dropped.insert (dropped.end (), std::make_move_iterator (waiting.begin ()),
+			std::make_move_iterator (waiting.end ()));
+	waiting.clear ();
+	for (Request &request : dropped)
+	{
+		Fail (request, reason);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Link::Fill ()
+	\brief		Moves commands from the queue into flight while the window,
+				one before the link is pipelined, has room
+*/
+void Link::Fill ()
+{
+	size_t limit = isPipelined ? window : 1;
+
+	while (IsOpen () && !waiting.empty () && (inFlight.size () < limit))
+	{
+		inFlight.push_back (std::move (waiting.front ()));
+		waiting.pop_front ();
+		inFlight.back ().sentAt = Clock::now ();
+		tx += '$';
+		tx += inFlight.back ().command;
+		tx += '\n';
+	}
+}
+
+/*!
+	\fn			void Link::Line (const std::string &line)
+	\param		line	Reply line without "$" and line ending
+	\brief		Adds a line to the oldest command in flight; "END" completes it
+*/
+void Link::Line (const std::string &line)
+{
+	if (inFlight.empty ())
+	{
+		return;
+	}
+
+	Request &front = inFlight.front ();
+	if (front.isResync)
+	{
+		if (line == "PONG")
+		{
+			front.sawPong = true;
+		}
+		else if ((line == "END") && front.sawPong)
+		{
+			inFlight.pop_front ();
+			Fill ();
+		}
+		return;
+	}
+	if (line != "END")
+	{
+		front.reply.lines.push_back (line);
+		return;
+	}
+
+	Request done = std::move (front);
+	inFlight.pop_front ();
+	Complete (done);
+	Fill ();
+}
+
+/*!
+	\fn			void Link::Complete (Request &request)
+	\brief		Hands a complete reply to the handler of its command
+*/
+void Link::Complete (Request &request)
+{
+	completed++;
+	request.reply.ok = true;
+	if (request.handler)
+	{
+		request.handler (request.reply);
+	}
+}
+
+/*!
+	\fn			void Link::Fail (Request &request, const char *reason)
+	\brief		Tells the handler of a command it will get no reply
+*/
+void Link::Fail (Request &request, const char *reason)
+{
+	if (request.isResync)
+	{
+		return;
+	}
+	failed++;
+	request.reply.ok = false;
+	request.reply.error = reason;
+	if (request.handler)
+	{
+		request.handler (request.reply);
+	}
+}
+
+/*!
+	\fn			void Link::Resync ()
+	\brief		Puts a "$PING" in front of the queue to find the end of the
+				late replies
+*/
+void Link::Resync ()
+{
+	Request request;
+
+	request.command = "PING";
+	request.isResync = true;
+	waiting.push_front (std::move (request));
+}
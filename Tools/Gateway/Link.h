@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		Link.h
+	\date		October 19th, 2026
+	\brief		One serial link to a lock. Commands are sent as "$NAME args\n"
+				lines and up to a window of them are kept in flight; the lock
+				queues them (PROTOCOL_QUEUE) and, once the link was switched
+				to "$PIPE 1", ends the replies of every command with "$END",
+				which is how they are matched to their command.
+
+				A Link is owned by the epoll thread of the Gateway and is not
+				thread-safe.
+*/
+//------------------------------------------------------------------------------
+#ifndef GATEWAY_LINK_H_
+#define GATEWAY_LINK_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <string>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		Reply
+	\brief		Outcome of one command: the reply lines without their "$" and
+				line ending, or the reason there are none
+*/
+struct Reply
+{
+	bool ok = false;
+	std::string error;
+	std::vector<std::string> lines;
+};
+
+/*!
+	\typedef	ReplyHandler
+	\brief		Called on the epoll thread once the command completed
+*/
+typedef std::function<void (const Reply &reply)> ReplyHandler;
+
+/*!
+	\typedef	Clock
+	\brief		Clock of the timeouts
+*/
+typedef std::chrono::steady_clock Clock;
+
+//------------------------------------------------------------------------------
+// Classes
+//------------------------------------------------------------------------------
+/*!
+	\class		Link
+	\brief		Framing, pipelining and timeouts of one lock
+*/
+class Link
+{
+public:
+	Link (int fd, const std::string &name, size_t window, std::chrono::milliseconds timeout);
+	~Link ();
+
+	Link (const Link &) = delete;
+	Link &operator= (const Link &) = delete;
+
+	int Fd () const { return fd; }
+	const std::string &Name () const { return name; }
+	bool IsOpen () const { return fd >= 0; }
+	bool WantsWrite () const { return !tx.empty (); }
+
+	void Queue (const std::string &command, ReplyHandler handler);
+	bool OnReadable ();
+	bool OnWritable ();
+	void Expire (Clock::time_point now);
+	void Close (const char *reason);
+
+	uint64_t Completed () const { return completed; }
+	uint64_t Failed () const { return failed; }
+
+private:
+	/*!
+		\struct		Request
+		\brief		A command waiting to be sent or for its "$END"
+	*/
+	struct Request
+	{
+		std::string command;
+		ReplyHandler handler;
+		Reply reply;
+		Clock::time_point sentAt;
+		bool isResync = false;
+		bool sawPong = false;
+	};
+
+	void Fill ();
+	void Line (const std::string &line);
+	void Complete (Request &request);
+	void Fail (Request &request, const char *reason);
+	void Resync ();
+
+	int fd;
+	std::string name;
+	size_t window;
+	std::chrono::milliseconds timeout;
+	bool isPipelined = false;
+
+	std::deque<Request> waiting;
+	std::deque<Request> inFlight;
+	std::string tx;
+	std::string rx;
+	bool inLine = false;
+
+	uint64_t completed = 0;
+	uint64_t failed = 0;
+};
+
+#endif /* GATEWAY_LINK_H_ */
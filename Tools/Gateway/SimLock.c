@@ -0,0 +1,213 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		SimLock.c
+	\date		October 19th, 2026
+	\brief		A simulated lock on a pseudo-terminal: the real firmware runs
+				on the simulated HAL, the bytes read from the terminal arrive
+				as Bluetooth bytes and every byte the firmware sends is
+				written back. One process per lock, so a fleet of them loads
+				the gateway the way separate boards would.
+
+				Usage:
+					simlock <tty>
+
+				Virtual time runs STEP_US per firmware step while there is
+				traffic and IDLE_US per idle poll, so the lock clocks stay
+				roughly in step with the wall clock. The wire time of the
+				baud rate is not modelled. The lock exits when the other end
+				of the terminal goes away.
+
+				The gateway stands for the installer at the lock: every read
+				counts as the master password just typed on the keypad, so
+				the Bluetooth link may provision it.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "SimHAL.h"
+#include "SmartLock.h"
+#include "Protocol.h"
+/* After the device header: termios.h defines CR0, CR1... as macros */
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <termios.h>
+#include <unistd.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		STEPS
+	\brief		Firmware steps after every read, enough to run PROTOCOL_QUEUE
+				command lines
+*/
+#define		STEPS				8u
+
+/*!
+	\def		STEP_US
+	\brief		Virtual time per firmware step
+*/
+#define		STEP_US				1000u
+
+/*!
+	\def		IDLE_MS
+	\brief		Longest wait for the terminal
+*/
+#define		IDLE_MS				100
+
+/*!
+	\def		IDLE_US
+	\brief		Virtual time of an idle wait
+*/
+#define		IDLE_US				(IDLE_MS * 1000u)
+
+/*!
+	\def		TX_SIZE
+	\brief		Firmware output buffered between writes
+*/
+#define		TX_SIZE				4096u
+
+//------------------------------------------------------------------------------
+// Local Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		tx
+	\brief		Firmware output not written yet
+*/
+static uint8_t tx[TX_SIZE];
+
+/*!
+	\var		txCount
+	\brief		Bytes in tx
+*/
+static uint32_t txCount = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void vfnTx (uint8_t value)
+	\brief		Collects a byte the firmware sent; a full buffer drops it, as
+				a Bluetooth module would
+*/
+static void vfnTx (uint8_t value)
+{
+	if (txCount < TX_SIZE)
+	{
+		tx[txCount++] = value;
+	}
+}
+
+/*!
+	\fn			static int ifnFlush (int fd)
+	\return		Returns 0, or -1 if the terminal is gone
+	\brief		Writes the collected output, waiting while the terminal is full
+*/
+static int ifnFlush (int fd)
+{
+	struct pollfd pfd = {fd, POLLOUT, 0};
+	uint32_t done = 0;
+	ssize_t written;
+
+	while (done < txCount)
+	{
+		written = write (fd, &tx[done], txCount - done);
+		if (written > 0)
+		{
+			done += (uint32_t)written;
+		}
+		else if ((written < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+		{
+			poll (&pfd, 1, IDLE_MS);
+		}
+		else
+		{
+			return -1;
+		}
+	}
+	txCount = 0;
+	return 0;
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	struct pollfd pfd;
+	struct termios tty;
+	uint8_t buffer[256];
+	ssize_t count;
+	uint32_t i;
+	int fd;
+
+	if (argc != 2)
+	{
+		fprintf (stderr, "usage: %s <tty>\n", argv[0]);
+		return 2;
+	}
+	fd = open (argv[1], O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if (fd < 0)
+	{
+		perror (argv[1]);
+		return 1;
+	}
+	if (tcgetattr (fd, &tty) == 0)
+	{
+		cfmakeraw (&tty);
+		tcsetattr (fd, TCSANOW, &tty);
+	}
+
+	Sim_vfnReset ();
+	Sim_vfnSetTxHook (vfnTx);
+	SmartLock_vfnInit ();
+	txCount = 0;
+
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	for (;;)
+	{
+		count = read (fd, buffer, sizeof (buffer));
+		if (count > 0)
+		{
+			Protocol_vfnAuthorize ();
+			for (i = 0; i < (uint32_t)count; i++)
+			{
+				Sim_vfnUartRx (buffer[i]);
+				Sim_vfnAdvance (STEP_US / 8u);
+			}
+			for (i = 0; i < STEPS; i++)
+			{
+				SmartLock_vfnStep ();
+				Sim_vfnAdvance (STEP_US);
+			}
+			if (ifnFlush (fd) < 0)
+			{
+				break;
+			}
+			continue;
+		}
+		if ((count == 0) || ((errno != EAGAIN) && (errno != EINTR)))
+		{
+			break;
+		}
+		if (poll (&pfd, 1, IDLE_MS) == 0)
+		{
+			SmartLock_vfnStep ();
+			Sim_vfnAdvance (IDLE_US);
+			if (ifnFlush (fd) < 0)
+			{
+				break;
+			}
+		}
+		else if (pfd.revents & (POLLHUP | POLLERR))
+		{
+			break;
+		}
+	}
+	close (fd);
+	return 0;
+}
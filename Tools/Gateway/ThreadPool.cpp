@@ -0,0 +1,88 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		ThreadPool.cpp
+	\date		October 19th, 2026
+	\brief		Fixed pool of worker threads
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include "ThreadPool.h"
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			ThreadPool::ThreadPool (size_t threads)
+	\param		threads		Workers, at least one
+*/
+ThreadPool::ThreadPool (size_t threads)
+{
+	size_t i = 0;
+
+	if (!threads)
+	{
+		threads = 1;
+	}
+	for (i = 0; i < threads; i++)
+	{
+		workers.emplace_back (&ThreadPool::Work, this);
+	}
+}
+
+/*!
+	\fn			ThreadPool::~ThreadPool ()
+	\brief		Runs what is still posted, then joins the workers
+*/
+ThreadPool::~ThreadPool ()
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		isStopping = true;
+	}
+	ready.notify_all ();
+	for (std::thread &worker : workers)
+	{
+		worker.join ();
+	}
+}
+
+/*!
+	\fn			void ThreadPool::Post (std::function<void ()> task)
+	\param		task	Work to run on a worker
+*/
+void ThreadPool::Post (std::function<void ()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock (mutex);
+		tasks.push_back (std::move (task));
+	}
+	ready.notify_one ();
+}
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void ThreadPool::Work ()
+	\brief		A worker: takes the oldest task until stopped and drained
+*/
+void ThreadPool::Work ()
+{
+	std::function<void ()> task;
+
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> lock (mutex);
+			ready.wait (lock, [this] { return isStopping || !tasks.empty (); });
+			if (tasks.empty ())
+			{
+				return;
+			}
+			task = std::move (tasks.front ());
+			tasks.pop_front ();
+		}
+		task ();
+	}
+}
@@ -0,0 +1,52 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		ThreadPool.h
+	\date		October 19th, 2026
+	\brief		Fixed pool of worker threads. The epoll thread only frames
+				replies; everything that parses or aggregates them is posted
+				here so a slow report never stalls the links.
+*/
+//------------------------------------------------------------------------------
+#ifndef GATEWAY_THREADPOOL_H_
+#define GATEWAY_THREADPOOL_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//------------------------------------------------------------------------------
+// Classes
+//------------------------------------------------------------------------------
+/*!
+	\class		ThreadPool
+	\brief		Runs posted tasks in order of posting on any free worker
+*/
+class ThreadPool
+{
+public:
+	explicit ThreadPool (size_t threads);
+	~ThreadPool ();
+
+	ThreadPool (const ThreadPool &) = delete;
+	ThreadPool &operator= (const ThreadPool &) = delete;
+
+	void Post (std::function<void ()> task);
+	size_t Size () const { return workers.size (); }
+
+private:
+	void Work ();
+
+	std::vector<std::thread> workers;
+	std::mutex mutex;
+	std::condition_variable ready;
+	std::deque<std::function<void ()>> tasks;
+	bool isStopping = false;
+};
+
+#endif /* GATEWAY_THREADPOOL_H_ */
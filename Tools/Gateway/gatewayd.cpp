@@ -0,0 +1,220 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		gatewayd.cpp
+	\date		October 19th, 2026
+	\brief		Gateway daemon for a fleet of locks on serial ports. The
+				operations are read from stdin, one per line, so the daemon
+				can be driven by a terminal, a script or a socket wrapper.
+
+				Usage:
+					gatewayd [options] <device>...
+
+				Options:
+					--threads <n>	parser threads (default 2)
+					--window <n>	commands in flight per lock, 1 to 4 (default 4)
+					--timeout <ms>	reply timeout (default 2000)
+					--baud <rate>	serial baud rate (default 9600)
+
+				Operations:
+					sweep				status of every lock
+					pull				crash record and watchdog history
+					push <file>			write a user table (see Fleet.cpp)
+					send all|<n> <cmd>	send a command line to one or all locks
+					links				list the locks
+					quit
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "Fleet.h"
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void Report (const Gateway &gateway, const char *operation, const std::vector<LockResult> &results, double seconds, bool isVerbose)
+	\brief		Prints one line per lock and a summary line
+*/
+static void Report (const Gateway &gateway, const char *operation,
+		const std::vector<LockResult> &results, double seconds, bool isVerbose)
+{
+	size_t failures = 0;
+
+	for (const LockResult &result : results)
+	{
+		failures += result.ok ? 0 : 1;
+		printf ("%zu %s %s %.1fms", result.link,
+				(result.link < gateway.LinkCount ()) ? gateway.LinkName (result.link).c_str () : "-",
+				result.ok ? "ok" : "FAIL", result.ms);
+		if (!result.ok)
+		{
+			printf (" %s", result.error.c_str ());
+		}
+		for (const auto &field : result.fields)
+		{
+			printf (" %s=%s", field.first.c_str (), field.second.c_str ());
+		}
+		printf ("\n");
+		if (isVerbose)
+		{
+			for (const std::string &line : result.lines)
+			{
+				printf ("  %s\n", line.c_str ());
+			}
+		}
+	}
+	printf ("%s locks=%zu failures=%zu seconds=%.3f locks/s=%.1f\n", operation,
+			results.size (), failures, seconds, seconds > 0.0 ? results.size () / seconds : 0.0);
+	fflush (stdout);
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	GatewayOptions options;
+	std::vector<std::string> devices;
+	size_t threads = 2;
+	int argi = 1;
+
+	for (argi = 1; argi < argc; argi++)
+	{
+		if (!strcmp (argv[argi], "--threads") && (argi + 1 < argc))
+		{
+			threads = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--window") && (argi + 1 < argc))
+		{
+			options.window = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--timeout") && (argi + 1 < argc))
+		{
+			options.timeout = std::chrono::milliseconds (strtoul (argv[++argi], NULL, 0));
+		}
+		else if (!strcmp (argv[argi], "--baud") && (argi + 1 < argc))
+		{
+			options.baud = strtoul (argv[++argi], NULL, 0);
+		}
+		else if (argv[argi][0] == '-')
+		{
+			fprintf (stderr, "usage: %s [--threads n] [--window n] [--timeout ms] [--baud rate] <device>...\n",
+					argv[0]);
+			return 2;
+		}
+		else
+		{
+			devices.push_back (argv[argi]);
+		}
+	}
+
+	try
+	{
+		Gateway gateway (options);
+		ThreadPool pool (threads);
+		Fleet fleet (gateway, pool);
+		std::string line;
+
+		for (const std::string &device : devices)
+		{
+			gateway.OpenDevice (device);
+		}
+		gateway.Start ();
+
+		while (std::getline (std::cin, line))
+		{
+			std::istringstream words (line);
+			std::string operation;
+			auto start = Clock::now ();
+			std::vector<LockResult> results;
+			bool isVerbose = false;
+
+			words >> operation;
+			if (operation.empty ())
+			{
+				continue;
+			}
+			else if (operation == "quit")
+			{
+				break;
+			}
+			else if (operation == "links")
+			{
+				for (size_t i = 0; i < gateway.LinkCount (); i++)
+				{
+					printf ("%zu %s\n", i, gateway.LinkName (i).c_str ());
+				}
+				fflush (stdout);
+				continue;
+			}
+			else if (operation == "sweep")
+			{
+				results = fleet.StatusSweep (fleet.All ());
+			}
+			else if (operation == "pull")
+			{
+				results = fleet.PullLogs (fleet.All ());
+				isVerbose = true;
+			}
+			else if (operation == "push")
+			{
+				std::string path;
+				words >> path;
+				std::ifstream table (path);
+				if (!table)
+				{
+					fprintf (stderr, "push: cannot open %s\n", path.c_str ());
+					continue;
+				}
+				try
+				{
+					results = fleet.PushUsers (fleet.All (), Fleet::UserTable (table));
+				}
+				catch (const std::runtime_error &error)
+				{
+					fprintf (stderr, "push: %s: %s\n", path.c_str (), error.what ());
+					continue;
+				}
+			}
+			else if (operation == "send")
+			{
+				std::string target;
+				std::string command;
+				std::vector<size_t> locks;
+
+				words >> target;
+				std::getline (words >> std::ws, command);
+				if (target == "all")
+				{
+					locks = fleet.All ();
+				}
+				else
+				{
+					locks.push_back (strtoul (target.c_str (), NULL, 0));
+				}
+				results = fleet.Send (locks, command);
+				isVerbose = true;
+			}
+			else
+			{
+				fprintf (stderr, "unknown operation: %s\n", operation.c_str ());
+				continue;
+			}
+			Report (gateway, operation.c_str (), results,
+					std::chrono::duration<double> (Clock::now () - start).count (), isVerbose);
+		}
+	}
+	catch (const std::exception &error)
+	{
+		fprintf (stderr, "gatewayd: %s\n", error.what ());
+		return 1;
+	}
+	return 0;
+}
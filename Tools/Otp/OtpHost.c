@@ -0,0 +1,436 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		OtpHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the one-time codes. Hash.c and Otp.c are
+				checked against the vectors of FIPS 180, RFC 4226 and
+				RFC 6238; then Access.c, Entry.c, Otp.c and Protocol.c run
+				unchanged while the harness uploads generators and types
+				their codes between two '#' on the keypad entry:
+				in order, skipped ahead, replayed, out of the window, out of
+				the schedule and around the TOTP time steps, and wrong codes
+				until they are locked out. The harness first checks that the
+				Bluetooth link cannot provision before the master password
+				authorizes it.
+
+				Usage:
+					otphost [--verbose]
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "RTC.h"
+#include "Hash.h"
+#include "Otp.h"
+#include "Access.h"
+#include "Entry.h"
+#include "Protocol.h"
+#include "Timebase.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		RFC_SECRET_SHA1, RFC_SECRET_SHA256
+	\brief		Secrets of the RFC 4226 and RFC 6238 vectors
+*/
+#define		RFC_SECRET_SHA1		"12345678901234567890"
+#define		RFC_SECRET_SHA256	"12345678901234567890123456789012"
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t reference (OTP_KIND kind, const char *secret, uint32_t counter, uint8_t digits)
+	\return		Returns the code a generator with the secret shows
+*/
+static uint32_t reference (OTP_KIND kind, const char *secret, uint32_t counter, uint8_t digits)
+{
+	HASH_HMAC_KEY key;
+
+	Hash_vfnHmacKey (&key, (kind & 1) ? eHASH_SHA256 : eHASH_SHA1, (const uint8_t *)secret,
+			(uint16_t)strlen (secret));
+	return Otp_dwfnCode (&key, counter, digits);
+}
+
+/*!
+	\fn			static uint8_t type (const char *keys)
+	\return		Returns what the lock decides on the last entry the keys
+				complete, 0 if they complete none
+*/
+static uint8_t type (const char *keys)
+{
+	ENTRY entry;
+	uint8_t isCorrect = 0;
+
+	for (; *keys; keys++)
+	{
+		Entry_vfnPut (eENTRY_KEYPAD, (uint8_t)((*keys >= '0' && *keys <= '9') ? *keys - '0' : *keys));
+		if (Entry_bfnTake (&entry))
+		{
+			isCorrect = Access_bfnAuthorize (entry.digits, entry.length);
+		}
+	}
+	return isCorrect;
+}
+
+/*!
+	\fn			static uint8_t enter (uint32_t code)
+	\return		Returns what the lock decides on the code typed as
+				"#digits#"
+*/
+static uint8_t enter (uint32_t code)
+{
+	char keys[OTP_DIGITS + 3];
+
+	snprintf (keys, sizeof (keys), "#%0*u#", (int)OTP_DIGITS, code);
+	return type (keys);
+}
+
+/*!
+	\fn			static void idle (void)
+	\brief		Main loop passes enough for every table to be complete
+*/
+static void idle (void)
+{
+	int i;
+
+	for (i = 0; i < (int)(OTP_SLOTS * OTP_WINDOW); i++)
+	{
+		Otp_vfnTask ();
+	}
+}
+
+/*!
+	\fn			static void upload (const char *secret)
+	\brief		Sends a secret in "$OTP KEY" pieces of up to 20 bytes
+*/
+static void upload (const char *secret)
+{
+	char line[64];
+	size_t length = strlen (secret);
+	size_t done = 0;
+	size_t i;
+	int n;
+
+	while (done < length)
+	{
+		n = snprintf (line, sizeof (line), "OTP KEY ");
+		for (i = 0; (i < 20u) && (done < length); i++, done++)
+		{
+			n += snprintf (&line[n], sizeof (line) - (size_t)n, "%02x", (uint8_t)secret[done]);
+		}
+		Host_pcfnCommand (line, 0);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testAuthorization (void)
+	\brief		Changes from the Bluetooth link are refused until the master
+				password authorizes it, and again once the time is up;
+				queries are always answered. Leaves the link authorized.
+*/
+static void testAuthorization (void)
+{
+	CHECK (!strcmp (Host_pcfnCommand ("USER 5 1234", 0), "USER ERR auth"), "user: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("SCHED 0 CLR", 0), "SCHED ERR auth"), "sched: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("TIME 100", 0), "TIME ERR auth"), "time: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP KEY 3132", 0), "OTP ERR auth"), "otp key: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP ZONE 60", 0), "OTP ERR auth"), "otp zone: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5 H1", 0), "OTP ERR auth"), "otp user: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP CLR", 0), "OTP ERR auth"), "otp clear: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5", 0), "OTP ERR index"), "otp query: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strncmp (Host_pcfnCommand ("USER", 0), "USER n=0 ", 9), "count: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strncmp (Host_pcfnCommand ("SCHED 0", 0), "SCHED 0 open=", 13), "query: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!Host_bRtcIsSet, "time set without authorization");
+
+	Protocol_vfnAuthorize ();
+	CHECK (!strncmp (Host_pcfnCommand ("TIME 100", 0), "TIME s=100 set=1", 16), "authorized: %s", Host_pcfnCommand (NULL, 0));
+	Host_dwNowMs += 60000u;
+	CHECK (!strcmp (Host_pcfnCommand ("TIME 200", 0), "TIME ERR auth"), "expired: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (Host_dwRtcTime == 100u, "time changed after the window");
+
+	Protocol_vfnAuthorize ();
+}
+
+/*!
+	\fn			static void testVectors (void)
+	\brief		FIPS 180 "abc" and the two-block message, RFC 4226 appendix D
+				and RFC 6238 appendix B
+*/
+static void testVectors (void)
+{
+	static const uint32_t hotp[10] =
+	{
+		755224, 287082, 359152, 969429, 338314, 254676, 287922, 162583, 399871, 520489
+	};
+	static const struct
+	{
+		uint64_t time;
+		uint32_t sha1;
+		uint32_t sha256;
+	} totp[] =
+	{
+		{59u, 94287082u, 46119246u},
+		{1111111109u, 7081804u, 68084774u},
+		{1111111111u, 14050471u, 67062674u},
+		{1234567890u, 89005924u, 91819424u},
+		{2000000000u, 69279037u, 90698825u},
+		{20000000000u, 65353130u, 77737706u}
+	};
+	static const char *twoBlocks = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+	HASH_CONTEXT context;
+	uint8_t digest[HASH_MAX_DIGEST];
+	char hex[2 * HASH_MAX_DIGEST + 1];
+	uint32_t i;
+	uint32_t code;
+
+	Hash_vfnStart (&context, eHASH_SHA1);
+	Hash_vfnUpdate (&context, (const uint8_t *)"abc", 3);
+	Hash_vfnFinish (&context, digest);
+	for (i = 0; i < 20u; i++)
+	{
+		sprintf (&hex[2 * i], "%02x", digest[i]);
+	}
+	CHECK (!strcmp (hex, "a9993e364706816aba3e25717850c26c9cd0d89d"), "sha1 abc %s", hex);
+
+	Hash_vfnStart (&context, eHASH_SHA256);
+	Hash_vfnUpdate (&context, (const uint8_t *)twoBlocks, (uint32_t)strlen (twoBlocks));
+	Hash_vfnFinish (&context, digest);
+	for (i = 0; i < 32u; i++)
+	{
+		sprintf (&hex[2 * i], "%02x", digest[i]);
+	}
+	CHECK (!strcmp (hex, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"),
+			"sha256 two blocks %s", hex);
+
+	for (i = 0; i < 10u; i++)
+	{
+		code = reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, i, 6);
+		CHECK (code == hotp[i], "hotp %u: %06u", i, code);
+	}
+	for (i = 0; i < sizeof (totp) / sizeof (totp[0]); i++)
+	{
+		code = reference (eOTP_TOTP_SHA1, RFC_SECRET_SHA1, (uint32_t)(totp[i].time / OTP_PERIOD), 8);
+		CHECK (code == totp[i].sha1, "totp sha1 %llu: %08u", (unsigned long long)totp[i].time, code);
+		code = reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, (uint32_t)(totp[i].time / OTP_PERIOD), 8);
+		CHECK (code == totp[i].sha256, "totp sha256 %llu: %08u", (unsigned long long)totp[i].time, code);
+	}
+}
+
+/*!
+	\fn			static void testHotp (void)
+	\brief		Codes in order, skipped ahead, replayed and beyond the window;
+				the table refilled by the main loop between entries
+*/
+static void testHotp (void)
+{
+	OTP_STATS before;
+	OTP_STATS after;
+	char line[16];
+	uint32_t counter;
+
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5 H1", 0), "OTP ERR key"), "no key: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP KEY 3g", 0), "OTP ERR format"), "bad hex: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP KEY 313", 0), "OTP ERR format"), "odd hex: %s", Host_pcfnCommand (NULL, 0));
+	upload (RFC_SECRET_SHA1);
+	CHECK (!strcmp (Host_pcfnCommand (NULL, 0), "OTP KEY 20"), "key: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5 H3", 0), "OTP ERR format"), "kind: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5 H1", 0), "OTP OK"), "add: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5 H1", 0), "OTP ERR key"), "key kept: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP", 0), "OTP n=1 max=16 zone=0"), "count: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 4", 0), "OTP ERR index"), "not otp: %s", Host_pcfnCommand (NULL, 0));
+
+	idle ();
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5", 0), "OTP 5 H1 counter=0 ready=8"), "state: %s", Host_pcfnCommand (NULL, 0));
+	Otp_vfnGetStats (&before);
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "code 0");
+	idle ();
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "code 0 replayed");
+	idle ();
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 3, OTP_DIGITS)), "code 3, skipping two");
+	idle ();
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 2, OTP_DIGITS)), "code 2 after 3");
+	idle ();
+	Otp_vfnGetStats (&after);
+	CHECK (after.refills == before.refills, "refills on the critical path: %u", after.refills - before.refills);
+	CHECK (after.accepted == before.accepted + 2u, "accepted: %u", after.accepted - before.accepted);
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5", 0), "OTP 5 H1 counter=4 ready=8"), "resync: %s", Host_pcfnCommand (NULL, 0));
+
+	/* Without the first '#' the code ends as a pin after four digits */
+	snprintf (line, sizeof (line), "%0*u", (int)OTP_DIGITS, reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 4, OTP_DIGITS));
+	Otp_vfnGetStats (&before);
+	CHECK (!type (line), "code typed as a pin");
+	CHECK (!type ("#"), "rest of the code");
+	Otp_vfnGetStats (&after);
+	CHECK (after.lookups == before.lookups, "a pin checked as a code: %u", after.lookups - before.lookups);
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 5", 0), "OTP 5 H1 counter=4 ready=8"), "unused: %s", Host_pcfnCommand (NULL, 0));
+
+	/* Code 12 is past the window of 4..11, unless it happens to repeat one in it */
+	for (counter = 4; counter < 12u; counter++)
+	{
+		if (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, counter, OTP_DIGITS) == reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 12, OTP_DIGITS))
+		{
+			break;
+		}
+	}
+	if (counter == 12u)
+	{
+		CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 12, OTP_DIGITS)), "code 12 out of the window");
+	}
+
+	/* Typed right after an accept: the missing entries computed on the spot */
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 4, OTP_DIGITS)), "code 4");
+	Otp_vfnGetStats (&before);
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 5, OTP_DIGITS)), "code 5 with the table short");
+	Otp_vfnGetStats (&after);
+	CHECK (after.refills == before.refills + 1u, "refills: %u", after.refills - before.refills);
+
+	/* A fixed pin for the user frees the slot */
+	CHECK (!strcmp (Host_pcfnCommand ("USER 5 1234", 0), "USER OK"), "replace: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP", 0), "OTP n=0 max=16 zone=0"), "freed: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 6, OTP_DIGITS)), "code of a freed slot");
+}
+
+/*!
+	\fn			static void testLockout (void)
+	\brief		Wrong codes in a row lock the codes out, the right one
+				included, for a time that doubles with every further wrong
+				code; a wrong code with no generator open does not count
+*/
+static void testLockout (void)
+{
+	uint32_t wrong;
+	uint32_t counter;
+	uint32_t i;
+
+	upload (RFC_SECRET_SHA1);
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 8 H1", 0), "OTP OK"), "add: %s", Host_pcfnCommand (NULL, 0));
+	idle ();
+
+	/* A code none of the window 0..7 shows */
+	for (wrong = 0, counter = 0; counter < OTP_WINDOW; counter++)
+	{
+		if (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, counter, OTP_DIGITS) == wrong)
+		{
+			wrong++;
+			counter = (uint32_t)-1;
+		}
+	}
+
+	for (i = 0; i < 5u; i++)
+	{
+		CHECK (!enter (wrong), "wrong code %u", i);
+	}
+	CHECK (strstr (Host_pcfnCommand ("OTP STATS", 0), " miss=5"), "misses: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "code 0 locked out");
+	Host_dwNowMs += 29999u;
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "code 0 still locked out");
+	Host_dwNowMs += 1u;
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "code 0 after the lockout");
+	idle ();
+
+	/* The sixth wrong code in a row locks out twice as long */
+	for (i = 0; i < 6u; i++)
+	{
+		Host_dwNowMs += 30000u;
+		CHECK (!enter (wrong), "wrong code %u", i);
+	}
+	Host_dwNowMs += 59999u;
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 1, OTP_DIGITS)), "code 1 locked out");
+	Host_dwNowMs += 1u;
+	CHECK (enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 1, OTP_DIGITS)), "code 1 after the lockout");
+
+	/* The time spent waiting closed the authorization as well */
+	Protocol_vfnAuthorize ();
+	CHECK (!strcmp (Host_pcfnCommand ("USER 8 DEL", 0), "USER OK"), "delete: %s", Host_pcfnCommand (NULL, 0));
+	for (i = 0; i < 6u; i++)
+	{
+		CHECK (!enter (wrong), "no generator %u", i);
+	}
+	CHECK (strstr (Host_pcfnCommand ("OTP STATS", 0), " miss=0"), "no generator: %s", Host_pcfnCommand (NULL, 0));
+}
+
+/*!
+	\fn			static void testTotp (void)
+	\brief		Steps around the current one, replays, the time zone and an
+				unset clock
+*/
+static void testTotp (void)
+{
+	const uint32_t utc = 1111111111u;
+	const uint32_t step = utc / OTP_PERIOD;
+	char line[32];
+	uint32_t i;
+
+	Host_bRtcIsSet = 0;
+	CHECK (!strcmp (Host_pcfnCommand ("OTP ZONE 900", 0), "OTP ERR format"), "zone range: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP ZONE -90", 0), "OTP OK"), "zone: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP", 0), "OTP n=0 max=16 zone=-90"), "zone: %s", Host_pcfnCommand (NULL, 0));
+	upload (RFC_SECRET_SHA256);
+	CHECK (!strcmp (Host_pcfnCommand (NULL, 0), "OTP KEY 32"), "key: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 6 T256", 0), "OTP OK"), "add: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step, OTP_DIGITS)), "clock unset");
+
+	/* Local time is 90 minutes behind UTC */
+	RTC_vfnSetTime (utc - 90u * 60u);
+	idle ();
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 6", 0), "OTP 6 T256 counter=37037036 ready=8"), "table: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step, OTP_DIGITS)), "current step");
+	CHECK (!enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step, OTP_DIGITS)), "current step replayed");
+	CHECK (!enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step - 1u, OTP_DIGITS)), "step before a used one");
+	CHECK (enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step + 1u, OTP_DIGITS)), "next step, clock skew");
+	CHECK (!enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step + 2u, OTP_DIGITS)), "two steps ahead");
+
+	Host_dwRtcTime += 2u * OTP_PERIOD;
+	idle ();
+	CHECK (enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step + 2u, OTP_DIGITS)), "two steps later");
+
+	/* A wrong zone moves the steps an hour away */
+	Host_pcfnCommand ("OTP ZONE 0", 0);
+	idle ();
+	CHECK (!enter (reference (eOTP_TOTP_SHA256, RFC_SECRET_SHA256, step + 3u, OTP_DIGITS)), "wrong zone");
+	Host_pcfnCommand ("OTP ZONE -90", 0);
+
+	/* A user whose schedule is closed does not use up the code */
+	Host_pcfnCommand ("SCHED 0 CLR", 0);
+	upload (RFC_SECRET_SHA1);
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 7 H1 0", 0), "OTP OK"), "scheduled: %s", Host_pcfnCommand (NULL, 0));
+	idle ();
+	CHECK (!enter (reference (eOTP_HOTP_SHA1, RFC_SECRET_SHA1, 0, OTP_DIGITS)), "schedule closed");
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 7", 0), "OTP 7 H1 counter=0 ready=8"), "unused: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("USER 7 DEL", 0), "USER OK"), "delete: %s", Host_pcfnCommand (NULL, 0));
+
+	/* Every slot taken, user 6 holds one */
+	for (i = 1; i < OTP_SLOTS; i++)
+	{
+		upload (RFC_SECRET_SHA1);
+		snprintf (line, sizeof (line), "OTP %u H1", 100u + i);
+		CHECK (!strcmp (Host_pcfnCommand (line, 0), "OTP OK"), "slot %u: %s", i, Host_pcfnCommand (NULL, 0));
+	}
+	upload (RFC_SECRET_SHA1);
+	CHECK (!strcmp (Host_pcfnCommand ("OTP 99 H1", 0), "OTP ERR full"), "full: %s", Host_pcfnCommand (NULL, 0));
+}
+
+int main (int argc, char **argv)
+{
+	Host_vfnInit (argc, argv);
+	Protocol_vfnDriverInit (Host_vfnIgnoreByte);
+	Entry_vfnInit ();
+	Access_vfnInit ();
+
+	testAuthorization ();
+	testVectors ();
+	testHotp ();
+	testLockout ();
+	testTotp ();
+
+	return Host_ifnResult ();
+}
@@ -0,0 +1,332 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		PortHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the pin interrupt service. PORT.c runs
+				unchanged on faked PORTB to PORTE flags and GPIO input levels:
+				the harness registers pins, raises flags, runs the shared
+				handler and PORT_vfnTask, and checks the pin found for every
+				flag bit, the order pins are called back in, the levels
+				snapshot they get, the debounce and the re-arm of level and
+				debounced pins.
+
+				Usage:
+					porthost [--verbose]
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MKL27Z644.h"
+#include "PORT.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_CALLS
+	\brief		Callbacks recorded per step
+*/
+#define		MAX_CALLS			40
+
+/*!
+	\def		PDIR
+	\brief		Faked input levels of PORTB to PORTE by index, read-only to
+				the firmware
+*/
+#define		PDIR(index)			(*(volatile uint32_t *)&Host_gpio[index].PDIR)
+
+/*!
+	\def		IRQC
+	\brief		Interrupt configuration of a faked pin
+*/
+#define		IRQC(port, pin)		((Host_port[(port) - ePORTB].PCR[pin] & PORT_PCR_IRQC_MASK) >> PORT_PCR_IRQC_SHIFT)
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		CALL
+	\brief		A recorded callback
+*/
+typedef struct
+{
+	uint8_t pin;
+	uint32_t levels;
+} CALL;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+PORT_Type Host_port[4];
+GPIO_Type Host_gpio[4];
+NVIC_Type Host_nvic;
+
+static CALL calls[MAX_CALLS];
+static uint8_t callCount = 0;
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void record (uint8_t pin, uint32_t levels)
+	\brief		Pin callback: keeps the call
+*/
+static void record (uint8_t pin, uint32_t levels)
+{
+	if (callCount < MAX_CALLS)
+	{
+		calls[callCount].pin = pin;
+		calls[callCount].levels = levels;
+		callCount++;
+	}
+	if (Host_bVerbose)
+	{
+		printf ("  pin %u levels %08x\n", pin, levels);
+	}
+}
+
+/*!
+	\fn			static void strobe (uint8_t pin, uint32_t levels)
+	\brief		Pin callback of the PORTD rows: records the call, then moves
+				the faked columns on as the FlexIO strobe would
+*/
+static void strobe (uint8_t pin, uint32_t levels)
+{
+	record (pin, levels);
+	PDIR (2) ^= 0xF0u;
+}
+
+/*!
+	\fn			static void interrupt (uint32_t b, uint32_t c, uint32_t d, uint32_t e)
+	\brief		Raises the flags of PORTB to PORTE and runs the shared handler
+*/
+static void interrupt (uint32_t b, uint32_t c, uint32_t d, uint32_t e)
+{
+	Host_port[0].ISFR = b;
+	Host_port[1].ISFR = c;
+	Host_port[2].ISFR = d;
+	Host_port[3].ISFR = e;
+	callCount = 0;
+	PORTB_PORTC_PORTD_PORTE_DriverIRQHandler ();
+}
+
+/*!
+	\fn			static void task (uint32_t ms)
+	\brief		Moves the time to ms and runs PORT_vfnTask
+*/
+static void task (uint32_t ms)
+{
+	Host_dwNowMs = ms;
+	callCount = 0;
+	PORT_vfnTask ();
+}
+
+/*!
+	\fn			static void reset (void)
+	\brief		Frees every pin and clears the faked registers
+*/
+static void reset (void)
+{
+	PORTS port;
+	uint8_t pin;
+
+	for (port = ePORTB; port <= ePORTE; port++)
+	{
+		for (pin = 0; pin < 32u; pin++)
+		{
+			PORT_vfnUnregister (port, (PINS)pin);
+		}
+	}
+	memset (Host_port, 0, sizeof (Host_port));
+	memset (Host_gpio, 0, sizeof (Host_gpio));
+	memset (&Host_nvic, 0, sizeof (Host_nvic));
+	callCount = 0;
+}
+
+//------------------------------------------------------------------------------
+// Tests
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testRegister (void)
+	\brief		PORTA and missing callbacks are refused, the pin is armed with
+				its mode and the rest of its PCR kept, the vector enabled,
+				and no more than PORT_MAX_PINS pins are taken
+*/
+static void testRegister (void)
+{
+	uint8_t pin;
+
+	reset ();
+	CHECK (!PORT_bfnRegister (ePORTA, ePIN1, ePORT_RISING, 0, record), "PORTA registered");
+	CHECK (!PORT_bfnRegister (ePORTB, ePIN1, ePORT_RISING, 0, 0), "no callback registered");
+
+	Host_port[2].PCR[2] = PORT_PCR_MUX (1) | PORT_PCR_PE_MASK;
+	CHECK (PORT_bfnRegister (ePORTD, ePIN2, ePORT_RISING, 0, record), "PTD2 refused");
+	CHECK (IRQC (ePORTD, 2) == ePORT_RISING, "PTD2 IRQC %u", IRQC (ePORTD, 2));
+	CHECK ((Host_port[2].PCR[2] & (PORT_PCR_MUX_MASK | PORT_PCR_PE_MASK)) == (PORT_PCR_MUX (1) | PORT_PCR_PE_MASK),
+			"PTD2 PCR %08x", Host_port[2].PCR[2]);
+	CHECK (Host_nvic.ISER[0] & (1u << PORTB_PORTC_PORTD_PORTE_IRQn), "vector not enabled");
+
+	/* Registering a pin again changes it in place */
+	CHECK (PORT_bfnRegister (ePORTD, ePIN2, ePORT_FALLING, 0, record), "PTD2 change refused");
+	CHECK (IRQC (ePORTD, 2) == ePORT_FALLING, "PTD2 IRQC %u", IRQC (ePORTD, 2));
+
+	for (pin = 0; pin < PORT_MAX_PINS - 1u; pin++)
+	{
+		CHECK (PORT_bfnRegister (ePORTC, (PINS)pin, ePORT_RISING, 0, record), "PTC%u refused", pin);
+	}
+	CHECK (!PORT_bfnRegister (ePORTE, ePIN0, ePORT_RISING, 0, record), "pin past PORT_MAX_PINS registered");
+	PORT_vfnUnregister (ePORTC, ePIN0);
+	CHECK (IRQC (ePORTC, 0) == 0, "PTC0 still armed");
+	CHECK (PORT_bfnRegister (ePORTE, ePIN0, ePORT_RISING, 0, record), "freed entry not reused");
+}
+
+/*!
+	\fn			static void testDispatch (void)
+	\brief		Every flag bit finds its pin, pending pins are called back
+				lowest port and pin first, a flag of an unregistered pin is
+				only cleared, and every callback of a port gets the levels
+				read once with its flags
+*/
+static void testDispatch (void)
+{
+	uint8_t pin;
+
+	reset ();
+	for (pin = 0; pin < 32u; pin++)
+	{
+		PORT_bfnRegister (ePORTC, (PINS)pin, ePORT_RISING, 0, record);
+		PDIR (1) = 1u << pin;
+		interrupt (0, 1u << pin, 0, 0);
+		CHECK ((callCount == 1) && (calls[0].pin == pin) && (calls[0].levels == (1u << pin)),
+				"PTC%u: %u calls, pin %u", pin, callCount, calls[0].pin);
+		PORT_vfnUnregister (ePORTC, (PINS)pin);
+	}
+
+	reset ();
+	PORT_bfnRegister (ePORTB, ePIN7, ePORT_RISING, 0, record);
+	PORT_bfnRegister (ePORTC, ePIN30, ePORT_RISING, 0, record);
+	PORT_bfnRegister (ePORTC, ePIN3, ePORT_RISING, 0, record);
+	PORT_bfnRegister (ePORTC, ePIN17, ePORT_RISING, 0, record);
+	PORT_bfnRegister (ePORTE, ePIN31, ePORT_RISING, 0, record);
+	interrupt (1u << 7, (1u << 30) | (1u << 17) | (1u << 3) | (1u << 5), 0, 1u << 31);
+	CHECK (callCount == 5, "%u calls", callCount);
+	CHECK ((calls[0].pin == 7) && (calls[1].pin == 3) && (calls[2].pin == 17)
+			&& (calls[3].pin == 30) && (calls[4].pin == 31),
+			"order %u %u %u %u %u", calls[0].pin, calls[1].pin, calls[2].pin, calls[3].pin, calls[4].pin);
+
+	/* The rows of the keypad: the strobe moves on during the first call */
+	reset ();
+	PORT_bfnRegister (ePORTD, ePIN0, ePORT_RISING, 0, strobe);
+	PORT_bfnRegister (ePORTD, ePIN2, ePORT_RISING, 0, strobe);
+	PDIR (2) = 0x25u;
+	interrupt (0, 0, 0x5u, 0);
+	CHECK ((callCount == 2) && (calls[0].levels == 0x25u) && (calls[1].levels == 0x25u),
+			"levels %08x %08x", calls[0].levels, calls[1].levels);
+}
+
+/*!
+	\fn			static void testDebounce (void)
+	\brief		A debounced pin is disarmed on its edge and called back by
+				PORT_vfnTask once the time is up, armed again first, and only
+				with the level its mode waits for
+*/
+static void testDebounce (void)
+{
+	reset ();
+	Host_dwNowMs = 1000u;
+	PDIR (0) = 1u << 5;
+	PORT_bfnRegister (ePORTB, ePIN5, ePORT_FALLING, 30, record);
+
+	PDIR (0) = 0;
+	interrupt (1u << 5, 0, 0, 0);
+	CHECK (callCount == 0, "called from the interrupt");
+	CHECK (IRQC (ePORTB, 5) == 0, "not disarmed");
+	task (1020u);
+	CHECK ((callCount == 0) && (IRQC (ePORTB, 5) == 0), "armed before the time");
+	task (1030u);
+	CHECK (IRQC (ePORTB, 5) == ePORT_FALLING, "not armed again");
+	CHECK ((callCount == 1) && (calls[0].pin == 5) && (calls[0].levels == 0), "settled low not reported");
+	task (1100u);
+	CHECK (callCount == 0, "reported twice");
+
+	/* A bounce back to high before the time is not reported */
+	Host_dwNowMs = 2000u;
+	interrupt (1u << 5, 0, 0, 0);
+	PDIR (0) = 1u << 5;
+	task (2030u);
+	CHECK ((callCount == 0) && (IRQC (ePORTB, 5) == ePORT_FALLING), "bounce reported");
+
+	/* Both edges: only a change from the level last reported */
+	Host_dwNowMs = 3000u;
+	PDIR (0) = 1u << 6;
+	PORT_bfnRegister (ePORTB, ePIN6, ePORT_BOTH, 10, record);
+	PDIR (0) = 0;
+	interrupt (1u << 6, 0, 0, 0);
+	task (3010u);
+	CHECK ((callCount == 1) && !(calls[0].levels & (1u << 6)), "fall not reported");
+	Host_dwNowMs = 3100u;
+	interrupt (1u << 6, 0, 0, 0);
+	task (3110u);
+	CHECK (callCount == 0, "same level reported again");
+	Host_dwNowMs = 3200u;
+	PDIR (0) = 1u << 6;
+	interrupt (1u << 6, 0, 0, 0);
+	task (3210u);
+	CHECK ((callCount == 1) && (calls[0].levels & (1u << 6)), "rise not reported");
+}
+
+/*!
+	\fn			static void testLevel (void)
+	\brief		A level pin calls back from the interrupt and is disarmed
+				until PORT_vfnTask, which arms it without calling back
+*/
+static void testLevel (void)
+{
+	reset ();
+	Host_dwNowMs = 500u;
+	PORT_bfnRegister (ePORTE, ePIN1, ePORT_LOW, 0, record);
+	interrupt (0, 0, 0, 1u << 1);
+	CHECK ((callCount == 1) && (calls[0].pin == 1), "level not reported");
+	CHECK (IRQC (ePORTE, 1) == 0, "level pin left armed");
+	task (500u);
+	CHECK ((callCount == 0) && (IRQC (ePORTE, 1) == ePORT_LOW), "level pin not armed again");
+}
+
+/*!
+	\fn			static void testUnregister (void)
+	\brief		An unregistered pin is not called back, and a disarmed one is
+				not armed again by PORT_vfnTask
+*/
+static void testUnregister (void)
+{
+	reset ();
+	Host_dwNowMs = 0;
+	PORT_bfnRegister (ePORTC, ePIN9, ePORT_RISING, 0, record);
+	PORT_vfnUnregister (ePORTC, ePIN9);
+	interrupt (0, 1u << 9, 0, 0);
+	CHECK (callCount == 0, "unregistered pin called back");
+
+	PORT_bfnRegister (ePORTC, ePIN9, ePORT_RISING, 20, record);
+	PDIR (1) = 1u << 9;
+	interrupt (0, 1u << 9, 0, 0);
+	PORT_vfnUnregister (ePORTC, ePIN9);
+	task (100u);
+	CHECK ((callCount == 0) && (IRQC (ePORTC, 9) == 0), "unregistered pin armed again");
+}
+
+int main (int argc, char **argv)
+{
+	Host_vfnInit (argc, argv);
+	testRegister ();
+	testDispatch ();
+	testDebounce ();
+	testLevel ();
+	testUnregister ();
+
+	return Host_ifnResult ();
+}
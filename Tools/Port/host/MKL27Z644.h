@@ -0,0 +1,43 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		MKL27Z644.h
+	\brief		Host wrapper of the device header for the pin interrupt
+				harness. Takes the real register layouts and points PORTB to
+				PORTE, GPIOB to GPIOE and the NVIC at structures owned by
+				PortHost.c, so PORT.c runs unchanged against faked flags and
+				input levels.
+*/
+//------------------------------------------------------------------------------
+#ifndef HOST_PORT_MKL27Z644_H_
+#define HOST_PORT_MKL27Z644_H_
+
+#include_next "MKL27Z644.h"
+
+extern PORT_Type Host_port[4];
+extern GPIO_Type Host_gpio[4];
+extern NVIC_Type Host_nvic;
+
+#undef PORTB
+#define PORTB						(&Host_port[0])
+#undef PORTC
+#define PORTC						(&Host_port[1])
+#undef PORTD
+#define PORTD						(&Host_port[2])
+#undef PORTE
+#define PORTE						(&Host_port[3])
+#undef GPIOB
+#define GPIOB						(&Host_gpio[0])
+#undef GPIOC
+#define GPIOC						(&Host_gpio[1])
+#undef GPIOD
+#define GPIOD						(&Host_gpio[2])
+#undef GPIOE
+#define GPIOE						(&Host_gpio[3])
+#undef NVIC
+#define NVIC						(&Host_nvic)
+
+/* The CMSIS function was compiled against the real NVIC address */
+#undef NVIC_EnableIRQ
+#define NVIC_EnableIRQ(irq)			(Host_nvic.ISER[0] = (1u << (irq)))
+
+#endif /* HOST_PORT_MKL27Z644_H_ */
@@ -0,0 +1,451 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		RamBudget.c
+	\date		October 19th, 2026
+	\brief		RAM budget report of a GNU ld map file: the .data, .bss and
+				.noinit bytes every object file takes, and the code it runs
+				from RAM (.ramfunc), per module and per directory, against the
+				RAM of the part.
+
+				Usage:
+					rambudget [--budget bytes] [--reserve bytes] <file.map>
+
+				The budget is the length of the writable regions of the
+				map's memory configuration, or RAMBUDGET_DEFAULT when the
+				map has none, as a host link. Output sections named after
+				the heap or the stack are reported as such; a stack the
+				linker script does not place in a section is given with
+				--reserve. The exit status is 1 when the RAM used and the
+				reserve exceed the budget.
+
+				Map of the MCUXpresso Debug build: Debug/SmartLock.map. That
+				report, with the stack size as reserve, is the RAM budget;
+				the report of a host link only tests the parser.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		RAMBUDGET_DEFAULT
+	\brief		SRAM of the KL27Z64
+*/
+#define		RAMBUDGET_DEFAULT	16384u
+
+/*!
+	\def		MAX_MODULES
+	\brief		Object files, libraries members and sections reported
+*/
+#define		MAX_MODULES			1024
+
+/*!
+	\def		MAX_NAME
+	\brief		Longest layer or module name kept
+*/
+#define		MAX_NAME			64
+
+/*!
+	\def		MAX_LINE
+	\brief		Longest map line read
+*/
+#define		MAX_LINE			1024
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		MODULE
+	\brief		RAM of one object file
+*/
+typedef struct
+{
+	char layer[MAX_NAME];	/* directory or library of the object */
+	char name[MAX_NAME];
+	uint32_t data;			/* initialized, also copied from flash */
+	uint32_t bss;			/* zeroed or left uninitialized */
+	uint32_t code;			/* functions copied from flash with the data */
+} MODULE;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+static MODULE modules[MAX_MODULES];
+static int numModules = 0;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static uint32_t *kind (MODULE *entry, int which)
+	\return		Returns the counter of a kind of RAM: 0 data, 1 bss, 2 code
+*/
+static uint32_t *kind (MODULE *entry, int which)
+{
+	return (which == 2) ? &entry->code : ((which == 1) ? &entry->bss : &entry->data);
+}
+
+/*!
+	\fn			static int isHex (const char *text, uint32_t *value)
+	\return		Returns 1 if text is a 0x number, which is stored in value
+*/
+static int isHex (const char *text, uint32_t *value)
+{
+	char *end;
+	unsigned long long number;
+
+	if (strncmp (text, "0x", 2) != 0)
+	{
+		return 0;
+	}
+	number = strtoull (text, &end, 16);
+	if (*end)
+	{
+		return 0;
+	}
+	*value = (uint32_t)number;
+	return 1;
+}
+
+/*!
+	\fn			static int hasPrefix (const char *name, const char * const *prefixes)
+	\return		Returns 1 if name is one of the prefixes or starts with one
+				of them and a '.'
+*/
+static int hasPrefix (const char *name, const char * const *prefixes)
+{
+	size_t length;
+
+	for (; *prefixes; prefixes++)
+	{
+		length = strlen (*prefixes);
+		if (!strncmp (name, *prefixes, length) && ((name[length] == '\0') || (name[length] == '.')))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			static MODULE *module (const char *path)
+	\return		Returns the entry of an object file, a member of a library
+				"lib.a(member.o)" or a name in parentheses, adding it if new.
+				The layer of an object file is its directory.
+*/
+static MODULE *module (const char *path)
+{
+	char layer[MAX_NAME] = "-";
+	char name[MAX_NAME];
+	const char *open = strchr (path, '(');
+	const char *base;
+	const char *end;
+	char *dot;
+	int i;
+
+	if ((path[0] == '(') || !open)
+	{
+		end = path + strlen (path);
+		base = strrchr (path, '/');
+		base = base ? base + 1 : path;
+		if (path[0] != '(')
+		{
+			strcpy (layer, ".");
+		}
+		if ((base > path + 1) && (path[0] != '('))
+		{
+			for (i = (int)(base - path) - 2; (i > 0) && (path[i - 1] != '/'); i--)
+			{
+			}
+			snprintf (layer, sizeof (layer), "%.*s", (int)(base - path) - 1 - i, &path[i]);
+		}
+	}
+	else
+	{
+		/* Library member: the library is the layer */
+		end = strchr (open, ')');
+		end = end ? end : open + strlen (open);
+		base = strrchr (path, '/');
+		base = (base && (base < open)) ? base + 1 : path;
+		snprintf (layer, sizeof (layer), "%.*s", (int)(open - base), base);
+		base = open + 1;
+	}
+	snprintf (name, sizeof (name), "%.*s", (int)(end - base), base);
+	dot = strrchr (name, '.');
+	if (dot && (dot != name) && (!strcmp (dot, ".o") || !strcmp (dot, ".obj")))
+	{
+		*dot = '\0';
+	}
+
+	for (i = 0; i < numModules; i++)
+	{
+		if (!strcmp (modules[i].layer, layer) && !strcmp (modules[i].name, name))
+		{
+			return &modules[i];
+		}
+	}
+	if (numModules == MAX_MODULES)
+	{
+		fprintf (stderr, "rambudget: more than %u modules\n", MAX_MODULES);
+		exit (2);
+	}
+	strcpy (modules[numModules].layer, layer);
+	strcpy (modules[numModules].name, name);
+	return &modules[numModules++];
+}
+
+/*!
+	\fn			static int byTotal (const void *a, const void *b)
+	\brief		Largest first, then by layer and name
+*/
+static int byTotal (const void *a, const void *b)
+{
+	const MODULE *x = a;
+	const MODULE *y = b;
+	uint32_t xTotal = x->data + x->bss + x->code;
+	uint32_t yTotal = y->data + y->bss + y->code;
+	int order;
+
+	if (xTotal != yTotal)
+	{
+		return (xTotal > yTotal) ? -1 : 1;
+	}
+	order = strcmp (x->layer, y->layer);
+	return order ? order : strcmp (x->name, y->name);
+}
+
+/*!
+	\fn			static void usage (void)
+	\brief		Prints the usage and exits
+*/
+static void usage (void)
+{
+	fprintf (stderr, "usage: rambudget [--budget bytes] [--reserve bytes] <file.map>\n");
+	exit (2);
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	static const char * const dataSections[] = {".data", ".sdata", 0};
+	static const char * const bssSections[] = {".bss", ".sbss", ".noinit", "COMMON", 0};
+	static const char * const codeSections[] = {".ramfunc", "RamFunction", "CodeQuickAccess", 0};
+	static char line[MAX_LINE];
+	static char pending[MAX_LINE];
+	static MODULE layers[MAX_MODULES];
+	const char *path = NULL;
+	char *tokens[4];
+	char *token;
+	FILE *file;
+	uint32_t budget = 0;
+	uint32_t reserve = 0;
+	uint32_t regions = 0;
+	uint32_t address;
+	uint32_t size;
+	uint32_t used = 0;
+	uint32_t code = 0;
+	int isMemory = 0;
+	int isMap = 0;
+	int lastKind = -1;		/* of the last input section, -1 if not RAM */
+	int isPendingOutput = 0;
+	int count;
+	int numLayers = 0;
+	int i;
+	int j;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp (argv[i], "--budget") && (i + 1 < argc))
+		{
+			budget = (uint32_t)strtoul (argv[++i], NULL, 0);
+		}
+		else if (!strcmp (argv[i], "--reserve") && (i + 1 < argc))
+		{
+			reserve = (uint32_t)strtoul (argv[++i], NULL, 0);
+		}
+		else if ((argv[i][0] == '-') || path)
+		{
+			usage ();
+		}
+		else
+		{
+			path = argv[i];
+		}
+	}
+	if (!path)
+	{
+		usage ();
+	}
+	file = fopen (path, "r");
+	if (!file)
+	{
+		fprintf (stderr, "rambudget: cannot read %s\n", path);
+		return 2;
+	}
+
+	pending[0] = '\0';
+	while (fgets (line, sizeof (line), file))
+	{
+		int isIndented = (line[0] == ' ');
+		int isInput = isIndented && (line[1] != ' ');
+
+		line[strcspn (line, "\r\n")] = '\0';
+		if (!strncmp (line, "Memory Configuration", 20))
+		{
+			isMemory = 1;
+			continue;
+		}
+		if (!strncmp (line, "Linker script and memory map", 28))
+		{
+			isMemory = 0;
+			isMap = 1;
+			continue;
+		}
+
+		count = 0;
+		for (token = strtok (line, " \t"); token && (count < 4); token = strtok (NULL, " \t"))
+		{
+			tokens[count++] = token;
+		}
+
+		/* Name Origin Length Attributes: writable regions are the RAM */
+		if (isMemory)
+		{
+			if ((count == 4) && isHex (tokens[1], &address) && isHex (tokens[2], &size) &&
+					strchr (tokens[3], 'w'))
+			{
+				regions += size;
+			}
+			continue;
+		}
+		if (!isMap || !count)
+		{
+			continue;
+		}
+
+		/* A name too long for its column is alone on its line */
+		if (!isIndented)
+		{
+			isPendingOutput = 0;
+			if ((count == 1) && (strstr (tokens[0], "heap") || strstr (tokens[0], "stack")))
+			{
+				strcpy (pending, tokens[0]);
+				isPendingOutput = 1;
+				continue;
+			}
+			if ((count >= 3) && (strstr (tokens[0], "heap") || strstr (tokens[0], "stack")) &&
+					isHex (tokens[2], &size) && size)
+			{
+				snprintf (pending, sizeof (pending), "(%s)", tokens[0]);
+				module (pending)->bss += size;
+			}
+			pending[0] = '\0';
+			continue;
+		}
+		if (isPendingOutput)
+		{
+			isPendingOutput = 0;
+			if ((count >= 2) && isHex (tokens[0], &address) && isHex (tokens[1], &size) && size)
+			{
+				snprintf (line, sizeof (line), "(%s)", pending);
+				module (line)->bss += size;
+			}
+			pending[0] = '\0';
+			continue;
+		}
+		if (isInput && (count == 1))
+		{
+			strcpy (pending, tokens[0]);
+			continue;
+		}
+		if (isInput)
+		{
+			pending[0] = '\0';
+			if (!strcmp (tokens[0], "*fill*"))
+			{
+				if ((count >= 3) && (lastKind >= 0) && isHex (tokens[2], &size))
+				{
+					*kind (module ("(fill)"), lastKind) += size;
+				}
+				continue;
+			}
+			if ((count < 3) || !isHex (tokens[1], &address) || !isHex (tokens[2], &size))
+			{
+				continue;
+			}
+			strcpy (pending, tokens[0]);
+			tokens[0] = tokens[1];
+			tokens[1] = tokens[2];
+			tokens[2] = tokens[3];
+			count--;
+		}
+		else if (!pending[0] || (count < 2) || !isHex (tokens[0], &address))
+		{
+			/* Symbols and assignments */
+			continue;
+		}
+
+		/* pending: input section; tokens: address, size and object */
+		lastKind = hasPrefix (pending, codeSections) ? 2 : (hasPrefix (pending, bssSections) ? 1 :
+				(hasPrefix (pending, dataSections) ? 0 : -1));
+		if ((lastKind >= 0) && isHex (tokens[1], &size) && size)
+		{
+			*kind (module ((count >= 3) ? tokens[2] : "(linker)"), lastKind) += size;
+		}
+		pending[0] = '\0';
+	}
+	fclose (file);
+
+	if (!budget)
+	{
+		budget = regions ? regions : RAMBUDGET_DEFAULT;
+	}
+
+	/* Per module, then per layer */
+	qsort (modules, (size_t)numModules, sizeof (MODULE), byTotal);
+	printf ("%-16s %-24s %8s %8s %8s %8s\n", "layer", "module", "data", "bss", "code", "total");
+	for (i = 0; i < numModules; i++)
+	{
+		printf ("%-16s %-24s %8u %8u %8u %8u\n", modules[i].layer, modules[i].name, modules[i].data,
+				modules[i].bss, modules[i].code, modules[i].data + modules[i].bss + modules[i].code);
+		used += modules[i].data + modules[i].bss + modules[i].code;
+		code += modules[i].code;
+		for (j = 0; (j < numLayers) && strcmp (layers[j].layer, modules[i].layer); j++)
+		{
+		}
+		if (j == numLayers)
+		{
+			strcpy (layers[numLayers++].layer, modules[i].layer);
+		}
+		layers[j].data += modules[i].data;
+		layers[j].bss += modules[i].bss;
+		layers[j].code += modules[i].code;
+	}
+	qsort (layers, (size_t)numLayers, sizeof (MODULE), byTotal);
+	printf ("\n");
+	for (i = 0; i < numLayers; i++)
+	{
+		printf ("%-16s %-24s %8u %8u %8u %8u\n", layers[i].layer, "", layers[i].data, layers[i].bss,
+				layers[i].code, layers[i].data + layers[i].bss + layers[i].code);
+	}
+	printf ("\n");
+	if (code)
+	{
+		printf ("code in RAM %u bytes\n", code);
+	}
+	if (reserve)
+	{
+		printf ("reserve %u bytes\n", reserve);
+	}
+	printf ("RAM used %u of %u bytes, %d free\n", used, budget, (int)budget - (int)(used + reserve));
+
+	return (used + reserve > budget) ? 1 : 0;
+}
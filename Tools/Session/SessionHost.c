@@ -0,0 +1,417 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		SessionHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the secure session. Aes.c and Curve25519.c
+				are checked against the vectors of FIPS-197, RFC 3610 and
+				RFC 7748; then Session.c and Protocol.c run unchanged while
+				the harness plays the phone: it pairs, compares the check
+				code, sends pin frames and opens the lock's answers, and
+				tries replayed, forged and malformed frames.
+
+				Usage:
+					sessionhost [--verbose]
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Aes.h"
+#include "ClockProfile.h"
+#include "Curve25519.h"
+#include "Protocol.h"
+#include "Session.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_DIGITS
+	\brief		Digits the lock may hand on in one run
+*/
+#define		MAX_DIGITS			64
+
+/*!
+	\def		FAST_REQUESTS, FAST_RELEASES
+	\brief		Calls for the 48 MHz profile
+*/
+#define		FAST_REQUESTS		Host_adwClockRequests[eCLOCK_PROFILE_RUN_48M]
+#define		FAST_RELEASES		Host_adwClockReleases[eCLOCK_PROFILE_RUN_48M]
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+static uint32_t cycles = 0;
+
+static uint8_t digits[MAX_DIGITS];
+static uint32_t numDigits = 0;
+
+//------------------------------------------------------------------------------
+// Firmware stubs
+//------------------------------------------------------------------------------
+uint32_t Timebase_dwfnGetCycles (void)
+{
+	cycles += 7919u;
+	return cycles;
+}
+
+static void digitHandler (uint8_t digit)
+{
+	if (numDigits < MAX_DIGITS)
+	{
+		digits[numDigits++] = digit;
+	}
+}
+
+//------------------------------------------------------------------------------
+// Helpers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void fromHex (const char *text, uint8_t *out, size_t size)
+*/
+static void fromHex (const char *text, uint8_t *out, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		sscanf (&text[2 * i], "%2hhx", &out[i]);
+	}
+}
+
+/*!
+	\fn			static void toHex (char *text, const uint8_t *in, size_t size)
+*/
+static void toHex (char *text, const uint8_t *in, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i < size; i++)
+	{
+		sprintf (&text[2 * i], "%02x", in[i]);
+	}
+}
+
+/*!
+	\fn			static int sameHex (const uint8_t *data, const char *hex, size_t size)
+	\return		Returns 1 if data holds the bytes written in hex
+*/
+static int sameHex (const uint8_t *data, const char *hex, size_t size)
+{
+	uint8_t expected[256];
+
+	fromHex (hex, expected, size);
+	return memcmp (data, expected, size) == 0;
+}
+
+/*!
+	\fn			static void derive (uint8_t *out, uint8_t label, const uint8_t *shared,
+					const uint8_t *lockKey, const uint8_t *phoneKey)
+	\brief		The phone's side of the key derivation, written from the
+				description in Session.c
+*/
+static void derive (uint8_t *out, uint8_t label, const uint8_t *shared,
+		const uint8_t *lockKey, const uint8_t *phoneKey)
+{
+	const uint8_t *input[6] = {shared, shared + 16, lockKey, lockKey + 16, phoneKey, phoneKey + 16};
+	AES_CONTEXT context;
+	uint8_t block[AES_BLOCK];
+	int i;
+	int j;
+
+	memset (out, 0, AES_BLOCK);
+	out[0] = label;
+	for (i = 0; i < 6; i++)
+	{
+		Aes_vfnSetKey (&context, input[i]);
+		Aes_vfnEncrypt (&context, out, block);
+		for (j = 0; j < AES_BLOCK; j++)
+		{
+			out[j] ^= block[j];
+		}
+	}
+}
+
+/*!
+	\fn			static void nonce (uint8_t *out, uint8_t direction, uint32_t counter)
+*/
+static void nonce (uint8_t *out, uint8_t direction, uint32_t counter)
+{
+	memset (out, 0, AES_CCM_NONCE);
+	out[0] = direction;
+	out[1] = (uint8_t)(counter >> 24);
+	out[2] = (uint8_t)(counter >> 16);
+	out[3] = (uint8_t)(counter >> 8);
+	out[4] = (uint8_t)counter;
+}
+
+/*!
+	\fn			static const char *sendPin (const AES_CONTEXT *key, uint32_t counter,
+					const uint8_t *pin, uint8_t length, int tamper)
+	\return		Returns the lock's reply to a sealed pin frame
+	\param		tamper	Byte of the frame to flip, -1 for none
+*/
+static const char *sendPin (const AES_CONTEXT *key, uint32_t counter,
+		const uint8_t *pin, uint8_t length, int tamper)
+{
+	uint8_t frame[32];
+	uint8_t n[AES_CCM_NONCE];
+	char line[96];
+
+	frame[0] = (uint8_t)(counter >> 24);
+	frame[1] = (uint8_t)(counter >> 16);
+	frame[2] = (uint8_t)(counter >> 8);
+	frame[3] = (uint8_t)counter;
+	nonce (n, 1, counter);
+	Aes_vfnCcmSeal (key, n, NULL, 0, pin, length, &frame[4], &frame[4 + length]);
+	if (tamper >= 0)
+	{
+		frame[tamper] ^= 0x01;
+	}
+	strcpy (line, "SEC ");
+	toHex (&line[4], frame, 4u + length + AES_CCM_TAG);
+	return Host_pcfnCommand (line, 0);
+}
+
+//------------------------------------------------------------------------------
+// Scenarios
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testAes (void)
+	\brief		FIPS-197 appendix C.1 and RFC 3610 packet vector 1
+*/
+static void testAes (void)
+{
+	AES_CONTEXT context;
+	uint8_t key[AES_BLOCK];
+	uint8_t block[AES_BLOCK];
+	uint8_t nonceBytes[AES_CCM_NONCE];
+	uint8_t packet[31];
+	uint8_t out[23];
+	uint8_t tag[AES_CCM_TAG];
+	uint8_t back[23];
+
+	fromHex ("000102030405060708090a0b0c0d0e0f", key, sizeof (key));
+	fromHex ("00112233445566778899aabbccddeeff", block, sizeof (block));
+	Aes_vfnSetKey (&context, key);
+	Aes_vfnEncrypt (&context, block, block);
+	CHECK (sameHex (block, "69c4e0d86a7b0430d8cdb78070b4c55a", 16), "FIPS-197 C.1");
+
+	fromHex ("c0c1c2c3c4c5c6c7c8c9cacbcccdcecf", key, sizeof (key));
+	fromHex ("00000003020100a0a1a2a3a4a5", nonceBytes, sizeof (nonceBytes));
+	fromHex ("000102030405060708090a0b0c0d0e0f101112131415161718191a1b1c1d1e", packet, sizeof (packet));
+	Aes_vfnSetKey (&context, key);
+	Aes_vfnCcmSeal (&context, nonceBytes, packet, 8, &packet[8], 23, out, tag);
+	CHECK (sameHex (out, "588c979a61c663d2f066d0c2c0f989806d5f6b61dac384", 23), "RFC 3610 #1 cipher text");
+	CHECK (sameHex (tag, "17e8d12cfdf926e0", 8), "RFC 3610 #1 tag");
+
+	CHECK (Aes_bfnCcmOpen (&context, nonceBytes, packet, 8, out, 23, tag, back) &&
+			!memcmp (back, &packet[8], 23), "RFC 3610 #1 open");
+	tag[7] ^= 0x80;
+	CHECK (!Aes_bfnCcmOpen (&context, nonceBytes, packet, 8, out, 23, tag, back), "forged tag opened");
+	tag[7] ^= 0x80;
+	packet[0] ^= 0x01;
+	CHECK (!Aes_bfnCcmOpen (&context, nonceBytes, packet, 8, out, 23, tag, back), "forged AAD opened");
+}
+
+/*!
+	\fn			static void testX25519 (void)
+	\brief		RFC 7748 section 5.2 and 6.1
+*/
+static void testX25519 (void)
+{
+	uint8_t k[CURVE25519_BYTES];
+	uint8_t u[CURVE25519_BYTES];
+	uint8_t out[CURVE25519_BYTES];
+	uint8_t alice[CURVE25519_BYTES];
+	uint8_t bob[CURVE25519_BYTES];
+	uint8_t alicePublic[CURVE25519_BYTES];
+	uint8_t bobPublic[CURVE25519_BYTES];
+	int i;
+
+	fromHex ("a546e36bf0527c9d3b16154b82465edd62144c0ac1fc5a18506a2244ba449ac4", k, 32);
+	fromHex ("e6db6867583030db3594c1a424b15f7c726624ec26b3353b10a903a6d0ab1c4c", u, 32);
+	Curve25519_vfnX25519 (out, k, u);
+	CHECK (sameHex (out, "c3da55379de9c6908e94ea4df28d084f32eccf03491c71f754b4075577a28552", 32), "5.2 vector 1");
+
+	fromHex ("4b66e9d4d1b4673c5ad22691957d6af5c11b6421e0ea01d42ca4169e7918ba0d", k, 32);
+	fromHex ("e5210f12786811d3f4b7959d0538ae2c31dbe7106fc03c3efc4cd549c715a493", u, 32);
+	Curve25519_vfnX25519 (out, k, u);
+	CHECK (sameHex (out, "95cbde9476e8907d7aade45cb4b873f88b595a68799fa152e6f8f7647aac7957", 32), "5.2 vector 2");
+
+	/* k = u = 9, then k, u = X25519 (k, u), k */
+	memset (k, 0, sizeof (k));
+	k[0] = 9;
+	memcpy (u, k, sizeof (u));
+	for (i = 1; i <= 1000; i++)
+	{
+		Curve25519_vfnX25519 (out, k, u);
+		memcpy (u, k, sizeof (u));
+		memcpy (k, out, sizeof (k));
+		if (i == 1)
+		{
+			CHECK (sameHex (k, "422c8e7a6227d7bca1350b3e2bb7279f7897b87bb6854b783c60e80311ae3079", 32), "5.2 1 iteration");
+		}
+	}
+	CHECK (sameHex (k, "684cf59ba83309552800ef566f2f4d3c1c3887c49360e3875f2eb94d99532c51", 32), "5.2 1000 iterations");
+
+	fromHex ("77076d0a7318a57d3c16c17251b26645df4c2f87ebc0992ab177fba51db92c2a", alice, 32);
+	fromHex ("5dab087e624a8a4b79e17f8b83800ee66f3bb1292618b6fd1c2f8b27ff88e0eb", bob, 32);
+	Curve25519_vfnX25519Base (alicePublic, alice);
+	Curve25519_vfnX25519Base (bobPublic, bob);
+	CHECK (sameHex (alicePublic, "8520f0098930a754748b7ddcb43ef75a0dbf3a0d26381af4eba4a98eaa9b4e6a", 32), "6.1 Alice");
+	CHECK (sameHex (bobPublic, "de9edb7d7b7dc1b4d35b61c2ece435373f8343c85b78674dadfc7e146f882b4f", 32), "6.1 Bob");
+	Curve25519_vfnX25519 (out, alice, bobPublic);
+	CHECK (sameHex (out, "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742", 32), "6.1 Alice's secret");
+	Curve25519_vfnX25519 (out, bob, alicePublic);
+	CHECK (sameHex (out, "4a5d9d5ba4ce2de1728e3bf480350f25e07e21c947d19e3376f09b3c1e161742", 32), "6.1 Bob's secret");
+}
+
+/*!
+	\fn			static int pair (const uint8_t *phoneSecret, AES_CONTEXT *key)
+	\return		Returns 1 if the lock paired and showed the code the phone
+				computed
+	\param		key		Receives the session key the phone derived
+*/
+static int pair (const uint8_t *phoneSecret, AES_CONTEXT *key)
+{
+	uint8_t phoneKey[CURVE25519_BYTES];
+	uint8_t lockKey[CURVE25519_BYTES];
+	uint8_t shared[CURVE25519_BYTES];
+	uint8_t derived[AES_BLOCK];
+	char line[96];
+	char code[8];
+	const char *reply;
+
+	Curve25519_vfnX25519Base (phoneKey, phoneSecret);
+	strcpy (line, "PAIR 0 ");
+	toHex (&line[7], phoneKey, 16);
+	CHECK (!strcmp (Host_pcfnCommand (line, 0), "PAIR 0"), "first half: %s", Host_pcfnCommand (line, 0));
+	strcpy (line, "PAIR 1 ");
+	toHex (&line[7], &phoneKey[16], 16);
+	reply = Host_pcfnCommand (line, 0);
+	if (strncmp (reply, "PAIR 0 ", 7))
+	{
+		CHECK (0, "second half: %s", reply);
+		return 0;
+	}
+	fromHex (&reply[7], lockKey, 16);
+	reply = Host_pcfnCommand (NULL, 1);
+	CHECK (!strncmp (reply, "PAIR 1 ", 7), "lock key: %s", reply);
+	fromHex (&reply[7], &lockKey[16], 16);
+	CHECK (FAST_REQUESTS == FAST_RELEASES, "the fast clock was not released");
+
+	Curve25519_vfnX25519 (shared, phoneSecret, lockKey);
+	derive (derived, 1, shared, lockKey, phoneKey);
+	Aes_vfnSetKey (key, derived);
+	derive (derived, 2, shared, lockKey, phoneKey);
+	snprintf (code, sizeof (code), "%06u", (unsigned)((derived[0] | (derived[1] << 8) |
+			(derived[2] << 16) | ((uint32_t)derived[3] << 24)) % 1000000u));
+	reply = Host_pcfnCommand (NULL, 2);
+	CHECK (!strncmp (reply, "PAIR OK ", 8) && !strcmp (&reply[8], code), "code %s, lock shows %s", code, reply);
+	return Session_bfnIsPaired ();
+}
+
+/*!
+	\fn			static void testSession (void)
+	\brief		Pairing, pin frames and every refusal
+*/
+static void testSession (void)
+{
+	static const uint8_t pin[4] = {1, 2, 3, 4};
+	static const uint8_t letters[4] = {1, 2, 10, 4};
+	uint8_t phoneSecret[CURVE25519_BYTES];
+	AES_CONTEXT key;
+	AES_CONTEXT otherKey;
+	uint8_t n[AES_CCM_NONCE];
+	uint8_t answer[16];
+	uint8_t echo[4];
+	const char *reply;
+	int i;
+
+	for (i = 0; i < CURVE25519_BYTES; i++)
+	{
+		phoneSecret[i] = (uint8_t)(i * 73 + 11);
+	}
+
+	CHECK (!strcmp (Host_pcfnCommand ("SEC 00000001", 0), "SEC ERR unpaired"), "unpaired: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR 0 00", 0), "PAIR ERR closed"), "closed: %s", Host_pcfnCommand (NULL, 0));
+
+	Session_vfnAllowPairing ();
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR 2 00", 0), "PAIR ERR format"), "half 2: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR 0 0011", 0), "PAIR ERR format"), "short half: %s", Host_pcfnCommand (NULL, 0));
+
+	/* u = 0 has small order: the secret would be zero */
+	Host_pcfnCommand ("PAIR 0 00000000000000000000000000000000", 0);
+	reply = Host_pcfnCommand ("PAIR 1 00000000000000000000000000000000", 0);
+	CHECK (!strcmp (reply, "PAIR ERR key"), "small order key: %s", reply);
+	CHECK (!Session_bfnIsPaired (), "paired with a small order key");
+
+	CHECK (pair (phoneSecret, &key), "pairing failed");
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR", 0), "PAIR paired=1 window=1"), "status: %s", Host_pcfnCommand (NULL, 0));
+
+	numDigits = 0;
+	reply = sendPin (&key, 1, pin, sizeof (pin), -1);
+	CHECK ((numDigits == 4) && !memcmp (digits, pin, 4), "%u digits handed on", numDigits);
+	CHECK (!strncmp (reply, "SEC ", 4) && (strlen (reply) == 4 + 2 * 16), "answer: %s", reply);
+	fromHex (&reply[4], answer, sizeof (answer));
+	nonce (n, 2, 1);
+	CHECK ((answer[3] == 1) && Aes_bfnCcmOpen (&key, n, NULL, 0, &answer[4], 4, &answer[8], echo) &&
+			sameHex (echo, "00000001", 4), "answer does not open or echo the counter");
+
+	numDigits = 0;
+	CHECK (!strcmp (sendPin (&key, 1, pin, 4, -1), "SEC ERR replay"), "replay: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (sendPin (&key, 5, pin, 4, 6), "SEC ERR auth"), "forged digit: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (sendPin (&key, 5, pin, 4, 9), "SEC ERR auth"), "forged tag: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (sendPin (&key, 5, pin, 4, 3), "SEC ERR auth"), "forged counter: %s", Host_pcfnCommand (NULL, 0));
+	memset (&otherKey, 0, sizeof (otherKey));
+	Aes_vfnSetKey (&otherKey, phoneSecret);
+	CHECK (!strcmp (sendPin (&otherKey, 5, pin, 4, -1), "SEC ERR auth"), "other key: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (sendPin (&key, 6, letters, 4, -1), "SEC ERR format"), "not a digit: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("SEC 0000000712", 0), "SEC ERR format"), "short frame: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("SEC 0000000g1234567890123456789012", 0), "SEC ERR format"), "not hex: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (numDigits == 0, "%u digits of refused frames handed on", numDigits);
+
+	/* A gap in the counter is fine, going back is not */
+	reply = sendPin (&key, 100, pin, 4, -1);
+	CHECK (!strncmp (reply, "SEC ", 4) && (numDigits == 4), "counter 100: %s", reply);
+	CHECK (!strcmp (sendPin (&key, 99, pin, 4, -1), "SEC ERR replay"), "counter 99: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!strcmp (Host_pcfnCommand ("SEC", 0), "SEC received=64 sent=2"), "status: %s", Host_pcfnCommand (NULL, 0));
+
+	/* The window closes; pairing again needs a new pin */
+	Host_dwNowMs += SESSION_PAIRING_MS;
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR CLR", 0), "PAIR ERR closed"), "clear after the window: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (Session_bfnIsPaired (), "session lost with the window");
+
+	Session_vfnAllowPairing ();
+	CHECK (!strcmp (Host_pcfnCommand ("PAIR CLR", 0), "PAIR CLR"), "clear: %s", Host_pcfnCommand (NULL, 0));
+	CHECK (!Session_bfnIsPaired (), "still paired after PAIR CLR");
+	CHECK (!strcmp (sendPin (&key, 200, pin, 4, -1), "SEC ERR unpaired"), "after clear: %s", Host_pcfnCommand (NULL, 0));
+
+	/* A new pairing starts the counters over under a new key */
+	phoneSecret[0] ^= 0x55;
+	CHECK (pair (phoneSecret, &otherKey), "second pairing failed");
+	CHECK (!strcmp (sendPin (&key, 201, pin, 4, -1), "SEC ERR auth"), "old key: %s", Host_pcfnCommand (NULL, 0));
+	numDigits = 0;
+	reply = sendPin (&otherKey, 1, pin, 4, -1);
+	CHECK (!strncmp (reply, "SEC ", 4) && (numDigits == 4), "new key: %s", reply);
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	Host_vfnInit (argc, argv);
+	Protocol_vfnDriverInit (Host_vfnIgnoreByte);
+	Session_vfnInit (digitHandler);
+
+	testAes ();
+	testX25519 ();
+	testSession ();
+
+	return Host_ifnResult ();
+}
@@ -0,0 +1,838 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	Replay.c
+	\date		October 19th, 2026
+	\brief		Deterministic scenario replay and fuzz harness for the lock
+				state machine. The real SmartLock.c, Password.c, Control.c and
+				Indicators.c run on the simulated HAL, driven by key presses and
+				Bluetooth bytes from a trace file or from a seeded generator.
+
+				Usage:
+					replay [options] <trace>...		replay recorded traces
+					replay [options] --fuzz <n>		run n random entry sequences
+
+				Options:
+					--seed <s>		generator seed (default 1)
+					--dump <file>	write the fuzzed timeline as a trace on failure
+					--strict		missed or coalesced entries also fail the run
+					--verbose		keep the firmware output on stdout
+
+				Trace format, one event per line, times in milliseconds:
+					<time> key <char> <hold>	press a keypad key for <hold> ms
+					<time> bt <value>			receive a byte from Bluetooth
+				Lines starting with '#' are comments. Bluetooth bytes between
+				'$' (36) and a newline (10) form a management protocol line
+				and are not pin digits; outside them 0 to 9 are digits, '*'
+				(42) discards the entry and '#' (35) ends it. Every source
+				has its own entry, as in the firmware.
+
+				Invariants checked (any breach fails the run):
+				- the solenoid is only energised after a correct pin
+				- lockdown is only released after a correct pin
+				- an entry is never evaluated twice (double entry)
+				- interrupt handlers never block
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "SimHAL.h"
+#include "SmartLock.h"
+#include "Entry.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		PIN_LENGTH
+	\brief		Digits in a pin entry
+*/
+#define		PIN_LENGTH			4
+
+/*!
+	\def		SOURCES
+	\brief		Entries the model keeps apart: the keypad, then Bluetooth,
+				in the order of the firmware's ENTRY_SOURCE
+*/
+#define		SOURCES				2
+
+/*!
+	\def		BT_LINE
+	\brief		Longest management protocol line (Protocol.c PROTOCOL_LINE)
+*/
+#define		BT_LINE				48
+
+/*!
+	\def		LOOP_US
+	\brief		Virtual time charged for one pass of the main loop
+*/
+#define		LOOP_US				1000u
+
+/*!
+	\def		IDLE_JUMP_US
+	\brief		Longest jump of virtual time while the lock waits for input
+*/
+#define		IDLE_JUMP_US		100000u
+
+/*!
+	\def		SETTLE_US
+	\brief		Time the firmware is given after the last event of a sequence
+				to finish indicators and actuation
+*/
+#define		SETTLE_US			6000000u
+
+/*!
+	\def		MAX_REPORTED
+	\brief		Violations printed in detail before only counting them
+*/
+#define		MAX_REPORTED		20
+
+//------------------------------------------------------------------------------
+// Enums
+//------------------------------------------------------------------------------
+/*!
+	\enum		EVENT_TYPE
+	\brief		Kinds of scenario events
+*/
+typedef enum
+{
+	eEVENT_KEY_DOWN,
+	eEVENT_KEY_UP,
+	eEVENT_BT
+} EVENT_TYPE;
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		EVENT
+	\brief		One scheduled input
+*/
+typedef struct
+{
+	uint64_t timeUs;
+	uint32_t order;
+	uint8_t type;
+	uint8_t value;
+} EVENT;
+
+/*!
+	\struct		ORACLE
+	\brief		Reference model of what the firmware is allowed to do
+*/
+typedef struct
+{
+	uint8_t entry[SOURCES][PIN_LENGTH];
+	uint8_t index[SOURCES];
+	uint64_t lastKeyUs[SOURCES];
+	uint8_t isPending[SOURCES];
+	uint8_t isPendingCorrect[SOURCES];
+	uint8_t lastServed;
+	uint8_t grant;
+	uint8_t inLockdown;
+	uint8_t keyAccepted;
+	uint8_t btInLine;
+	uint8_t btLineLength;
+	uint32_t digits;
+	uint32_t entries;
+	uint32_t evaluations;
+	uint32_t unlocks;
+	uint32_t missedKeys;
+	uint32_t coalesced;
+	uint32_t violations;
+	uint64_t keyDownUs[256];
+	uint64_t latencySumUs;
+	uint64_t latencyMaxUs;
+	uint32_t latencies;
+} ORACLE;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		password
+	\brief		Pin the firmware is built with (Password.c)
+*/
+static const uint8_t password[PIN_LENGTH] = {1, 2, 3, 4};
+
+/*!
+	\var		events
+	\brief		Scheduled events, sorted by time
+*/
+static EVENT *events = NULL;
+
+/*!
+	\var		numEvents
+	\brief		Events in the schedule
+*/
+static uint32_t numEvents = 0;
+
+/*!
+	\var		capacity
+	\brief		Allocated size of the schedule
+*/
+static uint32_t capacity = 0;
+
+/*!
+	\var		nextEvent
+	\brief		First event not delivered yet
+*/
+static uint32_t nextEvent = 0;
+
+/*!
+	\var		oracle
+	\brief		State of the reference model
+*/
+static ORACLE oracle;
+
+/*!
+	\var		isStrict
+	\brief		Set by --strict
+*/
+static uint8_t isStrict = 0;
+
+/*!
+	\var		rngState
+	\brief		xorshift32 state of the fuzz generator
+*/
+static uint32_t rngState = 1;
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void vfnViolation (const char *what);
+static void vfnKey (uint8_t source, uint8_t key);
+static uint8_t bfnBtDigit (uint8_t value);
+
+//------------------------------------------------------------------------------
+// Schedule
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void vfnSchedule (uint64_t timeUs, EVENT_TYPE type, uint8_t value)
+	\brief		Appends an event to the schedule
+*/
+static void vfnSchedule (uint64_t timeUs, EVENT_TYPE type, uint8_t value)
+{
+	if (numEvents == capacity)
+	{
+		capacity = capacity ? (capacity * 2) : 1024;
+		events = realloc (events, capacity * sizeof (EVENT));
+		if (events == NULL)
+		{
+			fprintf (stderr, "out of memory\n");
+			exit (2);
+		}
+	}
+	events[numEvents].timeUs = timeUs;
+	events[numEvents].order = numEvents;
+	events[numEvents].type = (uint8_t)type;
+	events[numEvents].value = value;
+	numEvents++;
+}
+
+/*!
+	\fn			static int ifnCompare (const void *a, const void *b)
+	\brief		Orders events by time, then by the order they were scheduled
+*/
+static int ifnCompare (const void *a, const void *b)
+{
+	const EVENT *x = a;
+	const EVENT *y = b;
+
+	if (x->timeUs != y->timeUs)
+	{
+		return (x->timeUs < y->timeUs) ? -1 : 1;
+	}
+	return (x->order < y->order) ? -1 : (x->order > y->order);
+}
+
+/*!
+	\fn			static void vfnPump (uint64_t nowUs)
+	\brief		Delivers every event that is due. Key releases are checked
+				against the keypad specification to count missed presses.
+*/
+static void vfnPump (uint64_t nowUs)
+{
+	EVENT *event;
+
+	while ((nextEvent < numEvents) && (events[nextEvent].timeUs <= nowUs))
+	{
+		event = &events[nextEvent++];
+		switch (event->type)
+		{
+		case eEVENT_KEY_DOWN:
+			oracle.keyAccepted = 0;
+			oracle.keyDownUs[event->value] = nowUs;
+			Sim_vfnKey (event->value, 1);
+			break;
+
+		case eEVENT_KEY_UP:
+			if (!oracle.keyAccepted)
+			{
+				oracle.missedKeys++;
+			}
+			Sim_vfnKey (event->value, 0);
+			break;
+
+		case eEVENT_BT:
+			if (bfnBtDigit (event->value))
+			{
+				vfnKey (eENTRY_BLUETOOTH, event->value);
+			}
+			Sim_vfnUartRx (event->value);
+			break;
+
+		default:
+			break;
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// Oracle
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void vfnViolation (const char *what)
+	\brief		Records an invariant breach
+*/
+static void vfnViolation (const char *what)
+{
+	oracle.violations++;
+	if (oracle.violations <= MAX_REPORTED)
+	{
+		fprintf (stderr, "VIOLATION at %llu.%03llu ms: %s\n",
+				(unsigned long long)(Sim_qwNowUs / 1000u),
+				(unsigned long long)(Sim_qwNowUs % 1000u), what);
+	}
+}
+
+/*!
+	\fn			static uint8_t bfnBtDigit (uint8_t value)
+	\return		Returns 1 if a Bluetooth byte is a pin digit; else, it is part
+				of a management protocol line and returns 0
+	\brief		Frames the lines as the firmware does: from '$' to the newline,
+				a line that grows past BT_LINE bytes ending early
+*/
+static uint8_t bfnBtDigit (uint8_t value)
+{
+	if (!oracle.btInLine)
+	{
+		if (value != '$')
+		{
+			return 1;
+		}
+		oracle.btInLine = 1;
+		oracle.btLineLength = 0;
+		return 0;
+	}
+	if (value == '\n')
+	{
+		oracle.btInLine = 0;
+	}
+	else if ((value != '\r') && (oracle.btLineLength++ >= BT_LINE))
+	{
+		oracle.btInLine = 0;
+	}
+	return 0;
+}
+
+/*!
+	\fn			static void vfnComplete (uint8_t source)
+	\brief		The entry of a source was completed; it waits for the
+				evaluation, replacing one still waiting
+*/
+static void vfnComplete (uint8_t source)
+{
+	uint8_t i = 0;
+
+	oracle.entries++;
+	if (oracle.isPending[source])
+	{
+		oracle.coalesced++;
+	}
+	oracle.isPending[source] = 1;
+	oracle.isPendingCorrect[source] = (oracle.index[source] == PIN_LENGTH);
+	for (i = 0; i < PIN_LENGTH; i++)
+	{
+		if (oracle.entry[source][i] != password[i])
+		{
+			oracle.isPendingCorrect[source] = 0;
+		}
+	}
+	oracle.index[source] = 0;
+}
+
+/*!
+	\fn			static void vfnKey (uint8_t source, uint8_t key)
+	\brief		Feeds a key delivered to the firmware to the reference model:
+				a digit 0 to 9, ENTRY_CLEAR or ENTRY_END. An entry left for
+				ENTRY_TIMEOUT_MS is discarded before the key.
+*/
+static void vfnKey (uint8_t source, uint8_t key)
+{
+	if ((key > 9u) && (key != ENTRY_CLEAR) && (key != ENTRY_END))
+	{
+		return;
+	}
+	if (oracle.index[source]
+			&& (Sim_qwNowUs - oracle.lastKeyUs[source] >= ENTRY_TIMEOUT_MS * 1000ull))
+	{
+		oracle.index[source] = 0;
+	}
+	if (key == ENTRY_CLEAR)
+	{
+		oracle.index[source] = 0;
+	}
+	else if (key == ENTRY_END)
+	{
+		if (oracle.index[source])
+		{
+			vfnComplete (source);
+		}
+	}
+	else
+	{
+		oracle.digits++;
+		oracle.lastKeyUs[source] = Sim_qwNowUs;
+		oracle.entry[source][oracle.index[source]++] = key;
+		if (oracle.index[source] == PIN_LENGTH)
+		{
+			vfnComplete (source);
+		}
+	}
+}
+
+/*!
+	\fn			static void vfnKeyAccepted (uint8_t key)
+	\brief		A press accepted by the keypad specification is a key of the
+				keypad entry for the model; holding '*' and '#' together
+				cancels the partial entry as well. The time since the key
+				went down is the scan latency.
+*/
+static void vfnKeyAccepted (uint8_t key)
+{
+	uint64_t latencyUs;
+
+	if (key != SIM_KEY_CANCEL)
+	{
+		latencyUs = Sim_qwNowUs - oracle.keyDownUs[key];
+		oracle.latencySumUs += latencyUs;
+		oracle.latencies++;
+		if (latencyUs > oracle.latencyMaxUs)
+		{
+			oracle.latencyMaxUs = latencyUs;
+		}
+	}
+	oracle.keyAccepted = 1;
+	if ((key >= '0') && (key <= '9'))
+	{
+		vfnKey (eENTRY_KEYPAD, (uint8_t)(key - '0'));
+	}
+	else if (key == SIM_KEY_CANCEL)
+	{
+		vfnKey (eENTRY_KEYPAD, ENTRY_CLEAR);
+	}
+	else
+	{
+		vfnKey (eENTRY_KEYPAD, key);
+	}
+}
+
+/*!
+	\fn			static void vfnEvaluation (CLOCK_PROFILE profile)
+	\param		profile		Requested clock profile
+	\brief		The full speed request marks one evaluation. It must take a
+				waiting entry, the sources served in turn as the firmware's
+				arbiter does; none waiting means an entry was evaluated
+				twice. An entry replaced before its evaluation was
+				coalesced.
+*/
+static void vfnEvaluation (CLOCK_PROFILE profile)
+{
+	uint8_t source = oracle.lastServed;
+	uint8_t i = 0;
+
+	if (eCLOCK_PROFILE_RUN_48M != profile)
+	{
+		return;
+	}
+
+	oracle.evaluations++;
+	for (i = 0; i < SOURCES; i++)
+	{
+		source = (uint8_t)((source + 1u) % SOURCES);
+		if (oracle.isPending[source])
+		{
+			break;
+		}
+	}
+	if (i == SOURCES)
+	{
+		vfnViolation ("entry evaluated twice (double entry)");
+		oracle.grant = 0;
+		return;
+	}
+	oracle.isPending[source] = 0;
+	oracle.lastServed = source;
+	oracle.grant = oracle.isPendingCorrect[source];
+}
+
+/*!
+	\fn			static void vfnPinChanged (PORTS port, PINS pin, uint8_t level)
+	\brief		Checks every actuation against the reference model
+				- PTA12 low: solenoid relay energised
+				- PTB0 low: window motor forward (lockdown on)
+				- PTB1 low: window motor backwards (lockdown off)
+*/
+static void vfnPinChanged (PORTS port, PINS pin, uint8_t level)
+{
+	if ((port == ePORTA) && (pin == ePIN12) && !level)
+	{
+		if (!oracle.grant)
+		{
+			vfnViolation ("solenoid energised without a correct pin");
+		}
+		oracle.grant = 0;
+		oracle.unlocks++;
+	}
+	else if ((port == ePORTB) && (pin == ePIN0) && !level)
+	{
+		oracle.inLockdown = 1;
+	}
+	else if ((port == ePORTB) && (pin == ePIN1) && !level)
+	{
+		if (!oracle.grant)
+		{
+			vfnViolation ("lockdown released without a correct pin");
+		}
+		oracle.inLockdown = 0;
+	}
+}
+
+/*!
+	\fn			static void vfnIsrBlocked (const char *reason, uint64_t durationUs)
+	\brief		Interrupt handlers must never block
+*/
+static void vfnIsrBlocked (const char *reason, uint64_t durationUs)
+{
+	char text[96];
+
+	snprintf (text, sizeof (text), "interrupt blocked: %s (%llu us)", reason,
+			(unsigned long long)durationUs);
+	vfnViolation (text);
+}
+
+//------------------------------------------------------------------------------
+// Runner
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void vfnRunUntil (uint64_t endUs)
+	\brief		Steps the firmware until the virtual clock reaches endUs. While
+				no key is held the clock jumps to the next event.
+*/
+static void vfnRunUntil (uint64_t endUs)
+{
+	uint64_t jump;
+
+	while (Sim_qwNowUs < endUs)
+	{
+		SmartLock_vfnStep ();
+
+		jump = LOOP_US;
+		if (!Sim_bfnAnyKeyPressed ())
+		{
+			jump = IDLE_JUMP_US;
+			if ((nextEvent < numEvents) && (events[nextEvent].timeUs > Sim_qwNowUs)
+					&& (events[nextEvent].timeUs - Sim_qwNowUs < jump))
+			{
+				jump = events[nextEvent].timeUs - Sim_qwNowUs;
+			}
+			if (jump < LOOP_US)
+			{
+				jump = LOOP_US;
+			}
+		}
+		Sim_vfnAdvance (jump);
+	}
+}
+
+/*!
+	\fn			static void vfnRunSchedule (uint32_t from)
+	\brief		Sorts the events scheduled from index from and runs until all
+				of them were delivered and the firmware settled
+*/
+static void vfnRunSchedule (uint32_t from)
+{
+	qsort (&events[from], numEvents - from, sizeof (EVENT), ifnCompare);
+	nextEvent = from;
+	if (numEvents > from)
+	{
+		vfnRunUntil (events[numEvents - 1].timeUs + SETTLE_US);
+	}
+}
+
+/*!
+	\fn			static int ifnLoadTrace (const char *path, uint64_t baseUs)
+	\brief		Schedules the events of a trace file, offset by baseUs
+	\return		Returns 0 on success, -1 on a read or syntax error
+*/
+static int ifnLoadTrace (const char *path, uint64_t baseUs)
+{
+	FILE *file = fopen (path, "r");
+	char line[128];
+	char kind[8];
+	char key;
+	unsigned long timeMs;
+	unsigned long arg;
+	uint32_t lineNumber = 0;
+
+	if (file == NULL)
+	{
+		perror (path);
+		return -1;
+	}
+	while (fgets (line, sizeof (line), file) != NULL)
+	{
+		lineNumber++;
+		if ((line[0] == '#') || (line[strspn (line, " \t\r\n")] == 0))
+		{
+			continue;
+		}
+		if ((sscanf (line, "%lu %7s", &timeMs, kind) == 2) && !strcmp (kind, "key")
+				&& (sscanf (line, "%lu %*s %c %lu", &timeMs, &key, &arg) == 3))
+		{
+			vfnSchedule (baseUs + timeMs * 1000u, eEVENT_KEY_DOWN, (uint8_t)key);
+			vfnSchedule (baseUs + (timeMs + arg) * 1000u, eEVENT_KEY_UP, (uint8_t)key);
+		}
+		else if ((sscanf (line, "%lu %7s %lu", &timeMs, kind, &arg) == 3) && !strcmp (kind, "bt"))
+		{
+			vfnSchedule (baseUs + timeMs * 1000u, eEVENT_BT, (uint8_t)arg);
+		}
+		else
+		{
+			fprintf (stderr, "%s:%u: cannot parse: %s", path, lineNumber, line);
+			fclose (file);
+			return -1;
+		}
+	}
+	fclose (file);
+	return 0;
+}
+
+/*!
+	\fn			static uint32_t dwfnRandom (uint32_t range)
+	\return		Returns a pseudo random number in [0, range)
+*/
+static uint32_t dwfnRandom (uint32_t range)
+{
+	rngState ^= rngState << 13;
+	rngState ^= rngState >> 17;
+	rngState ^= rngState << 5;
+	return range ? (rngState % range) : 0;
+}
+
+/*!
+	\fn			static uint64_t qwfnFuzzSequence (uint64_t startUs)
+	\brief		Schedules one random pin entry: correct or random digits, all
+				typed on the keypad or all sent over Bluetooth, with random
+				timing
+	\return		Returns the time of the last scheduled event
+*/
+static uint64_t qwfnFuzzSequence (uint64_t startUs)
+{
+	uint8_t i = 0;
+	uint8_t digit;
+	uint8_t isCorrect = (dwfnRandom (3) == 0);
+	uint8_t isKeypad = (uint8_t)dwfnRandom (2);
+	uint64_t t = startUs + dwfnRandom (3000) * 1000u;
+	uint32_t hold;
+
+	for (i = 0; i < PIN_LENGTH; i++)
+	{
+		digit = isCorrect ? password[i] : (uint8_t)dwfnRandom (10);
+		if (isKeypad)
+		{
+			hold = (20u + dwfnRandom (200u)) * 1000u;
+			vfnSchedule (t, eEVENT_KEY_DOWN, (uint8_t)('0' + digit));
+			vfnSchedule (t + hold, eEVENT_KEY_UP, (uint8_t)('0' + digit));
+			t += hold + (20u + dwfnRandom (400u)) * 1000u;
+		}
+		else
+		{
+			vfnSchedule (t, eEVENT_BT, digit);
+			t += (1u + dwfnRandom (200u)) * 1000u;
+		}
+	}
+	return t;
+}
+
+/*!
+	\fn			static void vfnDumpTrace (const char *path)
+	\brief		Writes the whole schedule as a trace that replays the run
+*/
+static void vfnDumpTrace (const char *path)
+{
+	FILE *file = fopen (path, "w");
+	uint32_t i = 0;
+	uint32_t j = 0;
+
+	if (file == NULL)
+	{
+		perror (path);
+		return;
+	}
+	fprintf (file, "# fuzzed timeline, seed replayable with this file\n");
+	for (i = 0; i < numEvents; i++)
+	{
+		if (events[i].type == eEVENT_BT)
+		{
+			fprintf (file, "%llu bt %u\n", (unsigned long long)(events[i].timeUs / 1000u),
+					events[i].value);
+		}
+		else if (events[i].type == eEVENT_KEY_DOWN)
+		{
+			for (j = i + 1; j < numEvents; j++)
+			{
+				if ((events[j].type == eEVENT_KEY_UP) && (events[j].value == events[i].value))
+				{
+					break;
+				}
+			}
+			fprintf (file, "%llu key %c %llu\n", (unsigned long long)(events[i].timeUs / 1000u),
+					events[i].value, (j < numEvents) ?
+					(unsigned long long)((events[j].timeUs - events[i].timeUs) / 1000u) : 0ull);
+		}
+	}
+	fclose (file);
+}
+
+/*!
+	\fn			int main (int argc, char **argv)
+	\brief		Parses the options, runs the traces or the fuzzer and prints
+				the summary
+	\return		Returns 0 if every invariant held, 1 otherwise, 2 on usage errors
+*/
+int main (int argc, char **argv)
+{
+	const char *dumpPath = NULL;
+	uint32_t fuzzCount = 0;
+	uint8_t isVerbose = 0;
+	uint32_t i = 0;
+	uint32_t j = 0;
+	uint32_t batch = 1;
+	uint32_t from;
+	int argi = 1;
+	int failed;
+	clock_t wallStart;
+	double wallSeconds;
+	ENTRY_STATS entryStats[SOURCES];
+
+	for (argi = 1; (argi < argc) && (argv[argi][0] == '-'); argi++)
+	{
+		if (!strcmp (argv[argi], "--fuzz") && (argi + 1 < argc))
+		{
+			fuzzCount = (uint32_t)strtoul (argv[++argi], NULL, 0);
+		}
+		else if (!strcmp (argv[argi], "--seed") && (argi + 1 < argc))
+		{
+			rngState = (uint32_t)strtoul (argv[++argi], NULL, 0);
+			if (!rngState)
+			{
+				rngState = 1;
+			}
+		}
+		else if (!strcmp (argv[argi], "--dump") && (argi + 1 < argc))
+		{
+			dumpPath = argv[++argi];
+		}
+		else if (!strcmp (argv[argi], "--strict"))
+		{
+			isStrict = 1;
+		}
+		else if (!strcmp (argv[argi], "--verbose"))
+		{
+			isVerbose = 1;
+		}
+		else
+		{
+			fprintf (stderr, "unknown option %s\n", argv[argi]);
+			return 2;
+		}
+	}
+	if (!fuzzCount && (argi >= argc))
+	{
+		fprintf (stderr, "usage: %s [--seed s] [--dump file] [--strict] [--verbose]"
+				" (--fuzz n | trace...)\n", argv[0]);
+		return 2;
+	}
+	if (!isVerbose && (freopen ("/dev/null", "w", stdout) == NULL))
+	{
+		return 2;
+	}
+
+	memset (&oracle, 0, sizeof (oracle));
+	Sim_vfnReset ();
+	Sim_vfnSetHooks (vfnPinChanged, vfnKeyAccepted, vfnPump, vfnIsrBlocked, vfnEvaluation);
+	SmartLock_vfnInit ();
+
+	wallStart = clock ();
+	for (; argi < argc; argi++)
+	{
+		from = numEvents;
+		if (ifnLoadTrace (argv[argi], Sim_qwNowUs))
+		{
+			return 2;
+		}
+		vfnRunSchedule (from);
+	}
+	// Sequences are run in batches of one to three with random start
+	// offsets, so entries from both sources sometimes interleave
+	for (i = 0; i < fuzzCount; i += batch)
+	{
+		from = numEvents;
+		batch = 1 + dwfnRandom (3);
+		for (j = 0; (j < batch) && (i + j < fuzzCount); j++)
+		{
+			// Whole milliseconds, so a dumped trace replays exactly
+			qwfnFuzzSequence ((Sim_qwNowUs / 1000u + 1u + dwfnRandom (5000)) * 1000u);
+		}
+		vfnRunSchedule (from);
+	}
+	wallSeconds = (double)(clock () - wallStart) / CLOCKS_PER_SEC;
+
+	failed = oracle.violations || (isStrict && (oracle.missedKeys || oracle.coalesced));
+	fprintf (stderr, "events %u, digits %u, entries %u, evaluations %u, unlocks %u\n",
+			numEvents, oracle.digits, oracle.entries, oracle.evaluations, oracle.unlocks);
+	fprintf (stderr, "missed keys %u, coalesced entries %u, violations %u\n",
+			oracle.missedKeys, oracle.coalesced, oracle.violations);
+	fprintf (stderr, "key latency avg %.1f ms, max %.1f ms\n",
+			oracle.latencies ? (double)oracle.latencySumUs / oracle.latencies / 1000.0 : 0.0,
+			(double)oracle.latencyMaxUs / 1000.0);
+	for (i = 0; i < SOURCES; i++)
+	{
+		Entry_vfnGetStats ((ENTRY_SOURCE)i, &entryStats[i]);
+	}
+	fprintf (stderr, "decision latency keypad avg %u ms, max %u ms; bluetooth avg %u ms, max %u ms\n",
+			entryStats[eENTRY_KEYPAD].decided ?
+					entryStats[eENTRY_KEYPAD].latencySumMs / entryStats[eENTRY_KEYPAD].decided : 0u,
+			entryStats[eENTRY_KEYPAD].latencyMaxMs,
+			entryStats[eENTRY_BLUETOOTH].decided ?
+					entryStats[eENTRY_BLUETOOTH].latencySumMs / entryStats[eENTRY_BLUETOOTH].decided : 0u,
+			entryStats[eENTRY_BLUETOOTH].latencyMaxMs);
+	fprintf (stderr, "simulated %.1f s in %.3f s wall, %.0f entries/s\n",
+			(double)Sim_qwNowUs / 1e6, wallSeconds,
+			(wallSeconds > 0) ? (oracle.entries / wallSeconds) : 0.0);
+	fprintf (stderr, "%s\n", failed ? "FAIL" : "PASS");
+
+	if (failed && (dumpPath != NULL))
+	{
+		vfnDumpTrace (dumpPath);
+	}
+	free (events);
+
+	return failed ? 1 : 0;
+}
+//------------------------------------------------------------------------------
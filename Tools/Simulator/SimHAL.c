@@ -0,0 +1,1258 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	SimHAL.c
+	\date		October 19th, 2026
+	\brief		Function implementation of the simulated HAL. Every GPIO, UART,
+				PWM, PIT, ADC, RTC, delay, Timebase and ClockProfile call made by
+				the firmware lands here. Blocking delays do not wait; they advance
+				the virtual clock and let the scenario deliver interrupts in the
+				meantime. PIT channels run their callbacks as interrupts at
+				their exact virtual deadlines.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stddef.h>
+#include <string.h>
+#include "SimHAL.h"
+#include "UART.h"
+#include "PWM.h"
+#include "ClockProfile.h"
+#include "Timebase.h"
+#include "PIT.h"
+#include "PORT.h"
+#include "ADC.h"
+#include "RTC.h"
+#include "serviceLayer.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		PORTS_COUNT
+	\brief		Number of GPIO ports in the model
+*/
+#define		PORTS_COUNT			5
+
+/*!
+	\def		ROWS
+	\brief		Rows of the keypad matrix
+*/
+#define		ROWS				4
+
+/*!
+	\def		CHORD_CANCEL
+	\brief		Bitmap of the '*' + '#' chord (row 3, columns 0 and 2)
+*/
+#define		CHORD_CANCEL		((1u << 9) | (1u << 11))
+
+/*!
+	\def		COLUMNS
+	\brief		Columns of the keypad matrix
+*/
+#define		COLUMNS				3
+
+/*!
+	\def		ADVANCE_CHUNK_US
+	\brief		Longest step virtual time moves without pumping events
+*/
+#define		ADVANCE_CHUNK_US	1000u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		SIM_PORT
+	\brief		Direction and output registers of a simulated GPIO port
+*/
+typedef struct
+{
+	uint32_t pddr;
+	uint32_t pdor;
+} SIM_PORT;
+
+/*!
+	\struct		SIM_TIMER
+	\brief		State of a simulated PIT channel. A new period is loaded at the
+				next expiry, like LDVAL.
+*/
+typedef struct
+{
+	PIT_CALLBACK callback;
+	uint32_t periodUs;
+	uint32_t loadUs;
+	uint64_t dueUs;
+} SIM_TIMER;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		Sim_qwNowUs
+	\brief		Virtual time in microseconds since the simulation was reset
+*/
+uint64_t Sim_qwNowUs = 0;
+
+/*!
+	\var		keyLayout
+	\brief		Characters of the keypad, same layout as Password.c
+*/
+static const uint8_t keyLayout[ROWS][COLUMNS] = {
+		{'1', '2', '3'},
+		{'4', '5', '6'},
+		{'7', '8', '9'},
+		{'*', '0', '#'}
+};
+
+/*!
+	\var		rowPins
+	\brief		Port D pins driving the keypad rows
+*/
+static const PINS rowPins[ROWS] = {ePIN0, ePIN1, ePIN2, ePIN3};
+
+/*!
+	\var		ports
+	\brief		Register model of PORTA..PORTE
+*/
+static SIM_PORT ports[PORTS_COUNT];
+
+/*!
+	\var		pressed
+	\brief		Keys currently held down
+*/
+static uint8_t pressed[ROWS][COLUMNS];
+
+/*!
+	\var		acceptedKeys
+	\brief		Key-state bitmap of the last scan the specification accepted
+*/
+static uint16_t acceptedKeys = 0;
+
+/*!
+	\var		previousReal
+	\brief		Keys held on the previous unambiguous scan
+*/
+static uint16_t previousReal = 0;
+
+/*!
+	\var		frameSeen
+	\brief		Columns the firmware could read on every row released so far
+				in the current scan
+*/
+static uint16_t frameSeen = 0;
+
+/*!
+	\var		frameReal
+	\brief		Keys really held on every row released so far in the current scan
+*/
+static uint16_t frameReal = 0;
+
+/*!
+	\var		timers
+	\brief		Simulated PIT channels
+*/
+static SIM_TIMER timers[ePIT_CHANNELS];
+
+/*!
+	\var		uartCallback
+	\brief		Callback registered by the firmware for the LPUART0 interrupt
+*/
+static UART_RX_CALLBACK uartCallback = NULL;
+
+/*!
+	\var		rxRing
+	\brief		Receive ring of the driver. The simulator does not model the
+				DMA: the handler moves every byte to the ring like the
+				interrupt-per-byte build of UART.c.
+*/
+static uint8_t rxRing[UART_RX_RING];
+
+/*!
+	\var		rxHead
+	\brief		Next byte of rxRing to be written by the handler
+*/
+static uint16_t rxHead = 0;
+
+/*!
+	\var		rxTail
+	\brief		Next byte of rxRing to be taken by UART_wfnReceive
+*/
+static uint16_t rxTail = 0;
+
+/*!
+	\var		rxEvents
+	\brief		Receive callbacks per reason
+*/
+static uint32_t rxEvents[eUART_RX_EVENTS];
+
+/*!
+	\var		rxBytes
+	\brief		Bytes taken from rxRing
+*/
+static uint32_t rxBytes = 0;
+
+/*!
+	\var		rxDropped
+	\brief		Bytes lost because too many arrived while a handler ran
+*/
+static uint32_t rxDropped = 0;
+
+/*!
+	\var		rxData
+	\brief		Simulated LPUART0 data register
+*/
+static uint8_t rxData = 0;
+
+/*!
+	\var		rxFull
+	\brief		Simulated RDRF flag
+*/
+static uint8_t rxFull = 0;
+
+/*!
+	\var		rxPending
+	\brief		Bytes that arrived while the handler was already running
+*/
+static uint8_t rxPending[64];
+
+/*!
+	\var		rxPendingCount
+	\brief		Number of bytes in rxPending
+*/
+static uint8_t rxPendingCount = 0;
+
+/*!
+	\var		txCount
+	\brief		Bytes the firmware sent through LPUART0
+*/
+static uint32_t txCount = 0;
+
+/*!
+	\var		loopback
+	\brief		Simulated LPUART0 LOOPS bit: sent bytes land in the receiver
+*/
+static uint8_t loopback = 0;
+
+/*!
+	\var		Sim_dwPrimask
+	\brief		Simulated PRIMASK, written by the CMSIS shim in host/
+*/
+uint32_t Sim_dwPrimask = 0;
+
+/*!
+	\var		pwmRunning
+	\brief		Simulated TPM2 CMOD state
+*/
+static uint8_t pwmRunning = 0;
+
+/*!
+	\var		pwmStarts
+	\brief		Times the PWM signal was switched on
+*/
+static uint32_t pwmStarts = 0;
+
+/*!
+	\var		rtcSeconds
+	\brief		RTC time when rtcSetUs was the virtual time
+*/
+static uint32_t rtcSeconds = 0;
+
+/*!
+	\var		rtcSetUs
+	\brief		Virtual time of the last RTC write
+*/
+static uint64_t rtcSetUs = 0;
+
+/*!
+	\var		rtcIsSet
+	\brief		Set once the firmware set the RTC
+*/
+static uint8_t rtcIsSet = 0;
+
+/*!
+	\var		isrDepth
+	\brief		Nesting level of simulated interrupt handlers
+*/
+static uint8_t isrDepth = 0;
+
+/*!
+	\var		pinHook
+	\brief		Scenario observer of output changes
+*/
+static SIM_PIN_HOOK pinHook = NULL;
+
+/*!
+	\var		keyHook
+	\brief		Scenario observer of accepted key presses
+*/
+static SIM_KEY_HOOK keyHook = NULL;
+
+/*!
+	\var		pump
+	\brief		Scenario event pump
+*/
+static SIM_PUMP pump = NULL;
+
+/*!
+	\var		isrHook
+	\brief		Scenario observer of blocking interrupt handlers
+*/
+static SIM_ISR_HOOK isrHook = NULL;
+
+/*!
+	\var		requestHook
+	\brief		Scenario observer of clock profile requests
+*/
+static SIM_REQUEST_HOOK requestHook = NULL;
+
+/*!
+	\var		txHook
+	\brief		Receiver of the bytes the firmware sends on the UART
+*/
+static SIM_TX_HOOK txHook = NULL;
+
+/*!
+	\var		clockRequests
+	\brief		Pending clock profile requests, kept only for symmetry checks
+*/
+static uint32_t clockRequests[eCLOCK_PROFILES];
+
+//------------------------------------------------------------------------------
+// Local Functions prototypes
+//------------------------------------------------------------------------------
+static void Sim_vfnOutputChanged (PORTS port, PINS pin, uint32_t before);
+static void Sim_vfnRaiseUartIrq (void);
+static void Sim_vfnRowReleased (uint8_t row);
+static void Sim_vfnScanEnd (void);
+static uint8_t Sim_bfnColumnsSeen (uint8_t rowMask);
+static uint64_t Sim_qwfnNextDue (void);
+static void Sim_vfnRunTimers (void);
+
+//------------------------------------------------------------------------------
+// Simulation control
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Sim_vfnReset (void)
+	\brief		Clears the register model and the virtual clock
+*/
+void Sim_vfnReset (void)
+{
+	memset (ports, 0, sizeof (ports));
+	memset (pressed, 0, sizeof (pressed));
+	acceptedKeys = 0;
+	previousReal = 0;
+	frameSeen = 0;
+	frameReal = 0;
+	memset (timers, 0, sizeof (timers));
+	memset (clockRequests, 0, sizeof (clockRequests));
+	Sim_qwNowUs = 0;
+	rxFull = 0;
+	rxPendingCount = 0;
+	rxHead = 0;
+	rxTail = 0;
+	rxBytes = 0;
+	rxDropped = 0;
+	memset (rxEvents, 0, sizeof (rxEvents));
+	txCount = 0;
+	loopback = 0;
+	Sim_dwPrimask = 0;
+	pwmRunning = 0;
+	pwmStarts = 0;
+	rtcSeconds = 0;
+	rtcSetUs = 0;
+	rtcIsSet = 0;
+	isrDepth = 0;
+}
+
+/*!
+	\fn			void Sim_vfnSetHooks (SIM_PIN_HOOK newPinHook, SIM_KEY_HOOK newKeyHook, SIM_PUMP newPump, SIM_ISR_HOOK newIsrHook, SIM_REQUEST_HOOK newRequestHook)
+	\param		newPinHook		Observer of output changes, may be NULL
+	\param		newKeyHook		Observer of accepted key presses, may be NULL
+	\param		newPump			Event pump, may be NULL
+	\param		newIsrHook		Observer of blocking interrupt handlers, may be NULL
+	\param		newRequestHook	Observer of clock profile requests, may be NULL
+	\brief		Connects the scenario to the simulated hardware
+*/
+void Sim_vfnSetHooks (SIM_PIN_HOOK newPinHook, SIM_KEY_HOOK newKeyHook, SIM_PUMP newPump,
+		SIM_ISR_HOOK newIsrHook, SIM_REQUEST_HOOK newRequestHook)
+{
+	pinHook = newPinHook;
+	keyHook = newKeyHook;
+	pump = newPump;
+	isrHook = newIsrHook;
+	requestHook = newRequestHook;
+}
+
+/*!
+	\fn			void Sim_vfnAdvance (uint64_t us)
+	\param		us	Microseconds of virtual time to let pass
+	\brief		Moves the virtual clock in chunks, pumping the scenario events
+				after every chunk so they can preempt blocking code. Chunks end
+				at every PIT deadline, where the channel interrupt runs.
+*/
+void Sim_vfnAdvance (uint64_t us)
+{
+	uint64_t endUs = Sim_qwNowUs + us;
+	uint64_t dueUs;
+	uint64_t step;
+
+	do
+	{
+		step = endUs - Sim_qwNowUs;
+		if (step > ADVANCE_CHUNK_US)
+		{
+			step = ADVANCE_CHUNK_US;
+		}
+		dueUs = Sim_qwfnNextDue ();
+		if (dueUs < Sim_qwNowUs + step)
+		{
+			step = (dueUs > Sim_qwNowUs) ? (dueUs - Sim_qwNowUs) : 0;
+		}
+		Sim_qwNowUs += step;
+		if (pump != NULL)
+		{
+			pump (Sim_qwNowUs);
+		}
+		Sim_vfnRunTimers ();
+	} while (Sim_qwNowUs < endUs);
+}
+
+/*!
+	\fn			static uint64_t Sim_qwfnNextDue (void)
+	\return		Returns the earliest deadline of the running PIT channels, or
+				UINT64_MAX when none runs or an interrupt is in progress (the
+				PIT cannot preempt itself or another handler of its priority)
+*/
+static uint64_t Sim_qwfnNextDue (void)
+{
+	uint64_t dueUs = UINT64_MAX;
+	uint8_t channel = 0;
+
+	if (isrDepth)
+	{
+		return dueUs;
+	}
+	for (channel = 0; channel < ePIT_CHANNELS; channel++)
+	{
+		if (timers[channel].periodUs && (timers[channel].dueUs < dueUs))
+		{
+			dueUs = timers[channel].dueUs;
+		}
+	}
+	return dueUs;
+}
+
+/*!
+	\fn			static void Sim_vfnRunTimers (void)
+	\brief		Runs the callback of every PIT channel that is due, measuring
+				its virtual duration like any other handler
+*/
+static void Sim_vfnRunTimers (void)
+{
+	SIM_TIMER *timer;
+	uint64_t start;
+	uint8_t channel = 0;
+
+	if (isrDepth)
+	{
+		return;
+	}
+	for (channel = 0; channel < ePIT_CHANNELS; channel++)
+	{
+		timer = &timers[channel];
+		if (!timer->periodUs || (timer->dueUs > Sim_qwNowUs))
+		{
+			continue;
+		}
+		// Expiries missed while another handler ran raise a single interrupt
+		timer->periodUs = timer->loadUs;
+		while (timer->dueUs <= Sim_qwNowUs)
+		{
+			timer->dueUs += timer->periodUs;
+		}
+
+		start = Sim_qwNowUs;
+		isrDepth++;
+		if (timer->callback != NULL)
+		{
+			timer->callback ();
+		}
+		isrDepth--;
+		if ((Sim_qwNowUs - start > SIM_ISR_BUDGET_US) && (isrHook != NULL))
+		{
+			isrHook ("PIT handler over budget", Sim_qwNowUs - start);
+		}
+	}
+}
+
+/*!
+	\fn			void Sim_vfnKey (uint8_t key, uint8_t isPressed)
+	\param		key			Keypad character
+	\param		isPressed	1 to press the key, 0 to release it
+	\brief		Changes the state of a key of the matrix model
+*/
+void Sim_vfnKey (uint8_t key, uint8_t isPressed)
+{
+	uint8_t row = 0;
+	uint8_t column = 0;
+
+	for (row = 0; row < ROWS; row++)
+	{
+		for (column = 0; column < COLUMNS; column++)
+		{
+			if (keyLayout[row][column] == key)
+			{
+				pressed[row][column] = isPressed;
+			}
+		}
+	}
+}
+
+/*!
+	\fn			uint8_t Sim_bfnAnyKeyPressed (void)
+	\return		Returns 1 if any key of the matrix is held down
+*/
+uint8_t Sim_bfnAnyKeyPressed (void)
+{
+	uint8_t row = 0;
+	uint8_t column = 0;
+
+	for (row = 0; row < ROWS; row++)
+	{
+		for (column = 0; column < COLUMNS; column++)
+		{
+			if (pressed[row][column])
+			{
+				return 1;
+			}
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			void Sim_vfnUartRx (uint8_t value)
+	\param		value	Byte received from the Bluetooth module
+	\brief		Loads the byte in the data register and raises the interrupt.
+				A byte arriving while the handler runs stays pending, as the
+				NVIC would keep it, and an unread byte is overrun.
+*/
+void Sim_vfnUartRx (uint8_t value)
+{
+	if (isrDepth)
+	{
+		if (rxPendingCount < sizeof (rxPending))
+		{
+			rxPending[rxPendingCount++] = value;
+		}
+		else
+		{
+			rxDropped++;
+		}
+		return;
+	}
+
+	rxData = value;
+	rxFull = 1;
+	Sim_vfnRaiseUartIrq ();
+}
+
+/*!
+	\fn			uint32_t Sim_dwfnUartTxCount (void)
+	\return		Returns the number of bytes the firmware sent
+*/
+uint32_t Sim_dwfnUartTxCount (void)
+{
+	return txCount;
+}
+
+/*!
+	\fn			void Sim_vfnSetTxHook (SIM_TX_HOOK newTxHook)
+	\param		newTxHook	Receiver of the transmitted bytes, may be NULL
+*/
+void Sim_vfnSetTxHook (SIM_TX_HOOK newTxHook)
+{
+	txHook = newTxHook;
+}
+
+/*!
+	\fn			uint8_t Sim_bfnOutput (PORTS port, PINS pin)
+	\return		Returns the level the firmware drives on an output pin
+*/
+uint8_t Sim_bfnOutput (PORTS port, PINS pin)
+{
+	return !!(ports[port].pdor & (1u << pin));
+}
+
+/*!
+	\fn			uint32_t Sim_dwfnPwmStarts (void)
+	\return		Returns how many times the buzzer PWM was switched on
+*/
+uint32_t Sim_dwfnPwmStarts (void)
+{
+	return pwmStarts;
+}
+
+/*!
+	\fn			static uint8_t Sim_bfnColumnsSeen (uint8_t rowMask)
+	\param		rowMask		Rows driven high
+	\return		Returns the columns that read high. Without diodes the current
+				also flows backwards through pressed keys, so a column is seen
+				when any chain of pressed keys connects it to a driven row.
+*/
+static uint8_t Sim_bfnColumnsSeen (uint8_t rowMask)
+{
+	uint8_t columns = 0;
+	uint8_t previousColumns;
+	uint8_t previousRows;
+	uint8_t row = 0;
+	uint8_t column = 0;
+
+	do
+	{
+		previousColumns = columns;
+		previousRows = rowMask;
+		for (row = 0; row < ROWS; row++)
+		{
+			for (column = 0; column < COLUMNS; column++)
+			{
+				if (!pressed[row][column])
+				{
+					continue;
+				}
+				if (rowMask & (1u << row))
+				{
+					columns |= (uint8_t)(1u << column);
+				}
+				if (columns & (1u << column))
+				{
+					rowMask |= (uint8_t)(1u << row);
+				}
+			}
+		}
+	} while ((columns != previousColumns) || (rowMask != previousRows));
+
+	return columns;
+}
+
+/*!
+	\fn			static void Sim_vfnRowReleased (uint8_t row)
+	\param		row		Row the firmware stopped driving
+	\brief		The firmware reads the columns of a row right before releasing
+				it, so this is when the row is sampled. A scan may strobe its
+				rows in one pass or one per tick; either way the frame ends
+				with the last row.
+*/
+static void Sim_vfnRowReleased (uint8_t row)
+{
+	uint8_t column = 0;
+
+	frameSeen &= (uint16_t)~(0x7u << (row * COLUMNS));
+	frameReal &= (uint16_t)~(0x7u << (row * COLUMNS));
+	frameSeen |= (uint16_t)(Sim_bfnColumnsSeen ((uint8_t)(1u << row)) << (row * COLUMNS));
+	for (column = 0; column < COLUMNS; column++)
+	{
+		frameReal |= (uint16_t)(pressed[row][column] << (row * COLUMNS + column));
+	}
+
+	if (row == ROWS - 1)
+	{
+		Sim_vfnScanEnd ();
+	}
+}
+
+/*!
+	\fn			static void Sim_vfnScanEnd (void)
+	\brief		Applies the keypad specification at the end of every complete
+				scan: each key is accepted once per press, even while others
+				are held, unless the electrical reading is ambiguous (two rows
+				sharing two columns), in which case nothing changes. With three
+				or more keys read, a new key must be held on two unambiguous
+				scans in a row.
+*/
+static void Sim_vfnScanEnd (void)
+{
+	uint16_t real = frameReal;
+	uint16_t seen = frameSeen;
+	uint16_t pressedNow;
+	uint16_t pairs;
+	uint8_t shared;
+	uint8_t row = 0;
+	uint8_t other = 0;
+	uint8_t column = 0;
+
+	for (row = 0; row < ROWS; row++)
+	{
+		for (other = row + 1; other < ROWS; other++)
+		{
+			shared = (uint8_t)((seen >> (row * COLUMNS)) & (seen >> (other * COLUMNS))) & 0x7u;
+			if (shared & (shared - 1u))
+			{
+				previousReal = 0;
+				return;
+			}
+		}
+	}
+
+	pairs = seen & (seen - 1u);
+	if (pairs & (pairs - 1u))
+	{
+		real &= (uint16_t)~(real & ~acceptedKeys & ~previousReal);
+	}
+	previousReal = frameReal;
+
+	pressedNow = real & ~acceptedKeys;
+	acceptedKeys = real;
+	for (row = 0; row < ROWS; row++)
+	{
+		for (column = 0; column < COLUMNS; column++)
+		{
+			if ((pressedNow & (1u << (row * COLUMNS + column))) && (keyHook != NULL))
+			{
+				keyHook (keyLayout[row][column]);
+			}
+		}
+	}
+	if ((real == CHORD_CANCEL) && (pressedNow & CHORD_CANCEL) && (keyHook != NULL))
+	{
+		keyHook (SIM_KEY_CANCEL);
+	}
+}
+
+/*!
+	\fn			static void Sim_vfnOutputChanged (PORTS port, PINS pin, uint32_t before)
+	\brief		Samples every keypad row as it is released (row 3 going low
+				ends a scan) and reports the output change to the scenario
+*/
+static void Sim_vfnOutputChanged (PORTS port, PINS pin, uint32_t before)
+{
+	uint32_t mask = 1u << pin;
+	uint8_t row = 0;
+
+	if ((port == ePORTD) && (before & mask) && !(ports[port].pdor & mask))
+	{
+		for (row = 0; row < ROWS; row++)
+		{
+			if (pin == rowPins[row])
+			{
+				Sim_vfnRowReleased (row);
+			}
+		}
+	}
+
+	if (((before ^ ports[port].pdor) & mask) && (pinHook != NULL))
+	{
+		pinHook (port, pin, !!(ports[port].pdor & mask));
+	}
+}
+
+/*!
+	\fn			static void Sim_vfnRaiseUartIrq (void)
+	\brief		Runs the LPUART0 handler, measuring its virtual duration, and
+				then any byte that became pending meanwhile
+*/
+static void Sim_vfnRaiseUartIrq (void)
+{
+	uint64_t start = Sim_qwNowUs;
+	uint64_t duration;
+	uint8_t i = 0;
+
+	isrDepth++;
+	LPUART0_DriverIRQHandler ();
+	isrDepth--;
+
+	duration = Sim_qwNowUs - start;
+	if ((duration > SIM_ISR_BUDGET_US) && (isrHook != NULL))
+	{
+		isrHook ("handler over budget", duration);
+	}
+
+	if (rxPendingCount)
+	{
+		rxData = rxPending[0];
+		rxFull = 1;
+		rxPendingCount--;
+		for (i = 0; i < rxPendingCount; i++)
+		{
+			rxPending[i] = rxPending[i + 1];
+		}
+		Sim_vfnRaiseUartIrq ();
+	}
+}
+
+//------------------------------------------------------------------------------
+// GPIO.h
+//------------------------------------------------------------------------------
+void GPIO_vfnPortInit(PORTS port, PINS pin, IO io)
+{
+	if (io)
+	{
+		ports[port].pddr |= (1u << pin);
+	}
+	else
+	{
+		ports[port].pddr &= ~(1u << pin);
+	}
+}
+
+uint8_t GPIO_bfnSetData(PORTS port, PINS pin)
+{
+	uint32_t before = ports[port].pdor;
+
+	if (!(ports[port].pddr & (1u << pin)))
+	{
+		return 0;
+	}
+	ports[port].pdor |= (1u << pin);
+	Sim_vfnOutputChanged (port, pin, before);
+	return 1;
+}
+
+uint8_t GPIO_bfnClearData(PORTS port, PINS pin)
+{
+	uint32_t before = ports[port].pdor;
+
+	if (!(ports[port].pddr & (1u << pin)))
+	{
+		return 0;
+	}
+	ports[port].pdor &= ~(1u << pin);
+	Sim_vfnOutputChanged (port, pin, before);
+	return 1;
+}
+
+uint8_t GPIO_bfnToggleData(PORTS port, PINS pin)
+{
+	uint32_t before = ports[port].pdor;
+
+	if (!(ports[port].pddr & (1u << pin)))
+	{
+		return 0;
+	}
+	ports[port].pdor ^= (1u << pin);
+	Sim_vfnOutputChanged (port, pin, before);
+	return 1;
+}
+
+uint8_t GPIO_bfnData(PORTS port, PINS pin, uint8_t *value)
+{
+	if (*value)
+	{
+		return GPIO_bfnSetData (port, pin);
+	}
+	else
+	{
+		return GPIO_bfnClearData (port, pin);
+	}
+}
+
+/*!
+	\fn			uint8_t GPIO_bfnReadData(PORTS port, PINS pin, uint8_t *value)
+	\brief		Reads an input. The keypad columns (PTD4, PTD5, PTB3) read high
+				when pressed keys connect them to a row driven high.
+*/
+uint8_t GPIO_bfnReadData(PORTS port, PINS pin, uint8_t *value)
+{
+	int8_t column = -1;
+	uint8_t row = 0;
+	uint8_t rowMask = 0;
+
+	if (ports[port].pddr & (1u << pin))
+	{
+		return 0;
+	}
+
+	if ((port == ePORTD) && (pin == ePIN4))
+	{
+		column = 0;
+	}
+	else if ((port == ePORTD) && (pin == ePIN5))
+	{
+		column = 1;
+	}
+	else if ((port == ePORTB) && (pin == ePIN3))
+	{
+		column = 2;
+	}
+
+	*value = 0;
+	if (column >= 0)
+	{
+		for (row = 0; row < ROWS; row++)
+		{
+			if (ports[ePORTD].pdor & (1u << rowPins[row]))
+			{
+				rowMask |= (uint8_t)(1u << row);
+			}
+		}
+		*value = !!(Sim_bfnColumnsSeen (rowMask) & (1u << column));
+	}
+	return 1;
+}
+
+//------------------------------------------------------------------------------
+// UART.h
+//------------------------------------------------------------------------------
+void UART_vfnDriverInit(void)
+{
+}
+
+void UART_vfnClockChanged(uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+	(void)irClock;
+}
+
+void UART_vfnCallbackReg(UART_RX_CALLBACK ptr)
+{
+	if (ptr != NULL)
+	{
+		uartCallback = ptr;
+	}
+}
+
+void LPUART0_DriverIRQHandler()
+{
+	if (!rxFull)
+	{
+		return;
+	}
+	rxRing[rxHead] = rxData;
+	rxHead = (rxHead + 1u) & (UART_RX_RING - 1u);
+	rxFull = 0;
+	rxEvents[eUART_RX_BYTE]++;
+	if (uartCallback != NULL)
+	{
+		uartCallback (eUART_RX_BYTE);
+	}
+}
+
+uint16_t UART_wfnReceive(uint8_t *data, uint16_t size)
+{
+	uint16_t count = 0;
+
+	while ((rxTail != rxHead) && (count < size))
+	{
+		data[count++] = rxRing[rxTail];
+		rxTail = (rxTail + 1u) & (UART_RX_RING - 1u);
+	}
+	rxBytes += count;
+	return count;
+}
+
+uint32_t UART_dwfnGetRxEvents(UART_RX_EVENT event)
+{
+	return rxEvents[event];
+}
+
+uint32_t UART_dwfnGetRxBytes(void)
+{
+	return rxBytes;
+}
+
+uint32_t UART_dwfnGetRxDropped(void)
+{
+	return rxDropped;
+}
+
+uint8_t UART_bfnRead(uint8_t *readVal)
+{
+	if (!rxFull)
+	{
+		return 0;
+	}
+	*readVal = rxData;
+	rxFull = 0;
+	return 1;
+}
+
+uint8_t UART_bfnSend(uint8_t *sendVal)
+{
+	txCount++;
+	if (txHook != NULL)
+	{
+		txHook (*sendVal);
+	}
+	if (loopback)
+	{
+		rxData = *sendVal;
+		rxFull = 1;
+	}
+	return 1;
+}
+
+void UART_vfnLoopback(uint8_t enable)
+{
+	loopback = enable;
+}
+
+//------------------------------------------------------------------------------
+// PWM.h
+//------------------------------------------------------------------------------
+void PWM_vfnDriverInit()
+{
+	pwmRunning = 0;
+}
+
+uint8_t PWM_bfnAngleAdjustment (uint8_t bNewAngle)
+{
+	return bNewAngle <= 180;
+}
+
+uint8_t PWM_bInitialPosition (void)
+{
+	return 1;
+}
+
+uint8_t PWM_bfnChangeCounter (uint16_t counter)
+{
+	(void)counter;
+	return 1;
+}
+
+void PWM_vfnToggleSignal (void)
+{
+	pwmRunning ^= 1;
+	if (pwmRunning)
+	{
+		pwmStarts++;
+	}
+	// The buzzer is reported as a level change of its pin, PTB18
+	if (pinHook != NULL)
+	{
+		pinHook (ePORTB, ePIN18, pwmRunning);
+	}
+}
+
+void PWM_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+	(void)irClock;
+}
+
+//------------------------------------------------------------------------------
+// serviceLayer.h
+//------------------------------------------------------------------------------
+/*!
+	\fn			void delay (uint32_t count)
+	\brief		Advances virtual time instead of spinning. A delay inside an
+				interrupt handler is reported as blocking.
+*/
+void delay (uint32_t count)
+{
+	if (isrDepth && (isrHook != NULL))
+	{
+		isrHook ("delay() called from a handler", count / SIM_DELAY_COUNTS_PER_US);
+	}
+	Sim_vfnAdvance (count / SIM_DELAY_COUNTS_PER_US);
+}
+
+void Delay_vfnClockChanged (uint32_t coreClock)
+{
+	(void)coreClock;
+}
+
+//------------------------------------------------------------------------------
+// Timebase.h
+//------------------------------------------------------------------------------
+void Timebase_vfnInit (void)
+{
+}
+
+uint32_t Timebase_dwfnGetCycles (void)
+{
+	return (uint32_t)(Sim_qwNowUs * (SIM_CORE_HZ / 1000000u));
+}
+
+uint32_t Timebase_dwfnCyclesToUs (uint32_t cycles)
+{
+	return cycles / (SIM_CORE_HZ / 1000000u);
+}
+
+void Timebase_vfnClockChanged (uint32_t coreClock)
+{
+	(void)coreClock;
+}
+
+void Timebase_vfnStartTick (void)
+{
+}
+
+uint32_t Timebase_dwfnGetMs (void)
+{
+	return (uint32_t)(Sim_qwNowUs / 1000u);
+}
+
+//------------------------------------------------------------------------------
+// PIT.h
+//------------------------------------------------------------------------------
+void PIT_vfnDriverInit (void)
+{
+}
+
+void PIT_vfnStart (PIT_CHANNEL channel, uint32_t periodUs, PIT_CALLBACK callback)
+{
+	timers[channel].callback = callback;
+	timers[channel].periodUs = periodUs;
+	timers[channel].loadUs = periodUs;
+	timers[channel].dueUs = Sim_qwNowUs + periodUs;
+}
+
+void PIT_vfnSetPeriod (PIT_CHANNEL channel, uint32_t periodUs)
+{
+	timers[channel].loadUs = periodUs;
+}
+
+void PIT_vfnStop (PIT_CHANNEL channel)
+{
+	timers[channel].periodUs = 0;
+}
+
+void PIT_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+	(void)irClock;
+}
+
+//------------------------------------------------------------------------------
+// PORT.h
+//------------------------------------------------------------------------------
+uint8_t PORT_bfnRegister (PORTS port, PINS pin, PORT_MODE mode, uint16_t debounceMs,
+		PORT_CALLBACK callback)
+{
+	(void)port;
+	(void)pin;
+	(void)mode;
+	(void)debounceMs;
+	(void)callback;
+	return 0;
+}
+
+void PORT_vfnUnregister (PORTS port, PINS pin)
+{
+	(void)port;
+	(void)pin;
+}
+
+void PORT_vfnTask (void)
+{
+}
+
+//------------------------------------------------------------------------------
+// ADC.h
+//------------------------------------------------------------------------------
+/*
+ * The supply is not simulated: no block ever arrives, so the power budget
+ * has no measurement and grants every load.
+ */
+uint8_t ADC_bfnDriverInit (void)
+{
+	return 1;
+}
+
+void ADC_vfnStart (uint8_t channel, uint32_t periodMs, ADC_BLOCK_CALLBACK callback)
+{
+	(void)channel;
+	(void)periodMs;
+	(void)callback;
+}
+
+void ADC_vfnStop (void)
+{
+}
+
+void ADC_vfnClockChanged (uint32_t coreClock, uint32_t irClock)
+{
+	(void)coreClock;
+	(void)irClock;
+}
+
+void DMA2_DriverIRQHandler (void)
+{
+}
+
+//------------------------------------------------------------------------------
+// RTC.h
+//------------------------------------------------------------------------------
+/*
+ * TSR follows the virtual clock, but the seconds interrupt is not raised:
+ * the access slot only moves when the time is set.
+ */
+void RTC_vfnDriverInit (void)
+{
+}
+
+void RTC_vfnSetTime (uint32_t seconds)
+{
+	rtcSeconds = seconds;
+	rtcSetUs = Sim_qwNowUs;
+	rtcIsSet = 1;
+}
+
+uint32_t RTC_dwfnGetTime (void)
+{
+	return rtcSeconds + (uint32_t)((Sim_qwNowUs - rtcSetUs) / 1000000u);
+}
+
+uint8_t RTC_bfnIsSet (void)
+{
+	return rtcIsSet;
+}
+
+void RTC_vfnCallbackReg (RTC_SECONDS_CALLBACK callback)
+{
+	(void)callback;
+}
+
+void RTC_Seconds_DriverIRQHandler (void)
+{
+}
+
+//------------------------------------------------------------------------------
+// ClockProfile.h
+//------------------------------------------------------------------------------
+void ClockProfile_vfnInit (void)
+{
+}
+
+uint8_t ClockProfile_bfnRegister (CLOCK_LISTENER listener)
+{
+	return listener != NULL;
+}
+
+void ClockProfile_vfnRequest (CLOCK_PROFILE profile)
+{
+	clockRequests[profile]++;
+	if (requestHook != NULL)
+	{
+		requestHook (profile);
+	}
+}
+
+void ClockProfile_vfnRelease (CLOCK_PROFILE profile)
+{
+	if (clockRequests[profile])
+	{
+		clockRequests[profile]--;
+	}
+}
+
+void ClockProfile_vfnTask (void)
+{
+}
+
+uint8_t ClockProfile_bfnSwitch (CLOCK_PROFILE profile)
+{
+	return profile < eCLOCK_PROFILES;
+}
+
+CLOCK_PROFILE ClockProfile_efnGetCurrent (void)
+{
+	return eCLOCK_PROFILE_RUN_8M;
+}
+
+uint32_t ClockProfile_dwfnGetIrClock (void)
+{
+	return SIM_CORE_HZ;
+}
+//------------------------------------------------------------------------------
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------------
+/*!
+	\file   	SimHAL.h
+	\date		October 19th, 2026
+	\brief		Function declaration of the simulated HAL. It replaces the
+				3_HAL drivers and the register based 4_SL services on the host
+				so the real 1_APP and 2_HIL sources run against a virtual clock,
+				a keypad matrix model and a scripted Bluetooth UART.
+*/
+//------------------------------------------------------------------------------
+#ifndef SIMHAL_H_
+#define SIMHAL_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include "GPIO.h"
+#include "ClockProfile.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		SIM_CORE_HZ
+	\brief		Core clock the simulated cycle counter runs at
+*/
+#define		SIM_CORE_HZ			8000000u
+
+/*!
+	\def		SIM_DELAY_COUNTS_PER_US
+	\brief		delay() loop iterations per microsecond at the 8 MHz reference
+				clock (about four cycles per iteration)
+*/
+#define		SIM_DELAY_COUNTS_PER_US		2u
+
+/*!
+	\def		SIM_ISR_BUDGET_US
+	\brief		Longest an interrupt handler may run before it counts as
+				blocking: one character time at 9600 baud
+*/
+#define		SIM_ISR_BUDGET_US	1040u
+
+/*!
+	\def		SIM_KEY_CANCEL
+	\brief		Reported by the key hook when exactly '*' and '#' become held,
+				the chord that discards a partial entry
+*/
+#define		SIM_KEY_CANCEL		'C'
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\typedef	SIM_PIN_HOOK
+	\brief		Called every time the firmware changes the level of an output
+*/
+typedef void (*SIM_PIN_HOOK)(PORTS port, PINS pin, uint8_t level);
+
+/*!
+	\typedef	SIM_KEY_HOOK
+	\brief		Called when a key press is accepted according to the keypad
+				specification: once per press at the end of the first scan
+				that sees it, unless the scan was ambiguous (ghosting)
+*/
+typedef void (*SIM_KEY_HOOK)(uint8_t key);
+
+/*!
+	\typedef	SIM_PUMP
+	\brief		Called whenever virtual time advances, so the scenario can
+				deliver its due events (key presses, UART bytes) as interrupts
+*/
+typedef void (*SIM_PUMP)(uint64_t nowUs);
+
+/*!
+	\typedef	SIM_ISR_HOOK
+	\brief		Called when an interrupt handler blocked: ran longer than the
+				budget or called a blocking delay
+*/
+typedef void (*SIM_ISR_HOOK)(const char *reason, uint64_t durationUs);
+
+/*!
+	\typedef	SIM_REQUEST_HOOK
+	\brief		Called when the firmware requests a clock profile. The state
+				machine requests full speed right before it compares pinData,
+				so this is the exact evaluation point
+*/
+typedef void (*SIM_REQUEST_HOOK)(CLOCK_PROFILE profile);
+
+/*!
+	\typedef	SIM_TX_HOOK
+	\brief		Called with every byte the firmware sends on the UART
+*/
+typedef void (*SIM_TX_HOOK)(uint8_t value);
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+extern uint64_t Sim_qwNowUs;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Sim_vfnReset (void);
+
+void Sim_vfnSetHooks (SIM_PIN_HOOK pinHook, SIM_KEY_HOOK keyHook, SIM_PUMP pump,
+		SIM_ISR_HOOK isrHook, SIM_REQUEST_HOOK requestHook);
+
+void Sim_vfnAdvance (uint64_t us);
+
+void Sim_vfnKey (uint8_t key, uint8_t pressed);
+
+uint8_t Sim_bfnAnyKeyPressed (void);
+
+void Sim_vfnUartRx (uint8_t value);
+
+uint32_t Sim_dwfnUartTxCount (void);
+
+void Sim_vfnSetTxHook (SIM_TX_HOOK txHook);
+
+uint8_t Sim_bfnOutput (PORTS port, PINS pin);
+
+uint32_t Sim_dwfnPwmStarts (void);
+
+#endif /* SIMHAL_H_ */
@@ -0,0 +1,273 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		HostSupport.c
+	\brief		Scaffolding shared by the host harnesses under Tools. The
+				stubs keep what the firmware hands them where the harness
+				reads it: the UART bytes sent, the clock profiles requested
+				and released; and return what the harness sets: the tick,
+				the RTC time and the bytes of the command line being
+				received.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <string.h>
+#include "UART.h"
+#include "RTC.h"
+#include "Timebase.h"
+#include "Protocol.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+/*!
+	\var		Sim_dwPrimask
+	\brief		PRIMASK of cmsis_compiler.h
+*/
+uint32_t Sim_dwPrimask = 0;
+
+/*!
+	\var		Host_dwFailures
+	\brief		Expectations CHECK found false
+*/
+uint32_t Host_dwFailures = 0;
+
+/*!
+	\var		Host_bVerbose
+	\brief		Set by --verbose: every command and its replies are printed
+*/
+uint8_t Host_bVerbose = 0;
+
+/*!
+	\var		Host_dwNowMs
+	\brief		Returned by Timebase_dwfnGetMs
+*/
+uint32_t Host_dwNowMs = 0;
+
+/*!
+	\var		Host_dwRtcTime, Host_bRtcIsSet
+	\brief		Returned by RTC_dwfnGetTime and RTC_bfnIsSet
+*/
+uint32_t Host_dwRtcTime = 0;
+uint8_t Host_bRtcIsSet = 0;
+
+/*!
+	\var		Host_adwClockRequests, Host_adwClockReleases
+	\brief		Calls of ClockProfile_vfnRequest and ClockProfile_vfnRelease
+				per profile
+*/
+uint32_t Host_adwClockRequests[eCLOCK_PROFILES];
+uint32_t Host_adwClockReleases[eCLOCK_PROFILES];
+
+/*!
+	\var		Host_acUartOut
+	\brief		Bytes sent on the UART since the last command
+*/
+char Host_acUartOut[HOST_UART_OUT];
+uint16_t Host_wUartOutLength = 0;
+
+/*!
+	\var		rxCallback
+	\brief		Receive callback Protocol.c registers
+*/
+static UART_RX_CALLBACK rxCallback = NULL;
+
+/*!
+	\var		rxData, rxLength
+	\brief		Bytes of the command line not received yet
+*/
+static const char *rxData = NULL;
+static uint16_t rxLength = 0;
+
+//------------------------------------------------------------------------------
+// Firmware stubs
+//------------------------------------------------------------------------------
+void UART_vfnDriverInit (void)
+{
+}
+
+void UART_vfnCallbackReg (UART_RX_CALLBACK ptr)
+{
+	rxCallback = ptr;
+}
+
+uint16_t UART_wfnReceive (uint8_t *data, uint16_t size)
+{
+	uint16_t count = (rxLength < size) ? rxLength : size;
+
+	memcpy (data, rxData, count);
+	rxData += count;
+	rxLength = (uint16_t)(rxLength - count);
+	return count;
+}
+
+uint32_t UART_dwfnGetRxEvents (UART_RX_EVENT event)
+{
+	(void)event;
+	return 0;
+}
+
+uint32_t UART_dwfnGetRxBytes (void)
+{
+	return 0;
+}
+
+uint32_t UART_dwfnGetRxDropped (void)
+{
+	return 0;
+}
+
+uint8_t UART_bfnSend (uint8_t *sendVal)
+{
+	if (Host_wUartOutLength < sizeof (Host_acUartOut) - 1)
+	{
+		Host_acUartOut[Host_wUartOutLength++] = (char)*sendVal;
+	}
+	return 1;
+}
+
+void RTC_vfnDriverInit (void)
+{
+}
+
+void RTC_vfnSetTime (uint32_t seconds)
+{
+	Host_dwRtcTime = seconds;
+	Host_bRtcIsSet = 1;
+}
+
+uint32_t RTC_dwfnGetTime (void)
+{
+	return Host_dwRtcTime;
+}
+
+uint8_t RTC_bfnIsSet (void)
+{
+	return Host_bRtcIsSet;
+}
+
+void RTC_vfnCallbackReg (RTC_SECONDS_CALLBACK callback)
+{
+	(void)callback;
+}
+
+void ClockProfile_vfnRequest (CLOCK_PROFILE profile)
+{
+	Host_adwClockRequests[profile]++;
+}
+
+void ClockProfile_vfnRelease (CLOCK_PROFILE profile)
+{
+	Host_adwClockReleases[profile]++;
+}
+
+void ClockProfile_vfnTask (void)
+{
+}
+
+uint32_t Timebase_dwfnGetMs (void)
+{
+	return Host_dwNowMs;
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			void Host_vfnInit (int argc, char **argv)
+	\brief		Takes --verbose from the command line; a harness with
+				options of its own skips it
+*/
+void Host_vfnInit (int argc, char **argv)
+{
+	int i;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp (argv[i], "--verbose"))
+		{
+			Host_bVerbose = 1;
+		}
+	}
+}
+
+/*!
+	\fn			int Host_ifnResult (void)
+	\return		Returns the exit code of the harness
+	\brief		Prints PASS, or FAIL if any CHECK failed
+*/
+int Host_ifnResult (void)
+{
+	printf ("%s\n", Host_dwFailures ? "FAIL" : "PASS");
+	return Host_dwFailures ? 1 : 0;
+}
+
+/*!
+	\fn			const char *Host_pcfnCommand (const char *line, int index)
+	\param		line	Command without its '$' and line end, or NULL
+	\param		index	Reply to return, 0 for the first
+	\return		Returns reply number index without its '$' and line end,
+				"" if there are fewer
+	\brief		Sends a command line over the UART and runs the main loop
+				task that executes it. With line NULL the replies of the
+				last command are read again.
+*/
+const char *Host_pcfnCommand (const char *line, int index)
+{
+	static char text[96];
+
+	if (line != NULL)
+	{
+		snprintf (text, sizeof (text), "%c%s\n", PROTOCOL_START, line);
+		rxData = text;
+		rxLength = (uint16_t)strlen (text);
+		Host_wUartOutLength = 0;
+		rxCallback (eUART_RX_IDLE);
+		Protocol_vfnTask ();
+		Host_acUartOut[Host_wUartOutLength] = '\0';
+		if (Host_bVerbose)
+		{
+			printf ("> %s\n< %s", line, Host_acUartOut);
+		}
+	}
+	return Host_pcfnReply (Host_acUartOut, index);
+}
+
+/*!
+	\fn			const char *Host_pcfnReply (const char *output, int index)
+	\param		output	Replies as Protocol.c sent them, '\0' ended
+	\param		index	Reply to return, 0 for the first
+	\return		Returns reply number index without its '$' and line end,
+				"" if there are fewer
+*/
+const char *Host_pcfnReply (const char *output, int index)
+{
+	static char reply[96];
+	const char *start = output;
+	const char *end;
+	int i;
+
+	for (i = 0; (i < index) && start; i++)
+	{
+		start = strchr (start, '\n');
+		start = start ? start + 1 : NULL;
+	}
+	if (!start || (start[0] != PROTOCOL_START))
+	{
+		return "";
+	}
+	end = strchr (start, '\r');
+	snprintf (reply, sizeof (reply), "%.*s", end ? (int)(end - start - 1) : (int)strlen (start + 1), start + 1);
+	return reply;
+}
+
+/*!
+	\fn			void Host_vfnIgnoreByte (uint8_t value)
+	\brief		Byte handler for Protocol_vfnDriverInit of a harness that
+				sends no pin digits
+*/
+void Host_vfnIgnoreByte (uint8_t value)
+{
+	(void)value;
+}
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		HostSupport.h
+	\brief		Scaffolding shared by the host harnesses under Tools: the
+				CHECK macro, the command line, the PRIMASK variable of
+				cmsis_compiler.h and stubs of the UART, the RTC, the clock
+				profiles and the millisecond tick the harnesses drive, plus
+				a helper that sends a command line to Protocol.c and reads
+				its replies back. A harness links HostSupport.c and keeps
+				only the stubs and the models of its own module.
+*/
+//------------------------------------------------------------------------------
+#ifndef HOST_SUPPORT_H_
+#define HOST_SUPPORT_H_
+
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdint.h>
+#include <stdio.h>
+#include "ClockProfile.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		CHECK
+	\brief		Records a failed expectation and goes on
+*/
+#define		CHECK(cond, ...)	do { if (!(cond)) { Host_dwFailures++; \
+									printf ("FAIL %s:%d ", __func__, __LINE__); \
+									printf (__VA_ARGS__); printf ("\n"); } } while (0)
+
+/*!
+	\def		HOST_UART_OUT
+	\brief		Bytes of UART output kept per command
+*/
+#define		HOST_UART_OUT		512u
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+extern uint32_t Host_dwFailures;
+extern uint8_t Host_bVerbose;
+
+extern uint32_t Host_dwNowMs;
+extern uint32_t Host_dwRtcTime;
+extern uint8_t Host_bRtcIsSet;
+extern uint32_t Host_adwClockRequests[eCLOCK_PROFILES];
+extern uint32_t Host_adwClockReleases[eCLOCK_PROFILES];
+
+extern char Host_acUartOut[HOST_UART_OUT];
+extern uint16_t Host_wUartOutLength;
+
+//--------------------------------------------------------------------------
+// Functions
+//--------------------------------------------------------------------------
+void Host_vfnInit (int argc, char **argv);
+
+int Host_ifnResult (void);
+
+const char *Host_pcfnCommand (const char *line, int index);
+
+const char *Host_pcfnReply (const char *output, int index);
+
+void Host_vfnIgnoreByte (uint8_t value);
+
+#endif /* HOST_SUPPORT_H_ */
@@ -0,0 +1,68 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		cmsis_compiler.h
+	\brief		Host replacement for the CMSIS compiler layer. The Makefiles
+				force-include it and define __CMSIS_GCC_H, so the ARM inline
+				assembly of cmsis_gcc.h is never seen by the host compiler.
+				PRIMASK is kept in a variable owned by SimHAL.c, or by
+				HostSupport.c in the harnesses that do not link it.
+*/
+//------------------------------------------------------------------------------
+#ifndef HOST_CMSIS_COMPILER_H_
+#define HOST_CMSIS_COMPILER_H_
+
+#include <stdint.h>
+
+#define __ASM						__asm
+#define __INLINE					inline
+#define __STATIC_INLINE				static inline
+#define __STATIC_FORCEINLINE		static inline
+#define __NO_RETURN					__attribute__((__noreturn__))
+#define __USED						__attribute__((used))
+#define __WEAK						__attribute__((weak))
+#define __PACKED					__attribute__((packed, aligned(1)))
+#define __PACKED_STRUCT				struct __attribute__((packed, aligned(1)))
+#define __PACKED_UNION				union __attribute__((packed, aligned(1)))
+#define __ALIGNED(x)				__attribute__((aligned(x)))
+#define __RESTRICT					__restrict
+#define __COMPILER_BARRIER()		__asm volatile("" ::: "memory")
+
+extern uint32_t Sim_dwPrimask;
+
+static inline uint32_t __get_PRIMASK (void)
+{
+	return Sim_dwPrimask;
+}
+
+static inline void __set_PRIMASK (uint32_t priMask)
+{
+	Sim_dwPrimask = priMask;
+}
+
+static inline void __disable_irq (void)
+{
+	Sim_dwPrimask = 1;
+}
+
+static inline void __enable_irq (void)
+{
+	Sim_dwPrimask = 0;
+}
+
+static inline uint32_t __get_IPSR (void)
+{
+	return 0;
+}
+
+#define __NOP()						__COMPILER_BARRIER()
+#define __WFI()						__COMPILER_BARRIER()
+#define __WFE()						__COMPILER_BARRIER()
+#define __SEV()						__COMPILER_BARRIER()
+#define __DSB()						__COMPILER_BARRIER()
+#define __ISB()						__COMPILER_BARRIER()
+#define __DMB()						__COMPILER_BARRIER()
+#define __BKPT(value)				__builtin_trap()
+#define __REV(value)				__builtin_bswap32(value)
+#define __CLZ(value)				((uint8_t)((value) ? __builtin_clz(value) : 32))
+
+#endif /* HOST_CMSIS_COMPILER_H_ */
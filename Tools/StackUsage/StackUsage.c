@@ -0,0 +1,536 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		StackUsage.c
+	\date		October 19th, 2026
+	\brief		Worst-case stack estimate from the call graphs GCC writes
+				with -fcallgraph-info=su: one .ci file per object, with the
+				frame of every function and its calls.
+
+				Usage:
+					stackusage [--root name]... [--indirect bytes] [--nested]
+						[--reserve bytes] <file.ci>...
+
+				The roots are main and every function whose name ends in
+				Handler, plus the --root ones. The depth of a function is
+				its frame and the deepest of its calls. A call through a
+				pointer counts as the deepest function nothing calls
+				directly, the callbacks and command handlers, themselves
+				measured without their calls through pointers, unless
+				--indirect gives the bytes of such a call. Recursion
+				counts once. A depth marked '+' is a lower bound: somewhere
+				below it is a recursion, a dynamic frame or a function
+				without a call graph, as the C library.
+
+				The worst case is main, the deepest interrupt and its
+				exception frame; interrupts of one priority cannot preempt
+				each other. With --nested every interrupt is added, for
+				interrupts of different priorities. The exit status is 1
+				when the worst case exceeds the reserve.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		MAX_FUNCTIONS, MAX_CALLS, MAX_ROOTS
+	\brief		Sizes of the call graph
+*/
+#define		MAX_FUNCTIONS		4096
+#define		MAX_CALLS			16384
+#define		MAX_ROOTS			64
+
+/*!
+	\def		MAX_NAME
+	\brief		Longest function name kept, with the file of a static one
+*/
+#define		MAX_NAME			96
+
+/*!
+	\def		MAX_LINE
+	\brief		Longest .ci line read
+*/
+#define		MAX_LINE			1024
+
+/*!
+	\def		EXCEPTION_FRAME
+	\brief		Bytes the core stacks on an exception entry, aligned
+*/
+#define		EXCEPTION_FRAME		36u
+
+/*!
+	\def		INDIRECT
+	\brief		Name GCC gives the target of a call through a pointer
+*/
+#define		INDIRECT			"__indirect_call"
+
+/*!
+	\def		TOP_FRAMES
+	\brief		Largest frames listed
+*/
+#define		TOP_FRAMES			10
+
+/*!
+	\def		BOUND_*
+	\brief		Why a depth is only a lower bound
+*/
+#define		BOUND_RECURSION		0x01u
+#define		BOUND_DYNAMIC		0x02u
+#define		BOUND_UNKNOWN		0x04u
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\struct		FUNCTION
+	\brief		Node of the call graph
+*/
+typedef struct
+{
+	char name[MAX_NAME];
+	char location[MAX_NAME];
+	uint32_t frame;
+	uint8_t isDefined;
+	uint8_t isDynamic;
+	uint8_t isCalled;		/* directly, by another function */
+	uint8_t state;			/* 0 not visited, 1 on the path, 2 done */
+	uint8_t bounds;			/* BOUND_* below it */
+	uint32_t depth;
+	int next;				/* deepest call, -1 for none */
+	int firstCall;
+} FUNCTION;
+
+/*!
+	\struct		CALL
+	\brief		Edge of the call graph
+*/
+typedef struct
+{
+	int callee;
+	int nextCall;			/* of the same caller, -1 at the end */
+} CALL;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+static FUNCTION functions[MAX_FUNCTIONS];
+static int numFunctions = 0;
+static CALL calls[MAX_CALLS];
+static int numCalls = 0;
+static uint32_t indirectDepth = 0;
+static int indirectVia = -1;
+
+//------------------------------------------------------------------------------
+// Local Functions
+//------------------------------------------------------------------------------
+/*!
+	\fn			static int function (const char *name)
+	\return		Returns the index of a function, adding it if new
+*/
+static int function (const char *name)
+{
+	int i;
+
+	for (i = 0; i < numFunctions; i++)
+	{
+		if (!strcmp (functions[i].name, name))
+		{
+			return i;
+		}
+	}
+	if (numFunctions == MAX_FUNCTIONS)
+	{
+		fprintf (stderr, "stackusage: more than %u functions\n", MAX_FUNCTIONS);
+		exit (2);
+	}
+	snprintf (functions[i].name, sizeof (functions[i].name), "%s", name);
+	functions[i].next = -1;
+	functions[i].firstCall = -1;
+	return numFunctions++;
+}
+
+/*!
+	\fn			static void shorten (char *name)
+	\brief		Drops the directories of "dir/file.c:function" and
+				"dir/file.c:line:column"
+*/
+static void shorten (char *name)
+{
+	char *slash = strrchr (name, '/');
+
+	if (slash)
+	{
+		memmove (name, slash + 1, strlen (slash + 1) + 1);
+	}
+}
+
+/*!
+	\fn			static int quoted (const char *line, const char *key, char *out, size_t size)
+	\return		Returns 1 if line has key: "value", copied to out
+*/
+static int quoted (const char *line, const char *key, char *out, size_t size)
+{
+	const char *start = strstr (line, key);
+	const char *end;
+
+	if (!start)
+	{
+		return 0;
+	}
+	start += strlen (key);
+	end = strchr (start, '"');
+	if (!end)
+	{
+		return 0;
+	}
+	snprintf (out, size, "%.*s", (int)(end - start), start);
+	return 1;
+}
+
+/*!
+	\fn			static void load (const char *path)
+	\brief		Adds the nodes and edges of a .ci file, or exits
+*/
+static void load (const char *path)
+{
+	static char line[MAX_LINE];
+	static char label[MAX_LINE];
+	char name[MAX_NAME];
+	char callee[MAX_NAME];
+	FILE *file = fopen (path, "r");
+	FUNCTION *node;
+	char *text;
+	char *part;
+	int caller;
+
+	if (!file)
+	{
+		fprintf (stderr, "stackusage: cannot read %s\n", path);
+		exit (2);
+	}
+	while (fgets (line, sizeof (line), file))
+	{
+		if (!strncmp (line, "node:", 5) && quoted (line, "title: \"", name, sizeof (name)))
+		{
+			shorten (name);
+			node = &functions[function (name)];
+			/* label: "name\nfile:line:column\nN bytes (static)" on a definition */
+			if (!quoted (line, "label: \"", label, sizeof (label)) || !(text = strstr (label, "\\n")) ||
+					!(part = strstr (text + 2, "\\n")))
+			{
+				continue;
+			}
+			snprintf (node->location, sizeof (node->location), "%.*s", (int)(part - text - 2), text + 2);
+			shorten (node->location);
+			node->frame = (uint32_t)strtoul (part + 2, NULL, 10);
+			node->isDynamic = (strstr (part, "dynamic") && !strstr (part, "bounded")) ? 1 : 0;
+			node->isDefined = 1;
+		}
+		else if (!strncmp (line, "edge:", 5) && quoted (line, "sourcename: \"", name, sizeof (name)) &&
+				quoted (line, "targetname: \"", callee, sizeof (callee)))
+		{
+			if (numCalls == MAX_CALLS)
+			{
+				fprintf (stderr, "stackusage: more than %u calls\n", MAX_CALLS);
+				exit (2);
+			}
+			shorten (name);
+			shorten (callee);
+			caller = function (name);
+			calls[numCalls].callee = function (callee);
+			calls[numCalls].nextCall = functions[caller].firstCall;
+			functions[caller].firstCall = numCalls++;
+			if (strcmp (functions[calls[numCalls - 1].callee].name, name))
+			{
+				functions[calls[numCalls - 1].callee].isCalled = 1;
+			}
+		}
+	}
+	fclose (file);
+}
+
+/*!
+	\fn			static void measure (int index)
+	\brief		Depth of a function and of everything it calls
+*/
+static void measure (int index)
+{
+	FUNCTION *node = &functions[index];
+	FUNCTION *callee;
+	uint32_t depth;
+	int call;
+
+	if (node->state == 2)
+	{
+		return;
+	}
+	node->state = 1;
+	node->depth = node->frame;
+	node->bounds = node->isDynamic ? BOUND_DYNAMIC : 0;
+	if (!node->isDefined && strcmp (node->name, INDIRECT))
+	{
+		node->bounds |= BOUND_UNKNOWN;
+	}
+	for (call = node->firstCall; call >= 0; call = calls[call].nextCall)
+	{
+		callee = &functions[calls[call].callee];
+		if (!strcmp (callee->name, INDIRECT))
+		{
+			depth = indirectDepth;
+		}
+		else if (callee->state == 1)
+		{
+			node->bounds |= BOUND_RECURSION;
+			continue;
+		}
+		else
+		{
+			measure (calls[call].callee);
+			depth = callee->depth;
+			node->bounds |= callee->bounds;
+		}
+		if (node->frame + depth > node->depth)
+		{
+			node->depth = node->frame + depth;
+			node->next = calls[call].callee;
+		}
+	}
+	node->state = 2;
+}
+
+/*!
+	\fn			static int isHandler (const char *name)
+	\return		Returns 1 for an exception or interrupt handler
+*/
+static int isHandler (const char *name)
+{
+	size_t length = strlen (name);
+
+	return (length > 7) && !strcmp (&name[length - 7], "Handler");
+}
+
+/*!
+	\fn			static int isRoot (const FUNCTION *node, char **roots, int numRoots)
+	\return		Returns 1 for main, a handler or a --root function
+*/
+static int isRoot (const FUNCTION *node, char **roots, int numRoots)
+{
+	int i;
+
+	if (!node->isDefined)
+	{
+		return 0;
+	}
+	if (!strcmp (node->name, "main") || isHandler (node->name))
+	{
+		return 1;
+	}
+	for (i = 0; i < numRoots; i++)
+	{
+		if (!strcmp (node->name, roots[i]))
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+/*!
+	\fn			static void printPath (int index)
+	\brief		Prints the deepest call chain from a function, with the
+				frame of every call, up to a call through a pointer
+*/
+static void printPath (int index)
+{
+	const char *separator = "";
+	int hops = 0;
+
+	for (; (index >= 0) && (hops < 32); index = functions[index].next, hops++)
+	{
+		if (!strcmp (functions[index].name, INDIRECT))
+		{
+			printf ("%s(*)%s[%u]", separator, (indirectVia >= 0) ? functions[indirectVia].name : "", indirectDepth);
+			break;
+		}
+		printf ("%s%s(%u)", separator, functions[index].name, functions[index].frame);
+		separator = " > ";
+	}
+	printf ("\n");
+}
+
+/*!
+	\fn			static const char *marks (uint8_t bounds)
+	\return		Returns "+" for a lower bound
+*/
+static const char *marks (uint8_t bounds)
+{
+	return bounds ? "+" : "";
+}
+
+/*!
+	\fn			static void usage (void)
+	\brief		Prints the usage and exits
+*/
+static void usage (void)
+{
+	fprintf (stderr, "usage: stackusage [--root name]... [--indirect bytes] [--nested] [--reserve bytes] <file.ci>...\n");
+	exit (2);
+}
+
+//------------------------------------------------------------------------------
+// Functions
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	char *roots[MAX_ROOTS];
+	int top[TOP_FRAMES];
+	int numRoots = 0;
+	int numFiles = 0;
+	int isNested = 0;
+	int isIndirectSet = 0;
+	int deepestMain = -1;
+	int deepestIsr = -1;
+	uint32_t reserve = 0;
+	uint32_t isrSum = 0;
+	uint32_t worst;
+	uint8_t bounds = 0;
+	int pass;
+	int i;
+	int j;
+
+	for (i = 1; i < argc; i++)
+	{
+		if (!strcmp (argv[i], "--root") && (i + 1 < argc) && (numRoots < MAX_ROOTS))
+		{
+			roots[numRoots++] = argv[++i];
+		}
+		else if (!strcmp (argv[i], "--reserve") && (i + 1 < argc))
+		{
+			reserve = (uint32_t)strtoul (argv[++i], NULL, 0);
+		}
+		else if (!strcmp (argv[i], "--indirect") && (i + 1 < argc))
+		{
+			indirectDepth = (uint32_t)strtoul (argv[++i], NULL, 0);
+			isIndirectSet = 1;
+		}
+		else if (!strcmp (argv[i], "--nested"))
+		{
+			isNested = 1;
+		}
+		else if (argv[i][0] == '-')
+		{
+			usage ();
+		}
+		else
+		{
+			load (argv[i]);
+			numFiles++;
+		}
+	}
+	if (!numFiles)
+	{
+		usage ();
+	}
+
+	/* Without the calls through pointers first, then with the deepest
+	 * function only called through them in their place */
+	for (pass = 0; pass < 2; pass++)
+	{
+		for (i = 0; i < numFunctions; i++)
+		{
+			functions[i].state = 0;
+			functions[i].next = -1;
+		}
+		for (i = 0; i < numFunctions; i++)
+		{
+			measure (i);
+		}
+		if ((pass == 0) && !isIndirectSet)
+		{
+			for (i = 0; i < numFunctions; i++)
+			{
+				if (functions[i].isDefined && !functions[i].isCalled && !isRoot (&functions[i], roots, numRoots) &&
+						(functions[i].depth > indirectDepth))
+				{
+					indirectDepth = functions[i].depth;
+					indirectVia = i;
+				}
+			}
+		}
+	}
+
+	printf ("%-40s %8s  %s\n", "root", "bytes", "deepest path");
+	for (i = 0; i < numFunctions; i++)
+	{
+		if (!isRoot (&functions[i], roots, numRoots))
+		{
+			continue;
+		}
+		printf ("%-40s %7u%-1s  ", functions[i].name, functions[i].depth, marks (functions[i].bounds));
+		printPath (i);
+		if (!isHandler (functions[i].name))
+		{
+			if ((deepestMain < 0) || (functions[i].depth > functions[deepestMain].depth))
+			{
+				deepestMain = i;
+			}
+		}
+		else
+		{
+			isrSum += functions[i].depth + EXCEPTION_FRAME;
+			if ((deepestIsr < 0) || (functions[i].depth > functions[deepestIsr].depth))
+			{
+				deepestIsr = i;
+			}
+		}
+	}
+	printf ("\ncalls through pointers: %u bytes%s%s\n", indirectDepth, (indirectVia >= 0) ? ", " : "",
+			(indirectVia >= 0) ? functions[indirectVia].name : "");
+
+	/* Largest frames, largest first */
+	for (i = 0; i < TOP_FRAMES; i++)
+	{
+		top[i] = -1;
+		for (j = 0; j < numFunctions; j++)
+		{
+			if (functions[j].isDefined && ((top[i] < 0) || (functions[j].frame > functions[top[i]].frame)) &&
+					((i == 0) || (functions[j].frame < functions[top[i - 1]].frame) ||
+					((functions[j].frame == functions[top[i - 1]].frame) && (j > top[i - 1]))))
+			{
+				top[i] = j;
+			}
+		}
+	}
+	printf ("\n%-32s %8s  %s\n", "largest frames", "bytes", "location");
+	for (i = 0; (i < TOP_FRAMES) && (top[i] >= 0); i++)
+	{
+		printf ("%-40s %7u%-1s  %s\n", functions[top[i]].name, functions[top[i]].frame,
+				functions[top[i]].isDynamic ? "+" : "", functions[top[i]].location);
+	}
+
+	worst = (deepestMain >= 0) ? functions[deepestMain].depth : 0;
+	bounds |= (deepestMain >= 0) ? functions[deepestMain].bounds : 0;
+	if (isNested)
+	{
+		worst += isrSum;
+	}
+	else if (deepestIsr >= 0)
+	{
+		worst += functions[deepestIsr].depth + EXCEPTION_FRAME;
+		bounds |= functions[deepestIsr].bounds;
+	}
+	printf ("\nworst case %u%s bytes", worst, marks (bounds));
+	if (reserve)
+	{
+		printf (" of %u reserved, %d free", reserve, (int)reserve - (int)worst);
+	}
+	printf ("\n");
+
+	return (reserve && (worst > reserve)) ? 1 : 0;
+}
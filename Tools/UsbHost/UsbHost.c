@@ -0,0 +1,779 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		UsbHost.c
+	\date		October 19th, 2026
+	\brief		Host harness of the USB CDC management port. USB.c, Protocol.c
+				and fsl_str.c run unchanged on a model of the USB0 serial
+				interface engine: buffer descriptors with their OWN, DATA0/1
+				and even/odd rules, the four entry token FIFO, NAK and STALL
+				handshakes and the suspended token processing after a SETUP.
+				The harness plays the USB host: it enumerates the device like
+				a PC would, opens the virtual COM port, runs the management
+				protocol over the bulk endpoints and then streams data both
+				ways to count the NAKs the double buffering avoids.
+
+				Usage:
+					usbhost [options]
+
+				Options:
+					--packets <n>	bulk packets per throughput run (default 2000)
+					--latency <s>	transaction slots between a completed token
+									and its interrupt (default 1)
+					--verbose		print every control transfer
+
+				The throughput is modelled, not measured: a full-speed frame
+				carries at most FRAME_SLOTS bulk transactions of 64 bytes and
+				every attempt, NAKed or not, takes one of them.
+*/
+//------------------------------------------------------------------------------
+// Includes
+//------------------------------------------------------------------------------
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "MKL27Z644.h"
+#include "ClockProfile.h"
+#include "USB.h"
+#include "Protocol.h"
+#include "HostSupport.h"
+
+//------------------------------------------------------------------------------
+// Defines
+//------------------------------------------------------------------------------
+/*!
+	\def		DEVICE_ADDRESS
+	\brief		Address given with SET_ADDRESS
+*/
+#define		DEVICE_ADDRESS		5
+
+/*!
+	\def		FRAME_SLOTS
+	\brief		Bulk transactions of 64 bytes that fit a 1 ms full-speed frame
+*/
+#define		FRAME_SLOTS			19
+
+/*!
+	\def		RETRIES
+	\brief		NAKs a control transaction accepts before failing
+*/
+#define		RETRIES				16
+
+/*!
+	\def		TOKEN_FIFO
+	\brief		Depth of the SIE token status FIFO
+*/
+#define		TOKEN_FIFO			4
+
+/*!
+	\def		BD_OWN, BD_DATA1, BD_DTS
+	\brief		Buffer descriptor bits, as in USB.c
+*/
+#define		BD_OWN				(1u << 7)
+#define		BD_DATA1			(1u << 6)
+#define		BD_DTS				(1u << 3)
+
+/*!
+	\def		PID_OUT, PID_IN, PID_SETUP
+	\brief		Token PIDs the SIE writes back into a buffer descriptor
+*/
+#define		PID_OUT				0x1
+#define		PID_IN				0x9
+#define		PID_SETUP			0xD
+
+/*!
+	\def		FAST_HELD
+	\brief		Requests of the 48 MHz profile not released yet
+*/
+#define		FAST_HELD			(Host_adwClockRequests[eCLOCK_PROFILE_RUN_48M] - \
+									Host_adwClockReleases[eCLOCK_PROFILE_RUN_48M])
+
+//------------------------------------------------------------------------------
+// Types
+//------------------------------------------------------------------------------
+/*!
+	\enum		HANDSHAKE
+	\brief		Outcome of one transaction
+*/
+typedef enum
+{
+	eACK,
+	eNAK,
+	eSTALL,
+	eTIMEOUT
+} HANDSHAKE;
+
+/*!
+	\struct		BD
+	\brief		Buffer descriptor, as the SIE reads it
+*/
+typedef struct
+{
+	volatile uint32_t control;
+	volatile uint32_t address;
+} BD;
+
+/*!
+	\struct		TOKEN
+	\brief		Completed token waiting for its interrupt
+*/
+typedef struct
+{
+	uint8_t stat;
+	uint32_t slot;
+} TOKEN;
+
+//------------------------------------------------------------------------------
+// Variables
+//------------------------------------------------------------------------------
+USB_Type Host_usb;
+SIM_Type Host_sim;
+MCG_Type Host_mcg;
+NVIC_Type Host_nvic;
+
+static uint8_t sieOdd[16][2];
+static TOKEN tokens[TOKEN_FIFO];
+static uint8_t tokenCount = 0;
+static uint32_t slot = 0;
+static uint32_t latency = 0;
+static uint32_t naks = 0;
+
+/* Data toggles the host expects or sends next, per endpoint */
+static uint8_t hostOutData1[16];
+static uint8_t hostInData1[16];
+
+static uint32_t rawRxCalls = 0;
+static uint32_t rawTxCalls = 0;
+
+//------------------------------------------------------------------------------
+// SIE model
+//------------------------------------------------------------------------------
+/*!
+	\fn			static BD *sieBd (uint8_t ep, uint8_t tx, uint8_t odd)
+	\return		Returns the buffer descriptor the BDTPAGE registers point at
+*/
+static BD *sieBd (uint8_t ep, uint8_t tx, uint8_t odd)
+{
+	uintptr_t base = ((uintptr_t)Host_usb.BDTPAGE3 << 24) |
+			((uintptr_t)Host_usb.BDTPAGE2 << 16) |
+			((uintptr_t)(Host_usb.BDTPAGE1 & USB_BDTPAGE1_BDTBA_MASK) << 8);
+
+	return &((BD *)base)[(ep << 2) | (tx << 1) | odd];
+}
+
+/*!
+	\fn			static void sieInterrupt (uint8_t status, uint8_t stat)
+	\brief		Raises interrupt flags, runs the handler and clears them, as
+				the handler's write-one-to-clear stores cannot be modelled
+*/
+static void sieInterrupt (uint8_t status, uint8_t stat)
+{
+	Host_usb.ISTAT = status;
+	/* STAT is read-only for the CPU, the SIE writes it */
+	*(volatile uint8_t *)&Host_usb.STAT = stat;
+	USB0_DriverIRQHandler ();
+	Host_usb.ISTAT = 0;
+}
+
+/*!
+	\fn			static void sieService (int all)
+	\brief		Runs the interrupt of every token older than the latency
+*/
+static void sieService (int all)
+{
+	while (tokenCount && (all || ((slot - tokens[0].slot) >= latency)))
+	{
+		uint8_t stat = tokens[0].stat;
+
+		tokenCount--;
+		memmove (&tokens[0], &tokens[1], tokenCount * sizeof (TOKEN));
+		sieInterrupt (USB_ISTAT_TOKDNE_MASK, stat);
+	}
+}
+
+/*!
+	\fn			static void sieComplete (uint8_t ep, uint8_t tx, BD *bd, uint8_t pid, uint16_t size)
+	\brief		Writes a buffer descriptor back to the CPU and queues its token
+*/
+static void sieComplete (uint8_t ep, uint8_t tx, BD *bd, uint8_t pid, uint16_t size)
+{
+	uint8_t odd = sieOdd[ep][tx];
+
+	bd->control = (bd->control & BD_DATA1) | ((uint32_t)size << 16) | ((uint32_t)pid << 2);
+	sieOdd[ep][tx] ^= 1;
+	tokens[tokenCount].stat = (uint8_t)((ep << 4) | (tx << 3) | (odd << 2));
+	tokens[tokenCount].slot = slot;
+	tokenCount++;
+}
+
+/*!
+	\fn			static HANDSHAKE sieTransaction (uint8_t pid, uint8_t addr, uint8_t ep, uint8_t data1, uint8_t *data, uint16_t *size)
+	\brief		One transaction on the bus as the SIE answers it
+*/
+static HANDSHAKE sieTransaction (uint8_t pid, uint8_t addr, uint8_t ep, uint8_t data1,
+		uint8_t *data, uint16_t *size)
+{
+	uint8_t tx = (pid == PID_IN);
+	uint8_t endpt = Host_usb.ENDPOINT[ep].ENDPT;
+	HANDSHAKE result = eACK;
+	BD *bd;
+	uint32_t control;
+
+	slot++;
+	if ((addr != Host_usb.ADDR) ||
+			!(endpt & (tx ? USB_ENDPT_EPTXEN_MASK : USB_ENDPT_EPRXEN_MASK)))
+	{
+		result = eTIMEOUT;
+	}
+	else if ((pid != PID_SETUP) && (endpt & USB_ENDPT_EPSTALL_MASK))
+	{
+		sieInterrupt (USB_ISTAT_STALL_MASK, 0);
+		result = eSTALL;
+	}
+	else if (((pid != PID_SETUP) && (Host_usb.CTL & USB_CTL_TXSUSPENDTOKENBUSY_MASK)) ||
+			(tokenCount == TOKEN_FIFO))
+	{
+		result = eNAK;
+	}
+	else
+	{
+		bd = sieBd (ep, tx, sieOdd[ep][tx]);
+		control = bd->control;
+		if (!(control & BD_OWN))
+		{
+			result = eNAK;
+		}
+		else if (tx)
+		{
+			*size = (uint16_t)((control >> 16) & 0x3FF);
+			memcpy (data, (const void *)(uintptr_t)bd->address, *size);
+			*size |= (control & BD_DATA1) ? 0x8000 : 0;
+			sieComplete (ep, tx, bd, PID_IN, *size & 0x3FF);
+		}
+		else if ((pid == PID_OUT) && (control & BD_DTS) &&
+				(((control & BD_DATA1) ? 1 : 0) != data1))
+		{
+			/* A retried packet: acknowledged and dropped */
+		}
+		else if (*size > ((control >> 16) & 0x3FF))
+		{
+			result = eTIMEOUT;
+		}
+		else
+		{
+			memcpy ((void *)(uintptr_t)bd->address, data, *size);
+			bd->control = (control & ~BD_DATA1) | (data1 ? BD_DATA1 : 0);
+			sieComplete (ep, tx, bd, pid, *size);
+			if (pid == PID_SETUP)
+			{
+				Host_usb.CTL |= USB_CTL_TXSUSPENDTOKENBUSY_MASK;
+			}
+		}
+	}
+
+	if (result == eNAK)
+	{
+		naks++;
+	}
+	sieService (0);
+	return result;
+}
+
+/*!
+	\fn			static void sieBusReset (void)
+	\brief		Bus reset; the firmware resets the even/odd state with ODDRST
+*/
+static void sieBusReset (void)
+{
+	memset (sieOdd, 0, sizeof (sieOdd));
+	tokenCount = 0;
+	Host_usb.CTL &= ~USB_CTL_TXSUSPENDTOKENBUSY_MASK;
+	sieInterrupt (USB_ISTAT_USBRST_MASK, 0);
+}
+
+//------------------------------------------------------------------------------
+// Host transfers
+//------------------------------------------------------------------------------
+/*!
+	\fn			static HANDSHAKE hostOut (uint8_t addr, uint8_t ep, const uint8_t *data, uint16_t size, int retries)
+	\brief		OUT transaction with the toggle of the endpoint, retried on NAK
+*/
+static HANDSHAKE hostOut (uint8_t addr, uint8_t ep, const uint8_t *data, uint16_t size, int retries)
+{
+	uint8_t packet[USB_PACKET];
+	uint16_t length;
+	HANDSHAKE result;
+
+	do
+	{
+		memcpy (packet, data, size);
+		length = size;
+		result = sieTransaction (PID_OUT, addr, ep, hostOutData1[ep], packet, &length);
+	} while ((result == eNAK) && retries--);
+
+	if (result == eACK)
+	{
+		hostOutData1[ep] ^= 1;
+	}
+	return result;
+}
+
+/*!
+	\fn			static HANDSHAKE hostIn (uint8_t addr, uint8_t ep, uint8_t *data, uint16_t *size, int retries)
+	\brief		IN transaction, retried on NAK; checks the data toggle
+*/
+static HANDSHAKE hostIn (uint8_t addr, uint8_t ep, uint8_t *data, uint16_t *size, int retries)
+{
+	HANDSHAKE result;
+	uint16_t raw = 0;
+
+	do
+	{
+		result = sieTransaction (PID_IN, addr, ep, 0, data, &raw);
+	} while ((result == eNAK) && retries--);
+
+	*size = 0;
+	if (result == eACK)
+	{
+		CHECK (((raw & 0x8000) ? 1 : 0) == hostInData1[ep],
+				"endpoint %u IN toggle DATA%u, expected DATA%u", ep,
+				(raw & 0x8000) ? 1 : 0, hostInData1[ep]);
+		hostInData1[ep] ^= 1;
+		*size = raw & 0x3FF;
+	}
+	return result;
+}
+
+/*!
+	\fn			static HANDSHAKE hostControl (uint8_t addr, uint8_t type, uint8_t request, uint16_t value, uint16_t index, uint16_t length, uint8_t *data, uint16_t *actual)
+	\brief		Control transfer: SETUP, data stage and status stage
+*/
+static HANDSHAKE hostControl (uint8_t addr, uint8_t type, uint8_t request, uint16_t value,
+		uint16_t index, uint16_t length, uint8_t *data, uint16_t *actual)
+{
+	uint8_t setup[8] = {type, request, (uint8_t)value, (uint8_t)(value >> 8),
+			(uint8_t)index, (uint8_t)(index >> 8), (uint8_t)length, (uint8_t)(length >> 8)};
+	uint16_t size = sizeof (setup);
+	uint16_t done = 0;
+	uint16_t chunk = 0;
+	HANDSHAKE result;
+
+	result = sieTransaction (PID_SETUP, addr, 0, 0, setup, &size);
+	if (result != eACK)
+	{
+		return result;
+	}
+	hostOutData1[0] = 1;
+	hostInData1[0] = 1;
+
+	if (length && (type & 0x80))
+	{
+		do
+		{
+			result = hostIn (addr, 0, &data[done], &chunk, RETRIES);
+			if (result != eACK)
+			{
+				return result;
+			}
+			done = (uint16_t)(done + chunk);
+		} while ((chunk == USB_PACKET) && (done < length));
+		hostOutData1[0] = 1;
+		result = hostOut (addr, 0, 0, 0, RETRIES);
+	}
+	else
+	{
+		while (done < length)
+		{
+			chunk = (uint16_t)(((length - done) > USB_PACKET) ? USB_PACKET : (length - done));
+			result = hostOut (addr, 0, &data[done], chunk, RETRIES);
+			if (result != eACK)
+			{
+				return result;
+			}
+			done = (uint16_t)(done + chunk);
+		}
+		hostInData1[0] = 1;
+		result = hostIn (addr, 0, 0, &chunk, RETRIES);
+		CHECK ((result != eACK) || (chunk == 0), "status stage carried %u bytes", chunk);
+	}
+
+	if (actual != 0)
+	{
+		*actual = done;
+	}
+	if (Host_bVerbose)
+	{
+		printf ("control %02X %02X %04X %04X %u -> %d, %u bytes\n",
+				type, request, value, index, length, result, done);
+	}
+	return result;
+}
+
+/*!
+	\fn			static uint16_t hostReadAll (uint8_t *data, uint16_t room)
+	\brief		Reads the data IN endpoint until it NAKs
+*/
+static uint16_t hostReadAll (uint8_t *data, uint16_t room)
+{
+	uint8_t packet[USB_PACKET];
+	uint16_t total = 0;
+	uint16_t size = 0;
+
+	while (hostIn (DEVICE_ADDRESS, 1, packet, &size, 0) == eACK)
+	{
+		if ((total + size) <= room)
+		{
+			memcpy (&data[total], packet, size);
+			total = (uint16_t)(total + size);
+		}
+	}
+	return total;
+}
+
+/*!
+	\fn			static const char *hostCommand (const char *line)
+	\return		Returns the first reply without its '$' and line end, ""
+				if none
+	\brief		Sends a management command over the bulk OUT endpoint, lets
+				the main loop run it and reads the reply
+*/
+static const char *hostCommand (const char *line)
+{
+	static char output[128];
+	uint16_t size = 0;
+
+	CHECK (hostOut (DEVICE_ADDRESS, 1, (const uint8_t *)line, (uint16_t)strlen (line), RETRIES) == eACK,
+			"bulk OUT of %s", line);
+	sieService (1);
+	Protocol_vfnTask ();
+	size = hostReadAll ((uint8_t *)output, (uint16_t)(sizeof (output) - 1));
+	output[size] = '\0';
+	if (Host_bVerbose)
+	{
+		printf ("> %s< %s", line, output);
+	}
+	return Host_pcfnReply (output, 0);
+}
+
+//------------------------------------------------------------------------------
+// Scenarios
+//------------------------------------------------------------------------------
+/*!
+	\fn			static void testEnumeration (void)
+	\brief		What a PC does after plugging the board in
+*/
+static void testEnumeration (void)
+{
+	uint8_t data[256];
+	uint16_t size = 0;
+	char text[64];
+	uint16_t i = 0;
+
+	CHECK (Host_usb.CONTROL & USB_CONTROL_DPPULLUPNONOTG_MASK, "D+ pull-up not connected");
+	CHECK (Host_nvic.ISER[0] & (1u << USB0_IRQn), "USB0 interrupt not enabled");
+	CHECK (FAST_HELD == 1, "48 MHz not requested");
+
+	sieBusReset ();
+	CHECK (hostControl (0, 0x80, 0x06, 0x0100, 0, 64, data, &size) == eACK, "GET_DESCRIPTOR device");
+	CHECK ((size == 18) && (data[1] == 1) && (data[7] == USB_PACKET), "device descriptor %u bytes", size);
+
+	sieBusReset ();
+	CHECK (hostControl (0, 0x00, 0x05, DEVICE_ADDRESS, 0, 0, 0, 0) == eACK, "SET_ADDRESS");
+	CHECK (Host_usb.ADDR == DEVICE_ADDRESS, "address %u after the status stage", Host_usb.ADDR);
+
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x06, 0x0200, 0, 9, data, &size) == eACK, "GET_DESCRIPTOR config 9");
+	CHECK ((size == 9) && (data[2] == 67), "configuration header %u bytes, total %u", size, data[2]);
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x06, 0x0200, 0, 255, data, &size) == eACK, "GET_DESCRIPTOR config");
+	CHECK ((size == 67) && (data[14] == 0x02) && (data[15] == 0x02), "configuration %u bytes", size);
+
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x06, 0x0302, 0x0409, 255, data, &size) == eACK, "GET_DESCRIPTOR string");
+	for (i = 0; (i < (size - 2) / 2) && (i < sizeof (text) - 1); i++)
+	{
+		text[i] = (char)data[2 + 2 * i];
+	}
+	text[i] = '\0';
+	CHECK (strcmp (text, "SmartLock Service Port") == 0, "product string \"%s\"", text);
+
+	/* Device qualifier: a full-speed only device stalls it */
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x06, 0x0600, 0, 10, data, &size) == eSTALL, "device qualifier not stalled");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x00, 0, 0, 2, data, &size) == eACK, "GET_STATUS after a stall");
+	CHECK ((size == 2) && (data[0] == 1), "device status %u bytes, %02X", size, data[0]);
+
+	CHECK (hostControl (DEVICE_ADDRESS, 0x00, 0x09, 1, 0, 0, 0, 0) == eACK, "SET_CONFIGURATION");
+	CHECK (USB_bfnIsConfigured (), "not configured");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x80, 0x08, 0, 0, 1, data, &size) == eACK, "GET_CONFIGURATION");
+	CHECK ((size == 1) && (data[0] == 1), "configuration %u", data[0]);
+	hostOutData1[1] = 0;
+	hostInData1[1] = 0;
+	hostInData1[2] = 0;
+}
+
+/*!
+	\fn			static void testCdc (void)
+	\brief		What a terminal program does when it opens the port
+*/
+static void testCdc (void)
+{
+	uint8_t coding[7] = {0x00, 0x10, 0x0E, 0x00, 0, 0, 8};
+	uint8_t data[16];
+	uint16_t size = 0;
+
+	CHECK (hostControl (DEVICE_ADDRESS, 0x21, 0x20, 0, 0, 7, coding, 0) == eACK, "SET_LINE_CODING");
+	CHECK (hostControl (DEVICE_ADDRESS, 0xA1, 0x21, 0, 0, 7, data, &size) == eACK, "GET_LINE_CODING");
+	CHECK ((size == 7) && (memcmp (data, coding, 7) == 0), "line coding did not round trip");
+	CHECK (!USB_bfnIsOpen (), "open before DTR");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x21, 0x22, 3, 0, 0, 0, 0) == eACK, "SET_CONTROL_LINE_STATE");
+	CHECK (USB_bfnIsOpen (), "not open after DTR");
+	CHECK (hostIn (DEVICE_ADDRESS, 2, data, &size, 0) == eNAK, "notification endpoint not silent");
+}
+
+/*!
+	\fn			static void testProtocol (void)
+	\brief		Management commands over the bulk endpoints; replies must go
+				back on USB and never to the UART
+*/
+static void testProtocol (void)
+{
+	const char *reply;
+
+	reply = hostCommand ("$PING\n");
+	CHECK (strcmp (reply, "PONG") == 0, "PING answered \"%s\"", reply);
+
+	reply = hostCommand ("$NOPE\n");
+	CHECK (strcmp (reply, "ERR NOPE") == 0, "unknown command answered \"%s\"", reply);
+
+	/* A line split over two packets */
+	CHECK (hostOut (DEVICE_ADDRESS, 1, (const uint8_t *)"$US", 3, RETRIES) == eACK, "first half");
+	reply = hostCommand ("B\n");
+	CHECK (strncmp (reply, "USB cfg=1 open=1", 16) == 0, "USB answered \"%s\"", reply);
+	printf ("%s\n", reply);
+
+	CHECK (Host_wUartOutLength == 0, "%u reply bytes went to the UART", Host_wUartOutLength);
+}
+
+/*!
+	\fn			static void testHalt (void)
+	\brief		Halting and clearing the bulk endpoints restarts their data
+				toggles with DATA0
+*/
+static void testHalt (void)
+{
+	const char *reply;
+	uint8_t data[USB_PACKET];
+	uint16_t size = 0;
+
+	/* Leave both OUT toggles and the IN toggle on DATA1 */
+	hostCommand ("$PING\n");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x02, 0x03, 0, 0x81, 0, 0, 0) == eACK, "SET_FEATURE halt");
+	CHECK (hostIn (DEVICE_ADDRESS, 1, data, &size, 0) == eSTALL, "halted IN endpoint not stalling");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x02, 0x01, 0, 0x81, 0, 0, 0) == eACK, "CLEAR_FEATURE halt IN");
+	CHECK (hostControl (DEVICE_ADDRESS, 0x02, 0x01, 0, 0x01, 0, 0, 0) == eACK, "CLEAR_FEATURE halt OUT");
+	hostOutData1[1] = 0;
+	hostInData1[1] = 0;
+
+	reply = hostCommand ("$PING\n");
+	CHECK (strcmp (reply, "PONG") == 0, "PING after clearing the halt answered \"%s\"", reply);
+}
+
+/*!
+	\fn			static void rawRx (void) / rawTx (void)
+	\brief		Driver callbacks of the throughput runs
+*/
+static void rawRx (void)
+{
+	rawRxCalls++;
+}
+
+static void rawTx (void)
+{
+	rawTxCalls++;
+}
+
+/*!
+	\fn			static void testOutStream (uint32_t packets, uint32_t drainEvery)
+	\brief		Streams a counting pattern to the device. With drainEvery 0
+				the ring is emptied from the receive interrupt, like the
+				protocol does; else the main loop empties it every drainEvery
+				slots and the driver has to hold buffers back.
+*/
+static void testOutStream (uint32_t packets, uint32_t drainEvery)
+{
+	uint8_t packet[USB_PACKET];
+	uint8_t chunk[USB_RX_RING];
+	uint32_t sent = 0;
+	uint32_t expected = 0;
+	uint32_t first = slot;
+	uint32_t firstNaks = naks;
+	uint32_t used = 0;
+	uint32_t held = USB_dwfnGetStatistic (eUSB_RX_HELD);
+	uint16_t count = 0;
+	uint16_t i = 0;
+	HANDSHAKE result;
+
+	while ((sent < packets) || (expected < packets * USB_PACKET))
+	{
+		if (sent < packets)
+		{
+			for (i = 0; i < USB_PACKET; i++)
+			{
+				packet[i] = (uint8_t)(sent * USB_PACKET + i);
+			}
+			result = hostOut (DEVICE_ADDRESS, 1, packet, USB_PACKET, 0);
+			CHECK ((result == eACK) || (result == eNAK), "bulk OUT handshake %d", result);
+			sent += (result == eACK);
+		}
+		else
+		{
+			slot++;
+			sieService (0);
+		}
+
+		if ((drainEvery == 0) ? (rawRxCalls != 0) : ((slot % drainEvery) == 0))
+		{
+			rawRxCalls = 0;
+			do
+			{
+				count = USB_wfnReceive (chunk, sizeof (chunk));
+				for (i = 0; i < count; i++, expected++)
+				{
+					if (chunk[i] != (uint8_t)expected)
+					{
+						CHECK (0, "byte %u is %02X, expected %02X", expected, chunk[i], (uint8_t)expected);
+						return;
+					}
+				}
+			} while (count);
+		}
+	}
+	sieService (1);
+
+	used = slot - first;
+	printf ("OUT %5u packets, drain %-9s %5u NAKs, %5u held, %4u kB/s modelled\n",
+			packets, drainEvery ? "main loop" : "interrupt", naks - firstNaks,
+			USB_dwfnGetStatistic (eUSB_RX_HELD) - held,
+			(uint32_t)((uint64_t)packets * USB_PACKET * FRAME_SLOTS / used));
+	/* Two buffers hide one slot of interrupt latency, not more */
+	if ((drainEvery == 0) && (latency <= 1))
+	{
+		CHECK (naks == firstNaks, "double buffered OUT NAKed %u times", naks - firstNaks);
+	}
+}
+
+/*!
+	\fn			static void testInStream (uint32_t packets)
+	\brief		The main loop queues a counting pattern as fast as the ring
+				takes it while the host reads every slot
+*/
+static void testInStream (uint32_t packets)
+{
+	uint8_t data[USB_TX_RING];
+	uint8_t packet[USB_PACKET];
+	uint32_t total = packets * USB_PACKET;
+	uint32_t queued = 0;
+	uint32_t received = 0;
+	uint32_t first = slot;
+	uint32_t firstNaks = naks;
+	uint32_t zlps = 0;
+	uint16_t room = 0;
+	uint16_t size = 0;
+	uint16_t i = 0;
+
+	while (received < total)
+	{
+		room = (uint16_t)(USB_TX_RING - 1 - USB_wfnTxPending ());
+		if ((total - queued) < room)
+		{
+			room = (uint16_t)(total - queued);
+		}
+		for (i = 0; i < room; i++)
+		{
+			data[i] = (uint8_t)(queued + i);
+		}
+		queued += USB_wfnSend (data, room);
+
+		if (hostIn (DEVICE_ADDRESS, 1, packet, &size, 0) != eACK)
+		{
+			continue;
+		}
+		zlps += (size == 0);
+		for (i = 0; i < size; i++, received++)
+		{
+			if (packet[i] != (uint8_t)received)
+			{
+				CHECK (0, "byte %u is %02X, expected %02X", received, packet[i], (uint8_t)received);
+				return;
+			}
+		}
+	}
+	/* The stream ended on a full packet: a zero length packet closes it */
+	CHECK ((hostIn (DEVICE_ADDRESS, 1, packet, &size, 4) == eACK) && (size == 0), "no closing zero length packet");
+	sieService (1);
+	CHECK (rawTxCalls != 0, "transmit callback never called");
+
+	printf ("IN  %5u packets, %5u NAKs, %4u kB/s modelled\n", packets,
+			naks - firstNaks, (uint32_t)((uint64_t)total * FRAME_SLOTS / (slot - first)));
+	(void)zlps;
+}
+
+/*!
+	\fn			static void testSuspend (void)
+	\brief		A suspended bus lets the core slow down until it resumes
+*/
+static void testSuspend (void)
+{
+	sieInterrupt (USB_ISTAT_SLEEP_MASK, 0);
+	CHECK (FAST_HELD == 0, "48 MHz kept while suspended");
+	CHECK (Host_usb.USBTRC0 & USB_USBTRC0_USBRESMEN_MASK, "asynchronous resume not armed");
+	sieInterrupt (USB_ISTAT_RESUME_MASK, 0);
+	CHECK (FAST_HELD == 1, "48 MHz not requested after resume");
+	CHECK (USB_bfnIsConfigured (), "configuration lost over a suspend");
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+int main (int argc, char **argv)
+{
+	uint32_t packets = 2000;
+	uint32_t streamLatency = 1;
+	int i = 0;
+
+	for (i = 1; i < argc; i++)
+	{
+		if ((strcmp (argv[i], "--packets") == 0) && (i + 1 < argc))
+		{
+			packets = (uint32_t)strtoul (argv[++i], 0, 0);
+		}
+		else if ((strcmp (argv[i], "--latency") == 0) && (i + 1 < argc))
+		{
+			streamLatency = (uint32_t)strtoul (argv[++i], 0, 0);
+		}
+		else if (strcmp (argv[i], "--verbose") == 0)
+		{
+			/* taken by Host_vfnInit */
+		}
+		else
+		{
+			fprintf (stderr, "usage: %s [--packets <n>] [--latency <slots>] [--verbose]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	Host_vfnInit (argc, argv);
+	Protocol_vfnDriverInit (0);
+
+	testEnumeration ();
+	testCdc ();
+	testProtocol ();
+	testHalt ();
+	testSuspend ();
+
+	/* From here on the interrupt runs streamLatency slots after its token */
+	USB_vfnCallbackReg (rawRx, rawTx);
+	latency = streamLatency;
+	printf ("interrupt latency %u slots, %u slots per frame\n", latency, FRAME_SLOTS);
+	testOutStream (packets, 0);
+	testOutStream (packets, 8);
+	testInStream (packets);
+
+	return Host_ifnResult ();
+}
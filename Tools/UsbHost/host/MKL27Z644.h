@@ -0,0 +1,29 @@
+//------------------------------------------------------------------------------
+/*!
+	\file		MKL27Z644.h
+	\brief		Host wrapper of the device header for the USB harness. Takes
+				the real register layouts and points USB0, SIM, MCG and NVIC
+				at structures owned by UsbHost.c, so USB.c runs unchanged
+				against the model of the serial interface engine.
+*/
+//------------------------------------------------------------------------------
+#ifndef HOST_USB_MKL27Z644_H_
+#define HOST_USB_MKL27Z644_H_
+
+#include_next "MKL27Z644.h"
+
+extern USB_Type Host_usb;
+extern SIM_Type Host_sim;
+extern MCG_Type Host_mcg;
+extern NVIC_Type Host_nvic;
+
+#undef USB0
+#define USB0						(&Host_usb)
+#undef SIM
+#define SIM							(&Host_sim)
+#undef MCG
+#define MCG							(&Host_mcg)
+#undef NVIC
+#define NVIC						(&Host_nvic)
+
+#endif /* HOST_USB_MKL27Z644_H_ */
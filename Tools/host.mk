@@ -0,0 +1,24 @@
+# Host build settings shared by the Makefiles under Tools.
+#
+# A Makefile may set, before including it:
+#   SIM         directory of the simulated HAL, ../Simulator by default
+#   HOST_INCS   include directories searched before the shared ones
+#
+# and gets FW, the firmware tree; HOST_CFLAGS, the flags that compile the
+# firmware for the host, to add to its CFLAGS; and INCS.
+
+FW      := ../../SmartLock
+SIM     ?= ../Simulator
+CC      ?= gcc
+CFLAGS  ?= -O2 -g -Wall
+
+HOST_CFLAGS := -std=gnu99 -DHOST_SIMULATION -DCPU_MKL27Z64VLH4 \
+               -Wno-int-to-pointer-cast \
+               -D__CMSIS_GCC_H -include $(SIM)/host/cmsis_compiler.h
+
+INCS    := $(HOST_INCS) -I$(SIM) -I$(SIM)/host \
+           -I$(FW)/source/1_APP -I$(FW)/source/2_HIL -I$(FW)/source/3_HAL \
+           -I$(FW)/source/4_SL -I$(FW)/device -I$(FW)/CMSIS -I$(FW)/drivers \
+           -I$(FW)/utilities -I$(FW)/board \
+           -I$(FW)/component/serial_manager -I$(FW)/component/uart \
+           -I$(FW)/component/lists